@@ -107,6 +107,7 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 	rz_event_hook (analysis->zign_spaces.event, RZ_SPACE_EVENT_COUNT, zign_count_for, NULL);
 	rz_event_hook (analysis->zign_spaces.event, RZ_SPACE_EVENT_RENAME, zign_rename_for, NULL);
 	rz_analysis_hint_storage_init (analysis);
+	rz_analysis_op_cache_init (&analysis->opcache);
 	rz_interval_tree_init (&analysis->meta, rz_meta_item_free);
 	analysis->sdb_types = sdb_ns (analysis->sdb, "types", 1);
 	analysis->sdb_fmts = sdb_ns (analysis->sdb, "spec", 1);
@@ -120,6 +121,7 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 	(void)rz_analysis_xrefs_init (analysis);
 	analysis->diff_thbb = RZ_ANALYSIS_THRESHOLDBB;
 	analysis->diff_thfcn = RZ_ANALYSIS_THRESHOLDFCN;
+	analysis->diff_threads = 1;
 	analysis->syscall = rz_syscall_new ();
 	rz_io_bind_init (analysis->iob);
 	rz_flag_bind_init (analysis->flb);
@@ -158,6 +160,7 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	ht_pp_free (a->ht_name_fun);
 	set_u_free (a->visited);
 	rz_analysis_hint_storage_fini (a);
+	rz_analysis_op_cache_fini (&a->opcache);
 	rz_interval_tree_fini (&a->meta);
 	free (a->cpu);
 	free (a->os);
@@ -165,12 +168,12 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	rz_list_free (a->plugins);
 	rz_rbtree_free (a->bb_tree, __block_free_rb, NULL);
 	rz_spaces_fini (&a->meta_spaces);
+	rz_sign_index_invalidate (a);
 	rz_spaces_fini (&a->zign_spaces);
 	rz_analysis_pin_fini (a);
 	rz_syscall_free (a->syscall);
 	rz_reg_free (a->reg);
-	ht_up_free (a->dict_refs);
-	ht_up_free (a->dict_xrefs);
+	rz_analysis_xrefs_fini (a);
 	rz_list_free (a->leaddrs);
 	sdb_free (a->sdb);
 	if (a->esil) {
@@ -212,6 +215,7 @@ RZ_API bool rz_analysis_use(RzAnalysis *analysis, const char *name) {
 			}
 #endif
 			analysis->cur = h;
+			rz_analysis_op_cache_flush (&analysis->opcache);
 			rz_analysis_set_reg_profile (analysis);
 			return true;
 		}
@@ -295,6 +299,7 @@ RZ_API bool rz_analysis_set_bits(RzAnalysis *analysis, int bits) {
 RZ_API void rz_analysis_set_cpu(RzAnalysis *analysis, const char *cpu) {
 	free (analysis->cpu);
 	analysis->cpu = cpu ? strdup (cpu) : NULL;
+	rz_analysis_op_cache_flush (&analysis->opcache);
 	int v = rz_analysis_archinfo (analysis, RZ_ANALYSIS_ARCHINFO_ALIGN);
 	if (v != -1) {
 		analysis->pcalign = v;
@@ -302,6 +307,9 @@ RZ_API void rz_analysis_set_cpu(RzAnalysis *analysis, const char *cpu) {
 }
 
 RZ_API int rz_analysis_set_big_endian(RzAnalysis *analysis, int bigend) {
+	if (analysis->big_endian != bigend) {
+		rz_analysis_op_cache_flush (&analysis->opcache);
+	}
 	analysis->big_endian = bigend;
 	analysis->reg->big_endian = bigend;
 	return true;
@@ -417,6 +425,7 @@ RZ_API void rz_analysis_purge(RzAnalysis *analysis) {
 	rz_interval_tree_init (&analysis->meta, rz_meta_item_free);
 	sdb_reset (analysis->sdb_types);
 	sdb_reset (analysis->sdb_zigns);
+	rz_sign_index_invalidate (analysis);
 	sdb_reset (analysis->sdb_classes);
 	sdb_reset (analysis->sdb_classes_attrs);
 	rz_analysis_pin_fini (analysis);
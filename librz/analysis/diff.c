@@ -170,121 +170,564 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 	return true;
 }
 
-RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns, RzList *fcns2) {
-	RzAnalysisFunction *fcn, *fcn2, *mfcn, *mfcn2;
-	RzListIter *iter, *iter2;
-	ut64 maxsize, minsize;
-	double t, ot;
+/* Function matching.
+ *
+ * Pairs are found in rounds, each one only looking at the functions left
+ * unmatched by the previous ones:
+ *  - functions with the same name
+ *  - identical fingerprints, through a hashtable
+ *  - callees of matched pairs, called in the same order
+ *  - fingerprints sharing a MinHash band (LSH), or the closest sizes when
+ *    none does. Only these candidates go through the expensive distance,
+ *    smallest size difference first, skipping those that cannot beat the
+ *    best similarity found so far.
+ * The distances of a round are computed on analysis->diff_threads threads
+ * and applied in list order afterwards.
+ */
 
-	if (!analysis) {
-		return false;
+#define DIFF_MINHASH      16 // MinHash values per function
+#define DIFF_BAND_ROWS    2 // MinHash values per LSH band
+#define DIFF_WINDOW       16 // closest sizes tried when no band is shared
+#define DIFF_FCNS_PER_JOB 32
+
+typedef struct {
+	RzAnalysisFunction *fcn;
+	ut64 size; // linear size
+	ut64 hash; // whole fingerprint
+	ut32 minhash[DIFF_MINHASH];
+	bool eligible; // can be matched by content
+	// result of the last parallel round
+	st64 best;
+	double t;
+	ut32 distances;
+} DiffFcn;
+
+typedef struct {
+	ut32 a;
+	ut32 b;
+	double t;
+} DiffPair;
+
+typedef struct {
+	ut64 size;
+	ut32 b;
+} DiffSized;
+
+typedef struct {
+	RzAnalysis *analysis;
+	RzThreadPool *pool;
+	DiffFcn *a;
+	DiffFcn *b;
+	ut32 na;
+	ut32 nb;
+	HtUP /*<ut64, RzVector<ut32>>*/ *exact; // fingerprint hash -> b indices
+	HtUP /*<ut64, RzVector<ut32>>*/ *bands; // band hash -> b indices
+	HtUP /*<ut64, ut32>*/ *a_at; // address -> a index + 1
+	HtUP /*<ut64, ut32>*/ *b_at;
+	DiffSized *by_size; // b sorted by size
+	DiffPair *pairs;
+	RzVector /*<DiffPair>*/ worklist; // pairs whose callees are still to be matched
+	RzAnalysisDiffStats *stats;
+} DiffCtx;
+
+typedef struct {
+	DiffCtx *ctx;
+	ut32 from;
+	ut32 to;
+	void (*fn)(DiffCtx *ctx, ut32 i);
+} DiffJob;
+
+static ut64 diff_hash(ut64 h, const ut8 *buf, size_t len) {
+	size_t i;
+	for (i = 0; i < len; i++) {
+		h = (h ^ buf[i]) * 0x100000001b3ULL;
 	}
-	if (analysis->cur && analysis->cur->diff_fcn) {
-		return (analysis->cur->diff_fcn (analysis, fcns, fcns2));
-	}
-	/* Compare functions with the same name */
-	if (fcns) {
-		rz_list_foreach (fcns, iter, fcn) {
-			rz_list_foreach (fcns2, iter2, fcn2) {
-				if (fcn->name && fcn2->name && strcmp (fcn->name, fcn2->name)) {
-					continue;
-				}
-				rz_diff_buffers_distance (NULL, fcn->fingerprint, fcn->fingerprint_size,
-						fcn2->fingerprint, fcn2->fingerprint_size,
-						NULL, &t);
-				/* Set flag in matched functions */
-				fcn->diff->type = fcn2->diff->type = (t >= 1)
-					? RZ_ANALYSIS_DIFF_TYPE_MATCH
-					: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-				fcn->diff->dist = fcn2->diff->dist = t;
-				RZ_FREE (fcn->fingerprint);
-				RZ_FREE (fcn2->fingerprint);
-				fcn->diff->addr = fcn2->addr;
-				fcn2->diff->addr = fcn->addr;
-				fcn->diff->size = rz_analysis_function_linear_size (fcn2);
-				fcn2->diff->size = rz_analysis_function_linear_size (fcn);
-				RZ_FREE (fcn->diff->name);
-				if (fcn2->name) {
-					fcn->diff->name = strdup (fcn2->name);
-				}
-				RZ_FREE (fcn2->diff->name);
-				if (fcn->name) {
-					fcn2->diff->name = strdup (fcn->name);
-				}
-				rz_analysis_diff_bb (analysis, fcn, fcn2);
-				break;
+	return h;
+}
+
+static void diff_minhash(const ut8 *buf, size_t len, ut32 *out) {
+	size_t i, j;
+	for (i = 0; i < DIFF_MINHASH; i++) {
+		out[i] = UT32_MAX;
+	}
+	for (j = 0; buf && j + 4 <= len; j++) {
+		ut32 h = rz_read_le32 (buf + j) * 0x9e3779b1U;
+		for (i = 0; i < DIFF_MINHASH; i++) {
+			ut32 x = (h ^ ((ut32)(i + 1) * 0x85ebca6bU)) * 0xc2b2ae35U;
+			x ^= x >> 15;
+			if (x < out[i]) {
+				out[i] = x;
 			}
 		}
 	}
-	/* Compare remaining functions */
+}
+
+static bool diff_is_free(const DiffFcn *f) {
+	return f->fcn->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL;
+}
+
+static bool diff_size_ok(DiffCtx *ctx, ut64 s1, ut64 s2) {
+	ut64 maxsize = RZ_MAX (s1, s2);
+	ut64 minsize = RZ_MIN (s1, s2);
+	return !(maxsize * ctx->analysis->diff_thfcn > minsize);
+}
+
+static bool diff_same(const DiffFcn *x, const DiffFcn *y) {
+	const RzAnalysisFunction *f = x->fcn, *f2 = y->fcn;
+	return f->fingerprint && f2->fingerprint && x->hash == y->hash
+		&& f->fingerprint_size == f2->fingerprint_size
+		&& !memcmp (f->fingerprint, f2->fingerprint, f->fingerprint_size);
+}
+
+static double diff_similarity(DiffFcn *x, DiffFcn *y) {
+	double t = 0.0;
+	if (diff_same (x, y)) {
+		return 1.0;
+	}
+	x->distances++;
+	if (!rz_diff_buffers_distance (NULL, x->fcn->fingerprint, x->fcn->fingerprint_size,
+		    y->fcn->fingerprint, y->fcn->fingerprint_size, NULL, &t)) {
+		return 0.0;
+	}
+	return t;
+}
+
+static void diff_job(void *user) {
+	DiffJob *job = user;
+	ut32 i;
+	for (i = job->from; i < job->to; i++) {
+		job->fn (job->ctx, i);
+	}
+}
+
+static void diff_run(DiffCtx *ctx, ut32 n, void (*fn)(DiffCtx *ctx, ut32 i)) {
+	ut32 njobs = (n + DIFF_FCNS_PER_JOB - 1) / DIFF_FCNS_PER_JOB;
+	DiffJob *jobs = ctx->pool && njobs > 1 ? RZ_NEWS0 (DiffJob, njobs) : NULL;
+	ut32 i;
+	if (!jobs) {
+		for (i = 0; i < n; i++) {
+			fn (ctx, i);
+		}
+		return;
+	}
+	for (i = 0; i < njobs; i++) {
+		jobs[i].ctx = ctx;
+		jobs[i].from = i * DIFF_FCNS_PER_JOB;
+		jobs[i].to = RZ_MIN (n, jobs[i].from + DIFF_FCNS_PER_JOB);
+		jobs[i].fn = fn;
+		if (!rz_th_pool_add_job (ctx->pool, diff_job, &jobs[i])) {
+			diff_job (&jobs[i]);
+		}
+	}
+	rz_th_pool_wait (ctx->pool);
+	free (jobs);
+}
+
+static void diff_set(RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2, double t) {
+	fcn->diff->type = (t >= 1) ? RZ_ANALYSIS_DIFF_TYPE_MATCH : RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
+	fcn->diff->dist = t;
+	fcn->diff->addr = fcn2->addr;
+	fcn->diff->size = rz_analysis_function_linear_size (fcn2);
+	RZ_FREE (fcn->diff->name);
+	if (fcn2->name) {
+		fcn->diff->name = strdup (fcn2->name);
+	}
+}
+
+static void diff_match(DiffCtx *ctx, ut32 ia, ut32 ib, double t, ut32 *counter) {
+	RzAnalysisFunction *fcn = ctx->a[ia].fcn;
+	RzAnalysisFunction *fcn2 = ctx->b[ib].fcn;
+	diff_set (fcn, fcn2, t);
+	diff_set (fcn2, fcn, t);
+	RZ_FREE (fcn->fingerprint);
+	RZ_FREE (fcn2->fingerprint);
+	rz_analysis_diff_bb (ctx->analysis, fcn, fcn2);
+	DiffPair pair = { ia, ib, t };
+	rz_vector_push (&ctx->worklist, &pair);
+	(*counter)++;
+	ctx->stats->similarity += t;
+}
+
+static void diff_vector_free(HtUPKv *kv) {
+	rz_vector_free (kv->value);
+}
+
+static void diff_bucket_add(HtUP *ht, ut64 key, ut32 i) {
+	RzVector *v = ht_up_find (ht, key, NULL);
+	if (!v) {
+		v = rz_vector_new (sizeof (ut32), NULL, NULL);
+		if (!v || !ht_up_insert (ht, key, v)) {
+			rz_vector_free (v);
+			return;
+		}
+	}
+	rz_vector_push (v, &i);
+}
+
+static ut64 diff_band_key(const DiffFcn *f, ut32 band) {
+	ut64 h = diff_hash (0xcbf29ce484222325ULL, (const ut8 *)&band, sizeof (band));
+	return diff_hash (h, (const ut8 *)(f->minhash + band * DIFF_BAND_ROWS), DIFF_BAND_ROWS * sizeof (ut32));
+}
+
+static void diff_fcn_init(DiffFcn *f, RzAnalysisFunction *fcn, bool lsh) {
+	f->fcn = fcn;
+	f->size = rz_analysis_function_linear_size (fcn);
+	f->hash = diff_hash (0xcbf29ce484222325ULL, fcn->fingerprint, fcn->fingerprint ? fcn->fingerprint_size : 0);
+	f->eligible = fcn->type == RZ_ANALYSIS_FCN_TYPE_FCN || fcn->type == RZ_ANALYSIS_FCN_TYPE_SYM;
+	f->best = -1;
+	if (lsh) {
+		diff_minhash (fcn->fingerprint, fcn->fingerprint_size, f->minhash);
+	}
+}
+
+static DiffFcn *diff_fcns_new(RzList *fcns, ut32 *n, HtUP **at, bool lsh) {
+	RzAnalysisFunction *fcn;
+	RzListIter *iter;
+	ut32 i = 0;
+	*n = rz_list_length (fcns);
+	DiffFcn *r = RZ_NEWS0 (DiffFcn, *n + 1);
+	if (!r || !(*at = ht_up_new0 ())) {
+		free (r);
+		return NULL;
+	}
 	rz_list_foreach (fcns, iter, fcn) {
-/*
-		if ((fcn->type != RZ_ANALYSIS_FCN_TYPE_FCN &&
-			fcn->type != RZ_ANALYSIS_FCN_TYPE_SYM) ||
-			fcn->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
+		diff_fcn_init (&r[i], fcn, lsh);
+		ht_up_insert (*at, fcn->addr, (void *)(size_t)(i + 1));
+		i++;
+	}
+	return r;
+}
+
+static void diff_name_job(DiffCtx *ctx, ut32 i) {
+	DiffPair *p = &ctx->pairs[i];
+	p->t = diff_similarity (&ctx->a[p->a], &ctx->b[p->b]);
+}
+
+static void diff_by_name(DiffCtx *ctx) {
+	HtPP *names = ht_pp_new0 ();
+	ut32 i, n = 0;
+	if (!names) {
+		return;
+	}
+	for (i = ctx->nb; i-- > 0;) {
+		if (ctx->b[i].fcn->name) {
+			ht_pp_update (names, ctx->b[i].fcn->name, (void *)(size_t)(i + 1));
+		}
+	}
+	ctx->pairs = RZ_NEWS0 (DiffPair, ctx->na + 1);
+	for (i = 0; ctx->pairs && i < ctx->na; i++) {
+		const char *name = ctx->a[i].fcn->name;
+		size_t j = name ? (size_t)ht_pp_find (names, name, NULL) : 0;
+		if (j) {
+			ctx->pairs[n].a = i;
+			ctx->pairs[n].b = j - 1;
+			n++;
+		}
+	}
+	ht_pp_free (names);
+	diff_run (ctx, n, diff_name_job);
+	for (i = 0; i < n; i++) {
+		DiffPair *p = &ctx->pairs[i];
+		if (diff_is_free (&ctx->b[p->b])) {
+			diff_match (ctx, p->a, p->b, p->t, &ctx->stats->by_name);
+		}
+	}
+	RZ_FREE (ctx->pairs);
+}
+
+static void diff_by_hash(DiffCtx *ctx) {
+	ut32 i, *j;
+	for (i = 0; i < ctx->na; i++) {
+		DiffFcn *x = &ctx->a[i];
+		RzVector *bucket = diff_is_free (x) && x->fcn->fingerprint
+			? ht_up_find (ctx->exact, x->hash, NULL) : NULL;
+		if (!bucket) {
 			continue;
 		}
-*/
-		if (fcn->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
+		rz_vector_foreach (bucket, j) {
+			DiffFcn *y = &ctx->b[*j];
+			if (diff_is_free (y) && diff_size_ok (ctx, x->size, y->size) && diff_same (x, y)) {
+				diff_match (ctx, i, *j, 1.0, &ctx->stats->by_hash);
+				break;
+			}
+		}
+	}
+}
+
+static void diff_callees(DiffCtx *ctx, RzAnalysisFunction *fcn, HtUP *at, RzVector *out) {
+	RzList *refs = rz_analysis_function_get_refs (fcn);
+	RzAnalysisRef *ref;
+	RzListIter *iter;
+	rz_vector_clear (out);
+	rz_list_foreach (refs, iter, ref) {
+		ut32 k = ref->type == RZ_ANALYSIS_REF_TYPE_CALL ? (ut32)(size_t)ht_up_find (at, ref->addr, NULL) : 0;
+		ut32 *it;
+		bool dup = false;
+		if (!k) {
 			continue;
 		}
-		ot = 0;
-		mfcn = mfcn2 = NULL;
-		rz_list_foreach (fcns2, iter2, fcn2) {
-			ut64 fcn_size = rz_analysis_function_linear_size (fcn);
-			ut64 fcn2_size = rz_analysis_function_linear_size (fcn2);
-			if (fcn_size > fcn2_size) {
-				maxsize = fcn_size;
-				minsize = fcn2_size;
-			} else {
-				maxsize = fcn2_size;
-				minsize = fcn_size;
+		rz_vector_foreach (out, it) {
+			if (*it == k - 1) {
+				dup = true;
+				break;
 			}
-			if (maxsize * analysis->diff_thfcn > minsize) {
-				eprintf ("Exceeded analysis threshold while diffing %s and %s\n", fcn->name, fcn2->name);
+		}
+		if (!dup) {
+			k--;
+			rz_vector_push (out, &k);
+		}
+	}
+	rz_list_free (refs);
+}
+
+static void diff_by_callgraph(DiffCtx *ctx) {
+	RzVector ca, cb;
+	rz_vector_init (&ca, sizeof (ut32), NULL, NULL);
+	rz_vector_init (&cb, sizeof (ut32), NULL, NULL);
+	while (!rz_vector_empty (&ctx->worklist)) {
+		DiffPair pair;
+		rz_vector_pop (&ctx->worklist, &pair);
+		diff_callees (ctx, ctx->a[pair.a].fcn, ctx->a_at, &ca);
+		diff_callees (ctx, ctx->b[pair.b].fcn, ctx->b_at, &cb);
+		if (rz_vector_len (&ca) != rz_vector_len (&cb)) {
+			continue;
+		}
+		size_t k;
+		for (k = 0; k < rz_vector_len (&ca); k++) {
+			ut32 ia = *(ut32 *)rz_vector_index_ptr (&ca, k);
+			ut32 ib = *(ut32 *)rz_vector_index_ptr (&cb, k);
+			DiffFcn *x = &ctx->a[ia], *y = &ctx->b[ib];
+			if (!diff_is_free (x) || !diff_is_free (y) || !y->eligible || !diff_size_ok (ctx, x->size, y->size)) {
 				continue;
 			}
-			if (fcn2->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-				eprintf ("Function %s already diffed\n", fcn2->name);
-				continue;
+			double t = diff_similarity (x, y);
+			if (t > ctx->analysis->diff_thfcn) {
+				diff_match (ctx, ia, ib, t, &ctx->stats->by_callgraph);
 			}
-			if ((fcn2->type != RZ_ANALYSIS_FCN_TYPE_FCN && fcn2->type != RZ_ANALYSIS_FCN_TYPE_SYM)) {
-				eprintf ("Function %s type not supported\n", fcn2->name);
-				continue;
+		}
+	}
+	rz_vector_fini (&ca);
+	rz_vector_fini (&cb);
+}
+
+typedef struct {
+	ut32 b;
+	ut32 delta;
+} DiffCandidate;
+
+static int diff_candidate_cmp(const void *x, const void *y) {
+	const DiffCandidate *a = x, *b = y;
+	if (a->delta != b->delta) {
+		return a->delta < b->delta ? -1 : 1;
+	}
+	return a->b < b->b ? -1 : a->b > b->b;
+}
+
+static bool diff_candidate_ok(DiffCtx *ctx, DiffFcn *x, ut32 j) {
+	DiffFcn *y = &ctx->b[j];
+	return y->eligible && diff_is_free (y) && diff_size_ok (ctx, x->size, y->size);
+}
+
+static void diff_candidate_push(DiffFcn *x, DiffFcn *y, ut32 j, RzVector *out) {
+	size_t s = x->fcn->fingerprint_size, s2 = y->fcn->fingerprint_size;
+	DiffCandidate c = { j, (ut32)RZ_MIN (s > s2 ? s - s2 : s2 - s, UT32_MAX) };
+	rz_vector_push (out, &c);
+}
+
+static ut32 diff_size_lower_bound(DiffCtx *ctx, ut64 size) {
+	ut32 lo = 0, hi = ctx->nb;
+	while (lo < hi) {
+		ut32 mid = lo + (hi - lo) / 2;
+		if (ctx->by_size[mid].size < size) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static void diff_best(DiffCtx *ctx, ut32 i) {
+	DiffFcn *x = &ctx->a[i];
+	RzVector cands;
+	ut32 band, *j;
+	x->best = -1;
+	x->t = 0.0;
+	if (!diff_is_free (x) || !x->fcn->fingerprint) {
+		return;
+	}
+	rz_vector_init (&cands, sizeof (DiffCandidate), NULL, NULL);
+	for (band = 0; band < DIFF_MINHASH / DIFF_BAND_ROWS; band++) {
+		RzVector *bucket = ht_up_find (ctx->bands, diff_band_key (x, band), NULL);
+		if (!bucket) {
+			continue;
+		}
+		rz_vector_foreach (bucket, j) {
+			if (diff_candidate_ok (ctx, x, *j)) {
+				diff_candidate_push (x, &ctx->b[*j], *j, &cands);
 			}
-			rz_diff_buffers_distance (NULL, fcn->fingerprint, fcn->fingerprint_size, fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
-			fcn->diff->dist = fcn2->diff->dist = t;
-			if (t > analysis->diff_thfcn && t > ot) {
-				ot = t;
-				mfcn = fcn;
-				mfcn2 = fcn2;
-				if (t == 1) {
-					break;
+		}
+	}
+	if (rz_vector_empty (&cands)) {
+		// no shared band, try the functions with the closest sizes
+		ut32 hi = diff_size_lower_bound (ctx, x->size), lo = hi, n = 0;
+		while (n < DIFF_WINDOW && (lo > 0 || hi < ctx->nb)) {
+			bool down = lo > 0 && (hi >= ctx->nb || x->size - ctx->by_size[lo - 1].size < ctx->by_size[hi].size - x->size);
+			ut32 k = down ? ctx->by_size[--lo].b : ctx->by_size[hi++].b;
+			if (!diff_size_ok (ctx, x->size, ctx->b[k].size)) {
+				// everything further in this direction is out of range too
+				if (down) {
+					lo = 0;
+				} else {
+					hi = ctx->nb;
 				}
+				continue;
+			}
+			if (diff_candidate_ok (ctx, x, k)) {
+				diff_candidate_push (x, &ctx->b[k], k, &cands);
+				n++;
 			}
 		}
-		if (mfcn && mfcn2) {
-			/* Set flag in matched functions */
-			mfcn->diff->type = mfcn2->diff->type = (ot == 1)
-				? RZ_ANALYSIS_DIFF_TYPE_MATCH
-				: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-			RZ_FREE (mfcn->fingerprint);
-			RZ_FREE (mfcn2->fingerprint);
-			mfcn->diff->addr = mfcn2->addr;
-			mfcn2->diff->addr = mfcn->addr;
-			mfcn->diff->size = rz_analysis_function_linear_size (mfcn2);
-			mfcn2->diff->size = rz_analysis_function_linear_size (mfcn);
-			RZ_FREE (mfcn->diff->name);
-			if (mfcn2->name) {
-				mfcn->diff->name = strdup (mfcn2->name);
+	}
+	qsort (cands.a, cands.len, sizeof (DiffCandidate), diff_candidate_cmp);
+	ut32 last = UT32_MAX;
+	DiffCandidate *c;
+	rz_vector_foreach (&cands, c) {
+		if (c->b == last) {
+			continue;
+		}
+		last = c->b;
+		DiffFcn *y = &ctx->b[c->b];
+		double s = x->fcn->fingerprint_size, s2 = y->fcn->fingerprint_size;
+		// the distance is at least the size difference
+		if (s && s2 && RZ_MIN (s, s2) / RZ_MAX (s, s2) <= x->t) {
+			continue;
+		}
+		double t = diff_similarity (x, y);
+		if (t > ctx->analysis->diff_thfcn && t > x->t) {
+			x->t = t;
+			x->best = c->b;
+			if (t == 1) {
+				break;
 			}
-			RZ_FREE (mfcn2->diff->name);
-			if (mfcn->name) {
-				mfcn2->diff->name = strdup (mfcn->name);
+		}
+	}
+	rz_vector_fini (&cands);
+}
+
+static void diff_by_similarity(DiffCtx *ctx) {
+	ut32 i;
+	diff_run (ctx, ctx->na, diff_best);
+	for (i = 0; i < ctx->na; i++) {
+		DiffFcn *x = &ctx->a[i];
+		if (x->best < 0 || !diff_is_free (x)) {
+			continue;
+		}
+		if (!diff_is_free (&ctx->b[x->best])) {
+			// taken by a previous function, the candidates only got fewer
+			diff_best (ctx, i);
+			if (x->best < 0) {
+				continue;
 			}
-			rz_analysis_diff_bb (analysis, mfcn, mfcn2);
 		}
+		diff_match (ctx, i, x->best, x->t, &ctx->stats->by_similarity);
+	}
+}
+
+static int diff_size_cmp(const void *x, const void *y) {
+	const DiffSized *a = x, *b = y;
+	if (a->size != b->size) {
+		return a->size < b->size ? -1 : 1;
+	}
+	return a->b < b->b ? -1 : a->b > b->b;
+}
+
+static bool diff_ctx_init(DiffCtx *ctx, RzAnalysis *analysis, RzList *fcns, RzList *fcns2) {
+	ut32 i, band;
+	memset (ctx, 0, sizeof (*ctx));
+	ctx->analysis = analysis;
+	ctx->stats = &analysis->diff_stats;
+	rz_vector_init (&ctx->worklist, sizeof (DiffPair), NULL, NULL);
+	ctx->a = diff_fcns_new (fcns, &ctx->na, &ctx->a_at, true);
+	ctx->b = diff_fcns_new (fcns2, &ctx->nb, &ctx->b_at, true);
+	ctx->exact = ht_up_new (NULL, diff_vector_free, NULL);
+	ctx->bands = ht_up_new (NULL, diff_vector_free, NULL);
+	ctx->by_size = RZ_NEWS (DiffSized, ctx->nb + 1);
+	if (!ctx->a || !ctx->b || !ctx->exact || !ctx->bands || !ctx->by_size) {
+		return false;
+	}
+	for (i = 0; i < ctx->nb; i++) {
+		DiffFcn *y = &ctx->b[i];
+		ctx->by_size[i].size = y->size;
+		ctx->by_size[i].b = i;
+		if (!y->eligible || !y->fcn->fingerprint) {
+			continue;
+		}
+		diff_bucket_add (ctx->exact, y->hash, i);
+		for (band = 0; band < DIFF_MINHASH / DIFF_BAND_ROWS; band++) {
+			diff_bucket_add (ctx->bands, diff_band_key (y, band), i);
+		}
+	}
+	qsort (ctx->by_size, ctx->nb, sizeof (DiffSized), diff_size_cmp);
+	int threads = analysis->diff_threads > 0 ? analysis->diff_threads : rz_th_ncores ();
+	if (threads > 1 && ctx->na > DIFF_FCNS_PER_JOB) {
+		ctx->pool = rz_th_pool_new (threads);
+	}
+	return true;
+}
+static void diff_ctx_fini(DiffCtx *ctx) {
+	rz_th_pool_free (ctx->pool);
+	ht_up_free (ctx->exact);
+	ht_up_free (ctx->bands);
+	ht_up_free (ctx->a_at);
+	ht_up_free (ctx->b_at);
+	rz_vector_fini (&ctx->worklist);
+	free (ctx->by_size);
+	free (ctx->pairs);
+	free (ctx->a);
+	free (ctx->b);
+}
+
+static ut32 diff_distances(DiffFcn *f, ut32 n) {
+	ut32 i, r = 0;
+	for (i = 0; i < n; i++) {
+		r += f[i].distances;
+	}
+	return r;
+}
+
+RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns, RzList *fcns2) {
+	rz_return_val_if_fail (analysis, false);
+	DiffCtx ctx;
+	RzAnalysisDiffStats *stats = &analysis->diff_stats;
+
+	if (analysis->cur && analysis->cur->diff_fcn) {
+		return analysis->cur->diff_fcn (analysis, fcns, fcns2);
+	}
+
+	memset (stats, 0, sizeof (*stats));
+	ut64 start = rz_time_now_mono ();
+	if (!diff_ctx_init (&ctx, analysis, fcns, fcns2)) {
+		diff_ctx_fini (&ctx);
+		return false;
+	}
+	stats->fcns = ctx.na;
+	stats->fcns2 = ctx.nb;
+	ut64 indexed = rz_time_now_mono ();
+	stats->index_time = indexed - start;
+
+	diff_by_name (&ctx);
+	diff_by_hash (&ctx);
+	diff_by_callgraph (&ctx);
+	diff_by_similarity (&ctx);
+
+	ut32 matched = stats->by_name + stats->by_hash + stats->by_callgraph + stats->by_similarity;
+	if (matched) {
+		stats->similarity /= matched;
 	}
+	stats->distances = diff_distances (ctx.a, ctx.na);
+	stats->match_time = rz_time_now_mono () - indexed;
+	diff_ctx_fini (&ctx);
 	return true;
 }
 
@@ -31,6 +31,62 @@ static inline ut64 genmask(int bits) {
 
 #define ERR(x) if (esil->verbose) { eprintf ("%s\n", x); }
 
+/* see "Compiled expressions" below */
+typedef struct {
+	const char *str;
+	RzAnalysisEsilOp *op;
+	bool isnum; // immediate, num holds its value
+	ut64 num;
+	int reg; // register handle (see rz_reg_index_of) or -1
+} EsilWord;
+
+typedef struct rz_analysis_esil_program_t {
+	char *src;
+	char *text; // src with the separators replaced by NUL
+	EsilWord *words; // NULL if the expression must be interpreted
+	int nwords;
+	RzReg *reg; // register profile the handles were resolved in
+	ut32 reg_gen;
+	int refs;
+} EsilProgram;
+
+/* find the word of \p prog that \p name points to, the words are in
+ * address order and the ops get the names of the compiled words back from
+ * the stack as these same pointers */
+static const EsilWord *esil_program_word(const EsilProgram *prog, const char *name) {
+	int lo = 0, hi = prog->nwords - 1;
+	if (!prog->words || name < prog->words[0].str || name > prog->words[hi].str) {
+		return NULL;
+	}
+	while (lo <= hi) {
+		int mid = (lo + hi) / 2;
+		const EsilWord *w = &prog->words[mid];
+		if (w->str == name) {
+			return w;
+		}
+		if (w->str < name) {
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return NULL;
+}
+
+/* look up a register operand, the words of the expression being run have
+ * their handles resolved already so only other names hit the hashtables */
+static RzRegItem *esil_reg_get(RzAnalysisEsil *esil, const char *name) {
+	RzReg *reg = esil->analysis->reg;
+	const EsilProgram *prog = esil->program;
+	if (prog && reg && prog->reg == reg && prog->reg_gen == reg->profile_gen) {
+		const EsilWord *w = esil_program_word (prog, name);
+		if (w) {
+			return rz_reg_index_get (reg, w->reg);
+		}
+	}
+	return rz_reg_get (reg, name, -1);
+}
+
 static bool isnum(RzAnalysisEsil *esil, const char *str, ut64 *num) {
 	if (!esil || !str) {
 		return false;
@@ -48,7 +104,7 @@ static bool isnum(RzAnalysisEsil *esil, const char *str, ut64 *num) {
 }
 
 static bool ispackedreg(RzAnalysisEsil *esil, const char *str) {
-	RzRegItem *ri = rz_reg_get (esil->analysis->reg, str, -1);
+	RzRegItem *ri = esil_reg_get (esil, str);
 	return ri? ri->packed_size > 0: false;
 }
 
@@ -61,12 +117,148 @@ static bool isregornum(RzAnalysisEsil *esil, const char *str, ut64 *num) {
 	return true;
 }
 
+/* Typed stack
+ *
+ * The ops push their results as numbers and the compiled expressions push
+ * their words as they are, an entry only becomes a string when it is
+ * popped with rz_analysis_esil_pop (). The ops converted to pop values get
+ * the numbers and the immediates without going through a string at all.
+ * esil->stack[i] holds the string of the ESIL_VALUE_STR entries and is
+ * NULL for the others.
+ */
+typedef enum {
+	ESIL_VALUE_NONE = 0,
+	ESIL_VALUE_STR,
+	ESIL_VALUE_NUM,
+	ESIL_VALUE_WORD
+} EsilValueType;
+
+typedef struct rz_analysis_esil_value_t {
+	EsilValueType type;
+	char *str; // ESIL_VALUE_STR, owned once popped
+	ut64 num; // ESIL_VALUE_NUM
+	const EsilWord *word; // ESIL_VALUE_WORD, prog is referenced until popped
+	EsilProgram *prog;
+	char buf[24]; // ESIL_VALUE_NUM formatted on demand
+} EsilValue;
+
+static void esil_program_unref(EsilProgram *prog);
+
+static bool esil_push_value(RzAnalysisEsil *esil, const EsilValue *v) {
+	if (esil->stackptr > (esil->stacksize - 1)) {
+		return false;
+	}
+	esil->stack[esil->stackptr] = v->type == ESIL_VALUE_STR? v->str: NULL;
+	esil->values[esil->stackptr++] = *v;
+	return true;
+}
+
+static bool esil_push_word(RzAnalysisEsil *esil, EsilProgram *prog, const EsilWord *w) {
+	EsilValue v = { .type = ESIL_VALUE_WORD, .word = w, .prog = prog };
+	if (!esil_push_value (esil, &v)) {
+		return false;
+	}
+	prog->refs++;
+	return true;
+}
+
+/* \p v must be released with esil_value_fini (), fails on an empty stack
+ * or entry like rz_analysis_esil_pop () returning NULL */
+static bool esil_pop_value(RzAnalysisEsil *esil, EsilValue *v) {
+	if (esil->stackptr < 1) {
+		v->type = ESIL_VALUE_NONE;
+		return false;
+	}
+	esil->stackptr--;
+	*v = esil->values[esil->stackptr];
+	if (v->type == ESIL_VALUE_STR) {
+		v->str = esil->stack[esil->stackptr];
+		if (!v->str) {
+			v->type = ESIL_VALUE_NONE;
+			return false;
+		}
+	}
+	return true;
+}
+
+static void esil_value_fini(EsilValue *v) {
+	switch (v->type) {
+	case ESIL_VALUE_STR:
+		free (v->str);
+		break;
+	case ESIL_VALUE_WORD:
+		esil_program_unref (v->prog);
+		break;
+	default:
+		break;
+	}
+	v->type = ESIL_VALUE_NONE;
+}
+
+/* the string rz_analysis_esil_pop () would return, owned by \p v */
+static const char *esil_value_name(EsilValue *v) {
+	switch (v->type) {
+	case ESIL_VALUE_STR:
+		return v->str;
+	case ESIL_VALUE_NUM:
+		snprintf (v->buf, sizeof (v->buf), "0x%" PFMT64x, v->num);
+		return v->buf;
+	case ESIL_VALUE_WORD:
+		return v->word->str;
+	default:
+		return NULL;
+	}
+}
+
+/* rz_analysis_esil_get_parm () of a popped value */
+static bool esil_value_parm(RzAnalysisEsil *esil, EsilValue *v, ut64 *num) {
+	switch (v->type) {
+	case ESIL_VALUE_NUM:
+		*num = v->num;
+		return true;
+	case ESIL_VALUE_WORD:
+		if (v->word->isnum) {
+			*num = v->word->num;
+			return true;
+		}
+		return rz_analysis_esil_get_parm (esil, v->word->str, num);
+	case ESIL_VALUE_STR:
+		return v->str && rz_analysis_esil_get_parm (esil, v->str, num);
+	default:
+		return false;
+	}
+}
+
+/* isregornum () of a popped value, numbers are tried as register names
+ * first there so they only skip that when no hook may see them */
+static bool esil_value_regornum(RzAnalysisEsil *esil, EsilValue *v, ut64 *num) {
+	if (esil->cb.hook_reg_read) {
+		const char *name = esil_value_name (v);
+		return name && isregornum (esil, name, num);
+	}
+	switch (v->type) {
+	case ESIL_VALUE_NUM:
+		*num = v->num;
+		return true;
+	case ESIL_VALUE_WORD:
+		if (v->word->isnum) {
+			*num = v->word->num;
+			return true;
+		}
+		return isregornum (esil, v->word->str, num);
+	case ESIL_VALUE_STR:
+		return v->str && isregornum (esil, v->str, num);
+	default:
+		return false;
+	}
+}
+
 /* pop Register or Number */
 static bool popRN(RzAnalysisEsil *esil, ut64 *n) {
-	char *str = rz_analysis_esil_pop (esil);
-	if (str) {
-		bool ret = isregornum (esil, str, n);
-		free (str);
+	EsilValue v;
+	if (esil_pop_value (esil, &v)) {
+		bool ret = esil_value_regornum (esil, &v, n);
+		esil_value_fini (&v);
 		return ret;
 	}
 	return false;
@@ -92,6 +284,11 @@ RZ_API RzAnalysisEsil *rz_analysis_esil_new(int stacksize, int iotrap, unsigned
 		free (esil);
 		return NULL;
 	}
+	if (!(esil->values = calloc (sizeof (EsilValue), stacksize))) {
+		free (esil->stack);
+		free (esil);
+		return NULL;
+	}
 	esil->verbose = false;
 	esil->stacksize = stacksize;
 	esil->parse_goto_count = RZ_ANALYSIS_ESIL_GOTO_LIMIT;
@@ -117,6 +314,8 @@ RZ_API bool rz_analysis_esil_set_op(RzAnalysisEsil *esil, const char *op, RzAnal
 			free (eop);
 			return false;
 		}
+		// words compiled as plain values may be this operator now
+		rz_analysis_esil_compiled_flush (esil);
 	}
 	eop->push = push;
 	eop->pop = pop;
@@ -163,6 +362,7 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 	if (esil->analysis && esil == esil->analysis->esil) {
 		esil->analysis->esil = NULL;
 	}
+	rz_analysis_esil_compiled_flush (esil);
 	ht_pp_free (esil->ops);
 	esil->ops = NULL;
 	rz_analysis_esil_interrupts_fini (esil);
@@ -171,6 +371,7 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 	esil->stats = NULL;
 	rz_analysis_esil_stack_free (esil);
 	free (esil->stack);
+	free (esil->values);
 	if (esil->analysis && esil->analysis->cur && esil->analysis->cur->esil_fini) {
 		esil->analysis->cur->esil_fini (esil);
 	}
@@ -188,7 +389,7 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 
 static ut8 esil_internal_sizeof_reg(RzAnalysisEsil *esil, const char *r) {
 	rz_return_val_if_fail (esil && esil->analysis && esil->analysis->reg && r, 0);
-	RzRegItem *ri = rz_reg_get (esil->analysis->reg, r, -1);
+	RzRegItem *ri = esil_reg_get (esil, r);
 	return ri? ri->size: 0;
 }
 
@@ -363,7 +564,7 @@ RZ_API int rz_analysis_esil_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8
 }
 
 static int internal_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut64 *num, int *size) {
-	RzRegItem *reg = rz_reg_get (esil->analysis->reg, regname, -1);
+	RzRegItem *reg = esil_reg_get (esil, regname);
 	if (reg) {
 		if (size) {
 			*size = reg->size;
@@ -378,7 +579,7 @@ static int internal_esil_reg_read(RzAnalysisEsil *esil, const char *regname, ut6
 
 static int internal_esil_reg_write(RzAnalysisEsil *esil, const char *regname, ut64 num) {
 	if (esil && esil->analysis) {
-		RzRegItem *reg = rz_reg_get (esil->analysis->reg, regname, -1);
+		RzRegItem *reg = esil_reg_get (esil, regname);
 		if (reg) {
 			rz_reg_set_value (esil->analysis->reg, reg, num);
 			return true;
@@ -390,7 +591,7 @@ static int internal_esil_reg_write(RzAnalysisEsil *esil, const char *regname, ut
 static int internal_esil_reg_write_no_null (RzAnalysisEsil *esil, const char *regname, ut64 num) {
 	rz_return_val_if_fail (esil && esil->analysis && esil->analysis->reg, false);
 
-	RzRegItem *reg = rz_reg_get (esil->analysis->reg, regname, -1);
+	RzRegItem *reg = esil_reg_get (esil, regname);
 	const char *pc = rz_reg_get_name (esil->analysis->reg, RZ_REG_NAME_PC);
 	const char *sp = rz_reg_get_name (esil->analysis->reg, RZ_REG_NAME_SP);
 	const char *bp = rz_reg_get_name (esil->analysis->reg, RZ_REG_NAME_BP);
@@ -415,25 +616,32 @@ static int internal_esil_reg_write_no_null (RzAnalysisEsil *esil, const char *re
 }
 
 RZ_API bool rz_analysis_esil_pushnum(RzAnalysisEsil *esil, ut64 num) {
-	char str[64];
-	snprintf (str, sizeof (str) - 1, "0x%" PFMT64x, num);
-	return rz_analysis_esil_push (esil, str);
+	rz_return_val_if_fail (esil, false);
+	EsilValue v = { .type = ESIL_VALUE_NUM, .num = num };
+	return esil_push_value (esil, &v);
 }
 
 RZ_API bool rz_analysis_esil_push(RzAnalysisEsil *esil, const char *str) {
 	if (!str || !esil || !*str || esil->stackptr > (esil->stacksize - 1)) {
 		return false;
 	}
-	esil->stack[esil->stackptr++] = strdup (str);
-	return true;
+	EsilValue v = { .type = ESIL_VALUE_STR, .str = strdup (str) };
+	return esil_push_value (esil, &v);
 }
 
 RZ_API char *rz_analysis_esil_pop(RzAnalysisEsil *esil) {
 	rz_return_val_if_fail (esil, NULL);
-	if (esil->stackptr < 1) {
+	EsilValue v;
+	if (!esil_pop_value (esil, &v)) {
 		return NULL;
 	}
-	return esil->stack[--esil->stackptr];
+	if (v.type == ESIL_VALUE_STR) {
+		return v.str;
+	}
+	const char *name = esil_value_name (&v);
+	char *str = name? strdup (name): NULL;
+	esil_value_fini (&v);
+	return str;
 }
 
 RZ_API int rz_analysis_esil_get_parm_type(RzAnalysisEsil *esil, const char *str) {
@@ -455,7 +663,7 @@ RZ_API int rz_analysis_esil_get_parm_type(RzAnalysisEsil *esil, const char *str)
 	}
 	return RZ_ANALYSIS_ESIL_PARM_NUM;
 not_a_number:
-	if (rz_reg_get (esil->analysis->reg, str, -1)) {
+	if (esil_reg_get (esil, str)) {
 		return RZ_ANALYSIS_ESIL_PARM_REG;
 	}
 	return RZ_ANALYSIS_ESIL_PARM_INVALID;
@@ -752,27 +960,32 @@ static bool esil_weak_eq(RzAnalysisEsil *esil) {
 static bool esil_eq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (!src || !dst) {
+	EsilValue dst_val, src_val;
+	bool have_dst = esil_pop_value (esil, &dst_val);
+	bool have_src = esil_pop_value (esil, &src_val);
+	const char *dst = esil_value_name (&dst_val);
+	if (!have_src || !have_dst) {
+		esil_value_fini (&src_val);
+		esil_value_fini (&dst_val);
 		if (esil->verbose) {
 			eprintf ("Missing elements in the esil stack for '=' at 0x%08"PFMT64x"\n", esil->address);
 		}
 		return false;
 	}
 	if (ispackedreg (esil, dst)) {
-		char *src2 = rz_analysis_esil_pop (esil);
+		EsilValue src2_val;
+		esil_pop_value (esil, &src2_val);
 		char *newreg = rz_str_newf ("%sl", dst);
-		if (rz_analysis_esil_get_parm (esil, src2, &num2)) {
+		if (esil_value_parm (esil, &src2_val, &num2)) {
 			ret = rz_analysis_esil_reg_write (esil, newreg, num2);
 		}
 		free (newreg);
-		free (src2);
+		esil_value_fini (&src2_val);
 		goto beach;
 	}
 
-	if (src && dst && rz_analysis_esil_reg_read_nocallback (esil, dst, &num, NULL)) {
-		if (rz_analysis_esil_get_parm (esil, src, &num2)) {
+	if (rz_analysis_esil_reg_read_nocallback (esil, dst, &num, NULL)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			ret = rz_analysis_esil_reg_write (esil, dst, num2);
 			esil->cur = num2;
 			esil->old = num;
@@ -785,31 +998,31 @@ static bool esil_eq(RzAnalysisEsil *esil) {
 	}
 
 beach:
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_neg(RzAnalysisEsil *esil) {
 	bool ret = false;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src) {
+	EsilValue src_val;
+	if (esil_pop_value (esil, &src_val)) {
 		ut64 num;
-		if (rz_analysis_esil_get_parm (esil, src, &num)) {
+		if (esil_value_parm (esil, &src_val, &num)) {
 			rz_analysis_esil_pushnum (esil, !num);
 			ret = true;
 		} else {
-			if (isregornum (esil, src, &num)) {
+			if (esil_value_regornum (esil, &src_val, &num)) {
 				ret = true;
 				rz_analysis_esil_pushnum (esil, !num);
 			} else {
-				eprintf ("0x%08"PFMT64x" esil_neg: unknown reg %s\n", esil->address, src);
+				eprintf ("0x%08"PFMT64x" esil_neg: unknown reg %s\n", esil->address, esil_value_name (&src_val));
 			}
 		}
 	} else {
 		ERR ("esil_neg: empty stack");
 	}
-	free (src);
+	esil_value_fini (&src_val);
 	return ret;
 }
 
@@ -836,10 +1049,13 @@ static bool esil_nop(RzAnalysisEsil *esil) {
 static bool esil_andeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	const char *dst = esil_value_name (&dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
 	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			esil->old = num;
 			esil->cur = num & num2;
 			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
@@ -849,18 +1065,21 @@ static bool esil_andeq(RzAnalysisEsil *esil) {
 			ERR ("esil_andeq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_oreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	const char *dst = esil_value_name (&dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
 	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			esil->old = num;
 			esil->cur = num | num2;
 			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
@@ -869,18 +1088,21 @@ static bool esil_oreq(RzAnalysisEsil *esil) {
 			ERR ("esil_ordeq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_xoreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	const char *dst = esil_value_name (&dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
 	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 				esil->old = num;
 				esil->cur = num ^ num2;
 				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
@@ -889,8 +1111,8 @@ static bool esil_xoreq(RzAnalysisEsil *esil) {
 			ERR ("esil_xoreq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
@@ -985,16 +1207,20 @@ static bool esil_interrupt(RzAnalysisEsil *esil) {
 static bool esil_cmp(RzAnalysisEsil *esil) {
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &dst_val, &num)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
+			const char *dst = esil_value_name (&dst_val);
+			const char *src = esil_value_name (&src_val);
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
+			if (esil_reg_get (esil, dst)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
+			} else if (esil_reg_get (esil, src)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, src);
 			} else {
 				// default size is set to 64 as internally operands are ut64
@@ -1002,8 +1228,8 @@ static bool esil_cmp(RzAnalysisEsil *esil) {
 			}
 		}
 	}
-	free (dst);
-	free (src);
+	esil_value_fini (&dst_val);
+	esil_value_fini (&src_val);
 	return ret;
 }
 
@@ -1072,13 +1298,14 @@ static bool esil_if(RzAnalysisEsil *esil) {
 		esil->skip++;
 		return true;
 	}
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &num)) {
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &src_val, &num)) {
 		// condition not matching, skipping until
 		if (!num) {
 			esil->skip++;
 		}
-		free (src);
+		esil_value_fini (&src_val);
 		return true;
 	}
 	return false;
@@ -1087,10 +1314,12 @@ static bool esil_if(RzAnalysisEsil *esil) {
 static bool esil_lsl(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &dst_val, &num)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			if (num2 > sizeof (ut64) * 8) {
 				ERR ("esil_lsl: shift is too big");
 			} else {
@@ -1105,18 +1334,21 @@ static bool esil_lsl(RzAnalysisEsil *esil) {
 			ERR ("esil_lsl: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_lsleq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	const char *dst = esil_value_name (&dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
 	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			if (num2 > sizeof (ut64) * 8) {
 				ERR ("esil_lsleq: shift is too big");
 			} else {
@@ -1135,18 +1367,20 @@ static bool esil_lsleq(RzAnalysisEsil *esil) {
 			ERR ("esil_lsleq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_lsr(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &dst_val, &num)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			ut64 res = num >> RZ_MIN (num2, 63);
 			rz_analysis_esil_pushnum (esil, res);
 			ret = true;
@@ -1154,18 +1388,21 @@ static bool esil_lsr(RzAnalysisEsil *esil) {
 			ERR ("esil_lsr: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_lsreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	const char *dst = esil_value_name (&dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
 	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			if (num2 > 63) {
 				if (esil->verbose) {
 					eprintf ("Invalid shift at 0x%08"PFMT64x"\n", esil->address);
@@ -1182,8 +1419,8 @@ static bool esil_lsreq(RzAnalysisEsil *esil) {
 			ERR ("esil_lsreq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
@@ -1357,10 +1594,12 @@ static bool esil_rol(RzAnalysisEsil *esil) {
 static bool esil_and(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &dst_val, &num)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			num &= num2;
 			rz_analysis_esil_pushnum (esil, num);
 			ret = true;
@@ -1368,18 +1607,20 @@ static bool esil_and(RzAnalysisEsil *esil) {
 			ERR ("esil_and: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_xor(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &dst_val, &num)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			num ^= num2;
 			rz_analysis_esil_pushnum (esil, num);
 			ret = true;
@@ -1387,18 +1628,20 @@ static bool esil_xor(RzAnalysisEsil *esil) {
 			ERR ("esil_xor: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_or(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &dst_val, &num)) {
+		if (esil_value_parm (esil, &src_val, &num2)) {
 			num |= num2;
 			rz_analysis_esil_pushnum (esil, num);
 			ret = true;
@@ -1406,8 +1649,8 @@ static bool esil_or(RzAnalysisEsil *esil) {
 			ERR ("esil_xor: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
@@ -1446,7 +1689,11 @@ RZ_API bool rz_analysis_esil_dumpstack(RzAnalysisEsil *esil) {
 		return false;
 	}
 	for (i = esil->stackptr - 1; i >= 0; i--) {
-		esil->analysis->cb_printf ("%s\n", esil->stack[i]);
+		EsilValue v = esil->values[i];
+		if (v.type == ESIL_VALUE_STR) {
+			v.str = esil->stack[i];
+		}
+		esil->analysis->cb_printf ("%s\n", esil_value_name (&v));
 	}
 	return true;
 }
@@ -1471,11 +1718,13 @@ static bool esil_todo(RzAnalysisEsil *esil) {
 
 static bool esil_goto(RzAnalysisEsil *esil) {
 	ut64 num = 0;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && *src && rz_analysis_esil_get_parm (esil, src, &num)) {
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	const char *src = esil_value_name (&src_val);
+	if (src && *src && esil_value_parm (esil, &src_val, &num)) {
 		esil->parse_goto = num;
 	}
-	free (src);
+	esil_value_fini (&src_val);
 	return 1;
 }
 
@@ -1661,10 +1910,12 @@ static bool esil_diveq(RzAnalysisEsil *esil) {
 static bool esil_mul(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
-		if (dst && rz_analysis_esil_get_parm (esil, dst, &d)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &src_val, &s)) {
+		if (esil_value_parm (esil, &dst_val, &d)) {
 			rz_analysis_esil_pushnum (esil, d * s);
 			ret = true;
 		} else {
@@ -1673,17 +1924,20 @@ static bool esil_mul(RzAnalysisEsil *esil) {
 	} else {
 		ERR ("esil_mul: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_muleq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	const char *dst = esil_value_name (&dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &src_val, &s)) {
 		if (dst && rz_analysis_esil_reg_read (esil, dst, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d * s;
@@ -1695,33 +1949,38 @@ static bool esil_muleq(RzAnalysisEsil *esil) {
 	} else {
 		ERR ("esil_muleq: invalid parameters");
 	}
-	free (dst);
-	free (src);
+	esil_value_fini (&dst_val);
+	esil_value_fini (&src_val);
 	return ret;
 }
 
 static bool esil_add(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if ((src && rz_analysis_esil_get_parm (esil, src, &s)) && (dst && rz_analysis_esil_get_parm (esil, dst, &d))) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if ((esil_value_parm (esil, &src_val, &s)) && (esil_value_parm (esil, &dst_val, &d))) {
 		rz_analysis_esil_pushnum (esil, s + d);
 		ret = true;
 	} else {
 		ERR ("esil_add: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_addeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	const char *dst = esil_value_name (&dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &src_val, &s)) {
 		if (dst && rz_analysis_esil_reg_read (esil, dst, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d + s;
@@ -1731,30 +1990,33 @@ static bool esil_addeq(RzAnalysisEsil *esil) {
 	} else {
 		ERR ("esil_addeq: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_inc(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &src_val, &s)) {
 		s++;
 		ret = rz_analysis_esil_pushnum (esil, s);
 	} else {
 		ERR ("esil_inc: invalid parameters");
 	}
-	free (src);
+	esil_value_fini (&src_val);
 	return ret;
 }
 
 static bool esil_inceq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 sd;
-	char *src_dst = rz_analysis_esil_pop (esil);
-	if (src_dst && (rz_analysis_esil_get_parm_type (esil, src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && rz_analysis_esil_get_parm (esil, src_dst, &sd)) {
+	EsilValue src_dst_val;
+	esil_pop_value (esil, &src_dst_val);
+	const char *src_dst = esil_value_name (&src_dst_val);
+	if (src_dst && (rz_analysis_esil_get_parm_type (esil, src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && esil_value_parm (esil, &src_dst_val, &sd)) {
 		// inc rax
 		esil->old = sd++;
 		esil->cur = sd;
@@ -1764,31 +2026,36 @@ static bool esil_inceq(RzAnalysisEsil *esil) {
 	} else {
 		ERR ("esil_inceq: invalid parameters");
 	}
-	free (src_dst);
+	esil_value_fini (&src_dst_val);
 	return ret;
 }
 
 static bool esil_sub(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if ((src && rz_analysis_esil_get_parm (esil, src, &s)) && (dst && rz_analysis_esil_get_parm (esil, dst, &d))) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if ((esil_value_parm (esil, &src_val, &s)) && (esil_value_parm (esil, &dst_val, &d))) {
 		ret = rz_analysis_esil_pushnum (esil, d - s);
 	} else {
 		ERR ("esil_sub: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_subeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	const char *dst = esil_value_name (&dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &src_val, &s)) {
 		if (dst && rz_analysis_esil_reg_read (esil, dst, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d - s;
@@ -1798,30 +2065,33 @@ static bool esil_subeq(RzAnalysisEsil *esil) {
 	} else {
 		ERR ("esil_subeq: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
 static bool esil_dec(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
+	if (esil_value_parm (esil, &src_val, &s)) {
 		s--;
 		ret = rz_analysis_esil_pushnum (esil, s);
 	} else {
 		ERR ("esil_dec: invalid parameters");
 	}
-	free (src);
+	esil_value_fini (&src_val);
 	return ret;
 }
 
 static bool esil_deceq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 sd;
-	char *src_dst = rz_analysis_esil_pop (esil);
-	if (src_dst && (rz_analysis_esil_get_parm_type (esil, src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && rz_analysis_esil_get_parm (esil, src_dst, &sd)) {
+	EsilValue src_dst_val;
+	esil_pop_value (esil, &src_dst_val);
+	const char *src_dst = esil_value_name (&src_dst_val);
+	if (src_dst && (rz_analysis_esil_get_parm_type (esil, src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && esil_value_parm (esil, &src_dst_val, &sd)) {
 		esil->old = sd;
 		sd--;
 		esil->cur = sd;
@@ -1831,7 +2101,7 @@ static bool esil_deceq(RzAnalysisEsil *esil) {
 	} else {
 		ERR ("esil_deceq: invalid parameters");
 	}
-	free (src_dst);
+	esil_value_fini (&src_dst_val);
 	return ret;
 }
 
@@ -1841,19 +2111,21 @@ static bool esil_poke_n(RzAnalysisEsil *esil, int bits) {
 	ut64 num, num2, addr;
 	ut8 b[8] = {0};
 	ut64 n;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
+	EsilValue dst_val;
+	esil_pop_value (esil, &dst_val);
+	EsilValue src_val;
+	esil_pop_value (esil, &src_val);
 	int bytes = RZ_MIN (sizeof (b), bits / 8);
 	if (bits % 8) {
-		free (src);
-		free (dst);
+		esil_value_fini (&src_val);
+		esil_value_fini (&dst_val);
 		return false;
 	}
 	bool ret = false;
 	//eprintf ("GONA POKE %d src:%s dst:%s\n", bits, src, dst);
 	char *src2 = NULL;
-	if (src && rz_analysis_esil_get_parm (esil, src, &num)) {
-		if (dst && rz_analysis_esil_get_parm (esil, dst, &addr)) {
+	if (esil_value_parm (esil, &src_val, &num)) {
+		if (esil_value_parm (esil, &dst_val, &addr)) {
 			if (bits == 128) {
 				src2 = rz_analysis_esil_pop (esil);
 				if (src2 && rz_analysis_esil_get_parm (esil, src2, &num2)) {
@@ -1885,8 +2157,8 @@ static bool esil_poke_n(RzAnalysisEsil *esil, int bits) {
 	}
 out:
 	free (src2);
-	free (src);
-	free (dst);
+	esil_value_fini (&src_val);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
@@ -1970,26 +2242,23 @@ static bool esil_peek_n(RzAnalysisEsil *esil, int bits) {
 		return false;
 	}
 	bool ret = false;
-	char res[32];
 	ut64 addr;
 	ut32 bytes = bits / 8;
-	char *dst = rz_analysis_esil_pop (esil);
-	if (!dst) {
+	EsilValue dst_val;
+	if (!esil_pop_value (esil, &dst_val)) {
 		eprintf ("ESIL-ERROR at 0x%08"PFMT64x": Cannot peek memory without specifying an address\n", esil->address);
 		return false;
 	}
 	//eprintf ("GONA PEEK %d dst:%s\n", bits, dst);
-	if (dst && isregornum (esil, dst, &addr)) {
+	if (esil_value_regornum (esil, &dst_val, &addr)) {
 		if (bits == 128) {
 			ut8 a[sizeof(ut64) * 2] = {0};
 			ret = rz_analysis_esil_mem_read (esil, addr, a, bytes);
 			ut64 b = rz_read_ble64 (&a, 0); //esil->analysis->big_endian);
 			ut64 c = rz_read_ble64 (&a[8], 0); //esil->analysis->big_endian);
-			snprintf (res, sizeof (res), "0x%" PFMT64x, b);
-			rz_analysis_esil_push (esil, res);
-			snprintf (res, sizeof (res), "0x%" PFMT64x, c);
-			rz_analysis_esil_push (esil, res);
-			free (dst);
+			rz_analysis_esil_pushnum (esil, b);
+			rz_analysis_esil_pushnum (esil, c);
+			esil_value_fini (&dst_val);
 			return ret;
 		}
 		ut64 bitmask = genmask (bits - 1);
@@ -1999,11 +2268,10 @@ static bool esil_peek_n(RzAnalysisEsil *esil, int bits) {
 		if (esil->analysis->big_endian) {
 			rz_mem_swapendian ((ut8*)&b, (const ut8*)&b, bytes);
 		}
-		snprintf (res, sizeof (res), "0x%" PFMT64x, b & bitmask);
-		rz_analysis_esil_push (esil, res);
+		rz_analysis_esil_pushnum (esil, b & bitmask);
 		esil->lastsz = bits;
 	}
-	free (dst);
+	esil_value_fini (&dst_val);
 	return ret;
 }
 
@@ -2680,7 +2948,15 @@ static bool esil_dup(RzAnalysisEsil *esil) {
 	if (!esil || !esil->stack || esil->stackptr < 1 || esil->stackptr > (esil->stacksize - 1)) {
 		return false;
 	}
-	return rz_analysis_esil_push (esil, esil->stack[esil->stackptr-1]);
+	EsilValue v = esil->values[esil->stackptr - 1];
+	switch (v.type) {
+	case ESIL_VALUE_STR:
+		return rz_analysis_esil_push (esil, esil->stack[esil->stackptr - 1]);
+	case ESIL_VALUE_WORD:
+		return esil_push_word (esil, v.prog, v.word);
+	default:
+		return esil_push_value (esil, &v);
+	}
 }
 
 static bool esil_swap(RzAnalysisEsil *esil) {
@@ -2688,12 +2964,17 @@ static bool esil_swap(RzAnalysisEsil *esil) {
 	if (!esil || !esil->stack || esil->stackptr < 2) {
 		return false;
 	}
-	if (!esil->stack[esil->stackptr-1] || !esil->stack[esil->stackptr-2]) {
+	EsilValue *a = &esil->values[esil->stackptr - 1];
+	EsilValue *b = &esil->values[esil->stackptr - 2];
+	if ((a->type == ESIL_VALUE_STR && !esil->stack[esil->stackptr-1]) || (b->type == ESIL_VALUE_STR && !esil->stack[esil->stackptr-2])) {
 		return false;
 	}
 	tmp = esil->stack[esil->stackptr-1];
 	esil->stack[esil->stackptr-1] = esil->stack[esil->stackptr-2];
 	esil->stack[esil->stackptr-2] = tmp;
+	EsilValue v = *a;
+	*a = *b;
+	*b = v;
 	return true;
 }
 
@@ -2732,9 +3013,9 @@ static bool esil_smaller(RzAnalysisEsil *esil) { // 'dst < src' => 'src,dst,<'
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
+			if (esil_reg_get (esil, dst)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
+			} else if (esil_reg_get (esil, src)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, src);
 			} else {
 				// default size is set to 64 as internally operands are ut64
@@ -2759,9 +3040,9 @@ static bool esil_bigger(RzAnalysisEsil *esil) { // 'dst > src' => 'src,dst,>'
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
+			if (esil_reg_get (esil, dst)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
+			} else if (esil_reg_get (esil, src)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, src);
 			} else {
 				// default size is set to 64 as internally operands are ut64
@@ -2785,9 +3066,9 @@ static bool esil_smaller_equal(RzAnalysisEsil *esil) { // 'dst <= src' => 'src,d
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
+			if (esil_reg_get (esil, dst)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
+			} else if (esil_reg_get (esil, src)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, src);
 			} else {
 				// default size is set to 64 as internally operands are ut64
@@ -2811,9 +3092,9 @@ static bool esil_bigger_equal(RzAnalysisEsil *esil) { // 'dst >= src' => 'src,ds
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
+			if (esil_reg_get (esil, dst)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
+			} else if (esil_reg_get (esil, src)) {
 				esil->lastsz = esil_internal_sizeof_reg (esil, src);
 			} else {
 				// default size is set to 64 as internally operands are ut64
@@ -2883,41 +3164,9 @@ static bool iscommand(RzAnalysisEsil *esil, const char *word, RzAnalysisEsilOp *
 	return false;
 }
 
-static bool runword(RzAnalysisEsil *esil, const char *word) {
-	RzAnalysisEsilOp *op = NULL;
-	if (!word) {
-		return false;
-	}
-	esil->parse_goto_count--;
-	if (esil->parse_goto_count < 1) {
-		ERR ("ESIL infinite loop detected\n");
-		esil->trap = 1;       // INTERNAL ERROR
-		esil->parse_stop = 1; // INTERNAL ERROR
-		return false;
-	}
-
-	// Don't push anything onto stack when processing if statements
-	if (!strcmp (word, "?{") && esil->Reil) {
-		esil->Reil->skip = esil->Reil->skip? 0: 1;
-		if (esil->Reil->skip) {
-			esil->Reil->cmd_count = 0;
-			memset (esil->Reil->if_buf, 0, sizeof (esil->Reil->if_buf));
-		}
-	}
-
-	if (esil->Reil && esil->Reil->skip) {
-		char *if_buf = esil->Reil->if_buf;
-		strncat (if_buf, word, sizeof (esil->Reil->if_buf) - strlen (if_buf) - 1);
-		strncat (if_buf, ",", sizeof (esil->Reil->if_buf) - strlen (if_buf) - 1);
-		if (!strcmp (word, "}")) {
-			rz_analysis_esil_pushnum (esil, esil->Reil->addr + esil->Reil->cmd_count + 1);
-			rz_analysis_esil_parse (esil, esil->Reil->if_buf);
-		} else if (iscommand (esil, word, &op)) {
-			esil->Reil->cmd_count++;
-		}
-		return true;
-	}
-
+/* run a word whose operator (if any) has already been looked up, \p w is
+ * the compiled word when run from esil->program */
+static bool runword_op(RzAnalysisEsil *esil, const char *word, RzAnalysisEsilOp *op, const EsilWord *w) {
 	//eprintf ("WORD (%d) (%s)\n", esil->skip, word);
 	if (!strcmp (word, "}{")) {
 		if (esil->skip == 1) {
@@ -2937,27 +3186,25 @@ static bool runword(RzAnalysisEsil *esil, const char *word) {
 		return true;
 	}
 
-	if (iscommand (esil, word, &op)) {
+	if (op) {
 		// run action
-		if (op) {
-			if (esil->cb.hook_command) {
-				if (esil->cb.hook_command (esil, word)) {
-					return 1; // XXX cannot return != 1
-				}
+		if (esil->cb.hook_command) {
+			if (esil->cb.hook_command (esil, word)) {
+				return 1; // XXX cannot return != 1
 			}
-			esil->current_opstr = strdup (word);
-			//so this is basically just sharing what's the operation with the operation
-			//useful for wrappers
-			const bool ret = op->code (esil);
-			free (esil->current_opstr);
-			esil->current_opstr = NULL;
-			if (!ret) {
-				if (esil->verbose) {
-					eprintf ("%s returned 0\n", word);
-				}
+		}
+		esil->current_opstr = strdup (word);
+		//so this is basically just sharing what's the operation with the operation
+		//useful for wrappers
+		const bool ret = op->code (esil);
+		free (esil->current_opstr);
+		esil->current_opstr = NULL;
+		if (!ret) {
+			if (esil->verbose) {
+				eprintf ("%s returned 0\n", word);
 			}
-			return ret;
 		}
+		return ret;
 	}
 	if (!*word || *word == ',') {
 		// skip empty words
@@ -2965,7 +3212,7 @@ static bool runword(RzAnalysisEsil *esil, const char *word) {
 	}
 
 	// push value
-	if (!rz_analysis_esil_push (esil, word)) {
+	if (w? !esil_push_word (esil, esil->program, w): !rz_analysis_esil_push (esil, word)) {
 		ERR ("ESIL stack is full");
 		esil->trap = 1;
 		esil->trap_code = 1;
@@ -2973,6 +3220,53 @@ static bool runword(RzAnalysisEsil *esil, const char *word) {
 	return true;
 }
 
+static bool goto_count_dec(RzAnalysisEsil *esil) {
+	esil->parse_goto_count--;
+	if (esil->parse_goto_count < 1) {
+		ERR ("ESIL infinite loop detected\n");
+		esil->trap = 1;       // INTERNAL ERROR
+		esil->parse_stop = 1; // INTERNAL ERROR
+		return false;
+	}
+	return true;
+}
+
+static bool runword(RzAnalysisEsil *esil, const char *word) {
+	RzAnalysisEsilOp *op = NULL;
+	if (!word) {
+		return false;
+	}
+	if (!goto_count_dec (esil)) {
+		return false;
+	}
+
+	// Don't push anything onto stack when processing if statements
+	if (!strcmp (word, "?{") && esil->Reil) {
+		esil->Reil->skip = esil->Reil->skip? 0: 1;
+		if (esil->Reil->skip) {
+			esil->Reil->cmd_count = 0;
+			memset (esil->Reil->if_buf, 0, sizeof (esil->Reil->if_buf));
+		}
+	}
+
+	if (esil->Reil && esil->Reil->skip) {
+		char *if_buf = esil->Reil->if_buf;
+		strncat (if_buf, word, sizeof (esil->Reil->if_buf) - strlen (if_buf) - 1);
+		strncat (if_buf, ",", sizeof (esil->Reil->if_buf) - strlen (if_buf) - 1);
+		if (!strcmp (word, "}")) {
+			rz_analysis_esil_pushnum (esil, esil->Reil->addr + esil->Reil->cmd_count + 1);
+			rz_analysis_esil_parse (esil, esil->Reil->if_buf);
+		} else if (iscommand (esil, word, &op)) {
+			esil->Reil->cmd_count++;
+		}
+		return true;
+	}
+	if (!esil->skip || !strcmp (word, "?{")) {
+		iscommand (esil, word, &op);
+	}
+	return runword_op (esil, word, op, NULL);
+}
+
 static const char *gotoWord(const char *str, int n) {
 	const char *ostr = str;
 	int count = 0;
@@ -3042,6 +3336,211 @@ static bool __stepOut(RzAnalysisEsil *esil, const char *cmd) {
 	return false;
 }
 
+/* Compiled expressions
+ *
+ * An expression is split into its words once and every word gets its
+ * operator resolved, so executing it again skips the tokenizer and the
+ * ops lookups. The words naming a register are resolved to their handles
+ * too, and while the expression runs the names the ops get back from the
+ * stack are mapped to those handles by address (see esil_reg_get).
+ * The immediates are parsed here once too and the words are pushed on the
+ * typed stack as they are, so the ops popping values never see a string.
+ * Programs are cached per instruction address and checked
+ * against their source string, anything the tokenizer treats specially
+ * (';', "#!", empty or oversized words, REIL) is left to the interpreter.
+ */
+
+static void esil_program_unref(EsilProgram *prog) {
+	if (!prog || --prog->refs > 0) {
+		return;
+	}
+	free (prog->src);
+	free (prog->text);
+	free (prog->words);
+	free (prog);
+}
+
+static void esil_compiled_kv_free(HtUPKv *kv) {
+	esil_program_unref (kv->value);
+}
+
+static bool esil_compilable(const char *str) {
+	if (strchr (str, ';') || strstr (str, "#!")) {
+		return false;
+	}
+	const char *p = str;
+	do {
+		const char *end = strchr (p, ',');
+		size_t len = end? end - p: strlen (p);
+		if (!len || len > 62) {
+			return false;
+		}
+		p = end? end + 1: NULL;
+	} while (p);
+	return true;
+}
+
+/* the immediates rz_analysis_esil_get_parm () and isregornum () agree on */
+static bool esil_word_isnum(const char *str, ut64 *num) {
+	if (!IS_DIGIT (*str)) {
+		return false;
+	}
+	if (strncmp (str, "0x", 2)) {
+		const char *p;
+		for (p = str + 1; *p; p++) {
+			if (!IS_DIGIT (*p)) {
+				return false;
+			}
+		}
+	}
+	*num = rz_num_get (NULL, str);
+	return true;
+}
+
+/* resolve the words naming a register to their handles, they stay valid
+ * as long as the profile is not reloaded (see esil_program_get) */
+static void esil_program_resolve_regs(RzAnalysisEsil *esil, EsilProgram *prog) {
+	RzReg *reg = esil->analysis? esil->analysis->reg: NULL;
+	if (!reg) {
+		return;
+	}
+	prog->reg = reg;
+	prog->reg_gen = reg->profile_gen;
+	int i;
+	for (i = 0; i < prog->nwords; i++) {
+		EsilWord *w = &prog->words[i];
+		if (!w->op && !IS_DIGIT (*w->str)) {
+			w->reg = rz_reg_index_of (reg, w->str);
+		}
+	}
+}
+
+static EsilProgram *esil_program_new(RzAnalysisEsil *esil, const char *str) {
+	EsilProgram *prog = RZ_NEW0 (EsilProgram);
+	if (!prog) {
+		return NULL;
+	}
+	prog->refs = 1;
+	prog->src = strdup (str);
+	if (!prog->src) {
+		free (prog);
+		return NULL;
+	}
+	if (!esil_compilable (str)) {
+		return prog;
+	}
+	int n = rz_str_char_count (str, ',') + 1;
+	prog->text = strdup (str);
+	prog->words = RZ_NEWS0 (EsilWord, n);
+	if (!prog->text || !prog->words) {
+		RZ_FREE (prog->text);
+		RZ_FREE (prog->words);
+		return prog;
+	}
+	char *p = prog->text;
+	for (prog->nwords = 0; prog->nwords < n; prog->nwords++) {
+		EsilWord *w = &prog->words[prog->nwords];
+		char *end = strchr (p, ',');
+		if (end) {
+			*end++ = 0;
+		}
+		w->str = p;
+		w->reg = -1;
+		if (!iscommand (esil, p, &w->op)) {
+			w->isnum = esil_word_isnum (p, &w->num);
+		}
+		p = end;
+	}
+	esil_program_resolve_regs (esil, prog);
+	return prog;
+}
+
+static bool esil_program_regs_valid(RzAnalysisEsil *esil, EsilProgram *prog) {
+	RzReg *reg = esil->analysis? esil->analysis->reg: NULL;
+	return prog->reg == reg && (!reg || prog->reg_gen == reg->profile_gen);
+}
+
+static EsilProgram *esil_program_get(RzAnalysisEsil *esil, const char *str) {
+	if (!esil->compiled) {
+		esil->compiled = ht_up_new (NULL, esil_compiled_kv_free, NULL);
+		if (!esil->compiled) {
+			return NULL;
+		}
+	}
+	EsilProgram *prog = ht_up_find (esil->compiled, esil->address, NULL);
+	if (prog && !strcmp (prog->src, str) && esil_program_regs_valid (esil, prog)) {
+		return prog;
+	}
+	prog = esil_program_new (esil, str);
+	if (!prog) {
+		return NULL;
+	}
+	if (esil->compiled->count >= RZ_ANALYSIS_ESIL_COMPILED_MAX) {
+		rz_analysis_esil_compiled_flush (esil);
+		esil->compiled = ht_up_new (NULL, esil_compiled_kv_free, NULL);
+		if (!esil->compiled) {
+			esil_program_unref (prog);
+			return NULL;
+		}
+	}
+	ht_up_update (esil->compiled, esil->address, prog);
+	return prog;
+}
+
+/* same control flow as the interpreter loop below, but indexing words */
+static bool esil_program_run(RzAnalysisEsil *esil, EsilProgram *prog) {
+	int i;
+loop:
+	esil->repeat = 0;
+	esil->skip = 0;
+	esil->parse_goto = -1;
+	esil->parse_stop = 0;
+	esil->parse_goto_count = esil->analysis? esil->analysis->esil_goto_limit: RZ_ANALYSIS_ESIL_GOTO_LIMIT;
+	i = 0;
+	while (i < prog->nwords) {
+		const EsilWord *w = &prog->words[i];
+		if (!goto_count_dec (esil)) {
+			return false;
+		}
+		RzAnalysisEsilOp *op = (!esil->skip || !strcmp (w->str, "?{"))? w->op: NULL;
+		if (!runword_op (esil, w->str, op, w)) {
+			return false;
+		}
+		if (esil->repeat) {
+			goto loop;
+		}
+		if (esil->parse_goto != -1) {
+			if (esil->parse_goto >= 0 && esil->parse_goto < prog->nwords) {
+				i = esil->parse_goto;
+				esil->parse_goto = -1;
+				continue;
+			}
+			if (esil->verbose) {
+				eprintf ("Cannot find word %d\n", esil->parse_goto);
+			}
+			return false;
+		}
+		if (esil->parse_stop) {
+			if (esil->parse_stop == 2) {
+				const char *rest = i + 1 < prog->nwords? prog->src + (prog->words[i + 1].str - prog->text): "";
+				eprintf ("[esil at 0x%08"PFMT64x"] TODO: %s\n", esil->address, rest);
+			}
+			return false;
+		}
+		i++;
+	}
+	return true;
+}
+
+/**
+ * \brief Drop all the cached compiled expressions
+ */
+RZ_API void rz_analysis_esil_compiled_flush(RzAnalysisEsil *esil) {
+	rz_return_if_fail (esil);
+	ht_up_free (esil->compiled);
+	esil->compiled = NULL;
+}
+
 RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
 	int wordi = 0;
 	int dorunword;
@@ -3060,6 +3559,19 @@ RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
 			esil->cmd (esil, esil->cmd_todo, esil->address, 0);
 		}
 	}
+	if (!esil->Reil) {
+		EsilProgram *prog = esil_program_get (esil, str);
+		if (prog && prog->words) {
+			EsilProgram *outer = esil->program;
+			prog->refs++;
+			esil->program = prog;
+			bool ret = esil_program_run (esil, prog);
+			esil->program = outer;
+			esil_program_unref (prog);
+			__stepOut (esil, esil->cmd_step_out);
+			return ret;
+		}
+	}
 loop:
 	esil->repeat = 0;
 	esil->skip = 0;
@@ -3158,7 +3670,12 @@ RZ_API void rz_analysis_esil_stack_free(RzAnalysisEsil *esil) {
 	int i;
 	if (esil) {
 		for (i = 0; i < esil->stackptr; i++) {
-			RZ_FREE (esil->stack[i]);
+			EsilValue *v = &esil->values[i];
+			if (v->type == ESIL_VALUE_STR) {
+				v->str = esil->stack[i];
+			}
+			esil_value_fini (v);
+			esil->stack[i] = NULL;
 		}
 		esil->stackptr = 0;
 	}
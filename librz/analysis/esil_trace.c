@@ -7,7 +7,6 @@
 #define KEYAT(x,y) sdb_fmt ("%d."x".0x%"PFMT64x, esil->trace->idx, y)
 #define KEYREG(x,y) sdb_fmt ("%d."x".%s", esil->trace->idx, y)
 #define CMP_REG_CHANGE(x, y) ((x) - ((RzAnalysisEsilRegChange *)y)->idx)
-#define CMP_MEM_CHANGE(x, y) ((x) - ((RzAnalysisEsilMemChange *)y)->idx)
 
 static int ocbs_set = false;
 static RzAnalysisEsilCallbacks ocbs = {0};
@@ -27,7 +26,7 @@ RZ_API RzAnalysisEsilTrace *rz_analysis_esil_trace_new(RzAnalysisEsil *esil) {
 	if (!trace->registers) {
 		goto error;
 	}
-	trace->memory = ht_up_new (NULL, htup_vector_free, NULL);
+	trace->memory = rz_mem_journal_new ();
 	if (!trace->memory) {
 		goto error;
 	}
@@ -65,7 +64,7 @@ RZ_API void rz_analysis_esil_trace_free(RzAnalysisEsilTrace *trace) {
 	size_t i;
 	if (trace) {
 		ht_up_free (trace->registers);
-		ht_up_free (trace->memory);
+		rz_mem_journal_free (trace->memory);
 		for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
 			rz_reg_arena_free (trace->arena[i]);
 		}
@@ -90,18 +89,10 @@ static void add_reg_change(RzAnalysisEsilTrace *trace, int idx, RzRegItem *ri, u
 	rz_vector_push (vreg, &reg);
 }
 
-static void add_mem_change(RzAnalysisEsilTrace *trace, int idx, ut64 addr, ut8 data) {
-	RzVector *vmem = ht_up_find (trace->memory, addr, NULL);
-	if (!vmem) {
-		vmem = rz_vector_new (sizeof (RzAnalysisEsilMemChange), NULL, NULL);
-		if (!vmem) {
-			eprintf ("Error: creating a memory vector.\n");
-			return;
-		}
-		ht_up_insert (trace->memory, addr, vmem);
+static void add_mem_change(RzAnalysisEsilTrace *trace, int idx, ut64 addr, const ut8 *buf, int len) {
+	if (len > 0 && !rz_mem_journal_add (trace->memory, idx, addr, buf, len)) {
+		eprintf ("Error: recording a memory change.\n");
 	}
-	RzAnalysisEsilMemChange mem = { idx, data };
-	rz_vector_push (vmem, &mem);
 }
 
 static int trace_hook_reg_read(RzAnalysisEsil *esil, const char *name, ut64 *res, int *size) {
@@ -168,7 +159,6 @@ static int trace_hook_mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int le
 }
 
 static int trace_hook_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf, int len) {
-	size_t i;
 	int ret = 0;
 	char *hexbuf = malloc ((1+len)*3);
 	sdb_array_add_num (DB, KEY ("mem.write"), addr, 0);
@@ -176,9 +166,7 @@ static int trace_hook_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf,
 	sdb_set (DB, KEYAT ("mem.write.data", addr), hexbuf, 0);
 	//eprintf ("[ESIL] MEM WRITE 0x%08"PFMT64x" %s\n", addr, hexbuf);
 	free (hexbuf);
-	for (i = 0; i < len; i++) {
-		add_mem_change (esil->trace, esil->trace->idx + 1, addr + i, buf[i]);
-	}
+	add_mem_change (esil->trace, esil->trace->idx + 1, addr, buf, len);
 
 	if (ocbs.hook_mem_write) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
@@ -242,16 +230,9 @@ RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RzAnalysisOp *op) {
 }
 
 
-static bool restore_memory_cb(void *user, const ut64 key, const void *value) {
-	size_t index;
+static bool restore_memory_cb(void *user, ut64 addr, const ut8 *buf, ut32 len) {
 	RzAnalysisEsil *esil = user;
-	RzVector *vmem = (RzVector *)value;
-
-	rz_vector_upper_bound (vmem, esil->trace->idx, index, CMP_MEM_CHANGE);
-	if (index > 0 && index <= vmem->len) {
-		RzAnalysisEsilMemChange *c = rz_vector_index_ptr (vmem, index - 1);
-		esil->analysis->iob.write_at (esil->analysis->iob.io, key, &c->data, 1);
-	}
+	esil->analysis->iob.write_at (esil->analysis->iob.io, addr, buf, len);
 	return true;
 }
 
@@ -271,6 +252,8 @@ static bool restore_register(RzAnalysisEsil *esil, RzRegItem *ri, int idx) {
 RZ_API void rz_analysis_esil_trace_restore(RzAnalysisEsil *esil, int idx) {
 	size_t i;
 	RzAnalysisEsilTrace *trace = esil->trace;
+	// Memory is already as of trace->idx when going forward
+	int from = idx < trace->idx ? 0 : trace->idx + 1;
 	// Restore initial state when going backward
 	if (idx < esil->trace->idx) {
 		// Restore initial registers value
@@ -292,7 +275,9 @@ RZ_API void rz_analysis_esil_trace_restore(RzAnalysisEsil *esil, int idx) {
 	rz_list_foreach (esil->analysis->reg->allregs, iter, ri) {
 		restore_register (esil, ri, idx);
 	}
-	ht_up_foreach (trace->memory, restore_memory_cb, esil);
+	if (idx >= from) {
+		rz_mem_journal_replay (trace->memory, from, idx, restore_memory_cb, esil);
+	}
 }
 
 static int cmp_strings_by_leading_number(void *data1, void *data2) {
@@ -5,7 +5,6 @@
 #include <rz_util.h>
 #include <rz_list.h>
 
-#define READ_AHEAD 1
 #define SDB_KEY_BB "bb.0x%"PFMT64x ".0x%"PFMT64x
 // XXX must be configurable by the user
 #define JMPTBLSZ 512
@@ -50,48 +49,6 @@ RZ_API const char *rz_analysis_fcntype_tostring(int type) {
 	return "unk";
 }
 
-#if READ_AHEAD
-static ut64 cache_addr = UT64_MAX;
-
-// TODO: move into io :?
-static int read_ahead(RzAnalysis *analysis, ut64 addr, ut8 *buf, int len) {
-	static ut8 cache[1024];
-	const int cache_len = sizeof (cache);
-
-	if (len < 1) {
-		return 0;
-	}
-	if (len > cache_len) {
-		int a = analysis->iob.read_at (analysis->iob.io, addr, buf, len); // double read
-		memcpy (cache, buf, cache_len);
-		cache_addr = addr;
-		return a;
-	}
-
-	ut64 addr_end = UT64_ADD_OVFCHK (addr, len)? UT64_MAX: addr + len;
-	ut64 cache_addr_end = UT64_ADD_OVFCHK (cache_addr, cache_len)? UT64_MAX: cache_addr + cache_len;
-	bool isCached = ((addr != UT64_MAX) && (addr >= cache_addr) && (addr_end < cache_addr_end));
-	if (isCached) {
-		memcpy (buf, cache + (addr - cache_addr), len);
-	} else {
-		analysis->iob.read_at (analysis->iob.io, addr, cache, sizeof (cache));
-		memcpy (buf, cache, len);
-		cache_addr = addr;
-	}
-	return len;
-}
-#else
-static int read_ahead(RzAnalysis *analysis, ut64 addr, ut8 *buf, int len) {
-	return analysis->iob.read_at (analysis->iob.io, addr, buf, len);
-}
-#endif
-
-RZ_API void rz_analysis_fcn_invalidate_read_ahead_cache(void) {
-#if READ_AHEAD
-	cache_addr = UT64_MAX;
-#endif
-}
-
 static int cmpaddr(const void *_a, const void *_b) {
 	const RzAnalysisBlock *a = _a, *b = _b;
 	return a->addr > b->addr ? 1 : (a->addr < b->addr ? -1 : 0);
@@ -133,6 +90,20 @@ RZ_API int rz_analysis_function_resize(RzAnalysisFunction *fcn, int newsize) {
 	return true;
 }
 
+/**
+ * \brief Flush the IO page cache \p analysis reads through
+ *
+ * Function analysis used to read through a static read-ahead buffer that
+ * had to be invalidated by hand, reads now go through the IO page cache
+ * which IO writes and map changes already keep up to date.
+ */
+RZ_API RZ_DEPRECATE void rz_analysis_fcn_invalidate_read_ahead_cache(RzAnalysis *analysis) {
+	rz_return_if_fail (analysis);
+	if (analysis->iob.io && analysis->iob.page_cache_flush) {
+		analysis->iob.page_cache_flush (analysis->iob.io);
+	}
+}
+
 // Create a new 0-sized basic block inside the function
 static RzAnalysisBlock *fcn_append_basic_block(RzAnalysis *analysis, RzAnalysisFunction *fcn, ut64 addr) {
 	RzAnalysisBlock *bb = rz_analysis_create_block (analysis, addr, 0);
@@ -183,7 +154,7 @@ static bool is_delta_pointer_table(RzAnalysis *analysis, RzAnalysisFunction *fcn
 	RzAnalysisOp add_aop = {0};
 	RzRegItem *reg_src = NULL, *o_reg_dst = NULL;
 	RzAnalysisValue cur_scr, cur_dst = { 0 };
-	read_ahead (analysis, addr, (ut8*)buf, sizeof (buf));
+	analysis->iob.read_at (analysis->iob.io, addr, (ut8*)buf, sizeof (buf));
 	bool isValid = false;
 	for (i = 0; i + 8 < JMPTBL_LEA_SEARCH_SZ; i++) {
 		ut64 at = addr + i;
@@ -246,7 +217,7 @@ static bool is_delta_pointer_table(RzAnalysis *analysis, RzAnalysisFunction *fcn
 	}
 #endif
 	/* check if jump table contains valid deltas */
-	read_ahead (analysis, *jmptbl_addr, (ut8 *)&jmptbl, 64);
+	analysis->iob.read_at (analysis->iob.io, *jmptbl_addr, (ut8 *)&jmptbl, 64);
 	for (i = 0; i < 3; i++) {
 		dst = lea_ptr + (st32)rz_read_le32 (jmptbl);
 		if (!analysis->iob.is_valid_offset (analysis->iob.io, dst, 0)) {
@@ -667,12 +638,7 @@ repeat:
 		ut32 at_delta = addrbytes * idx;
 		ut64 at = addr + at_delta;
 		ut64 bytes_read = RZ_MIN (len - at_delta, sizeof (buf));
-		ret = read_ahead (analysis, at, buf, bytes_read);
-
-		if (ret < 0) {
-			eprintf ("Failed to read\n");
-			break;
-		}
+		(void)analysis->iob.read_at (analysis->iob.io, at, buf, bytes_read);
 		if (isInvalidMemory (analysis, buf, bytes_read)) {
 			if (analysis->verbose) {
 				eprintf ("Warning: FFFF opcode at 0x%08"PFMT64x "\n", at);
@@ -1433,7 +1399,6 @@ RZ_API void rz_analysis_del_jmprefs(RzAnalysis *analysis, RzAnalysisFunction *fc
 	rz_list_free (refs);
 }
 
-/* Does NOT invalidate read-ahead cache. */
 RZ_API int rz_analysis_fcn(RzAnalysis *analysis, RzAnalysisFunction *fcn, ut64 addr, ut64 len, int reftype) {
 	RzPVector *metas = rz_meta_get_all_in(analysis, addr, RZ_META_TYPE_ANY);
 	void **it;
@@ -1615,7 +1580,6 @@ RZ_API bool rz_analysis_fcn_add_bb(RzAnalysis *a, RzAnalysisFunction *fcn, ut64
 	const bool is_x86 = a->cur->arch && !strcmp (a->cur->arch, "x86");
 	// TODO fix this x86-ism
 	if (is_x86) {
-		rz_analysis_fcn_invalidate_read_ahead_cache ();
 		fcn_recurse (a, fcn, addr, size, 1);
 		block = rz_analysis_get_block_at (a, addr);
 		if (block) {
@@ -2152,7 +2116,6 @@ static void update_analysis(RzAnalysis *analysis, RzList *fcns, HtUP *reachable)
 	RzAnalysisFunction *fcn;
 	bool old_jmpmid = analysis->opt.jmpmid;
 	analysis->opt.jmpmid = true;
-	rz_analysis_fcn_invalidate_read_ahead_cache ();
 	rz_list_foreach (fcns, it, fcn) {
 		// Recurse through blocks of function, mark reachable,
 		// analyze edges that don't have a block
@@ -82,6 +82,7 @@ void rz_analysis_hint_storage_fini(RzAnalysis *a) {
 }
 
 RZ_API void rz_analysis_hint_clear(RzAnalysis *a) {
+	a->hints_gen++;
 	rz_analysis_hint_storage_fini (a);
 	rz_analysis_hint_storage_init (a);
 }
@@ -102,6 +103,7 @@ static bool addr_hint_range_delete_cb(void *user, const ut64 key, const void *va
 }
 
 RZ_API void rz_analysis_hint_del(RzAnalysis *a, ut64 addr, ut64 size) {
+	a->hints_gen++;
 	if (size <= 1) {
 		// only single address
 		ht_up_delete (a->addr_hints, addr);
@@ -141,6 +143,7 @@ static void unset_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType
 	if (!records) {
 		return;
 	}
+	analysis->hints_gen++;
 	size_t i;
 	for (i = 0; i < records->len; i++) {
 		RzAnalysisAddrHintRecord *record = rz_vector_index_ptr (records, i);
@@ -154,6 +157,7 @@ static void unset_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType
 
 // create or return the existing addr hint record of the given type at addr
 static RzAnalysisAddrHintRecord *ensure_addr_hint_record(RzAnalysis *analysis, RzAnalysisAddrHintType type, ut64 addr) {
+	analysis->hints_gen++;
 	RzVector *records = ht_up_find (analysis->addr_hints, addr, NULL);
 	if (!records) {
 		records = rz_vector_new (sizeof (RzAnalysisAddrHintRecord), addr_hint_record_fini, NULL);
@@ -283,6 +287,7 @@ RZ_API void rz_analysis_hint_set_arch(RzAnalysis *a, ut64 addr, const char *arch
 	if (!record) {
 		return;
 	}
+	a->hints_gen++;
 	free (record->arch);
 	record->arch = arch ? strdup (arch) : NULL;
 }
@@ -292,6 +297,7 @@ RZ_API void rz_analysis_hint_set_bits(RzAnalysis *a, ut64 addr, int bits) {
 	if (!record) {
 		return;
 	}
+	a->hints_gen++;
 	record->bits = bits;
 	if (a->hint_cbs.on_bits) {
 		a->hint_cbs.on_bits (a, addr, bits, true);
@@ -363,10 +369,12 @@ RZ_API void rz_analysis_hint_unset_stackframe(RzAnalysis *a, ut64 addr) {
 }
 
 RZ_API void rz_analysis_hint_unset_arch(RzAnalysis *a, ut64 addr) {
+	a->hints_gen++;
 	rz_rbtree_delete (&a->arch_hints, &addr, ranged_hint_record_cmp, NULL, arch_hint_record_free_rb, NULL);
 }
 
 RZ_API void rz_analysis_hint_unset_bits(RzAnalysis *a, ut64 addr) {
+	a->hints_gen++;
 	rz_rbtree_delete (&a->bits_hints, &addr, ranged_hint_record_cmp, NULL, bits_hint_record_free_rb, NULL);
 }
 
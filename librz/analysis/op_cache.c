@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/* Bounded LRU of decoded instructions.
+ *
+ * Entries are keyed by address and remember the bits, the decode mask and
+ * the instruction bytes they were decoded from, so a lookup only hits if
+ * all of them match. The cache is dropped when the cpu, the endianness or
+ * the register profile change, and by rz_analysis_use(). Hints are applied by rz_analysis_op() after the
+ * lookup and never end up in the cache, but some plugins read hints while
+ * decoding so the cache is still dropped whenever a hint changes.
+ */
+
+typedef struct rz_analysis_op_cache_item_t {
+	RzAnalysisOp op;
+	int ret;
+	int bits;
+	RzAnalysisOpMask mask;
+	ut8 bytes[RZ_ANALYSIS_OP_CACHE_BYTES];
+	struct rz_analysis_op_cache_item_t *prev;
+	struct rz_analysis_op_cache_item_t *next;
+} RzAnalysisOpCacheItem;
+
+static bool op_copy_into(RzAnalysisOp *dst, const RzAnalysisOp *src) {
+	int i;
+	*dst = *src;
+	dst->mnemonic = NULL;
+	dst->access = NULL;
+	dst->dst = NULL;
+	dst->switch_op = NULL;
+	for (i = 0; i < 3; i++) {
+		dst->src[i] = NULL;
+	}
+	rz_strbuf_init (&dst->esil);
+	rz_strbuf_init (&dst->opex);
+	if (src->mnemonic && !(dst->mnemonic = strdup (src->mnemonic))) {
+		return false;
+	}
+	for (i = 0; i < 3; i++) {
+		if (src->src[i]) {
+			dst->src[i] = rz_analysis_value_copy (src->src[i]);
+		}
+	}
+	if (src->dst) {
+		dst->dst = rz_analysis_value_copy (src->dst);
+	}
+	if (src->access) {
+		RzListIter *it;
+		RzAnalysisValue *val;
+		dst->access = rz_list_newf ((RzListFree)rz_analysis_value_free);
+		if (!dst->access) {
+			return false;
+		}
+		rz_list_foreach (src->access, it, val) {
+			rz_list_append (dst->access, rz_analysis_value_copy (val));
+		}
+	}
+	return rz_strbuf_copy (&dst->esil, (RzStrBuf *)&src->esil)
+		&& rz_strbuf_copy (&dst->opex, (RzStrBuf *)&src->opex);
+}
+
+static void item_unlink(RzAnalysisOpCache *cache, RzAnalysisOpCacheItem *item) {
+	if (item->prev) {
+		item->prev->next = item->next;
+	} else {
+		cache->head = item->next;
+	}
+	if (item->next) {
+		item->next->prev = item->prev;
+	} else {
+		cache->tail = item->prev;
+	}
+	item->prev = item->next = NULL;
+}
+
+static void item_push_front(RzAnalysisOpCache *cache, RzAnalysisOpCacheItem *item) {
+	item->prev = NULL;
+	item->next = cache->head;
+	if (cache->head) {
+		cache->head->prev = item;
+	} else {
+		cache->tail = item;
+	}
+	cache->head = item;
+}
+
+static void item_free(RzAnalysisOpCacheItem *item) {
+	if (item) {
+		rz_analysis_op_fini (&item->op);
+		free (item);
+	}
+}
+
+static void item_remove(RzAnalysisOpCache *cache, RzAnalysisOpCacheItem *item) {
+	item_unlink (cache, item);
+	ht_up_delete (cache->ht, item->op.addr);
+	cache->count--;
+	item_free (item);
+}
+
+RZ_API void rz_analysis_op_cache_init(RzAnalysisOpCache *cache) {
+	memset (cache, 0, sizeof (*cache));
+}
+
+RZ_API void rz_analysis_op_cache_fini(RzAnalysisOpCache *cache) {
+	rz_analysis_op_cache_flush (cache);
+	RZ_FREE (cache->cpu);
+}
+
+/**
+ * \brief Drop every cached instruction, the hit/miss counters are kept
+ */
+RZ_API void rz_analysis_op_cache_flush(RzAnalysisOpCache *cache) {
+	RzAnalysisOpCacheItem *item = cache->head;
+	while (item) {
+		RzAnalysisOpCacheItem *next = item->next;
+		item_free (item);
+		item = next;
+	}
+	ht_up_free (cache->ht);
+	cache->ht = NULL;
+	cache->head = cache->tail = NULL;
+	cache->count = 0;
+}
+
+/**
+ * \brief Set the maximum number of cached instructions, 0 disables the cache
+ */
+RZ_API void rz_analysis_op_cache_set_capacity(RzAnalysisOpCache *cache, ut32 capacity) {
+	cache->capacity = capacity;
+	while (cache->count > capacity && cache->tail) {
+		item_remove (cache, cache->tail);
+	}
+	if (!capacity) {
+		rz_analysis_op_cache_flush (cache);
+	}
+}
+
+/**
+ * \brief Drop the instructions overlapping [addr, addr + len)
+ */
+RZ_API void rz_analysis_op_cache_invalidate(RzAnalysisOpCache *cache, ut64 addr, ut64 len) {
+	if (!cache->count || !len) {
+		return;
+	}
+	if (len > RZ_ANALYSIS_OP_CACHE_BYTES * 64) {
+		rz_analysis_op_cache_flush (cache);
+		return;
+	}
+	ut64 from = addr > RZ_ANALYSIS_OP_CACHE_BYTES? addr - RZ_ANALYSIS_OP_CACHE_BYTES + 1: 0;
+	ut64 to = addr + len;
+	ut64 at;
+	for (at = from; at < to && at >= from; at++) {
+		RzAnalysisOpCacheItem *item = ht_up_find (cache->ht, at, NULL);
+		if (item && at + item->op.size > addr) {
+			item_remove (cache, item);
+		}
+	}
+}
+
+static bool state_changed(RzAnalysis *analysis) {
+	RzAnalysisOpCache *cache = &analysis->opcache;
+	ut32 gen = analysis->reg? analysis->reg->profile_gen: 0;
+	bool cpu_changed = analysis->cpu? !cache->cpu || strcmp (cache->cpu, analysis->cpu): !!cache->cpu;
+	if (cache->reg != analysis->reg || cache->profile_gen != gen || cache->hints_gen != analysis->hints_gen
+		|| cpu_changed || cache->big_endian != analysis->big_endian) {
+		cache->reg = analysis->reg;
+		cache->profile_gen = gen;
+		cache->hints_gen = analysis->hints_gen;
+		if (cpu_changed) {
+			free (cache->cpu);
+			cache->cpu = analysis->cpu? strdup (analysis->cpu): NULL;
+		}
+		cache->big_endian = analysis->big_endian;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * \brief Fill \p op from the cache if an instruction was decoded from the same bytes at \p addr
+ *
+ * Decoded operand values keep pointers to the register items, so the whole
+ * cache is dropped as soon as the register profile changes. It is also
+ * dropped when any analysis hint was set or removed since the last lookup,
+ * or when the cpu or the endianness differ from the ones it was filled with.
+ */
+RZ_API bool rz_analysis_op_cache_get(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask, int *ret) {
+	RzAnalysisOpCache *cache = &analysis->opcache;
+	if (!cache->capacity) {
+		return false;
+	}
+	if (state_changed (analysis)) {
+		rz_analysis_op_cache_flush (cache);
+	}
+	mask &= ~RZ_ANALYSIS_OP_MASK_HINT;
+	RzAnalysisOpCacheItem *item = cache->ht? ht_up_find (cache->ht, addr, NULL): NULL;
+	if (!item || item->bits != analysis->bits || (item->mask & mask) != mask
+		|| item->op.size > len || memcmp (item->bytes, data, item->op.size)) {
+		cache->misses++;
+		return false;
+	}
+	if (!op_copy_into (op, &item->op)) {
+		rz_analysis_op_fini (op);
+		rz_analysis_op_init (op);
+		cache->misses++;
+		return false;
+	}
+	if (cache->head != item) {
+		item_unlink (cache, item);
+		item_push_front (cache, item);
+	}
+	*ret = item->ret;
+	cache->hits++;
+	return true;
+}
+
+/**
+ * \brief Remember the result of decoding \p data at \p addr
+ */
+RZ_API void rz_analysis_op_cache_put(RzAnalysis *analysis, const RzAnalysisOp *op, const ut8 *data, int len, RzAnalysisOpMask mask, int ret) {
+	RzAnalysisOpCache *cache = &analysis->opcache;
+	if (!cache->capacity || ret < 1 || op->size < 1 || op->size > len
+		|| op->size > RZ_ANALYSIS_OP_CACHE_BYTES || op->switch_op) {
+		return;
+	}
+	if (state_changed (analysis)) {
+		// the plugin set hints while decoding, its result depends on them
+		rz_analysis_op_cache_flush (cache);
+		return;
+	}
+	if (!cache->ht && !(cache->ht = ht_up_new0 ())) {
+		return;
+	}
+	RzAnalysisOpCacheItem *item = ht_up_find (cache->ht, op->addr, NULL);
+	if (item) {
+		item_remove (cache, item);
+	}
+	item = RZ_NEW0 (RzAnalysisOpCacheItem);
+	if (!item) {
+		return;
+	}
+	if (!op_copy_into (&item->op, op)) {
+		item_free (item);
+		return;
+	}
+	item->ret = ret;
+	item->bits = analysis->bits;
+	item->mask = mask & ~RZ_ANALYSIS_OP_MASK_HINT;
+	memcpy (item->bytes, data, op->size);
+	if (!ht_up_insert (cache->ht, op->addr, item)) {
+		item_free (item);
+		return;
+	}
+	item_push_front (cache, item);
+	cache->count++;
+	while (cache->count > cache->capacity && cache->tail) {
+		item_remove (cache, cache->tail);
+	}
+}
@@ -1252,38 +1252,712 @@ beach:
 	return ret;
 }
 
-static bool store_xref_cb(void *j, const ut64 k, const void *v) {
-	const RzAnalysisRef *xref = v;
-	pj_o (j);
-	pj_kn (j, "to", k);
-	if (xref->type != RZ_ANALYSIS_REF_TYPE_NULL) {
-		char type[2] = { xref->type, '\0' };
-		pj_ks (j, "type", type);
+/*
+ * Binary records
+ *
+ * The blocks and functions namespaces can also be stored as binary records,
+ * which are a lot cheaper to load than their JSON equivalent. They hold the
+ * same fields, in a fixed order, and are keyed by "0x<addr>" as well:
+ *
+ *   block     size:ut64 jump:ut64 fail:ut64 cmpval:ut64 colorize:ut32 ninstr:st32
+ *             stackptr:st32 parent_stackptr:st32 flags:ut8
+ *             [op_pos:ut16[ninstr - 1]] [fingerprint:ut8[size]] [cmpreg:<str>]
+ *             [diff:<diff>] [switch_op:<switch_op>]
+ *   function  bits:st32 type:st32 stack:st32 maxstack:st32 ninstr:st32 bp_off:st64 flags:ut8
+ *             name:<str> [cc:<str>] [fingerprint:ut32 ut8[]] [diff:<diff>]
+ *             bbs:ut32 ut64[] imports:ut32 <str>[] labels:ut32 {addr:ut64 name:<str>}[]
+ *             vars:ut32 <var>[]
+ *   var       kind:ut8 flags:ut8 delta:st64 name:<str> type:<str> [reg:<str>] [cmt:<str>]
+ *             accs:ut32 {off:st64 type:ut8 sp:st64 reg:<str>}[] constrs:ut32 {cond:st32 val:ut64}[]
+ *   diff      type:st32 addr:ut64 dist:f64 size:ut32 has_name:ut8 [name:<str>]
+ *   switch_op addr:ut64 min:ut64 max:ut64 def:ut64 cases:ut32 {addr:ut64 jump:ut64 value:ut64}[]
+ *   str       len:ut32 chars[len] 0
+ *
+ * Bracketed fields are only present if their bit in flags is set. All
+ * integers are little endian.
+ */
+
+enum {
+	BLOCK_RECORD_TRACED = 1 << 0,
+	BLOCK_RECORD_FOLDED = 1 << 1,
+	BLOCK_RECORD_OP_POS = 1 << 2,
+	BLOCK_RECORD_FINGERPRINT = 1 << 3,
+	BLOCK_RECORD_CMPREG = 1 << 4,
+	BLOCK_RECORD_DIFF = 1 << 5,
+	BLOCK_RECORD_SWITCH_OP = 1 << 6
+};
+
+enum {
+	FUNCTION_RECORD_FOLDED = 1 << 0,
+	FUNCTION_RECORD_BP_FRAME = 1 << 1,
+	FUNCTION_RECORD_PURE = 1 << 2,
+	FUNCTION_RECORD_NORETURN = 1 << 3,
+	FUNCTION_RECORD_CC = 1 << 4,
+	FUNCTION_RECORD_FINGERPRINT = 1 << 5,
+	FUNCTION_RECORD_DIFF = 1 << 6
+};
+
+enum {
+	VAR_RECORD_ARG = 1 << 0,
+	VAR_RECORD_REG = 1 << 1,
+	VAR_RECORD_COMMENT = 1 << 2
+};
+
+typedef struct {
+	RzStrBuf buf;
+	bool fail;
+} RecordWriter;
+
+static void rec_put(RecordWriter *w, const void *data, size_t size) {
+	if (size && !rz_strbuf_append_n (&w->buf, data, size)) {
+		w->fail = true;
 	}
-	pj_end (j);
-	return true;
 }
 
-static bool store_xrefs_list_cb(void *db, const ut64 k, const void *v) {
+static void rec_u8(RecordWriter *w, ut8 x) {
+	rec_put (w, &x, 1);
+}
+
+static void rec_le32(RecordWriter *w, ut32 x) {
+	ut8 b[4];
+	rz_write_le32 (b, x);
+	rec_put (w, b, sizeof (b));
+}
+
+static void rec_le64(RecordWriter *w, ut64 x) {
+	ut8 b[8];
+	rz_write_le64 (b, x);
+	rec_put (w, b, sizeof (b));
+}
+
+// NULL is written as ""
+static void rec_str(RecordWriter *w, const char *s) {
+	s = s ? s : "";
+	size_t len = strlen (s);
+	if (len > UT32_MAX) {
+		w->fail = true;
+		return;
+	}
+	rec_le32 (w, (ut32)len);
+	rec_put (w, s, len + 1);
+}
+
+static void rec_diff(RecordWriter *w, RzAnalysisDiff *diff) {
+	ut64 dist;
+	memcpy (&dist, &diff->dist, sizeof (dist));
+	rec_le32 (w, (ut32)diff->type);
+	rec_le64 (w, diff->addr);
+	rec_le64 (w, dist);
+	rec_le32 (w, diff->size);
+	rec_u8 (w, diff->name ? 1 : 0);
+	if (diff->name) {
+		rec_str (w, diff->name);
+	}
+}
+
+static void rec_switch_op(RecordWriter *w, RzAnalysisSwitchOp *op) {
+	rec_le64 (w, op->addr);
+	rec_le64 (w, op->min_val);
+	rec_le64 (w, op->max_val);
+	rec_le64 (w, op->def_val);
+	rec_le32 (w, (ut32)rz_list_length (op->cases));
+	RzListIter *it;
+	RzAnalysisCaseOp *cop;
+	rz_list_foreach (op->cases, it, cop) {
+		rec_le64 (w, cop->addr);
+		rec_le64 (w, cop->jump);
+		rec_le64 (w, cop->value);
+	}
+}
+
+// pass the record built in w to cb and start the next one
+static bool rec_emit(RecordWriter *w, ut64 addr, RzSerializeRecordCb cb, void *user) {
 	char key[0x20];
-	if (snprintf (key, sizeof (key), "0x%"PFMT64x, k) < 0) {
+	bool ret = !w->fail && snprintf (key, sizeof (key), "0x%"PFMT64x, addr) > 0
+		&& cb (user, key, (const ut8 *)rz_strbuf_get (&w->buf), rz_strbuf_length (&w->buf));
+	rz_strbuf_set (&w->buf, "");
+	w->fail = false;
+	return ret;
+}
+
+typedef struct {
+	const ut8 *p;
+	const ut8 *end;
+	bool fail;
+} RecordReader;
+
+static const ut8 *rd_take(RecordReader *r, ut64 size) {
+	if (r->fail || size > (ut64)(r->end - r->p)) {
+		r->fail = true;
+		return NULL;
+	}
+	const ut8 *p = r->p;
+	r->p += size;
+	return p;
+}
+
+static ut8 rd_u8(RecordReader *r) {
+	const ut8 *p = rd_take (r, 1);
+	return p ? *p : 0;
+}
+
+static ut32 rd_le32(RecordReader *r) {
+	const ut8 *p = rd_take (r, 4);
+	return p ? rz_read_le32 (p) : 0;
+}
+
+static ut64 rd_le64(RecordReader *r) {
+	const ut8 *p = rd_take (r, 8);
+	return p ? rz_read_le64 (p) : 0;
+}
+
+// points into the record, NULL if it is malformed
+static const char *rd_str(RecordReader *r) {
+	ut64 len = rd_le32 (r);
+	const ut8 *p = rd_take (r, len + 1);
+	if (!p || p[len] || memchr (p, 0, len)) {
+		r->fail = true;
+		return NULL;
+	}
+	return (const char *)p;
+}
+
+// number of elements of at least elem_size bytes each that follow
+static ut32 rd_count(RecordReader *r, ut64 elem_size) {
+	ut32 count = rd_le32 (r);
+	if ((ut64)count * elem_size > (ut64)(r->end - r->p)) {
+		r->fail = true;
+		return 0;
+	}
+	return count;
+}
+
+static RzAnalysisDiff *rd_diff(RecordReader *r) {
+	int type = (int)rd_le32 (r);
+	ut64 addr = rd_le64 (r);
+	ut64 dist = rd_le64 (r);
+	ut32 size = rd_le32 (r);
+	const char *name = rd_u8 (r) ? rd_str (r) : NULL;
+	if (r->fail) {
+		return NULL;
+	}
+	RzAnalysisDiff *diff = rz_analysis_diff_new ();
+	if (!diff) {
+		return NULL;
+	}
+	if (type == RZ_ANALYSIS_DIFF_TYPE_MATCH || type == RZ_ANALYSIS_DIFF_TYPE_UNMATCH) {
+		diff->type = type;
+	}
+	diff->addr = addr;
+	memcpy (&diff->dist, &dist, sizeof (diff->dist));
+	diff->size = size;
+	diff->name = name ? strdup (name) : NULL;
+	return diff;
+}
+
+static RzAnalysisSwitchOp *rd_switch_op(RecordReader *r) {
+	ut64 addr = rd_le64 (r);
+	ut64 min_val = rd_le64 (r);
+	ut64 max_val = rd_le64 (r);
+	ut64 def_val = rd_le64 (r);
+	ut32 count = rd_count (r, 24);
+	if (r->fail) {
+		return NULL;
+	}
+	RzAnalysisSwitchOp *sop = rz_analysis_switch_op_new (addr, min_val, max_val, def_val);
+	if (!sop) {
+		return NULL;
+	}
+	ut32 i;
+	for (i = 0; i < count; i++) {
+		ut64 caddr = rd_le64 (r);
+		ut64 jump = rd_le64 (r);
+		ut64 value = rd_le64 (r);
+		rz_analysis_switch_op_add_case (sop, caddr, value, jump);
+	}
+	return sop;
+}
+
+static bool rd_key(const char *key, ut64 *addr) {
+	errno = 0;
+	*addr = strtoull (key, NULL, 0);
+	return !errno;
+}
+
+/**
+ * \brief Save all blocks of \p analysis as binary records, see serialize_analysis.c
+ */
+RZ_API bool rz_serialize_analysis_blocks_save_records(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzSerializeRecordCb cb, void *user) {
+	rz_return_val_if_fail (analysis && cb, false);
+	RecordWriter w = { 0 };
+	rz_strbuf_init (&w.buf);
+	bool ret = true;
+	RBIter iter;
+	RzAnalysisBlock *block;
+	rz_rbtree_foreach (analysis->bb_tree, iter, block, RzAnalysisBlock, _rb) {
+		bool op_pos = block->op_pos && block->ninstr > 1 && block->op_pos_size >= block->ninstr - 1;
+		ut8 flags = (block->traced ? BLOCK_RECORD_TRACED : 0)
+			| (block->folded ? BLOCK_RECORD_FOLDED : 0)
+			| (op_pos ? BLOCK_RECORD_OP_POS : 0)
+			| (block->fingerprint ? BLOCK_RECORD_FINGERPRINT : 0)
+			| (block->cmpreg ? BLOCK_RECORD_CMPREG : 0)
+			| (block->diff ? BLOCK_RECORD_DIFF : 0)
+			| (block->switch_op ? BLOCK_RECORD_SWITCH_OP : 0);
+		rec_le64 (&w, block->size);
+		rec_le64 (&w, block->jump);
+		rec_le64 (&w, block->fail);
+		rec_le64 (&w, block->cmpval);
+		rec_le32 (&w, block->colorize);
+		rec_le32 (&w, (ut32)block->ninstr);
+		rec_le32 (&w, (ut32)block->stackptr);
+		rec_le32 (&w, (ut32)block->parent_stackptr);
+		rec_u8 (&w, flags);
+		if (op_pos) {
+			int i;
+			for (i = 0; i < block->ninstr - 1; i++) {
+				ut8 b[2];
+				rz_write_le16 (b, block->op_pos[i]);
+				rec_put (&w, b, sizeof (b));
+			}
+		}
+		if (block->fingerprint) {
+			rec_put (&w, block->fingerprint, block->size);
+		}
+		if (block->cmpreg) {
+			rec_str (&w, block->cmpreg);
+		}
+		if (block->diff) {
+			rec_diff (&w, block->diff);
+		}
+		if (block->switch_op) {
+			rec_switch_op (&w, block->switch_op);
+		}
+		if (!rec_emit (&w, block->addr, cb, user)) {
+			ret = false;
+			break;
+		}
+	}
+	rz_strbuf_fini (&w.buf);
+	return ret;
+}
+
+static bool block_load_record_cb(void *user, const char *k, const ut8 *data, ut64 size) {
+	RzAnalysis *analysis = user;
+	RecordReader r = { data, data + size, false };
+	RzAnalysisBlock proto = { 0 };
+	proto.size = rd_le64 (&r);
+	proto.jump = rd_le64 (&r);
+	proto.fail = rd_le64 (&r);
+	proto.cmpval = rd_le64 (&r);
+	proto.colorize = rd_le32 (&r);
+	proto.ninstr = (int)rd_le32 (&r);
+	proto.stackptr = (int)rd_le32 (&r);
+	proto.parent_stackptr = (int)rd_le32 (&r);
+	ut8 flags = rd_u8 (&r);
+	proto.traced = flags & BLOCK_RECORD_TRACED;
+	proto.folded = flags & BLOCK_RECORD_FOLDED;
+	if (flags & BLOCK_RECORD_OP_POS) {
+		const ut8 *p = proto.ninstr > 1 ? rd_take (&r, (ut64)(proto.ninstr - 1) * 2) : NULL;
+		proto.op_pos = p ? RZ_NEWS (ut16, proto.ninstr - 1) : NULL;
+		if (!proto.op_pos) {
+			goto error;
+		}
+		proto.op_pos_size = proto.ninstr - 1;
+		int i;
+		for (i = 0; i < proto.op_pos_size; i++) {
+			proto.op_pos[i] = rz_read_le16 (p + (size_t)i * 2);
+		}
+	}
+	if (flags & BLOCK_RECORD_FINGERPRINT && proto.size) {
+		const ut8 *p = proto.size <= INT_MAX ? rd_take (&r, proto.size) : NULL;
+		proto.fingerprint = p ? rz_mem_dup (p, (int)proto.size) : NULL;
+		if (!proto.fingerprint) {
+			goto error;
+		}
+	}
+	if (flags & BLOCK_RECORD_CMPREG) {
+		const char *cmpreg = rd_str (&r);
+		proto.cmpreg = cmpreg ? rz_str_constpool_get (&analysis->constpool, cmpreg) : NULL;
+	}
+	if (flags & BLOCK_RECORD_DIFF) {
+		proto.diff = rd_diff (&r);
+	}
+	if (flags & BLOCK_RECORD_SWITCH_OP) {
+		proto.switch_op = rd_switch_op (&r);
+	}
+	ut64 addr;
+	if (r.fail || !rd_key (k, &addr)) {
+		goto error;
+	}
+
+	RzAnalysisBlock *block = rz_analysis_create_block (analysis, addr, proto.size);
+	if (!block) {
+		goto error;
+	}
+	block->jump = proto.jump;
+	block->fail = proto.fail;
+	block->traced = proto.traced;
+	block->folded = proto.folded;
+	block->colorize = proto.colorize;
+	block->fingerprint = proto.fingerprint;
+	block->diff = proto.diff;
+	block->switch_op = proto.switch_op;
+	block->ninstr = proto.ninstr;
+	if (proto.op_pos) {
+		free (block->op_pos);
+		block->op_pos = proto.op_pos;
+		block->op_pos_size = proto.op_pos_size;
+	}
+	block->stackptr = proto.stackptr;
+	block->parent_stackptr = proto.parent_stackptr;
+	block->cmpval = proto.cmpval;
+	block->cmpreg = proto.cmpreg;
+	return true;
+error:
+	free (proto.fingerprint);
+	rz_analysis_diff_free (proto.diff);
+	rz_analysis_switch_op_free (proto.switch_op);
+	free (proto.op_pos);
+	return false;
+}
+
+/**
+ * \brief Load blocks from the binary records of the namespace \p path of \p src
+ *
+ * The same rules as for rz_serialize_analysis_blocks_load() apply.
+ */
+RZ_API bool rz_serialize_analysis_blocks_load_records(RZ_NONNULL RzSerializeNsSource *src, RZ_NONNULL const char *path, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	rz_return_val_if_fail (src && src->records && path && analysis, false);
+	bool ret = src->records (src->user, path, block_load_record_cb, analysis);
+	if (!ret) {
+		SERIALIZE_ERR ("basic blocks parsing failed");
+	}
+	return ret;
+}
+
+static bool save_label_record_cb(void *user, const ut64 k, const void *v) {
+	RecordWriter *w = user;
+	rec_le64 (w, k);
+	rec_str (w, v);
+	return true;
+}
+
+static void var_save_record(RecordWriter *w, RzAnalysisVar *var) {
+	char kind = var->kind == RZ_ANALYSIS_VAR_KIND_REG ? 'r' : var->kind == RZ_ANALYSIS_VAR_KIND_SPV ? 's' : 'b';
+	rec_u8 (w, (ut8)kind);
+	rec_u8 (w, (var->isarg ? VAR_RECORD_ARG : 0) | (var->regname ? VAR_RECORD_REG : 0) | (var->comment ? VAR_RECORD_COMMENT : 0));
+	rec_le64 (w, (ut64)(st64)var->delta);
+	rec_str (w, var->name);
+	rec_str (w, var->type);
+	if (var->regname) {
+		rec_str (w, var->regname);
+	}
+	if (var->comment) {
+		rec_str (w, var->comment);
+	}
+	rec_le32 (w, (ut32)var->accesses.len);
+	RzAnalysisVarAccess *acc;
+	rz_vector_foreach (&var->accesses, acc) {
+		rec_le64 (w, (ut64)acc->offset);
+		rec_u8 (w, acc->type);
+		rec_le64 (w, (ut64)acc->stackptr);
+		rec_str (w, acc->reg ? acc->reg : "");
+	}
+	rec_le32 (w, (ut32)var->constraints.len);
+	RzAnalysisVarConstraint *constr;
+	rz_vector_foreach (&var->constraints, constr) {
+		rec_le32 (w, (ut32)constr->cond);
+		rec_le64 (w, constr->val);
+	}
+}
+
+/**
+ * \brief Save all functions of \p analysis as binary records, see serialize_analysis.c
+ */
+RZ_API bool rz_serialize_analysis_functions_save_records(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzSerializeRecordCb cb, void *user) {
+	rz_return_val_if_fail (analysis && cb, false);
+	RecordWriter w = { 0 };
+	rz_strbuf_init (&w.buf);
+	bool ret = true;
+	RzListIter *it;
+	RzAnalysisFunction *function;
+	rz_list_foreach (analysis->fcns, it, function) {
+		ut8 flags = (function->folded ? FUNCTION_RECORD_FOLDED : 0)
+			| (function->bp_frame ? FUNCTION_RECORD_BP_FRAME : 0)
+			| (function->is_pure ? FUNCTION_RECORD_PURE : 0)
+			| (function->is_noreturn ? FUNCTION_RECORD_NORETURN : 0)
+			| (function->cc ? FUNCTION_RECORD_CC : 0)
+			| (function->fingerprint ? FUNCTION_RECORD_FINGERPRINT : 0)
+			| (function->diff ? FUNCTION_RECORD_DIFF : 0);
+		rec_le32 (&w, (ut32)function->bits);
+		rec_le32 (&w, (ut32)function->type);
+		rec_le32 (&w, (ut32)function->stack);
+		rec_le32 (&w, (ut32)function->maxstack);
+		rec_le32 (&w, (ut32)function->ninstr);
+		rec_le64 (&w, (ut64)function->bp_off);
+		rec_u8 (&w, flags);
+		rec_str (&w, function->name);
+		if (function->cc) {
+			rec_str (&w, function->cc);
+		}
+		if (function->fingerprint) {
+			if (function->fingerprint_size > UT32_MAX) {
+				w.fail = true;
+			}
+			rec_le32 (&w, (ut32)function->fingerprint_size);
+			rec_put (&w, function->fingerprint, function->fingerprint_size);
+		}
+		if (function->diff) {
+			rec_diff (&w, function->diff);
+		}
+
+		rec_le32 (&w, (ut32)rz_list_length (function->bbs));
+		RzListIter *bit;
+		RzAnalysisBlock *block;
+		rz_list_foreach (function->bbs, bit, block) {
+			rec_le64 (&w, block->addr);
+		}
+		rec_le32 (&w, (ut32)rz_list_length (function->imports));
+		const char *import;
+		rz_list_foreach (function->imports, bit, import) {
+			rec_str (&w, import);
+		}
+		rec_le32 (&w, function->labels->count);
+		ht_up_foreach (function->labels, save_label_record_cb, &w);
+		rec_le32 (&w, (ut32)rz_pvector_len (&function->vars));
+		void **vit;
+		rz_pvector_foreach (&function->vars, vit) {
+			var_save_record (&w, *vit);
+		}
+		if (!rec_emit (&w, function->addr, cb, user)) {
+			ret = false;
+			break;
+		}
+	}
+	rz_strbuf_fini (&w.buf);
+	return ret;
+}
+
+// same rules as rz_serialize_analysis_var_load()
+static void var_load_record(RecordReader *r, RzAnalysisFunction *fcn) {
+	char kind_chr = (char)rd_u8 (r);
+	ut8 flags = rd_u8 (r);
+	st64 delta = (st64)rd_le64 (r);
+	const char *name = rd_str (r);
+	const char *type = rd_str (r);
+	const char *regname = flags & VAR_RECORD_REG ? rd_str (r) : NULL;
+	const char *comment = flags & VAR_RECORD_COMMENT ? rd_str (r) : NULL;
+	RzVector accesses;
+	rz_vector_init (&accesses, sizeof (RzAnalysisVarAccess), NULL, NULL);
+	RzVector constraints;
+	rz_vector_init (&constraints, sizeof (RzAnalysisVarConstraint), NULL, NULL);
+	ut32 count = rd_count (r, 22);
+	ut32 i;
+	for (i = 0; i < count && !r->fail; i++) {
+		RzAnalysisVarAccess acc;
+		acc.offset = (st64)rd_le64 (r);
+		acc.type = rd_u8 (r);
+		acc.stackptr = (st64)rd_le64 (r);
+		acc.reg = rd_str (r);
+		if (!acc.reg || !*acc.reg || !acc.type || (acc.type & ~(RZ_ANALYSIS_VAR_ACCESS_TYPE_READ | RZ_ANALYSIS_VAR_ACCESS_TYPE_WRITE))) {
+			continue;
+		}
+		rz_vector_push (&accesses, &acc);
+	}
+	count = rd_count (r, 12);
+	for (i = 0; i < count && !r->fail; i++) {
+		RzAnalysisVarConstraint constr;
+		constr.cond = (_RzAnalysisCond)(st32)rd_le32 (r);
+		constr.val = rd_le64 (r);
+		if (constr.cond < RZ_ANALYSIS_COND_AL || constr.cond > RZ_ANALYSIS_COND_LS) {
+			continue;
+		}
+		rz_vector_push (&constraints, &constr);
+	}
+	if (r->fail) {
+		goto beach;
+	}
+
+	RzAnalysisVarKind kind;
+	switch (kind_chr) {
+	case 'r':
+		kind = RZ_ANALYSIS_VAR_KIND_REG;
+		break;
+	case 's':
+		kind = RZ_ANALYSIS_VAR_KIND_SPV;
+		break;
+	case 'b':
+		kind = RZ_ANALYSIS_VAR_KIND_BPV;
+		break;
+	default:
+		goto beach;
+	}
+	if (kind == RZ_ANALYSIS_VAR_KIND_REG) {
+		RzRegItem *reg = regname ? rz_reg_get (fcn->analysis->reg, regname, -1) : NULL;
+		if (!reg) {
+			goto beach;
+		}
+		delta = reg->index;
+	}
+	RzAnalysisVar *var = rz_analysis_function_set_var (fcn, delta, kind, type, 0, flags & VAR_RECORD_ARG, name);
+	if (!var) {
+		goto beach;
+	}
+	if (comment) {
+		free (var->comment);
+		var->comment = strdup (comment);
+	}
+	RzAnalysisVarAccess *acc;
+	rz_vector_foreach (&accesses, acc) {
+		rz_analysis_var_set_access (var, acc->reg, fcn->addr + acc->offset, acc->type, acc->stackptr);
+	}
+	RzAnalysisVarConstraint *constr;
+	rz_vector_foreach (&constraints, constr) {
+		rz_analysis_var_add_constraint (var, constr);
+	}
+beach:
+	rz_vector_fini (&accesses);
+	rz_vector_fini (&constraints);
+}
+
+static bool function_load_record_cb(void *user, const char *k, const ut8 *data, ut64 size) {
+	RzAnalysis *analysis = user;
+	RecordReader r = { data, data + size, false };
+	RzAnalysisFunction *function = rz_analysis_function_new (analysis);
+	if (!function) {
 		return false;
 	}
-	PJ *j = pj_new ();
-	if (!j) {
+	function->bits = (int)rd_le32 (&r);
+	function->type = (int)rd_le32 (&r);
+	function->stack = (int)rd_le32 (&r);
+	function->maxstack = (int)rd_le32 (&r);
+	function->ninstr = (int)rd_le32 (&r);
+	function->bp_off = (st64)rd_le64 (&r);
+	ut8 flags = rd_u8 (&r);
+	function->folded = flags & FUNCTION_RECORD_FOLDED;
+	function->bp_frame = flags & FUNCTION_RECORD_BP_FRAME;
+	function->is_pure = flags & FUNCTION_RECORD_PURE;
+	const char *name = rd_str (&r);
+	free (function->name);
+	function->name = name ? strdup (name) : NULL;
+	if (flags & FUNCTION_RECORD_CC) {
+		const char *cc = rd_str (&r);
+		function->cc = cc ? rz_str_constpool_get (&analysis->constpool, cc) : NULL;
+	}
+	if (flags & FUNCTION_RECORD_FINGERPRINT) {
+		ut32 fsize = rd_le32 (&r);
+		const ut8 *p = fsize ? rd_take (&r, fsize) : NULL;
+		function->fingerprint = p && fsize <= INT_MAX ? rz_mem_dup (p, (int)fsize) : NULL;
+		function->fingerprint_size = function->fingerprint ? fsize : 0;
+	}
+	if (flags & FUNCTION_RECORD_DIFF) {
+		rz_analysis_diff_free (function->diff);
+		function->diff = rd_diff (&r);
+	}
+	ut32 count = rd_count (&r, 8);
+	ut32 i;
+	for (i = 0; i < count && !r.fail; i++) {
+		RzAnalysisBlock *block = rz_analysis_get_block_at (analysis, rd_le64 (&r));
+		if (block) {
+			rz_analysis_function_add_block (function, block);
+		}
+	}
+	count = rd_count (&r, 5);
+	for (i = 0; i < count && !r.fail; i++) {
+		char *import = rz_str_new (rd_str (&r));
+		if (!import) {
+			break;
+		}
+		if (!function->imports) {
+			function->imports = rz_list_newf ((RzListFree)free);
+			if (!function->imports) {
+				free (import);
+				break;
+			}
+		}
+		rz_list_push (function->imports, import);
+	}
+	count = rd_count (&r, 13);
+	for (i = 0; i < count && !r.fail; i++) {
+		ut64 addr = rd_le64 (&r);
+		const char *label = rd_str (&r);
+		if (label) {
+			rz_analysis_function_set_label (function, label, addr);
+		}
+	}
+	if (r.fail || !rd_key (k, &function->addr) || !function->name || !rz_analysis_add_function (analysis, function)) {
+		rz_analysis_function_free (function);
 		return false;
 	}
-	pj_a (j);
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach (ht, store_xref_cb, j);
-	pj_end (j);
-	sdb_set (db, key, pj_string (j), 0);
-	pj_free (j);
+	function->is_noreturn = flags & FUNCTION_RECORD_NORETURN; // Can't set directly, rz_analysis_add_function() overwrites it
+
+	count = rd_count (&r, 28);
+	for (i = 0; i < count && !r.fail; i++) {
+		var_load_record (&r, function);
+	}
+	return !r.fail;
+}
+
+/**
+ * \brief Load functions from the binary records of the namespace \p path of \p src
+ *
+ * The same rules as for rz_serialize_analysis_functions_load() apply.
+ */
+RZ_API bool rz_serialize_analysis_functions_load_records(RZ_NONNULL RzSerializeNsSource *src, RZ_NONNULL const char *path, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	rz_return_val_if_fail (src && src->records && path && analysis, false);
+	bool ret = src->records (src->user, path, function_load_record_cb, analysis);
+	if (!ret) {
+		SERIALIZE_ERR ("functions parsing failed");
+	}
+	return ret;
+}
+
+typedef struct {
+	Sdb *db;
+	PJ *j;
+	ut64 from;
+} XrefsSaveCtx;
+
+static void store_xrefs_list(XrefsSaveCtx *ctx) {
+	char key[0x20];
+	if (!ctx->j) {
+		return;
+	}
+	pj_end (ctx->j);
+	if (snprintf (key, sizeof (key), "0x%"PFMT64x, ctx->from) >= 0) {
+		sdb_set (ctx->db, key, pj_string (ctx->j), 0);
+	}
+	pj_free (ctx->j);
+	ctx->j = NULL;
+}
+
+static bool store_xref_cb(void *user, const RzAnalysisRef *ref) {
+	XrefsSaveCtx *ctx = user;
+	if (ctx->j && ctx->from != ref->at) {
+		store_xrefs_list (ctx);
+	}
+	if (!ctx->j) {
+		ctx->j = pj_new ();
+		if (!ctx->j) {
+			return false;
+		}
+		ctx->from = ref->at;
+		pj_a (ctx->j);
+	}
+	pj_o (ctx->j);
+	pj_kn (ctx->j, "to", ref->addr);
+	if (ref->type != RZ_ANALYSIS_REF_TYPE_NULL) {
+		char type[2] = { ref->type, '\0' };
+		pj_ks (ctx->j, "type", type);
+	}
+	pj_end (ctx->j);
 	return true;
 }
 
 RZ_API void rz_serialize_analysis_xrefs_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis) {
-	ht_up_foreach (analysis->dict_refs, store_xrefs_list_cb, db);
+	XrefsSaveCtx ctx = { db, NULL, 0 };
+	rz_analysis_refs_foreach_in (analysis, 0, UT64_MAX, store_xref_cb, &ctx);
+	store_xrefs_list (&ctx);
 }
 
 static bool xrefs_load_cb(void *user, const char *k, const char *v) {
@@ -1970,6 +2644,7 @@ RZ_API void rz_serialize_analysis_sign_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAna
 RZ_API bool rz_serialize_analysis_sign_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
 	sdb_reset (analysis->sdb_zigns);
 	sdb_copy (db, analysis->sdb_zigns);
+	rz_sign_index_invalidate (analysis);
 	Sdb *spaces_db = sdb_ns (db, "spaces", false);
 	if (!spaces_db) {
 		SERIALIZE_ERR ("missing spaces namespace");
@@ -2030,8 +2705,9 @@ RZ_API void rz_serialize_analysis_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis
 	rz_serialize_analysis_cc_save (sdb_ns (db, "cc", true), analysis);
 }
 
-RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+static bool analysis_load(RZ_NULLABLE Sdb *db, RZ_NULLABLE RzSerializeNsSource *src, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
 	bool ret = false;
+	char *records = NULL;
 	RzSerializeAnalDiffParser diff_parser = rz_serialize_analysis_diff_parser_new ();
 	if (!diff_parser) {
 		goto beach;
@@ -2040,12 +2716,26 @@ RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis
 	rz_analysis_purge (analysis);
 
 	Sdb *subdb;
-#define SUB(ns, call) SUB_DO(ns, call, goto beach;)
+#define SUB(ns, call) SUB_SRC_DO(ns, call, goto beach;)
 	SUB ("xrefs", rz_serialize_analysis_xrefs_load (subdb, analysis, res));
 
-	SUB ("blocks", rz_serialize_analysis_blocks_load (subdb, analysis, diff_parser, res));
+	if ((records = serialize_src_records (src, "blocks"))) {
+		if (!rz_serialize_analysis_blocks_load_records (src, records, analysis, res)) {
+			goto beach;
+		}
+		RZ_FREE (records);
+	} else {
+		SUB ("blocks", rz_serialize_analysis_blocks_load (subdb, analysis, diff_parser, res));
+	}
 	// All bbs have ref=1 now
-	SUB ("functions", rz_serialize_analysis_functions_load (subdb, analysis, diff_parser, res));
+	if ((records = serialize_src_records (src, "functions"))) {
+		if (!rz_serialize_analysis_functions_load_records (src, records, analysis, res)) {
+			goto beach;
+		}
+		RZ_FREE (records);
+	} else {
+		SUB ("functions", rz_serialize_analysis_functions_load (subdb, analysis, diff_parser, res));
+	}
 	// BB's refs have increased if they are part of a function.
 	// We must subtract from each to hold our invariant again.
 	// If any block has ref=0 then, it should be deleted. But we can't do this while
@@ -2074,6 +2764,21 @@ RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis
 
 	ret = true;
 beach:
+	free (records);
 	rz_serialize_analysis_diff_parser_free (diff_parser);
 	return ret;
 }
+
+RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	return analysis_load (db, NULL, analysis, res);
+}
+
+/**
+ * \brief Load the analysis from \p src, decoding each namespace only when it is read
+ *
+ * Blocks and functions are read straight from their binary records if \p src has them.
+ */
+RZ_API bool rz_serialize_analysis_load_from(RZ_NONNULL RzSerializeNsSource *src, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	rz_return_val_if_fail (src && analysis, false);
+	return analysis_load (NULL, src, analysis, res);
+}
@@ -671,6 +671,7 @@ RZ_API bool rz_sign_add_item(RzAnalysis *a, RzSignItem *it) {
 		serialize (a, curit, key, val);
 	}
 	sdb_set (a->sdb_zigns, key, val, 0);
+	rz_sign_index_invalidate (a);
 
 out:
 	rz_sign_item_free (curit);
@@ -1140,6 +1141,7 @@ RZ_API bool rz_sign_delete(RzAnalysis *a, const char *name) {
 	if (!a || !name) {
 		return false;
 	}
+	rz_sign_index_invalidate (a);
 	// Remove all zigns
 	if (*name == '*') {
 		if (!rz_spaces_current (&a->zign_spaces)) {
@@ -2167,6 +2169,7 @@ static bool unsetForCB(void *user, const char *k, const char *v) {
 RZ_API void rz_sign_space_unset_for(RzAnalysis *a, const RzSpace *space) {
 	rz_return_if_fail (a);
 	struct ctxUnsetForCB ctx = { a, space };
+	rz_sign_index_invalidate (a);
 	sdb_foreach (a->sdb_zigns, unsetForCB, &ctx);
 }
 
@@ -2197,52 +2200,244 @@ RZ_API void rz_sign_space_rename_for(RzAnalysis *a, const RzSpace *space, const
 	struct ctxRenameForCB ctx = {.analysis = a};
 	serializeKeySpaceStr (a, oname, "", ctx.oprefix);
 	serializeKeySpaceStr (a, nname, "", ctx.nprefix);
+	rz_sign_index_invalidate (a);
 	sdb_foreach (a->sdb_zigns, renameForCB, &ctx);
 }
 
-struct ctxForeachCB {
-	RzAnalysis *analysis;
-	RzSignForeachCallback cb;
-	bool freeit;
-	void *user;
+/* Compiled zignatures.
+ *
+ * sdb_zigns stays the source of truth, the index keeps every zignature
+ * deserialized once, in sdb order, together with a hashtable from hashed
+ * metric keys (graph metrics, offset, bb hash, refs, vars and types) to the
+ * items carrying them. Matching a function only looks at the items sharing
+ * one of its keys, hash collisions are weeded out by the regular match
+ * functions. The index is dropped whenever sdb_zigns is modified through
+ * this API and rebuilt lazily on the next use.
+ */
+
+struct rz_sign_index_t {
+	int refs;
+	RzPVector /*<RzSignItem *>*/ items;
+	HtUP /*<ut64, RzVector<ut32>>*/ *keys;
+	RzVector /*<ut32>*/ loose_graphs; // graphs with wildcard metrics
+	ut32 ngraphs;
+	ut32 nbbhashes;
+	ut32 nrefs;
+	ut32 nvars;
+	ut32 ntypes;
 };
 
-static bool foreachCB(void *user, const char *k, const char *v) {
-	struct ctxForeachCB *ctx = (struct ctxForeachCB *) user;
-	RzSignItem *it = rz_sign_item_new ();
-	RzAnalysis *a = ctx->analysis;
+#define KEY_INIT  0xcbf29ce484222325ULL
+#define KEY_PRIME 0x100000001b3ULL
+
+static ut64 key_feed(ut64 h, const void *data, size_t len) {
+	const ut8 *p = data;
+	size_t i;
+	for (i = 0; i < len; i++) {
+		h = (h ^ p[i]) * KEY_PRIME;
+	}
+	return h;
+}
+
+static ut64 key_new(RzSignType type) {
+	ut8 t = (ut8)type;
+	return key_feed (KEY_INIT, &t, 1);
+}
+
+static ut64 key_graph(int cc, int nbbs, int edges, int ebbs) {
+	int m[4] = { cc, nbbs, edges, ebbs };
+	return key_feed (key_new (RZ_SIGN_GRAPH), m, sizeof (m));
+}
+
+static ut64 key_addr(ut64 addr) {
+	return key_feed (key_new (RZ_SIGN_OFFSET), &addr, sizeof (addr));
+}
+
+static ut64 key_str(RzSignType type, const char *str) {
+	return key_feed (key_new (type), str, strlen (str));
+}
+
+static ut64 key_list(RzSignType type, RzList *list) {
+	RzListIter *iter;
+	const char *str;
+	ut64 h = key_new (type);
+	rz_list_foreach (list, iter, str) {
+		h = key_feed (h, str, strlen (str) + 1);
+	}
+	return h;
+}
+
+static void index_keys_free(HtUPKv *kv) {
+	rz_vector_free (kv->value);
+}
+
+static RzSignIndex *index_new(void) {
+	RzSignIndex *idx = RZ_NEW0 (RzSignIndex);
+	if (!idx) {
+		return NULL;
+	}
+	idx->keys = ht_up_new (NULL, index_keys_free, NULL);
+	if (!idx->keys) {
+		free (idx);
+		return NULL;
+	}
+	idx->refs = 1;
+	rz_pvector_init (&idx->items, (RzPVectorFree)rz_sign_item_free);
+	rz_vector_init (&idx->loose_graphs, sizeof (ut32), NULL, NULL);
+	return idx;
+}
+
+static void index_add_key(RzSignIndex *idx, ut64 key, ut32 i) {
+	RzVector *v = ht_up_find (idx->keys, key, NULL);
+	if (!v) {
+		v = rz_vector_new (sizeof (ut32), NULL, NULL);
+		if (!v || !ht_up_insert (idx->keys, key, v)) {
+			rz_vector_free (v);
+			return;
+		}
+	}
+	rz_vector_push (v, &i);
+}
 
-	if (rz_sign_deserialize (a, it, k, v)) {
-		RzSpace *cur = rz_spaces_current (&a->zign_spaces);
-		if (ctx->cb && cur == it->space) {
-			ctx->cb (it, ctx->user);
+static bool index_add_item(RzSignIndex *idx, RzSignItem *it) {
+	ut32 i = rz_pvector_len (&idx->items);
+	if (!rz_pvector_push (&idx->items, it)) {
+		return false;
+	}
+	RzSignGraph *graph = it->graph;
+	if (graph) {
+		if (graph->cc != -1 && graph->nbbs != -1 && graph->edges != -1 && graph->ebbs != -1) {
+			index_add_key (idx, key_graph (graph->cc, graph->nbbs, graph->edges, graph->ebbs), i);
+		} else {
+			rz_vector_push (&idx->loose_graphs, &i);
 		}
-	} else {
+		idx->ngraphs++;
+	}
+	if (it->addr != UT64_MAX) {
+		index_add_key (idx, key_addr (it->addr), i);
+	}
+	if (it->hash && it->hash->bbhash && *it->hash->bbhash) {
+		index_add_key (idx, key_str (RZ_SIGN_BBHASH, it->hash->bbhash), i);
+		idx->nbbhashes++;
+	}
+	if (it->refs) {
+		index_add_key (idx, key_list (RZ_SIGN_REFS, it->refs), i);
+		idx->nrefs++;
+	}
+	if (it->vars) {
+		index_add_key (idx, key_list (RZ_SIGN_VARS, it->vars), i);
+		idx->nvars++;
+	}
+	if (it->types) {
+		index_add_key (idx, key_list (RZ_SIGN_TYPES, it->types), i);
+		idx->ntypes++;
+	}
+	return true;
+}
+
+static void index_collect(RzSignIndex *idx, ut64 key, RzVector *out) {
+	RzVector *v = ht_up_find (idx->keys, key, NULL);
+	ut32 *i;
+	if (v) {
+		rz_vector_foreach (v, i) {
+			rz_vector_push (out, i);
+		}
+	}
+}
+
+struct ctxIndexCB {
+	RzAnalysis *analysis;
+	RzSignIndex *idx;
+};
+
+static bool indexCB(void *user, const char *k, const char *v) {
+	struct ctxIndexCB *ctx = (struct ctxIndexCB *)user;
+	RzSignItem *it = rz_sign_item_new ();
+	if (!it) {
+		return false;
+	}
+	if (!rz_sign_deserialize (ctx->analysis, it, k, v)) {
 		eprintf ("error: cannot deserialize zign\n");
+		rz_sign_item_free (it);
+		return true;
 	}
-	if (ctx->freeit) {
+	if (!index_add_item (ctx->idx, it)) {
 		rz_sign_item_free (it);
+		return false;
 	}
 	return true;
 }
 
-static bool rz_sign_foreach_nofree(RzAnalysis *a, RzSignForeachCallback cb, void *user) {
-	rz_return_val_if_fail (a && cb, false);
-	struct ctxForeachCB ctx = { a, cb, false, user };
-	return sdb_foreach (a->sdb_zigns, foreachCB, &ctx);
+/**
+ * \brief Get a reference to the compiled zignatures, building them if needed
+ *
+ * The returned index must be released with rz_sign_index_unref() and stays
+ * valid even if the zignatures are modified in the meantime.
+ */
+RZ_API RzSignIndex *rz_sign_index_get(RzAnalysis *a) {
+	rz_return_val_if_fail (a, NULL);
+	if (!a->zign_index) {
+		struct ctxIndexCB ctx = { a, index_new () };
+		if (!ctx.idx) {
+			return NULL;
+		}
+		if (!sdb_foreach (a->sdb_zigns, indexCB, &ctx)) {
+			rz_sign_index_unref (ctx.idx);
+			return NULL;
+		}
+		a->zign_index = ctx.idx;
+	}
+	a->zign_index->refs++;
+	return a->zign_index;
 }
 
+RZ_API void rz_sign_index_unref(RzSignIndex *idx) {
+	if (!idx || --idx->refs > 0) {
+		return;
+	}
+	rz_pvector_fini (&idx->items);
+	rz_vector_fini (&idx->loose_graphs);
+	ht_up_free (idx->keys);
+	free (idx);
+}
+
+/**
+ * \brief Drop the compiled zignatures, must be called after modifying sdb_zigns
+ */
+RZ_API void rz_sign_index_invalidate(RzAnalysis *a) {
+	rz_return_if_fail (a);
+	rz_sign_index_unref (a->zign_index);
+	a->zign_index = NULL;
+}
+
+/**
+ * \brief Call \p cb on every zignature of the current zignspace
+ *
+ * The items belong to the compiled index, \p cb must not modify or free them.
+ */
 RZ_API bool rz_sign_foreach(RzAnalysis *a, RzSignForeachCallback cb, void *user) {
 	rz_return_val_if_fail (a && cb, false);
-	struct ctxForeachCB ctx = { a, cb, true, user };
-	return sdb_foreach (a->sdb_zigns, foreachCB, &ctx);
+	RzSignIndex *idx = rz_sign_index_get (a);
+	if (!idx) {
+		return false;
+	}
+	const RzSpace *cur = rz_spaces_current (&a->zign_spaces);
+	void **it;
+	rz_pvector_foreach (&idx->items, it) {
+		RzSignItem *item = *it;
+		if (item->space == cur) {
+			cb (item, user);
+		}
+	}
+	rz_sign_index_unref (idx);
+	return true;
 }
 
 RZ_API RzSignSearch *rz_sign_search_new(void) {
 	RzSignSearch *ret = RZ_NEW0 (RzSignSearch);
 	if (ret) {
 		ret->search = rz_search_new (RZ_SEARCH_KEYWORD);
-		ret->items = rz_list_newf ((RzListFree) rz_sign_item_free);
+		ret->items = rz_list_new ();
 	}
 	return ret;
 }
@@ -2253,6 +2448,7 @@ RZ_API void rz_sign_search_free(RzSignSearch *ss) {
 	}
 	rz_search_free (ss->search);
 	rz_list_free (ss->items);
+	rz_sign_index_unref (ss->index);
 	free (ss);
 }
 
@@ -2293,7 +2489,9 @@ RZ_API void rz_sign_search_init(RzAnalysis *a, RzSignSearch *ss, int minsz, RzSi
 	ss->user = user;
 	rz_list_purge (ss->items);
 	rz_search_reset (ss->search, RZ_SEARCH_KEYWORD);
-	rz_sign_foreach_nofree (a, addSearchKwCB, &ctx);
+	rz_sign_index_unref (ss->index);
+	ss->index = rz_sign_index_get (a);
+	rz_sign_foreach (a, addSearchKwCB, &ctx);
 	rz_search_begin (ss->search);
 	rz_search_set_callback (ss->search, searchHitCB, ss);
 }
@@ -2495,10 +2693,100 @@ static int match_metrics(RzSignItem *it, void *user) {
 	return count? 0: 1;
 }
 
+static void collect_candidates(RzSignIndex *idx, struct metric_ctx *ctx, RzSignType type, RzVector *out) {
+	RzSignSearchMetrics *sm = ctx->sm;
+	ut32 *i;
+	switch (type) {
+	case RZ_SIGN_GRAPH:
+		if (idx->ngraphs) {
+			int ebbs = -1;
+			int edges = rz_analysis_function_count_edges (sm->fcn, &ebbs);
+			int cc = rz_analysis_function_complexity (sm->fcn);
+			index_collect (idx, key_graph (cc, rz_list_length (sm->fcn->bbs), edges, ebbs), out);
+			rz_vector_foreach (&idx->loose_graphs, i) {
+				rz_vector_push (out, i);
+			}
+		}
+		break;
+	case RZ_SIGN_OFFSET:
+		index_collect (idx, key_addr (sm->fcn->addr), out);
+		break;
+	case RZ_SIGN_BBHASH:
+		if (idx->nbbhashes && !ctx->digest_hex) {
+			ctx->digest_hex = rz_sign_calc_bbhash (sm->analysis, sm->fcn);
+		}
+		if (idx->nbbhashes && ctx->digest_hex) {
+			index_collect (idx, key_str (RZ_SIGN_BBHASH, ctx->digest_hex), out);
+		}
+		break;
+	case RZ_SIGN_REFS:
+		if (idx->nrefs && !ctx->refs) {
+			ctx->refs = rz_sign_fcn_refs (sm->analysis, sm->fcn);
+		}
+		if (idx->nrefs && ctx->refs) {
+			index_collect (idx, key_list (RZ_SIGN_REFS, ctx->refs), out);
+		}
+		break;
+	// match_metrics() checks RZ_SIGN_TYPES against the vars and
+	// RZ_SIGN_VARS against the types, the candidates must follow it
+	case RZ_SIGN_TYPES:
+		if (idx->nvars && !ctx->vars) {
+			ctx->vars = rz_sign_fcn_vars (sm->analysis, sm->fcn);
+		}
+		if (idx->nvars && ctx->vars) {
+			index_collect (idx, key_list (RZ_SIGN_VARS, ctx->vars), out);
+		}
+		break;
+	case RZ_SIGN_VARS:
+		if (idx->ntypes && !ctx->types) {
+			ctx->types = rz_sign_fcn_types (sm->analysis, sm->fcn);
+		}
+		if (idx->ntypes && ctx->types) {
+			index_collect (idx, key_list (RZ_SIGN_TYPES, ctx->types), out);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static int cmp_ut32(const void *a, const void *b) {
+	ut32 x = *(const ut32 *)a;
+	ut32 y = *(const ut32 *)b;
+	return x < y ? -1 : x > y;
+}
+
 RZ_API int rz_sign_fcn_match_metrics(RzSignSearchMetrics *sm) {
 	rz_return_val_if_fail (sm && sm->mincc >= 0 && sm->analysis && sm->fcn, false);
 	struct metric_ctx ctx = { 0, sm, NULL, NULL, NULL, NULL };
-	rz_sign_foreach (sm->analysis, match_metrics, (void *)&ctx);
+	RzSignIndex *idx = rz_sign_index_get (sm->analysis);
+	if (!idx) {
+		return 0;
+	}
+	RzVector cands;
+	rz_vector_init (&cands, sizeof (ut32), NULL, NULL);
+	RzSignType type;
+	int t = 0;
+	while ((type = sm->types[t++])) {
+		collect_candidates (idx, &ctx, type, &cands);
+	}
+	// visit the candidates in sdb order, as a full scan would
+	qsort (cands.a, cands.len, sizeof (ut32), cmp_ut32);
+	const RzSpace *cur = rz_spaces_current (&sm->analysis->zign_spaces);
+	ut32 last = UT32_MAX;
+	ut32 *i;
+	rz_vector_foreach (&cands, i) {
+		if (*i == last) {
+			continue;
+		}
+		last = *i;
+		RzSignItem *it = rz_pvector_at (&idx->items, *i);
+		if (it->space == cur) {
+			match_metrics (it, &ctx);
+		}
+	}
+	rz_vector_fini (&cands);
+	rz_sign_index_unref (idx);
 	rz_list_free (ctx.refs);
 	rz_list_free (ctx.types);
 	rz_list_free (ctx.vars);
@@ -2547,6 +2835,293 @@ RZ_API void rz_sign_bytes_free(RzSignBytes *bytes) {
 	}
 }
 
+/* Compiled zignature files.
+ *
+ *   "RZSI" | ut32 version | ut32 count | count * item
+ *
+ * Every item holds the sdb key and value followed by the deserialized
+ * fields, so loading it only needs to copy strings around. Integers are
+ * little endian, strings are a ut32 length followed by the bytes, a length
+ * of UT32_MAX stands for NULL.
+ */
+
+#define SIGN_INDEX_MAGIC   "RZSI"
+#define SIGN_INDEX_VERSION 1
+
+enum {
+	SIGN_INDEX_GRAPH = 1 << 0,
+	SIGN_INDEX_BYTES = 1 << 1,
+	SIGN_INDEX_HASH = 1 << 2,
+	SIGN_INDEX_REFS = 1 << 3,
+	SIGN_INDEX_XREFS = 1 << 4,
+	SIGN_INDEX_VARS = 1 << 5,
+	SIGN_INDEX_TYPES = 1 << 6,
+};
+
+static bool write_ut32(RzBuffer *b, ut32 v) {
+	ut8 tmp[4];
+	rz_write_le32 (tmp, v);
+	return rz_buf_write (b, tmp, sizeof (tmp)) == sizeof (tmp);
+}
+
+static bool write_str(RzBuffer *b, const char *str) {
+	if (!str) {
+		return write_ut32 (b, UT32_MAX);
+	}
+	ut32 len = strlen (str);
+	return write_ut32 (b, len) && rz_buf_write (b, (const ut8 *)str, len) == len;
+}
+
+static bool write_list(RzBuffer *b, RzList *list) {
+	RzListIter *iter;
+	const char *str;
+	if (!write_ut32 (b, rz_list_length (list))) {
+		return false;
+	}
+	rz_list_foreach (list, iter, str) {
+		if (!write_str (b, str)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool write_item(RzAnalysis *a, RzBuffer *b, RzSignItem *it) {
+	char k[RZ_SIGN_KEY_MAXSZ], v[RZ_SIGN_VAL_MAXSZ];
+	ut8 tmp[8];
+	ut32 flags = (it->graph ? SIGN_INDEX_GRAPH : 0)
+		| (it->bytes ? SIGN_INDEX_BYTES : 0)
+		| (it->hash ? SIGN_INDEX_HASH : 0)
+		| (it->refs ? SIGN_INDEX_REFS : 0)
+		| (it->xrefs ? SIGN_INDEX_XREFS : 0)
+		| (it->vars ? SIGN_INDEX_VARS : 0)
+		| (it->types ? SIGN_INDEX_TYPES : 0);
+	*v = 0;
+	serialize (a, it, k, v);
+	rz_write_le64 (tmp, it->addr);
+	if (!write_str (b, k) || !write_str (b, v)
+		|| !write_str (b, it->space ? it->space->name : NULL)
+		|| !write_str (b, it->name) || !write_str (b, it->realname) || !write_str (b, it->comment)
+		|| rz_buf_write (b, tmp, sizeof (tmp)) != sizeof (tmp)
+		|| !write_ut32 (b, flags)) {
+		return false;
+	}
+	if (it->graph) {
+		RzSignGraph *g = it->graph;
+		if (!write_ut32 (b, g->cc) || !write_ut32 (b, g->nbbs) || !write_ut32 (b, g->edges)
+			|| !write_ut32 (b, g->ebbs) || !write_ut32 (b, g->bbsum)) {
+			return false;
+		}
+	}
+	if (it->bytes) {
+		ut32 size = it->bytes->size;
+		if (!it->bytes->bytes || !it->bytes->mask || !write_ut32 (b, size)
+			|| rz_buf_write (b, it->bytes->bytes, size) != size
+			|| rz_buf_write (b, it->bytes->mask, size) != size) {
+			return false;
+		}
+	}
+	if (it->hash && !write_str (b, it->hash->bbhash)) {
+		return false;
+	}
+	return (!it->refs || write_list (b, it->refs))
+		&& (!it->xrefs || write_list (b, it->xrefs))
+		&& (!it->vars || write_list (b, it->vars))
+		&& (!it->types || write_list (b, it->types));
+}
+
+/**
+ * \brief Save every zignature to \p file in the compiled format
+ *
+ * Unlike rz_sign_save() the file is overwritten, rz_sign_load() recognizes
+ * both formats.
+ */
+RZ_API bool rz_sign_save_compiled(RzAnalysis *a, const char *file) {
+	rz_return_val_if_fail (a && file, false);
+	RzSignIndex *idx = rz_sign_index_get (a);
+	if (!idx) {
+		return false;
+	}
+	if (rz_pvector_empty (&idx->items)) {
+		eprintf ("WARNING: no zignatures to save\n");
+		rz_sign_index_unref (idx);
+		return false;
+	}
+	bool retval = false;
+	RzBuffer *b = rz_buf_new_with_bytes (NULL, 0);
+	if (!b || rz_buf_write (b, (const ut8 *)SIGN_INDEX_MAGIC, 4) != 4
+		|| !write_ut32 (b, SIGN_INDEX_VERSION) || !write_ut32 (b, rz_pvector_len (&idx->items))) {
+		goto beach;
+	}
+	void **it;
+	rz_pvector_foreach (&idx->items, it) {
+		if (!write_item (a, b, *it)) {
+			goto beach;
+		}
+	}
+	retval = rz_buf_dump (b, file);
+beach:
+	rz_buf_free (b);
+	rz_sign_index_unref (idx);
+	return retval;
+}
+
+typedef struct {
+	const ut8 *buf;
+	size_t size;
+	size_t off;
+} IndexReader;
+
+static bool read_ut32(IndexReader *r, ut32 *v) {
+	if (r->size - r->off < 4) {
+		return false;
+	}
+	*v = rz_read_le32 (r->buf + r->off);
+	r->off += 4;
+	return true;
+}
+
+static bool read_str(IndexReader *r, char **str) {
+	ut32 len;
+	*str = NULL;
+	if (!read_ut32 (r, &len)) {
+		return false;
+	}
+	if (len == UT32_MAX) {
+		return true;
+	}
+	if (r->size - r->off < len || !(*str = rz_str_ndup ((const char *)r->buf + r->off, len))) {
+		return false;
+	}
+	r->off += len;
+	return true;
+}
+
+static bool read_list(IndexReader *r, RzList **list) {
+	ut32 n;
+	if (!read_ut32 (r, &n) || !(*list = rz_list_newf (free))) {
+		return false;
+	}
+	while (n--) {
+		char *str;
+		if (!read_str (r, &str) || !str || !rz_list_append (*list, str)) {
+			free (str);
+			return false;
+		}
+	}
+	return true;
+}
+
+static RzSignItem *read_item(RzAnalysis *a, IndexReader *r, char **k, char **v) {
+	char *space = NULL;
+	ut32 flags;
+	*k = *v = NULL;
+	RzSignItem *it = rz_sign_item_new ();
+	if (!it || !read_str (r, k) || !read_str (r, v) || !*k || !*v || !read_str (r, &space)
+		|| !read_str (r, &it->name) || !read_str (r, &it->realname) || !read_str (r, &it->comment)
+		|| r->size - r->off < 8) {
+		goto fail;
+	}
+	it->space = rz_spaces_add (&a->zign_spaces, space);
+	it->addr = rz_read_le64 (r->buf + r->off);
+	r->off += 8;
+	if (!read_ut32 (r, &flags)) {
+		goto fail;
+	}
+	if (flags & SIGN_INDEX_GRAPH) {
+		ut32 m[5];
+		int i;
+		for (i = 0; i < 5; i++) {
+			if (!read_ut32 (r, &m[i])) {
+				goto fail;
+			}
+		}
+		if (!(it->graph = RZ_NEW0 (RzSignGraph))) {
+			goto fail;
+		}
+		it->graph->cc = (int)m[0];
+		it->graph->nbbs = (int)m[1];
+		it->graph->edges = (int)m[2];
+		it->graph->ebbs = (int)m[3];
+		it->graph->bbsum = (int)m[4];
+	}
+	if (flags & SIGN_INDEX_BYTES) {
+		ut32 size;
+		if (!read_ut32 (r, &size) || size > INT_MAX || (r->size - r->off) / 2 < size
+			|| !(it->bytes = RZ_NEW0 (RzSignBytes))) {
+			goto fail;
+		}
+		it->bytes->size = size;
+		it->bytes->bytes = rz_mem_dup (r->buf + r->off, size);
+		it->bytes->mask = rz_mem_dup (r->buf + r->off + size, size);
+		if (!it->bytes->bytes || !it->bytes->mask) {
+			goto fail;
+		}
+		r->off += 2 * size;
+	}
+	if (flags & SIGN_INDEX_HASH) {
+		if (!(it->hash = RZ_NEW0 (RzSignHash)) || !read_str (r, &it->hash->bbhash)) {
+			goto fail;
+		}
+	}
+	if (((flags & SIGN_INDEX_REFS) && !read_list (r, &it->refs))
+		|| ((flags & SIGN_INDEX_XREFS) && !read_list (r, &it->xrefs))
+		|| ((flags & SIGN_INDEX_VARS) && !read_list (r, &it->vars))
+		|| ((flags & SIGN_INDEX_TYPES) && !read_list (r, &it->types))) {
+		goto fail;
+	}
+	free (space);
+	return it;
+fail:
+	free (space);
+	RZ_FREE (*k);
+	RZ_FREE (*v);
+	rz_sign_item_free (it);
+	return NULL;
+}
+
+static bool load_compiled(RzAnalysis *a, const ut8 *buf, size_t size) {
+	IndexReader r = { buf, size, 4 };
+	ut32 version, count;
+	if (!read_ut32 (&r, &version) || version != SIGN_INDEX_VERSION || !read_ut32 (&r, &count)) {
+		eprintf ("error: unsupported compiled zignatures version\n");
+		return false;
+	}
+	// loading into an empty database gives the index for free
+	RzSignIndex *idx = sdb_isempty (a->sdb_zigns) ? index_new () : NULL;
+	bool retval = true;
+	while (count--) {
+		char *k, *v;
+		RzSignItem *it = read_item (a, &r, &k, &v);
+		if (!it) {
+			eprintf ("error: corrupted compiled zignatures\n");
+			retval = false;
+			break;
+		}
+		sdb_set (a->sdb_zigns, k, v, 0);
+		free (k);
+		free (v);
+		if (!idx || !index_add_item (idx, it)) {
+			rz_sign_item_free (it);
+		}
+	}
+	rz_sign_index_invalidate (a);
+	if (retval && idx) {
+		a->zign_index = idx;
+	} else {
+		rz_sign_index_unref (idx);
+	}
+	return retval;
+}
+
+static bool is_compiled(const char *path) {
+	int len = 0;
+	char *magic = rz_file_slurp_range (path, 0, 4, &len);
+	bool ret = magic && len == 4 && !memcmp (magic, SIGN_INDEX_MAGIC, 4);
+	free (magic);
+	return ret;
+}
+
 static bool loadCB(void *user, const char *k, const char *v) {
 	RzAnalysis *a = (RzAnalysis *) user;
 	char nk[RZ_SIGN_KEY_MAXSZ], nv[RZ_SIGN_VAL_MAXSZ];
@@ -2607,12 +3182,21 @@ RZ_API bool rz_sign_load(RzAnalysis *a, const char *file) {
 		free (path);
 		return false;
 	}
+	if (is_compiled (path)) {
+		size_t size = 0;
+		char *buf = rz_file_slurp (path, &size);
+		bool ret = buf && load_compiled (a, (const ut8 *)buf, size);
+		free (buf);
+		free (path);
+		return ret;
+	}
 	Sdb *db = sdb_new (NULL, path, 0);
 	if (!db) {
 		free (path);
 		return false;
 	}
 	sdb_foreach (db, loadCB, a);
+	rz_sign_index_invalidate (a);
 	sdb_close (db);
 	sdb_free (db);
 	free (path);
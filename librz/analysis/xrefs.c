@@ -21,52 +21,337 @@ xrefs
 20: call 10
 #endif
 
-// XXX: is it possible to have multiple type for the same (from, to) pair?
-//      if it is, things need to be adjusted
+/* Both directions are stored in a RzAnalysisXrefSet: a set of (k1, k2)
+ * pairs with a type, kept in sorted columns. refs use (from, to) as key
+ * and xrefs (to, from), so all the refs from or to an address, or from or
+ * to a range of addresses, are contiguous.
+ *
+ * New pairs go in a small sorted append buffer. When it is full it becomes
+ * a run of its own and runs of similar size are merged, so there are only
+ * O(log n) runs to look at and every pair is moved O(log n) times.
+ * Deleted pairs are only marked and dropped by the next merge.
+ */
+
+#define XREF_DEAD 0xff
+#define XREFS_PENDING 256
+#define XREFS_MAX_RUNS 48
+
+typedef struct {
+	ut64 *k1;
+	ut64 *k2;
+	ut8 *type;
+	size_t len;
+} XrefRun;
+
+struct rz_analysis_xref_set_t {
+	XrefRun pending; // up to XREFS_PENDING pairs, never holds dead ones
+	XrefRun runs[XREFS_MAX_RUNS]; // oldest and biggest first
+	size_t nruns;
+	ut64 count; // live pairs
+	ut64 dead; // pairs marked as deleted in runs
+};
+
+typedef struct {
+	const XrefRun *run;
+	size_t i;
+	size_t end;
+} XrefCursor;
+
+static inline int key_cmp(ut64 a1, ut64 a2, ut64 b1, ut64 b2) {
+	if (a1 != b1) {
+		return a1 < b1? -1: 1;
+	}
+	if (a2 != b2) {
+		return a2 < b2? -1: 1;
+	}
+	return 0;
+}
 
-static RzAnalysisRef *rz_analysis_ref_new(ut64 addr, ut64 at, ut64 type) {
-	RzAnalysisRef *ref = RZ_NEW (RzAnalysisRef);
-	if (ref) {
-		ref->addr = addr;
-		ref->at = at;
-		ref->type = (type == -1)? RZ_ANALYSIS_REF_TYPE_CODE: type;
+// first index whose key is >= (k1, k2)
+static size_t run_lower_bound(const XrefRun *run, ut64 k1, ut64 k2) {
+	size_t lo = 0, hi = run->len;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (key_cmp (run->k1[mid], run->k2[mid], k1, k2) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
 	}
-	return ref;
+	return lo;
 }
 
-static void rz_analysis_ref_free(void *ref) {
-	free (ref);
+// first index whose k1 is > k1
+static size_t run_upper_bound(const XrefRun *run, ut64 k1) {
+	if (k1 == UT64_MAX) {
+		return run->len;
+	}
+	return run_lower_bound (run, k1 + 1, 0);
 }
 
-RZ_API RzList *rz_analysis_ref_list_new(void) {
-	return rz_list_newf (rz_analysis_ref_free);
+static bool run_alloc(XrefRun *run, size_t len) {
+	run->len = 0;
+	run->k1 = RZ_NEWS (ut64, len);
+	run->k2 = RZ_NEWS (ut64, len);
+	run->type = RZ_NEWS (ut8, len);
+	if (!run->k1 || !run->k2 || !run->type) {
+		RZ_FREE (run->k1);
+		RZ_FREE (run->k2);
+		RZ_FREE (run->type);
+		return false;
+	}
+	return true;
 }
 
-static void xrefs_ht_free(HtUPKv *kv) {
-	ht_up_free (kv->value);
+static void run_fini(XrefRun *run) {
+	free (run->k1);
+	free (run->k2);
+	free (run->type);
+	memset (run, 0, sizeof (*run));
 }
 
-static void xrefs_ref_free(HtUPKv *kv) {
-	rz_analysis_ref_free (kv->value);
+static inline void run_push(XrefRun *dst, const XrefRun *src, size_t i) {
+	dst->k1[dst->len] = src->k1[i];
+	dst->k2[dst->len] = src->k2[i];
+	dst->type[dst->len] = src->type[i];
+	dst->len++;
 }
 
-static bool appendRef(void *u, const ut64 k, const void *v) {
-	RzList *list = (RzList *)u;
-	RzAnalysisRef *ref = (RzAnalysisRef *)v;
-	RzAnalysisRef *cloned = rz_analysis_ref_new (ref->addr, ref->at, ref->type);
-	if (cloned) {
-		rz_list_append (list, cloned);
+// merge a and b into a new run, leaving out the dead pairs
+static bool run_merge(RzAnalysisXrefSet *set, XrefRun *out, const XrefRun *a, const XrefRun *b) {
+	if (!run_alloc (out, RZ_MAX (a->len + b->len, 1))) {
+		return false;
+	}
+	size_t i = 0, j = 0;
+	while (i < a->len || j < b->len) {
+		const XrefRun *src;
+		size_t k;
+		if (j >= b->len || (i < a->len && key_cmp (a->k1[i], a->k2[i], b->k1[j], b->k2[j]) < 0)) {
+			src = a;
+			k = i++;
+		} else {
+			src = b;
+			k = j++;
+		}
+		if (src->type[k] == XREF_DEAD) {
+			set->dead--;
+			continue;
+		}
+		run_push (out, src, k);
+	}
+	return true;
+}
+
+static bool set_merge_last(RzAnalysisXrefSet *set) {
+	XrefRun merged;
+	XrefRun *a = &set->runs[set->nruns - 2];
+	XrefRun *b = &set->runs[set->nruns - 1];
+	if (!run_merge (set, &merged, a, b)) {
+		return false;
+	}
+	run_fini (a);
+	run_fini (b);
+	*a = merged;
+	set->nruns--;
+	return true;
+}
+
+static bool set_flush_pending(RzAnalysisXrefSet *set) {
+	if (!set->pending.len) {
 		return true;
 	}
-	return false;
+	if (set->nruns == XREFS_MAX_RUNS && !set_merge_last (set)) {
+		return false;
+	}
+	XrefRun *run = &set->runs[set->nruns];
+	if (!run_alloc (run, set->pending.len)) {
+		return false;
+	}
+	memcpy (run->k1, set->pending.k1, set->pending.len * sizeof (ut64));
+	memcpy (run->k2, set->pending.k2, set->pending.len * sizeof (ut64));
+	memcpy (run->type, set->pending.type, set->pending.len);
+	run->len = set->pending.len;
+	set->pending.len = 0;
+	set->nruns++;
+	while (set->nruns > 1 && set->runs[set->nruns - 2].len <= 2 * set->runs[set->nruns - 1].len) {
+		if (!set_merge_last (set)) {
+			break;
+		}
+	}
+	return true;
 }
 
-static bool mylistrefs_cb(void *list, const ut64 k, const void *v) {
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach (ht, appendRef, list);
+// rewrite everything as a single run without dead pairs
+static void set_compact(RzAnalysisXrefSet *set) {
+	if (!set_flush_pending (set)) {
+		return;
+	}
+	while (set->nruns > 1) {
+		if (!set_merge_last (set)) {
+			return;
+		}
+	}
+	if (set->nruns == 1 && set->dead) {
+		XrefRun merged, empty = { 0 };
+		if (run_merge (set, &merged, &set->runs[0], &empty)) {
+			run_fini (&set->runs[0]);
+			set->runs[0] = merged;
+		}
+	}
+}
+
+static RzAnalysisXrefSet *set_new(void) {
+	RzAnalysisXrefSet *set = RZ_NEW0 (RzAnalysisXrefSet);
+	if (!set) {
+		return NULL;
+	}
+	if (!run_alloc (&set->pending, XREFS_PENDING)) {
+		free (set);
+		return NULL;
+	}
+	return set;
+}
+
+static void set_free(RzAnalysisXrefSet *set) {
+	if (!set) {
+		return;
+	}
+	size_t i;
+	for (i = 0; i < set->nruns; i++) {
+		run_fini (&set->runs[i]);
+	}
+	run_fini (&set->pending);
+	free (set);
+}
+
+// type of the (k1, k2) pair, dead or alive, or NULL if it has never been added
+static ut8 *set_find(RzAnalysisXrefSet *set, ut64 k1, ut64 k2) {
+	size_t i, pos = run_lower_bound (&set->pending, k1, k2);
+	if (pos < set->pending.len && set->pending.k1[pos] == k1 && set->pending.k2[pos] == k2) {
+		return &set->pending.type[pos];
+	}
+	for (i = set->nruns; i-- > 0;) {
+		XrefRun *run = &set->runs[i];
+		pos = run_lower_bound (run, k1, k2);
+		if (pos < run->len && run->k1[pos] == k1 && run->k2[pos] == k2) {
+			return &run->type[pos];
+		}
+	}
+	return NULL;
+}
+
+static bool set_insert(RzAnalysisXrefSet *set, ut64 k1, ut64 k2, ut8 type) {
+	ut8 *t = set_find (set, k1, k2);
+	if (t) {
+		if (*t == XREF_DEAD) {
+			set->dead--;
+			set->count++;
+		}
+		*t = type;
+		return true;
+	}
+	XrefRun *p = &set->pending;
+	if (p->len == XREFS_PENDING && !set_flush_pending (set)) {
+		return false;
+	}
+	size_t pos = run_lower_bound (p, k1, k2);
+	size_t tail = p->len - pos;
+	memmove (p->k1 + pos + 1, p->k1 + pos, tail * sizeof (ut64));
+	memmove (p->k2 + pos + 1, p->k2 + pos, tail * sizeof (ut64));
+	memmove (p->type + pos + 1, p->type + pos, tail);
+	p->k1[pos] = k1;
+	p->k2[pos] = k2;
+	p->type[pos] = type;
+	p->len++;
+	set->count++;
 	return true;
 }
 
+static bool set_delete(RzAnalysisXrefSet *set, ut64 k1, ut64 k2) {
+	XrefRun *p = &set->pending;
+	size_t pos = run_lower_bound (p, k1, k2);
+	if (pos < p->len && p->k1[pos] == k1 && p->k2[pos] == k2) {
+		size_t tail = p->len - pos - 1;
+		memmove (p->k1 + pos, p->k1 + pos + 1, tail * sizeof (ut64));
+		memmove (p->k2 + pos, p->k2 + pos + 1, tail * sizeof (ut64));
+		memmove (p->type + pos, p->type + pos + 1, tail);
+		p->len--;
+		set->count--;
+		return true;
+	}
+	ut8 *t = set_find (set, k1, k2);
+	if (!t || *t == XREF_DEAD) {
+		return false;
+	}
+	*t = XREF_DEAD;
+	set->count--;
+	set->dead++;
+	if (set->dead > XREFS_PENDING && set->dead > set->count) {
+		set_compact (set);
+	}
+	return true;
+}
+
+// call cb on the live pairs with k1 in [lo, hi], sorted by (k1, k2)
+static bool set_foreach(RzAnalysisXrefSet *set, ut64 lo, ut64 hi, RzAnalysisRefForeachCb cb, void *user) {
+	XrefCursor cur[XREFS_MAX_RUNS + 1];
+	size_t i, n = 0;
+	if (!set || lo > hi) {
+		return true;
+	}
+	for (i = 0; i <= set->nruns; i++) {
+		const XrefRun *run = i < set->nruns? &set->runs[i]: &set->pending;
+		size_t start = run_lower_bound (run, lo, 0);
+		size_t end = run_upper_bound (run, hi);
+		if (start < end) {
+			cur[n].run = run;
+			cur[n].i = start;
+			cur[n].end = end;
+			n++;
+		}
+	}
+	while (n) {
+		XrefCursor *min = &cur[0];
+		for (i = 1; i < n; i++) {
+			const XrefRun *r = cur[i].run, *m = min->run;
+			if (key_cmp (r->k1[cur[i].i], r->k2[cur[i].i], m->k1[min->i], m->k2[min->i]) < 0) {
+				min = &cur[i];
+			}
+		}
+		const XrefRun *run = min->run;
+		size_t k = min->i++;
+		if (min->i == min->end) {
+			*min = cur[--n];
+		}
+		if (run->type[k] == XREF_DEAD) {
+			continue;
+		}
+		RzAnalysisRef ref = { .addr = run->k2[k], .at = run->k1[k], .type = run->type[k] };
+		if (!cb (user, &ref)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static RzAnalysisRef *rz_analysis_ref_new(ut64 addr, ut64 at, ut64 type) {
+	RzAnalysisRef *ref = RZ_NEW (RzAnalysisRef);
+	if (ref) {
+		ref->addr = addr;
+		ref->at = at;
+		ref->type = (type == -1)? RZ_ANALYSIS_REF_TYPE_CODE: type;
+	}
+	return ref;
+}
+
+static void rz_analysis_ref_free(void *ref) {
+	free (ref);
+}
+
+RZ_API RzList *rz_analysis_ref_list_new(void) {
+	return rz_list_newf (rz_analysis_ref_free);
+}
+
 static int ref_cmp(const RzAnalysisRef *a, const RzAnalysisRef *b) {
 	if (a->at < b->at) {
 		return -1;
@@ -83,43 +368,39 @@ static int ref_cmp(const RzAnalysisRef *a, const RzAnalysisRef *b) {
 	return 0;
 }
 
-static void sortxrefs(RzList *list) {
-	rz_list_sort (list, (RzListComparator)ref_cmp);
+static bool append_ref_cb(void *user, const RzAnalysisRef *ref) {
+	RzAnalysisRef *cloned = rz_analysis_ref_new (ref->addr, ref->at, ref->type);
+	if (!cloned) {
+		return false;
+	}
+	rz_list_append ((RzList *)user, cloned);
+	return true;
 }
 
-static void listxrefs(HtUP *m, ut64 addr, RzList *list) {
+static void listxrefs(RzAnalysisXrefSet *set, ut64 addr, RzList *list) {
 	if (addr == UT64_MAX) {
-		ht_up_foreach (m, mylistrefs_cb, list);
+		set_foreach (set, 0, UT64_MAX, append_ref_cb, list);
 	} else {
-		bool found;
-		HtUP *d = ht_up_find (m, addr, &found);
-		if (!found) {
-			return;
-		}
-
-		ht_up_foreach (d, appendRef, list);
+		set_foreach (set, addr, addr, append_ref_cb, list);
 	}
 }
 
-static void setxref(HtUP *m, ut64 from, ut64 to, int type) {
-	bool found;
-	HtUP *ht = ht_up_find (m, from, &found);
-	if (!found) {
-		ht = ht_up_new (NULL, xrefs_ref_free, NULL);
-		if (!ht) {
-			return;
-		}
-		ht_up_insert (m, from, ht);
+static RzList *listxrefs_nonempty(RzAnalysisXrefSet *set, ut64 addr) {
+	RzList *list = rz_analysis_ref_list_new ();
+	if (!list) {
+		return NULL;
 	}
-	RzAnalysisRef *ref = rz_analysis_ref_new (to, from, type);
-	if (ref) {
-		ht_up_update (ht, to, ref);
+	set_foreach (set, addr, addr, append_ref_cb, list);
+	if (rz_list_empty (list)) {
+		rz_list_free (list);
+		list = NULL;
 	}
+	return list;
 }
 
 // set a reference from FROM to TO and a cross-reference(xref) from TO to FROM.
 RZ_API int rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, const RzAnalysisRefType type) {
-	if (!analysis || from == to) {
+	if (!analysis || from == to || !analysis->ref_set || !analysis->xref_set) {
 		return false;
 	}
 	if (analysis->iob.is_valid_offset) {
@@ -130,76 +411,84 @@ RZ_API int rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, const
 			return false;
 		}
 	}
-	setxref (analysis->dict_xrefs, to, from, type);
-	setxref (analysis->dict_refs, from, to, type);
+	const ut8 t = (type == -1)? RZ_ANALYSIS_REF_TYPE_CODE: type;
+	if (!set_insert (analysis->xref_set, to, from, t)) {
+		return false;
+	}
+	if (!set_insert (analysis->ref_set, from, to, t)) {
+		set_delete (analysis->xref_set, to, from);
+		return false;
+	}
 	return true;
 }
 
 RZ_API int rz_analysis_xrefs_deln(RzAnalysis *analysis, ut64 from, ut64 to, const RzAnalysisRefType type) {
-	if (!analysis) {
+	if (!analysis || !analysis->ref_set || !analysis->xref_set) {
 		return false;
 	}
-	ht_up_delete (analysis->dict_refs, from);
-	ht_up_delete (analysis->dict_xrefs, to);
+	set_delete (analysis->ref_set, from, to);
+	set_delete (analysis->xref_set, to, from);
 	return true;
 }
 
 RZ_API int rz_analysis_xref_del(RzAnalysis *analysis, ut64 from, ut64 to) {
-	bool res = false;
-	res |= rz_analysis_xrefs_deln (analysis, from, to, RZ_ANALYSIS_REF_TYPE_NULL);
-	res |= rz_analysis_xrefs_deln (analysis, from, to, RZ_ANALYSIS_REF_TYPE_CODE);
-	res |= rz_analysis_xrefs_deln (analysis, from, to, RZ_ANALYSIS_REF_TYPE_CALL);
-	res |= rz_analysis_xrefs_deln (analysis, from, to, RZ_ANALYSIS_REF_TYPE_DATA);
-	res |= rz_analysis_xrefs_deln (analysis, from, to, RZ_ANALYSIS_REF_TYPE_STRING);
-	return res;
+	return rz_analysis_xrefs_deln (analysis, from, to, RZ_ANALYSIS_REF_TYPE_NULL);
 }
 
 RZ_API int rz_analysis_xrefs_from(RzAnalysis *analysis, RzList *list, const char *kind, const RzAnalysisRefType type, ut64 addr) {
-	listxrefs (analysis->dict_refs, addr, list);
-	sortxrefs (list);
+	listxrefs (analysis->ref_set, addr, list);
+	rz_list_sort (list, (RzListComparator)ref_cmp);
 	return true;
 }
 
 RZ_API RzList *rz_analysis_xrefs_get(RzAnalysis *analysis, ut64 to) {
-	RzList *list = rz_analysis_ref_list_new ();
-	if (!list) {
-		return NULL;
-	}
-	listxrefs (analysis->dict_xrefs, to, list);
-	sortxrefs (list);
-	if (rz_list_empty (list)) {
-		rz_list_free (list);
-		list = NULL;
-	}
-	return list;
+	return listxrefs_nonempty (analysis->xref_set, to);
 }
 
 RZ_API RzList *rz_analysis_refs_get(RzAnalysis *analysis, ut64 from) {
-	RzList *list = rz_analysis_ref_list_new ();
-	if (!list) {
-		return NULL;
-	}
-	listxrefs (analysis->dict_refs, from, list);
-	sortxrefs (list);
-	if (rz_list_empty (list)) {
-		rz_list_free (list);
-		list = NULL;
-	}
-	return list;
+	return listxrefs_nonempty (analysis->ref_set, from);
 }
 
 RZ_API RzList *rz_analysis_xrefs_get_from(RzAnalysis *analysis, ut64 to) {
-	RzList *list = rz_analysis_ref_list_new ();
-	if (!list) {
-		return NULL;
-	}
-	listxrefs (analysis->dict_refs, to, list);
-	sortxrefs (list);
-	if (rz_list_empty (list)) {
-		rz_list_free (list);
-		list = NULL;
-	}
-	return list;
+	return listxrefs_nonempty (analysis->ref_set, to);
+}
+
+/**
+ * \brief Call \p cb on every reference from \p from, sorted by target
+ *
+ * ref->at is \p from and ref->addr the target. Nothing is allocated, but the
+ * references must not be changed from the callback. Returns false if \p cb
+ * stopped the iteration by returning false.
+ */
+RZ_API bool rz_analysis_refs_foreach(RzAnalysis *analysis, ut64 from, RzAnalysisRefForeachCb cb, void *user) {
+	rz_return_val_if_fail (analysis && cb, false);
+	return set_foreach (analysis->ref_set, from, from, cb, user);
+}
+
+/**
+ * \brief Call \p cb on every cross-reference to \p to, sorted by source
+ *
+ * ref->at is \p to and ref->addr the source, like in rz_analysis_xrefs_get().
+ */
+RZ_API bool rz_analysis_xrefs_foreach(RzAnalysis *analysis, ut64 to, RzAnalysisRefForeachCb cb, void *user) {
+	rz_return_val_if_fail (analysis && cb, false);
+	return set_foreach (analysis->xref_set, to, to, cb, user);
+}
+
+/**
+ * \brief Call \p cb on every reference whose source is in [from, to), sorted by source and target
+ */
+RZ_API bool rz_analysis_refs_foreach_in(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisRefForeachCb cb, void *user) {
+	rz_return_val_if_fail (analysis && cb, false);
+	return from >= to || set_foreach (analysis->ref_set, from, to - 1, cb, user);
+}
+
+/**
+ * \brief Call \p cb on every cross-reference whose target is in [from, to), sorted by target and source
+ */
+RZ_API bool rz_analysis_xrefs_foreach_in(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisRefForeachCb cb, void *user) {
+	rz_return_val_if_fail (analysis && cb, false);
+	return from >= to || set_foreach (analysis->xref_set, from, to - 1, cb, user);
 }
 
 RZ_API void rz_analysis_xrefs_list(RzAnalysis *analysis, int rad) {
@@ -207,8 +496,7 @@ RZ_API void rz_analysis_xrefs_list(RzAnalysis *analysis, int rad) {
 	RzAnalysisRef *ref;
 	PJ *pj = NULL;
 	RzList *list = rz_analysis_ref_list_new();
-	listxrefs (analysis->dict_refs, UT64_MAX, list);
-	sortxrefs (list);
+	listxrefs (analysis->ref_set, UT64_MAX, list);
 	if (rad == 'j') {
 		pj = analysis->coreb.pjWithEncoding (analysis->coreb.core);
 		if (!pj) {
@@ -309,39 +597,73 @@ RZ_API RzAnalysisRefType rz_analysis_xrefs_type(char ch) {
 }
 
 RZ_API bool rz_analysis_xrefs_init(RzAnalysis *analysis) {
-	ht_up_free (analysis->dict_refs);
-	analysis->dict_refs = NULL;
-	ht_up_free (analysis->dict_xrefs);
-	analysis->dict_xrefs = NULL;
-
-	HtUP *tmp = ht_up_new (NULL, xrefs_ht_free, NULL);
-	if (!tmp) {
-		return false;
-	}
-	analysis->dict_refs = tmp;
-
-	tmp = ht_up_new (NULL, xrefs_ht_free, NULL);
-	if (!tmp) {
-		ht_up_free (analysis->dict_refs);
-		analysis->dict_refs = NULL;
+	rz_analysis_xrefs_fini (analysis);
+	analysis->ref_set = set_new ();
+	analysis->xref_set = set_new ();
+	if (!analysis->ref_set || !analysis->xref_set) {
+		rz_analysis_xrefs_fini (analysis);
 		return false;
 	}
-	analysis->dict_xrefs = tmp;
 	return true;
 }
 
-static bool count_cb(void *user, const ut64 k, const void *v) {
-	(*(ut64 *)user) += ((HtUP *)v)->count;
-	return true;
+RZ_API void rz_analysis_xrefs_fini(RzAnalysis *analysis) {
+	set_free (analysis->ref_set);
+	analysis->ref_set = NULL;
+	set_free (analysis->xref_set);
+	analysis->xref_set = NULL;
 }
 
 RZ_API ut64 rz_analysis_xrefs_count(RzAnalysis *analysis) {
-	ut64 ret = 0;
-	ht_up_foreach (analysis->dict_xrefs, count_cb, &ret);
-	return ret;
+	return analysis->xref_set? analysis->xref_set->count: 0;
+}
+
+typedef struct {
+	RzAnalysis *analysis;
+	ut64 diff;
+} XrefsRebase;
+
+static bool rebase_cb(void *user, const RzAnalysisRef *ref) {
+	XrefsRebase *rb = user;
+	rz_analysis_xrefs_set (rb->analysis, ref->at + rb->diff, ref->addr + rb->diff, ref->type);
+	return true;
 }
 
-static RzList *fcn_get_refs(RzAnalysisFunction *fcn, HtUP *ht) {
+/**
+ * \brief Move every reference by \p diff bytes
+ */
+RZ_API void rz_analysis_xrefs_rebase(RzAnalysis *analysis, ut64 diff) {
+	rz_return_if_fail (analysis);
+	RzAnalysisXrefSet *old_refs = analysis->ref_set;
+	RzAnalysisXrefSet *old_xrefs = analysis->xref_set;
+	analysis->ref_set = NULL;
+	analysis->xref_set = NULL;
+	if (!rz_analysis_xrefs_init (analysis)) {
+		analysis->ref_set = old_refs;
+		analysis->xref_set = old_xrefs;
+		return;
+	}
+	XrefsRebase rb = { analysis, diff };
+	set_foreach (old_refs, 0, UT64_MAX, rebase_cb, &rb);
+	set_free (old_refs);
+	set_free (old_xrefs);
+}
+
+typedef struct {
+	RzAnalysisBlock *bb;
+	RzList *list;
+} BlockRefs;
+
+static bool block_ref_cb(void *user, const RzAnalysisRef *ref) {
+	BlockRefs *br = user;
+	if (rz_analysis_block_op_starts_at (br->bb, ref->at)) {
+		return append_ref_cb (br->list, ref);
+	}
+	return true;
+}
+
+
+static RzList *fcn_get_refs(RzAnalysisFunction *fcn, RzAnalysisXrefSet *set) {
 	RzListIter *iter;
 	RzAnalysisBlock *bb;
 	RzList *list = rz_analysis_ref_list_new ();
@@ -349,25 +671,23 @@ static RzList *fcn_get_refs(RzAnalysisFunction *fcn, HtUP *ht) {
 		return NULL;
 	}
 	rz_list_foreach (fcn->bbs, iter, bb) {
-		int i;
-
-		for (i = 0; i < bb->ninstr; i++) {
-			ut64 at = bb->addr + rz_analysis_bb_offset_inst (bb, i);
-			listxrefs (ht, at, list);
+		BlockRefs br = { bb, list };
+		if (bb->size) {
+			set_foreach (set, bb->addr, bb->addr + bb->size - 1, block_ref_cb, &br);
 		}
 	}
-	sortxrefs (list);
+	rz_list_sort (list, (RzListComparator)ref_cmp);
 	return list;
 }
 
 RZ_API RzList *rz_analysis_function_get_refs(RzAnalysisFunction *fcn) {
 	rz_return_val_if_fail (fcn, NULL);
-	return fcn_get_refs (fcn, fcn->analysis->dict_refs);
+	return fcn_get_refs (fcn, fcn->analysis->ref_set);
 }
 
 RZ_API RzList *rz_analysis_function_get_xrefs(RzAnalysisFunction *fcn) {
 	rz_return_val_if_fail (fcn, NULL);
-	return fcn_get_refs (fcn, fcn->analysis->dict_xrefs);
+	return fcn_get_refs (fcn, fcn->analysis->xref_set);
 }
 
 RZ_API const char *rz_analysis_ref_type_tostring(RzAnalysisRefType t) {
@@ -7,6 +7,12 @@
 // maybe too big sometimes? 2KB of stack eaten here..
 #define RZ_STRING_SCAN_BUFFER_SIZE 2048
 #define RZ_STRING_MAX_UNI_BLOCKS 4
+// ranges are read in windows of this size
+#define RZ_STRING_SCAN_WINDOW (1024 * 1024)
+// bytes a single string may span: up to 4 per rune, plus the type detection
+#define RZ_STRING_SCAN_LOOKAHEAD (RZ_STRING_SCAN_BUFFER_SIZE * 4 + 16)
+// bytes that may start a string, anything else is skipped in bulk
+#define RZ_STRING_SCAN_CLASSES (RZ_STR_SCAN_PRINTABLE | RZ_STR_SCAN_ESCAPES | RZ_STR_SCAN_UTF8_LEAD)
 
 static RzBinClass *__getClass(RzBinFile *bf, const char *name) {
 	rz_return_val_if_fail (bf && bf->o && bf->o->classes_ht && name, NULL);
@@ -112,8 +118,13 @@ static void print_string(RzBinFile *bf, RzBinString *string, int raw, PJ *pj) {
 	}
 }
 
+/* Bytes outside RZ_STRING_SCAN_CLASSES can neither start a string nor make
+ * a string starting on them printable unless it is forced to be wide, and
+ * the scan never steps over the next byte that is in the classes, so runs
+ * of them are skipped at once without changing the results. Forced wide
+ * scans skip the units rz_str_scan_wide_next() walks over instead. */
 static int string_scan_range(RzList *list, RzBinFile *bf, int min,
-			      const ut64 from, const ut64 to, int type, int raw, RzBinSection *section) {
+			      const ut64 from, const ut64 to, int type, int raw, RzBinSection *section, RzThreadLock *lock) {
 	RzBin *bin = bf->rbin;
 	ut8 tmp[RZ_STRING_SCAN_BUFFER_SIZE];
 	ut64 str_start, needle = from;
@@ -133,12 +144,16 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 		eprintf ("Invalid range to find strings 0x%"PFMT64x" .. 0x%"PFMT64x"\n", from, to);
 		return -1;
 	}
-	int len = to - from;
-	ut8 *buf = calloc (len, 1);
-	if (!buf || !min) {
-		free (buf);
+	if (!min) {
+		return -1;
+	}
+	// [bfrom, bto) of the range is in buf
+	ut64 bfrom = to, bto = to;
+	ut8 *buf = malloc (RZ_MIN (to - from, RZ_STRING_SCAN_WINDOW));
+	if (!buf) {
 		return -1;
 	}
+	size_t width = type == RZ_STRING_TYPE_WIDE32? 4: type == RZ_STRING_TYPE_WIDE? 2: 0;
 	st64 vdelta = 0, pdelta = 0;
 	RzBinSection *s = NULL;
 	bool ascii_only = false;
@@ -149,21 +164,38 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 			pj_a (pj);
 		}
 	}
-	rz_buf_read_at (bf->buf, from, buf, len);
-	// may oobread
 	while (needle < to) {
 		if (bin && bin->consb.is_breaked) {
 			if (bin->consb.is_breaked ()) {
 				break;
 			}
 		}
-		rc = rz_utf8_decode (buf + needle - from, to - needle, NULL);
+		if (needle < bfrom || (bto < to && needle + RZ_STRING_SCAN_LOOKAHEAD > bto)) {
+			// keep the bytes before the needle where a BOM may be
+			bfrom = RZ_MAX (from, needle - RZ_MIN (needle, 4));
+			bto = RZ_MIN (to, bfrom + RZ_STRING_SCAN_WINDOW);
+			if (lock) {
+				rz_th_lock_enter (lock);
+			}
+			rz_buf_read_at (bf->buf, bfrom, buf, bto - bfrom);
+			if (lock) {
+				rz_th_lock_leave (lock);
+			}
+		}
+		ut64 next = needle + (width
+			? rz_str_scan_wide_next (buf + needle - bfrom, bto - needle, width)
+			: rz_str_scan_next (buf + needle - bfrom, bto - needle, RZ_STRING_SCAN_CLASSES));
+		if (next > needle) {
+			needle = next;
+			continue;
+		}
+		rc = rz_utf8_decode (buf + needle - bfrom, to - needle, NULL);
 		if (!rc) {
 			needle++;
 			continue;
 		}
 		if (type == RZ_STRING_TYPE_DETECT) {
-			char *w = (char *)buf + needle + rc - from;
+			char *w = (char *)buf + needle + rc - bfrom;
 			if ((to - needle) > 5 + rc) {
 				bool is_wide32 = (needle + rc + 2 < to) && (!w[0] && !w[1] && !w[2] && w[3] && !w[4]);
 				if (is_wide32) {
@@ -188,17 +220,17 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 			RzRune r = {0};
 
 			if (str_type == RZ_STRING_TYPE_WIDE32) {
-				rc = rz_utf32le_decode (buf + needle - from, to - needle, &r);
+				rc = rz_utf32le_decode (buf + needle - bfrom, to - needle, &r);
 				if (rc) {
 					rc = 4;
 				}
 			} else if (str_type == RZ_STRING_TYPE_WIDE) {
-				rc = rz_utf16le_decode (buf + needle - from, to - needle, &r);
+				rc = rz_utf16le_decode (buf + needle - bfrom, to - needle, &r);
 				if (rc == 1) {
 					rc = 2;
 				}
 			} else {
-				rc = rz_utf8_decode (buf + needle - from, to - needle, &r);
+				rc = rz_utf8_decode (buf + needle - bfrom, to - needle, &r);
 				if (rc > 1) {
 					str_type = RZ_STRING_TYPE_UTF8;
 				}
@@ -307,7 +339,7 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 			switch (str_type) {
 			case RZ_STRING_TYPE_WIDE:
 				if (str_start - from > 1) {
-					const ut8 *p = buf + str_start - 2 - from;
+					const ut8 *p = buf + str_start - 2 - bfrom;
 					if (p[0] == 0xff && p[1] == 0xfe) {
 						str_start -= 2; // \xff\xfe
 					}
@@ -315,7 +347,7 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 				break;
 			case RZ_STRING_TYPE_WIDE32:
 				if (str_start - from > 3) {
-					const ut8 *p = buf + str_start - 4 - from;
+					const ut8 *p = buf + str_start - 4 - bfrom;
 					if (p[0] == 0xff && p[1] == 0xfe) {
 						str_start -= 4; // \xff\xfe\x00\x00
 					}
@@ -338,9 +370,6 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 			bs->string = rz_str_ndup ((const char *)tmp, i);
 			if (list) {
 				rz_list_append (list, bs);
-				if (bf->o) {
-					ht_up_insert (bf->o->strings_db, bs->vaddr, bs);
-				}
 			} else {
 				print_string (bf, bs, raw, pj);
 				rz_bin_string_free (bs);
@@ -372,7 +401,7 @@ static bool __isDataSection(RzBinFile *a, RzBinSection *s) {
 	return strstr (s->name, "_const") != NULL;
 }
 
-static void get_strings_range(RzBinFile *bf, RzList *list, int min, int raw, ut64 from, ut64 to, RzBinSection * section) {
+static void get_strings_range(RzBinFile *bf, RzList *list, int min, int raw, ut64 from, ut64 to, RzBinSection *section, RzThreadLock *lock) {
 	rz_return_if_fail (bf && bf->buf);
 
 	RzBinPlugin *plugin = rz_bin_file_cur_plugin (bf);
@@ -425,7 +454,7 @@ static void get_strings_range(RzBinFile *bf, RzList *list, int min, int raw, ut6
 		eprintf ("ERROR: encoding %s not supported\n", enc);
 		return;
 	}
-	string_scan_range (list, bf, min, from, to, type, raw, section);
+	string_scan_range (list, bf, min, from, to, type, raw, section, lock);
 }
 
 RZ_IPI RzBinFile *rz_bin_file_new(RzBin *bin, const char *file, ut64 file_sz, int rawstr, int fd, const char *xtrname, Sdb *sdb, bool steal_ptr) {
@@ -577,6 +606,7 @@ RZ_API ut64 rz_bin_file_delete_all(RzBin *bin) {
 		ut64 counter = rz_list_length (bin->binfiles);
 		rz_list_purge (bin->binfiles);
 		bin->cur = NULL;
+		rz_bin_demangle_cache_clear (bin);
 		return counter;
 	}
 	return 0;
@@ -595,6 +625,9 @@ RZ_API bool rz_bin_file_delete(RzBin *bin, ut32 bin_id) {
 				bin->cur = NULL;
 			}
 			rz_list_delete (bin->binfiles, iter);
+			if (rz_list_empty (bin->binfiles)) {
+				rz_bin_demangle_cache_clear (bin);
+			}
 			return true;
 		}
 	}
@@ -725,6 +758,7 @@ RZ_API void rz_bin_file_free(void /*RzBinFile*/ *_bf) {
 		sdb_free (bf->sdb_addrinfo);
 		bf->sdb_addrinfo = NULL;
 	}
+	rz_bin_dwarf_line_table_free (bf->dwarf_lines);
 	free (bf->file);
 	rz_bin_object_free (bf->o);
 	rz_list_free (bf->xtr_data);
@@ -791,6 +825,75 @@ RZ_API RzBinPlugin *rz_bin_file_cur_plugin(RzBinFile *bf) {
 }
 
 // TODO: searchStrings() instead
+typedef struct {
+	RzBinFile *bf;
+	RzBinSection *section;
+	RzList *list;
+	RzThreadLock *lock;
+	int min;
+	int raw;
+} StringsJob;
+
+static void strings_job(void *user) {
+	StringsJob *job = user;
+	get_strings_range (job->bf, job->list, job->min, job->raw, job->section->paddr,
+		job->section->paddr + job->section->size, job->section, job->lock);
+}
+
+/* scan the data sections on a thread pool, the results are joined in section order */
+static void get_strings_sections_parallel(RzBinFile *bf, RzList *ret, int min, int raw, int threads) {
+	RzPVector jobs;
+	RzListIter *iter;
+	RzBinSection *section;
+	rz_pvector_init (&jobs, free);
+	rz_list_foreach (bf->o->sections, iter, section) {
+		if (!__isDataSection (bf, section)) {
+			continue;
+		}
+		StringsJob *job = RZ_NEW0 (StringsJob);
+		if (!job) {
+			break;
+		}
+		job->bf = bf;
+		job->section = section;
+		job->min = min;
+		job->raw = raw;
+		job->list = rz_list_newf (rz_bin_string_free);
+		rz_pvector_push (&jobs, job);
+	}
+	RzThreadLock *lock = rz_th_lock_new (false);
+	RzThreadPool *pool = lock? rz_th_pool_new (threads): NULL;
+	void **it;
+	rz_pvector_foreach (&jobs, it) {
+		StringsJob *job = *it;
+		job->lock = lock;
+		if (!pool || !rz_th_pool_add_job (pool, strings_job, job)) {
+			strings_job (job);
+		}
+	}
+	rz_th_pool_free (pool);
+	rz_th_lock_free (lock);
+	rz_pvector_foreach (&jobs, it) {
+		StringsJob *job = *it;
+		if (job->list) {
+			rz_list_join (ret, job->list);
+			rz_list_free (job->list);
+		}
+	}
+	rz_pvector_fini (&jobs);
+}
+
+static void index_strings(RzBinFile *bf, RzList *strings) {
+	RzListIter *iter;
+	RzBinString *bs;
+	if (!strings || !bf->o) {
+		return;
+	}
+	rz_list_foreach (strings, iter, bs) {
+		ht_up_insert (bf->o->strings_db, bs->vaddr, bs);
+	}
+}
+
 RZ_IPI RzList *rz_bin_file_get_strings(RzBinFile *bf, int min, int dump, int raw) {
 	rz_return_val_if_fail (bf, NULL);
 	RzListIter *iter;
@@ -799,12 +902,21 @@ RZ_IPI RzList *rz_bin_file_get_strings(RzBinFile *bf, int min, int dump, int raw
 
 	if (!raw && bf && bf->o && bf->o->sections && !rz_list_empty (bf->o->sections)) {
 		RzBinObject *o = bf->o;
-		rz_list_foreach (o->sections, iter, section) {
-			if (__isDataSection (bf, section)) {
-				get_strings_range (bf, ret, min, raw, section->paddr,
-						section->paddr + section->size, section);
+		int threads = bf->rbin->str_threads;
+		if (threads <= 0) {
+			threads = rz_th_ncores ();
+		}
+		if (ret && threads > 1) {
+			get_strings_sections_parallel (bf, ret, min, raw, threads);
+		} else {
+			rz_list_foreach (o->sections, iter, section) {
+				if (__isDataSection (bf, section)) {
+					get_strings_range (bf, ret, min, raw, section->paddr,
+							section->paddr + section->size, section, NULL);
+				}
 			}
 		}
+		index_strings (bf, ret);
 		rz_list_foreach (o->sections, iter, section) {
 			/* load objc/swift strings */
 			const int bits = (bf->o && bf->o->info) ? bf->o->info->bits : 32;
@@ -850,7 +962,8 @@ RZ_IPI RzList *rz_bin_file_get_strings(RzBinFile *bf, int min, int dump, int raw
 			}
 		}
 	} else {
-		get_strings_range (bf, ret, min, raw, 0, bf->size, NULL);
+		get_strings_range (bf, ret, min, raw, 0, bf->size, NULL, NULL);
+		index_strings (bf, ret);
 	}
 	return ret;
 }
@@ -893,36 +1006,33 @@ RZ_API RzList *rz_bin_file_compute_hashes(RzBin *bin, ut64 limit) {
 		}
 		return NULL;
 	}
-	const size_t blocksize = 64000;
-	ut8 *buf = malloc (blocksize);
-	if (!buf) {
+	const size_t blocksize = RZ_MIN (0x100000, RZ_MAX (buf_len, 1));
+	ut8 *bufs[2] = { malloc (blocksize), malloc (blocksize) };
+	RzHashStream *hs = rz_hash_stream_new (RZ_HASH_MD5 | RZ_HASH_SHA1 | RZ_HASH_SHA256, 0);
+	if (!bufs[0] || !bufs[1] || !hs) {
 		eprintf ("Cannot allocate computation buffer\n");
+		free (bufs[0]);
+		free (bufs[1]);
+		rz_hash_stream_free (hs);
 		return NULL;
 	}
 
+	// each block is read once and hashed by all the digests, while the next one is read
 	char hash[128];
-	RzHash *ctx = rz_hash_new (false, RZ_HASH_MD5 | RZ_HASH_SHA1 | RZ_HASH_SHA256);
-	while (r + blocksize < buf_len) {
-		rz_io_desc_seek (iod, r, RZ_IO_SEEK_SET);
-		int b = rz_io_desc_read (iod, buf, blocksize);
-		(void)rz_hash_do_md5 (ctx, buf, blocksize);
-		(void)rz_hash_do_sha1 (ctx, buf, blocksize);
-		(void)rz_hash_do_sha256 (ctx, buf, blocksize);
-		r += b;
-	}
-	if (r < buf_len) {
+	int k = 0;
+	while (r < buf_len) {
 		rz_io_desc_seek (iod, r, RZ_IO_SEEK_SET);
-		const size_t rem_len = buf_len-r;
-		int b = rz_io_desc_read (iod, buf, rem_len);
+		int b = rz_io_desc_read (iod, bufs[k], RZ_MIN (blocksize, buf_len - r));
 		if (b < 1) {
 			eprintf ("rz_io_desc_read: error\n");
-		} else {
-			(void)rz_hash_do_md5 (ctx, buf, b);
-			(void)rz_hash_do_sha1 (ctx, buf, b);
-			(void)rz_hash_do_sha256 (ctx, buf, b);
+			break;
 		}
+		rz_hash_stream_update (hs, bufs[k], b);
+		k ^= 1;
+		r += b;
 	}
-	rz_hash_do_end (ctx, RZ_HASH_MD5);
+	rz_hash_stream_final (hs);
+	RzHash *ctx = rz_hash_stream_ctx (hs, RZ_HASH_MD5);
 	rz_hex_bin2str (ctx->digest, RZ_HASH_SIZE_MD5, hash);
 
 	RzList *file_hashes = rz_list_newf ((RzListFree) rz_bin_file_hash_free);
@@ -932,7 +1042,7 @@ RZ_API RzList *rz_bin_file_compute_hashes(RzBin *bin, ut64 limit) {
 		md5h->hex = strdup (hash);
 		rz_list_push (file_hashes, md5h);
 	}
-	rz_hash_do_end (ctx, RZ_HASH_SHA1);
+	ctx = rz_hash_stream_ctx (hs, RZ_HASH_SHA1);
 	rz_hex_bin2str (ctx->digest, RZ_HASH_SIZE_SHA1, hash);
 
 	RzBinFileHash *sha1h = RZ_NEW0 (RzBinFileHash);
@@ -941,7 +1051,7 @@ RZ_API RzList *rz_bin_file_compute_hashes(RzBin *bin, ut64 limit) {
 		sha1h->hex = strdup (hash);
 		rz_list_push (file_hashes, sha1h);
 	}
-	rz_hash_do_end (ctx, RZ_HASH_SHA256);
+	ctx = rz_hash_stream_ctx (hs, RZ_HASH_SHA256);
 	rz_hex_bin2str (ctx->digest, RZ_HASH_SIZE_SHA256, hash);
 
 	RzBinFileHash *sha256h = RZ_NEW0 (RzBinFileHash);
@@ -958,8 +1068,9 @@ RZ_API RzList *rz_bin_file_compute_hashes(RzBin *bin, ut64 limit) {
 	}
 	// TODO: add here more rows
 
-	free (buf);
-	rz_hash_free (ctx);
+	free (bufs[0]);
+	free (bufs[1]);
+	rz_hash_stream_free (hs);
 	return file_hashes;
 }
 
@@ -1066,6 +1177,7 @@ RZ_API RzList *rz_bin_file_get_trycatch(RzBinFile *bf) {
 
 RZ_API RzList *rz_bin_file_get_symbols(RzBinFile *bf) {
 	rz_return_val_if_fail (bf, NULL);
+	rz_bin_object_load_items (bf, RZ_BIN_REQ_SYMBOLS);
 	RzBinObject *o = bf->o;
 	return o? o->symbols: NULL;
 }
@@ -476,6 +476,8 @@ RZ_API void rz_bin_free(RzBin *bin) {
 		sdb_free (bin->sdb);
 		rz_id_storage_free (bin->ids);
 		rz_str_constpool_fini (&bin->constpool);
+		ht_pp_free (bin->demangled);
+		rz_th_lock_free (bin->demangled_lock);
 		free (bin);
 	}
 }
@@ -675,7 +677,7 @@ RZ_API RzList *rz_bin_get_fields(RzBin *bin) {
 
 RZ_API RzList *rz_bin_get_imports(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
+	RzBinObject *o = rz_bin_cur_object_items (bin, RZ_BIN_REQ_IMPORTS);
 	return o ? o->imports : NULL;
 }
 
@@ -717,7 +719,7 @@ RZ_API RzList *rz_bin_patch_relocs_list(RzBin *bin) {
 
 RZ_API RBNode *rz_bin_get_relocs(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
+	RzBinObject *o = rz_bin_cur_object_items (bin, RZ_BIN_REQ_RELOCS);
 	return o ? o->relocs : NULL;
 }
 
@@ -764,6 +766,7 @@ RZ_API RzList *rz_bin_reset_strings(RzBin *bin) {
 		rz_list_free (bf->o->strings);
 		bf->o->strings = NULL;
 	}
+	bf->o->lazy_items &= ~RZ_BIN_REQ_STRINGS;
 
 	bf->rawstr = bin->rawstr;
 	RzBinPlugin *plugin = rz_bin_file_cur_plugin (bf);
@@ -781,7 +784,7 @@ RZ_API RzList *rz_bin_reset_strings(RzBin *bin) {
 
 RZ_API RzList *rz_bin_get_strings(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
+	RzBinObject *o = rz_bin_cur_object_items (bin, RZ_BIN_REQ_STRINGS);
 	return o ? o->strings : NULL;
 }
 
@@ -805,7 +808,7 @@ RZ_API int rz_bin_is_string(RzBin *bin, ut64 va) {
 
 RZ_API RzList *rz_bin_get_symbols(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
+	RzBinObject *o = rz_bin_cur_object_items (bin, RZ_BIN_REQ_SYMBOLS);
 	return o? o->symbols: NULL;
 }
 
@@ -847,11 +850,15 @@ RZ_API RzBin *rz_bin_new(void) {
 	bin->cb_printf = (PrintfCallback)printf;
 	bin->plugins = rz_list_newf ((RzListFree)rz_bin_plugin_free);
 	bin->minstrlen = 0;
+	bin->str_threads = 1;
+	bin->dwarf_threads = 1;
 	bin->strpurge = NULL;
 	bin->strenc = NULL;
 	bin->want_dbginfo = true;
 	bin->cur = NULL;
 	bin->ids = rz_id_storage_new (0, ST32_MAX);
+	bin->demangled = rz_bin_demangle_cache_new ();
+	bin->demangled_lock = rz_th_lock_new (false);
 
 	/* bin parsers */
 	bin->binfiles = rz_list_newf ((RzListFree)rz_bin_file_free);
@@ -887,6 +894,8 @@ trashbin_binxtrs:
 	rz_list_free (bin->binxtrs);
 	rz_list_free (bin->binfiles);
 	rz_id_storage_free (bin->ids);
+	ht_pp_free (bin->demangled);
+	rz_th_lock_free (bin->demangled_lock);
 	rz_str_constpool_fini (&bin->constpool);
 trashbin:
 	free(bin);
@@ -1272,7 +1281,7 @@ RZ_API RzBuffer *rz_bin_package(RzBin *bin, const char *type, const char *file,
 
 RZ_API RzList * /*<RzBinClass>*/ rz_bin_get_classes(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
+	RzBinObject *o = rz_bin_cur_object_items (bin, RZ_BIN_REQ_CLASSES);
 	return o ? o->classes : NULL;
 }
 
@@ -1322,6 +1331,19 @@ RZ_API RzBinObject *rz_bin_cur_object(RzBin *bin) {
 	return binfile ? binfile->o : NULL;
 }
 
+/**
+ * \brief Like rz_bin_cur_object, with the RZ_BIN_REQ_* items in \p req loaded if bin.lazy left them out
+ */
+RZ_API RzBinObject *rz_bin_cur_object_items(RzBin *bin, ut64 req) {
+	rz_return_val_if_fail (bin, NULL);
+	RzBinFile *bf = rz_bin_cur (bin);
+	if (!bf || !bf->o) {
+		return NULL;
+	}
+	rz_bin_object_load_items (bf, req);
+	return bf->o;
+}
+
 RZ_API void rz_bin_force_plugin(RzBin *bin, const char *name) {
 	rz_return_if_fail (bin);
 	free (bin->force);
@@ -267,6 +267,162 @@ static void rz_bin_object_rebuild_classes_ht(RzBinObject *o) {
 	}
 }
 
+static void load_imports(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	if (p->imports) {
+		rz_list_free (o->imports);
+		o->imports = p->imports (bf);
+		if (o->imports) {
+			o->imports->free = rz_bin_import_free;
+		}
+	}
+}
+
+static void load_symbols(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	if (p->symbols) {
+		o->symbols = p->symbols (bf); // 5s
+		if (o->symbols) {
+			o->symbols->free = rz_bin_symbol_free;
+			REBASE_PADDR (o, o->symbols, RzBinSymbol);
+			if (bf->rbin->filter) {
+				rz_bin_filter_symbols (bf, o->symbols); // 5s
+			}
+		}
+	}
+}
+
+static void load_relocs(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	if (p->relocs) {
+		RzList *l = p->relocs (bf);
+		if (l) {
+			REBASE_PADDR (o, l, RzBinReloc);
+			o->relocs = list2rbtree (l);
+			l->free = NULL;
+			rz_list_free (l);
+		}
+	}
+}
+
+static void load_strings(RzBinFile *bf, RzBinObject *o) {
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	int minlen = (bin->minstrlen > 0) ? bin->minstrlen : p->minstrlen;
+	o->strings = p->strings
+		? p->strings (bf)
+		: rz_bin_file_get_strings (bf, minlen, 0, bf->rawstr);
+	if (bin->debase64) {
+		rz_bin_object_filter_strings (o);
+	}
+	REBASE_PADDR (o, o->strings, RzBinString);
+}
+
+/* returns true if the classes are from a swift binary */
+static bool load_classes(RzBinFile *bf, RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	bool isSwift = false;
+	if (p->classes) {
+		RzList *classes = p->classes (bf);
+		if (classes) {
+			// XXX we should probably merge them instead
+			rz_list_free (o->classes);
+			o->classes = classes;
+			rz_bin_object_rebuild_classes_ht (o);
+		}
+		isSwift = rz_bin_lang_swift (bf);
+		if (isSwift) {
+			o->classes = classes_from_symbols (bf);
+		}
+	} else {
+		RzList *classes = classes_from_symbols (bf);
+		if (classes) {
+			o->classes = classes;
+		}
+	}
+	if (bf->rbin->filter) {
+		filter_classes (bf, o->classes);
+	}
+	// cache addr=class+method
+	if (o->classes) {
+		RzList *klasses = o->classes;
+		RzListIter *iter, *iter2;
+		RzBinClass *klass;
+		RzBinSymbol *method;
+		if (!o->addrzklassmethod) {
+			// this is slow. must be optimized, but at least its cached
+			o->addrzklassmethod = sdb_new0 ();
+			rz_list_foreach (klasses, iter, klass) {
+				rz_list_foreach (klass->methods, iter2, method) {
+					char *km = sdb_fmt ("method.%s.%s", klass->name, method->name);
+					char *at = sdb_fmt ("0x%08"PFMT64x, method->vaddr);
+					sdb_set (o->addrzklassmethod, at, km, 0);
+				}
+			}
+		}
+	}
+	return isSwift;
+}
+
+/* the items rz_bin_object_set_items() leaves to rz_bin_object_load_items()
+ * when bin.lazy is set, with the ones each of them needs to be loaded first,
+ * in the order the eager load goes */
+static const struct {
+	ut64 req;
+	ut64 deps;
+} lazy_items[] = {
+	{ RZ_BIN_REQ_IMPORTS, 0 },
+	{ RZ_BIN_REQ_SYMBOLS, RZ_BIN_REQ_IMPORTS },
+	{ RZ_BIN_REQ_RELOCS, RZ_BIN_REQ_IMPORTS | RZ_BIN_REQ_SYMBOLS },
+	{ RZ_BIN_REQ_STRINGS, 0 },
+	{ RZ_BIN_REQ_CLASSES, RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_STRINGS },
+};
+
+#define LAZY_ITEMS (RZ_BIN_REQ_IMPORTS | RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_STRINGS | RZ_BIN_REQ_CLASSES)
+
+/**
+ * \brief Load the items of \p req that were left out when the object was set
+ * up with bin.lazy, together with the ones they depend on.
+ *
+ * \param req mask of RZ_BIN_REQ_IMPORTS, _SYMBOLS, _RELOCS, _STRINGS and _CLASSES
+ */
+RZ_API void rz_bin_object_load_items(RzBinFile *bf, ut64 req) {
+	rz_return_if_fail (bf);
+	RzBinObject *o = bf->o;
+	if (!o || !(o->lazy_items & req)) {
+		return;
+	}
+	int i;
+	for (i = RZ_ARRAY_SIZE (lazy_items) - 1; i >= 0; i--) {
+		if (req & lazy_items[i].req) {
+			req |= lazy_items[i].deps;
+		}
+	}
+	req &= o->lazy_items;
+	// clear them first, the plugins may ask for the items they are loading
+	o->lazy_items &= ~req;
+	bool isSwift = false;
+	if (req & RZ_BIN_REQ_IMPORTS) {
+		load_imports (bf, o);
+	}
+	if (req & RZ_BIN_REQ_SYMBOLS) {
+		load_symbols (bf, o);
+	}
+	if (req & RZ_BIN_REQ_RELOCS) {
+		load_relocs (bf, o);
+	}
+	if (req & RZ_BIN_REQ_STRINGS) {
+		load_strings (bf, o);
+	}
+	if (req & RZ_BIN_REQ_CLASSES) {
+		isSwift = load_classes (bf, o);
+	}
+	if (req & RZ_BIN_REQ_SYMBOLS && o->info && bf->rbin->filter_rules & (RZ_BIN_REQ_INFO | RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_IMPORTS)) {
+		isSwift |= o->plugin->classes && bf->rbin->filter_rules & RZ_BIN_REQ_CLASSES && rz_bin_lang_swift (bf);
+		o->lang = isSwift? RZ_BIN_NM_SWIFT: rz_bin_load_languages (bf);
+	}
+}
+
 RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	rz_return_val_if_fail (bf && o && o->plugin, false);
 
@@ -274,9 +430,15 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	bool isSwift = false;
 	RzBin *bin = bf->rbin;
 	RzBinPlugin *p = o->plugin;
-	int minlen = (bf->rbin->minstrlen > 0) ? bf->rbin->minstrlen : p->minstrlen;
 	bf->o = o;
 
+	// with bin.lazy the expensive items are loaded on first use
+	ut64 items = RZ_BIN_REQ_IMPORTS | RZ_BIN_REQ_SYMBOLS | (bin->filter_rules & LAZY_ITEMS);
+	if (bin->filter_rules & RZ_BIN_REQ_IMPORTS) {
+		items |= RZ_BIN_REQ_RELOCS;
+	}
+	o->lazy_items = bin->lazy? items: 0;
+
 	if (p->file_type) {
 		int type = p->file_type (bf);
 		if (type == RZ_BIN_TYPE_CORE) {
@@ -318,22 +480,9 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 			REBASE_PADDR (o, o->fields, RzBinField);
 		}
 	}
-	if (p->imports) {
-		rz_list_free (o->imports);
-		o->imports = p->imports (bf);
-		if (o->imports) {
-			o->imports->free = rz_bin_import_free;
-		}
-	}
-	if (p->symbols) {
-		o->symbols = p->symbols (bf); // 5s
-		if (o->symbols) {
-			o->symbols->free = rz_bin_symbol_free;
-			REBASE_PADDR (o, o->symbols, RzBinSymbol);
-			if (bin->filter) {
-				rz_bin_filter_symbols (bf, o->symbols); // 5s
-			}
-		}
+	if (!bin->lazy) {
+		load_imports (bf, o);
+		load_symbols (bf, o);
 	}
 	o->info = p->info? p->info (bf): NULL;
 	if (p->libs) {
@@ -349,65 +498,15 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 			rz_bin_filter_sections (bf, o->sections);
 		}
 	}
-	if (bin->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS)) {
-		if (p->relocs) {
-			RzList *l = p->relocs (bf);
-			if (l) {
-				REBASE_PADDR (o, l, RzBinReloc);
-				o->relocs = list2rbtree (l);
-				l->free = NULL;
-				rz_list_free (l);
-			}
-		}
-	}
-	if (bin->filter_rules & RZ_BIN_REQ_STRINGS) {
-		o->strings = p->strings
-			? p->strings (bf)
-			: rz_bin_file_get_strings (bf, minlen, 0, bf->rawstr);
-		if (bin->debase64) {
-			rz_bin_object_filter_strings (o);
+	if (!bin->lazy) {
+		if (items & RZ_BIN_REQ_RELOCS) {
+			load_relocs (bf, o);
 		}
-		REBASE_PADDR (o, o->strings, RzBinString);
-	}
-	if (bin->filter_rules & RZ_BIN_REQ_CLASSES) {
-		if (p->classes) {
-			RzList *classes = p->classes (bf);
-			if (classes) {
-				// XXX we should probably merge them instead
-				rz_list_free (o->classes);
-				o->classes = classes;
-				rz_bin_object_rebuild_classes_ht (o);
-			}
-			isSwift = rz_bin_lang_swift (bf);
-			if (isSwift) {
-				o->classes = classes_from_symbols (bf);
-			}
-		} else {
-			RzList *classes = classes_from_symbols (bf);
-			if (classes) {
-				o->classes = classes;
-			}
+		if (items & RZ_BIN_REQ_STRINGS) {
+			load_strings (bf, o);
 		}
-		if (bin->filter) {
-			filter_classes (bf, o->classes);
-		}
-		// cache addr=class+method
-		if (o->classes) {
-			RzList *klasses = o->classes;
-			RzListIter *iter, *iter2;
-			RzBinClass *klass;
-			RzBinSymbol *method;
-			if (!o->addrzklassmethod) {
-				// this is slow. must be optimized, but at least its cached
-				o->addrzklassmethod = sdb_new0 ();
-				rz_list_foreach (klasses, iter, klass) {
-					rz_list_foreach (klass->methods, iter2, method) {
-						char *km = sdb_fmt ("method.%s.%s", klass->name, method->name);
-						char *at = sdb_fmt ("0x%08"PFMT64x, method->vaddr);
-						sdb_set (o->addrzklassmethod, at, km, 0);
-					}
-				}
-			}
+		if (items & RZ_BIN_REQ_CLASSES) {
+			isSwift = load_classes (bf, o);
 		}
 	}
 	if (p->lines) {
@@ -423,7 +522,8 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	if (p->mem)  {
 		o->mem = p->mem (bf);
 	}
-	if (o->info && bin->filter_rules & (RZ_BIN_REQ_INFO | RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_IMPORTS)) {
+	// with bin.lazy the language is detected once the symbols are loaded
+	if (!bin->lazy && o->info && bin->filter_rules & (RZ_BIN_REQ_INFO | RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_IMPORTS)) {
 		o->lang = isSwift? RZ_BIN_NM_SWIFT: rz_bin_load_languages (bf);
 	}
 	return true;
@@ -445,6 +545,7 @@ RZ_IPI RBNode *rz_bin_object_patch_relocs(RzBin *bin, RzBinObject *o) {
 		rz_rbtree_free (o->relocs, reloc_free, NULL);
 		REBASE_PADDR (o, tmp, RzBinReloc);
 		o->relocs = list2rbtree (tmp);
+		o->lazy_items &= ~RZ_BIN_REQ_RELOCS;
 		first = false;
 		bin->is_reloc_patched = true;
 	}
@@ -31,6 +31,12 @@ RZ_API char *rz_bin_addr2text(RzBin *bin, ut64 addr, int origin) {
 	}
 	char *key = rz_str_newf ("0x%"PFMT64x, addr);
 	char *file_line = sdb_get (bin->cur->sdb_addrinfo, key, 0);
+	if (!file_line && bin->cur->dwarf_lines) {
+		const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (bin->cur->dwarf_lines, addr);
+		if (e && e->address == addr) {
+			file_line = rz_str_newf ("%s|%u", rz_bin_dwarf_line_table_file (bin->cur->dwarf_lines, e->file), e->line);
+		}
+	}
 	if (file_line) {
 		char *token = strchr (file_line, '|');
 		if (token) {
@@ -2,6 +2,7 @@
 
 #include <rz_bin.h>
 #include "i/private.h"
+#include <rz_th.h>
 #include <cxx/demangle.h>
 
 RZ_API void rz_bin_demangle_list(RzBin *bin) {
@@ -62,15 +63,14 @@ RZ_API int rz_bin_demangle_type(const char *str) {
 	return RZ_BIN_NM_NONE;
 }
 
-RZ_API char *rz_bin_demangle(RzBinFile *bf, const char *def, const char *str, ut64 vaddr, bool libs) {
-	int type = -1;
-	if (!str || !*str) {
-		return NULL;
-	}
+/* Strips the flag prefixes and the library name off \p str and guesses its
+ * language. Returns the name to demangle, or NULL if nothing is left. */
+static const char *demangle_prepare(RzBinFile *bf, const char *def, const char *str, int *type, const char **lib) {
 	RzBin *bin = bf? bf->rbin: NULL;
 	RzBinObject *o = bf? bf->o: NULL;
 	RzListIter *iter;
-	const char *lib = NULL;
+	*type = -1;
+	*lib = NULL;
 	if (!strncmp (str, "reloc.", 6)) {
 		str += 6;
 	}
@@ -81,24 +81,21 @@ RZ_API char *rz_bin_demangle(RzBinFile *bf, const char *def, const char *str, ut
 		str += 4;
 	}
 	if (o) {
-		bool found = false;
-		rz_list_foreach (o->libs, iter, lib) {
-			size_t len = strlen (lib);
-			if (!rz_str_ncasecmp (str, lib, len)) {
+		const char *l;
+		rz_list_foreach (o->libs, iter, l) {
+			size_t len = strlen (l);
+			if (!rz_str_ncasecmp (str, l, len)) {
 				str += len;
 				if (*str == '_') {
 					str++;
 				}
-				found = true;
+				*lib = l;
 				break;
 			}
 		}
-		if (!found) {
-			lib = NULL;
-		}
 		size_t len = strlen (bin->file);
 		if (!rz_str_ncasecmp (str, bin->file, len)) {
-			lib = bin->file;
+			*lib = bin->file;
 			str += len;
 			if (*str == '_') {
 				str++;
@@ -107,9 +104,9 @@ RZ_API char *rz_bin_demangle(RzBinFile *bf, const char *def, const char *str, ut
 	}
 	if (!strncmp (str, "__", 2)) {
 		if (str[2] == 'T') {
-			type = RZ_BIN_NM_SWIFT;
+			*type = RZ_BIN_NM_SWIFT;
 		} else {
-			type = RZ_BIN_NM_CXX;
+			*type = RZ_BIN_NM_CXX;
 		//	str++;
 		}
 	}
@@ -117,18 +114,148 @@ RZ_API char *rz_bin_demangle(RzBinFile *bf, const char *def, const char *str, ut
 	if (!*str) {
 		return NULL;
 	}
-	if (type == -1) {
-		type = rz_bin_lang_type (bf, def, str);
+	if (*type == -1) {
+		*type = rz_bin_lang_type (bf, def, str);
 	}
-	char *demangled = NULL;
+	return str;
+}
+
+/* The demangling of \p str alone, without touching \p bin, so that it can
+ * run on any thread and be cached. Rust gets the c++ demangling, see
+ * rz_bin_demangle_rust_fix(). */
+static char *demangle_name(RzBin *bin, int type, const char *str) {
+	switch (type) {
+	case RZ_BIN_NM_JAVA: return rz_bin_demangle_java (str);
+	case RZ_BIN_NM_RUST:
+	case RZ_BIN_NM_CXX: return rz_bin_demangle_cxx (NULL, str, 0);
+	case RZ_BIN_NM_OBJC: return rz_bin_demangle_objc (NULL, str);
+	case RZ_BIN_NM_SWIFT: return rz_bin_demangle_swift (str, bin? bin->demanglercmd: false);
+	case RZ_BIN_NM_MSVC: return rz_bin_demangle_msvc (str);
+	case RZ_BIN_NM_DLANG: return rz_bin_demangle_plugin (bin, "dlang", str);
+	}
+	return NULL;
+}
+
+static bool demangle_cacheable(int type) {
 	switch (type) {
-	case RZ_BIN_NM_JAVA: demangled = rz_bin_demangle_java (str); break;
-	case RZ_BIN_NM_RUST: demangled = rz_bin_demangle_rust (bf, str, vaddr); break;
-	case RZ_BIN_NM_OBJC: demangled = rz_bin_demangle_objc (NULL, str); break;
-	case RZ_BIN_NM_SWIFT: demangled = rz_bin_demangle_swift (str, bin? bin->demanglercmd: false); break;
-	case RZ_BIN_NM_CXX: demangled = rz_bin_demangle_cxx (bf, str, vaddr); break;
-	case RZ_BIN_NM_MSVC: demangled = rz_bin_demangle_msvc (str); break;
-	case RZ_BIN_NM_DLANG: demangled = rz_bin_demangle_plugin (bin, "dlang", str); break;
+	case RZ_BIN_NM_JAVA:
+	case RZ_BIN_NM_RUST:
+	case RZ_BIN_NM_CXX:
+	case RZ_BIN_NM_OBJC:
+	case RZ_BIN_NM_SWIFT:
+	case RZ_BIN_NM_MSVC:
+	case RZ_BIN_NM_DLANG:
+		return true;
+	}
+	return false;
+}
+
+// the msvc and swift demanglers keep their state in globals, plugins are unknown
+static bool demangle_threadsafe(int type) {
+	return type != RZ_BIN_NM_MSVC && type != RZ_BIN_NM_SWIFT && type != RZ_BIN_NM_DLANG;
+}
+
+static char *demangle_cache_key(RzBin *bin, int type, const char *str) {
+	// rust shares the c++ demangling
+	if (type == RZ_BIN_NM_RUST) {
+		type = RZ_BIN_NM_CXX;
+	}
+	bool cmd = type == RZ_BIN_NM_SWIFT && bin->demanglercmd;
+	return rz_str_newf ("%d%s:%s", type, cmd? "+cmd": "", str);
+}
+
+/* bound on the cached names, the cache starts over when it is full */
+#define DEMANGLE_CACHE_MAX 0x40000
+
+static void demangled_kv_free(HtPPKv *kv) {
+	free (kv->key);
+	free (kv->value);
+}
+
+RZ_IPI HtPP *rz_bin_demangle_cache_new(void) {
+	return ht_pp_new (NULL, demangled_kv_free, NULL);
+}
+
+static void demangle_cache_lock(RzBin *bin) {
+	if (bin->demangled_lock) {
+		rz_th_lock_enter (bin->demangled_lock);
+	}
+}
+
+static void demangle_cache_unlock(RzBin *bin) {
+	if (bin->demangled_lock) {
+		rz_th_lock_leave (bin->demangled_lock);
+	}
+}
+
+// called with the lock held, takes ownership of \p out
+static void demangle_cache_put(RzBin *bin, const char *key, char *out) {
+	if (bin->demangled && bin->demangled->count >= DEMANGLE_CACHE_MAX) {
+		ht_pp_free (bin->demangled);
+		bin->demangled = rz_bin_demangle_cache_new ();
+	}
+	if (!bin->demangled || !ht_pp_insert (bin->demangled, key, out)) {
+		free (out);
+	}
+}
+
+/**
+ * \brief Forget the demangled names, done when the last file is closed
+ */
+RZ_IPI void rz_bin_demangle_cache_clear(RzBin *bin) {
+	demangle_cache_lock (bin);
+	if (bin->demangled) {
+		ht_pp_free (bin->demangled);
+		bin->demangled = rz_bin_demangle_cache_new ();
+	}
+	demangle_cache_unlock (bin);
+}
+
+// failures are cached too, as a NULL value
+static char *demangle_cached(RzBin *bin, int type, const char *str) {
+	char *key = demangle_cache_key (bin, type, str);
+	bool found = false;
+	demangle_cache_lock (bin);
+	char *out = bin->demangled? ht_pp_find (bin->demangled, key, &found): NULL;
+	if (found) {
+		out = rz_str_new (out);
+	} else {
+		// computed with the lock held, so the stateful demanglers never run twice at once
+		char *d = demangle_name (bin, type, str);
+		out = rz_str_new (d);
+		demangle_cache_put (bin, key, d);
+	}
+	demangle_cache_unlock (bin);
+	free (key);
+	return out;
+}
+
+RZ_API char *rz_bin_demangle(RzBinFile *bf, const char *def, const char *str, ut64 vaddr, bool libs) {
+	int type;
+	const char *lib;
+	if (!str || !*str) {
+		return NULL;
+	}
+	RzBin *bin = bf? bf->rbin: NULL;
+	str = demangle_prepare (bf, def, str, &type, &lib);
+	if (!str) {
+		return NULL;
+	}
+	char *demangled = NULL;
+	if (bin && bin->demangled && demangle_cacheable (type)) {
+		demangled = demangle_cached (bin, type, str);
+		if (demangled && bf && (type == RZ_BIN_NM_CXX || type == RZ_BIN_NM_RUST)) {
+			rz_bin_demangle_cxx_method (bf, demangled, vaddr);
+		}
+		if (type == RZ_BIN_NM_RUST) {
+			demangled = rz_bin_demangle_rust_fix (demangled);
+		}
+	} else {
+		switch (type) {
+		case RZ_BIN_NM_RUST: demangled = rz_bin_demangle_rust (bf, str, vaddr); break;
+		case RZ_BIN_NM_CXX: demangled = rz_bin_demangle_cxx (bf, str, vaddr); break;
+		default: demangled = demangle_name (bin, type, str); break;
+		}
 	}
 	if (libs && demangled && lib) {
 		char *d = rz_str_newf ("%s_%s", lib, demangled);
@@ -138,6 +265,160 @@ RZ_API char *rz_bin_demangle(RzBinFile *bf, const char *def, const char *str, ut
 	return demangled;
 }
 
+typedef struct {
+	RzBin *bin;
+	RzPVector *names; // DemangleJobName
+	size_t from, to;
+} DemangleJob;
+
+typedef struct {
+	char *key;
+	const char *str;
+	int type;
+	char *out;
+} DemangleJobName;
+
+static void demangle_job(void *user) {
+	DemangleJob *job = user;
+	size_t i;
+	for (i = job->from; i < job->to; i++) {
+		DemangleJobName *n = rz_pvector_at (job->names, i);
+		n->out = demangle_name (job->bin, n->type, n->str);
+	}
+}
+
+static void demangle_job_name_free(void *p) {
+	DemangleJobName *n = p;
+	if (n) {
+		free (n->key);
+		free (n->out);
+		free (n);
+	}
+}
+
+// called with the lock held
+static void demangle_queue(RzBin *bin, HtPP *queued, RzPVector *names, RzPVector *serial, RzBinFile *bf, const char *lang, const char *name) {
+	int type;
+	const char *lib;
+	if (!name || !*name) {
+		return;
+	}
+	const char *str = demangle_prepare (bf, lang, name, &type, &lib);
+	if (!str || !demangle_cacheable (type)) {
+		return;
+	}
+	// the swift-demangle command is run by one thread at a time
+	if (type == RZ_BIN_NM_SWIFT && bin->demanglercmd) {
+		return;
+	}
+	char *key = demangle_cache_key (bin, type, str);
+	bool found = false;
+	ht_pp_find (bin->demangled, key, &found);
+	if (found || ht_pp_find (queued, key, NULL)) {
+		free (key);
+		return;
+	}
+	DemangleJobName *n = RZ_NEW0 (DemangleJobName);
+	if (!n) {
+		free (key);
+		return;
+	}
+	n->key = key;
+	n->str = str;
+	n->type = type;
+	ht_pp_insert (queued, key, n);
+	rz_pvector_push (demangle_threadsafe (type)? names: serial, n);
+}
+
+/**
+ * \brief Demangle the symbol and import names of \p bf on \p threads threads
+ *
+ * The results land in the cache of the demangled names, so that the
+ * rz_bin_demangle() calls that follow, e.g. while setting the flags, are
+ * just lookups. The msvc, swift and plugin demanglers are not reentrant,
+ * their names are demangled by the calling thread.
+ *
+ * \param lang the language to assume, as for rz_bin_demangle()
+ * \param threads the number of threads, 0 for one per core
+ */
+RZ_API void rz_bin_demangle_all(RzBinFile *bf, const char *lang, int threads) {
+	rz_return_if_fail (bf && bf->rbin);
+	RzBin *bin = bf->rbin;
+	rz_bin_object_load_items (bf, RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_IMPORTS);
+	RzBinObject *o = bf->o;
+	if (!o || !bin->demangled) {
+		return;
+	}
+	RzPVector names, serial;
+	rz_pvector_init (&names, demangle_job_name_free);
+	rz_pvector_init (&serial, demangle_job_name_free);
+	HtPP *queued = ht_pp_new0 ();
+	if (!queued) {
+		return;
+	}
+	RzListIter *iter;
+	RzBinSymbol *sym;
+	RzBinImport *imp;
+	demangle_cache_lock (bin);
+	if (bin->demangled) {
+		rz_list_foreach (o->symbols, iter, sym) {
+			demangle_queue (bin, queued, &names, &serial, bf, lang, sym->name);
+		}
+		rz_list_foreach (o->imports, iter, imp) {
+			demangle_queue (bin, queued, &names, &serial, bf, lang, imp->name);
+		}
+	}
+	demangle_cache_unlock (bin);
+	ht_pp_free (queued);
+
+	size_t i, count = rz_pvector_len (&names);
+	if (threads <= 0) {
+		threads = rz_th_ncores ();
+	}
+	// a few jobs per thread, so that a slow chunk does not hold the others
+	size_t njobs = threads > 1? RZ_MIN ((size_t)threads * 4, count): 1;
+	DemangleJob *jobs = count? RZ_NEWS0 (DemangleJob, njobs): NULL;
+	RzThreadPool *pool = jobs && njobs > 1? rz_th_pool_new (threads): NULL;
+	if (!pool) {
+		njobs = jobs? 1: 0;
+	}
+	for (i = 0; i < njobs; i++) {
+		jobs[i].bin = bin;
+		jobs[i].names = &names;
+		jobs[i].from = count * i / njobs;
+		jobs[i].to = count * (i + 1) / njobs;
+		if (pool) {
+			rz_th_pool_add_job (pool, demangle_job, &jobs[i]);
+		} else {
+			demangle_job (&jobs[i]);
+		}
+	}
+	if (pool) {
+		rz_th_pool_wait (pool);
+		rz_th_pool_free (pool);
+	}
+	free (jobs);
+	demangle_cache_lock (bin);
+	for (i = 0; i < rz_pvector_len (&serial); i++) {
+		DemangleJobName *n = rz_pvector_at (&serial, i);
+		n->out = demangle_name (bin, n->type, n->str);
+	}
+	// without jobs, on allocation failure, nothing was demangled
+	for (i = 0; njobs && i < count; i++) {
+		DemangleJobName *n = rz_pvector_at (&names, i);
+		demangle_cache_put (bin, n->key, n->out);
+		n->out = NULL;
+	}
+	for (i = 0; i < rz_pvector_len (&serial); i++) {
+		DemangleJobName *n = rz_pvector_at (&serial, i);
+		demangle_cache_put (bin, n->key, n->out);
+		n->out = NULL;
+	}
+	demangle_cache_unlock (bin);
+	rz_pvector_fini (&names);
+	rz_pvector_fini (&serial);
+}
+
 #ifdef TEST
 main() {
 	char *out, str[128];
@@ -405,13 +405,6 @@ static inline ut64 dwarf_read_address(size_t size, const ut8 **buf, const ut8 *b
 	return result;
 }
 
-static int add_sdb_include_dir(Sdb *s, const char *incl, int idx) {
-	if (!s || !incl) {
-		return false;
-	}
-	return sdb_array_set (s, "includedirs", idx, incl, 0);
-}
-
 static void line_header_fini(RzBinDwarfLineHeader *hdr) {
 	if (hdr) {
 		size_t i;
@@ -426,11 +419,13 @@ static void line_header_fini(RzBinDwarfLineHeader *hdr) {
 }
 
 // Parses source file header of DWARF version <= 4
-static const ut8 *parse_line_header_source(RzBinFile *bf, const ut8 *buf, const ut8 *buf_end,
-	RzBinDwarfLineHeader *hdr, Sdb *sdb, int mode, PrintfCallback print) {
+static const ut8 *parse_line_header_source(const char *comp_dir, const ut8 *buf, const ut8 *buf_end,
+	RzBinDwarfLineHeader *hdr, int mode, PrintfCallback print) {
 	int i = 0;
 	size_t count;
 	const ut8 *tmp_buf = NULL;
+	RzPVector include_dirs;
+	rz_pvector_init (&include_dirs, free);
 
 	if (mode == RZ_MODE_PRINT) {
 		print (" The Directory Table:\n");
@@ -447,8 +442,7 @@ static const ut8 *parse_line_header_source(RzBinFile *bf, const ut8 *buf, const
 		if (mode == RZ_MODE_PRINT) {
 			print ("  %d     %s\n", i + 1, str);
 		}
-		add_sdb_include_dir (sdb, str, i);
-		free (str);
+		rz_pvector_push (&include_dirs, str);
 		i++;
 		buf += len + 1;
 	}
@@ -495,20 +489,17 @@ static const ut8 *parse_line_header_source(RzBinFile *bf, const ut8 *buf, const
 			}
 
 			if (i) {
-				char *include_dir = NULL, *comp_dir = NULL, *pinclude_dir = NULL;
+				const char *include_dir = NULL;
+				char *full_dir = NULL;
 				if (id_idx > 0) {
-					include_dir = pinclude_dir = sdb_array_get (sdb, "includedirs", id_idx - 1, 0);
-					if (include_dir && include_dir[0] != '/') {
-						comp_dir = sdb_get (bf->sdb_addrinfo, "DW_AT_comp_dir", 0);
-						if (comp_dir) {
-							include_dir = rz_str_newf("%s/%s/", comp_dir, include_dir);
-						}
+					if (id_idx <= rz_pvector_len (&include_dirs)) {
+						include_dir = rz_pvector_at (&include_dirs, id_idx - 1);
 					}
-				} else {
-					include_dir = pinclude_dir = sdb_get (bf->sdb_addrinfo, "DW_AT_comp_dir", 0);
-					if (!include_dir) {
-						include_dir = "./";
+					if (include_dir && include_dir[0] != '/' && comp_dir) {
+						include_dir = full_dir = rz_str_newf ("%s/%s/", comp_dir, include_dir);
 					}
+				} else {
+					include_dir = comp_dir? comp_dir: "./";
 				}
 
 				if (hdr->file_names) {
@@ -517,11 +508,7 @@ static const ut8 *parse_line_header_source(RzBinFile *bf, const ut8 *buf, const
 					hdr->file_names[count].mod_time = mod_time;
 					hdr->file_names[count].file_len = file_len;
 				}
-				if (comp_dir) {
-					RZ_FREE (include_dir);
-					RZ_FREE (comp_dir);
-				}
-				RZ_FREE (pinclude_dir);
+				free (full_dir);
 			}
 			count++;
 			if (mode == RZ_MODE_PRINT && i) {
@@ -544,7 +531,7 @@ static const ut8 *parse_line_header_source(RzBinFile *bf, const ut8 *buf, const
 	}
 
 beach:
-	sdb_free (sdb);
+	rz_pvector_fini (&include_dirs);
 
 	return buf;
 }
@@ -552,8 +539,8 @@ beach:
 // Because this function needs ability to parse a lot of FORMS just like debug info
 // I'll complete this function after completing debug_info parsing and merging
 // for the meanwhile I am skipping the space.
-static const ut8 *parse_line_header_source_dwarf5(RzBinFile *bf, const ut8 *buf, const ut8 *buf_end,
-	RzBinDwarfLineHeader *hdr, Sdb *sdb, int mode) {
+static const ut8 *parse_line_header_source_dwarf5(const char *comp_dir, const ut8 *buf, const ut8 *buf_end,
+	RzBinDwarfLineHeader *hdr, int mode) {
 // 	int i = 0;
 // 	size_t count;
 // 	const ut8 *tmp_buf = NULL;
@@ -569,17 +556,14 @@ static const ut8 *parse_line_header_source_dwarf5(RzBinFile *bf, const ut8 *buf,
 // 	ut8 file_count = READ8 (buf);
 // 	// file names
 
-// beach:
-// 	sdb_free (sdb);
-
 	return NULL;
 }
 
 static const ut8 *parse_line_header (
-	RzBinFile *bf, const ut8 *buf, const ut8 *buf_end,
+	const char *comp_dir, const ut8 *buf, const ut8 *buf_end,
 	RzBinDwarfLineHeader *hdr, int mode, PrintfCallback print) {
 
-	rz_return_val_if_fail(hdr && bf && buf, NULL);
+	rz_return_val_if_fail(hdr && buf, NULL);
 
 	hdr->is_64bit = false;
 	hdr->unit_length = READ32 (buf);
@@ -656,61 +640,49 @@ static const ut8 *parse_line_header (
 		return tmp_buf;
 	}
 
-	Sdb *sdb = sdb_new (NULL, NULL, 0);
-	if (!sdb) {
-		return NULL;
-	}
-
 	if (hdr->version <= 4) {
-		buf = parse_line_header_source (bf, buf, buf_end, hdr, sdb, mode, print);
+		buf = parse_line_header_source (comp_dir, buf, buf_end, hdr, mode, print);
 	} else { // because Version 5 source files are very different
-		buf = parse_line_header_source_dwarf5 (bf, buf, buf_end, hdr, sdb, mode);
+		buf = parse_line_header_source_dwarf5 (comp_dir, buf, buf_end, hdr, mode);
 	}
 
 	return buf;
 }
 
-static inline void add_sdb_addrline(Sdb *s, ut64 addr, const char *file, ut64 line, int mode, PrintfCallback print) {
-	const char *p;
-	char *fileline;
-	char offset[64];
-	char *offset_ptr;
+// where the rows of the line number program of one unit go
+typedef struct {
+	RzBinDwarfLineTable *table;
+	ut32 *file_ids; // table index of each name of the header's file table
+} LineTableCtx;
 
-	if (!s || !file) {
+static inline void add_line(LineTableCtx *ctx, const RzBinDwarfLineHeader *hdr,
+	const RzBinDwarfSMRegisters *regs, int mode, PrintfCallback print) {
+	size_t fnidx = regs->file - 1;
+	if (!ctx || !hdr->file_names || fnidx >= hdr->file_names_count) {
 		return;
 	}
-	p = rz_str_rchr (file, NULL, '/');
-	if (p) {
-		p++;
-	} else {
-		p = file;
+	const char *file = hdr->file_names[fnidx].name;
+	if (!file) {
+		return;
 	}
-	// includedirs and properly check full paths
 	switch (mode) {
 	case 1:
 	case 'r':
-	case '*':
-		print ("CL %s:%d 0x%08"PFMT64x"\n", p, (int)line, addr);
+	case '*': {
+		const char *p = rz_str_rchr (file, NULL, '/');
+		print ("CL %s:%d 0x%08"PFMT64x"\n", p? p + 1: file, (int)regs->line, regs->address);
 		break;
 	}
-#if 0
-	/* THIS IS TOO SLOW */
-	if (rz_file_exists (file)) {
-		p = file;
 	}
-#else
-	p = file;
-#endif
-	fileline = rz_str_newf ("%s|%"PFMT64d, p, line);
-	offset_ptr = sdb_itoa (addr, offset, 16);
-	sdb_add (s, offset_ptr, fileline, 0);
-	sdb_add (s, fileline, offset_ptr, 0);
-	free (fileline);
+	if (ctx->file_ids[fnidx] != UT32_MAX) {
+		rz_bin_dwarf_line_table_add (ctx->table, regs->address, ctx->file_ids[fnidx],
+			(ut32)regs->line, (ut32)regs->column);
+	}
 }
 
 static const ut8 *parse_ext_opcode(const RzBin *bin, const ut8 *obuf,
 	size_t len, const RzBinDwarfLineHeader *hdr,
-	RzBinDwarfSMRegisters *regs, int mode) {
+	RzBinDwarfSMRegisters *regs, LineTableCtx *ctx, int mode) {
 
 	rz_return_val_if_fail (bin && bin->cur && obuf && hdr && regs, NULL);
 
@@ -741,14 +713,7 @@ static const ut8 *parse_ext_opcode(const RzBin *bin, const ut8 *obuf,
 	switch (opcode) {
 	case DW_LNE_end_sequence:
 		regs->end_sequence = DWARF_TRUE;
-
-		if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-			int fnidx = regs->file - 1;
-			if (fnidx >= 0 && fnidx < hdr->file_names_count) {
-				add_sdb_addrline(binfile->sdb_addrinfo, regs->address,
-						hdr->file_names[fnidx].name, regs->line, mode, print);
-			}
-		}
+		add_line (ctx, hdr, regs, mode, print);
 
 		if (mode == RZ_MODE_PRINT) {
 			print ("End of Sequence\n");
@@ -807,13 +772,12 @@ static const ut8 *parse_ext_opcode(const RzBin *bin, const ut8 *obuf,
 static const ut8 *parse_spec_opcode(
 	const RzBin *bin, const ut8 *obuf, size_t len,
 	const RzBinDwarfLineHeader *hdr,
-	RzBinDwarfSMRegisters *regs,
+	RzBinDwarfSMRegisters *regs, LineTableCtx *ctx,
 	ut8 opcode, int mode) {
 
 	rz_return_val_if_fail (bin && obuf && hdr && regs, NULL);
 
 	PrintfCallback print = bin->cb_printf;
-	RzBinFile *binfile = bin->cur;
 	const ut8 *buf = obuf;
 	ut8 adj_opcode = 0;
 	ut64 advance_adr;
@@ -832,14 +796,7 @@ static const ut8 *parse_spec_opcode(
 		print ("advance Address by %"PFMT64d" to 0x%"PFMT64x" and Line by %d to %"PFMT64d"\n",
 			advance_adr, regs->address, line_increment, regs->line);
 	}
-	if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-		int idx = regs->file -1;
-		if (idx >= 0 && idx < hdr->file_names_count) {
-			add_sdb_addrline (binfile->sdb_addrinfo, regs->address,
-					hdr->file_names[idx].name,
-					regs->line, mode, print);
-		}
-	}
+	add_line (ctx, hdr, regs, mode, print);
 	regs->basic_block = DWARF_FALSE;
 	regs->prologue_end = DWARF_FALSE;
 	regs->epilogue_begin = DWARF_FALSE;
@@ -851,12 +808,11 @@ static const ut8 *parse_spec_opcode(
 static const ut8 *parse_std_opcode(
 	const RzBin *bin, const ut8 *obuf, size_t len,
 	const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegisters *regs,
-	ut8 opcode, int mode) {
+	LineTableCtx *ctx, ut8 opcode, int mode) {
 
 	rz_return_val_if_fail (bin && bin->cur && obuf && hdr && regs, NULL);
 
 	PrintfCallback print = bin->cb_printf;
-	RzBinFile *binfile = bin->cur;
 	const ut8* buf = obuf;
 	const ut8* buf_end = obuf + len;
 	ut64 addr = 0LL;
@@ -873,15 +829,7 @@ static const ut8 *parse_std_opcode(
 		if (mode == RZ_MODE_PRINT) {
 			print ("Copy\n");
 		}
-		if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-			int fnidx = regs->file - 1;
-			if (fnidx >= 0 && fnidx < hdr->file_names_count) {
-				add_sdb_addrline (binfile->sdb_addrinfo,
-					regs->address,
-					hdr->file_names[fnidx].name,
-					regs->line, mode, print);
-			}
-		}
+		add_line (ctx, hdr, regs, mode, print);
 		regs->basic_block = DWARF_FALSE;
 		break;
 	case DW_LNS_advance_pc:
@@ -989,7 +937,7 @@ static void set_regs_default(const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegist
 // Passing bin should be unnecessary (after we stop printing inside bin_dwarf)
 static size_t parse_opcodes(const RzBin *bin, const ut8 *obuf,
 		size_t len, const RzBinDwarfLineHeader *hdr,
-		RzBinDwarfSMRegisters *regs, int mode) {
+		RzBinDwarfSMRegisters *regs, LineTableCtx *ctx, int mode) {
 	const ut8 *buf, *buf_end;
 	ut8 opcode, ext_opcode;
 
@@ -1004,15 +952,15 @@ static size_t parse_opcodes(const RzBin *bin, const ut8 *obuf,
 		len--;
 		if (!opcode) {
 			ext_opcode = *buf;
-			buf = parse_ext_opcode (bin, buf, len, hdr, regs, mode);
+			buf = parse_ext_opcode (bin, buf, len, hdr, regs, ctx, mode);
 			if (!buf || ext_opcode == DW_LNE_end_sequence) {
 				set_regs_default (hdr, regs); // end_sequence should reset regs to default
 				break;
 			}
 		} else if (opcode >= hdr->opcode_base) {
-			buf = parse_spec_opcode (bin, buf, len, hdr, regs, opcode, mode);
+			buf = parse_spec_opcode (bin, buf, len, hdr, regs, ctx, opcode, mode);
 		} else {
-			buf = parse_std_opcode (bin, buf, len, hdr, regs, opcode, mode);
+			buf = parse_std_opcode (bin, buf, len, hdr, regs, ctx, opcode, mode);
 		}
 		len = (size_t)(buf_end - buf);
 	}
@@ -1025,78 +973,199 @@ static size_t parse_opcodes(const RzBin *bin, const ut8 *obuf,
 	return (size_t) (buf - obuf); // number of bytes we've moved by
 }
 
-static int parse_line_raw(const RzBin *a, const ut8 *obuf,
-				       ut64 len, int mode) {
-
-	RzBinFile *binfile = a ? a->cur : NULL;
-	rz_return_val_if_fail(binfile && obuf, false);
+// Parses one unit of .debug_line, returns where the next one starts or NULL on error
+static const ut8 *parse_line_unit(const RzBin *a, const ut8 *buf, const ut8 *buf_end,
+	RzBinDwarfLineTable *lines, const char *comp_dir, int mode) {
 	PrintfCallback print = a->cb_printf;
+	RzBinDwarfLineHeader hdr = { 0 };
+	// How much did we read from the compilation unit
+	size_t bytes_read = 0;
+	// calculate how much we've read by parsing header
+	// because header unit_length includes itself
+	ut64 buf_size = buf_end - buf;
+
+	const ut8 *tmpbuf = buf;
+	buf = parse_line_header (comp_dir, buf, buf_end, &hdr, mode, print);
+	if (!buf) {
+		return NULL;
+	}
 
 	if (mode == RZ_MODE_PRINT) {
-		print ("Raw dump of debug contents of section .debug_line:\n\n");
+		print (" Line Number Statements:\n");
 	}
-	const ut8 *buf = obuf;
-	const ut8 *buf_end = obuf + len;
-	const ut8 *tmpbuf = NULL;
-
-	RzBinDwarfLineHeader hdr = { 0 };
-	ut64 buf_size;
+	bytes_read = buf - tmpbuf;
 
-	// each iteration we read one header AKA comp. unit
-	while (buf <= buf_end) {
-		// How much did we read from the compilation unit
-		size_t bytes_read = 0;
-		// calculate how much we've read by parsing header
-		// because header unit_length includes itself
-		buf_size = buf_end - buf;
-
-		tmpbuf = buf;
-		buf = parse_line_header (a->cur, buf, buf_end, &hdr, mode, print);
-		if (!buf) {
-			return false;
-		}
+	RzBinDwarfSMRegisters regs;
+	set_regs_default (&hdr, &regs);
 
+	// If there is more bytes in the buffer than size of the header
+	// It means that there has to be another header/comp.unit
+	if (buf_size > hdr.unit_length) {
+		buf_size = hdr.unit_length + (hdr.is_64bit * 8 + 4); // we dif against bytes_read, but
+			// unit_length doesn't account unit_length field
+	}
+	// this deals with a case that there is compilation unit with any line information
+	if (buf_size == bytes_read) {
 		if (mode == RZ_MODE_PRINT) {
-			print (" Line Number Statements:\n");
+			print (" Line table is present, but no lines present\n");
 		}
-		bytes_read = buf - tmpbuf;
+		line_header_fini (&hdr);
+		return buf;
+	}
+	if (buf_size > (buf_end - buf) + bytes_read || buf > buf_end) {
+		line_header_fini (&hdr);
+		return NULL;
+	}
+	// file names are interned once per unit, rows only carry their index
+	LineTableCtx ctx = { lines, RZ_NEWS (ut32, hdr.file_names_count + 1) };
+	if (!ctx.file_ids) {
+		line_header_fini (&hdr);
+		return NULL;
+	}
+	size_t i;
+	for (i = 0; i < hdr.file_names_count; i++) {
+		const char *name = hdr.file_names[i].name;
+		ctx.file_ids[i] = name? rz_bin_dwarf_line_table_file_id (lines, name): UT32_MAX;
+	}
+	size_t tmp_read = 0;
+	// we read the whole compilation unit (that might be composed of more sequences)
+	do {
+		// reads one whole sequence
+		tmp_read = parse_opcodes (a, buf, buf_end - buf, &hdr, &regs, &ctx, mode);
+		bytes_read += tmp_read;
+		buf += tmp_read; // Move in the buffer forward
+	} while (bytes_read < buf_size && tmp_read != 0); // if nothing is read -> error, exit
+
+	free (ctx.file_ids);
+	line_header_fini (&hdr);
+	return tmp_read? buf: NULL;
+}
 
-		RzBinDwarfSMRegisters regs;
-		set_regs_default (&hdr, &regs);
+typedef struct {
+	const RzBin *bin;
+	const ut8 *buf;
+	const ut8 *buf_end;
+	const char *comp_dir;
+	int mode;
+	RzBinDwarfLineTable *lines;
+	const ut8 *next;
+} LineUnitJob;
+
+static void line_unit_job(void *user) {
+	LineUnitJob *job = user;
+	job->lines = rz_bin_dwarf_line_table_new ();
+	if (!job->lines) {
+		return;
+	}
+	job->next = parse_line_unit (job->bin, job->buf, job->buf_end, job->lines, job->comp_dir, job->mode);
+	if (!rz_bin_dwarf_line_table_finish (job->lines)) {
+		rz_bin_dwarf_line_table_free (job->lines);
+		job->lines = NULL;
+	}
+}
 
-		// If there is more bytes in the buffer than size of the header
-		// It means that there has to be another header/comp.unit
-		if (buf_size > hdr.unit_length) {
-			buf_size = hdr.unit_length + (hdr.is_64bit * 8 + 4); // we dif against bytes_read, but
-				// unit_length doesn't account unit_length field
-		}
-		// this deals with a case that there is compilation unit with any line information
-		if (buf_size == bytes_read) {
-			if (mode == RZ_MODE_PRINT) {
-				print (" Line table is present, but no lines present\n");
+// Finds where each unit starts from the unit lengths, without decoding them
+static void line_unit_starts(const ut8 *buf, const ut8 *buf_end, RzPVector *units) {
+	while (buf + 4 <= buf_end) {
+		ut64 len = rz_read_ble32 (buf, big_end);
+		size_t skip = 4;
+		if (len == DWARF_INIT_LEN_64) {
+			if (buf + 12 > buf_end) {
+				break;
 			}
-			line_header_fini (&hdr);
-			continue;
+			len = rz_read_ble64 (buf + 4, big_end);
+			skip = 12;
 		}
-		if (buf_size > (buf_end - buf) + bytes_read || buf > buf_end) {
-			line_header_fini (&hdr);
-			return false;
+		rz_pvector_push (units, (void *)buf);
+		if (len > (ut64)(buf_end - buf) - skip) {
+			break;
 		}
-		size_t tmp_read = 0;
-		// we read the whole compilation unit (that might be composed of more sequences)
-		do {
-			// reads one whole sequence
-			tmp_read = parse_opcodes (a, buf, buf_end - buf, &hdr, &regs, mode);
-			bytes_read += tmp_read;
-			buf += tmp_read; // Move in the buffer forward
-		} while (bytes_read < buf_size && tmp_read != 0); // if nothing is read -> error, exit
+		buf += skip + len;
+	}
+}
 
-		line_header_fini (&hdr);
-		if (!tmp_read) {
-			return false;
+/*
+ * Units are independent, so when nothing is printed they are decoded in
+ * parallel into a table each, merged back in the order of the section.
+ * If a unit does not end where the next one starts, the rest of the section
+ * is parsed sequentially to get the same rows as the sequential parser.
+ * \p failed is set when the rows of a unit could not be kept, e.g. on OOM.
+ */
+static const ut8 *parse_line_units_parallel(const RzBin *a, const ut8 *buf, const ut8 *buf_end,
+	RzBinDwarfLineTable *lines, const char *comp_dir, int mode, bool *failed) {
+	RzPVector units;
+	rz_pvector_init (&units, NULL);
+	line_unit_starts (buf, buf_end, &units);
+	size_t i, count = rz_pvector_len (&units);
+	int threads = a->dwarf_threads > 0? a->dwarf_threads: rz_th_ncores ();
+	LineUnitJob *jobs = count > 1 && threads > 1? RZ_NEWS0 (LineUnitJob, count): NULL;
+	RzThreadPool *pool = jobs? rz_th_pool_new (threads): NULL;
+	if (!pool) {
+		free (jobs);
+		rz_pvector_fini (&units);
+		return buf;
+	}
+	for (i = 0; i < count; i++) {
+		jobs[i].bin = a;
+		jobs[i].buf = rz_pvector_at (&units, i);
+		jobs[i].buf_end = buf_end;
+		jobs[i].comp_dir = comp_dir;
+		jobs[i].mode = mode;
+		if (!rz_th_pool_add_job (pool, line_unit_job, &jobs[i])) {
+			line_unit_job (&jobs[i]);
+		}
+	}
+	rz_th_pool_wait (pool);
+	rz_th_pool_free (pool);
+	for (i = 0; i < count; i++) {
+		if (!jobs[i].lines || !rz_bin_dwarf_line_table_merge (lines, jobs[i].lines)) {
+			*failed = true;
+			buf = NULL;
+			break;
+		}
+		buf = jobs[i].next;
+		if (!buf || (i + 1 < count && buf != rz_pvector_at (&units, i + 1))) {
+			break;
 		}
 	}
-	return true;
+	for (i = 0; i < count; i++) {
+		rz_bin_dwarf_line_table_free (jobs[i].lines);
+	}
+	free (jobs);
+	rz_pvector_fini (&units);
+	return buf && buf < buf_end? buf: NULL;
+}
+
+static bool parse_line_raw(const RzBin *a, const ut8 *obuf,
+	ut64 len, RzBinDwarfLineTable *lines, const char *comp_dir, int mode) {
+
+	RzBinFile *binfile = a ? a->cur : NULL;
+	rz_return_val_if_fail(binfile && obuf && lines, false);
+	PrintfCallback print = a->cb_printf;
+
+	if (mode == RZ_MODE_PRINT) {
+		print ("Raw dump of debug contents of section .debug_line:\n\n");
+	}
+	const ut8 *buf = obuf;
+	const ut8 *buf_end = obuf + len;
+	bool failed = false;
+
+	switch (mode) {
+	case RZ_MODE_PRINT:
+	case RZ_MODE_RADARE:
+	case 'r':
+	case '*':
+		// the output has to follow the order of the section
+		break;
+	default:
+		buf = parse_line_units_parallel (a, buf, buf_end, lines, comp_dir, mode, &failed);
+		break;
+	}
+	// each iteration we read one header AKA comp. unit
+	while (buf && buf <= buf_end) {
+		buf = parse_line_unit (a, buf, buf_end, lines, comp_dir, mode);
+	}
+	return !failed;
 }
 
 #define READ_BUF(x,y) if (idx+sizeof(y)>=len) { return false;} \
@@ -1182,9 +1251,6 @@ static int init_debug_info(RzBinDwarfDebugInfo *inf) {
 		return -1;
 	}
 	inf->comp_units = calloc (sizeof (RzBinDwarfCompUnit), DEBUG_INFO_CAPACITY);
-
-	inf->lookup_table = ht_up_new0 ();
-
 	if (!inf->comp_units) {
 		return -1;
 	}
@@ -1360,37 +1426,11 @@ RZ_API void rz_bin_dwarf_free_debug_abbrev(RzBinDwarfDebugAbbrev *da) {
 	free (da);
 }
 
-static void free_attr_value(RzBinDwarfAttrValue *val) {
-	// TODO adjust to new forms, now we're leaking
-	if (!val) {
-		return;
-	}
-	switch (val->attr_form) {
-	case DW_FORM_strp:
-	case DW_FORM_string:
-		RZ_FREE (val->string.content);
-		break;
-	case DW_FORM_exprloc:
-	case DW_FORM_block:
-	case DW_FORM_block1:
-	case DW_FORM_block2:
-	case DW_FORM_block4:
-		RZ_FREE (val->block.data);
-		break;
-	default:
-		break;
-	};
-}
-
 static void free_die(RzBinDwarfDie *die) {
-	size_t i;
-	if (!die) {
-		return;
+	// strings and blocks of the values point into the sections of the info
+	if (die) {
+		RZ_FREE (die->attr_values);
 	}
-	for (i = 0; i < die->count; i++) {
-		free_attr_value (&die->attr_values[i]);
-	}
-	RZ_FREE (die->attr_values);
 }
 
 static void free_comp_unit(RzBinDwarfCompUnit *cu) {
@@ -1404,8 +1444,12 @@ static void free_comp_unit(RzBinDwarfCompUnit *cu) {
 		}
 	}
 	RZ_FREE (cu->dies);
+	cu->count = 0;
+	cu->capacity = 0;
 }
 
+static void free_info_accel(RzBinDwarfInfoAccel *accel);
+
 RZ_API void rz_bin_dwarf_free_debug_info(RzBinDwarfDebugInfo *inf) {
 	size_t i;
 	if (!inf) {
@@ -1414,9 +1458,11 @@ RZ_API void rz_bin_dwarf_free_debug_info(RzBinDwarfDebugInfo *inf) {
 	for (i = 0; i < inf->count; i++) {
 		free_comp_unit (&inf->comp_units[i]);
 	}
-	ht_up_free (inf->lookup_table);
 	free (inf->comp_units);
-	free(inf);
+	free (inf->debug_info);
+	free (inf->debug_str);
+	free_info_accel (inf->accel);
+	free (inf);
 }
 
 static void print_attr_value(const RzBinDwarfAttrValue *val, PrintfCallback print) {
@@ -1557,18 +1603,12 @@ static void print_debug_info(const RzBinDwarfDebugInfo *inf, PrintfCallback prin
 }
 
 static const ut8 *fill_block_data(const ut8 *buf, const ut8 *buf_end, RzBinDwarfBlock *block) {
-	block->data = calloc (sizeof (ut8), block->length);
-	if (!block->data) {
-		return NULL;
+	// the block stays in the section, a truncated one is cut at its end
+	block->data = (ut8 *)buf;
+	if (block->length > buf_end - buf) {
+		block->length = buf_end - buf;
 	}
-	/* Maybe unroll this as an optimization in future? */
-	if (block->data) {
-		size_t j = 0;
-		for (j = 0; j < block->length; j++) {
-			block->data[j] = READ (buf, ut8);
-		}
-	}
-	return buf;
+	return buf + block->length;
 }
 
 /**
@@ -1593,7 +1633,6 @@ static const ut8 *parse_attr_value(const ut8 *obuf, int obuf_len,
 
 	const ut8 *buf = obuf;
 	const ut8 *buf_end = obuf + obuf_len;
-	size_t j;
 
 	rz_return_val_if_fail(def && value && hdr && obuf && obuf_len >= 1, NULL);
 
@@ -1656,7 +1695,7 @@ static const ut8 *parse_attr_value(const ut8 *obuf, int obuf_len,
 		break;
 	case DW_FORM_string:
 		value->kind = DW_AT_KIND_STRING;
-		value->string.content = *buf ? strdup ((const char *)buf) : NULL;
+		value->string.content = *buf ? (char *)buf : NULL;
 		buf += (strlen ((const char *)buf) + 1);
 		break;
 	case DW_FORM_block1:
@@ -1667,15 +1706,7 @@ static const ut8 *parse_attr_value(const ut8 *obuf, int obuf_len,
 	case DW_FORM_block2:
 		value->kind = DW_AT_KIND_BLOCK;
 		value->block.length = READ16 (buf);
-		if (value->block.length > 0) {
-			value->block.data = calloc (sizeof (ut8), value->block.length);
-			if (!value->block.data) {
-				return NULL;
-			}
-			for (j = 0; j < value->block.length; j++) {
-				value->block.data[j] = READ (buf, ut8);
-			}
-		}
+		buf = fill_block_data (buf, buf_end, &value->block);
 		break;
 	case DW_FORM_block4:
 		value->kind = DW_AT_KIND_BLOCK;
@@ -1699,8 +1730,7 @@ static const ut8 *parse_attr_value(const ut8 *obuf, int obuf_len,
 		value->kind = DW_AT_KIND_STRING;
 		value->string.offset = dwarf_read_offset(hdr->is_64bit, &buf, buf_end);
 		if (debug_str && value->string.offset < debug_str_len) {
-			value->string.content =
-				strdup ((const char *)(debug_str + value->string.offset));
+			value->string.content = (char *)(debug_str + value->string.offset);
 		} else {
 			value->string.content = NULL; // Means malformed DWARF, should we print error message?
 		}
@@ -1856,30 +1886,16 @@ static const ut8 *parse_attr_value(const ut8 *obuf, int obuf_len,
  * @param die DIE to store the parsed info into
  * @param debug_str Ptr to string section start
  * @param debug_str_len Length of the string section
- * @param sdb
  * @return const ut8* Updated buffer
  */
 static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfAbbrevDecl *abbrev,
-		RzBinDwarfCompUnitHdr *hdr, RzBinDwarfDie *die, const ut8 *debug_str, size_t debug_str_len, Sdb *sdb) {
+		RzBinDwarfCompUnitHdr *hdr, RzBinDwarfDie *die, const ut8 *debug_str, size_t debug_str_len) {
 	size_t i;
 	for (i = 0; i < abbrev->count - 1; i++) {
 		memset (&die->attr_values[i], 0, sizeof (die->attr_values[i]));
 
 		buf = parse_attr_value (buf, buf_end - buf, &abbrev->defs[i],
 			&die->attr_values[i], hdr, debug_str, debug_str_len);
-
-		RzBinDwarfAttrValue *attribute = &die->attr_values[i];
-
-		bool is_valid_string_form = (attribute->attr_form == DW_FORM_strp ||
-			attribute->attr_form == DW_FORM_string) &&
-			attribute->string.content;
-		// TODO  does this have a purpose anymore?
-		// Or atleast it needs to rework becase there will be
-		// more comp units -> more comp dirs and only the last one will be kept
-		if (attribute->attr_name == DW_AT_comp_dir && is_valid_string_form) {
-			const char *name = attribute->string.content;
-			sdb_set (sdb, "DW_AT_comp_dir", name, 0);
-		}
 		die->count++;
 	}
 
@@ -1889,7 +1905,9 @@ static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfAbbrev
 /**
  * @brief Reads throught comp_unit buffer and parses all its DIEntries
  *
- * @param sdb
+ * Units do not share any state while they are parsed, so this may run for
+ * several units at once.
+ *
  * @param buf_start Start of the compilation unit data
  * @param unit Unit to store the newly parsed information
  * @param abbrevs Parsed abbrev section info of *all* abbreviations
@@ -1899,7 +1917,7 @@ static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfAbbrev
  *
  * @return const ut8* Update buffer
  */
-static const ut8 *parse_comp_unit(RzBinDwarfDebugInfo *info, Sdb *sdb, const ut8 *buf_start,
+static const ut8 *parse_comp_unit(const ut8 *buf_start,
 		RzBinDwarfCompUnit *unit, const RzBinDwarfDebugAbbrev *abbrevs,
 		size_t first_abbr_idx, const ut8 *debug_str, size_t debug_str_len) {
 
@@ -1945,7 +1963,7 @@ static const ut8 *parse_comp_unit(RzBinDwarfDebugInfo *info, Sdb *sdb, const ut8
 		die->tag = abbrev->tag;
 		die->has_children = abbrev->has_children;
 
-		buf = parse_die (buf, buf_end, abbrev, &unit->hdr, die, debug_str, debug_str_len, sdb);
+		buf = parse_die (buf, buf_end, abbrev, &unit->hdr, die, debug_str, debug_str_len);
 		if (!buf) {
 			return NULL;
 		}
@@ -2010,89 +2028,79 @@ static int expand_info(RzBinDwarfDebugInfo *info) {
 }
 
 /**
- * @brief Parses whole .debug_info section
+ * @brief Reads the headers of all compilation units of .debug_info
+ *
+ * The DIEs are left alone, units are decoded later by decode_comp_unit().
  *
- * @param sdb Sdb to store line related information into
- * @param da Parsed Abbreviations
- * @param obuf .debug_info section buffer start
- * @param len length of the section buffer
- * @param debug_str start of the .debug_str section
- * @param debug_str_len length of the debug_str section
- * @param mode
- * @return RZ_API* parse_info_raw Parsed information
+ * @param info Info owning the section
+ * @return bool false if a unit header is malformed
  */
-static RzBinDwarfDebugInfo *parse_info_raw(Sdb *sdb, RzBinDwarfDebugAbbrev *da,
-		const ut8 *obuf, size_t len,
-		const ut8 *debug_str, size_t debug_str_len) {
-
-	rz_return_val_if_fail (da && sdb && obuf, false);
-
+static bool index_comp_units(RzBinDwarfDebugInfo *info) {
+	const ut8 *obuf = info->debug_info;
 	const ut8 *buf = obuf;
-	const ut8 *buf_end = obuf + len;
-
-	RzBinDwarfDebugInfo *info = RZ_NEW0 (RzBinDwarfDebugInfo);
-	if (!info) {
-		return NULL;
-	}
-	if (init_debug_info (info) < 0) {
-		goto cleanup;
-	}
-	int unit_idx = 0;
+	const ut8 *buf_end = obuf + info->debug_info_len;
 
 	while (buf < buf_end) {
-		if (info->count >= info->capacity) {
-			if (expand_info (info)) {
-				break;
-			}
-		}
-
-		RzBinDwarfCompUnit *unit = &info->comp_units[unit_idx];
-		if (init_comp_unit (unit) < 0) {
-			unit_idx--;
-			goto cleanup;
+		if (info->count >= info->capacity && expand_info (info)) {
+			return false;
 		}
-		info->count++;
-
+		RzBinDwarfCompUnit *unit = &info->comp_units[info->count];
+		const ut8 *start = buf;
 		unit->offset = buf - obuf;
 		// small redundancy, because it was easiest solution at a time
 		unit->hdr.unit_offset = buf - obuf;
 
 		buf = info_comp_unit_read_hdr (buf, buf_end, &unit->hdr);
 
-		if (unit->hdr.length > len) {
-			goto cleanup;
-		}
-
-		if (da->decls->count >= da->capacity) {
-			eprintf ("WARNING: malformed dwarf have not enough buckets for decls.\n");
-		}
-		rz_warn_if_fail (da->count <= da->capacity);
-
-		// find abbrev start for current comp unit
-		// we could also do naive, ((char *)da->decls) + abbrev_offset,
-		// but this is more bulletproof to invalid DWARF
-		RzBinDwarfAbbrevDecl key = { .offset = unit->hdr.abbrev_offset };
-		RzBinDwarfAbbrevDecl *abbrev_start = bsearch (&key, da->decls, da->count, sizeof (key), abbrev_cmp);
-		if (!abbrev_start) {
-			goto cleanup;
-		}
-		// They point to the same array object, so should be def. behaviour
-		size_t first_abbr_idx = abbrev_start - da->decls;
-
-		buf = parse_comp_unit (info, sdb, buf, unit, da, first_abbr_idx, debug_str, debug_str_len);
-
-		if (!buf) {
-			goto cleanup;
+		// the length does not count the length field itself
+		ut64 size = unit->hdr.length + (unit->hdr.is_64bit ? 12 : 4);
+		if (unit->hdr.length < unit->hdr.header_size || size > (ut64)(buf_end - start)) {
+			memset (unit, 0, sizeof (*unit));
+			return false;
 		}
+		info->count++;
+		buf = start + size;
+	}
+	return true;
+}
 
-		unit_idx++;
+/**
+ * @brief Decodes all DIEs of an indexed compilation unit
+ *
+ * @param info Info the unit belongs to
+ * @param unit Unit to decode, its dies must be NULL
+ * @return bool false on malformed unit, which is left undecoded
+ */
+static bool decode_comp_unit(const RzBinDwarfDebugInfo *info, RzBinDwarfCompUnit *unit) {
+	const RzBinDwarfDebugAbbrev *da = info->abbrevs;
+	if (!da || !da->decls) {
+		return false;
 	}
+	if (da->decls->count >= da->capacity) {
+		eprintf ("WARNING: malformed dwarf have not enough buckets for decls.\n");
+	}
+	rz_warn_if_fail (da->count <= da->capacity);
 
-	return info;
+	// find abbrev start for current comp unit
+	// we could also do naive, ((char *)da->decls) + abbrev_offset,
+	// but this is more bulletproof to invalid DWARF
+	RzBinDwarfAbbrevDecl key = { .offset = unit->hdr.abbrev_offset };
+	RzBinDwarfAbbrevDecl *abbrev_start = bsearch (&key, da->decls, da->count, sizeof (key), abbrev_cmp);
+	if (!abbrev_start) {
+		return false;
+	}
+	// They point to the same array object, so should be def. behaviour
+	size_t first_abbr_idx = abbrev_start - da->decls;
 
-cleanup:
-	rz_bin_dwarf_free_debug_info (info);
-	return NULL;
+	if (init_comp_unit (unit) < 0) {
+		return false;
+	}
+	const ut8 *buf = info->debug_info + unit->offset + (unit->hdr.is_64bit ? 12 : 4) + unit->hdr.header_size;
+	if (!parse_comp_unit (buf, unit, da, first_abbr_idx, info->debug_str, info->debug_str_len)) {
+		free_comp_unit (unit);
+		return false;
+	}
+	return true;
 }
 
 static RzBinDwarfDebugAbbrev *parse_abbrev_raw(const ut8 *obuf, size_t len) {
@@ -2187,157 +2195,944 @@ static ut8 *get_section_bytes(RzBin *bin, const char *sect_name, size_t *len) {
 	return buf;
 }
 
-/**
- * @brief Parses .debug_info section
- *
- * @param da Parsed abbreviations
- * @param bin
- * @param mode RZ_MODE_PRINT to print
- * @return RzBinDwarfDebugInfo* Parsed information, NULL if error
- */
-RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info(RzBinDwarfDebugAbbrev *da, RzBin *bin, int mode) {
-	RzBinDwarfDebugInfo *info = NULL;
-	RzBinSection *debug_str;
-	RzBinSection *section = getsection (bin, "debug_info");
-	RzBinFile *binfile = bin ? bin->cur : NULL;
+// Copies a section, zero terminated so that strings at its end stay bounded
+static ut8 *read_section(RzBin *bin, const char *sect_name, size_t *len) {
+	RzBinSection *section = getsection (bin, sect_name);
+	RzBinFile *binfile = bin->cur;
+	if (!section || !binfile || section->size < 1 || section->size > (UT32_MAX >> 1)) {
+		return NULL;
+	}
+	ut8 *buf = calloc (1, section->size + 1);
+	if (!buf) {
+		return NULL;
+	}
+	if (rz_buf_read_at (binfile->buf, section->paddr, buf, section->size) < 1) {
+		free (buf);
+		return NULL;
+	}
+	*len = section->size;
+	return buf;
+}
 
-	ut64 debug_str_len = 0;
-	ut8 *debug_str_buf = NULL;
+typedef struct {
+	const char *name;
+	ut64 die; ///< offset of the DIE, UT64_MAX when only the unit is known
+	size_t unit;
+} DwarfNameEntry;
+
+typedef struct {
+	ut64 low;
+	ut64 high;
+	ut64 max_high; ///< highest end of this range and of all the ones sorted before it
+	size_t unit;
+} DwarfAddrEntry;
+
+struct rz_bin_dwarf_info_accel_t {
+	RzVector /*<DwarfNameEntry>*/ names;
+	RzVector /*<DwarfAddrEntry>*/ addrs;
+	ut8 *gdb_index; ///< names from .gdb_index point into it
+	bool names_ready;
+	bool addrs_ready;
+};
 
-	if (binfile && section) {
-		debug_str = getsection (bin, "debug_str");
-		if (debug_str) {
-			debug_str_len = debug_str->size;
-			debug_str_buf = calloc (1, debug_str_len + 1);
-			if (!debug_str_buf) {
-				goto cleanup;
-			}
-			st64 ret = rz_buf_read_at (binfile->buf, debug_str->paddr,
-				debug_str_buf, debug_str_len);
-			if (!ret) {
-				goto cleanup;
-			}
-		}
+static void free_info_accel(RzBinDwarfInfoAccel *accel) {
+	if (!accel) {
+		return;
+	}
+	rz_vector_fini (&accel->names);
+	rz_vector_fini (&accel->addrs);
+	free (accel->gdb_index);
+	free (accel);
+}
 
-		ut64 len = section->size;
-		// what is this checking for?
-		if (len > (UT32_MAX >> 1) || len < 1) {
-			goto cleanup;
-		}
-		ut8 *buf = calloc (1, len);
-		if (!buf) {
-			goto cleanup;
-		}
-		if (!rz_buf_read_at (binfile->buf, section->paddr, buf, len)) {
-			free (buf);
-			goto cleanup;
-		}
-		/* set the endianity global [HOTFIX] */
-		big_end = rz_bin_is_big_endian (bin);
-		info = parse_info_raw (binfile->sdb_addrinfo, da, buf, len,
-			debug_str_buf, debug_str_len);
-
-		if (mode == RZ_MODE_PRINT && info) {
-			print_debug_info (info, bin->cb_printf);
-		}
-		// build hashtable after whole parsing because of possible relocations
-		if (info) {
-			size_t i, j;
-			for (i = 0; i < info->count; i++) {
-				RzBinDwarfCompUnit *unit = &info->comp_units[i];
-				for (j = 0; j < unit->count; j++) {
-					RzBinDwarfDie *die = &unit->dies[j];
-					ht_up_insert (info->lookup_table, die->offset, die); // optimization for further processing}
-				}
-			}
+// Index of the unit starting exactly at offset, or SIZE_MAX
+static size_t unit_at_offset(const RzBinDwarfDebugInfo *info, ut64 offset) {
+	size_t lo = 0, hi = info->count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (info->comp_units[mid].offset < offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
 		}
-		free (debug_str_buf);
-		free (buf);
-		return info;
 	}
-cleanup:
-	free (debug_str_buf);
-	return NULL;
+	return lo < info->count && info->comp_units[lo].offset == offset ? lo : SIZE_MAX;
 }
 
-static RzBinDwarfRow *row_new(ut64 addr, const char *file, int line, int col) {
-	RzBinDwarfRow *row = RZ_NEW0 (RzBinDwarfRow);
-	if (!row) {
-		return NULL;
+// Index of the unit containing offset, or SIZE_MAX
+static size_t unit_containing(const RzBinDwarfDebugInfo *info, ut64 offset) {
+	size_t lo = 0, hi = info->count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (info->comp_units[mid].offset <= offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
 	}
-	row->file = strdup (file);
-	row->address = addr;
-	row->line = line;
-	row->column = 0;
-	return row;
+	if (!lo) {
+		return SIZE_MAX;
+	}
+	const RzBinDwarfCompUnit *unit = &info->comp_units[lo - 1];
+	ut64 end = unit->offset + unit->hdr.length + (unit->hdr.is_64bit ? 12 : 4);
+	return offset < end ? lo - 1 : SIZE_MAX;
 }
 
-static void row_free(void *p) {
-	RzBinDwarfRow *row = (RzBinDwarfRow*)p;
-	free (row->file);
-	free (row);
+static void add_name(RzBinDwarfInfoAccel *accel, const char *name, ut64 die, size_t unit) {
+	DwarfNameEntry e = { name, die, unit };
+	rz_vector_push (&accel->names, &e);
 }
 
-RZ_API RzList *rz_bin_dwarf_parse_line(RzBin *bin, int mode) {
-	ut8 *buf;
-	RzList *list = NULL;
-	int len, ret;
-	RzBinSection *section = getsection (bin, "debug_line");
-	RzBinFile *binfile = bin ? bin->cur: NULL;
-	if (binfile && section) {
-		len = section->size;
-		if (len < 1) {
-			return NULL;
-		}
-		buf = calloc (1, len + 1);
-		if (!buf) {
-			return NULL;
-		}
-		ret = rz_buf_read_at (binfile->buf, section->paddr, buf, len);
-		if (ret != len) {
-			free (buf);
-			return NULL;
+static void add_addr(RzBinDwarfInfoAccel *accel, ut64 low, ut64 high, size_t unit) {
+	if (low < high) {
+		DwarfAddrEntry e = { low, high, high, unit };
+		rz_vector_push (&accel->addrs, &e);
+	}
+}
+
+static const ut8 *read_index_value(const ut8 *buf, const ut8 *buf_end, ut64 form, bool is_64bit, ut64 *val) {
+	switch (form) {
+	case DW_FORM_flag_present:
+		*val = 1;
+		break;
+	case DW_FORM_flag:
+	case DW_FORM_data1:
+	case DW_FORM_ref1:
+		*val = READ8 (buf);
+		break;
+	case DW_FORM_data2:
+	case DW_FORM_ref2:
+		*val = READ16 (buf);
+		break;
+	case DW_FORM_data4:
+	case DW_FORM_ref4:
+		*val = READ32 (buf);
+		break;
+	case DW_FORM_data8:
+	case DW_FORM_ref8:
+	case DW_FORM_ref_sig8:
+		*val = READ64 (buf);
+		break;
+	case DW_FORM_udata:
+	case DW_FORM_ref_udata:
+		buf = rz_uleb128 (buf, buf_end - buf, val, NULL);
+		break;
+	case DW_FORM_sdata:
+		buf = rz_leb128 (buf, buf_end - buf, (st64 *)val);
+		break;
+	case DW_FORM_ref_addr:
+	case DW_FORM_sec_offset:
+		*val = dwarf_read_offset (is_64bit, &buf, buf_end);
+		break;
+	default:
+		return NULL;
+	}
+	return buf;
+}
+
+/*
+ * Reads the name tables of .debug_names, DWARF5 section 6.1.1. Only entries
+ * of compilation units are kept, with the offset of their DIE.
+ */
+static void load_debug_names(const RzBinDwarfDebugInfo *info, RzBinDwarfInfoAccel *accel, const ut8 *obuf, size_t len) {
+	const ut8 *buf = obuf;
+	const ut8 *buf_end = obuf + len;
+	RzVector abbrevs;
+	rz_vector_init (&abbrevs, sizeof (ut64) * 2, NULL, NULL);
+
+	while (buf + 4 < buf_end) {
+		bool is_64bit = false;
+		ut64 unit_len = READ32 (buf);
+		if (unit_len == DWARF_INIT_LEN_64) {
+			unit_len = READ64 (buf);
+			is_64bit = true;
 		}
-		list = rz_list_newf (row_free);
-		if (!list) {
-			free (buf);
-			return NULL;
+		if (unit_len > (ut64)(buf_end - buf)) {
+			break;
 		}
-		/* set the endianity global [HOTFIX] */
-		big_end = rz_bin_is_big_endian (bin);
-		// Actually parse the section
-		parse_line_raw (bin, buf, len, mode);
-		// k bin/cur/addrinfo/*
-		SdbListIter *iter;
-		SdbKv *kv;
-		SdbList *ls = sdb_foreach_list (binfile->sdb_addrinfo, false);
-		// Use the parsed information from _raw and transform it to more useful format
-		ls_foreach (ls, iter, kv) {
-			if (!strncmp (sdbkv_key (kv), "0x", 2)) {
-				ut64 addr;
-				RzBinDwarfRow *row;
-				int line;
-				char *file = strdup (sdbkv_value (kv));
-				if (!file) {
-					free (buf);
-					ls_free (ls);
-					rz_list_free (list);
-					return NULL;
+		const ut8 *unit_end = buf + unit_len;
+		ut16 version = READ16 (buf);
+		buf += 2; // padding
+		ut64 cu_count = READ32 (buf);
+		ut64 local_tu_count = READ32 (buf);
+		ut64 foreign_tu_count = READ32 (buf);
+		ut64 bucket_count = READ32 (buf);
+		ut64 name_count = READ32 (buf);
+		ut64 abbrev_size = READ32 (buf);
+		ut64 aug_size = READ32 (buf);
+		ut64 off_size = is_64bit ? 8 : 4;
+		// offsets of the arrays following the header
+		ut64 cus = aug_size;
+		ut64 str_offsets = cus + (cu_count + local_tu_count) * off_size + foreign_tu_count * 8;
+		if (bucket_count) {
+			str_offsets += (bucket_count + name_count) * 4;
+		}
+		ut64 entry_offsets = str_offsets + name_count * off_size;
+		ut64 abbrev_table = entry_offsets + name_count * off_size;
+		ut64 pool = abbrev_table + abbrev_size;
+		if (version != 5 || buf > unit_end || pool > (ut64)(unit_end - buf)) {
+			buf = unit_end;
+			continue;
+		}
+
+		// abbreviation code and where its attribute specifications start
+		rz_vector_clear (&abbrevs);
+		const ut8 *ab = buf + abbrev_table;
+		const ut8 *ab_end = buf + pool;
+		while (ab && ab < ab_end) {
+			ut64 a[2], idx, form;
+			ab = rz_uleb128 (ab, ab_end - ab, &a[0], NULL);
+			if (!ab || !a[0]) {
+				break;
+			}
+			ab = rz_uleb128 (ab, ab_end - ab, &a[1], NULL); // tag
+			if (!ab) {
+				break;
+			}
+			a[1] = ab - obuf;
+			do {
+				ab = rz_uleb128 (ab, ab_end - ab, &idx, NULL);
+				ab = ab ? rz_uleb128 (ab, ab_end - ab, &form, NULL) : NULL;
+			} while (ab && (idx || form));
+			rz_vector_push (&abbrevs, a);
+		}
+
+		ut64 i;
+		for (i = 0; i < name_count; i++) {
+			const ut8 *p = buf + str_offsets + i * off_size;
+			ut64 str_off = dwarf_read_offset (is_64bit, &p, unit_end);
+			p = buf + entry_offsets + i * off_size;
+			ut64 entry_off = dwarf_read_offset (is_64bit, &p, unit_end);
+			if (!info->debug_str || str_off >= info->debug_str_len || entry_off >= (ut64)(unit_end - buf) - pool) {
+				continue;
+			}
+			const char *name = (const char *)info->debug_str + str_off;
+			const ut8 *entry = buf + pool + entry_off;
+			while (entry && entry < unit_end) {
+				ut64 code;
+				entry = rz_uleb128 (entry, unit_end - entry, &code, NULL);
+				if (!entry || !code) {
+					break;
+				}
+				const ut8 *spec = NULL;
+				ut64 *a;
+				rz_vector_foreach (&abbrevs, a) {
+					if (a[0] == code) {
+						spec = obuf + a[1];
+						break;
+					}
 				}
-				char *tok = strchr (file, '|');
-				if (tok) {
-					*tok++ = 0;
-					line = atoi (tok);
-					addr = rz_num_math (NULL, sdbkv_key (kv));
-					row = row_new (addr, file, line, 0);
-					rz_list_append (list, row);
+				if (!spec) {
+					entry = NULL;
+					break;
 				}
-				free (file);
+				ut64 cu = cu_count == 1 ? 0 : UT64_MAX;
+				ut64 die = UT64_MAX;
+				bool type_unit = false;
+				for (;;) {
+					ut64 idx, form, val = 0;
+					spec = rz_uleb128 (spec, ab_end - spec, &idx, NULL);
+					spec = spec ? rz_uleb128 (spec, ab_end - spec, &form, NULL) : NULL;
+					if (!spec || (!idx && !form)) {
+						break;
+					}
+					entry = read_index_value (entry, unit_end, form, is_64bit, &val);
+					if (!entry) {
+						break;
+					}
+					if (idx == DW_IDX_compile_unit) {
+						cu = val;
+					} else if (idx == DW_IDX_type_unit) {
+						type_unit = true;
+					} else if (idx == DW_IDX_die_offset) {
+						die = val;
+					}
+				}
+				if (!entry) {
+					break;
+				}
+				if (type_unit || cu >= cu_count || die == UT64_MAX) {
+					continue;
+				}
+				p = buf + cus + cu * off_size;
+				ut64 cu_off = dwarf_read_offset (is_64bit, &p, unit_end);
+				size_t unit = unit_at_offset (info, cu_off);
+				if (unit != SIZE_MAX) {
+					// the DIE offset is relative to the unit
+					add_name (accel, name, cu_off + die, unit);
+				}
+			}
+		}
+		buf = unit_end;
+	}
+	rz_vector_fini (&abbrevs);
+}
+
+/*
+ * Reads the symbol and address tables of a .gdb_index section, versions 7
+ * and 8. It only tells which unit defines a symbol, not the DIE.
+ */
+static void load_gdb_index(const RzBinDwarfDebugInfo *info, RzBinDwarfInfoAccel *accel, ut8 *buf, size_t len) {
+	accel->gdb_index = buf;
+	if (len < 24) {
+		return;
+	}
+	ut32 version = rz_read_le32 (buf);
+	ut32 cu_list = rz_read_le32 (buf + 4);
+	ut32 tu_list = rz_read_le32 (buf + 8);
+	ut32 addr_area = rz_read_le32 (buf + 12);
+	ut32 sym_table = rz_read_le32 (buf + 16);
+	ut32 pool = rz_read_le32 (buf + 20);
+	if (version < 7 || version > 8 || cu_list > tu_list || tu_list > addr_area ||
+		addr_area > sym_table || sym_table > pool || pool > len) {
+		return;
+	}
+	size_t i, cu_count = (tu_list - cu_list) / 16;
+	size_t *units = cu_count ? RZ_NEWS (size_t, cu_count) : NULL;
+	if (!units) {
+		return;
+	}
+	for (i = 0; i < cu_count; i++) {
+		units[i] = unit_at_offset (info, rz_read_le64 (buf + cu_list + i * 16));
+	}
+	ut64 off;
+	for (off = addr_area; off + 20 <= sym_table; off += 20) {
+		ut32 cu = rz_read_le32 (buf + off + 16);
+		if (cu < cu_count && units[cu] != SIZE_MAX) {
+			add_addr (accel, rz_read_le64 (buf + off), rz_read_le64 (buf + off + 8), units[cu]);
+		}
+	}
+	for (off = sym_table; off + 8 <= pool; off += 8) {
+		ut64 name_off = pool + (ut64)rz_read_le32 (buf + off);
+		ut64 vec_off = pool + (ut64)rz_read_le32 (buf + off + 4);
+		if (name_off == pool && vec_off == pool) {
+			continue; // empty slot of the hash table
+		}
+		if (name_off >= len || vec_off + 4 > len) {
+			continue;
+		}
+		ut64 j, n = rz_read_le32 (buf + vec_off);
+		for (j = 0; j < n && vec_off + 8 + j * 4 <= len; j++) {
+			// the low 24 bits are the index of the unit, type units come after the compilation units
+			ut32 cu = rz_read_le32 (buf + vec_off + 4 + j * 4) & 0xffffff;
+			if (cu < cu_count && units[cu] != SIZE_MAX) {
+				add_name (accel, (const char *)buf + name_off, UT64_MAX, units[cu]);
+			}
+		}
+	}
+	free (units);
+}
+
+static void load_aranges(const RzBinDwarfDebugInfo *info, RzBinDwarfInfoAccel *accel, const ut8 *obuf, size_t len) {
+	const ut8 *buf = obuf;
+	const ut8 *buf_end = obuf + len;
+	while (buf + 4 < buf_end) {
+		const ut8 *start = buf;
+		bool is_64bit = false;
+		ut64 set_len = READ32 (buf);
+		if (set_len == DWARF_INIT_LEN_64) {
+			set_len = READ64 (buf);
+			is_64bit = true;
+		}
+		if (set_len > (ut64)(buf_end - buf)) {
+			break;
+		}
+		const ut8 *set_end = buf + set_len;
+		buf += 2; // version
+		ut64 cu_off = dwarf_read_offset (is_64bit, &buf, buf_end);
+		ut8 addr_size = READ8 (buf);
+		ut8 seg_size = READ8 (buf);
+		size_t unit = unit_at_offset (info, cu_off);
+		if ((addr_size != 4 && addr_size != 8) || seg_size || unit == SIZE_MAX) {
+			buf = set_end;
+			continue;
+		}
+		// tuples are aligned on their size from the start of the set
+		size_t tuple = addr_size * 2;
+		size_t pad = (buf - start) % tuple;
+		if (pad) {
+			buf += tuple - pad;
+		}
+		while (buf + tuple <= set_end) {
+			ut64 addr = addr_size == 8 ? rz_read_ble64 (buf, big_end) : rz_read_ble32 (buf, big_end);
+			ut64 length = addr_size == 8 ? rz_read_ble64 (buf + 8, big_end) : rz_read_ble32 (buf + 4, big_end);
+			buf += tuple;
+			if (!addr && !length) {
+				break;
+			}
+			add_addr (accel, addr, addr + length, unit);
+		}
+		buf = set_end;
+	}
+}
+
+static bool is_indexed_tag(ut64 tag) {
+	switch (tag) {
+	case DW_TAG_subprogram:
+	case DW_TAG_variable:
+	case DW_TAG_base_type:
+	case DW_TAG_typedef:
+	case DW_TAG_structure_type:
+	case DW_TAG_class_type:
+	case DW_TAG_union_type:
+	case DW_TAG_enumeration_type:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Walks the DIEs of a unit without storing them, for binaries that have no
+ * index sections. Names of definitions outside of functions are kept, along
+ * with the ranges of the unit and of its functions.
+ */
+static void prescan_comp_unit(RzBinDwarfDebugInfo *info, size_t idx, bool names, bool addrs) {
+	RzBinDwarfCompUnit *unit = &info->comp_units[idx];
+	const RzBinDwarfDebugAbbrev *da = info->abbrevs;
+	RzBinDwarfAbbrevDecl key = { .offset = unit->hdr.abbrev_offset };
+	RzBinDwarfAbbrevDecl *abbrev_start = da ? bsearch (&key, da->decls, da->count, sizeof (key), abbrev_cmp) : NULL;
+	if (!abbrev_start) {
+		return;
+	}
+	size_t first_abbr_idx = abbrev_start - da->decls;
+	const ut8 *buf = info->debug_info + unit->offset + (unit->hdr.is_64bit ? 12 : 4) + unit->hdr.header_size;
+	const ut8 *buf_end = buf + unit->hdr.length - unit->hdr.header_size;
+	int depth = 0, fn_depth = -1;
+
+	while (buf && buf < buf_end) {
+		ut64 offset = buf - info->debug_info;
+		ut64 abbr_code;
+		buf = rz_uleb128 (buf, buf_end - buf, &abbr_code, NULL);
+		if (!buf || abbr_code > da->count) {
+			return;
+		}
+		if (!abbr_code) {
+			if (--depth < fn_depth) {
+				fn_depth = -1;
 			}
+			continue;
+		}
+		ut64 abbr_idx = first_abbr_idx + abbr_code;
+		if (da->count < abbr_idx) {
+			return;
 		}
-		ls_free (ls);
+		RzBinDwarfAbbrevDecl *abbrev = &da->decls[abbr_idx - 1];
+		const char *name = NULL;
+		ut64 low = UT64_MAX, high = 0;
+		bool high_is_size = false, declaration = false;
+		size_t i;
+		for (i = 0; i + 1 < abbrev->count; i++) {
+			RzBinDwarfAttrValue val = { 0 };
+			buf = parse_attr_value (buf, buf_end - buf, &abbrev->defs[i], &val, &unit->hdr, info->debug_str, info->debug_str_len);
+			if (!buf) {
+				return;
+			}
+			switch (val.attr_name) {
+			case DW_AT_name:
+				name = val.kind == DW_AT_KIND_STRING ? val.string.content : NULL;
+				break;
+			case DW_AT_declaration:
+				declaration = val.flag;
+				break;
+			case DW_AT_low_pc:
+				low = val.kind == DW_AT_KIND_ADDRESS ? val.address : UT64_MAX;
+				break;
+			case DW_AT_high_pc:
+				// since DWARF4 it may be the size of the range
+				high_is_size = val.kind == DW_AT_KIND_CONSTANT;
+				high = high_is_size ? val.uconstant : val.address;
+				break;
+			default:
+				break;
+			}
+		}
+		if (names && name && !declaration && fn_depth < 0 && is_indexed_tag (abbrev->tag)) {
+			add_name (info->accel, name, offset, idx);
+		}
+		if (addrs && low != UT64_MAX && (abbrev->tag == DW_TAG_compile_unit || abbrev->tag == DW_TAG_subprogram)) {
+			add_addr (info->accel, low, high_is_size ? low + high : high, idx);
+		}
+		if (abbrev->has_children) {
+			depth++;
+			if (abbrev->tag == DW_TAG_subprogram && fn_depth < 0) {
+				fn_depth = depth;
+			}
+		}
+	}
+}
+
+// Reads DW_AT_comp_dir from the first DIE of the unit, without decoding the others
+static const char *unit_comp_dir(RzBinDwarfDebugInfo *info, size_t idx) {
+	RzBinDwarfCompUnit *unit = &info->comp_units[idx];
+	const RzBinDwarfDebugAbbrev *da = info->abbrevs;
+	RzBinDwarfAbbrevDecl key = { .offset = unit->hdr.abbrev_offset };
+	RzBinDwarfAbbrevDecl *abbrev_start = da ? bsearch (&key, da->decls, da->count, sizeof (key), abbrev_cmp) : NULL;
+	if (!abbrev_start) {
+		return NULL;
+	}
+	const ut8 *buf = info->debug_info + unit->offset + (unit->hdr.is_64bit ? 12 : 4) + unit->hdr.header_size;
+	const ut8 *buf_end = buf + unit->hdr.length - unit->hdr.header_size;
+	ut64 abbr_code;
+	buf = buf < buf_end ? rz_uleb128 (buf, buf_end - buf, &abbr_code, NULL) : NULL;
+	ut64 abbr_idx = (abbrev_start - da->decls) + abbr_code;
+	if (!buf || !abbr_code || da->count < abbr_idx) {
+		return NULL;
+	}
+	RzBinDwarfAbbrevDecl *abbrev = &da->decls[abbr_idx - 1];
+	size_t i;
+	for (i = 0; buf && i + 1 < abbrev->count; i++) {
+		RzBinDwarfAttrValue val = { 0 };
+		buf = parse_attr_value (buf, buf_end - buf, &abbrev->defs[i], &val, &unit->hdr, info->debug_str, info->debug_str_len);
+		if (buf && val.attr_name == DW_AT_comp_dir && val.kind == DW_AT_KIND_STRING && val.string.content &&
+			(val.attr_form == DW_FORM_strp || val.attr_form == DW_FORM_string)) {
+			return val.string.content;
+		}
+	}
+	return NULL;
+}
+
+static int name_entry_cmp(const void *a, const void *b) {
+	const DwarfNameEntry *x = a, *y = b;
+	int r = strcmp (x->name, y->name);
+	if (r) {
+		return r;
+	}
+	return x->unit != y->unit ? (x->unit < y->unit ? -1 : 1) : (x->die < y->die ? -1 : x->die > y->die);
+}
+
+static int addr_entry_cmp(const void *a, const void *b) {
+	const DwarfAddrEntry *x = a, *y = b;
+	if (x->low != y->low) {
+		return x->low < y->low ? -1 : 1;
+	}
+	return x->high < y->high ? -1 : x->high > y->high;
+}
+
+static void sort_names(RzBinDwarfInfoAccel *accel) {
+	qsort (accel->names.a, rz_vector_len (&accel->names), sizeof (DwarfNameEntry), name_entry_cmp);
+	rz_vector_shrink (&accel->names);
+	accel->names_ready = true;
+}
+
+static void sort_addrs(RzBinDwarfInfoAccel *accel) {
+	DwarfAddrEntry *a = accel->addrs.a;
+	size_t i, n = rz_vector_len (&accel->addrs);
+	qsort (a, n, sizeof (DwarfAddrEntry), addr_entry_cmp);
+	for (i = 1; i < n; i++) {
+		a[i].max_high = RZ_MAX (a[i].high, a[i - 1].max_high);
+	}
+	rz_vector_shrink (&accel->addrs);
+	accel->addrs_ready = true;
+}
+
+// Builds the tables that no index section provided
+static void prescan_info(RzBinDwarfDebugInfo *info) {
+	RzBinDwarfInfoAccel *accel = info->accel;
+	bool names = !accel->names_ready, addrs = !accel->addrs_ready;
+	size_t i;
+	big_end = info->big_endian;
+	for (i = 0; i < info->count; i++) {
+		prescan_comp_unit (info, i, names, addrs);
+	}
+	if (names) {
+		sort_names (accel);
+	}
+	if (addrs) {
+		sort_addrs (accel);
+	}
+}
+
+/**
+ * @brief Indexes the compilation units of .debug_info without decoding them
+ *
+ * Only the unit headers and their first DIE are read, along with the
+ * .debug_names, .gdb_index and .debug_aranges sections when present. Units are then decoded on demand
+ * by the lookup functions, or all at once by rz_bin_dwarf_info_decode_all().
+ *
+ * @param da Parsed abbreviations, must outlive the returned info
+ * @param bin
+ * @return RzBinDwarfDebugInfo* Indexed units, NULL if error
+ */
+RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_index_info(RzBinDwarfDebugAbbrev *da, RzBin *bin) {
+	rz_return_val_if_fail (bin, NULL);
+	if (!da || !bin->cur || !getsection (bin, "debug_info")) {
+		return NULL;
+	}
+	RzBinDwarfDebugInfo *info = RZ_NEW0 (RzBinDwarfDebugInfo);
+	if (!info) {
+		return NULL;
+	}
+	if (init_debug_info (info) < 0) {
+		goto cleanup;
+	}
+	RzBinDwarfInfoAccel *accel = info->accel = RZ_NEW0 (RzBinDwarfInfoAccel);
+	if (!accel) {
+		goto cleanup;
+	}
+	rz_vector_init (&accel->names, sizeof (DwarfNameEntry), NULL, NULL);
+	rz_vector_init (&accel->addrs, sizeof (DwarfAddrEntry), NULL, NULL);
+	info->debug_info = read_section (bin, "debug_info", &info->debug_info_len);
+	if (!info->debug_info) {
+		goto cleanup;
+	}
+	info->debug_str = read_section (bin, "debug_str", &info->debug_str_len);
+	info->abbrevs = da;
+	/* set the endianity global [HOTFIX] */
+	big_end = info->big_endian = rz_bin_is_big_endian (bin);
+	if (!index_comp_units (info)) {
+		goto cleanup;
+	}
+	// TODO: there is a comp dir per unit, only the last one is kept
+	size_t i;
+	for (i = 0; i < info->count; i++) {
+		const char *comp_dir = unit_comp_dir (info, i);
+		if (comp_dir) {
+			sdb_set (bin->cur->sdb_addrinfo, "DW_AT_comp_dir", comp_dir, 0);
+		}
+	}
+
+	size_t len;
+	ut8 *buf = read_section (bin, "debug_names", &len);
+	if (buf) {
+		load_debug_names (info, accel, buf, len);
 		free (buf);
 	}
+	buf = read_section (bin, "gdb_index", &len);
+	if (buf) {
+		if (rz_vector_empty (&accel->names)) {
+			load_gdb_index (info, accel, buf, len);
+		} else {
+			free (buf);
+		}
+	}
+	if (rz_vector_empty (&accel->addrs)) {
+		buf = read_section (bin, "debug_aranges", &len);
+		if (buf) {
+			load_aranges (info, accel, buf, len);
+			free (buf);
+		}
+	}
+	// empty tables are built from the DIEs on first use
+	if (!rz_vector_empty (&accel->names)) {
+		sort_names (accel);
+	}
+	if (!rz_vector_empty (&accel->addrs)) {
+		sort_addrs (accel);
+	}
+	return info;
+
+cleanup:
+	rz_bin_dwarf_free_debug_info (info);
+	return NULL;
+}
+
+typedef struct {
+	RzBinDwarfDebugInfo *info;
+	size_t from;
+	size_t to;
+	bool failed;
+} DecodeJob;
+
+static void decode_job(void *user) {
+	DecodeJob *job = user;
+	size_t i;
+	for (i = job->from; i < job->to && !job->failed; i++) {
+		RzBinDwarfCompUnit *unit = &job->info->comp_units[i];
+		job->failed = !unit->dies && !decode_comp_unit (job->info, unit);
+	}
+}
+
+/**
+ * @brief Decodes all units not decoded yet, spreading them over threads
+ *
+ * @param info
+ * @param threads Number of threads to use, 0 for one per core
+ * @return bool false if a unit is malformed
+ */
+RZ_API bool rz_bin_dwarf_info_decode_all(RzBinDwarfDebugInfo *info, int threads) {
+	rz_return_val_if_fail (info, false);
+	if (threads < 1) {
+		threads = rz_th_ncores ();
+	}
+	big_end = info->big_endian;
+	// a few jobs per thread, so that a large unit does not keep a single thread busy
+	size_t i, njobs = RZ_MIN (info->count, (size_t)threads * 4);
+	DecodeJob *jobs = threads > 1 && njobs > 1 ? RZ_NEWS0 (DecodeJob, njobs) : NULL;
+	RzThreadPool *pool = jobs ? rz_th_pool_new (threads) : NULL;
+	if (!pool) {
+		free (jobs);
+		DecodeJob job = { info, 0, info->count, false };
+		decode_job (&job);
+		return !job.failed;
+	}
+	for (i = 0; i < njobs; i++) {
+		jobs[i].info = info;
+		jobs[i].from = info->count * i / njobs;
+		jobs[i].to = info->count * (i + 1) / njobs;
+		if (!rz_th_pool_add_job (pool, decode_job, &jobs[i])) {
+			decode_job (&jobs[i]);
+		}
+	}
+	rz_th_pool_wait (pool);
+	rz_th_pool_free (pool);
+	bool ok = true;
+	for (i = 0; i < njobs; i++) {
+		ok &= !jobs[i].failed;
+	}
+	free (jobs);
+	return ok;
+}
+
+/**
+ * @brief Returns the unit at index \p idx, decoding it if needed
+ */
+RZ_API RzBinDwarfCompUnit *rz_bin_dwarf_info_unit(RzBinDwarfDebugInfo *info, size_t idx) {
+	rz_return_val_if_fail (info, NULL);
+	if (idx >= info->count) {
+		return NULL;
+	}
+	RzBinDwarfCompUnit *unit = &info->comp_units[idx];
+	if (!unit->dies) {
+		big_end = info->big_endian;
+		if (!decode_comp_unit (info, unit)) {
+			return NULL;
+		}
+	}
+	return unit;
+}
+
+/**
+ * @brief Finds the DIE at \p offset in .debug_info among the decoded units
+ */
+RZ_API const RzBinDwarfDie *rz_bin_dwarf_info_find_die(const RzBinDwarfDebugInfo *info, ut64 offset) {
+	rz_return_val_if_fail (info, NULL);
+	size_t idx = unit_containing (info, offset);
+	if (idx == SIZE_MAX) {
+		return NULL;
+	}
+	const RzBinDwarfCompUnit *unit = &info->comp_units[idx];
+	// DIEs are stored in the order of the section
+	size_t lo = 0, hi = unit->dies ? unit->count : 0;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (unit->dies[mid].offset < offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo < unit->count && unit->dies[lo].offset == offset ? &unit->dies[lo] : NULL;
+}
+
+/**
+ * @brief Returns the DIE at \p offset in .debug_info, decoding its unit if needed
+ */
+RZ_API const RzBinDwarfDie *rz_bin_dwarf_info_die(RzBinDwarfDebugInfo *info, ut64 offset) {
+	rz_return_val_if_fail (info, NULL);
+	size_t idx = unit_containing (info, offset);
+	if (idx == SIZE_MAX || !rz_bin_dwarf_info_unit (info, idx)) {
+		return NULL;
+	}
+	return rz_bin_dwarf_info_find_die (info, offset);
+}
+
+/**
+ * @brief Returns the unit whose code covers \p addr, decoding it if needed
+ *
+ * The ranges come from .gdb_index or .debug_aranges, or from the unit and
+ * function DIEs when there are none.
+ */
+RZ_API RzBinDwarfCompUnit *rz_bin_dwarf_info_unit_at(RzBinDwarfDebugInfo *info, ut64 addr) {
+	rz_return_val_if_fail (info, NULL);
+	RzBinDwarfInfoAccel *accel = info->accel;
+	if (!accel->addrs_ready) {
+		prescan_info (info);
+	}
+	DwarfAddrEntry *a = accel->addrs.a;
+	size_t lo = 0, hi = rz_vector_len (&accel->addrs);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (a[mid].low <= addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	// ranges may overlap, walk back as long as one could still cover addr
+	for (; lo > 0 && a[lo - 1].max_high > addr; lo--) {
+		if (addr < a[lo - 1].high) {
+			return rz_bin_dwarf_info_unit (info, a[lo - 1].unit);
+		}
+	}
+	return NULL;
+}
+
+static const RzBinDwarfDie *find_name_in_unit(RzBinDwarfDebugInfo *info, size_t idx, const char *name) {
+	RzBinDwarfCompUnit *unit = rz_bin_dwarf_info_unit (info, idx);
+	size_t i, j;
+	for (i = 0; unit && i < unit->count; i++) {
+		const RzBinDwarfDie *die = &unit->dies[i];
+		bool match = false, declaration = false;
+		for (j = 0; j < die->count; j++) {
+			const RzBinDwarfAttrValue *val = &die->attr_values[j];
+			if (val->attr_name == DW_AT_name && val->kind == DW_AT_KIND_STRING) {
+				match = val->string.content && !strcmp (val->string.content, name);
+			} else if (val->attr_name == DW_AT_declaration) {
+				declaration = val->flag;
+			}
+		}
+		if (match && !declaration && is_indexed_tag (die->tag)) {
+			return die;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Finds the DIE defining \p name, decoding only the units needed
+ *
+ * The names come from .debug_names or .gdb_index, or from the DIEs outside of
+ * functions when there are none.
+ */
+RZ_API const RzBinDwarfDie *rz_bin_dwarf_info_find_name(RzBinDwarfDebugInfo *info, const char *name) {
+	rz_return_val_if_fail (info && name, NULL);
+	RzBinDwarfInfoAccel *accel = info->accel;
+	if (!accel->names_ready) {
+		prescan_info (info);
+	}
+	DwarfNameEntry *a = accel->names.a;
+	size_t lo = 0, hi = rz_vector_len (&accel->names);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (strcmp (a[mid].name, name) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	for (; lo < rz_vector_len (&accel->names) && !strcmp (a[lo].name, name); lo++) {
+		const RzBinDwarfDie *die = a[lo].die != UT64_MAX
+			? rz_bin_dwarf_info_die (info, a[lo].die)
+			: find_name_in_unit (info, a[lo].unit, name);
+		if (die) {
+			return die;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Parses .debug_info section
+ *
+ * All units are decoded, on bin.dwarf.threads threads, see
+ * rz_bin_dwarf_index_info() to only decode the ones that are looked up.
+ *
+ * @param da Parsed abbreviations
+ * @param bin
+ * @param mode RZ_MODE_PRINT to print
+ * @return RzBinDwarfDebugInfo* Parsed information, NULL if error
+ */
+RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info(RzBinDwarfDebugAbbrev *da, RzBin *bin, int mode) {
+	RzBinDwarfDebugInfo *info = rz_bin_dwarf_index_info (da, bin);
+	if (!info) {
+		return NULL;
+	}
+	if (!rz_bin_dwarf_info_decode_all (info, bin->dwarf_threads)) {
+		rz_bin_dwarf_free_debug_info (info);
+		return NULL;
+	}
+	if (mode == RZ_MODE_PRINT) {
+		print_debug_info (info, bin->cb_printf);
+	}
+	return info;
+}
+
+static RzBinDwarfRow *row_new(ut64 addr, const char *file, int line, int col) {
+	RzBinDwarfRow *row = RZ_NEW0 (RzBinDwarfRow);
+	if (!row) {
+		return NULL;
+	}
+	row->file = strdup (file);
+	row->address = addr;
+	row->line = line;
+	row->column = col;
+	return row;
+}
+
+static void row_free(void *p) {
+	RzBinDwarfRow *row = (RzBinDwarfRow*)p;
+	free (row->file);
+	free (row);
+}
+
+/**
+ * \brief Parses .debug_line into a line table and attaches it to the current bin file
+ *
+ * The table replaces the one of a previous call, it is owned by the bin file.
+ * Returns NULL if the rows could not all be kept, e.g. on OOM.
+ *
+ * The rows are only kept in this table, they are not added to the addrinfo
+ * sdb of the bin file anymore, which is left to the other sources of line
+ * info and to the user entries.
+ */
+RZ_API RzBinDwarfLineTable *rz_bin_dwarf_load_lines(RzBin *bin, int mode) {
+	rz_return_val_if_fail (bin, NULL);
+	RzBinSection *section = getsection (bin, "debug_line");
+	RzBinFile *binfile = bin->cur;
+	if (!binfile || !section || section->size < 1 || section->size > ST32_MAX) {
+		return NULL;
+	}
+	int len = section->size;
+	ut8 *buf = calloc (1, len + 1);
+	if (!buf) {
+		return NULL;
+	}
+	if (rz_buf_read_at (binfile->buf, section->paddr, buf, len) != len) {
+		free (buf);
+		return NULL;
+	}
+	RzBinDwarfLineTable *lines = rz_bin_dwarf_line_table_new ();
+	if (!lines) {
+		free (buf);
+		return NULL;
+	}
+	/* set the endianity global [HOTFIX] */
+	big_end = rz_bin_is_big_endian (bin);
+	char *comp_dir = binfile->sdb_addrinfo? sdb_get (binfile->sdb_addrinfo, "DW_AT_comp_dir", 0): NULL;
+	// Actually parse the section
+	bool ok = parse_line_raw (bin, buf, len, lines, comp_dir, mode)
+		&& rz_bin_dwarf_line_table_finish (lines);
+	free (comp_dir);
+	free (buf);
+	if (!ok) {
+		rz_bin_dwarf_line_table_free (lines);
+		return NULL;
+	}
+	rz_bin_dwarf_line_table_free (binfile->dwarf_lines);
+	binfile->dwarf_lines = lines;
+	return lines;
+}
+
+RZ_API RzList *rz_bin_dwarf_parse_line(RzBin *bin, int mode) {
+	RzBinDwarfLineTable *lines = rz_bin_dwarf_load_lines (bin, mode);
+	if (!lines) {
+		return NULL;
+	}
+	RzList *list = rz_list_newf (row_free);
+	if (!list) {
+		return NULL;
+	}
+	// Use the parsed information from _raw and transform it to more useful format
+	RzBinDwarfLineEntry *e;
+	rz_vector_foreach (&lines->entries, e) {
+		RzBinDwarfRow *row = row_new (e->address, rz_bin_dwarf_line_table_file (lines, e->file), e->line, e->column);
+		if (!row) {
+			rz_list_free (list);
+			return NULL;
+		}
+		rz_list_append (list, row);
+	}
 	return list;
 }
 
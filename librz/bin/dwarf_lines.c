@@ -0,0 +1,292 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_bin.h>
+#include <rz_bin_dwarf.h>
+
+/**
+ * \brief Creates an empty line table
+ */
+RZ_API RzBinDwarfLineTable *rz_bin_dwarf_line_table_new(void) {
+	RzBinDwarfLineTable *t = RZ_NEW0 (RzBinDwarfLineTable);
+	if (!t) {
+		return NULL;
+	}
+	rz_vector_init (&t->entries, sizeof (RzBinDwarfLineEntry), NULL, NULL);
+	rz_pvector_init (&t->files, free);
+	t->file_ids = ht_pu_new0 ();
+	if (!t->file_ids) {
+		rz_bin_dwarf_line_table_free (t);
+		return NULL;
+	}
+	t->sorted = true;
+	t->finished = true;
+	return t;
+}
+
+RZ_API void rz_bin_dwarf_line_table_free(RzBinDwarfLineTable *t) {
+	if (!t) {
+		return;
+	}
+	rz_vector_fini (&t->entries);
+	rz_pvector_fini (&t->files);
+	ht_pu_free (t->file_ids);
+	free (t->by_line);
+	free (t);
+}
+
+/**
+ * \brief Returns the index of the file \p name in the table, adding it if needed
+ * \return the index or UT32_MAX on failure
+ */
+RZ_API ut32 rz_bin_dwarf_line_table_file_id(RzBinDwarfLineTable *t, const char *name) {
+	rz_return_val_if_fail (t && name, UT32_MAX);
+	bool found = false;
+	ut64 id = ht_pu_find (t->file_ids, name, &found);
+	if (found) {
+		return (ut32)id - 1;
+	}
+	char *dup = strdup (name);
+	if (!dup || !rz_pvector_push (&t->files, dup)) {
+		free (dup);
+		return UT32_MAX;
+	}
+	id = rz_pvector_len (&t->files);
+	ht_pu_insert (t->file_ids, name, id);
+	return (ut32)id - 1;
+}
+
+/**
+ * \brief Returns the name of the file at index \p file, or NULL
+ */
+RZ_API const char *rz_bin_dwarf_line_table_file(RzBinDwarfLineTable *t, ut32 file) {
+	rz_return_val_if_fail (t, NULL);
+	return file < rz_pvector_len (&t->files)? rz_pvector_at (&t->files, file): NULL;
+}
+
+/**
+ * \brief Appends a row, rows may come in any order until the table is finished
+ */
+RZ_API bool rz_bin_dwarf_line_table_add(RzBinDwarfLineTable *t, ut64 addr, ut32 file, ut32 line, ut32 column) {
+	rz_return_val_if_fail (t && file < rz_pvector_len (&t->files), false);
+	RzBinDwarfLineEntry e = { addr, file, line, column };
+	size_t n = rz_vector_len (&t->entries);
+	if (n && ((RzBinDwarfLineEntry *)rz_vector_index_ptr (&t->entries, n - 1))->address > addr) {
+		t->sorted = false;
+	}
+	if (!rz_vector_push (&t->entries, &e)) {
+		return false;
+	}
+	t->finished = false;
+	RZ_FREE (t->by_line);
+	return true;
+}
+
+/**
+ * \brief Appends all rows of \p other, which is left untouched
+ */
+RZ_API bool rz_bin_dwarf_line_table_merge(RzBinDwarfLineTable *t, RzBinDwarfLineTable *other) {
+	rz_return_val_if_fail (t && other, false);
+	size_t i, nfiles = rz_pvector_len (&other->files);
+	ut32 *ids = nfiles? RZ_NEWS (ut32, nfiles): NULL;
+	if (nfiles && !ids) {
+		return false;
+	}
+	for (i = 0; i < nfiles; i++) {
+		ids[i] = rz_bin_dwarf_line_table_file_id (t, rz_pvector_at (&other->files, i));
+		if (ids[i] == UT32_MAX) {
+			free (ids);
+			return false;
+		}
+	}
+	if (!rz_vector_reserve (&t->entries, rz_vector_len (&t->entries) + rz_vector_len (&other->entries))) {
+		free (ids);
+		return false;
+	}
+	RzBinDwarfLineEntry *e;
+	rz_vector_foreach (&other->entries, e) {
+		rz_bin_dwarf_line_table_add (t, e->address, ids[e->file], e->line, e->column);
+	}
+	free (ids);
+	return true;
+}
+
+/*
+ * Line programs emit each sequence in increasing address order, so the rows
+ * are made of a few long sorted runs: a natural merge sort is close to a
+ * single pass over them. It is also stable, which keeps the first row emitted
+ * for an address in front of the others.
+ */
+static bool sort_entries(RzBinDwarfLineEntry *a, size_t n) {
+	RzBinDwarfLineEntry *tmp = RZ_NEWS (RzBinDwarfLineEntry, n);
+	if (!tmp) {
+		return false;
+	}
+	RzBinDwarfLineEntry *src = a, *dst = tmp;
+	for (;;) {
+		size_t runs = 0, lo = 0;
+		while (lo < n) {
+			size_t mid = lo + 1;
+			while (mid < n && src[mid - 1].address <= src[mid].address) {
+				mid++;
+			}
+			size_t hi = mid < n? mid + 1: n;
+			while (hi < n && src[hi - 1].address <= src[hi].address) {
+				hi++;
+			}
+			size_t i = lo, j = mid, k = lo;
+			while (i < mid && j < hi) {
+				dst[k++] = src[j].address < src[i].address? src[j++]: src[i++];
+			}
+			memcpy (dst + k, src + i, (mid - i) * sizeof (*src));
+			k += mid - i;
+			memcpy (dst + k, src + j, (hi - j) * sizeof (*src));
+			runs++;
+			lo = hi;
+		}
+		RzBinDwarfLineEntry *swap = src;
+		src = dst;
+		dst = swap;
+		if (runs <= 1) {
+			break;
+		}
+	}
+	if (src != a) {
+		memcpy (a, src, n * sizeof (*a));
+	}
+	free (tmp);
+	return true;
+}
+
+/**
+ * \brief Sorts the rows by address, keeping only the first row seen for each address
+ */
+RZ_API bool rz_bin_dwarf_line_table_finish(RzBinDwarfLineTable *t) {
+	rz_return_val_if_fail (t, false);
+	size_t n = rz_vector_len (&t->entries);
+	if (t->finished) {
+		return true;
+	}
+	RzBinDwarfLineEntry *a = (RzBinDwarfLineEntry *)t->entries.a;
+	if (!t->sorted && n > 1 && !sort_entries (a, n)) {
+		return false;
+	}
+	size_t i, k = 0;
+	for (i = 0; i < n; i++) {
+		if (k && a[k - 1].address == a[i].address) {
+			continue;
+		}
+		a[k++] = a[i];
+	}
+	t->entries.len = k;
+	rz_vector_shrink (&t->entries);
+	t->sorted = true;
+	t->finished = true;
+	return true;
+}
+
+/**
+ * \brief Finds the row covering \p addr, that is the last one at or below it
+ *
+ * Callers that want an exact match have to compare the address of the row.
+ * The table must be finished.
+ */
+RZ_API const RzBinDwarfLineEntry *rz_bin_dwarf_line_table_get(RzBinDwarfLineTable *t, ut64 addr) {
+	rz_return_val_if_fail (t && t->finished, NULL);
+	RzBinDwarfLineEntry *a = (RzBinDwarfLineEntry *)t->entries.a;
+	size_t lo = 0, hi = rz_vector_len (&t->entries);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (a[mid].address <= addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo? &a[lo - 1]: NULL;
+}
+
+typedef struct {
+	ut32 file;
+	ut32 line;
+	ut32 idx;
+} LineKey;
+
+static int cmp_line_key(const void *pa, const void *pb) {
+	const LineKey *a = pa, *b = pb;
+	if (a->file != b->file) {
+		return a->file < b->file? -1: 1;
+	}
+	if (a->line != b->line) {
+		return a->line < b->line? -1: 1;
+	}
+	// rows are sorted by address, so the index orders the addresses
+	return a->idx < b->idx? -1: a->idx > b->idx;
+}
+
+static bool build_by_line(RzBinDwarfLineTable *t) {
+	size_t i, n = rz_vector_len (&t->entries);
+	LineKey *keys = RZ_NEWS (LineKey, n + 1);
+	t->by_line = RZ_NEWS (ut32, n + 1);
+	if (!keys || !t->by_line) {
+		free (keys);
+		RZ_FREE (t->by_line);
+		return false;
+	}
+	RzBinDwarfLineEntry *a = (RzBinDwarfLineEntry *)t->entries.a;
+	for (i = 0; i < n; i++) {
+		keys[i].file = a[i].file;
+		keys[i].line = a[i].line;
+		keys[i].idx = (ut32)i;
+	}
+	qsort (keys, n, sizeof (LineKey), cmp_line_key);
+	for (i = 0; i < n; i++) {
+		t->by_line[i] = keys[i].idx;
+	}
+	free (keys);
+	return true;
+}
+
+/**
+ * \brief Finds the lowest address generated for \p line of \p file
+ *
+ * The first call builds the reverse index, the table must be finished.
+ */
+RZ_API const RzBinDwarfLineEntry *rz_bin_dwarf_line_table_find(RzBinDwarfLineTable *t, const char *file, ut32 line) {
+	rz_return_val_if_fail (t && t->finished && file, NULL);
+	bool found = false;
+	ut64 id = ht_pu_find (t->file_ids, file, &found);
+	if (!found || (!t->by_line && !build_by_line (t))) {
+		return NULL;
+	}
+	ut32 fid = (ut32)id - 1;
+	RzBinDwarfLineEntry *a = (RzBinDwarfLineEntry *)t->entries.a;
+	size_t lo = 0, hi = rz_vector_len (&t->entries);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		RzBinDwarfLineEntry *e = &a[t->by_line[mid]];
+		if (e->file < fid || (e->file == fid && e->line < line)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo == rz_vector_len (&t->entries)) {
+		return NULL;
+	}
+	RzBinDwarfLineEntry *e = &a[t->by_line[lo]];
+	return e->file == fid && e->line == line? e: NULL;
+}
+
+/**
+ * \brief Removes the row at exactly \p addr
+ */
+RZ_API bool rz_bin_dwarf_line_table_del(RzBinDwarfLineTable *t, ut64 addr) {
+	rz_return_val_if_fail (t && t->finished, false);
+	const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (t, addr);
+	if (!e || e->address != addr) {
+		return false;
+	}
+	rz_vector_remove_at (&t->entries, e - (RzBinDwarfLineEntry *)t->entries.a, NULL);
+	RZ_FREE (t->by_line);
+	return true;
+}
@@ -33,6 +33,11 @@ RZ_IPI const char *rz_bin_lang_tostring(int lang);
 RZ_IPI int rz_bin_lang_type(RzBinFile *binfile, const char *def, const char *sym);
 RZ_IPI bool rz_bin_lang_swift(RzBinFile *binfile);
 
+RZ_IPI HtPP *rz_bin_demangle_cache_new(void);
+RZ_IPI void rz_bin_demangle_cache_clear(RzBin *bin);
+RZ_IPI void rz_bin_demangle_cxx_method(RzBinFile *bf, char *out, ut64 vaddr);
+RZ_IPI char *rz_bin_demangle_rust_fix(char *str);
+
 RZ_IPI void rz_bin_class_free(RzBinClass *c);
 RZ_IPI RzBinSymbol *rz_bin_class_add_method(RzBinFile *binfile, const char *classname, const char *name, int nargs);
 RZ_IPI void rz_bin_class_add_field(RzBinFile *binfile, const char *classname, const char *name);
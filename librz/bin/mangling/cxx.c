@@ -4,6 +4,42 @@
 #include "../i/private.h"
 #include "./cxx/demangle.h"
 
+/**
+ * \brief Add the method \p out, the output of the c++ demangler, to its class in \p bf
+ */
+RZ_IPI void rz_bin_demangle_cxx_method(RzBinFile *bf, char *out, ut64 vaddr) {
+	char *sign = (char *)strchr (out, '(');
+	if (!sign) {
+		return;
+	}
+	char *str = out;
+	char *ptr = NULL;
+	char *nerd = NULL;
+	for (;;) {
+		ptr = strstr (str, "::");
+		if (!ptr || ptr > sign) {
+			break;
+		}
+		nerd = ptr;
+		str = ptr + 1;
+	}
+	if (nerd && *nerd) {
+		*nerd = 0;
+		RzBinSymbol *sym = rz_bin_file_add_method (bf, out, nerd + 2, 0);
+		if (sym) {
+			if (sym->vaddr != 0 && sym->vaddr != vaddr) {
+				if (bf->rbin && bf->rbin->verbose) {
+					eprintf ("Dupped method found: %s\n", sym->name);
+				}
+			}
+			if (sym->vaddr == 0) {
+				sym->vaddr = vaddr;
+			}
+		}
+		*nerd = ':';
+	}
+}
+
 RZ_API char *rz_bin_demangle_cxx(RzBinFile *bf, const char *str, ut64 vaddr) {
 	// DMGL_TYPES | DMGL_PARAMS | DMGL_ANSI | DMGL_VERBOSE
 	// | DMGL_RET_POSTFIX | DMGL_TYPES;
@@ -50,38 +86,8 @@ RZ_API char *rz_bin_demangle_cxx(RzBinFile *bf, const char *str, ut64 vaddr) {
 	char *out = NULL;
 #endif
 	free (tmpstr);
-	if (out) {
-		char *sign = (char *)strchr (out, '(');
-		if (sign) {
-			char *str = out;
-			char *ptr = NULL;
-			char *nerd = NULL;
-			for (;;) {
-				ptr = strstr (str, "::");
-				if (!ptr || ptr > sign) {
-					break;
-				}
-				nerd = ptr;
-				str = ptr + 1;
-			}
-			if (nerd && *nerd) {
-				*nerd = 0;
-				if (bf) {
-					RzBinSymbol *sym = rz_bin_file_add_method (bf, out, nerd + 2, 0);
-					if (sym) {
-						if (sym->vaddr != 0 && sym->vaddr != vaddr) {
-							if (bf && bf->rbin && bf->rbin->verbose) {
-								eprintf ("Dupped method found: %s\n", sym->name);
-							}
-						}
-						if (sym->vaddr == 0) {
-							sym->vaddr = vaddr;
-						}
-					}
-				}
-				*nerd = ':';
-			}
-		}
+	if (out && bf) {
+		rz_bin_demangle_cxx_method (bf, out, vaddr);
 	}
 	return out;
 }
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <rz_bin.h>
+#include "../i/private.h"
 
 #define RS(from, to) (replace_seq ((const char **)&in, &out, (const char *)(from), to))
 
@@ -20,11 +21,16 @@ static bool replace_seq (const char **in, char **out, const char *seq, char valu
 }
 
 RZ_API char *rz_bin_demangle_rust (RzBinFile *binfile, const char *sym, ut64 vaddr) {
+	return rz_bin_demangle_rust_fix (rz_bin_demangle_cxx (binfile, sym, vaddr));
+}
+
+/**
+ * \brief Turn \p str, the c++ demangling of a rust symbol, into rust syntax, in place
+ */
+RZ_IPI char *rz_bin_demangle_rust_fix(char *str) {
 	int len;
-	char *str, *out, *in;
+	char *out, *in;
 
-	str = rz_bin_demangle_cxx (binfile, sym, vaddr);
-	
 	if (!str) {
 		return str;
 	}
@@ -15,8 +15,18 @@ static bool get_line(RzBinFile *bf, ut64 addr, char *file, int len, int *line) {
 				*p = '\0';
 				strncpy (file, ret, len);
 				*line = atoi (p + 1);
+				free (ret);
 				return true;
 			}
+			free (ret);
+		}
+	}
+	if (bf->dwarf_lines) {
+		const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (bf->dwarf_lines, addr);
+		if (e && e->address == addr) {
+			rz_str_ncpy (file, rz_bin_dwarf_line_table_file (bf->dwarf_lines, e->file), len);
+			*line = e->line;
+			return true;
 		}
 	}
 	return false;
@@ -10,13 +10,15 @@
 #include <stdarg.h>
 
 #define COUNT_LINES 1
-#define CTX(x) I.context->x
+#define CTX(x) rz_cons_context ()->x
 
 RZ_LIB_VERSION (rz_cons);
 
 static RzConsContext rz_cons_context_default = {{{{0}}}};
 static RzCons rz_cons_instance = {0};
 #define I rz_cons_instance
+// the context of the calling thread when it is not the shared one, see rz_cons_context_load_thread()
+static RZ_TLS RzConsContext *thread_context = NULL;
 
 //this structure goes into cons_stack when rz_cons_push/pop
 typedef struct {
@@ -60,20 +62,20 @@ static RzConsStack *cons_stack_dump(bool recreate) {
 		}
 		data->grep = RZ_NEW0 (RzConsGrep);
 		if (data->grep) {
-			memcpy (data->grep, &I.context->grep, sizeof (RzConsGrep));
-			if (I.context->grep.str) {
-				data->grep->str = strdup (I.context->grep.str);
+			memcpy (data->grep, &rz_cons_context ()->grep, sizeof (RzConsGrep));
+			if (rz_cons_context ()->grep.str) {
+				data->grep->str = strdup (rz_cons_context ()->grep.str);
 			}
 		}
-		if (recreate && I.context->buffer_sz > 0) {
-			I.context->buffer = malloc (I.context->buffer_sz);
-			if (!I.context->buffer) {
-				I.context->buffer = data->buf;
+		if (recreate && rz_cons_context ()->buffer_sz > 0) {
+			rz_cons_context ()->buffer = malloc (rz_cons_context ()->buffer_sz);
+			if (!rz_cons_context ()->buffer) {
+				rz_cons_context ()->buffer = data->buf;
 				free (data);
 				return NULL;
 			}
 		} else {
-			I.context->buffer = NULL;
+			rz_cons_context ()->buffer = NULL;
 		}
 	}
 	return data;
@@ -82,15 +84,15 @@ static RzConsStack *cons_stack_dump(bool recreate) {
 static void cons_stack_load(RzConsStack *data, bool free_current) {
 	rz_return_if_fail (data);
 	if (free_current) {
-		free (I.context->buffer);
+		free (rz_cons_context ()->buffer);
 	}
-	I.context->buffer = data->buf;
+	rz_cons_context ()->buffer = data->buf;
 	data->buf = NULL;
-	I.context->buffer_len = data->buf_len;
-	I.context->buffer_sz = data->buf_size;
+	rz_cons_context ()->buffer_len = data->buf_len;
+	rz_cons_context ()->buffer_sz = data->buf_size;
 	if (data->grep) {
-		free (I.context->grep.str);
-		memcpy (&I.context->grep, data->grep, sizeof (RzConsGrep));
+		free (rz_cons_context ()->grep.str);
+		memcpy (&rz_cons_context ()->grep, data->grep, sizeof (RzConsGrep));
 	}
 }
 
@@ -167,7 +169,7 @@ static inline void __cons_write(const char *obuf, int olen) {
 
 RZ_API RzColor rz_cons_color_random(ut8 alpha) {
 	RzColor rcolor = {0};
-	if (I.context->color_mode > COLOR_MODE_16) {
+	if (rz_cons_context ()->color_mode > COLOR_MODE_16) {
 		rcolor.r = rz_num_rand (0xff);
 		rcolor.g = rz_num_rand (0xff);
 		rcolor.b = rz_num_rand (0xff);
@@ -279,7 +281,7 @@ RZ_API RzCons *rz_cons_singleton(void) {
 }
 
 RZ_API void rz_cons_break_clear(void) {
-	I.context->breaked = false;
+	rz_cons_context ()->breaked = false;
 }
 
 RZ_API void rz_cons_context_break_push(RzConsContext *context, RzConsBreak cb, void *user, bool sig) {
@@ -332,15 +334,15 @@ RZ_API void rz_cons_context_break_pop(RzConsContext *context, bool sig) {
 }
 
 RZ_API void rz_cons_break_push(RzConsBreak cb, void *user) {
-	rz_cons_context_break_push (I.context, cb, user, true);
+	rz_cons_context_break_push (rz_cons_context (), cb, user, true);
 }
 
 RZ_API void rz_cons_break_pop(void) {
-	rz_cons_context_break_pop (I.context, true);
+	rz_cons_context_break_pop (rz_cons_context (), true);
 }
 
 RZ_API bool rz_cons_is_interactive(void) {
-	return I.context->is_interactive;
+	return rz_cons_context ()->is_interactive;
 }
 
 RZ_API bool rz_cons_default_context_is_interactive(void) {
@@ -353,12 +355,12 @@ RZ_API bool rz_cons_is_breaked(void) {
 	}
 	if (I.timeout) {
 		if (rz_time_now_mono () > I.timeout) {
-			I.context->breaked = true;
+			rz_cons_context ()->breaked = true;
 			eprintf ("\nTimeout!\n");
 			I.timeout = 0;
 		}
 	}
-	return I.context->breaked;
+	return rz_cons_context ()->breaked;
 }
 
 RZ_API int rz_cons_get_cur_line(void) {
@@ -399,18 +401,18 @@ RZ_API void rz_cons_break_timeout(int timeout) {
 }
 
 RZ_API void rz_cons_break_end(void) {
-	I.context->breaked = false;
+	rz_cons_context ()->breaked = false;
 	I.timeout = 0;
 #if __UNIX__
 	rz_sys_signal (SIGINT, SIG_IGN);
 #endif
-	if (!rz_stack_is_empty (I.context->break_stack)) {
+	if (!rz_stack_is_empty (rz_cons_context ()->break_stack)) {
 		// free all the stack
-		rz_stack_free (I.context->break_stack);
+		rz_stack_free (rz_cons_context ()->break_stack);
 		// create another one
-		I.context->break_stack = rz_stack_newf (6, break_stack_free);
-		I.context->event_interrupt_data = NULL;
-		I.context->event_interrupt = NULL;
+		rz_cons_context ()->break_stack = rz_stack_newf (6, break_stack_free);
+		rz_cons_context ()->event_interrupt_data = NULL;
+		rz_cons_context ()->event_interrupt = NULL;
 	}
 }
 
@@ -543,7 +545,7 @@ RZ_API RzCons *rz_cons_new(void) {
 	I.lines = 0;
 
 	I.context = &rz_cons_context_default;
-	cons_context_init (I.context, NULL);
+	cons_context_init (rz_cons_context (), NULL);
 
 	rz_cons_get_size (&I.pagesize);
 	I.num = NULL;
@@ -601,11 +603,11 @@ RZ_API RzCons *rz_cons_free(void) {
 		rz_line_free ();
 		I.line = NULL;
 	}
-	RZ_FREE (I.context->buffer);
+	RZ_FREE (rz_cons_context ()->buffer);
 	RZ_FREE (I.break_word);
-	cons_context_deinit (I.context);
-	RZ_FREE (I.context->lastOutput);
-	I.context->lastLength = 0;
+	cons_context_deinit (rz_cons_context ());
+	RZ_FREE (rz_cons_context ()->lastOutput);
+	rz_cons_context ()->lastLength = 0;
 	RZ_FREE (I.pager);
 	return NULL;
 }
@@ -616,7 +618,7 @@ static bool palloc(int moar) {
 	if (moar <= 0) {
 		return false;
 	}
-	if (!I.context->buffer) {
+	if (!rz_cons_context ()->buffer) {
 		int new_sz;
 		if ((INT_MAX - MOAR) < moar) {
 			return false;
@@ -624,22 +626,22 @@ static bool palloc(int moar) {
 		new_sz = moar + MOAR;
 		temp = calloc (1, new_sz);
 		if (temp) {
-			I.context->buffer_sz = new_sz;
-			I.context->buffer = temp;
-			I.context->buffer[0] = '\0';
+			rz_cons_context ()->buffer_sz = new_sz;
+			rz_cons_context ()->buffer = temp;
+			rz_cons_context ()->buffer[0] = '\0';
 		}
-	} else if (moar + I.context->buffer_len > I.context->buffer_sz) {
+	} else if (moar + rz_cons_context ()->buffer_len > rz_cons_context ()->buffer_sz) {
 		char *new_buffer;
-		int old_buffer_sz = I.context->buffer_sz;
-		if ((INT_MAX - MOAR - moar) < I.context->buffer_sz) {
+		int old_buffer_sz = rz_cons_context ()->buffer_sz;
+		if ((INT_MAX - MOAR - moar) < rz_cons_context ()->buffer_sz) {
 			return false;
 		}
-		I.context->buffer_sz += moar + MOAR;
-		new_buffer = realloc (I.context->buffer, I.context->buffer_sz);
+		rz_cons_context ()->buffer_sz += moar + MOAR;
+		new_buffer = realloc (rz_cons_context ()->buffer, rz_cons_context ()->buffer_sz);
 		if (new_buffer) {
-			I.context->buffer = new_buffer;
+			rz_cons_context ()->buffer = new_buffer;
 		} else {
-			I.context->buffer_sz = old_buffer_sz;
+			rz_cons_context ()->buffer_sz = old_buffer_sz;
 			return false;
 		}
 	}
@@ -729,40 +731,40 @@ static void cons_grep_reset(RzConsGrep *grep) {
 }
 
 RZ_API void rz_cons_reset(void) {
-	if (I.context->buffer) {
-		I.context->buffer[0] = '\0';
+	if (rz_cons_context ()->buffer) {
+		rz_cons_context ()->buffer[0] = '\0';
 	}
-	I.context->buffer_len = 0;
+	rz_cons_context ()->buffer_len = 0;
 	I.lines = 0;
-	I.lastline = I.context->buffer;
-	cons_grep_reset (&I.context->grep);
+	I.lastline = rz_cons_context ()->buffer;
+	cons_grep_reset (&rz_cons_context ()->grep);
 	CTX (pageable) = true;
 }
 
 RZ_API const char *rz_cons_get_buffer(void) {
 	//check len otherwise it will return trash
-	return I.context->buffer_len? I.context->buffer : NULL;
+	return rz_cons_context ()->buffer_len? rz_cons_context ()->buffer : NULL;
 }
 
 RZ_API int rz_cons_get_buffer_len(void) {
-	return I.context->buffer_len;
+	return rz_cons_context ()->buffer_len;
 }
 
 RZ_API void rz_cons_filter(void) {
 	/* grep */
-	if (I.filter || I.context->grep.nstrings > 0 || I.context->grep.tokens_used || I.context->grep.less || I.context->grep.json) {
+	if (I.filter || rz_cons_context ()->grep.nstrings > 0 || rz_cons_context ()->grep.tokens_used || rz_cons_context ()->grep.less || rz_cons_context ()->grep.json) {
 		(void)rz_cons_grepbuf ();
 		I.filter = false;
 	}
 	/* html */
 	if (I.is_html) {
 		int newlen = 0;
-		char *input = rz_str_ndup (I.context->buffer, I.context->buffer_len);
+		char *input = rz_str_ndup (rz_cons_context ()->buffer, rz_cons_context ()->buffer_len);
 		char *res = rz_cons_html_filter (input, &newlen);
-		free (I.context->buffer);
-		I.context->buffer = res;
-		I.context->buffer_len = newlen;
-		I.context->buffer_sz = newlen;
+		free (rz_cons_context ()->buffer);
+		rz_cons_context ()->buffer = res;
+		rz_cons_context ()->buffer_len = newlen;
+		rz_cons_context ()->buffer_sz = newlen;
 		free (input);
 	}
 	if (I.was_html) {
@@ -772,25 +774,25 @@ RZ_API void rz_cons_filter(void) {
 }
 
 RZ_API void rz_cons_push(void) {
-	if (!I.context->cons_stack) {
+	if (!rz_cons_context ()->cons_stack) {
 		return;
 	}
 	RzConsStack *data = cons_stack_dump (true);
 	if (!data) {
 		return;
 	}
-	rz_stack_push (I.context->cons_stack, data);
-	I.context->buffer_len = 0;
-	if (I.context->buffer) {
-		memset (I.context->buffer, 0, I.context->buffer_sz);
+	rz_stack_push (rz_cons_context ()->cons_stack, data);
+	rz_cons_context ()->buffer_len = 0;
+	if (rz_cons_context ()->buffer) {
+		memset (rz_cons_context ()->buffer, 0, rz_cons_context ()->buffer_sz);
 	}
 }
 
 RZ_API void rz_cons_pop(void) {
-	if (!I.context->cons_stack) {
+	if (!rz_cons_context ()->cons_stack) {
 		return;
 	}
-	RzConsStack *data = (RzConsStack *)rz_stack_pop (I.context->cons_stack);
+	RzConsStack *data = (RzConsStack *)rz_stack_pop (rz_cons_context ()->cons_stack);
 	if (!data) {
 		return;
 	}
@@ -815,16 +817,35 @@ RZ_API void rz_cons_context_free(RzConsContext *context) {
 	free (context);
 }
 
+/**
+ * \brief The context that the output of the calling thread goes to
+ */
+RZ_API RzConsContext *rz_cons_context(void) {
+	return thread_context? thread_context: I.context;
+}
+
 RZ_API void rz_cons_context_load(RzConsContext *context) {
 	I.context = context;
 }
 
+/**
+ * \brief Load \p context for the calling thread only, while the other ones keep theirs
+ *
+ * Meant for threads that run in parallel with the others, e.g. read-only tasks.
+ * NULL goes back to the context shared by all the threads. Only the functions
+ * of rz_cons follow it, code that reads RzCons.context directly does not and
+ * must not run in such a thread.
+ */
+RZ_API void rz_cons_context_load_thread(RzConsContext *context) {
+	thread_context = context;
+}
+
 RZ_API void rz_cons_context_reset(void) {
 	I.context = &rz_cons_context_default;
 }
 
 RZ_API bool rz_cons_context_is_main(void) {
-	return I.context == &rz_cons_context_default;
+	return rz_cons_context () == &rz_cons_context_default;
 }
 
 RZ_API void rz_cons_context_break(RzConsContext *context) {
@@ -846,10 +867,10 @@ RZ_API void rz_cons_last(void) {
 }
 
 static bool lastMatters(void) {
-	return (I.context->buffer_len > 0) \
-		&& (CTX (lastEnabled) && !I.filter && I.context->grep.nstrings < 1 && \
-		!I.context->grep.tokens_used && !I.context->grep.less && \
-		!I.context->grep.json && !I.is_html);
+	return (rz_cons_context ()->buffer_len > 0) \
+		&& (CTX (lastEnabled) && !I.filter && rz_cons_context ()->grep.nstrings < 1 && \
+		!rz_cons_context ()->grep.tokens_used && !rz_cons_context ()->grep.less && \
+		!rz_cons_context ()->grep.json && !I.is_html);
 }
 
 RZ_API void rz_cons_echo(const char *msg) {
@@ -896,7 +917,7 @@ RZ_API void rz_cons_flush(void) {
 	if (rz_cons_is_interactive () && I.fdout == 1) {
 		/* Use a pager if the output doesn't fit on the terminal window. */
 		if (CTX (pageable) && CTX (buffer) && I.pager && *I.pager && CTX (buffer_len) > 0 && rz_str_char_count (CTX (buffer), '\n') >= I.rows) {
-			I.context->buffer[I.context->buffer_len - 1] = 0;
+			rz_cons_context ()->buffer[rz_cons_context ()->buffer_len - 1] = 0;
 			if (!strcmp (I.pager, "..")) {
 				char *str = rz_str_ndup (CTX (buffer), CTX (buffer_len));
 				CTX (pageable) = false;
@@ -908,11 +929,11 @@ RZ_API void rz_cons_flush(void) {
 				rz_sys_cmd_str_full (I.pager, CTX (buffer), NULL, NULL, NULL);
 				rz_cons_reset ();
 			}
-		} else if (I.context->buffer_len > CONS_MAX_USER) {
+		} else if (rz_cons_context ()->buffer_len > CONS_MAX_USER) {
 #if COUNT_LINES
 			int i, lines = 0;
-			for (i = 0; I.context->buffer[i]; i++) {
-				if (I.context->buffer[i] == '\n') {
+			for (i = 0; rz_cons_context ()->buffer[i]; i++) {
+				if (rz_cons_context ()->buffer[i] == '\n') {
 					lines ++;
 				}
 			}
@@ -922,7 +943,7 @@ RZ_API void rz_cons_flush(void) {
 			}
 #else
 			char buf[8];
-			rz_num_units (buf, sizeof (buf), I.context->buffer_len);
+			rz_num_units (buf, sizeof (buf), rz_cons_context ()->buffer_len);
 			if (!rz_cons_yesno ('n', "Do you want to print %s chars? (y/N)", buf)) {
 				rz_cons_reset ();
 				return;
@@ -935,7 +956,7 @@ RZ_API void rz_cons_flush(void) {
 	if (tee && *tee) {
 		FILE *d = rz_sandbox_fopen (tee, "a+");
 		if (d) {
-			if (I.context->buffer_len != fwrite (I.context->buffer, 1, I.context->buffer_len, d)) {
+			if (rz_cons_context ()->buffer_len != fwrite (rz_cons_context ()->buffer, 1, rz_cons_context ()->buffer_len, d)) {
 				eprintf ("rz_cons_flush: fwrite: error (%s)\n", tee);
 			}
 			fclose (d);
@@ -950,10 +971,10 @@ RZ_API void rz_cons_flush(void) {
 		if (I.linesleep > 0 && I.linesleep < 1000) {
 			int i = 0;
 			int pagesize = RZ_MAX (1, I.pagesize);
-			char *ptr = I.context->buffer;
+			char *ptr = rz_cons_context ()->buffer;
 			char *nl = strchr (ptr, '\n');
-			int len = I.context->buffer_len;
-			I.context->buffer[I.context->buffer_len] = 0;
+			int len = rz_cons_context ()->buffer_len;
+			rz_cons_context ()->buffer[rz_cons_context ()->buffer_len] = 0;
 			rz_cons_break_push (NULL, NULL);
 			while (nl && !rz_cons_is_breaked ()) {
 				__cons_write (ptr, nl - ptr + 1);
@@ -964,13 +985,13 @@ RZ_API void rz_cons_flush(void) {
 				nl = strchr (ptr, '\n');
 				i++;
 			}
-			__cons_write (ptr, I.context->buffer + len - ptr);
+			__cons_write (ptr, rz_cons_context ()->buffer + len - ptr);
 			rz_cons_break_pop ();
 		} else {
-			__cons_write (I.context->buffer, I.context->buffer_len);
+			__cons_write (rz_cons_context ()->buffer, rz_cons_context ()->buffer_len);
 		}
 	} else {
-		__cons_write (I.context->buffer, I.context->buffer_len);
+		__cons_write (rz_cons_context ()->buffer, rz_cons_context ()->buffer_len);
 	}
 
 	rz_cons_reset ();
@@ -989,12 +1010,12 @@ RZ_API void rz_cons_visual_flush(void) {
 /* TODO: this ifdef must go in the function body */
 #if __WINDOWS__
 		if (I.vtmode) {
-			rz_cons_visual_write (I.context->buffer);
+			rz_cons_visual_write (rz_cons_context ()->buffer);
 		} else {
-			rz_cons_w32_print (I.context->buffer, I.context->buffer_len, true);
+			rz_cons_w32_print (rz_cons_context ()->buffer, rz_cons_context ()->buffer_len, true);
 		}
 #else
-		rz_cons_visual_write (I.context->buffer);
+		rz_cons_visual_write (rz_cons_context ()->buffer);
 #endif
 	}
 	rz_cons_reset ();
@@ -1132,8 +1153,8 @@ RZ_API void rz_cons_printf_list(const char *format, va_list ap) {
 	if (strchr (format, '%')) {
 		if (palloc (MOAR + strlen (format) * 20)) {
 club:
-			size = I.context->buffer_sz - I.context->buffer_len - 1; /* remaining space in I.context->buffer */
-			written = vsnprintf (I.context->buffer + I.context->buffer_len, size, format, ap3);
+			size = rz_cons_context ()->buffer_sz - rz_cons_context ()->buffer_len - 1; /* remaining space in rz_cons_context ()->buffer */
+			written = vsnprintf (rz_cons_context ()->buffer + rz_cons_context ()->buffer_len, size, format, ap3);
 			if (written >= size) { /* not all bytes were written */
 				if (palloc (written)) {
 					va_end (ap3);
@@ -1141,8 +1162,8 @@ club:
 					goto club;
 				}
 			}
-			I.context->buffer_len += written;
-			I.context->buffer[I.context->buffer_len] = 0;
+			rz_cons_context ()->buffer_len += written;
+			rz_cons_context ()->buffer[rz_cons_context ()->buffer_len] = 0;
 		}
 	} else {
 		rz_cons_strcat (format);
@@ -1164,11 +1185,11 @@ RZ_API int rz_cons_printf(const char *format, ...) {
 }
 
 RZ_API int rz_cons_get_column(void) {
-	char *line = strrchr (I.context->buffer, '\n');
+	char *line = strrchr (rz_cons_context ()->buffer, '\n');
 	if (!line) {
-		line = I.context->buffer;
+		line = rz_cons_context ()->buffer;
 	}
-	I.context->buffer[I.context->buffer_len] = 0;
+	rz_cons_context ()->buffer[rz_cons_context ()->buffer_len] = 0;
 	return rz_str_ansi_len (line);
 }
 
@@ -1186,9 +1207,9 @@ RZ_API int rz_cons_memcat(const char *str, int len) {
 	}
 	if (str && len > 0 && !I.null) {
 		if (palloc (len + 1)) {
-			memcpy (I.context->buffer + I.context->buffer_len, str, len);
-			I.context->buffer_len += len;
-			I.context->buffer[I.context->buffer_len] = 0;
+			memcpy (rz_cons_context ()->buffer + rz_cons_context ()->buffer_len, str, len);
+			rz_cons_context ()->buffer_len += len;
+			rz_cons_context ()->buffer[rz_cons_context ()->buffer_len] = 0;
 		}
 	}
 	if (I.flush) {
@@ -1196,7 +1217,7 @@ RZ_API int rz_cons_memcat(const char *str, int len) {
 	}
 	if (I.break_word && str && len > 0) {
 		if (rz_mem_mem ((const ut8*)str, len, (const ut8*)I.break_word, I.break_word_len)) {
-			I.context->breaked = true;
+			rz_cons_context ()->breaked = true;
 		}
 	}
 	return len;
@@ -1205,9 +1226,9 @@ RZ_API int rz_cons_memcat(const char *str, int len) {
 RZ_API void rz_cons_memset(char ch, int len) {
 	if (!I.null && len > 0) {
 		if (palloc (len + 1)) {
-			memset (I.context->buffer + I.context->buffer_len, ch, len);
-			I.context->buffer_len += len;
-			I.context->buffer[I.context->buffer_len] = 0;
+			memset (rz_cons_context ()->buffer + rz_cons_context ()->buffer_len, ch, len);
+			rz_cons_context ()->buffer_len += len;
+			rz_cons_context ()->buffer[rz_cons_context ()->buffer_len] = 0;
 		}
 	}
 }
@@ -1248,11 +1269,11 @@ RZ_API int rz_cons_get_cursor(int *rows) {
 	int i, col = 0;
 	int row = 0;
 	// TODO: we need to handle GOTOXY and CLRSCR ansi escape code too
-	for (i = 0; i < I.context->buffer_len; i++) {
+	for (i = 0; i < rz_cons_context ()->buffer_len; i++) {
 		// ignore ansi chars, copypasta from rz_str_ansi_len
-		if (I.context->buffer[i] == 0x1b) {
-			char ch2 = I.context->buffer[i + 1];
-			char *str = I.context->buffer;
+		if (rz_cons_context ()->buffer[i] == 0x1b) {
+			char ch2 = rz_cons_context ()->buffer[i + 1];
+			char *str = rz_cons_context ()->buffer;
 			if (ch2 == '\\') {
 				i++;
 			} else if (ch2 == ']') {
@@ -1264,7 +1285,7 @@ RZ_API int rz_cons_get_cursor(int *rows) {
 					;
 				}
 			}
-		} else if (I.context->buffer[i] == '\n') {
+		} else if (rz_cons_context ()->buffer[i] == '\n') {
 			row++;
 			col = 0;
 		} else {
@@ -1654,12 +1675,12 @@ RZ_API bool rz_cons_set_cup(bool enable) {
 }
 
 RZ_API void rz_cons_column(int c) {
-	char *b = malloc (I.context->buffer_len + 1);
+	char *b = malloc (rz_cons_context ()->buffer_len + 1);
 	if (!b) {
 		return;
 	}
-	memcpy (b, I.context->buffer, I.context->buffer_len);
-	b[I.context->buffer_len] = 0;
+	memcpy (b, rz_cons_context ()->buffer, rz_cons_context ()->buffer_len);
+	b[rz_cons_context ()->buffer_len] = 0;
 	rz_cons_reset ();
 	// align current buffer N chars right
 	rz_cons_strcat_justify (b, c, 0);
@@ -1671,12 +1692,12 @@ RZ_API void rz_cons_column(int c) {
 static bool lasti = false; /* last interactive mode */
 
 RZ_API void rz_cons_set_interactive(bool x) {
-	lasti = rz_cons_singleton ()->context->is_interactive;
-	rz_cons_singleton ()->context->is_interactive = x;
+	lasti = rz_cons_context ()->is_interactive;
+	rz_cons_context ()->is_interactive = x;
 }
 
 RZ_API void rz_cons_set_last_interactive(void) {
-	rz_cons_singleton ()->context->is_interactive = lasti;
+	rz_cons_context ()->is_interactive = lasti;
 }
 
 RZ_API void rz_cons_set_title(const char *str) {
@@ -1718,13 +1739,13 @@ RZ_API void rz_cons_highlight(const char *word) {
 		rz_cons_enable_highlight (true);
 		return;
 	}
-	if (word && *word && I.context->buffer) {
+	if (word && *word && rz_cons_context ()->buffer) {
 		int word_len = strlen (word);
 		char *orig;
-		clean = rz_str_ndup (I.context->buffer, I.context->buffer_len);
+		clean = rz_str_ndup (rz_cons_context ()->buffer, rz_cons_context ()->buffer_len);
 		l = rz_str_ansi_filter (clean, &orig, &cpos, -1);
-		free (I.context->buffer);
-		I.context->buffer = orig;
+		free (rz_cons_context ()->buffer);
+		rz_cons_context ()->buffer = orig;
 		if (I.highlight) {
 			if (strcmp (word, I.highlight)) {
 				free (I.highlight);
@@ -1742,25 +1763,25 @@ RZ_API void rz_cons_highlight(const char *word) {
 		strcpy (rword, inv[0]);
 		strcpy (rword + linv[0], word);
 		strcpy (rword + linv[0] + word_len, inv[1]);
-		res = rz_str_replace_thunked (I.context->buffer, clean, cpos,
+		res = rz_str_replace_thunked (rz_cons_context ()->buffer, clean, cpos,
 					l, word, rword, 1);
 		if (res) {
-			I.context->buffer = res;
-			I.context->buffer_len = I.context->buffer_sz = strlen (res);
+			rz_cons_context ()->buffer = res;
+			rz_cons_context ()->buffer_len = rz_cons_context ()->buffer_sz = strlen (res);
 		}
 		free (rword);
 		free (clean);
 		free (cpos);
 		/* don't free orig - it's assigned
-		 * to I.context->buffer and possibly realloc'd */
+		 * to rz_cons_context ()->buffer and possibly realloc'd */
 	} else {
 		RZ_FREE (I.highlight);
 	}
 }
 
 RZ_API char *rz_cons_lastline(int *len) {
-	char *b = I.context->buffer + I.context->buffer_len;
-	while (b > I.context->buffer) {
+	char *b = rz_cons_context ()->buffer + rz_cons_context ()->buffer_len;
+	while (b > rz_cons_context ()->buffer) {
 		if (*b == '\n') {
 			b++;
 			break;
@@ -1768,8 +1789,8 @@ RZ_API char *rz_cons_lastline(int *len) {
 		b--;
 	}
 	if (len) {
-		int delta = b - I.context->buffer;
-		*len = I.context->buffer_len - delta;
+		int delta = b - rz_cons_context ()->buffer;
+		*len = rz_cons_context ()->buffer_len - delta;
 	}
 	return b;
 }
@@ -1781,12 +1802,12 @@ RZ_API char *rz_cons_lastline_utf8_ansi_len(int *len) {
 		return rz_cons_lastline (0);
 	}
 
-	char *b = I.context->buffer + I.context->buffer_len;
+	char *b = rz_cons_context ()->buffer + rz_cons_context ()->buffer_len;
 	int l = 0;
 	int last_possible_ansi_end = 0;
 	char ch = '\0';
 	char ch2;
-	while (b > I.context->buffer) {
+	while (b > rz_cons_context ()->buffer) {
 		ch2 = ch;
 		ch = *b;
 
@@ -1837,21 +1858,21 @@ RZ_API char *rz_cons_swap_ground(const char *col) {
 }
 
 RZ_API bool rz_cons_drop(int n) {
-	if (n > I.context->buffer_len) {
-		I.context->buffer_len = 0;
+	if (n > rz_cons_context ()->buffer_len) {
+		rz_cons_context ()->buffer_len = 0;
 		return false;
 	}
-	I.context->buffer_len -= n;
+	rz_cons_context ()->buffer_len -= n;
 	return true;
 }
 
 RZ_API void rz_cons_chop(void) {
-	while (I.context->buffer_len > 0) {
-		char ch = I.context->buffer[I.context->buffer_len - 1];
+	while (rz_cons_context ()->buffer_len > 0) {
+		char ch = rz_cons_context ()->buffer[rz_cons_context ()->buffer_len - 1];
 		if (ch != '\n' && !IS_WHITESPACE (ch)) {
 			break;
 		}
-		I.context->buffer_len--;
+		rz_cons_context ()->buffer_len--;
 	}
 }
 
@@ -1900,11 +1921,10 @@ RZ_API void rz_cons_breakword(RZ_NULLABLE const char *s) {
  * {"command", "args", "description",
  * "command2", "args2", "description"}; */
 RZ_API void rz_cons_cmd_help(const char *help[], bool use_color) {
-	RzCons *cons = rz_cons_singleton ();
-	const char *pal_args_color = use_color ? cons->context->pal.args : "",
-		   *pal_help_color = use_color ? cons->context->pal.help : "",
-		   *pal_input_color = use_color ? cons->context->pal.input : "",
-		   *pal_reset = use_color ? cons->context->pal.reset : "";
+	const char *pal_args_color = use_color ? rz_cons_context ()->pal.args : "",
+		   *pal_help_color = use_color ? rz_cons_context ()->pal.help : "",
+		   *pal_input_color = use_color ? rz_cons_context ()->pal.input : "",
+		   *pal_reset = use_color ? rz_cons_context ()->pal.reset : "";
 	int i, max_length = 0;
 	const char *usage_str = "Usage:";
 
@@ -80,7 +80,7 @@ static void parse_grep_expression(const char *str) {
 		return;
 	}
 	RzCons *cons = rz_cons_singleton ();
-	RzConsGrep *grep = &cons->context->grep;
+	RzConsGrep *grep = &rz_cons_context ()->grep;
 	sorted_column = 0;
 	bool first = true;
 	while (*str) {
@@ -459,15 +459,15 @@ static int cmp(const void *a, const void *b) {
 
 RZ_API void rz_cons_grepbuf(void) {
 	RzCons *cons = rz_cons_singleton ();
-	const char *buf = cons->context->buffer;
-	const int len = cons->context->buffer_len;
-	RzConsGrep *grep = &cons->context->grep;
+	const char *buf = rz_cons_context ()->buffer;
+	const int len = rz_cons_context ()->buffer_len;
+	RzConsGrep *grep = &rz_cons_context ()->grep;
 	const char *in = buf;
 	int ret, total_lines = 0, buffer_len = 0, l = 0, tl = 0;
 	bool show = false;
 	if (cons->filter) {
-		cons->context->buffer_len = 0;
-		RZ_FREE (cons->context->buffer);
+		rz_cons_context ()->buffer_len = 0;
+		RZ_FREE (rz_cons_context ()->buffer);
 		return;
 	}
 
@@ -479,14 +479,14 @@ RZ_API void rz_cons_grepbuf(void) {
 	}
 
 	if (grep->zoom) {
-		char *in = calloc (cons->context->buffer_len + 2, 4);
-		strcpy (in, cons->context->buffer);
+		char *in = calloc (rz_cons_context ()->buffer_len + 2, 4);
+		strcpy (in, rz_cons_context ()->buffer);
 		char *out = rz_str_scale (in, grep->zoom * 2, grep->zoomy?grep->zoomy:grep->zoom);
 		if (out) {
-			free (cons->context->buffer);
-			cons->context->buffer = out;
-			cons->context->buffer_len = strlen (out);
-			cons->context->buffer_sz = cons->context->buffer_len;
+			free (rz_cons_context ()->buffer);
+			rz_cons_context ()->buffer = out;
+			rz_cons_context ()->buffer_len = strlen (out);
+			rz_cons_context ()->buffer_sz = rz_cons_context ()->buffer_len;
 		}
 		grep->zoom = 0;
 		grep->zoomy = 0;
@@ -495,44 +495,44 @@ RZ_API void rz_cons_grepbuf(void) {
 	}
 	if (grep->json) {
 		if (grep->json_path) {
-			char *u = sdb_json_get_str (cons->context->buffer, grep->json_path);
+			char *u = sdb_json_get_str (rz_cons_context ()->buffer, grep->json_path);
 			if (u) {
-				cons->context->buffer = u;
-				cons->context->buffer_len = strlen (u);
-				cons->context->buffer_sz = cons->context->buffer_len + 1;
+				rz_cons_context ()->buffer = u;
+				rz_cons_context ()->buffer_len = strlen (u);
+				rz_cons_context ()->buffer_sz = rz_cons_context ()->buffer_len + 1;
 				grep->json = 0;
 				rz_cons_newline ();
 			}
 			RZ_FREE (grep->json_path);
 		} else {
 			const char *palette[] = {
-				cons->context->pal.graph_false, // f
-				cons->context->pal.graph_true, // t
-				cons->context->pal.num, // k
-				cons->context->pal.comment, // v
+				rz_cons_context ()->pal.graph_false, // f
+				rz_cons_context ()->pal.graph_true, // t
+				rz_cons_context ()->pal.num, // k
+				rz_cons_context ()->pal.comment, // v
 				Color_RESET,
 				NULL
 			};
 			char *bb = strdup (buf);
 			rz_str_ansi_filter (bb, NULL, NULL, -1);
-			char *out = (cons->context->grep.human)
+			char *out = (rz_cons_context ()->grep.human)
 				? rz_print_json_human (bb)
-				: rz_print_json_indent (bb, I (context->color_mode), "  ", palette);
+				: rz_print_json_indent (bb, rz_cons_context ()->color_mode, "  ", palette);
 			free (bb);
 			if (!out) {
 				return;
 			}
-			free (cons->context->buffer);
-			cons->context->buffer = out;
-			cons->context->buffer_len = strlen (out);
-			cons->context->buffer_sz = cons->context->buffer_len + 1;
+			free (rz_cons_context ()->buffer);
+			rz_cons_context ()->buffer = out;
+			rz_cons_context ()->buffer_len = strlen (out);
+			rz_cons_context ()->buffer_sz = rz_cons_context ()->buffer_len + 1;
 			grep->json = 0;
 			if (grep->hud) {
 				grep->hud = false;
-				rz_cons_hud_string (cons->context->buffer);
+				rz_cons_hud_string (rz_cons_context ()->buffer);
 			} else if (grep->less) {
 				grep->less = 0;
-				rz_cons_less_str (cons->context->buffer, NULL);
+				rz_cons_less_str (rz_cons_context ()->buffer, NULL);
 			}
 		}
 		return;
@@ -549,18 +549,18 @@ RZ_API void rz_cons_grepbuf(void) {
 			}
 		} else {
 			rz_cons_less_str (buf, NULL);
-			cons->context->buffer_len = 0;
-			if (cons->context->buffer) {
-				cons->context->buffer[0] = 0;
+			rz_cons_context ()->buffer_len = 0;
+			if (rz_cons_context ()->buffer) {
+				rz_cons_context ()->buffer[0] = 0;
 			}
-			RZ_FREE (cons->context->buffer);
+			RZ_FREE (rz_cons_context ()->buffer);
 		}
 		return;
 	}
-	if (!cons->context->buffer) {
-		cons->context->buffer_len = len + 20;
-		cons->context->buffer = malloc (cons->context->buffer_len);
-		cons->context->buffer[0] = 0;
+	if (!rz_cons_context ()->buffer) {
+		rz_cons_context ()->buffer_len = len + 20;
+		rz_cons_context ()->buffer = malloc (rz_cons_context ()->buffer_len);
+		rz_cons_context ()->buffer[0] = 0;
 	}
 	RzStrBuf *ob = rz_strbuf_new ("");
 	// if we modify cons->lines we should update I.context->buffer too
@@ -663,29 +663,29 @@ RZ_API void rz_cons_grepbuf(void) {
 		}
 	}
 
-	cons->context->buffer_len = rz_strbuf_length (ob);
+	rz_cons_context ()->buffer_len = rz_strbuf_length (ob);
 	if (grep->counter) {
-		int cnt = grep->charCounter? strlen (cons->context->buffer): cons->lines;
-		if (cons->context->buffer_len < 10) {
-			cons->context->buffer_len = 10; // HACK
+		int cnt = grep->charCounter? strlen (rz_cons_context ()->buffer): cons->lines;
+		if (rz_cons_context ()->buffer_len < 10) {
+			rz_cons_context ()->buffer_len = 10; // HACK
 		}
-		snprintf (cons->context->buffer, cons->context->buffer_len, "%d\n", cnt);
-		cons->context->buffer_len = strlen (cons->context->buffer);
+		snprintf (rz_cons_context ()->buffer, rz_cons_context ()->buffer_len, "%d\n", cnt);
+		rz_cons_context ()->buffer_len = strlen (rz_cons_context ()->buffer);
 		cons->num->value = cons->lines;
 		rz_strbuf_free (ob);
 		return;
 	}
 	
 	const int ob_len = rz_strbuf_length (ob);
-	if (ob_len >= cons->context->buffer_sz) {
-		cons->context->buffer_sz = ob_len + 1;
-		cons->context->buffer = rz_strbuf_drain (ob);
+	if (ob_len >= rz_cons_context ()->buffer_sz) {
+		rz_cons_context ()->buffer_sz = ob_len + 1;
+		rz_cons_context ()->buffer = rz_strbuf_drain (ob);
 	} else {
-		memcpy (cons->context->buffer, rz_strbuf_getbin (ob, NULL), ob_len);
-		cons->context->buffer[ob_len] = 0;
+		memcpy (rz_cons_context ()->buffer, rz_strbuf_getbin (ob, NULL), ob_len);
+		rz_cons_context ()->buffer[ob_len] = 0;
 		rz_strbuf_free (ob);
 	}
-	cons->context->buffer_len = ob_len;
+	rz_cons_context ()->buffer_len = ob_len;
 
 	if (grep->sort != -1) {
 #define INSERT_LINES(list)\
@@ -702,7 +702,7 @@ RZ_API void rz_cons_grepbuf(void) {
 
 		RzListIter *iter;
 		int nl = 0;
-		char *ptr = cons->context->buffer;
+		char *ptr = rz_cons_context ()->buffer;
 		char *str;
 		sorted_column = grep->sort;
 		rz_list_sort (sorted_lines, cmp);
@@ -721,7 +721,7 @@ RZ_API void rz_cons_grepbuf(void) {
 
 RZ_API int rz_cons_grep_line(char *buf, int len) {
 	RzCons *cons = rz_cons_singleton ();
-	RzConsGrep *grep = &cons->context->grep;
+	RzConsGrep *grep = &rz_cons_context ()->grep;
 	const char *delims = " |,;=\t";
 	char *tok = NULL;
 	bool hit = grep->neg;
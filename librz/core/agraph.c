@@ -48,11 +48,6 @@ static const char *mousemodes[] = {
 
 #define NORMALIZE_MOV(x) ((x) < 0 ? -1 : ((x) > 0 ? 1 : 0))
 
-#define hash_set(sdb, k, v) (sdb_num_set (sdb, sdb_fmt ("%"PFMT64u, (ut64) (size_t) (k)), (ut64) (size_t) (v), 0))
-#define hash_get(sdb, k) (sdb_num_get (sdb, sdb_fmt ("%"PFMT64u, (ut64) (size_t) (k)), NULL))
-#define hash_get_rnode(sdb, k) ((RzGraphNode *) (size_t) hash_get (sdb, k))
-#define hash_get_rlist(sdb, k) ((RzList *) (size_t) hash_get (sdb, k))
-#define hash_get_int(sdb, k) ((int) hash_get (sdb, k))
 /* don't use macros for this */
 #define get_anode(gn) ((gn)? (RzANode *) (gn)->data: NULL)
 
@@ -64,12 +59,6 @@ struct len_pos_t {
 	int pos;
 };
 
-struct dist_t {
-	const RzGraphNode *from;
-	const RzGraphNode *to;
-	int dist;
-};
-
 struct g_cb {
 	RzAGraph *graph;
 	RzANodeCallback node_cb;
@@ -427,136 +416,97 @@ static void normal_RzANode_print(const RzAGraph *g, const RzANode *n, int cur) {
 	}
 }
 
-static int **get_crossing_matrix(const RzGraph *g,
-                                 const struct layer_t layers[],
-                                 int maxlayer, int i, int from_up,
-                                 int *n_rows) {
+static int cmp_int(const void *a, const void *b) {
+	const int ia = *(const int *)a, ib = *(const int *)b;
+	return (ia > ib) - (ia < ib);
+}
+
+/* collect, for each node of layer i, the sorted positions of its neighbours
+ * in layer i-1 (from_up) or of its successors (!from_up). The positions of
+ * the node at index j end up in keys[start[j]] .. keys[start[j + 1] - 1] */
+static void get_neighbour_keys(const RzGraph *g, const struct layer_t layers[],
+                               int maxlayer, int i, int from_up,
+                               int *start, int *keys) {
 	int j, len = layers[i].n_nodes;
 
-	int **m = RZ_NEWS0 (int *, len);
-	if (!m) {
-		return NULL;
-	}
-	for (j = 0; j < len; j++) {
-		m[j] = RZ_NEWS0 (int, len);
-		if (!m[j]) {
-			goto err_row;
-		}
-	}
-	/* calculate crossings between layer i and layer i-1 */
-	/* consider the crossings generated by each pair of edges */
+	memset (start, 0, (len + 1) * sizeof (int));
 	if (i > 0 && from_up) {
-		if (rz_cons_is_breaked ()) {
-			goto err_row;
-		}
-		for (j = 0; j < layers[i - 1].n_nodes; j++) {
-			const RzGraphNode *gj = layers[i - 1].nodes[j];
-			const RzList *neigh = rz_graph_get_neighbours (g, gj);
-			RzGraphNode *gk;
-			RzListIter *itk;
-
-			rz_list_foreach (neigh, itk, gk) {
-				int s;
-				// skip self-loop
-				if (gj == gk) {
-					continue;
-				}
-				for (s = 0; s < j; s++) {
-					const RzGraphNode *gs = layers[i - 1].nodes[s];
-					const RzList *neigh_s = rz_graph_get_neighbours (g, gs);
-					RzGraphNode *gt;
-					RzListIter *itt;
-
-					rz_list_foreach (neigh_s, itt, gt) {
-						const RzANode *ak, *at; /* k and t should be "indexes" on layer i */
-						if (gt == gk || gt == gs) {
-							continue;
-						}
-						ak = get_anode (gk);
-						at = get_anode (gt);
-						if (ak->layer != i || at->layer != i) {
-							// this should never happen
-							// but it happens if we do graph.dummy = false, so better hide it for now
-#if 0
-							eprintf ("(WARNING) \"%s\" (%d) or \"%s\" (%d) are not on the right layer (%d)\n",
-								ak->title, ak->layer,
-								at->title, at->layer,
-								i);
-#endif
-							continue;
-						}
-						m[ak->pos_in_layer][at->pos_in_layer]++;
-					}
+		const struct layer_t *up = &layers[i - 1];
+		RzGraphNode *gk;
+		RzListIter *itk;
+
+		/* count the edges reaching each node and lay them out, the nodes
+		 * of the upper layer are visited in order so keys come sorted */
+		for (j = 0; j < up->n_nodes; j++) {
+			rz_list_foreach (rz_graph_get_neighbours (g, up->nodes[j]), itk, gk) {
+				const RzANode *ak = get_anode (gk);
+				if (gk != up->nodes[j] && ak->layer == i) {
+					start[ak->pos_in_layer + 1]++;
 				}
 			}
 		}
-	}
-
-	/* calculate crossings between layer i and layer i+1 */
-	if (i < maxlayer - 1 && !from_up) {
-		if (rz_cons_is_breaked ()) {
-			goto err_row;
+		for (j = 0; j < len; j++) {
+			start[j + 1] += start[j];
+		}
+		for (j = 0; j < up->n_nodes; j++) {
+			rz_list_foreach (rz_graph_get_neighbours (g, up->nodes[j]), itk, gk) {
+				const RzANode *ak = get_anode (gk);
+				if (gk != up->nodes[j] && ak->layer == i) {
+					keys[start[ak->pos_in_layer]++] = j;
+				}
+			}
 		}
-		for (j = 0; j < layers[i].n_nodes; j++) {
-			const RzGraphNode *gj = layers[i].nodes[j];
-			const RzList *neigh = rz_graph_get_neighbours (g, gj);
-			const RzANode *ak, *aj = get_anode (gj);
+		/* start[j] now points at the end of the keys of j */
+		memmove (start + 1, start, len * sizeof (int));
+		start[0] = 0;
+	} else if (i < maxlayer - 1 && !from_up) {
+		int n = 0;
+		for (j = 0; j < len; j++) {
+			const RzList *neigh = rz_graph_get_neighbours (g, layers[i].nodes[j]);
+			const RzANode *ak;
 			RzGraphNode *gk;
 			RzListIter *itk;
 
-			if (rz_cons_is_breaked ()) {
-				goto err_row;
-			}
+			start[j] = n;
 			graph_foreach_anode (neigh, itk, gk, ak) {
-				int s;
-				for (s = 0; s < layers[i].n_nodes; s++) {
-					const RzGraphNode *gs = layers[i].nodes[s];
-					const RzList *neigh_s;
-					RzGraphNode *gt;
-					RzListIter *itt;
-					const RzANode *at, *as = get_anode (gs);
-
-					if (gs == gj) {
-						continue;
-					}
-					neigh_s = rz_graph_get_neighbours (g, gs);
-					graph_foreach_anode (neigh_s, itt, gt, at) {
-						if (at->pos_in_layer < ak->pos_in_layer) {
-							m[aj->pos_in_layer][as->pos_in_layer]++;
-						}
-					}
-				}
+				keys[n++] = ak->pos_in_layer;
 			}
+			qsort (keys + start[j], n - start[j], sizeof (int), cmp_int);
 		}
+		start[len] = n;
 	}
+}
 
-	if (n_rows) {
-		*n_rows = len;
-	}
-	return m;
+/* count the crossings between the edges of two nodes when the first one is
+ * placed on the left of the second one, given the sorted positions of their
+ * neighbours */
+static int count_crossings(const int *ka, int na, const int *kb, int nb) {
+	int i, j = 0, res = 0;
 
-err_row:
-	for (i = 0; i < len; i++) {
-		free (m[i]);
+	for (i = 0; i < na; i++) {
+		while (j < nb && kb[j] < ka[i]) {
+			j++;
+		}
+		res += j;
 	}
-	free (m);
-	return NULL;
+	return res;
 }
 
 static int layer_sweep(const RzGraph *g, const struct layer_t layers[],
-                       int maxlayer, int i, int from_up) {
+                       int maxlayer, int i, int from_up, int *start, int *keys) {
 	RzGraphNode *u, *v;
 	const RzANode *au, *av;
-	int n_rows, j, changed = false;
+	int j, changed = false;
 	int len = layers[i].n_nodes;
 
-	int **cross_matrix = get_crossing_matrix (g, layers, maxlayer, i, from_up, &n_rows);
-	if (!cross_matrix) {
-		return -1; // ERROR HAPPENS
+	if (rz_cons_is_breaked ()) {
+		return -1;
 	}
-
+	/* only adjacent nodes are compared, so instead of the whole crossing
+	 * matrix just count the crossings of the pairs that are considered */
+	get_neighbour_keys (g, layers, maxlayer, i, from_up, start, keys);
 	for (j = 0; j < len - 1; j++) {
-		int auidx, avidx;
+		int auidx, avidx, uv, vu;
 
 		u = layers[i].nodes[j];
 		v = layers[i].nodes[j + 1];
@@ -565,7 +515,11 @@ static int layer_sweep(const RzGraph *g, const struct layer_t layers[],
 		auidx = au->pos_in_layer;
 		avidx = av->pos_in_layer;
 
-		if (cross_matrix[auidx][avidx] > cross_matrix[avidx][auidx]) {
+		uv = count_crossings (keys + start[auidx], start[auidx + 1] - start[auidx],
+			keys + start[avidx], start[avidx + 1] - start[avidx]);
+		vu = count_crossings (keys + start[avidx], start[avidx + 1] - start[avidx],
+			keys + start[auidx], start[auidx + 1] - start[auidx]);
+		if (uv > vu) {
 			/* swap elements */
 			layers[i].nodes[j] = v;
 			layers[i].nodes[j + 1] = u;
@@ -574,17 +528,12 @@ static int layer_sweep(const RzGraph *g, const struct layer_t layers[],
 	}
 
 	/* update position in the layer of each node. During the swap of some
-	 * elements we didn't swap also the pos_in_layer because the cross_matrix
-	 * is indexed by it, so do it now! */
+	 * elements we didn't swap also the pos_in_layer because the neighbour
+	 * keys are indexed by it, so do it now! */
 	for (j = 0; j < layers[i].n_nodes; j++) {
 		RzANode *n = get_anode (layers[i].nodes[j]);
 		n->pos_in_layer = j;
 	}
-
-	for (j = 0; j < n_rows; j++) {
-		free (cross_matrix[j]);
-	}
-	free (cross_matrix);
 	return changed;
 }
 
@@ -714,6 +663,7 @@ static void create_dummy_nodes(RzAGraph *g) {
 		RzANode *to = get_anode (e->to);
 		int diff_layer = RZ_ABS (from->layer - to->layer);
 		RzANode *prev = get_anode (e->from);
+		bool reversed = is_reversed (g, e);
 		int i, nth = e->nth;
 
 		rz_agraph_del_edge (g, from, to);
@@ -724,7 +674,7 @@ static void create_dummy_nodes(RzAGraph *g) {
 			}
 			dummy->is_dummy = true;
 			dummy->layer = from->layer + i;
-			dummy->is_reversed = is_reversed (g, e);
+			dummy->is_reversed = reversed;
 			dummy->w = 1;
 			rz_agraph_add_edge_at (g, prev, dummy, nth);
 
@@ -779,17 +729,34 @@ static void create_layers(RzAGraph *g) {
 /* layer-by-layer sweep */
 /* it permutes each layer, trying to find the best ordering for each layer
  * to minimize the number of crossing edges */
-static void minimize_crossings(const RzAGraph *g) {
+static bool minimize_crossings(const RzAGraph *g) {
 	int i, cross_changed, max_changes = 4096;
+	int max_nodes = 0, n_edges = 0;
+	const RzGraphNode *gn;
+	const RzListIter *it;
+	const RzANode *n;
+	bool res = false;
+
+	for (i = 0; i < g->n_layers; i++) {
+		max_nodes = RZ_MAX (max_nodes, g->layers[i].n_nodes);
+	}
+	graph_foreach_anode (rz_graph_get_nodes (g->graph), it, gn, n) {
+		n_edges += rz_list_length (rz_graph_get_neighbours (g->graph, gn));
+	}
+	int *start = RZ_NEWS (int, max_nodes + 1);
+	int *keys = RZ_NEWS (int, n_edges + 1);
+	if (!start || !keys) {
+		goto out;
+	}
 
 	do {
 		cross_changed = false;
 		max_changes--;
 
 		for (i = 0; i < g->n_layers; i++) {
-			int rc = layer_sweep (g->graph, g->layers, g->n_layers, i, true);
+			int rc = layer_sweep (g->graph, g->layers, g->n_layers, i, true, start, keys);
 			if (rc == -1) {
-				return;
+				goto out;
 			}
 			cross_changed |= !!rc;
 		}
@@ -802,63 +769,186 @@ static void minimize_crossings(const RzAGraph *g) {
 		max_changes--;
 
 		for (i = g->n_layers - 1; i >= 0; i--) {
-			int rc = layer_sweep (g->graph, g->layers, g->n_layers, i, false);
+			int rc = layer_sweep (g->graph, g->layers, g->n_layers, i, false, start, keys);
 			if (rc == -1) {
-				return;
+				goto out;
 			}
 			cross_changed |= !!rc;
 		}
 	} while (cross_changed && max_changes);
+	res = true;
+
+out:
+	free (start);
+	free (keys);
+	return res;
+}
+
+/* the order found by minimize_crossings only depends on the layers and on the
+ * edges between their nodes. It is kept together with a description of them,
+ * so that laying out the same graph again, e.g. because the body of some
+ * nodes changed, does not have to sweep the layers again */
+struct layout_cache_t {
+	int *sign;
+	int sign_len;
+	int *order; /* initial position of each node, layer after layer */
+	int order_len;
+};
+
+static void layout_cache_free(struct layout_cache_t *c) {
+	if (c) {
+		free (c->sign);
+		free (c->order);
+		free (c);
+	}
+}
+
+/* the dummy nodes created by this layout get new indexes every time, so they
+ * are numbered from the first one that was created */
+static int layout_key(const RzGraphNode *gn, int first_dummy) {
+	return (int)gn->idx < first_dummy? (int)gn->idx: first_dummy - (int)gn->idx - 1;
+}
+
+static int *layout_signature(const RzAGraph *g, int first_dummy, int *len) {
+	const RzGraphNode *gk;
+	const RzListIter *it;
+	int i, j, k = 0, n = 1;
+
+	for (i = 0; i < g->n_layers; i++) {
+		n++;
+		for (j = 0; j < g->layers[i].n_nodes; j++) {
+			n += 2 + rz_list_length (rz_graph_get_neighbours (g->graph, g->layers[i].nodes[j]));
+		}
+	}
+	int *sign = RZ_NEWS (int, n);
+	if (!sign) {
+		return NULL;
+	}
+	sign[k++] = g->n_layers;
+	for (i = 0; i < g->n_layers; i++) {
+		sign[k++] = g->layers[i].n_nodes;
+		for (j = 0; j < g->layers[i].n_nodes; j++) {
+			const RzGraphNode *gn = g->layers[i].nodes[j];
+			const RzList *neigh = rz_graph_get_neighbours (g->graph, gn);
+
+			sign[k++] = layout_key (gn, first_dummy);
+			sign[k++] = rz_list_length (neigh);
+			rz_list_foreach (neigh, it, gk) {
+				sign[k++] = layout_key (gk, first_dummy);
+			}
+		}
+	}
+	*len = n;
+	return sign;
+}
+
+static bool layout_cache_apply(const RzAGraph *g, const int *sign, int sign_len) {
+	const struct layout_cache_t *c = g->layout_cache;
+	int i, j, k = 0, max_nodes = 0;
+
+	if (!c || c->sign_len != sign_len || memcmp (c->sign, sign, sign_len * sizeof (int))) {
+		return false;
+	}
+	for (i = 0; i < g->n_layers; i++) {
+		max_nodes = RZ_MAX (max_nodes, g->layers[i].n_nodes);
+	}
+	RzGraphNode **tmp = RZ_NEWS (RzGraphNode *, max_nodes + 1);
+	if (!tmp) {
+		return false;
+	}
+	for (i = 0; i < g->n_layers; i++) {
+		memcpy (tmp, g->layers[i].nodes, g->layers[i].n_nodes * sizeof (RzGraphNode *));
+		for (j = 0; j < g->layers[i].n_nodes; j++) {
+			RzGraphNode *gn = tmp[c->order[k++]];
+			get_anode (gn)->pos_in_layer = j;
+			g->layers[i].nodes[j] = gn;
+		}
+	}
+	free (tmp);
+	return true;
 }
 
-static int find_dist(const struct dist_t *a, const struct dist_t *b) {
-	return a->from == b->from && a->to == b->to? 0: 1;
+/* reorder the nodes in each layer, reusing the order of the previous layout
+ * when the layers did not change since then */
+static void order_layers(RzAGraph *g, int first_dummy) {
+	struct layout_cache_t *c = NULL;
+	int i, j, k = 0, sign_len = 0;
+
+	int *sign = layout_signature (g, first_dummy, &sign_len);
+	if (sign && layout_cache_apply (g, sign, sign_len)) {
+		free (sign);
+		return;
+	}
+	int *init_pos = sign? RZ_NEWS (int, g->graph->last_index + 1): NULL;
+	if (init_pos) {
+		for (i = 0; i < g->n_layers; i++) {
+			for (j = 0; j < g->layers[i].n_nodes; j++) {
+				init_pos[g->layers[i].nodes[j]->idx] = j;
+			}
+		}
+	}
+	if (!minimize_crossings (g) || !init_pos) {
+		goto out;
+	}
+	c = RZ_NEW0 (struct layout_cache_t);
+	if (!c) {
+		goto out;
+	}
+	for (i = 0; i < g->n_layers; i++) {
+		c->order_len += g->layers[i].n_nodes;
+	}
+	c->order = RZ_NEWS (int, c->order_len + 1);
+	if (!c->order) {
+		layout_cache_free (c);
+		goto out;
+	}
+	for (i = 0; i < g->n_layers; i++) {
+		for (j = 0; j < g->layers[i].n_nodes; j++) {
+			c->order[k++] = init_pos[g->layers[i].nodes[j]->idx];
+		}
+	}
+	c->sign = sign;
+	c->sign_len = sign_len;
+	sign = NULL;
+	layout_cache_free (g->layout_cache);
+	g->layout_cache = c;
+out:
+	free (init_pos);
+	free (sign);
 }
 
+/* distances are only set between a node and the next one in its layer, so
+ * they are stored by the index of the first node */
+#define DIST_UNSET INT_MIN
+
 /* returns the distance between two nodes */
 /* if the distance between two nodes were explicitly set, returns that;
  * otherwise calculate the distance of two nodes on the same layer */
 static int dist_nodes(const RzAGraph *g, const RzGraphNode *a, const RzGraphNode *b) {
-	struct dist_t d;
 	const RzANode *aa, *ab;
-	RzListIter *it;
 	int res = 0;
 
-	if (g->dists) {
-		d.from = a;
-		d.to = b;
-		it = rz_list_find (g->dists, &d, (RzListComparator) find_dist);
-		if (it) {
-			struct dist_t *old = (struct dist_t *) rz_list_iter_get_data (it);
-			return old->dist;
-		}
-	}
-
 	aa = get_anode (a);
 	ab = get_anode (b);
 	if (aa && ab && aa->layer == ab->layer) {
 		int i;
 
+		if (g->dists && ab->pos_in_layer == aa->pos_in_layer + 1 && g->dists[a->idx] != DIST_UNSET) {
+			return g->dists[a->idx];
+		}
 		res = aa == ab && !aa->is_reversed? HORIZONTAL_NODE_SPACING: 0;
 		for (i = aa->pos_in_layer; i < ab->pos_in_layer; i++) {
 			const RzGraphNode *cur = g->layers[aa->layer].nodes[i];
 			const RzGraphNode *next = g->layers[aa->layer].nodes[i + 1];
 			const RzANode *anext = get_anode (next);
 			const RzANode *acur = get_anode (cur);
-			int found = false;
-
-			if (g->dists) {
-				d.from = cur;
-				d.to = next;
-				it = rz_list_find (g->dists, &d, (RzListComparator) find_dist);
-				if (it) {
-					struct dist_t *old = (struct dist_t *) rz_list_iter_get_data (it);
-					res += old->dist;
-					found = true;
-				}
+
+			if (g->dists && g->dists[cur->idx] != DIST_UNSET) {
+				res += g->dists[cur->idx];
+				continue;
 			}
 
-			if (acur && anext && !found) {
+			if (acur && anext) {
 				int space = HORIZONTAL_NODE_SPACING;
 				if (acur->is_reversed && anext->is_reversed) {
 					if (!acur->is_reversed) {
@@ -879,10 +969,8 @@ static int dist_nodes(const RzAGraph *g, const RzGraphNode *a, const RzGraphNode
 
 /* explicitly set the distance between two nodes on the same layer */
 static void set_dist_nodes(const RzAGraph *g, int l, int cur, int next) {
-	struct dist_t *d, find_el;
 	const RzGraphNode *vi, *vip;
 	const RzANode *avi, *avip;
-	RzListIter *it;
 
 	if (!g->dists) {
 		return;
@@ -891,18 +979,7 @@ static void set_dist_nodes(const RzAGraph *g, int l, int cur, int next) {
 	vip = g->layers[l].nodes[next];
 	avi = get_anode (vi);
 	avip = get_anode (vip);
-
-	find_el.from = vi;
-	find_el.to = vip;
-	it = rz_list_find (g->dists, &find_el, (RzListComparator) find_dist);
-	d = it? (struct dist_t *) rz_list_iter_get_data (it): RZ_NEW0 (struct dist_t);
-
-	d->from = vi;
-	d->to = vip;
-	d->dist = (avip && avi)? avip->x - avi->x: 0;
-	if (!it) {
-		rz_list_push (g->dists, d);
-	}
+	g->dists[vi->idx] = (avip && avi)? avip->x - avi->x: 0;
 }
 
 static int is_valid_pos(const RzAGraph *g, int l, int pos) {
@@ -913,33 +990,25 @@ static int is_valid_pos(const RzAGraph *g, int l, int pos) {
 /* if v is an original node, L(v) = { v }
  * if v is a dummy node, L(v) is the set of all the dummies node that belongs
  *      to the same long edge */
-static Sdb *compute_vertical_nodes(const RzAGraph *g) {
-	Sdb *res = sdb_new0 ();
+/* L(v) is returned as a chain starting at v, the node following w in the
+ * chain is stored at the index of w */
+static RzGraphNode **compute_vertical_nodes(const RzAGraph *g) {
+	RzGraphNode **res = RZ_NEWS0 (RzGraphNode *, g->graph->last_index + 1);
 	int i, j;
 
+	if (!res) {
+		return NULL;
+	}
 	for (i = 0; i < g->n_layers; i++) {
 		for (j = 0; j < g->layers[i].n_nodes; j++) {
 			RzGraphNode *gn = g->layers[i].nodes[j];
-			const RzList *Ln = hash_get_rlist (res, gn);
 			const RzANode *an = get_anode (gn);
 
-			if (!Ln) {
-				RzList *vert = rz_list_new ();
-				hash_set (res, gn, vert);
-				if (an->is_dummy) {
-					RzGraphNode *next = gn;
-					const RzANode *anext = get_anode (next);
-
-					while (anext->is_dummy) {
-						rz_list_append (vert, next);
-						next = rz_graph_nth_neighbour (g->graph, next, 0);
-						if (!next) {
-							break;
-						}
-						anext = get_anode (next);
-					}
-				} else {
-					rz_list_append (vert, gn);
+			if (an->is_dummy) {
+				RzGraphNode *next = rz_graph_nth_neighbour (g->graph, gn, 0);
+				const RzANode *anext = get_anode (next);
+				if (anext && anext->is_dummy) {
+					res[gn->idx] = next;
 				}
 			}
 		}
@@ -948,40 +1017,47 @@ static Sdb *compute_vertical_nodes(const RzAGraph *g) {
 	return res;
 }
 
+struct class_node_t {
+	int klass;
+	RzGraphNode *gn;
+};
+
 /* computes left or right classes, used to place dummies node */
 /* classes respect three properties:
  * - v E C
  * - w E C => L(v) is a subset of C
  * - w E C, the s+(w) exists and is not in any class yet => s+(w) E C */
-static RzList **compute_classes(const RzAGraph *g, Sdb *v_nodes, int is_left, int *n_classes) {
+/* the nodes of class c are returned in res[start[c]] .. res[start[c + 1] - 1],
+ * in the order they were added to it */
+static RzGraphNode **compute_classes(const RzAGraph *g, RzGraphNode **v_nodes, int is_left, int **start) {
 	int i, j, c;
-	RzList **res = RZ_NEWS0 (RzList *, g->n_layers);
-	RzGraphNode *gn;
+	RzGraphNode *gn, **res = NULL;
 	const RzListIter *it;
 	RzANode *n;
+	struct class_node_t *cn;
+	RzVector added;
 
 	graph_foreach_anode (rz_graph_get_nodes (g->graph), it, gn, n) {
 		n->klass = -1;
 	}
 
+	rz_vector_init (&added, sizeof (struct class_node_t), NULL, NULL);
 	for (i = 0; i < g->n_layers; i++) {
 		c = i;
 
 		for (j = is_left? 0: g->layers[i].n_nodes - 1;
 		     (is_left && j < g->layers[i].n_nodes) || (!is_left && j >= 0);
 		     j = is_left? j + 1: j - 1) {
-			const RzGraphNode *gj = g->layers[i].nodes[j];
+			RzGraphNode *gj = g->layers[i].nodes[j];
 			const RzANode *aj = get_anode (gj);
 
 			if (aj->klass == -1) {
-				const RzList *laj = hash_get_rlist (v_nodes, gj);
-
-				if (!res[c]) {
-					res[c] = rz_list_new ();
-				}
-				graph_foreach_anode (laj, it, gn, n) {
-					rz_list_append (res[c], gn);
-					n->klass = c;
+				for (gn = gj; gn; gn = v_nodes[gn->idx]) {
+					struct class_node_t add = { c, gn };
+					if (!rz_vector_push (&added, &add)) {
+						goto out;
+					}
+					get_anode (gn)->klass = c;
 				}
 			} else {
 				c = aj->klass;
@@ -989,14 +1065,34 @@ static RzList **compute_classes(const RzAGraph *g, Sdb *v_nodes, int is_left, in
 		}
 	}
 
-	if (n_classes) {
-		*n_classes = g->n_layers;
+	*start = RZ_NEWS0 (int, g->n_layers + 1);
+	res = RZ_NEWS (RzGraphNode *, rz_vector_len (&added) + 1);
+	if (!*start || !res) {
+		RZ_FREE (*start);
+		RZ_FREE (res);
+		goto out;
+	}
+	rz_vector_foreach (&added, cn) {
+		(*start)[cn->klass + 1]++;
 	}
+	for (i = 0; i < g->n_layers; i++) {
+		(*start)[i + 1] += (*start)[i];
+	}
+	rz_vector_foreach (&added, cn) {
+		res[(*start)[cn->klass]++] = cn->gn;
+	}
+	/* (*start)[c] now points at the end of class c */
+	memmove (*start + 1, *start, g->n_layers * sizeof (int));
+	(*start)[0] = 0;
+
+out:
+	rz_vector_fini (&added);
 	return res;
 }
 
-static int cmp_dist(const size_t a, const size_t b) {
-	return (a < b) - (a > b);
+static int cmp_dist(const void *a, const void *b) {
+	const size_t da = *(const size_t *)a, db = *(const size_t *)b;
+	return (da < db) - (da > db);
 }
 
 static RzGraphNode *get_sibling(const RzAGraph *g, const RzANode *n, int is_left, int is_adjust_class) {
@@ -1015,24 +1111,21 @@ static RzGraphNode *get_sibling(const RzAGraph *g, const RzANode *n, int is_left
 	return res;
 }
 
-static int adjust_class_val(const RzAGraph *g, const RzGraphNode *gn, const RzGraphNode *sibl, Sdb *res, int is_left) {
+static int adjust_class_val(const RzAGraph *g, const RzGraphNode *gn, const RzGraphNode *sibl, const int *res, int is_left) {
 	if (is_left) {
-		return hash_get_int (res, sibl) - hash_get_int (res, gn) - dist_nodes (g, gn, sibl);
+		return res[sibl->idx] - res[gn->idx] - dist_nodes (g, gn, sibl);
 	}
-	return hash_get_int (res, gn) - hash_get_int (res, sibl) - dist_nodes (g, sibl, gn);
+	return res[gn->idx] - res[sibl->idx] - dist_nodes (g, sibl, gn);
 }
 
 /* adjusts the position of previously placed left/right classes */
 /* tries to place classes as close as possible */
-static void adjust_class(const RzAGraph *g, int is_left, RzList **classes, Sdb *res, int c) {
-	const RzGraphNode *gn;
-	const RzListIter *it;
-	const RzANode *an;
-	int dist, v, is_first = true;
+static void adjust_class(const RzAGraph *g, int is_left, RzGraphNode **klass, int len, int *res, int c) {
+	int i, dist = 0, v, is_first = true;
 
-	graph_foreach_anode (classes[c], it, gn, an) {
+	for (i = 0; i < len; i++) {
 		const RzGraphNode *sibling;
-		const RzANode *sibl_anode;
+		const RzANode *sibl_anode, *an = get_anode (klass[i]);
 
 		sibling = get_sibling (g, an, is_left, true);
 		if (!sibling) {
@@ -1042,54 +1135,54 @@ static void adjust_class(const RzAGraph *g, int is_left, RzList **classes, Sdb *
 		if (sibl_anode->klass == c) {
 			continue;
 		}
-		v = adjust_class_val (g, gn, sibling, res, is_left);
+		v = adjust_class_val (g, klass[i], sibling, res, is_left);
 		dist = is_first? v: RZ_MIN (dist, v);
 		is_first = false;
 	}
 
 	if (is_first) {
-		RzList *heap = rz_list_new ();
-		int len;
+		RzVector heap;
+		size_t n_dists;
 
-		graph_foreach_anode (classes[c], it, gn, an) {
-			const RzList *neigh = rz_graph_all_neighbours (g->graph, gn);
+		rz_vector_init (&heap, sizeof (size_t), NULL, NULL);
+		for (i = 0; i < len; i++) {
+			const RzList *neigh = rz_graph_all_neighbours (g->graph, klass[i]);
+			const RzANode *ak, *an = get_anode (klass[i]);
 			const RzGraphNode *gk;
 			const RzListIter *itk;
-			const RzANode *ak;
 
 			graph_foreach_anode (neigh, itk, gk, ak) {
 				if (ak->klass < c) {
 					size_t d = (ak->x - an->x);
 					if (d > 0) {
-						rz_list_append (heap, (void *) d);
+						rz_vector_push (&heap, &d);
 					}
 				}
 			}
 		}
 
-		len = rz_list_length (heap);
-		if (len == 0) {
+		n_dists = rz_vector_len (&heap);
+		if (n_dists == 0) {
 			dist = 0;
 		} else {
-			rz_list_sort (heap, (RzListComparator) cmp_dist);
-			dist = (int) (size_t) rz_list_get_n (heap, len / 2);
+			qsort (heap.a, n_dists, sizeof (size_t), cmp_dist);
+			dist = (int) *(size_t *)rz_vector_index_ptr (&heap, n_dists / 2);
 		}
 
-		rz_list_free (heap);
+		rz_vector_fini (&heap);
 	}
 
-	graph_foreach_anode (classes[c], it, gn, an) {
-		const int old_val = hash_get_int (res, gn);
-		const int new_val = is_left? old_val + dist: old_val - dist;
-		hash_set (res, gn, new_val);
+	for (i = 0; i < len; i++) {
+		const int old_val = res[klass[i]->idx];
+		res[klass[i]->idx] = is_left? old_val + dist: old_val - dist;
 	}
 }
 
-static int place_nodes_val(const RzAGraph *g, const RzGraphNode *gn, const RzGraphNode *sibl, Sdb *res, int is_left) {
+static int place_nodes_val(const RzAGraph *g, const RzGraphNode *gn, const RzGraphNode *sibl, const int *res, int is_left) {
 	if (is_left) {
-		return hash_get_int (res, sibl) + dist_nodes (g, sibl, gn);
+		return res[sibl->idx] + dist_nodes (g, sibl, gn);
 	}
-	return hash_get_int (res, sibl) - dist_nodes (g, gn, sibl);
+	return res[sibl->idx] - dist_nodes (g, gn, sibl);
 }
 
 static int place_nodes_sel_p(int newval, int oldval, int is_first, int is_left) {
@@ -1103,16 +1196,13 @@ static int place_nodes_sel_p(int newval, int oldval, int is_first, int is_left)
 }
 
 /* places left/right the nodes of a class */
-static void place_nodes(const RzAGraph *g, const RzGraphNode *gn, int is_left, Sdb *v_nodes, RzList **classes, Sdb *res, Sdb *placed) {
-	const RzList *lv = hash_get_rlist (v_nodes, gn);
+static void place_nodes(const RzAGraph *g, RzGraphNode *gn, int is_left, RzGraphNode **v_nodes, int *res, bool *placed) {
 	int p = 0, v, is_first = true;
-	const RzGraphNode *gk;
-	const RzListIter *itk;
-	const RzANode *ak;
+	RzGraphNode *gk;
 
-	graph_foreach_anode (lv, itk, gk, ak) {
-		const RzGraphNode *sibling;
-		const RzANode *sibl_anode;
+	for (gk = gn; gk; gk = v_nodes[gk->idx]) {
+		RzGraphNode *sibling;
+		const RzANode *sibl_anode, *ak = get_anode (gk);
 
 		sibling = get_sibling (g, ak, is_left, false);
 		if (!sibling) {
@@ -1120,8 +1210,8 @@ static void place_nodes(const RzAGraph *g, const RzGraphNode *gn, int is_left, S
 		}
 		sibl_anode = get_anode (sibling);
 		if (ak->klass == sibl_anode->klass) {
-			if (!hash_get (placed, sibling)) {
-				place_nodes (g, sibling, is_left, v_nodes, classes, res, placed);
+			if (!placed[sibling->idx]) {
+				place_nodes (g, sibling, is_left, v_nodes, res, placed);
 			}
 
 			v = place_nodes_val (g, gk, sibling, res, is_left);
@@ -1134,51 +1224,44 @@ static void place_nodes(const RzAGraph *g, const RzGraphNode *gn, int is_left, S
 		p = is_left? 0: 50;
 	}
 
-	graph_foreach_anode (lv, itk, gk, ak) {
-		hash_set (res, gk, p);
-		hash_set (placed, gk, true);
+	for (gk = gn; gk; gk = v_nodes[gk->idx]) {
+		res[gk->idx] = p;
+		placed[gk->idx] = true;
 	}
 }
 
 /* computes the position to the left/right of all the nodes */
-static Sdb *compute_pos(const RzAGraph *g, int is_left, Sdb *v_nodes) {
-	int n_classes, i;
+static int *compute_pos(const RzAGraph *g, int is_left, RzGraphNode **v_nodes) {
+	int *start = NULL, i, j;
 
-	RzList **classes = compute_classes (g, v_nodes, is_left, &n_classes);
+	RzGraphNode **classes = compute_classes (g, v_nodes, is_left, &start);
 	if (!classes) {
 		return NULL;
 	}
 
-	Sdb *res = sdb_new0 ();
-	Sdb *placed = sdb_new0 ();
-	for (i = 0; i < n_classes; i++) {
-		const RzGraphNode *gn;
-		const RzListIter *it;
-
-		rz_list_foreach (classes[i], it, gn) {
-			if (!hash_get_rnode (placed, gn)) {
-				place_nodes (g, gn, is_left, v_nodes, classes, res, placed);
+	int *res = RZ_NEWS0 (int, g->graph->last_index + 1);
+	bool *placed = RZ_NEWS0 (bool, g->graph->last_index + 1);
+	if (!res || !placed) {
+		RZ_FREE (res);
+		goto out;
+	}
+	for (i = 0; i < g->n_layers; i++) {
+		for (j = start[i]; j < start[i + 1]; j++) {
+			if (!placed[classes[j]->idx]) {
+				place_nodes (g, classes[j], is_left, v_nodes, res, placed);
 			}
 		}
 
-		adjust_class (g, is_left, classes, res, i);
+		adjust_class (g, is_left, classes + start[i], start[i + 1] - start[i], res, i);
 	}
 
-	sdb_free (placed);
-	for (i = 0; i < n_classes; i++) {
-		if (classes[i]) {
-			rz_list_free (classes[i]);
-		}
-	}
+out:
+	free (placed);
 	free (classes);
+	free (start);
 	return res;
 }
 
-static int free_vertical_nodes_cb(void *user UNUSED, const char *k UNUSED, const char *v) {
-	rz_list_free ((RzList *) (size_t) sdb_atoi (v));
-	return 1;
-}
-
 /* calculates position of all nodes, but in particular dummies nodes */
 /* computes two different placements (called "left"/"right") and set the final
  * position of each node to the average of the values in the two placements */
@@ -1188,30 +1271,29 @@ static void place_dummies(const RzAGraph *g) {
 	const RzListIter *it;
 	RzANode *n;
 
-	Sdb *vertical_nodes = compute_vertical_nodes (g);
+	RzGraphNode **vertical_nodes = compute_vertical_nodes (g);
 	if (!vertical_nodes) {
 		return;
 	}
-	Sdb *xminus = compute_pos (g, true, vertical_nodes);
+	int *xminus = compute_pos (g, true, vertical_nodes);
 	if (!xminus) {
 		goto xminus_err;
 	}
-	Sdb *xplus = compute_pos (g, false, vertical_nodes);
+	int *xplus = compute_pos (g, false, vertical_nodes);
 	if (!xplus) {
 		goto xplus_err;
 	}
 
 	nodes = rz_graph_get_nodes (g->graph);
 	graph_foreach_anode (nodes, it, gn, n) {
-		n->x = (hash_get_int (xminus, gn) + hash_get_int (xplus, gn)) / 2;
+		n->x = (xminus[gn->idx] + xplus[gn->idx]) / 2;
 	}
 
-	sdb_free (xplus);
+	free (xplus);
 xplus_err:
-	sdb_free (xminus);
+	free (xminus);
 xminus_err:
-	sdb_foreach (vertical_nodes, (SdbForeachCallback)free_vertical_nodes_cb, NULL);
-	sdb_free (vertical_nodes);
+	free (vertical_nodes);
 }
 
 static RzGraphNode *get_right_dummy(const RzAGraph *g, const RzGraphNode *n) {
@@ -1235,7 +1317,7 @@ static RzGraphNode *get_right_dummy(const RzAGraph *g, const RzGraphNode *n) {
 	return NULL;
 }
 
-static void adjust_directions(const RzAGraph *g, int i, int from_up, Sdb *D, Sdb *P) {
+static void adjust_directions(const RzAGraph *g, int i, int from_up, bool *D, bool *P) {
 	const RzGraphNode *vm = NULL, *wm = NULL;
 	const RzANode *vma = NULL, *wma = NULL;
 	int j, d = from_up? 1: -1;
@@ -1260,23 +1342,23 @@ static void adjust_directions(const RzAGraph *g, int i, int from_up, Sdb *D, Sdb
 			continue;
 		}
 		if (vm) {
-			int p = hash_get_int (P, wm);
+			int p = P[wm->idx];
 			int k;
 
 			for (k = wma->pos_in_layer + 1; k < wpa->pos_in_layer; k++) {
 				const RzGraphNode *w = g->layers[wma->layer].nodes[k];
 				const RzANode *aw = get_anode (w);
 				if (aw && aw->is_dummy) {
-					p &= hash_get_int (P, w);
+					p &= P[w->idx];
 				}
 			}
 			if (p) {
-				hash_set (D, vm, from_up);
+				D[vm->idx] = from_up;
 				for (k = vma->pos_in_layer + 1; k < vpa->pos_in_layer; k++) {
 					const RzGraphNode *v = g->layers[vma->layer].nodes[k];
 					const RzANode *av = get_anode (v);
 					if (av && av->is_dummy) {
-						hash_set (D, v, from_up);
+						D[v->idx] = from_up;
 					}
 				}
 			}
@@ -1494,7 +1576,7 @@ static void place_sequence(const RzAGraph *g, int l, const RzGraphNode *bm, cons
 /* finds the placements of nodes while traversing the graph in the given
  * direction */
 /* places all the sequences of consecutive original nodes in each layer. */
-static void original_traverse_l(const RzAGraph *g, Sdb *D, Sdb *P, int from_up) {
+static void original_traverse_l(const RzAGraph *g, bool *D, bool *P, int from_up) {
 	int i, k, va, vr;
 
 	for (i = from_up? 0: g->n_layers - 1;
@@ -1543,12 +1625,12 @@ static void original_traverse_l(const RzAGraph *g, Sdb *D, Sdb *P, int from_up)
 				if (is_valid_pos (g, i, va)) {
 					set_dist_nodes (g, i, bma->pos_in_layer, va);
 				}
-			} else if (hash_get_int (D, bm) == from_up) {
+			} else if (D[bm->idx] == from_up) {
 				bpa = get_anode (bp);
 				va = bma->pos_in_layer + 1;
 				vr = bpa->pos_in_layer;
 				place_sequence (g, i, bm, bp, from_up, va, vr);
-				hash_set (P, bm, true);
+				P[bm->idx] = true;
 			}
 			bm = bp;
 		}
@@ -1564,21 +1646,16 @@ static void place_original(RzAGraph *g) {
 	const RzGraphNode *gn;
 	const RzListIter *itn;
 	const RzANode *an;
+	int i, n = g->graph->last_index + 1;
 
-	Sdb *D = sdb_new0 ();
-	if (!D) {
-		return;
+	bool *D = RZ_NEWS0 (bool, n);
+	bool *P = RZ_NEWS0 (bool, n);
+	g->dists = RZ_NEWS (int, n);
+	if (!D || !P || !g->dists) {
+		goto out;
 	}
-	Sdb *P = sdb_new0 ();
-	if (!P) {
-		sdb_free (D);
-		return;
-	}
-	g->dists = rz_list_newf ((RzListFree) free);
-	if (!g->dists) {
-		sdb_free (D);
-		sdb_free (P);
-		return;
+	for (i = 0; i < n; i++) {
+		g->dists[i] = DIST_UNSET;
 	}
 
 	graph_foreach_anode (nodes, itn, gn, an) {
@@ -1588,19 +1665,18 @@ static void place_original(RzAGraph *g) {
 		const RzGraphNode *right_v = get_right_dummy (g, gn);
 		const RzANode *right = get_anode (right_v);
 		if (right_v && right) {
-			hash_set (D, gn, 0);
-			int dt_eq = right->x - an->x == dist_nodes (g, gn, right_v);
-			hash_set (P, gn, dt_eq);
+			D[gn->idx] = false;
+			P[gn->idx] = right->x - an->x == dist_nodes (g, gn, right_v);
 		}
 	}
 
 	original_traverse_l (g, D, P, true);
 	original_traverse_l (g, D, P, false);
 
-	rz_list_free (g->dists);
-	g->dists = NULL;
-	sdb_free (P);
-	sdb_free (D);
+out:
+	RZ_FREE (g->dists);
+	free (P);
+	free (D);
 }
 
 #if 0
@@ -1930,16 +2006,17 @@ static void backedge_info (RzAGraph *g) {
  * 5) assign x and y coordinates to each node
  * 6) restore the original graph, with long edges and cycles */
 static void set_layout(RzAGraph *g) {
-	int i, j, k;
+	int i, j, k, first_dummy;
 
 	rz_list_free (g->edges);
 	g->edges = rz_list_new ();
 
 	remove_cycles (g);
 	assign_layers (g);
+	first_dummy = g->graph->last_index;
 	create_dummy_nodes (g);
 	create_layers (g);
-	minimize_crossings (g);
+	order_layers (g, first_dummy);
 
 	if (rz_cons_is_breaked ()) {
 		rz_cons_break_end ();
@@ -3864,6 +3941,8 @@ RZ_API void rz_agraph_del_edge(const RzAGraph *g, RzANode *a, RzANode *b) {
 RZ_API void rz_agraph_reset(RzAGraph *g) {
 	agraph_free_nodes (g);
 	rz_graph_reset (g->graph);
+	layout_cache_free (g->layout_cache);
+	g->layout_cache = NULL;
 	rz_agraph_set_title (g, NULL);
 	sdb_reset (g->db);
 	if (g->edges) {
@@ -3884,6 +3963,7 @@ RZ_API void rz_agraph_free(RzAGraph *g) {
 		agraph_free_nodes (g);
 		rz_graph_free (g->graph);
 		rz_list_free (g->edges);
+		layout_cache_free (g->layout_cache);
 		rz_agraph_set_title (g, NULL);
 		sdb_free (g->db);
 		rz_cons_canvas_free (g->can);
@@ -779,7 +779,6 @@ static int __core_analysis_fcn(RzCore *core, ut64 at, ut64 from, int reftype, in
 	if (!fcn->name) {
 		fcn->name = rz_str_newf ("%s.%08"PFMT64x, fcnpfx, at);
 	}
-	rz_analysis_fcn_invalidate_read_ahead_cache ();
 	do {
 		RzFlagItem *f;
 		ut64 delta = rz_analysis_function_linear_size (fcn);
@@ -2308,7 +2307,7 @@ static void add_single_addr_xrefs(RzCore *core, ut64 addr, RzGraph *graph) {
 
 RZ_API RzGraph *rz_core_analysis_importxrefs(RzCore *core) {
 	RzBinInfo *info = rz_bin_get_info (core->bin);
-	RzBinObject *obj = rz_bin_cur_object (core->bin);
+	RzBinObject *obj = rz_bin_cur_object_items (core->bin, RZ_BIN_REQ_IMPORTS);
 	bool lit = info? info->has_lit: false;
 	bool va = core->io->va || core->bin->is_debugger;
 
@@ -4132,6 +4131,19 @@ static bool isSkippable(RzBinSymbol *s) {
 	return false;
 }
 
+static void analysis_phase_done(RzCore *core, const char *phase, ut64 *t) {
+	ut64 now = rz_time_now_mono ();
+	if (rz_config_get_i (core->config, "analysis.timing")) {
+		RzAnalysisOpCache *opcache = &core->analysis->opcache;
+		eprintf ("aa: %-10s %.3fs", phase, (double)(now - *t) / 1000000);
+		if (opcache->capacity) {
+			eprintf (" (opcache %" PFMT64u " hits, %" PFMT64u " misses)", opcache->hits, opcache->misses);
+		}
+		eprintf ("\n");
+	}
+	*t = now;
+}
+
 RZ_API int rz_core_analysis_all(RzCore *core) {
 	RzList *list;
 	RzListIter *iter;
@@ -4142,6 +4154,7 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 	RzBinSymbol *symbol;
 	int depth = core->analysis->opt.depth;
 	bool analysis_vars = rz_config_get_i (core->config, "analysis.vars");
+	ut64 t = rz_time_now_mono ();
 
 	/* Analyze Functions */
 	/* Entries */
@@ -4152,6 +4165,7 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 	} else {
 		rz_core_cmd0 (core, "af");
 	}
+	analysis_phase_done (core, "entry0", &t);
 
 	rz_core_task_yield (&core->tasks);
 
@@ -4173,6 +4187,7 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 			}
 		}
 	}
+	analysis_phase_done (core, "symbols", &t);
 	rz_core_task_yield (&core->tasks);
 	/* Main */
 	if ((binmain = rz_bin_get_sym (core->bin, RZ_BIN_SYM_MAIN))) {
@@ -4191,6 +4206,7 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 			rz_core_analysis_fcn (core, addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
 		}
 	}
+	analysis_phase_done (core, "entries", &t);
 	rz_core_task_yield (&core->tasks);
 	if (analysis_vars) {
 		/* Set fcn type to RZ_ANALYSIS_FCN_TYPE_SYM for symbols */
@@ -4203,6 +4219,7 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 				fcni->type = RZ_ANALYSIS_FCN_TYPE_SYM;
 			}
 		}
+		analysis_phase_done (core, "vars", &t);
 	}
 	rz_cons_break_pop ();
 	return true;
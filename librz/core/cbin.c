@@ -342,7 +342,13 @@ RZ_API int rz_core_bin_set_env(RzCore *r, RzBinFile *binfile) {
 			rz_config_set (r->config, "analysis.cpu", arch);
 		}
 		rz_asm_use (r->rasm, arch);
-		rz_core_bin_info (r, RZ_CORE_BIN_ACC_ALL, RZ_MODE_SET, va, NULL, NULL);
+		int action = RZ_CORE_BIN_ACC_ALL;
+		if (r->bin->lazy) {
+			// bin.lazy leaves them for later, ".is*" and friends flag them on demand
+			action &= ~(RZ_CORE_BIN_ACC_IMPORTS | RZ_CORE_BIN_ACC_SYMBOLS | RZ_CORE_BIN_ACC_RELOCS
+				| RZ_CORE_BIN_ACC_STRINGS | RZ_CORE_BIN_ACC_CLASSES);
+		}
+		rz_core_bin_info (r, action, RZ_MODE_SET, va, NULL, NULL);
 		rz_core_bin_set_cur (r, binfile);
 		return true;
 	}
@@ -1100,7 +1106,10 @@ static int bin_dwarf(RzCore *core, int mode) {
 		// TODO: complete and speed-up support for dwarf
 		RzBinDwarfDebugAbbrev *da = NULL;
 		da = rz_bin_dwarf_parse_abbrev (core->bin, mode);
-		RzBinDwarfDebugInfo *info = rz_bin_dwarf_parse_info (da, core->bin, mode);
+		// units are only all decoded up front to be printed, analysis decodes them as it goes
+		RzBinDwarfDebugInfo *info = mode == RZ_MODE_PRINT
+			? rz_bin_dwarf_parse_info (da, core->bin, mode)
+			: rz_bin_dwarf_index_info (da, core->bin);
 		HtUP /*<offset, List *<LocListEntry>*/ *loc_table = rz_bin_dwarf_parse_loc (core->bin, core->analysis->bits / 8);
 		// I suppose there is no reason the parse it for a printing purposes
 		if (info && mode != RZ_MODE_PRINT) {
@@ -1119,8 +1128,12 @@ static int bin_dwarf(RzCore *core, int mode) {
 		}
 		rz_bin_dwarf_free_debug_info (info);
 		rz_bin_dwarf_parse_aranges (core->bin, mode);
-		list = ownlist = rz_bin_dwarf_parse_line (core->bin, mode);
 		rz_bin_dwarf_free_debug_abbrev (da);
+		if (IS_MODE_SET (mode)) {
+			// the line table stays in the bin file, there are no rows to print
+			return rz_bin_dwarf_load_lines (core->bin, mode) != NULL;
+		}
+		list = ownlist = rz_bin_dwarf_parse_line (core->bin, mode);
 	}
 	if (!list) {
 		return false;
@@ -1313,6 +1326,12 @@ static int bin_source(RzCore *r, int mode) {
 		}
 		rz_list_free (list);
 	}
+	if (binfile->dwarf_lines) {
+		void **it;
+		rz_pvector_foreach (&binfile->dwarf_lines->files, it) {
+			rz_list_append (final_list, *it);
+		}
+	}
 	rz_cons_printf ("[Source file]\n");
 	RzList *uniqlist = rz_list_uniq (final_list, srclineCmp);
 	rz_list_foreach (uniqlist, iter2, srcline) {
@@ -1556,7 +1575,7 @@ static char *construct_reloc_name(RZ_NONNULL RzBinReloc *reloc, RZ_NULLABLE cons
 	return rz_strbuf_drain (buf);
 }
 
-static void set_bin_relocs(RzCore *r, RzBinReloc *reloc, ut64 addr, Sdb **db, char **sdb_module) {
+static void set_bin_relocs(RzCore *r, RzFlagBatch *flags, RzBinReloc *reloc, ut64 addr, Sdb **db, char **sdb_module) {
 	int bin_demangle = rz_config_get_i (r->config, "bin.demangle");
 	bool keep_lib = rz_config_get_i (r->config, "bin.demangle.libs");
 	const char *lang = rz_config_get (r->config, "bin.lang");
@@ -1636,16 +1655,15 @@ static void set_bin_relocs(RzCore *r, RzBinReloc *reloc, ut64 addr, Sdb **db, ch
 		}
 	}
 	rz_name_filter (flagname, 0);
-	RzFlagItem *fi = rz_flag_set (r->flags, flagname, addr, bin_reloc_size (reloc));
+	const char *realname = NULL;
 	if (demname) {
-		char *realname;
 		if (r->bin->prefix) {
 			realname = sdb_fmt ("%s.reloc.%s", r->bin->prefix, demname);
 		} else {
 			realname = sdb_fmt ("reloc.%s", demname);
 		}
-		rz_flag_item_set_realname (fi, realname);
 	}
+	rz_flag_batch_add (flags, flagname, realname, addr, bin_reloc_size (reloc), false);
 	free (demname);
 }
 
@@ -1707,6 +1725,7 @@ static int bin_relocs(RzCore *r, int mode, int va) {
 	Sdb *db = NULL;
 	PJ *pj = NULL;
 	char *sdb_module = NULL;
+	RzFlagBatch *flags = NULL;
 	int i = 0;
 
 	RZ_TIME_PROFILE_BEGIN;
@@ -1730,6 +1749,7 @@ static int bin_relocs(RzCore *r, int mode, int va) {
 		}
 	} else if (IS_MODE_SET (mode)) {
 		rz_flag_space_set (r->flags, RZ_FLAGS_FS_RELOCS);
+		flags = rz_flag_batch_new (r->flags);
 	}
 
 	rz_rbtree_foreach (relocs, iter, reloc, RzBinReloc, vrb) {
@@ -1740,7 +1760,7 @@ static int bin_relocs(RzCore *r, int mode, int va) {
 			 * Skip also file reloc because not useful for now.
 			 */
 		} else if (IS_MODE_SET (mode)) {
-			set_bin_relocs (r, reloc, addr, &db, &sdb_module);
+			set_bin_relocs (r, flags, reloc, addr, &db, &sdb_module);
 			add_metadata (r, reloc, addr, mode);
 		} else if (IS_MODE_SIMPLE (mode)) {
 			rz_cons_printf ("0x%08"PFMT64x"  %s\n", addr, reloc->import ? reloc->import->name : "");
@@ -1837,6 +1857,10 @@ static int bin_relocs(RzCore *r, int mode, int va) {
 		}
 		i++;
 	}
+	if (flags) {
+		rz_flag_batch_commit (flags);
+		rz_flag_batch_free (flags);
+	}
 	if (IS_MODE_JSON (mode)) {
 		// close Json output
 		pj_end (pj);
@@ -2287,6 +2311,7 @@ static int bin_symbols(RzCore *r, int mode, ut64 laddr, int va, ut64 at, const c
 
 	RzList *symbols = rz_bin_get_symbols (r->bin);
 	rz_spaces_push (&r->analysis->meta_spaces, "bin");
+	RzFlagBatch *flags = IS_MODE_SET (mode)? rz_flag_batch_new (r->flags): NULL;
 
 	if (IS_MODE_JSON (mode) && !printHere) {
 		pj_a (pj);
@@ -2351,6 +2376,8 @@ static int bin_symbols(RzCore *r, int mode, ut64 laddr, int va, ut64 at, const c
 			select_flag_space (r, symbol);
 			/* If that's a Classed symbol (method or so) */
 			if (sn.classname) {
+				// methods look up the flags set so far
+				rz_flag_batch_commit (flags);
 				RzFlagItem *fi = rz_flag_get (r->flags, sn.methflag);
 				if (r->bin->prefix) {
 					char *prname = rz_str_newf ("%s.%s", r->bin->prefix, sn.methflag);
@@ -2378,11 +2405,7 @@ static int bin_symbols(RzCore *r, int mode, ut64 laddr, int va, ut64 at, const c
 				char *fnp = (r->bin->prefix) ?
 					rz_str_newf ("%s.%s", r->bin->prefix, fn):
 					strdup (fn? fn: "");
-				RzFlagItem *fi = rz_flag_set (r->flags, fnp, addr, symbol->size);
-				if (fi) {
-					rz_flag_item_set_realname (fi, n);
-					fi->demangled = (bool)(size_t)sn.demname;
-				} else {
+				if (!rz_flag_batch_add (flags, fnp, n, addr, symbol->size, sn.demname != NULL)) {
 					if (fn) {
 						eprintf ("[Warning] Can't find flag (%s)\n", fn);
 					}
@@ -2505,6 +2528,10 @@ next:
 			break;
 		}
 	}
+	if (flags) {
+		rz_flag_batch_commit (flags);
+		rz_flag_batch_free (flags);
+	}
 	if (IS_MODE_NORMAL (mode)){
 		if (r->table_query) {
 			rz_table_query (table, r->table_query);
@@ -4161,6 +4188,13 @@ static int bin_header(RzCore *r, int mode) {
 	return false;
 }
 
+// demangles all the names at once, before they are flagged one by one
+static void bin_demangle_all(RzCore *r) {
+	if (r->bin->cur && rz_config_get_i (r->config, "bin.demangle")) {
+		rz_bin_demangle_all (r->bin->cur, rz_config_get (r->config, "bin.lang"), rz_config_get_i (r->config, "bin.demangle.threads"));
+	}
+}
+
 RZ_API int rz_core_bin_info(RzCore *core, int action, int mode, int va, RzCoreBinFilter *filter, const char *chksum) {
 	int ret = true;
 	const char *name = NULL;
@@ -4214,6 +4248,9 @@ RZ_API int rz_core_bin_info(RzCore *core, int action, int mode, int va, RzCoreBi
 	if ((action & RZ_CORE_BIN_ACC_SECTIONS_MAPPING)) {
 		ret &= bin_map_sections_to_segments (core->bin, mode);
 	}
+	if (IS_MODE_SET (mode) && (action & (RZ_CORE_BIN_ACC_RELOCS | RZ_CORE_BIN_ACC_IMPORTS | RZ_CORE_BIN_ACC_EXPORTS | RZ_CORE_BIN_ACC_SYMBOLS))) {
+		bin_demangle_all (core);
+	}
 	if (rz_config_get_i (core->config, "bin.relocs")) {
 		if ((action & RZ_CORE_BIN_ACC_RELOCS)) {
 			ret &= bin_relocs (core, mode, va);
@@ -318,6 +318,13 @@ static bool cb_analysis_ignbithints(void *user, void *data) {
 	return true;
 }
 
+static bool cb_analysis_opcache(void *user, void *data) {
+	RzCore *core = (RzCore*) user;
+	RzConfigNode *node = (RzConfigNode*) data;
+	rz_analysis_op_cache_set_capacity (&core->analysis->opcache, (ut32)node->i_value);
+	return true;
+}
+
 static bool cb_analsleep(void *user, void *data) {
 	RzCore *core = (RzCore*) user;
 	RzConfigNode *node = (RzConfigNode*) data;
@@ -1024,6 +1031,13 @@ static bool cb_binfilter(void *user, void *data) {
 	return true;
 }
 
+static bool cb_binlazy(void *user, void *data) {
+	RzCore *core = (RzCore*) user;
+	RzConfigNode *node = (RzConfigNode*) data;
+	core->bin->lazy = node->i_value;
+	return true;
+}
+
 /* BinDemangleCmd */
 static bool cb_bdc(void *user, void *data) {
 	RzCore *core = (RzCore*) user;
@@ -1141,6 +1155,8 @@ static bool cb_asmsyntax(void *user, void *data) {
 			return false;
 		}
 		rz_asm_set_syntax (core->rasm, syntax);
+		// the cached mnemonics may have been printed in the previous syntax
+		rz_analysis_op_cache_flush (&core->analysis->opcache);
 	}
 	return true;
 }
@@ -1980,6 +1996,13 @@ static bool cb_ioff(void *user, void *data) {
 	return true;
 }
 
+static bool cb_io_gzip_index(void *user, void *data) {
+	RzCore *core = (RzCore *) user;
+	RzConfigNode *node = (RzConfigNode *) data;
+	core->io->gzip_index = node->i_value;
+	return true;
+}
+
 static bool cb_io_oxff(void *user, void *data) {
 	RzCore *core = (RzCore *) user;
 	RzConfigNode *node = (RzConfigNode *) data;
@@ -1987,6 +2010,29 @@ static bool cb_io_oxff(void *user, void *data) {
 	return true;
 }
 
+static bool cb_io_pagecache(void *user, void *data) {
+	RzCore *core = (RzCore *) user;
+	RzConfigNode *node = (RzConfigNode *) data;
+	if (node->i_value > UT32_MAX) {
+		return false;
+	}
+	return rz_io_page_cache_resize (core->io, (ut32)node->i_value, core->io->page_cache.page_size);
+}
+
+static bool cb_io_pagecache_size(void *user, void *data) {
+	RzCore *core = (RzCore *) user;
+	RzConfigNode *node = (RzConfigNode *) data;
+	if (node->i_value > UT16_MAX + 1) {
+		eprintf ("io.pagecache.size must be a power of two between 16 and 64K\n");
+		return false;
+	}
+	if (!rz_io_page_cache_resize (core->io, core->io->page_cache.capacity, (ut32)node->i_value)) {
+		eprintf ("io.pagecache.size must be a power of two between 16 and 64K\n");
+		return false;
+	}
+	return true;
+}
+
 static bool cb_filepath(void *user, void *data) {
 	RzCore *core = (RzCore *) user;
 	RzConfigNode *node = (RzConfigNode *) data;
@@ -2523,6 +2569,24 @@ static bool cb_binminstr(void *user, void *data) {
 	return true;
 }
 
+static bool cb_binstrthreads(void *user, void *data) {
+	RzCore *core = (RzCore *) user;
+	RzConfigNode *node = (RzConfigNode *) data;
+	if (core->bin) {
+		core->bin->str_threads = node->i_value;
+	}
+	return true;
+}
+
+static bool cb_bindwarfthreads(void *user, void *data) {
+	RzCore *core = (RzCore *) user;
+	RzConfigNode *node = (RzConfigNode *) data;
+	if (core->bin) {
+		core->bin->dwarf_threads = node->i_value;
+	}
+	return true;
+}
+
 static bool cb_searchin(void *user, void *data) {
 	RzCore *core = (RzCore*)user;
 	RzConfigNode *node = (RzConfigNode*) data;
@@ -2907,6 +2971,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 		"analysis.fcn", "analysis.bb",
 	NULL);
 	SETI ("analysis.timeout", 0, "Stop analyzing after a couple of seconds");
+	SETBPREF ("analysis.timing", "false", "Report the time spent in each phase of aa");
+	SETICB ("analysis.opcache", 0, &cb_analysis_opcache, "Number of decoded instructions cached by rz_analysis_op (0 = disabled)");
 	SETCB ("analysis.jmp.retpoline", "true", &cb_analysis_jmpretpoline, "Analyze retpolines, may be slower if not needed");
 	SETICB ("analysis.jmp.tailcall", 0, &cb_analysis_jmptailcall, "Consume a branch as a call if delta is big");
 
@@ -3179,10 +3245,12 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETDESC (n, "Filter strings");
 	SETOPTIONS (n, "a", "8", "p", "e", "u", "i", "U", "f", NULL);
 	SETCB ("bin.filter", "true", &cb_binfilter, "Filter symbol names to fix dupped names");
+	SETCB ("bin.lazy", "false", &cb_binlazy, "Load symbols, imports, relocs, strings and classes on first use instead of at startup");
 	SETCB ("bin.force", "", &cb_binforce, "Force that rbin plugin");
 	SETPREF ("bin.lang", "", "Language for bin.demangle");
 	SETBPREF ("bin.demangle", "true", "Import demangled symbols from RzBin");
 	SETBPREF ("bin.demangle.libs", "false", "Show library name on demangled symbols names");
+	SETI ("bin.demangle.threads", 1, "Number of threads demangling the symbol names before they are flagged (0 = one per core)");
 	SETI ("bin.baddr", -1, "Base address of the binary");
 	SETI ("bin.laddr", 0, "Base address for loading library ('*.so')");
 	SETCB ("bin.dbginfo", "true", &cb_bindbginfo, "Load debug information at startup if available");
@@ -3190,6 +3258,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETICB ("bin.minstr", 0, &cb_binminstr, "Minimum string length for rz_bin");
 	SETICB ("bin.maxstr", 0, &cb_binmaxstr, "Maximum string length for rz_bin");
 	SETICB ("bin.maxstrbuf", 1024*1024*10, & cb_binmaxstrbuf, "Maximum size of range to load strings from");
+	SETICB ("bin.str.threads", 1, &cb_binstrthreads, "Number of threads scanning the data sections for strings (0 = one per core)");
+	SETICB ("bin.dwarf.threads", 1, &cb_bindwarfthreads, "Number of threads decoding the DWARF line units (0 = one per core)");
 	n = NODECB ("bin.str.enc", "guess", &cb_binstrenc);
 	SETDESC (n, "Default string encoding of binary");
 	SETOPTIONS (n, "ascii", "latin1", "utf8", "utf16le", "utf32le", "utf16be", "utf32be", "guess", NULL);
@@ -3283,6 +3353,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETI ("diff.to", 0, "Set destination diffing address for px (uses cc command)");
 	SETBPREF ("diff.bare", "false", "Never show function names in diff output");
 	SETBPREF ("diff.levenstein", "false", "Use faster (and buggy) levenstein algorithm for buffer distance diffing");
+	SETI ("diff.threads", 1, "Number of threads used to compare functions in code diffing (0 = one per core)");
 
 	/* dir */
 	SETI ("dir.depth", 10,  "Maximum depth when searching recursively for files");
@@ -3629,6 +3700,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF ("search.flags", "true", "All search results are flagged, otherwise only printed");
 	SETBPREF ("search.overlap", "false", "Look for overlapped search hits");
 	SETI ("search.maxhits", 0, "Maximum number of hits (0: no limit)");
+	SETI ("search.threads", 1, "Number of threads scanning the blocks of keyword searches (0 = one per core)");
 	SETI ("search.from", -1, "Search start address");
 	n = NODECB ("search.in", "io.maps", &cb_searchin);
 	SETDESC (n, "Specify search boundaries");
@@ -3660,8 +3732,11 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB ("io.pcache", "false", &cb_iopcache, "io.cache for p-level");
 	SETCB ("io.pcache.write", "false", &cb_iopcachewrite, "Enable write-cache");
 	SETCB ("io.pcache.read", "false", &cb_iopcacheread, "Enable read-cache");
+	SETICB ("io.pagecache", RZ_IO_PAGE_CACHE_PAGES, &cb_io_pagecache, "Number of pages kept in the IO read cache (0 = disabled)");
+	SETICB ("io.pagecache.size", RZ_IO_PAGE_CACHE_PAGESIZE, &cb_io_pagecache_size, "Size of the pages of the IO read cache (power of two)");
 	SETCB ("io.ff", "true", &cb_ioff, "Fill invalid buffers with 0xff instead of returning error");
 	SETBPREF ("io.exec", "true", "See !!rizin -h~-x");
+	SETCB ("io.gzip.index", "false", &cb_io_gzip_index, "Save the index of gzip:// files to <file>.rzidx to reopen them faster");
 	SETICB ("io.0xff", 0xff, &cb_io_oxff, "Use this value instead of 0xff to fill unallocated areas");
 	SETCB ("io.aslr", "false", &cb_ioaslr, "Disable ASLR for spawn and such");
 	SETCB ("io.va", "true", &cb_iova, "Use virtual address layout");
@@ -1680,9 +1680,12 @@ RZ_IPI int rz_cmd_tasks(void *data, const char *input) {
 	case ' ': // "& "
 	case '_': // "&_"
 	case 't': { // "&t"
-		task_enqueue (core, input + 1, input[0] == 't');
+		task_enqueue (core, input + 1, input[0] == 't', false);
 		break;
 	}
+	case 'r': // "&r"
+		task_enqueue (core, input + 1, false, true);
+		break;
 	}
 	return 0;
 }
@@ -641,6 +641,21 @@ RZ_API RzCmdStatus rz_cmd_call_parsed_args(RzCmd *cmd, RzCmdParsedArgs *args) {
 	return call_cd (cmd, cd, args);
 }
 
+/**
+ * \brief Call the command in \p args only if its descriptor is read-only
+ *
+ * Unlike rz_cmd_call_parsed_args, the input is not offered to the core
+ * plugins, which cannot tell whether they change any state.
+ */
+RZ_API RzCmdStatus rz_cmd_call_read_only(RzCmd *cmd, RzCmdParsedArgs *args) {
+	rz_return_val_if_fail (cmd && args, RZ_CMD_STATUS_INVALID);
+	RzCmdDesc *cd = rz_cmd_get_desc (cmd, rz_cmd_parsed_args_cmd (args));
+	if (!cd || !rz_cmd_desc_is_read_only (cd)) {
+		return RZ_CMD_STATUS_INVALID;
+	}
+	return call_cd (cmd, cd, args);
+}
+
 static size_t strlen0(const char *s) {
 	return s? strlen (s): 0;
 }
@@ -1853,6 +1868,18 @@ RZ_API bool rz_cmd_desc_has_handler(RzCmdDesc *cd) {
 	return false;
 }
 
+/**
+ * \brief Whether the handler of \p cd may run in a read-only task
+ */
+RZ_API bool rz_cmd_desc_is_read_only(RzCmdDesc *cd) {
+	rz_return_val_if_fail (cd, false);
+	bool read_only = cd->read_only;
+	if (cd->type == RZ_CMD_DESC_TYPE_GROUP && cd->d.group_data.exec_cd) {
+		read_only |= cd->d.group_data.exec_cd->read_only;
+	}
+	return read_only && rz_cmd_desc_has_handler (cd);
+}
+
 RZ_API bool rz_cmd_desc_remove(RzCmd *cmd, RzCmdDesc *cd) {
 	rz_return_val_if_fail (cmd && cd, false);
 	if (cd->parent) {
@@ -25,6 +25,7 @@ static const RzCmdDescDetail grep_details[5];
 static const RzCmdDescArg hash_bang_args[3];
 static const RzCmdDescArg tasks_args[2];
 static const RzCmdDescArg tasks_transient_args[2];
+static const RzCmdDescArg tasks_read_only_args[2];
 static const RzCmdDescArg tasks_output_args[2];
 static const RzCmdDescArg tasks_break_args[2];
 static const RzCmdDescArg tasks_delete_args[2];
@@ -49,6 +50,7 @@ static const RzCmdDescArg push_escaped_args[2];
 static const RzCmdDescArg env_args[3];
 static const RzCmdDescArg ls_args[2];
 static const RzCmdDescArg project_save_args[2];
+static const RzCmdDescArg project_export_args[2];
 static const RzCmdDescArg project_open_args[2];
 static const RzCmdDescArg project_open_no_bin_io_args[2];
 static const RzCmdDescArg uniq_args[2];
@@ -80,6 +82,7 @@ static const RzCmdDescArg zign_add_fcn_args[3];
 static const RzCmdDescArg zign_load_sdb_args[2];
 static const RzCmdDescArg zign_save_sdb_args[2];
 static const RzCmdDescArg zign_load_gzip_sdb_args[2];
+static const RzCmdDescArg zign_save_compiled_args[2];
 static const RzCmdDescArg zign_flirt_dump_args[2];
 static const RzCmdDescArg zign_flirt_scan_args[2];
 static const RzCmdDescArg zign_cmp_args[2];
@@ -158,6 +161,15 @@ static const RzCmdDescHelp tasks_transient_help = {
 	.args = tasks_transient_args,
 };
 
+static const RzCmdDescArg tasks_read_only_args[] = {
+	{ .name = "cmd", .type = RZ_CMD_ARG_TYPE_CMD_LAST, },
+	{ 0 },
+};
+static const RzCmdDescHelp tasks_read_only_help = {
+	.summary = "Run <cmd> in parallel with the other read-only tasks if it is flagged read-only, as a regular task otherwise",
+	.args = tasks_read_only_args,
+};
+
 static const RzCmdDescArg tasks_output_args[] = {
 	{ .name = "n", .type = RZ_CMD_ARG_TYPE_NUM, },
 	{ 0 },
@@ -576,6 +588,15 @@ static const RzCmdDescHelp project_save_help = {
 	.args = project_save_args,
 };
 
+static const RzCmdDescArg project_export_args[] = {
+	{ .name = "project.rzdb", .type = RZ_CMD_ARG_TYPE_FILE, },
+	{ 0 },
+};
+static const RzCmdDescHelp project_export_help = {
+	.summary = "Export a project in the text format",
+	.args = project_export_args,
+};
+
 static const RzCmdDescArg project_open_args[] = {
 	{ .name = "project.rzdb", .type = RZ_CMD_ARG_TYPE_FILE, },
 	{ 0 },
@@ -1179,6 +1200,15 @@ static const RzCmdDescHelp zign_load_gzip_sdb_help = {
 	.args = zign_load_gzip_sdb_args,
 };
 
+static const RzCmdDescArg zign_save_compiled_args[] = {
+	{ .name = "filename", .type = RZ_CMD_ARG_TYPE_FILE, },
+	{ 0 },
+};
+static const RzCmdDescHelp zign_save_compiled_help = {
+	.summary = "Save zignatures to compiled file (loaded with zo)",
+	.args = zign_save_compiled_args,
+};
+
 static const RzCmdDescHelp zf_help = {
 	.summary = "Manage FLIRT signatures",
 };
@@ -1493,6 +1523,8 @@ RZ_IPI void newshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *and__cd = rz_cmd_desc_group_modes_new (core->rcmd, root_cd, "&", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON, rz_tasks_handler, &tasks_help, &and__help);
 	rz_warn_if_fail (and__cd);	RzCmdDesc *tasks_transient_cd = rz_cmd_desc_argv_new (core->rcmd, and__cd, "&t", rz_tasks_transient_handler, &tasks_transient_help);
 	rz_warn_if_fail (tasks_transient_cd);
+	RzCmdDesc *tasks_read_only_cd = rz_cmd_desc_argv_new (core->rcmd, and__cd, "&r", rz_tasks_read_only_handler, &tasks_read_only_help);
+	rz_warn_if_fail (tasks_read_only_cd);
 	RzCmdDesc *tasks_output_cd = rz_cmd_desc_argv_new (core->rcmd, and__cd, "&=", rz_tasks_output_handler, &tasks_output_help);
 	rz_warn_if_fail (tasks_output_cd);
 	RzCmdDesc *tasks_break_cd = rz_cmd_desc_argv_new (core->rcmd, and__cd, "&b", rz_tasks_break_handler, &tasks_break_help);
@@ -1593,6 +1625,8 @@ RZ_IPI void newshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *P_cd = rz_cmd_desc_group_new (core->rcmd, root_cd, "P", NULL, NULL, &P_help);
 	rz_warn_if_fail (P_cd);	RzCmdDesc *project_save_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Ps", rz_project_save_handler, &project_save_help);
 	rz_warn_if_fail (project_save_cd);
+	RzCmdDesc *project_export_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Pe", rz_project_export_handler, &project_export_help);
+	rz_warn_if_fail (project_export_cd);
 	RzCmdDesc *project_open_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Po", rz_project_open_handler, &project_open_help);
 	rz_warn_if_fail (project_open_cd);
 	RzCmdDesc *project_open_no_bin_io_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Poo", rz_project_open_no_bin_io_handler, &project_open_no_bin_io_help);
@@ -1607,8 +1641,14 @@ RZ_IPI void newshell_cmddescs_init(RzCore *core) {
 	rz_warn_if_fail (cmd_type_cd);
 	RzCmdDesc *uniq_cd = rz_cmd_desc_argv_new (core->rcmd, root_cd, "uniq", rz_uniq_handler, &uniq_help);
 	rz_warn_if_fail (uniq_cd);
+	if (uniq_cd) {
+		uniq_cd->read_only = true;
+	}
 	RzCmdDesc *uname_cd = rz_cmd_desc_argv_new (core->rcmd, root_cd, "uname", rz_uname_handler, &uname_help);
 	rz_warn_if_fail (uname_cd);
+	if (uname_cd) {
+		uname_cd->read_only = true;
+	}
 	RzCmdDesc *cmd_visual_cd = rz_cmd_desc_oldinput_new (core->rcmd, root_cd, "V", rz_cmd_visual, &cmd_visual_help);
 	rz_warn_if_fail (cmd_visual_cd);
 	RzCmdDesc *cmd_panels_cd = rz_cmd_desc_oldinput_new (core->rcmd, root_cd, "v", rz_cmd_panels, &cmd_panels_help);
@@ -1714,6 +1754,8 @@ RZ_IPI void newshell_cmddescs_init(RzCore *core) {
 	rz_warn_if_fail (zign_save_sdb_cd);
 	RzCmdDesc *zign_load_gzip_sdb_cd = rz_cmd_desc_argv_new (core->rcmd, zo_cd, "zoz", rz_zign_load_gzip_sdb_handler, &zign_load_gzip_sdb_help);
 	rz_warn_if_fail (zign_load_gzip_sdb_cd);
+	RzCmdDesc *zign_save_compiled_cd = rz_cmd_desc_argv_new (core->rcmd, zo_cd, "zoc", rz_zign_save_compiled_handler, &zign_save_compiled_help);
+	rz_warn_if_fail (zign_save_compiled_cd);
 	RzCmdDesc *zf_cd = rz_cmd_desc_group_new (core->rcmd, z_cd, "zf", NULL, NULL, &zf_help);
 	rz_warn_if_fail (zf_cd);	RzCmdDesc *zign_flirt_dump_cd = rz_cmd_desc_argv_new (core->rcmd, zf_cd, "zfd", rz_zign_flirt_dump_handler, &zign_flirt_dump_help);
 	rz_warn_if_fail (zign_flirt_dump_cd);
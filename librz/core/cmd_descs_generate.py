@@ -90,6 +90,9 @@ DEFINE_INNER_TEMPLATE = '''\tRzCmdDesc *{cname}_cd = rz_cmd_desc_inner_new (core
 \trz_warn_if_fail ({cname}_cd);'''
 DEFINE_FAKE_TEMPLATE = '''\tRzCmdDesc *{cname}_cd = rz_cmd_desc_fake_new (core->rcmd, {parent_cname}_cd, {name}, &{help_cname});
 \trz_warn_if_fail ({cname}_cd);'''
+SET_READ_ONLY_TEMPLATE = '''\tif ({cname}_cd) {{
+\t\t{cname}_cd->read_only = true;
+\t}}'''
 
 CD_TYPE_OLDINPUT = 'RZ_CMD_DESC_TYPE_OLDINPUT'
 CD_TYPE_GROUP = 'RZ_CMD_DESC_TYPE_GROUP'
@@ -270,6 +273,7 @@ class CmdDesc(object):
         self.exec_cd = None
         self.modes = c.get('modes')
         self.handler = c.get('handler')
+        self.read_only = c.get('read_only', False)
         # RzCmdDescHelp fields
         self.summary = strip(c['summary'])
         self.description = strip(c.get('description'))
@@ -421,6 +425,11 @@ class CmdDesc(object):
     def __repr__(self):
         return self._str_tab()
 
+def read_only2set(cd):
+    if not cd or not cd.read_only:
+        return ''
+    return '\n' + SET_READ_ONLY_TEMPLATE.format(cname=cd.cname)
+
 def createcd(cd):
     if cd.type == CD_TYPE_ARGV:
         return DEFINE_ARGV_TEMPLATE.format(
@@ -429,7 +438,7 @@ def createcd(cd):
             name=strornull(cd.name),
             handler_cname=cd.get_handler_cname(),
             help_cname=cd.get_help_cname(),
-        )
+        ) + read_only2set(cd)
     elif cd.type == CD_TYPE_ARGV_MODES:
         return DEFINE_ARGV_MODES_TEMPLATE.format(
             cname=cd.cname,
@@ -438,7 +447,7 @@ def createcd(cd):
             modes=' | '.join(cd.modes),
             handler_cname=cd.get_handler_cname(),
             help_cname=cd.get_help_cname(),
-        )
+        ) + read_only2set(cd)
     elif cd.type == CD_TYPE_FAKE:
         return DEFINE_FAKE_TEMPLATE.format(
             cname=cd.cname,
@@ -462,7 +471,7 @@ def createcd(cd):
             name=strornull(cd.name),
             handler_cname=cd.get_handler_cname(),
             help_cname=cd.get_help_cname(),
-        )
+        ) + read_only2set(cd)
         out += '\n'.join([createcd(child) for child in cd.subcommands or []])
         return out
     elif cd.type == CD_TYPE_GROUP and cd.exec_cd and cd.exec_cd.type == CD_TYPE_ARGV_MODES:
@@ -474,7 +483,7 @@ def createcd(cd):
             handler_cname=cd.exec_cd.get_handler_cname(),
             help_cname_ref='&' + cd.exec_cd.get_help_cname(),
             group_help_cname=cd.get_help_cname(),
-        )
+        ) + read_only2set(cd.exec_cd)
         out += '\n'.join([createcd(child) for child in cd.subcommands[1:] or []])
         return out
     elif cd.type == CD_TYPE_GROUP:
@@ -485,7 +494,7 @@ def createcd(cd):
             handler_cname=(cd.exec_cd and cd.exec_cd.get_handler_cname()) or 'NULL',
             help_cname_ref=(cd.exec_cd and '&' + cd.exec_cd.get_help_cname()) or 'NULL',
             group_help_cname=cd.get_help_cname(),
-        )
+        ) + read_only2set(cd.exec_cd)
         subcommands = (cd.exec_cd and cd.subcommands and cd.subcommands[1:]) or cd.subcommands
         out += '\n'.join([createcd(child) for child in subcommands or []])
         return out
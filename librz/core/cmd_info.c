@@ -764,7 +764,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 			goto done;
 		}
 		case 's': { // "is"
-			RzBinObject *obj = rz_bin_cur_object (core->bin);
+			RzBinObject *obj = rz_bin_cur_object_items (core->bin, RZ_BIN_REQ_SYMBOLS);
 			// Case for isj.
 			if (input[1] == 'j' && input[2] == '.') {
 				mode = RZ_MODE_JSON;
@@ -911,7 +911,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 			}
 			break;
 		case 'i': { // "ii"
-			RzBinObject *obj = rz_bin_cur_object (core->bin);
+			RzBinObject *obj = rz_bin_cur_object_items (core->bin, RZ_BIN_REQ_IMPORTS);
 			RBININFO ("imports", RZ_CORE_BIN_ACC_IMPORTS, NULL,
 				(obj && obj->imports)? rz_list_length (obj->imports): 0);
 			break;
@@ -999,7 +999,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 				}
 				RBININFO ("strings", RZ_CORE_BIN_ACC_RAW_STRINGS, NULL, 0);
 			} else {
-				RzBinObject *obj = rz_bin_cur_object (core->bin);
+				RzBinObject *obj = rz_bin_cur_object_items (core->bin, RZ_BIN_REQ_STRINGS);
 				if (input[1] == 'q') {
 					mode = (input[2] == 'q')
 					? RZ_MODE_SIMPLEST
@@ -1019,7 +1019,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 			} else if (input[1] == 'g') {
 				RzBinClass *cls;
 				RzListIter *iter;
-				RzBinObject *obj = rz_bin_cur_object (core->bin);
+				RzBinObject *obj = rz_bin_cur_object_items (core->bin, RZ_BIN_REQ_CLASSES);
 				if (!obj) {
 					break;
 				}
@@ -1048,7 +1048,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 				RzBinClass *cls;
 				RzBinSymbol *sym;
 				RzListIter *iter, *iter2;
-				RzBinObject *obj = rz_bin_cur_object (core->bin);
+				RzBinObject *obj = rz_bin_cur_object_items (core->bin, RZ_BIN_REQ_CLASSES);
 				if (!obj) {
 					break;
 				}
@@ -1167,7 +1167,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 					goto done;
 				}
 			} else { // "ic"
-				RzBinObject *obj = rz_bin_cur_object (core->bin);
+				RzBinObject *obj = rz_bin_cur_object_items (core->bin, RZ_BIN_REQ_CLASSES);
 				if (obj && obj->classes) {
 					int len = rz_list_length (obj->classes);
 					RBININFO ("classes", RZ_CORE_BIN_ACC_CLASSES, NULL, len);
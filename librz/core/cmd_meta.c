@@ -134,14 +134,31 @@ static const char *help_msg_Cvs[] = {
 	NULL
 };
 
+// removes the line info at offset, both the user entries and the DWARF rows
 static int remove_meta_offset(RzCore *core, ut64 offset) {
 	char aoffset[64];
+	RzBinFile *bf = rz_bin_cur (core->bin);
+	if (!bf) {
+		return false;
+	}
 	char *aoffsetptr = sdb_itoa (offset, aoffset, 16);
 	if (!aoffsetptr) {
 		eprintf ("Failed to convert %"PFMT64x" to a key", offset);
 		return -1;
 	}
-	return sdb_unset (core->bin->cur->sdb_addrinfo, aoffsetptr, 0);
+	bool removed = bf->dwarf_lines && rz_bin_dwarf_line_table_del (bf->dwarf_lines, offset);
+	char *file_line = bf->sdb_addrinfo? sdb_get (bf->sdb_addrinfo, aoffsetptr, 0): NULL;
+	if (file_line) {
+		// CL also adds the reverse file:line entry
+		char *back = sdb_get (bf->sdb_addrinfo, file_line, 0);
+		if (back && !strcmp (back, aoffsetptr)) {
+			sdb_unset (bf->sdb_addrinfo, file_line, 0);
+		}
+		free (back);
+		free (file_line);
+		removed |= sdb_unset (bf->sdb_addrinfo, aoffsetptr, 0);
+	}
+	return removed;
 }
 
 static bool print_meta_offset(RzCore *core, ut64 addr) {
@@ -190,6 +207,16 @@ static ut64 filter_offset = UT64_MAX;
 static int filter_format = 0;
 static size_t filter_count = 0;
 
+static void print_dwarf_line(RzBinDwarfLineTable *lines, const RzBinDwarfLineEntry *e) {
+	const char *file = rz_bin_dwarf_line_table_file (lines, e->file);
+	if (filter_format) {
+		rz_cons_printf ("CL 0x%"PFMT64x" %s:%u\n", e->address, file, e->line);
+	} else {
+		rz_cons_printf ("file: %s\nline: %u\n", file, e->line);
+	}
+	filter_count++;
+}
+
 static bool print_addrinfo (void *user, const char *k, const char *v) {
 	ut64 offset = sdb_atoi (k);
 	if (!offset || offset == UT64_MAX) {
@@ -218,6 +245,13 @@ static bool print_addrinfo (void *user, const char *k, const char *v) {
 	return true;
 }
 
+static void print_dwarf_lines(RzBinDwarfLineTable *lines) {
+	RzBinDwarfLineEntry *e;
+	rz_vector_foreach (&lines->entries, e) {
+		print_dwarf_line (lines, e);
+	}
+}
+
 static int cmd_meta_add_fileline(Sdb *s, char *fileline, ut64 offset) {
 	char aoffset[64];
 	char *aoffsetptr = sdb_itoa (offset, aoffset, 16);
@@ -275,8 +309,14 @@ static int cmd_meta_lineinfo(RzCore *core, const char *input) {
 	if (all) {
 		if (remove) {
 			sdb_reset (core->bin->cur->sdb_addrinfo);
+			rz_bin_dwarf_line_table_free (core->bin->cur->dwarf_lines);
+			core->bin->cur->dwarf_lines = NULL;
 		} else {
+			filter_offset = UT64_MAX;
 			sdb_foreach (core->bin->cur->sdb_addrinfo, print_addrinfo, NULL);
+			if (core->bin->cur->dwarf_lines) {
+				print_dwarf_lines (core->bin->cur->dwarf_lines);
+			}
 		}
 		free (pheap);
 		return 0;
@@ -321,6 +361,13 @@ static int cmd_meta_lineinfo(RzCore *core, const char *input) {
 		filter_offset = offset;
 		filter_count = 0;
 		sdb_foreach (core->bin->cur->sdb_addrinfo, print_addrinfo, NULL);
+		RzBinDwarfLineTable *lines = core->bin->cur->dwarf_lines;
+		if (filter_count == 0 && lines) {
+			const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (lines, offset);
+			if (e && e->address == offset) {
+				print_dwarf_line (lines, e);
+			}
+		}
 		if (filter_count == 0) {
 			print_meta_offset (core, offset);
 		}
@@ -484,6 +484,7 @@ static void cmd_omfg(RzCore *core, const char *input) {
 			}
 			break;
 		}
+		rz_io_page_cache_flush (core->io);
 	}
 }
 
@@ -517,6 +518,7 @@ static void cmd_omf(RzCore *core, const char *input) {
 			}
 		}
 	}
+	rz_io_page_cache_flush (core->io);
 	free (arg);
 }
 
@@ -947,7 +949,6 @@ struct __rebase_struct {
 	RzList *old_sections;
 	ut64 old_base;
 	ut64 diff;
-	int type;
 };
 
 #define __is_inside_section(item_addr, section)\
@@ -968,25 +969,6 @@ static bool __rebase_flags(RzFlagItem *flag, void *user) {
 	return true;
 }
 
-static bool __rebase_refs_i(void *user, const ut64 k, const void *v) {
-	struct __rebase_struct *reb = (void *)user;
-	RzAnalysisRef *ref = (RzAnalysisRef *)v;
-	ref->addr += reb->diff;
-	ref->at += reb->diff;
-	if (reb->type) {
-		rz_analysis_xrefs_set (reb->core->analysis, ref->addr, ref->at, ref->type);
-	} else {
-		rz_analysis_xrefs_set (reb->core->analysis, ref->at, ref->addr, ref->type);
-	}
-	return true;
-}
-
-static bool __rebase_refs(void *user, const ut64 k, const void *v) {
-	HtUP *ht = (HtUP *)v;
-	ht_up_foreach (ht, __rebase_refs_i, user);
-	return true;
-}
-
 static void __rebase_everything(RzCore *core, RzList *old_sections, ut64 old_base) {
 	RzListIter *it, *itit, *ititit;
 	RzAnalysisFunction *fcn;
@@ -1036,17 +1018,7 @@ static void __rebase_everything(RzCore *core, RzList *old_sections, ut64 old_bas
 	rz_meta_rebase (core->analysis, diff);
 
 	// REFS
-	HtUP *old_refs = core->analysis->dict_refs;
-	HtUP *old_xrefs = core->analysis->dict_xrefs;
-	core->analysis->dict_refs = NULL;
-	core->analysis->dict_xrefs = NULL;
-	rz_analysis_xrefs_init (core->analysis);
-	reb.type = 0;
-	ht_up_foreach (old_refs, __rebase_refs, &reb);
-	reb.type = 1;
-	ht_up_foreach (old_xrefs, __rebase_refs, &reb);
-	ht_up_free (old_refs);
-	ht_up_free (old_xrefs);
+	rz_analysis_xrefs_rebase (core->analysis, diff);
 
 	// BREAKPOINTS
 	rz_debug_bp_rebase (core->dbg, old_base, new_base);
@@ -108,6 +108,7 @@ static const char *help_msg_amper[] = {
 	"Usage:", "&[-|<cmd>]", "Manage tasks (WARNING: Experimental. Use with caution!)",
 	"&", " <cmd>", "run <cmd> in a new background task",
 	"&t", " <cmd>", "run <cmd> in a new transient background task (auto-delete when it is finished)",
+	"&r", " <cmd>", "run <cmd> in parallel with the other &r tasks if it is flagged read-only",
 	"&", "", "list all tasks",
 	"&j", "", "list all tasks (in JSON)",
 	"&=", " 3", "show output of task 3",
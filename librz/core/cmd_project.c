@@ -10,6 +10,14 @@ RZ_IPI RzCmdStatus rz_project_save_handler(RzCore *core, int argc, const char **
 	return RZ_CMD_STATUS_OK;
 }
 
+RZ_IPI RzCmdStatus rz_project_export_handler(RzCore *core, int argc, const char **argv) {
+	RzProjectErr err = rz_project_export_file (core, argv[1]);
+	if (err != RZ_PROJECT_ERR_SUCCESS) {
+		eprintf ("Failed to export project: %s\n", rz_project_err_message (err));
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
 static RzCmdStatus project_open(RzCore *core, int args, const char **argv, bool load_bin_io) {
 	RzSerializeResultInfo *res = rz_serialize_result_info_new ();
 	RzProjectErr err = rz_project_load_file (core, argv[1], load_bin_io, res);
@@ -12,6 +12,7 @@
 
 #define AES_SEARCH_LENGTH 40
 #define PRIVATE_KEY_SEARCH_LENGTH 11
+#define KEYWORD_SEARCH_CHUNK 0x10000
 
 static const char *help_msg_search_esil[] = {
 	"/E", " [esil-expr]", "search offsets matching a specific esil expression",
@@ -2328,6 +2329,26 @@ static void do_asm_search(RzCore *core, struct search_parameters *param, const c
 	rz_cons_break_pop ();
 }
 
+struct search_read_ctx {
+	RzCore *core;
+	struct search_parameters *param;
+	ut64 to;
+};
+
+static bool search_read_cb(void *user, ut64 addr, ut8 *buf, int len) {
+	struct search_read_ctx *ctx = user;
+	print_search_progress (addr, ctx->to, ctx->core->search->nhits, ctx->param);
+	if (rz_cons_is_breaked ()) {
+		eprintf ("\n\n");
+		return false;
+	}
+	if (!rz_io_is_valid_offset (ctx->core->io, addr, 0)) {
+		return false;
+	}
+	(void)rz_io_read_at (ctx->core->io, addr, buf, len);
+	return true;
+}
+
 static void do_string_search(RzCore *core, RzInterval search_itv, struct search_parameters *param) {
 	ut64 at;
 	ut8 *buf;
@@ -2353,7 +2374,12 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 		/* TODO: launch search in background support */
 		// REMOVE OLD FLAGS rz_core_cmdf (core, "f-%s*", rz_config_get (core->config, "search.prefix"));
 		rz_search_set_callback (core->search, &_cb_hit, param);
-		if (!(buf = malloc (core->blocksize))) {
+		// keywords spanning two reads are still found, so read more at once
+		const ut64 bsize = search->mode == RZ_SEARCH_KEYWORD
+			? RZ_MAX (core->blocksize, KEYWORD_SEARCH_CHUNK)
+			: core->blocksize;
+		const int threads = rz_config_get_i (core->config, "search.threads");
+		if (!(buf = malloc (bsize))) {
 			return;
 		}
 		if (search->bckwrds) {
@@ -2393,41 +2419,50 @@ static void do_string_search(RzCore *core, RzInterval search_itv, struct search_
 					from1 = search->bckwrds? to: from,
 					to1 = search->bckwrds? from: to;
 			ut64 len;
-			for (at = from1; at != to1; at = search->bckwrds? at - len: at + len) {
-				print_search_progress (at, to1, search->nhits, param);
-				if (rz_cons_is_breaked ()) {
-					eprintf ("\n\n");
-					break;
+			if (search->mode == RZ_SEARCH_KEYWORD && !search->bckwrds) {
+				struct search_read_ctx ctx = { core, param, to };
+				rz_search_update_range (search, from, to, bsize, threads, search_read_cb, &ctx);
+				at = to;
+				if (core->search->maxhits > 0 && core->search->nhits >= core->search->maxhits) {
+					goto done;
 				}
-				if (search->bckwrds) {
-					len = RZ_MIN (core->blocksize, at - from);
-					// TODO prefix_read_at
-					if (!rz_io_is_valid_offset (core->io, at - len, 0)) {
+			} else {
+				for (at = from1; at != to1; at = search->bckwrds? at - len: at + len) {
+					print_search_progress (at, to1, search->nhits, param);
+					if (rz_cons_is_breaked ()) {
+						eprintf ("\n\n");
 						break;
 					}
-					(void)rz_io_read_at (core->io, at - len, buf, len);
-				} else {
-					len = RZ_MIN (core->blocksize, to - at);
-					if (!rz_io_is_valid_offset (core->io, at, 0)) {
-						break;
+					if (search->bckwrds) {
+						len = RZ_MIN (bsize, at - from);
+						// TODO prefix_read_at
+						if (!rz_io_is_valid_offset (core->io, at - len, 0)) {
+							break;
+						}
+						(void)rz_io_read_at (core->io, at - len, buf, len);
+					} else {
+						len = RZ_MIN (bsize, to - at);
+						if (!rz_io_is_valid_offset (core->io, at, 0)) {
+							break;
+						}
+						(void)rz_io_read_at (core->io, at, buf, len);
 					}
-					(void)rz_io_read_at (core->io, at, buf, len);
-				}
-				rz_search_update (core->search, at, buf, len);
-				if (param->aes_search) {
-					// Adjust length to search between blocks.
-					if (len == core->blocksize) {
-						len -= AES_SEARCH_LENGTH - 1;
+					rz_search_update (core->search, at, buf, len);
+					if (param->aes_search) {
+						// Adjust length to search between blocks.
+						if (len == bsize) {
+							len -= AES_SEARCH_LENGTH - 1;
+						}
+					} else if (param->privkey_search) {
+						// Adjust length to search between blocks.
+						if (len == bsize) {
+							len -= PRIVATE_KEY_SEARCH_LENGTH - 1;
+						}
 					}
-				} else if (param->privkey_search) {
-					// Adjust length to search between blocks.
-					if (len == core->blocksize) {
-						len -= PRIVATE_KEY_SEARCH_LENGTH - 1;
+					if (core->search->maxhits > 0 && core->search->nhits >= core->search->maxhits) {
+						goto done;
 					}
 				}
-				if (core->search->maxhits > 0 && core->search->nhits >= core->search->maxhits) {
-					goto done;
-				}
 			}
 			print_search_progress (at, to1, search->nhits, param);
 			rz_cons_clear_line (1);
@@ -4,7 +4,7 @@
 #include <rz_core.h>
 #include "cmd_descs.h"
 
-static int task_enqueue(RzCore *core, const char *cmd, bool transient) {
+static int task_enqueue(RzCore *core, const char *cmd, bool transient, bool read_only) {
 	if (rz_sandbox_enable (0)) {
 		eprintf ("This command is disabled in sandbox mode\n");
 		return -1;
@@ -14,7 +14,11 @@ static int task_enqueue(RzCore *core, const char *cmd, bool transient) {
 		return -1;
 	}
 	task->transient = transient;
+	task->read_only = read_only;
 	rz_core_task_enqueue (&core->tasks, task);
+	if (read_only && !task->read_only) {
+		eprintf ("`%s` is not read-only, it runs as a regular task\n", cmd);
+	}
 	return 0;
 }
 
@@ -52,13 +56,17 @@ RZ_IPI RzCmdStatus rz_tasks_handler(RzCore *core, int argc, const char **argv, R
 		rz_core_task_list (core, mode == RZ_OUTPUT_MODE_STANDARD ? '\0' : 'j');
 		return RZ_CMD_STATUS_OK;
 	} else if (argc == 2) {
-		return rz_cmd_int2status (task_enqueue (core, argv[1], false));
+		return rz_cmd_int2status (task_enqueue (core, argv[1], false, false));
 	}
 	return RZ_CMD_STATUS_ERROR;
 }
 
 RZ_IPI RzCmdStatus rz_tasks_transient_handler(RzCore *core, int argc, const char **argv) {
-	return rz_cmd_int2status (task_enqueue (core, argv[1], true));
+	return rz_cmd_int2status (task_enqueue (core, argv[1], true, false));
+}
+
+RZ_IPI RzCmdStatus rz_tasks_read_only_handler(RzCore *core, int argc, const char **argv) {
+	return rz_cmd_int2status (task_enqueue (core, argv[1], false, true));
 }
 
 RZ_IPI RzCmdStatus rz_tasks_output_handler(RzCore *core, int argc, const char **argv) {
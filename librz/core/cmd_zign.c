@@ -64,10 +64,11 @@ static const char *help_msg_zf[] = {
 };
 
 static const char *help_msg_zo[] = {
-	"Usage:", "zo[zs] filename ", "# Manage zignature files (see dir.zigns)",
-	"zo ", "filename", "load zinatures from sdb file",
+	"Usage:", "zo[zsc] filename ", "# Manage zignature files (see dir.zigns)",
+	"zo ", "filename", "load zinatures from sdb or compiled file",
 	"zoz ", "filename", "load zinatures from gzipped sdb file",
 	"zos ", "filename", "save zignatures to sdb file (merge if file exists)",
+	"zoc ", "filename", "save zignatures to compiled file (faster to load)",
 	NULL
 };
 
@@ -473,11 +474,17 @@ static int cmdOpen(void *data, const char *input) {
 		}
 		eprintf ("Usage: zoz filename\n");
 		return false;
+	case 'c':
+		if (input[1] == ' ' && input[2]) {
+			return rz_sign_save_compiled (core->analysis, input + 2);
+		}
+		eprintf ("Usage: zoc filename\n");
+		return false;
 	case '?':
 		rz_core_cmd_help (core, help_msg_zo);
 		break;
 	default:
-		eprintf ("Usage: zo[zs] filename\n");
+		eprintf ("Usage: zo[zsc] filename\n");
 		return false;
 	}
 
@@ -1411,6 +1418,10 @@ RZ_IPI RzCmdStatus rz_zign_save_sdb_handler(RzCore *core, int argc, const char *
 	return rz_sign_save (core->analysis, argv[1]) ? RZ_CMD_STATUS_OK : RZ_CMD_STATUS_ERROR;
 }
 
+RZ_IPI RzCmdStatus rz_zign_save_compiled_handler(RzCore *core, int argc, const char **argv) {
+	return rz_sign_save_compiled (core->analysis, argv[1]) ? RZ_CMD_STATUS_OK : RZ_CMD_STATUS_ERROR;
+}
+
 RZ_IPI RzCmdStatus rz_zign_flirt_dump_handler(RzCore *core, int argc, const char **argv) {
 	rz_sign_flirt_dump (core->analysis, argv[1]);
 	return RZ_CMD_STATUS_OK;
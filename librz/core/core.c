@@ -2455,6 +2455,7 @@ static int win_eprintf(const char *format, ...) {
 static void ev_iowrite_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzCore *core = user;
 	RzEventIOWrite *iow = data;
+	rz_analysis_op_cache_invalidate (&core->analysis->opcache, iow->addr, iow->len);
 	if (rz_config_get_i (core->config, "analysis.detectwrites")) {
 		rz_analysis_update_analysis_range (core->analysis, iow->addr, iow->len);
 		if (core->cons->event_resize && core->cons->event_data) {
@@ -2628,6 +2629,8 @@ RZ_API bool rz_core_init(RzCore *core) {
 
 	rz_io_bind (core->io, &(core->dbg->iob));
 	rz_io_bind (core->io, &(core->dbg->bp->iob));
+	// rz_debug_wait() flushes the page cache on every stop
+	core->io->page_cache.dbg_flush = true;
 	rz_core_bind (core, &core->dbg->corebind);
 	rz_core_bind (core, &core->dbg->bp->corebind);
 	rz_core_bind (core, &core->io->corebind);
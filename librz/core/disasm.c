@@ -3307,8 +3307,8 @@ static void ds_print_import_name(RDisasmState *ds) {
 	case RZ_ANALYSIS_OP_TYPE_JMP:
 	case RZ_ANALYSIS_OP_TYPE_CJMP:
 	case RZ_ANALYSIS_OP_TYPE_CALL:
-		if (core->bin->cur->o->imports && core->bin->cur->o->relocs) {
-			rz_list_foreach (core->bin->cur->o->relocs, iter, rel) {
+		if (rz_bin_get_imports (core->bin) && rz_bin_get_relocs (core->bin)) {
+			rz_list_foreach (rz_bin_get_relocs (core->bin), iter, rel) {
 				if ((rel->vaddr == ds->analop.jump) &&
 					(rel->import != NULL)) {
 					if (ds->show_color) {
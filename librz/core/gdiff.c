@@ -43,6 +43,7 @@ RZ_API int rz_core_gdiff(RzCore *c, RzCore *c2) {
 	if (!c || !c2) {
 		return false;
 	}
+	ut64 start = rz_time_now_mono ();
 	for (i = 0; i < 2; i++) {
 		/* remove strings */
 		rz_list_foreach_safe (cores[i]->analysis->fcns, iter, iter2, fcn) {
@@ -61,12 +62,31 @@ RZ_API int rz_core_gdiff(RzCore *c, RzCore *c2) {
 			rz_analysis_diff_fingerprint_fcn (cores[i]->analysis, fcn);
 		}
 	}
+	ut64 fingerprint_time = rz_time_now_mono () - start;
 	/* Diff functions */
+	c->analysis->diff_threads = rz_config_get_i (c->config, "diff.threads");
 	rz_analysis_diff_fcn (cores[0]->analysis, cores[0]->analysis->fcns, cores[1]->analysis->fcns);
+	c->analysis->diff_stats.fingerprint_time = fingerprint_time;
 
 	return true;
 }
 
+/* Timing and quality of the last rz_core_gdiff(), on stderr */
+RZ_API void rz_core_gdiff_report(RzCore *c) {
+	rz_return_if_fail (c);
+	RzAnalysisDiffStats *st = &c->analysis->diff_stats;
+	ut32 matched = st->by_name + st->by_hash + st->by_callgraph + st->by_similarity;
+	eprintf ("functions:   %u vs %u\n", st->fcns, st->fcns2);
+	eprintf ("matched:     %u (name %u, hash %u, callgraph %u, similarity %u)\n",
+		matched, st->by_name, st->by_hash, st->by_callgraph, st->by_similarity);
+	eprintf ("unmatched:   %u\n", st->fcns - RZ_MIN (matched, st->fcns));
+	eprintf ("similarity:  %f\n", st->similarity);
+	eprintf ("distances:   %u\n", st->distances);
+	eprintf ("fingerprint: %" PFMT64u " ms\n", st->fingerprint_time / 1000);
+	eprintf ("index:       %" PFMT64u " ms\n", st->index_time / 1000);
+	eprintf ("match:       %" PFMT64u " ms\n", st->match_time / 1000);
+}
+
 /* copypasta from rz_diff */
 static void diffrow(ut64 addr, const char *name, ut32 size, int maxnamelen,
 		int digits, ut64 addr2, const char *name2, ut32 size2,
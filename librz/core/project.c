@@ -37,7 +37,15 @@ RZ_API RzProjectErr rz_project_save(RzCore *core, RzProject *prj, const char *fi
 	return RZ_PROJECT_ERR_SUCCESS;
 }
 
-RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file) {
+static bool blocks_records_save(void *user, RzSerializeRecordCb cb, void *cb_user) {
+	return rz_serialize_analysis_blocks_save_records (user, cb, cb_user);
+}
+
+static bool functions_records_save(void *user, RzSerializeRecordCb cb, void *cb_user) {
+	return rz_serialize_analysis_functions_save_records (user, cb, cb_user);
+}
+
+static RzProjectErr save_file(RzCore *core, const char *file, bool text) {
 	RzProject *prj = sdb_new0 ();
 	if (!prj) {
 		return RZ_PROJECT_ERR_UNKNOWN;
@@ -47,19 +55,38 @@ RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file) {
 		sdb_free (prj);
 		return err;
 	}
-	if (!sdb_text_save (prj, file, true)) {
+	// by far the biggest namespaces, binary records spare parsing them as json on load
+	RzProjectBinRecords records[] = {
+		{ "core/analysis/blocks", blocks_records_save, core->analysis },
+		{ "core/analysis/functions", functions_records_save, core->analysis }
+	};
+	if (text ? !sdb_text_save (prj, file, true) : !rz_project_bin_save (prj, records, RZ_ARRAY_SIZE (records), file, NULL)) {
 		err = RZ_PROJECT_ERR_FILE;
 	}
 	sdb_free (prj);
 	return err;
 }
 
-RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_io, RZ_NULLABLE const char *file, RzSerializeResultInfo *res) {
-	const char *type = sdb_const_get (prj, RZ_DB_KEY_TYPE, 0);
+/**
+ * \brief Save the project as a binary container, see project_bin.c
+ *
+ * If \p file already holds a binary project, only what changed since is written.
+ */
+RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file) {
+	return save_file (core, file, false);
+}
+
+/**
+ * \brief Save the project as a text sdb, which rz_project_load_file() reads as well
+ */
+RZ_API RzProjectErr rz_project_export_file(RzCore *core, const char *file) {
+	return save_file (core, file, true);
+}
+
+static RzProjectErr check_type_version(const char *type, const char *version_str) {
 	if (!type || strcmp (type, RZ_DB_PROJECT_TYPE) != 0) {
 		return RZ_PROJECT_ERR_INVALID_TYPE;
 	}
-	const char *version_str = sdb_const_get (prj, RZ_DB_KEY_VERSION, 0);
 	if (!version_str) {
 		return RZ_PROJECT_ERR_INVALID_VERSION;
 	}
@@ -69,6 +96,14 @@ RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_
 	} else if (version > RZ_DB_PROJECT_VERSION) {
 		return RZ_PROJECT_ERR_NEWER_VERSION;
 	}
+	return RZ_PROJECT_ERR_SUCCESS;
+}
+
+RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_io, RZ_NULLABLE const char *file, RzSerializeResultInfo *res) {
+	RzProjectErr err = check_type_version (sdb_const_get (prj, RZ_DB_KEY_TYPE, 0), sdb_const_get (prj, RZ_DB_KEY_VERSION, 0));
+	if (err != RZ_PROJECT_ERR_SUCCESS) {
+		return err;
+	}
 
 	Sdb *core_db = sdb_ns (prj, "core", false);
 	if (!core_db) {
@@ -84,13 +119,57 @@ RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_
 	return RZ_PROJECT_ERR_SUCCESS;
 }
 
+static bool bin_src_load(void *user, const char *path, Sdb *db, bool recursive) {
+	return rz_project_bin_load_ns (user, path, db, recursive);
+}
+
+static bool bin_src_has_records(void *user, const char *path) {
+	return rz_project_bin_has_records (user, path);
+}
+
+static bool bin_src_records(void *user, const char *path, RzSerializeRecordCb cb, void *cb_user) {
+	return rz_project_bin_records (user, path, cb, cb_user);
+}
+
+/**
+ * Check the header keys straight from the container, then let the loaders
+ * decode each namespace only when they get to it.
+ */
+static RzProjectErr bin_load(RzCore *core, RzProjectBin *pb, bool load_bin_io, const char *file, RzSerializeResultInfo *res) {
+	RzProjectErr err = check_type_version (rz_project_bin_get (pb, "", RZ_DB_KEY_TYPE), rz_project_bin_get (pb, "", RZ_DB_KEY_VERSION));
+	if (err != RZ_PROJECT_ERR_SUCCESS) {
+		return err;
+	}
+	RzSerializeNsSource src = {
+		.load = bin_src_load,
+		.has_records = bin_src_has_records,
+		.records = bin_src_records,
+		.user = pb,
+		.path = "core"
+	};
+	if (!rz_serialize_core_load_from (&src, core, load_bin_io, file, res)) {
+		return RZ_PROJECT_ERR_INVALID_CONTENTS;
+	}
+
+	rz_config_set (core->config, "prj.file", file);
+
+	return RZ_PROJECT_ERR_SUCCESS;
+}
+
 RZ_API RzProjectErr rz_project_load_file(RzCore *core, const char *file, bool load_bin_io, RzSerializeResultInfo *res) {
+	RzProjectBin *pb = rz_project_bin_open (file);
+	if (pb) {
+		RzProjectErr err = bin_load (core, pb, load_bin_io, file, res);
+		rz_project_bin_close (pb);
+		return err;
+	}
 	RzProject *prj = sdb_new0 ();
 	if (!prj) {
 		return RZ_PROJECT_ERR_UNKNOWN;
 	}
 	if (!sdb_text_load (prj, file)) {
 		SERIALIZE_ERR ("failed to read database file");
+		sdb_free (prj);
 		return RZ_PROJECT_ERR_FILE;
 	}
 	RzProjectErr ret = rz_project_load (core, prj, load_bin_io, file, res);
@@ -0,0 +1,612 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_project.h>
+
+/*
+ * Binary project container
+ *
+ * Every namespace of the project sdb is stored as one section, named by
+ * its path ("" for the root, "core", "core/analysis", ...):
+ *
+ *   header    magic[8] version:ut32 count:ut32 table:ut64 reserved:ut64
+ *   sections  ...
+ *   table     count * { off:ut64 size:ut64 name:ut32 name_len:ut32 flags:ut32 reserved:ut32 }
+ *             names, each terminated by a 0 byte
+ *
+ * A section holds the records of its namespace, indexed by offset:
+ *
+ *   count:ut32 off:ut32[count] { key\0 value\0 }[count]
+ *
+ * If PRJ_BIN_SECTION_RECORDS is set in its flags, the values are binary
+ * records instead of strings, which run up to the next record, e.g. the
+ * blocks and functions from rz_serialize_analysis_*_save_records(). Such
+ * sections have no sdb form and are only read through
+ * rz_project_bin_records().
+ *
+ * Sections are sorted by name and records by key, so that a single
+ * section or key can be looked up in the mapped file without decoding
+ * anything else. All integers are little endian.
+ *
+ * Saving over an existing container only appends the sections whose
+ * contents changed and a new table, then rewrites the header to point to
+ * it. Until the header is written, the file still describes the previous
+ * state. Once the space held by replaced sections outgrows the live data,
+ * the whole file is rewritten instead.
+ */
+
+#define PRJ_BIN_MAGIC      "RZPRJBIN"
+#define PRJ_BIN_VERSION    2
+#define PRJ_BIN_HDR_SIZE   32
+#define PRJ_BIN_ENTRY_SIZE 32
+
+#define PRJ_BIN_SECTION_RECORDS (1 << 0)
+
+typedef struct {
+	const char *name; // 0-terminated, points into the map
+	ut64 off;
+	ut64 size;
+	ut32 flags;
+} PrjBinSection;
+
+struct rz_project_bin_t {
+	RMmap *map;
+	PrjBinSection *sections;
+	ut32 count;
+};
+
+RZ_API void rz_project_bin_close(RzProjectBin *pb) {
+	if (!pb) {
+		return;
+	}
+	rz_file_mmap_free (pb->map);
+	free (pb->sections);
+	free (pb);
+}
+
+/**
+ * \brief Map a binary project container and read its section table
+ *
+ * Nothing else is read until sections or keys are requested.
+ *
+ * \return NULL if \p file does not exist or is not a valid container
+ */
+RZ_API RZ_OWN RzProjectBin *rz_project_bin_open(RZ_NONNULL const char *file) {
+	rz_return_val_if_fail (file, NULL);
+	if (!rz_file_exists (file) || rz_file_size (file) < PRJ_BIN_HDR_SIZE) {
+		return NULL;
+	}
+	RzProjectBin *pb = RZ_NEW0 (RzProjectBin);
+	if (!pb) {
+		return NULL;
+	}
+	pb->map = rz_file_mmap (file, false, 0);
+	if (!pb->map || !pb->map->buf || pb->map->len < PRJ_BIN_HDR_SIZE) {
+		goto fail;
+	}
+	const ut8 *buf = pb->map->buf;
+	ut64 len = pb->map->len;
+	if (memcmp (buf, PRJ_BIN_MAGIC, 8) || rz_read_le32 (buf + 8) != PRJ_BIN_VERSION) {
+		goto fail;
+	}
+	ut32 count = rz_read_le32 (buf + 12);
+	ut64 table = rz_read_le64 (buf + 16);
+	if (!count || table < PRJ_BIN_HDR_SIZE || table > len || count > (len - table) / PRJ_BIN_ENTRY_SIZE) {
+		goto fail;
+	}
+	pb->sections = RZ_NEWS0 (PrjBinSection, count);
+	if (!pb->sections) {
+		goto fail;
+	}
+	pb->count = count;
+	const ut8 *names = buf + table + (ut64)count * PRJ_BIN_ENTRY_SIZE;
+	ut64 names_size = buf + len - names;
+	ut32 i;
+	for (i = 0; i < count; i++) {
+		const ut8 *e = buf + table + (ut64)i * PRJ_BIN_ENTRY_SIZE;
+		PrjBinSection *s = &pb->sections[i];
+		s->off = rz_read_le64 (e);
+		s->size = rz_read_le64 (e + 8);
+		ut32 name_off = rz_read_le32 (e + 16);
+		ut32 name_len = rz_read_le32 (e + 20);
+		s->flags = rz_read_le32 (e + 24);
+		if (s->off < PRJ_BIN_HDR_SIZE || s->off > len || s->size > len - s->off || s->size < 4) {
+			goto fail;
+		}
+		if (name_off >= names_size || name_len >= names_size - name_off || names[name_off + name_len]) {
+			goto fail;
+		}
+		s->name = (const char *)names + name_off;
+		if (i && strcmp (pb->sections[i - 1].name, s->name) >= 0) {
+			goto fail;
+		}
+	}
+	return pb;
+fail:
+	rz_project_bin_close (pb);
+	return NULL;
+}
+
+// index of the first section whose name is not smaller than name
+static ut32 section_lower(RzProjectBin *pb, const char *name) {
+	ut32 lo = 0, hi = pb->count;
+	while (lo < hi) {
+		ut32 mid = lo + (hi - lo) / 2;
+		if (strcmp (pb->sections[mid].name, name) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static PrjBinSection *section_find(RzProjectBin *pb, const char *name) {
+	ut32 i = section_lower (pb, name);
+	return i < pb->count && !strcmp (pb->sections[i].name, name) ? &pb->sections[i] : NULL;
+}
+
+static ut32 section_count(RzProjectBin *pb, PrjBinSection *s) {
+	ut32 count = rz_read_le32 (pb->map->buf + s->off);
+	return count <= (s->size - 4) / 4 ? count : 0;
+}
+
+// record i of the count in s, a record runs up to the next one
+static bool section_record(RzProjectBin *pb, PrjBinSection *s, ut32 count, ut32 i, const char **key, const ut8 **value, ut64 *value_size) {
+	const ut8 *sec = pb->map->buf + s->off;
+	ut64 off = rz_read_le32 (sec + 4 + (ut64)i * 4);
+	ut64 end = i + 1 < count ? rz_read_le32 (sec + 4 + (ut64)(i + 1) * 4) : s->size;
+	if (off >= end || end > s->size) {
+		return false;
+	}
+	const ut8 *k = sec + off;
+	const ut8 *kend = memchr (k, 0, end - off);
+	if (!kend) {
+		return false;
+	}
+	*key = (const char *)k;
+	*value = kend + 1;
+	*value_size = sec + end - *value;
+	// string values are terminated by the last byte of their record
+	return (s->flags & PRJ_BIN_SECTION_RECORDS) || (*value_size && !(*value)[*value_size - 1]);
+}
+
+/**
+ * \brief Look up \p key in the namespace \p path straight from the mapped container
+ *
+ * \return the value, valid until \p pb is closed, or NULL
+ */
+RZ_API RZ_BORROW const char *rz_project_bin_get(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL const char *path, RZ_NONNULL const char *key) {
+	rz_return_val_if_fail (pb && path && key, NULL);
+	PrjBinSection *s = section_find (pb, path);
+	if (!s || (s->flags & PRJ_BIN_SECTION_RECORDS)) {
+		return NULL;
+	}
+	ut32 count = section_count (pb, s);
+	ut32 lo = 0, hi = count;
+	while (lo < hi) {
+		ut32 mid = lo + (hi - lo) / 2;
+		const char *k;
+		const ut8 *v;
+		ut64 vsize;
+		if (!section_record (pb, s, count, mid, &k, &v, &vsize)) {
+			return NULL;
+		}
+		int c = strcmp (k, key);
+		if (!c) {
+			return (const char *)v;
+		}
+		if (c < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return NULL;
+}
+
+static bool section_foreach(RzProjectBin *pb, PrjBinSection *s, RzSerializeRecordCb cb, void *user) {
+	ut32 count = section_count (pb, s);
+	ut32 i;
+	for (i = 0; i < count; i++) {
+		const char *k;
+		const ut8 *v;
+		ut64 vsize;
+		if (!section_record (pb, s, count, i, &k, &v, &vsize) || !cb (user, k, v, vsize)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool section_load_cb(void *user, const char *k, const ut8 *v, ut64 size) {
+	sdb_set (user, k, (const char *)v, 0);
+	return true;
+}
+
+/**
+ * \brief Decode the namespace \p path of the container into \p db
+ *
+ * Namespaces stored as binary records are skipped, see rz_project_bin_records().
+ *
+ * \param path namespace path, "" for the root namespace
+ * \param recursive whether to also decode all namespaces below \p path into the matching namespaces of \p db
+ * \return false if the namespace does not exist, is malformed or holds binary records
+ */
+RZ_API bool rz_project_bin_load_ns(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL const char *path, RZ_NONNULL Sdb *db, bool recursive) {
+	rz_return_val_if_fail (pb && path && db, false);
+	PrjBinSection *s = section_find (pb, path);
+	if (!s || (s->flags & PRJ_BIN_SECTION_RECORDS) || !section_foreach (pb, s, section_load_cb, db)) {
+		return false;
+	}
+	if (!recursive) {
+		return true;
+	}
+	char *prefix = *path ? rz_str_newf ("%s/", path) : strdup ("");
+	if (!prefix) {
+		return false;
+	}
+	size_t prefix_len = strlen (prefix);
+	bool ret = true;
+	ut32 i;
+	for (i = section_lower (pb, prefix); i < pb->count; i++) {
+		s = &pb->sections[i];
+		if (strncmp (s->name, prefix, prefix_len)) {
+			break;
+		}
+		if (!s->name[prefix_len] || (s->flags & PRJ_BIN_SECTION_RECORDS)) {
+			continue;
+		}
+		Sdb *sub = sdb_ns_path (db, s->name + prefix_len, true);
+		if (!sub || !section_foreach (pb, s, section_load_cb, sub)) {
+			ret = false;
+			break;
+		}
+	}
+	free (prefix);
+	return ret;
+}
+
+/**
+ * \brief Whether the namespace \p path of the container is stored as binary records
+ */
+RZ_API bool rz_project_bin_has_records(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail (pb && path, false);
+	PrjBinSection *s = section_find (pb, path);
+	return s && (s->flags & PRJ_BIN_SECTION_RECORDS);
+}
+
+/**
+ * \brief Pass all binary records of the namespace \p path to \p cb, sorted by key
+ *
+ * The data passed to \p cb points into the mapped container.
+ *
+ * \return false if the namespace does not exist, is malformed, holds no binary records or \p cb failed
+ */
+RZ_API bool rz_project_bin_records(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL const char *path, RZ_NONNULL RzSerializeRecordCb cb, void *user) {
+	rz_return_val_if_fail (pb && path && cb, false);
+	PrjBinSection *s = section_find (pb, path);
+	return s && (s->flags & PRJ_BIN_SECTION_RECORDS) && section_foreach (pb, s, cb, user);
+}
+
+/* saving */
+
+typedef struct {
+	char *name;
+	RzVector data; // ut8
+	ut32 flags;
+	ut64 off;
+	bool reused;
+} PrjBinOut;
+
+typedef struct {
+	const char *key;
+	const ut8 *value;
+	ut64 size; // including the terminating 0 of string values
+} PrjBinKv;
+
+static void out_free(void *e) {
+	PrjBinOut *out = e;
+	if (!out) {
+		return;
+	}
+	free (out->name);
+	rz_vector_fini (&out->data);
+	free (out);
+}
+
+static int out_cmp(const void *a, const void *b) {
+	return strcmp (((const PrjBinOut *)a)->name, ((const PrjBinOut *)b)->name);
+}
+
+static int kv_cmp(const void *a, const void *b) {
+	return strcmp (((const PrjBinKv *)a)->key, ((const PrjBinKv *)b)->key);
+}
+
+static bool put(RzVector *v, const void *data, size_t size) {
+	return !size || rz_vector_insert_range (v, v->len, (void *)data, size);
+}
+
+static bool put_le32(RzVector *v, ut32 x) {
+	ut8 b[4];
+	rz_write_le32 (b, x);
+	return put (v, b, sizeof (b));
+}
+
+static bool put_le64(RzVector *v, ut64 x) {
+	ut8 b[8];
+	rz_write_le64 (b, x);
+	return put (v, b, sizeof (b));
+}
+
+static bool kvs_encode(RzVector *kvs, RzVector *data) {
+	if (kvs->len > 1) {
+		qsort (kvs->a, kvs->len, sizeof (PrjBinKv), kv_cmp);
+	}
+	bool ret = put_le32 (data, (ut32)kvs->len);
+	ut64 off = 4 + (ut64)kvs->len * 4;
+	PrjBinKv *kv;
+	rz_vector_foreach (kvs, kv) {
+		if (!ret || off > UT32_MAX) {
+			ret = false;
+			break;
+		}
+		ret = put_le32 (data, (ut32)off);
+		off += strlen (kv->key) + 1 + kv->size;
+	}
+	rz_vector_foreach (kvs, kv) {
+		if (!ret) {
+			break;
+		}
+		ret = put (data, kv->key, strlen (kv->key) + 1) && put (data, kv->value, kv->size);
+	}
+	return ret;
+}
+
+static bool kv_collect_cb(void *user, const char *k, const char *v) {
+	PrjBinKv kv = { k, (const ut8 *)v, strlen (v) + 1 };
+	return rz_vector_push (user, &kv) != NULL;
+}
+
+static bool section_encode(Sdb *db, RzVector *data) {
+	RzVector kvs;
+	rz_vector_init (&kvs, sizeof (PrjBinKv), NULL, NULL);
+	sdb_foreach (db, kv_collect_cb, &kvs);
+	bool ret = kvs_encode (&kvs, data);
+	rz_vector_fini (&kvs);
+	return ret;
+}
+
+typedef struct {
+	RzVector kvs; // PrjBinKv
+	RzPVector bufs; // hold the keys and values of kvs
+} PrjBinRecords;
+
+static bool record_collect_cb(void *user, const char *key, const ut8 *data, ut64 size) {
+	PrjBinRecords *recs = user;
+	size_t key_size = strlen (key) + 1;
+	ut8 *buf = size <= SIZE_MAX - key_size ? malloc (key_size + size) : NULL;
+	if (!buf || !rz_pvector_push (&recs->bufs, buf)) {
+		free (buf);
+		return false;
+	}
+	memcpy (buf, key, key_size);
+	memcpy (buf + key_size, data, size);
+	PrjBinKv kv = { (const char *)buf, buf + key_size, size };
+	return rz_vector_push (&recs->kvs, &kv) != NULL;
+}
+
+static bool records_encode(const RzProjectBinRecords *records, RzVector *data) {
+	PrjBinRecords recs;
+	rz_vector_init (&recs.kvs, sizeof (PrjBinKv), NULL, NULL);
+	rz_pvector_init (&recs.bufs, free);
+	bool ret = records->save (records->user, record_collect_cb, &recs) && kvs_encode (&recs.kvs, data);
+	rz_vector_fini (&recs.kvs);
+	rz_pvector_fini (&recs.bufs);
+	return ret;
+}
+
+// replace the sections of the namespaces that are saved as binary records
+static bool records_collect(const RzProjectBinRecords *records, size_t records_count, RzPVector *outs) {
+	size_t i;
+	for (i = 0; i < records_count; i++) {
+		PrjBinOut *out = NULL;
+		void **it;
+		rz_pvector_foreach (outs, it) {
+			if (!strcmp (((PrjBinOut *)*it)->name, records[i].path)) {
+				out = *it;
+				break;
+			}
+		}
+		if (out) {
+			rz_vector_clear (&out->data);
+		} else {
+			out = RZ_NEW0 (PrjBinOut);
+			if (!out) {
+				return false;
+			}
+			rz_vector_init (&out->data, 1, NULL, NULL);
+			out->name = strdup (records[i].path);
+			if (!out->name || !rz_pvector_push (outs, out)) {
+				out_free (out);
+				return false;
+			}
+		}
+		out->flags = PRJ_BIN_SECTION_RECORDS;
+		if (!records_encode (&records[i], &out->data)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool sections_collect(Sdb *db, const char *path, RzPVector *outs) {
+	PrjBinOut *out = RZ_NEW0 (PrjBinOut);
+	if (!out) {
+		return false;
+	}
+	rz_vector_init (&out->data, 1, NULL, NULL);
+	out->name = strdup (path);
+	if (!out->name || !rz_pvector_push (outs, out)) {
+		out_free (out);
+		return false;
+	}
+	if (!section_encode (db, &out->data)) {
+		return false;
+	}
+	SdbListIter *it;
+	SdbNs *ns;
+	ls_foreach (db->ns, it, ns) {
+		char *sub = *path ? rz_str_newf ("%s/%s", path, ns->name) : strdup (ns->name);
+		bool ok = sub && sections_collect (ns->sdb, sub, outs);
+		free (sub);
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool write_all(FILE *f, const void *data, size_t size, ut64 *written) {
+	if (size && fwrite (data, 1, size, f) != size) {
+		return false;
+	}
+	*written += size;
+	return true;
+}
+
+// fseek() takes a long, which is 32 bits wide on some 64-bit targets too
+static bool file_seek(FILE *f, ut64 off) {
+#if __WINDOWS__
+	return off <= ST64_MAX && !_fseeki64 (f, (st64)off, SEEK_SET);
+#else
+	return (ut64)(off_t)off == off && !fseeko (f, (off_t)off, SEEK_SET);
+#endif
+}
+
+static bool table_encode(RzPVector *outs, RzVector *table) {
+	bool ret = true;
+	ut64 name_off = 0;
+	void **it;
+	rz_pvector_foreach (outs, it) {
+		PrjBinOut *out = *it;
+		size_t name_len = strlen (out->name);
+		ret &= put_le64 (table, out->off) && put_le64 (table, out->data.len)
+			&& put_le32 (table, (ut32)name_off) && put_le32 (table, (ut32)name_len)
+			&& put_le32 (table, out->flags) && put_le32 (table, 0);
+		name_off += name_len + 1;
+	}
+	rz_pvector_foreach (outs, it) {
+		PrjBinOut *out = *it;
+		ret &= put (table, out->name, strlen (out->name) + 1);
+	}
+	return ret && name_off <= UT32_MAX;
+}
+
+static bool header_write(FILE *f, ut32 count, ut64 table, ut64 *written) {
+	ut8 hdr[PRJ_BIN_HDR_SIZE] = { 0 };
+	memcpy (hdr, PRJ_BIN_MAGIC, 8);
+	rz_write_le32 (hdr + 8, PRJ_BIN_VERSION);
+	rz_write_le32 (hdr + 12, count);
+	rz_write_le64 (hdr + 16, table);
+	return write_all (f, hdr, sizeof (hdr), written);
+}
+
+/**
+ * \brief Save \p prj as a binary project container
+ *
+ * If \p file already is a container, only the namespaces whose contents
+ * changed since it was written are appended to it.
+ *
+ * \param records namespaces to store as binary records, replacing the ones of the same path in \p prj
+ * \param written if not NULL, set to the number of bytes written to the file
+ */
+RZ_API bool rz_project_bin_save(RZ_NONNULL RzProject *prj, RZ_NULLABLE const RzProjectBinRecords *records, size_t records_count,
+		RZ_NONNULL const char *file, RZ_NULLABLE ut64 *written) {
+	rz_return_val_if_fail (prj && (records || !records_count) && file, false);
+	bool ret = false;
+	ut64 wr = 0;
+	FILE *f = NULL;
+	RzVector table;
+	rz_vector_init (&table, 1, NULL, NULL);
+	RzPVector outs;
+	rz_pvector_init (&outs, out_free);
+	if (!sections_collect (prj, "", &outs) || !records_collect (records, records_count, &outs)) {
+		goto beach;
+	}
+	rz_pvector_sort (&outs, out_cmp);
+
+	// reuse the sections that did not change since the last save
+	ut64 end = 0, appended = 0, size = 0;
+	void **it;
+	RzProjectBin *old = rz_project_bin_open (file);
+	if (old) {
+		end = old->map->len;
+		rz_pvector_foreach (&outs, it) {
+			PrjBinOut *out = *it;
+			PrjBinSection *s = section_find (old, out->name);
+			if (s && s->flags == out->flags && s->size == out->data.len && !memcmp (old->map->buf + s->off, out->data.a, s->size)) {
+				out->off = s->off;
+				out->reused = true;
+			} else {
+				appended += out->data.len;
+			}
+		}
+		rz_project_bin_close (old);
+	}
+	rz_pvector_foreach (&outs, it) {
+		PrjBinOut *out = *it;
+		size += out->data.len;
+	}
+	// replaced sections and tables stay in the file as dead space
+	bool incremental = end && end + appended - size - PRJ_BIN_HDR_SIZE <= size;
+	ut64 off = incremental ? end : PRJ_BIN_HDR_SIZE;
+	rz_pvector_foreach (&outs, it) {
+		PrjBinOut *out = *it;
+		if (!incremental || !out->reused) {
+			out->reused = false;
+			out->off = off;
+			off += out->data.len;
+		}
+	}
+	if (!table_encode (&outs, &table)) {
+		goto beach;
+	}
+
+	f = rz_sandbox_fopen (file, incremental ? "r+b" : "wb");
+	if (!f) {
+		goto beach;
+	}
+	if (incremental) {
+		if (!file_seek (f, end)) {
+			goto beach;
+		}
+	} else if (!header_write (f, rz_pvector_len (&outs), off, &wr)) {
+		goto beach;
+	}
+	rz_pvector_foreach (&outs, it) {
+		PrjBinOut *out = *it;
+		if (!out->reused && !write_all (f, out->data.a, out->data.len, &wr)) {
+			goto beach;
+		}
+	}
+	if (!write_all (f, table.a, table.len, &wr)) {
+		goto beach;
+	}
+	if (incremental) {
+		// the new table is in place, switch the header over to it
+		if (fflush (f) || !file_seek (f, 0) || !header_write (f, rz_pvector_len (&outs), off, &wr)) {
+			goto beach;
+		}
+	}
+	ret = true;
+beach:
+	if (f && fclose (f)) {
+		ret = false;
+	}
+	if (written) {
+		*written = wr;
+	}
+	rz_vector_fini (&table);
+	rz_pvector_fini (&outs);
+	return ret;
+}
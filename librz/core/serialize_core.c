@@ -39,18 +39,30 @@ RZ_API void rz_serialize_core_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core,
 	sdb_set (db, "blocksize", buf, 0);
 }
 
-RZ_API bool rz_serialize_core_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core, bool load_bin_io,
+static bool core_load(RZ_NONNULL Sdb *db, RZ_NULLABLE RzSerializeNsSource *src, RZ_NONNULL RzCore *core, bool load_bin_io,
 		RZ_NULLABLE const char *prj_file, RZ_NULLABLE RzSerializeResultInfo *res) {
 	Sdb *subdb;
 
-#define SUB(ns, call) SUB_DO(ns, call, return false;)
+#define SUB(ns, call) SUB_SRC_DO(ns, call, return false;)
 
 	if (load_bin_io) {
 		SUB ("file", file_load (subdb, core, prj_file, res));
 	}
 	SUB ("config", rz_serialize_config_load (subdb, core->config, res));
 	SUB ("flags", rz_serialize_flag_load (subdb, core->flags, res));
-	SUB ("analysis", rz_serialize_analysis_load (subdb, core->analysis, res));
+	if (src) {
+		RzSerializeNsSource sub;
+		if (!serialize_src_sub (src, "analysis", &sub)) {
+			return false;
+		}
+		bool ok = rz_serialize_analysis_load_from (&sub, core->analysis, res);
+		free ((char *)sub.path);
+		if (!ok) {
+			return false;
+		}
+	} else {
+		SUB ("analysis", rz_serialize_analysis_load (subdb, core->analysis, res));
+	}
 
 	const char *str = sdb_get (db, "offset", 0);
 	if (!str || !*str) {
@@ -73,6 +85,33 @@ RZ_API bool rz_serialize_core_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core,
 	return true;
 }
 
+RZ_API bool rz_serialize_core_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core, bool load_bin_io,
+		RZ_NULLABLE const char *prj_file, RZ_NULLABLE RzSerializeResultInfo *res) {
+	return core_load (db, NULL, core, load_bin_io, prj_file, res);
+}
+
+/**
+ * \brief Load the core from \p src, decoding each namespace only when it is read
+ *
+ * Namespaces that are not needed, like "file" if \p load_bin_io is false, are never decoded.
+ */
+RZ_API bool rz_serialize_core_load_from(RZ_NONNULL RzSerializeNsSource *src, RZ_NONNULL RzCore *core, bool load_bin_io,
+		RZ_NULLABLE const char *prj_file, RZ_NULLABLE RzSerializeResultInfo *res) {
+	rz_return_val_if_fail (src && core, false);
+	Sdb *db = sdb_new0 ();
+	if (!db) {
+		return false;
+	}
+	bool ret = false;
+	if (!src->load (src->user, src->path, db, false)) {
+		SERIALIZE_ERR ("missing core namespace");
+	} else {
+		ret = core_load (db, src, core, load_bin_io, prj_file, res);
+	}
+	sdb_free (db);
+	return ret;
+}
+
 
 /* these file functions are a high-level serialization of RBin and RIO, i.e. for loading the project's underlying binary.
  * It only supports a subset of possible RBin and RIO configurations:
@@ -11,6 +11,9 @@ RZ_API void rz_core_task_scheduler_init (RzCoreTaskScheduler *tasks, RzCore *cor
 	tasks->lock = rz_th_lock_new (true);
 	tasks->tasks_running = 0;
 	tasks->oneshot_running = false;
+	tasks->readers_running = 0;
+	tasks->writers_waiting = 0;
+	tasks->readers_cond = rz_th_cond_new ();
 	tasks->main_task = rz_core_task_new (core, false, NULL, NULL, NULL);
 	rz_list_append (tasks->tasks, tasks->main_task);
 	tasks->current_task = NULL;
@@ -21,6 +24,7 @@ RZ_API void rz_core_task_scheduler_fini (RzCoreTaskScheduler *tasks) {
 	rz_list_free (tasks->tasks_queue);
 	rz_list_free (tasks->oneshot_queue);
 	rz_th_lock_free (tasks->lock);
+	rz_th_cond_free (tasks->readers_cond);
 }
 
 #if HAVE_PTHREAD
@@ -51,6 +55,90 @@ static void tasks_lock_leave(RzCoreTaskScheduler *scheduler, TASK_SIGSET_T *old_
 	tasks_lock_block_signals_reset (old_sigset);
 }
 
+/* Read-only tasks do not take part in the cooperative scheduling below: they
+ * wait until no other task is running, then run in parallel with each other,
+ * each on its own thread and cons context. The other tasks wait for them to
+ * finish before running again, and new read-only tasks wait for those. */
+
+// the read-only task running on the calling thread, if any
+static RZ_TLS RzCoreTask *reader_self = NULL;
+
+static void reader_begin(RzCoreTask *task) {
+	RzCoreTaskScheduler *scheduler = &task->core->tasks;
+	TASK_SIGSET_T old_sigset;
+	tasks_lock_enter (scheduler, &old_sigset);
+	while (scheduler->tasks_running > 0 || scheduler->writers_waiting > 0) {
+		rz_th_cond_wait (scheduler->readers_cond, scheduler->lock);
+	}
+	scheduler->readers_running++;
+	task->state = RZ_CORE_TASK_STATE_RUNNING;
+	tasks_lock_leave (scheduler, &old_sigset);
+	reader_self = task;
+	rz_cons_context_load_thread (task->cons_context);
+}
+
+// to be called with the scheduler lock held
+static void reader_end(RzCoreTask *task) {
+	RzCoreTaskScheduler *scheduler = &task->core->tasks;
+	reader_self = NULL;
+	rz_cons_context_load_thread (NULL);
+	task->state = RZ_CORE_TASK_STATE_DONE;
+	if (!--scheduler->readers_running) {
+		rz_th_cond_signal_all (scheduler->readers_cond);
+	}
+}
+
+// to be called with the scheduler lock held, before a task that may change the core runs
+static void readers_wait(RzCoreTaskScheduler *scheduler) {
+	if (!scheduler->readers_running) {
+		return;
+	}
+	scheduler->writers_waiting++;
+	while (scheduler->readers_running > 0) {
+		rz_th_cond_wait (scheduler->readers_cond, scheduler->lock);
+	}
+	if (!--scheduler->writers_waiting) {
+		rz_th_cond_signal_all (scheduler->readers_cond);
+	}
+}
+
+/* Read-only tasks skip the shell and call the descriptor directly: the
+ * shell itself moves the prompt offset, seeks for `@` and runs nested
+ * commands. Only a plain call to a command flagged read-only is accepted. */
+static RzCmdParsedArgs *reader_args_new(RzCore *core, const char *cmd) {
+	if (!cmd || strpbrk (cmd, "@;|<>~`$(){}#\"'\\")) {
+		return NULL;
+	}
+	int argc;
+	char **argv = rz_str_argv (cmd, &argc);
+	RzCmdParsedArgs *args = NULL;
+	if (argv && argc > 0) {
+		RzCmdDesc *cd = rz_cmd_get_desc (core->rcmd, argv[0]);
+		if (cd && rz_cmd_desc_is_read_only (cd)) {
+			args = rz_cmd_parsed_args_new (argv[0], argc - 1, argv + 1);
+		}
+	}
+	rz_str_argv_free (argv);
+	return args;
+}
+
+static char *reader_cmd_str(RzCore *core, const char *cmd) {
+	RzCmdParsedArgs *args = reader_args_new (core, cmd);
+	if (!args) {
+		return NULL;
+	}
+	rz_cons_push ();
+	if (rz_cmd_call_read_only (core->rcmd, args) != RZ_CMD_STATUS_OK) {
+		eprintf ("Task command `%s` failed\n", cmd);
+	}
+	rz_cons_filter ();
+	const char *buf = rz_cons_get_buffer ();
+	char *res = strdup (buf? buf: "");
+	rz_cons_pop ();
+	rz_cmd_parsed_args_free (args);
+	return res;
+}
+
 typedef struct oneshot_t {
 	RzCoreTaskOneShot func;
 	void *user;
@@ -75,7 +163,8 @@ RZ_API void rz_core_task_print (RzCore *core, RzCoreTask *task, int mode) {
 			rz_cons_print ("done");
 			break;
 		}
-		rz_cons_printf ("\",\"transient\":%s,\"cmd\":", task->transient ? "true" : "false");
+		rz_cons_printf ("\",\"transient\":%s,\"read_only\":%s,\"cmd\":",
+			task->transient ? "true" : "false", task->read_only ? "true" : "false");
 		if (task->cmd) {
 			rz_cons_printf ("\"%s\"}", task->cmd);
 		} else {
@@ -90,7 +179,7 @@ RZ_API void rz_core_task_print (RzCore *core, RzCoreTask *task, int mode) {
 		}
 		rz_cons_printf ("%3d %3s %12s  %s\n",
 					   task->id,
-					   task->transient ? "(t)" : "",
+					   task->transient ? "(t)" : task->read_only ? "(r)" : "",
 					   rz_core_task_status (task),
 					   info ? info : "");
 		}
@@ -149,6 +238,10 @@ RZ_API void rz_core_task_join(RzCoreTaskScheduler *scheduler, RzCoreTask *curren
 	if (current && id == current->id) {
 		return;
 	}
+	if (reader_self) {
+		// the tasks it would wait for are waiting for it
+		return;
+	}
 	if (id >= 0) {
 		RzCoreTask *task = rz_core_task_get_incref (scheduler, id);
 		if (!task) {
@@ -226,7 +319,7 @@ RZ_API RzCoreTask *rz_core_task_new(RzCore *core, bool create_cons, const char *
 	}
 
 	if (create_cons) {
-		task->cons_context = rz_cons_context_new (rz_cons_singleton ()->context);
+		task->cons_context = rz_cons_context_new (rz_cons_context ());
 		if (!task->cons_context) {
 			goto fail;
 		}
@@ -277,6 +370,9 @@ RZ_API void rz_core_task_schedule(RzCoreTask *current, RTaskState next_state) {
 	RzCoreTaskScheduler *scheduler = &core->tasks;
 	bool stop = next_state != RZ_CORE_TASK_STATE_RUNNING;
 
+	if (current->read_only) {
+		return;
+	}
 	if (scheduler->oneshot_running || (!stop && scheduler->tasks_running == 1 && scheduler->oneshots_enqueued == 0)) {
 		return;
 	}
@@ -290,6 +386,9 @@ RZ_API void rz_core_task_schedule(RzCoreTask *current, RTaskState next_state) {
 
 	if (stop) {
 		scheduler->tasks_running--;
+		if (!scheduler->tasks_running) {
+			rz_th_cond_signal_all (scheduler->readers_cond);
+		}
 	}
 
 	// oneshots always have priority.
@@ -340,10 +439,14 @@ RZ_API void rz_core_task_schedule(RzCoreTask *current, RTaskState next_state) {
 static void task_wakeup(RzCoreTask *current) {
 	RzCore *core = current->core;
 	RzCoreTaskScheduler *scheduler = &core->tasks;
+	if (current->read_only) {
+		return;
+	}
 
 	TASK_SIGSET_T old_sigset;
 	tasks_lock_enter (scheduler, &old_sigset);
 
+	readers_wait (scheduler);
 	scheduler->tasks_running++;
 	current->state = RZ_CORE_TASK_STATE_RUNNING;
 
@@ -394,7 +497,11 @@ static RzThreadFunctionRet task_run(RzCoreTask *task) {
 	RzCore *core = task->core;
 	RzCoreTaskScheduler *scheduler = &task->core->tasks;
 
-	task_wakeup (task);
+	if (task->read_only) {
+		reader_begin (task);
+	} else {
+		task_wakeup (task);
+	}
 
 	if (task->cons_context && task->cons_context->breaked) {
 		// breaked in RZ_CORE_TASK_STATE_BEFORE_START
@@ -405,6 +512,8 @@ static RzThreadFunctionRet task_run(RzCoreTask *task) {
 	if (task == scheduler->main_task) {
 		rz_core_cmd (core, task->cmd, task->cmd_log);
 		res_str = NULL;
+	} else if (task->read_only) {
+		res_str = reader_cmd_str (core, task->cmd);
 	} else {
 		res_str = rz_core_cmd_str (core, task->cmd);
 	}
@@ -420,7 +529,11 @@ static RzThreadFunctionRet task_run(RzCoreTask *task) {
 nonstart:
 	tasks_lock_enter (scheduler, &old_sigset);
 
-	task_end (task);
+	if (task->read_only) {
+		reader_end (task);
+	} else {
+		task_end (task);
+	}
 
 	if (task->cb) {
 		task->cb (task->user, task->res);
@@ -470,6 +583,15 @@ RZ_API void rz_core_task_enqueue(RzCoreTaskScheduler *scheduler, RzCoreTask *tas
 	}
 	if (task->cons_context) {
 		rz_cons_context_break_push (task->cons_context, NULL, NULL, false);
+	} else {
+		// without its own cons context it would write into the shared one
+		task->read_only = false;
+	}
+	if (task->read_only) {
+		// anything but a command flagged read-only runs as a regular task
+		RzCmdParsedArgs *args = reader_args_new (task->core, task->cmd);
+		task->read_only = !!args;
+		rz_cmd_parsed_args_free (args);
 	}
 	rz_list_append (scheduler->tasks, task);
 	task->thread = rz_th_new (task_run_thread, task, 0);
@@ -482,7 +604,7 @@ RZ_API void rz_core_task_enqueue_oneshot(RzCoreTaskScheduler *scheduler, RzCoreT
 	}
 	TASK_SIGSET_T old_sigset;
 	tasks_lock_enter (scheduler, &old_sigset);
-	if (scheduler->tasks_running == 0) {
+	if (scheduler->tasks_running == 0 && scheduler->readers_running == 0) {
 		// nothing is running right now and no other task can be scheduled
 		// while core->tasks_lock is locked => just run it
 		scheduler->oneshot_running = true;
@@ -549,6 +671,9 @@ RZ_API const char *rz_core_task_status (RzCoreTask *task) {
 }
 
 RZ_API RzCoreTask *rz_core_task_self (RzCoreTaskScheduler *scheduler) {
+	if (reader_self) {
+		return reader_self;
+	}
 	return scheduler->current_task ? scheduler->current_task : scheduler->main_task;
 }
 
@@ -608,6 +608,8 @@ RZ_API bool rz_debug_select(RzDebug *dbg, int pid, int tid) {
 	if (dbg->h && dbg->h->select && !dbg->h->select (dbg, pid, tid)) {
 		return false;
 	}
+	// the registers synced so far belong to the previous thread
+	rz_reg_dirty_set (dbg->reg, RZ_REG_TYPE_ALL);
 
 	// Don't change the pid/tid if the plugin already modified it due to internal constraints
 	if (dbg->pid == prev_pid) {
@@ -697,6 +699,11 @@ RZ_API RzDebugReasonType rz_debug_wait(RzDebug *dbg, RzBreakpointItem **bp) {
 	/* if our debugger plugin has wait */
 	if (dbg->h && dbg->h->wait) {
 		reason = dbg->h->wait (dbg, dbg->pid);
+		// the target ran, whatever was read from its memory and registers is stale
+		if (dbg->iob.page_cache_flush) {
+			dbg->iob.page_cache_flush (dbg->iob.io);
+		}
+		rz_reg_dirty_set (dbg->reg, RZ_REG_TYPE_ALL);
 		if (reason == RZ_DEBUG_REASON_DEAD) {
 			eprintf ("\n==> Process finished\n\n");
 			RzEventDebugProcessFinished event = {
@@ -1034,7 +1041,9 @@ RZ_API int rz_debug_step_over(RzDebug *dbg, int steps) {
 				dbg->session->maxcnum++;
 				rz_debug_trace_ins_before (dbg);
 			}
-			if (!dbg->h->step_over (dbg)) {
+			bool stepped = dbg->h->step_over (dbg);
+			rz_reg_dirty_set (dbg->reg, RZ_REG_TYPE_ALL);
+			if (!stepped) {
 				return steps_taken;
 			}
 			if (dbg->session && dbg->recoil_mode == RZ_DBG_RECOIL_NONE) {
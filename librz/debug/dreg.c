@@ -42,8 +42,14 @@ RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write) {
 			}
 		}
 	}
+	int dirty = write ? rz_reg_dirty_types (dbg->reg) : 0;
 	do {
 		if (write) {
+			// the target already holds these
+			if (!(dirty & (1 << i))) {
+				i++;
+				continue;
+			}
 			ut8 *buf = rz_reg_get_bytes (dbg->reg, i, &size);
 			if (!buf || !dbg->h->reg_write (dbg, i, buf, size)) {
 				if (i == RZ_REG_TYPE_GPR) {
@@ -54,6 +60,8 @@ RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write) {
 					free (buf);
 					return false;
 				}
+			} else {
+				rz_reg_dirty_clear (dbg->reg, i);
 			}
 			free (buf);
 		} else {
@@ -70,6 +78,7 @@ RZ_API int rz_debug_reg_sync(RzDebug *dbg, int type, int write) {
 				// we need to check against zero because reg_read can return false
 				if (size > 0) {
 					rz_reg_set_bytes (dbg->reg, i, buf, size); //RZ_MIN (size, bufsize));
+					rz_reg_dirty_clear (dbg->reg, i);
 			//		free (buf);
 			//		return true;
 				}
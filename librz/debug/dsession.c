@@ -4,14 +4,13 @@
 #include <rz_util/rz_json.h>
 
 #define CMP_CNUM_REG(x, y) ((x) >= ((RzDebugChangeReg *)y)->cnum ? 1 : -1)
-#define CMP_CNUM_MEM(x, y) ((x) >= ((RzDebugChangeMem *)y)->cnum ? 1 : -1)
 #define CMP_CNUM_CHKPT(x, y) ((x) >= ((RzDebugCheckpoint *)y)->cnum ? 1 : -1)
 
 RZ_API void rz_debug_session_free(RzDebugSession *session) {
 	if (session) {
 		rz_vector_free (session->checkpoints);
 		ht_up_free (session->registers);
-		ht_up_free (session->memory);
+		rz_mem_journal_free (session->memory);
 		RZ_FREE (session);
 	}
 }
@@ -45,7 +44,7 @@ RZ_API RzDebugSession *rz_debug_session_new(void) {
 		rz_debug_session_free (session);
 		return NULL;
 	}
-	session->memory = ht_up_new (NULL, htup_vector_free, NULL);
+	session->memory = rz_mem_journal_new ();
 	if (!session->memory) {
 		rz_debug_session_free (session);
 		return NULL;
@@ -68,22 +67,14 @@ RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
 		checkpoint.arena[i] = b;
 	}
 
-	// Save current memory maps
-	checkpoint.snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
+	// Save current memory maps, sharing the pages that did not change since the last checkpoint
+	RzDebugSession *session = dbg->session;
+	RzDebugCheckpoint *last = rz_vector_empty (session->checkpoints) ? NULL : rz_vector_index_ptr (session->checkpoints, session->checkpoints->len - 1);
+	checkpoint.snaps = rz_debug_snap_maps (dbg, RZ_PERM_RW, last ? last->snaps : NULL, last && session->soft_dirty);
 	if (!checkpoint.snaps) {
 		return false;
 	}
-	RzListIter *iter;
-	RzDebugMap *map;
-	rz_debug_map_sync (dbg);
-	rz_list_foreach (dbg->maps, iter, map) {
-		if ((map->perm & RZ_PERM_RW) == RZ_PERM_RW) {
-			RzDebugSnap *snap = rz_debug_snap_map (dbg, map);
-			if (snap) {
-				rz_list_append (checkpoint.snaps, snap);
-			}
-		}
-	}
+	session->soft_dirty = rz_debug_snap_clear_soft_dirty (dbg);
 
 	checkpoint.cnum = dbg->session->cnum;
 	rz_vector_push (dbg->session->checkpoints, &checkpoint);
@@ -132,31 +123,19 @@ RZ_API void _restore_registers(RzDebug *dbg, ut32 cnum) {
 }
 
 static void _set_initial_memory(RzDebug *dbg) {
-	RzListIter *iter;
-	RzDebugSnap *snap;
-	rz_list_foreach (dbg->session->cur_chkpt->snaps, iter, snap) {
-		dbg->iob.write_at (dbg->iob.io, snap->addr, snap->data, snap->size);
-	}
+	rz_debug_snap_restore (dbg, dbg->session->cur_chkpt->snaps);
 }
 
-static bool _restore_memory_cb(void *user, const ut64 key, const void *value) {
-	size_t index;
+static bool _restore_memory_cb(void *user, ut64 addr, const ut8 *buf, ut32 len) {
 	RzDebug *dbg = user;
-	RzVector *vmem = (RzVector *)value;
-
-	rz_vector_upper_bound (vmem, dbg->session->cnum, index, CMP_CNUM_MEM);
-	if (index > 0 && index <= vmem->len) {
-		RzDebugChangeMem *mem = rz_vector_index_ptr (vmem, index - 1);
-		if (mem->cnum > dbg->session->cur_chkpt->cnum) {
-			dbg->iob.write_at (dbg->iob.io, key, &mem->data, 1);
-		}
-	}
+	dbg->iob.write_at (dbg->iob.io, addr, buf, len);
 	return true;
 }
 
 static void _restore_memory(RzDebug *dbg, ut32 cnum) {
 	_set_initial_memory (dbg);
-	ht_up_foreach (dbg->session->memory, _restore_memory_cb, dbg);
+	// the snapshots hold the memory as of the checkpoint
+	rz_mem_journal_replay (dbg->session->memory, dbg->session->cur_chkpt->cnum + 1, cnum, _restore_memory_cb, dbg);
 }
 
 static RzDebugCheckpoint *_get_checkpoint_before(RzDebugSession *session, ut32 cnum) {
@@ -182,35 +161,26 @@ RZ_API void rz_debug_session_restore_reg_mem(RzDebug *dbg, ut32 cnum) {
 }
 
 RZ_API void rz_debug_session_list_memory(RzDebug *dbg) {
+	RzList *snaps = rz_debug_snap_maps (dbg, RZ_PERM_RW, NULL, false);
 	RzListIter *iter;
-	RzDebugMap *map;
-	rz_debug_map_sync (dbg);
-	rz_list_foreach (dbg->maps, iter, map) {
-		if ((map->perm & RZ_PERM_RW) == RZ_PERM_RW) {
-			RzDebugSnap *snap = rz_debug_snap_map (dbg, map);
-			if (!snap) {
-				return;
-			}
-
-			ut8 *hash = rz_debug_snap_get_hash (snap);
-			if (!hash) {
-				rz_debug_snap_free (snap);
-				return;
-			}
-
-			char *hexstr = rz_hex_bin2strdup (hash, RZ_HASH_SIZE_SHA256);
-			if (!hexstr) {
-				free (hash);
-				rz_debug_snap_free (snap);
-				return;
-			}
-			dbg->cb_printf ("%s: %s\n", snap->name, hexstr);
+	RzDebugSnap *snap;
+	rz_list_foreach (snaps, iter, snap) {
+		ut8 *hash = rz_debug_snap_get_hash (snap);
+		if (!hash) {
+			break;
+		}
 
-			free (hexstr);
+		char *hexstr = rz_hex_bin2strdup (hash, RZ_HASH_SIZE_SHA256);
+		if (!hexstr) {
 			free (hash);
-			rz_debug_snap_free (snap);
+			break;
 		}
+		dbg->cb_printf ("%s: %s\n", snap->name, hexstr);
+
+		free (hexstr);
+		free (hash);
 	}
+	rz_list_free (snaps);
 }
 
 RZ_API bool rz_debug_session_add_reg_change(RzDebugSession *session, int arena, ut64 offset, ut64 data) {
@@ -228,18 +198,11 @@ RZ_API bool rz_debug_session_add_reg_change(RzDebugSession *session, int arena,
 	return true;
 }
 
-RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, ut8 data) {
-	RzVector *vmem = ht_up_find (session->memory, addr, NULL);
-	if (!vmem) {
-		vmem = rz_vector_new (sizeof (RzDebugChangeMem), NULL, NULL);
-		if (!vmem) {
-			eprintf ("Error: creating a memory vector.\n");
-			return false;
-		}
-		ht_up_insert (session->memory, addr, vmem);
+RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, const ut8 *buf, ut32 len) {
+	if (!rz_mem_journal_add (session->memory, session->cnum, addr, buf, len)) {
+		eprintf ("Error: recording a memory change.\n");
+		return false;
 	}
-	RzDebugChangeMem mem = { session->cnum, data };
-	rz_vector_push (vmem, &mem);
 	return true;
 }
 
@@ -272,31 +235,20 @@ static void serialize_registers(Sdb *db, HtUP *registers) {
 	ht_up_foreach (registers, serialize_register_cb, db);
 }
 
-// 0x<addr>={"size":<size_t>, "a":[<RzDebugChangeMem>]}},
-static bool serialize_memory_cb(void *db, const ut64 k, const void *v) {
-	RzDebugChangeMem *mem;
-	RzVector *vmem = (RzVector *)v;
-	PJ *j = pj_new ();
-	if (!j) {
-		return false;
+// journal=<base64 of rz_mem_journal_serialize()>
+static void serialize_memory(Sdb *db, RzMemJournal *memory) {
+	ut64 size;
+	ut8 *buf = rz_mem_journal_serialize (memory, &size);
+	if (!buf || size > ST32_MAX) {
+		free (buf);
+		return;
 	}
-	pj_a (j);
-
-	rz_vector_foreach (vmem, mem) {
-		pj_o (j);
-		pj_kN (j, "cnum", mem->cnum);
-		pj_kn (j, "data", mem->data);
-		pj_end (j);
+	char *ebuf = sdb_encode (buf, (int)size);
+	if (ebuf) {
+		sdb_set (db, "journal", ebuf, 0);
+		free (ebuf);
 	}
-
-	pj_end (j);
-	sdb_set (db, sdb_fmt ("0x%"PFMT64x, k), pj_string (j), 0);
-	pj_free (j);
-	return true;
-}
-
-static void serialize_memory(Sdb *db, HtUP *memory) {
-	ht_up_foreach (memory, serialize_memory_cb, db);
+	free (buf);
 }
 
 static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
@@ -343,7 +295,9 @@ static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
 			pj_kn (j, "addr", snap->addr);
 			pj_kn (j, "addr_end", snap->addr_end);
 			pj_kn (j, "size", snap->size);
-			char *edata = sdb_encode ((const void *)snap->data, snap->size);
+			ut8 *data = rz_debug_snap_get_data (snap);
+			char *edata = data ? sdb_encode (data, snap->size) : NULL;
+			free (data);
 			if (!edata) {
 				pj_free (j);
 				return;
@@ -373,7 +327,7 @@ static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
  *     0x<addr>={"size":<size_t>, "a":[<RzDebugChangeReg>]}
  *
  *   /memory
- *     0x<addr>={"size":<size_t>, "a":[<RzDebugChangeMem>]}
+ *     journal=<base64>
  *
  *   /checkpoints
  *     0x<cnum>={
@@ -384,8 +338,9 @@ static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
  * RzDebugChangeReg JSON:
  * {"cnum":<int>, "data":<ut64>}
  *
- * RzDebugChangeMem JSON:
- * {"cnum":<int>, "data":<ut8>}
+ * journal is the binary encoding of the RzMemJournal, see rz_mem_journal_serialize().
+ * Sessions saved before it used one key per address instead:
+ *   0x<addr>=[{"cnum":<int>, "data":<ut8>}, ...]
  *
  * RzRegArena JSON:
  * {"size":<int>, "bytes":"<base64>"}
@@ -460,29 +415,27 @@ RZ_API bool rz_debug_session_save(RzDebugSession *session, const char *path) {
 	if (!v || v->type != t) \
 		continue
 
-static bool deserialize_memory_cb(void *user, const char *addr, const char *v) {
+typedef struct {
+	ut32 cnum;
+	ut64 addr;
+	ut8 data;
+} LegacyMemChange;
+
+// 0x<addr>=[{"cnum":<int>, "data":<ut8>}, ...]
+static bool deserialize_legacy_memory_cb(void *user, const char *addr, const char *v) {
 	RJson *child;
 	char *json_str = strdup (v);
 	if (!json_str) {
 		return true;
 	}
-	RJson *reg_json = rz_json_parse (json_str);
-	if (!reg_json || reg_json->type != RZ_JSON_ARRAY) {
+	RJson *mem_json = rz_json_parse (json_str);
+	if (!mem_json || mem_json->type != RZ_JSON_ARRAY) {
 		free (json_str);
 		return true;
 	}
 
-	HtUP *memory = user;
-	// Insert a new vector into `memory` HtUP at `addr`
-	RzVector *vmem = rz_vector_new (sizeof (RzDebugChangeMem), NULL, NULL);
-	if (!vmem) {
-		eprintf ("Error: failed to allocate RzVector vmem.\n");
-		return false;
-	}
-	ht_up_insert (memory, sdb_atoi (addr), vmem);
-
-	// Extract <RzDebugChangeMem>'s into the new vector
-	for (child = reg_json->children.first; child; child = child->next) {
+	RzVector *changes = user;
+	for (child = mem_json->children.first; child; child = child->next) {
 		if (child->type != RZ_JSON_OBJECT) {
 			continue;
 		}
@@ -494,15 +447,44 @@ static bool deserialize_memory_cb(void *user, const char *addr, const char *v) {
 		CHECK_TYPE (baby, RZ_JSON_INTEGER);
 		ut64 data = baby->num.u_value;
 
-		RzDebugChangeMem mem = { cnum, data };
-		rz_vector_push (vmem, &mem);
+		LegacyMemChange mem = { cnum, sdb_atoi (addr), data };
+		rz_vector_push (changes, &mem);
 	}
 
+	rz_json_free (mem_json);
+	free (json_str);
 	return true;
 }
 
-static void deserialize_memory(Sdb *db, HtUP *memory) {
-	sdb_foreach (db, deserialize_memory_cb, memory);
+static int legacy_mem_change_cmp(const void *a, const void *b) {
+	const LegacyMemChange *x = a, *y = b;
+	if (x->cnum != y->cnum) {
+		return x->cnum < y->cnum ? -1 : 1;
+	}
+	return x->addr < y->addr ? -1 : x->addr > y->addr;
+}
+
+static void deserialize_memory(Sdb *db, RzMemJournal *memory) {
+	const char *journal = sdb_const_get (db, "journal", 0);
+	if (journal) {
+		int size;
+		ut8 *buf = sdb_decode (journal, &size);
+		if (!buf || !rz_mem_journal_deserialize (memory, buf, size)) {
+			eprintf ("Error: failed to decode the memory journal.\n");
+		}
+		free (buf);
+		return;
+	}
+	// the journal is ordered by cnum, so gather the changes of every address first
+	RzVector changes;
+	LegacyMemChange *mem;
+	rz_vector_init (&changes, sizeof (LegacyMemChange), NULL, NULL);
+	sdb_foreach (db, deserialize_legacy_memory_cb, &changes);
+	qsort (changes.a, changes.len, sizeof (LegacyMemChange), legacy_mem_change_cmp);
+	rz_vector_foreach (&changes, mem) {
+		rz_mem_journal_add (memory, mem->cnum, mem->addr, &mem->data, 1);
+	}
+	rz_vector_fini (&changes);
 }
 
 static bool deserialize_registers_cb(void *user, const char *addr, const char *v) {
@@ -639,7 +621,15 @@ static bool deserialize_checkpoints_cb(void *user, const char *cnum, const char
 		snap->addr = addrj->num.u_value;
 		snap->addr_end = addr_endj->num.u_value;
 		snap->size = sizej->num.u_value;
-		snap->data = sdb_decode (dataj->str_value, NULL);
+		int len = 0;
+		ut8 *data = sdb_decode (dataj->str_value, &len);
+		bool ok = data && len >= snap->size && rz_debug_snap_set_data (snap, data, NULL);
+		free (data);
+		if (!ok) {
+			eprintf ("Error: invalid data of snap at 0x%" PFMT64x "\n", snap->addr);
+			rz_debug_snap_free (snap);
+			continue;
+		}
 		snap->perm = permj->num.s_value;
 		snap->user = userj->num.s_value;
 		snap->shared = sharedj->num.u_value;
@@ -711,6 +701,8 @@ RZ_API void rz_debug_session_deserialize(RzDebugSession *session, Sdb *db) {
 	DESERIALIZE ("memory", deserialize_memory (subdb, session->memory));
 	DESERIALIZE ("registers", deserialize_registers (subdb, session->registers));
 	DESERIALIZE ("checkpoints", deserialize_checkpoints (subdb, session->checkpoints));
+	// the soft-dirty bits do not relate to the loaded checkpoints
+	session->soft_dirty = false;
 }
 
 RZ_API bool rz_debug_session_load(RzDebug *dbg, const char *path) {
@@ -3,16 +3,158 @@
 #include <rz_debug.h>
 #include <rz_hash.h>
 
+#if __linux__ && !__ANDROID__
+#include <errno.h>
+#include <sys/uio.h>
+#define USE_PROCESS_VM 1
+// UIO_MAXIOV, the most ranges a single process_vm call takes
+#define PROCESS_VM_IOV 1024
+#else
+#define USE_PROCESS_VM 0
+#endif
+
+/*
+ * Snapshots are split in pages of RZ_DEBUG_SNAP_PAGE_SIZE bytes. When a map
+ * is snapshotted again, e.g. by the next checkpoint, its pages that did not
+ * change are shared with the previous snapshot instead of being copied.
+ *
+ * On Linux, the soft-dirty bits of /proc/pid/pagemap tell which pages were
+ * written since the bits were cleared through /proc/pid/clear_refs, so only
+ * those are read. Otherwise all pages are read and compared to the previous
+ * snapshot.
+ */
+
+#define SNAP_PAGES(size) (((ut64)(size) + RZ_DEBUG_SNAP_PAGE_SIZE - 1) / RZ_DEBUG_SNAP_PAGE_SIZE)
+// pages read and compared at once
+#define SNAP_BATCH 4096
+// pages compared at once on restore, their current contents are copied to a 1 MiB buffer
+#define RESTORE_BATCH 256
+
+#if __linux__
+#define PAGEMAP_SOFT_DIRTY (1ULL << 55)
+#define PAGEMAP_SWAPPED    (1ULL << 62)
+#define PAGEMAP_PRESENT    (1ULL << 63)
+#endif
+
+static bool is_native(RzDebug *dbg) {
+	return dbg->h && !strcmp (dbg->h->name, "native") && dbg->pid > 0;
+}
+
+static void mem_io(RzDebug *dbg, const RzDebugMemRange *range, ut64 done, bool write) {
+	while (done < range->size) {
+		int len = (int)RZ_MIN (range->size - done, 0x10000000);
+		if (write) {
+			dbg->iob.write_at (dbg->iob.io, range->addr + done, range->buf + done, len);
+		} else {
+			dbg->iob.read_at (dbg->iob.io, range->addr + done, range->buf + done, len);
+		}
+		done += len;
+	}
+}
+
+static void mem_rangesv(RzDebug *dbg, const RzDebugMemRange *ranges, size_t count, bool write) {
+	size_t i = 0;
+#if USE_PROCESS_VM
+	// the native backend debugs a local process, so process_vm_readv/writev can move
+	// many ranges in a single syscall, instead of one or more ptrace calls per word
+	if (is_native (dbg) && count) {
+		size_t max = RZ_MIN (count, PROCESS_VM_IOV);
+		struct iovec *local = RZ_NEWS (struct iovec, max);
+		struct iovec *remote = RZ_NEWS (struct iovec, max);
+		while (local && remote && i < count) {
+			size_t n, j;
+			for (n = 0; n < max && i + n < count; n++) {
+				const RzDebugMemRange *r = &ranges[i + n];
+				local[n] = (struct iovec){ r->buf, r->size };
+				remote[n] = (struct iovec){ (void *)(size_t)r->addr, r->size };
+			}
+			ssize_t res = write
+				? process_vm_writev (dbg->pid, local, n, remote, n, 0)
+				: process_vm_readv (dbg->pid, local, n, remote, n, 0);
+			if (res < 0 && errno != EFAULT) {
+				// not supported or not permitted, io does it all
+				break;
+			}
+			size_t done = res < 0 ? 0 : (size_t)res;
+			for (j = 0; j < n && done >= ranges[i].size; j++, i++) {
+				done -= ranges[i].size;
+			}
+			if (j < n) {
+				// stopped in the middle of a range, e.g. at a page it cannot access
+				mem_io (dbg, &ranges[i], done, write);
+				i++;
+			}
+		}
+		free (local);
+		free (remote);
+	}
+#endif
+	for (; i < count; i++) {
+		mem_io (dbg, &ranges[i], 0, write);
+	}
+}
+
+/**
+ * \brief Read the debuggee memory of many ranges at once
+ *
+ * When debugging a local process natively on Linux, all ranges are read with
+ * a few process_vm_readv calls. Ranges, or their remainders, that it cannot
+ * read are read through io.
+ */
+RZ_API void rz_debug_mem_readv(RzDebug *dbg, RzDebugMemRange *ranges, size_t count) {
+	rz_return_if_fail (dbg && (ranges || !count));
+	mem_rangesv (dbg, ranges, count, false);
+}
+
+/**
+ * \brief Write the debuggee memory of many ranges at once, see rz_debug_mem_readv()
+ */
+RZ_API void rz_debug_mem_writev(RzDebug *dbg, const RzDebugMemRange *ranges, size_t count) {
+	rz_return_if_fail (dbg && (ranges || !count));
+	mem_rangesv (dbg, ranges, count, true);
+}
+
+static void page_unref(RzDebugSnapPage *page) {
+	if (page && !--page->refs) {
+		free (page);
+	}
+}
+
+static RzDebugSnapPage *page_ref(RzDebugSnapPage *page) {
+	if (page) {
+		page->refs++;
+	}
+	return page;
+}
+
+static RzDebugSnapPage *page_new(void) {
+	RzDebugSnapPage *page = RZ_NEW (RzDebugSnapPage);
+	if (page) {
+		page->refs = 1;
+	}
+	return page;
+}
+
+static ut32 page_len(RzDebugSnap *snap, ut64 idx) {
+	return (ut32)RZ_MIN (RZ_DEBUG_SNAP_PAGE_SIZE, snap->size - idx * RZ_DEBUG_SNAP_PAGE_SIZE);
+}
+
 RZ_API void rz_debug_snap_free(RzDebugSnap *snap) {
 	if (snap) {
+		if (snap->pages) {
+			ut64 i;
+			for (i = 0; i < SNAP_PAGES (snap->size); i++) {
+				page_unref (snap->pages[i]);
+			}
+			free (snap->pages);
+		}
 		free (snap->name);
-		free (snap->data);
 		RZ_FREE (snap);
 	}
 }
 
-RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
-	rz_return_val_if_fail (dbg && map, NULL);
+// a snapshot of map without any pages yet
+static RzDebugSnap *snap_new(RzDebugMap *map) {
 	if (map->size < 1) {
 		eprintf ("Invalid map size\n");
 		return NULL;
@@ -31,68 +173,372 @@ RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
 	snap->user = map->user;
 	snap->shared = map->shared;
 
-	snap->data = malloc (map->size);
-	if (!snap->data) {
+	snap->pages = RZ_NEWS0 (RzDebugSnapPage *, SNAP_PAGES (snap->size));
+	if (!snap->pages) {
 		rz_debug_snap_free (snap);
 		return NULL;
 	}
-	eprintf ("Reading %d byte(s) from 0x%08"PFMT64x "...\n", snap->size, snap->addr);
-	dbg->iob.read_at (dbg->iob.io, snap->addr, snap->data, snap->size);
-
 	return snap;
 }
 
-RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr) {
-	return (snap->addr <= addr && addr >= snap->addr_end);
+/* pages to be read into snapshots, sharing the previous page where it did not change */
+typedef struct {
+	RzDebug *dbg;
+	size_t count;
+	RzDebugMemRange ranges[SNAP_BATCH];
+	RzDebugSnapPage **slots[SNAP_BATCH];
+	RzDebugSnapPage *prev[SNAP_BATCH];
+} SnapBatch;
+
+static void batch_flush(SnapBatch *b) {
+	rz_debug_mem_readv (b->dbg, b->ranges, b->count);
+	size_t i;
+	for (i = 0; i < b->count; i++) {
+		RzDebugSnapPage *page = *b->slots[i];
+		if (b->prev[i] && !memcmp (b->prev[i]->data, page->data, b->ranges[i].size)) {
+			free (page);
+			*b->slots[i] = page_ref (b->prev[i]);
+		}
+	}
+	b->count = 0;
 }
 
-RZ_API ut8 *rz_debug_snap_get_hash(RzDebugSnap *snap) {
-	ut64 algobit = rz_hash_name_to_bits ("sha256");
-	RzHash *ctx = rz_hash_new (true, algobit);
-	if (!ctx) {
-		return NULL;
+static bool batch_add(SnapBatch *b, RzDebugSnap *snap, ut64 idx, RzDebugSnapPage *prev) {
+	RzDebugSnapPage *page = page_new ();
+	if (!page) {
+		return false;
+	}
+	snap->pages[idx] = page;
+	b->ranges[b->count] = (RzDebugMemRange){ snap->addr + idx * RZ_DEBUG_SNAP_PAGE_SIZE, page->data, page_len (snap, idx) };
+	b->slots[b->count] = &snap->pages[idx];
+	b->prev[b->count] = prev;
+	if (++b->count == SNAP_BATCH) {
+		batch_flush (b);
 	}
+	return true;
+}
 
-	rz_hash_do_begin (ctx, algobit);
-	rz_hash_calculate (ctx, algobit, snap->data, snap->size);
-	rz_hash_do_end (ctx, algobit);
+#if __linux__
+static bool soft_dirty_supported(void) {
+	static int supported = -1;
+	if (supported >= 0) {
+		return supported;
+	}
+	supported = 0;
+	// a page that was just written to is soft-dirty if the kernel tracks it
+	long ps = sysconf (_SC_PAGESIZE);
+	volatile ut8 *probe = ps > 0 ? malloc (ps * 2) : NULL;
+	int fd = rz_sandbox_open ("/proc/self/pagemap", O_RDONLY, 0);
+	if (probe && fd != -1) {
+		ut64 addr = ((ut64)(size_t)probe + ps) & ~(ut64)(ps - 1);
+		*(volatile ut8 *)(size_t)addr = 1;
+		ut64 e;
+		if (pread (fd, &e, sizeof (e), (addr / ps) * sizeof (e)) == sizeof (e)) {
+			supported = (e & PAGEMAP_PRESENT) && (e & PAGEMAP_SOFT_DIRTY);
+		}
+	}
+	if (fd != -1) {
+		close (fd);
+	}
+	free ((void *)probe);
+	return supported;
+}
+#endif
 
-	ut8 *ret = malloc (RZ_HASH_SIZE_SHA256);
-	if (!ret) {
-		rz_hash_free (ctx);
+// flags of the pages of snap that were written since the soft-dirty bits were cleared,
+// or NULL if they are not known
+static ut8 *soft_dirty_pages(RzDebug *dbg, RzDebugSnap *snap) {
+#if __linux__
+	long ps = sysconf (_SC_PAGESIZE);
+	if (ps <= 0 || !is_native (dbg) || !soft_dirty_supported ()) {
+		return NULL;
+	}
+	char path[64];
+	snprintf (path, sizeof (path), "/proc/%d/pagemap", dbg->pid);
+	int fd = rz_sandbox_open (path, O_RDONLY, 0);
+	if (fd == -1) {
 		return NULL;
 	}
-	memcpy (ret, ctx->digest, RZ_HASH_SIZE_SHA256);
+	ut64 first = snap->addr / ps;
+	size_t n = (snap->addr + snap->size - 1) / ps - first + 1;
+	ut64 *entries = RZ_NEWS (ut64, n);
+	ut8 *dirty = RZ_NEWS0 (ut8, SNAP_PAGES (snap->size));
+	if (!entries || !dirty || pread (fd, entries, n * sizeof (ut64), first * sizeof (ut64)) != n * sizeof (ut64)) {
+		RZ_FREE (dirty);
+		goto beach;
+	}
+	ut64 i;
+	for (i = 0; i < SNAP_PAGES (snap->size); i++) {
+		ut64 e = entries[(snap->addr + i * RZ_DEBUG_SNAP_PAGE_SIZE) / ps - first];
+		// pages that are not there may have been dropped, e.g. with MADV_DONTNEED
+		dirty[i] = (e & PAGEMAP_SOFT_DIRTY) || !(e & (PAGEMAP_PRESENT | PAGEMAP_SWAPPED));
+	}
+beach:
+	free (entries);
+	close (fd);
+	return dirty;
+#else
+	return NULL;
+#endif
+}
 
-	rz_hash_free (ctx);
+/**
+ * \brief Clear the soft-dirty bits of the debuggee pages
+ *
+ * \return true if the kernel tracks them and they were cleared, so that the
+ * next rz_debug_snap_maps() can read only the pages written since.
+ */
+RZ_API bool rz_debug_snap_clear_soft_dirty(RzDebug *dbg) {
+	rz_return_val_if_fail (dbg, false);
+#if __linux__
+	if (!is_native (dbg) || !soft_dirty_supported ()) {
+		return false;
+	}
+	char path[64];
+	snprintf (path, sizeof (path), "/proc/%d/clear_refs", dbg->pid);
+	int fd = rz_sandbox_open (path, O_WRONLY, 0);
+	if (fd == -1) {
+		return false;
+	}
+	bool ret = write (fd, "4", 1) == 1;
+	close (fd);
 	return ret;
+#else
+	return false;
+#endif
 }
 
-RZ_API bool rz_debug_snap_is_equal(RzDebugSnap *a, RzDebugSnap *b) {
-	bool ret = false;
-	ut64 algobit = rz_hash_name_to_bits ("sha256");
-	RzHash *ctx = rz_hash_new (true, algobit);
-	if (!ctx) {
-		return ret;
+static RzDebugSnap *snap_find(RzList *snaps, RzDebugSnap *snap) {
+	RzListIter *iter;
+	RzDebugSnap *s;
+	rz_list_foreach (snaps, iter, s) {
+		if (s->addr == snap->addr && s->size == snap->size) {
+			return s;
+		}
+	}
+	return NULL;
+}
+
+RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
+	rz_return_val_if_fail (dbg && map, NULL);
+	RzDebugSnap *snap = snap_new (map);
+	if (!snap) {
+		return NULL;
+	}
+	eprintf ("Reading %d byte(s) from 0x%08"PFMT64x "...\n", snap->size, snap->addr);
+	ut8 *data = malloc (snap->size);
+	if (!data) {
+		rz_debug_snap_free (snap);
+		return NULL;
+	}
+	dbg->iob.read_at (dbg->iob.io, snap->addr, data, snap->size);
+	bool ok = rz_debug_snap_set_data (snap, data, NULL);
+	free (data);
+	if (!ok) {
+		rz_debug_snap_free (snap);
+		return NULL;
+	}
+	return snap;
+}
+
+/**
+ * \brief Take a snapshot of every map of the debuggee that has at least the permissions \p perm
+ *
+ * The memory of all maps is read at once with rz_debug_mem_readv().
+ *
+ * \param prev snapshots taken before, their pages are shared where the memory did not change
+ * \param prev_soft_dirty whether the soft-dirty bits were cleared right after \p prev was taken,
+ * see rz_debug_snap_clear_soft_dirty()
+ */
+RZ_API RzList *rz_debug_snap_maps(RzDebug *dbg, int perm, RZ_NULLABLE RzList *prev, bool prev_soft_dirty) {
+	rz_return_val_if_fail (dbg, NULL);
+	RzList *snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
+	SnapBatch *b = RZ_NEW (SnapBatch);
+	if (!snaps || !b) {
+		rz_list_free (snaps);
+		free (b);
+		return NULL;
+	}
+	b->dbg = dbg;
+	b->count = 0;
+	RzListIter *iter;
+	RzDebugMap *map;
+	rz_debug_map_sync (dbg);
+	rz_list_foreach (dbg->maps, iter, map) {
+		if ((map->perm & perm) != perm) {
+			continue;
+		}
+		RzDebugSnap *snap = snap_new (map);
+		if (!snap) {
+			continue;
+		}
+		rz_list_append (snaps, snap);
+		RzDebugSnap *old = prev ? snap_find (prev, snap) : NULL;
+		ut8 *dirty = old && prev_soft_dirty ? soft_dirty_pages (dbg, snap) : NULL;
+		ut64 i;
+		for (i = 0; i < SNAP_PAGES (snap->size); i++) {
+			RzDebugSnapPage *old_page = old ? old->pages[i] : NULL;
+			if (dirty && !dirty[i] && old_page) {
+				snap->pages[i] = page_ref (old_page);
+			} else if (!batch_add (b, snap, i, old_page)) {
+				break;
+			}
+		}
+		free (dirty);
+	}
+	batch_flush (b);
+	free (b);
+	// pages that could not be allocated leave the snapshot incomplete
+	RzListIter *tmp;
+	RzDebugSnap *snap;
+	rz_list_foreach_safe (snaps, iter, tmp, snap) {
+		ut64 i;
+		for (i = 0; i < SNAP_PAGES (snap->size) && snap->pages[i]; i++) {
+		}
+		if (i < SNAP_PAGES (snap->size)) {
+			rz_list_delete (snaps, iter);
+		}
+	}
+	return snaps;
+}
+
+typedef struct {
+	RzDebug *dbg;
+	size_t count;
+	ut8 cur[RESTORE_BATCH][RZ_DEBUG_SNAP_PAGE_SIZE];
+	RzDebugMemRange reads[RESTORE_BATCH];
+	RzDebugMemRange writes[RESTORE_BATCH];
+} RestoreBatch;
+
+static void restore_flush(RestoreBatch *b) {
+	rz_debug_mem_readv (b->dbg, b->reads, b->count);
+	size_t i, n = 0;
+	for (i = 0; i < b->count; i++) {
+		if (memcmp (b->cur[i], b->writes[i].buf, b->writes[i].size)) {
+			b->writes[n++] = b->writes[i];
+		}
+	}
+	rz_debug_mem_writev (b->dbg, b->writes, n);
+	b->count = 0;
+}
+
+/**
+ * \brief Write the snapshots back to the debuggee memory
+ *
+ * Only the pages whose contents differ from the current memory are written.
+ */
+RZ_API void rz_debug_snap_restore(RzDebug *dbg, RzList *snaps) {
+	rz_return_if_fail (dbg && snaps);
+	RestoreBatch *b = RZ_NEW (RestoreBatch);
+	if (!b) {
+		return;
 	}
+	b->dbg = dbg;
+	b->count = 0;
+	RzListIter *iter;
+	RzDebugSnap *snap;
+	rz_list_foreach (snaps, iter, snap) {
+		ut64 i;
+		for (i = 0; i < SNAP_PAGES (snap->size); i++) {
+			ut64 addr = snap->addr + i * RZ_DEBUG_SNAP_PAGE_SIZE;
+			ut32 len = page_len (snap, i);
+			b->reads[b->count] = (RzDebugMemRange){ addr, b->cur[b->count], len };
+			b->writes[b->count] = (RzDebugMemRange){ addr, snap->pages[i]->data, len };
+			if (++b->count == RESTORE_BATCH) {
+				restore_flush (b);
+			}
+		}
+	}
+	restore_flush (b);
+	free (b);
+}
 
-	rz_hash_do_begin (ctx, algobit);
-	rz_hash_calculate (ctx, algobit, a->data, a->size);
-	rz_hash_do_end (ctx, algobit);
+/**
+ * \brief Copy the contents of \p snap to a single buffer of snap->size bytes
+ */
+RZ_API RZ_OWN ut8 *rz_debug_snap_get_data(RzDebugSnap *snap) {
+	rz_return_val_if_fail (snap, NULL);
+	ut8 *data = malloc (snap->size);
+	if (!data) {
+		return NULL;
+	}
+	ut64 i;
+	for (i = 0; i < SNAP_PAGES (snap->size); i++) {
+		memcpy (data + i * RZ_DEBUG_SNAP_PAGE_SIZE, snap->pages[i]->data, page_len (snap, i));
+	}
+	return data;
+}
 
-	ut8 *temp = malloc (RZ_HASH_SIZE_SHA256);
-	if (!temp) {
-		rz_hash_free (ctx);
-		return ret;
+/**
+ * \brief Set the contents of \p snap from \p data of snap->size bytes
+ *
+ * \param prev snapshot of the same map, whose pages are shared where they hold the same data
+ */
+RZ_API bool rz_debug_snap_set_data(RzDebugSnap *snap, const ut8 *data, RZ_NULLABLE RzDebugSnap *prev) {
+	rz_return_val_if_fail (snap && data, false);
+	ut64 i, n = SNAP_PAGES (snap->size);
+	if (prev && (prev->size != snap->size || !prev->pages)) {
+		prev = NULL;
+	}
+	if (!snap->pages) {
+		snap->pages = RZ_NEWS0 (RzDebugSnapPage *, n);
+		if (!snap->pages) {
+			return false;
+		}
 	}
-	memcpy (temp, ctx->digest, RZ_HASH_SIZE_SHA256);
+	for (i = 0; i < n; i++) {
+		const ut8 *src = data + i * RZ_DEBUG_SNAP_PAGE_SIZE;
+		ut32 len = page_len (snap, i);
+		RzDebugSnapPage *page;
+		if (prev && !memcmp (prev->pages[i]->data, src, len)) {
+			page = page_ref (prev->pages[i]);
+		} else {
+			page = page_new ();
+			if (!page) {
+				return false;
+			}
+			memcpy (page->data, src, len);
+		}
+		page_unref (snap->pages[i]);
+		snap->pages[i] = page;
+	}
+	return true;
+}
 
-	rz_hash_do_begin (ctx, algobit);
-	rz_hash_calculate (ctx, algobit, b->data, b->size);
-	rz_hash_do_end (ctx, algobit);
+RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr) {
+	return (snap->addr <= addr && addr >= snap->addr_end);
+}
 
-	ret = memcmp (temp, ctx->digest, RZ_HASH_SIZE_SHA256) == 0;
-	free (temp);
-	rz_hash_free (ctx);
+RZ_API ut8 *rz_debug_snap_get_hash(RzDebugSnap *snap) {
+	ut64 algobit = rz_hash_name_to_bits ("sha256");
+	RzHashStream *stream = rz_hash_stream_new (algobit, 1);
+	if (!stream) {
+		return NULL;
+	}
+	ut64 i;
+	for (i = 0; i < SNAP_PAGES (snap->size); i++) {
+		rz_hash_stream_update (stream, snap->pages[i]->data, page_len (snap, i));
+	}
+	rz_hash_stream_final (stream);
+
+	ut8 *ret = malloc (RZ_HASH_SIZE_SHA256);
+	if (ret) {
+		memcpy (ret, rz_hash_stream_ctx (stream, algobit)->digest, RZ_HASH_SIZE_SHA256);
+	}
+	rz_hash_stream_free (stream);
 	return ret;
 }
+
+RZ_API bool rz_debug_snap_is_equal(RzDebugSnap *a, RzDebugSnap *b) {
+	if (a->size != b->size) {
+		return false;
+	}
+	ut64 i;
+	for (i = 0; i < SNAP_PAGES (a->size); i++) {
+		// shared pages are equal without looking at them
+		if (a->pages[i] != b->pages[i] && memcmp (a->pages[i]->data, b->pages[i]->data, page_len (a, i))) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -749,6 +749,183 @@ err:
 	return NULL;
 }
 
+typedef struct {
+	int name; /* filtered name, index in the pool */
+	int realname; /* index in the pool, -1 to keep the name */
+	bool demangled;
+	ut64 off;
+	ut32 size;
+	RzSpace *space;
+} BatchItem;
+
+typedef struct {
+	RzFlagItem *item;
+	size_t seq; /* keeps the order of flags at the same offset */
+} BatchFresh;
+
+struct rz_flag_batch_t {
+	RzFlag *f;
+	RzStrpool *names;
+	RzVector /*<BatchItem>*/ items;
+};
+
+/* create a batch of flags to be set in f. Names are copied in a single pool
+ * and nothing touches f until rz_flag_batch_commit() */
+RZ_API RzFlagBatch *rz_flag_batch_new(RzFlag *f) {
+	rz_return_val_if_fail (f, NULL);
+	RzFlagBatch *b = RZ_NEW0 (RzFlagBatch);
+	if (!b) {
+		return NULL;
+	}
+	b->names = rz_strpool_new (0);
+	if (!b->names) {
+		free (b);
+		return NULL;
+	}
+	b->f = f;
+	rz_vector_init (&b->items, sizeof (BatchItem), NULL, NULL);
+	return b;
+}
+
+/* free the batch, dropping the flags that were not committed */
+RZ_API void rz_flag_batch_free(RzFlagBatch *b) {
+	if (!b) {
+		return;
+	}
+	rz_strpool_free (b->names);
+	rz_vector_fini (&b->items);
+	free (b);
+}
+
+/* queue a flag in the current flag space, as rz_flag_set() would set it.
+ * If realname is given, it becomes the real name of the item and demangled
+ * tells whether it comes from demangling. */
+RZ_API bool rz_flag_batch_add(RzFlagBatch *b, const char *name, const char *realname, ut64 off, ut32 size, bool demangled) {
+	rz_return_val_if_fail (b && name && *name, false);
+	BatchItem it = {
+		.realname = -1,
+		.demangled = demangled,
+		.off = off,
+		.size = size,
+		.space = rz_flag_space_cur (b->f),
+	};
+	it.name = rz_strpool_append (b->names, name);
+	if (it.name < 0) {
+		return false;
+	}
+	char *fname = rz_strpool_get (b->names, it.name);
+	rz_str_trim (fname);
+	rz_name_filter (fname, 0);
+	if (realname) {
+		it.realname = rz_strpool_append (b->names, realname);
+		if (it.realname < 0) {
+			return false;
+		}
+	}
+	return rz_vector_push (&b->items, &it) != NULL;
+}
+
+static int batch_fresh_cmp(const void *a, const void *b) {
+	const BatchFresh *x = a, *y = b;
+	if (x->item->offset != y->item->offset) {
+		return x->item->offset < y->item->offset? -1: 1;
+	}
+	return x->seq < y->seq? -1: x->seq > y->seq;
+}
+
+/* add the new items to the offset index: sort them once, then merge the
+ * offsets that are not flagged yet in a single pass over the skiplist */
+static bool batch_index(RzFlag *f, RzVector *fresh) {
+	size_t i, n = rz_vector_len (fresh);
+	if (!n) {
+		return true;
+	}
+	BatchFresh *v = rz_vector_index_ptr (fresh, 0);
+	qsort (v, n, sizeof (BatchFresh), batch_fresh_cmp);
+	void **added = RZ_NEWS (void *, n);
+	if (!added) {
+		return false;
+	}
+	bool empty = rz_skiplist_empty (f->by_off);
+	size_t nadded = 0;
+	for (i = 0; i < n;) {
+		ut64 off = v[i].item->offset;
+		RzFlagsAtOffset *flags = empty? NULL: rz_flag_get_nearest_list (f, off, 0);
+		if (!flags) {
+			flags = RZ_NEW (RzFlagsAtOffset);
+			if (!flags) {
+				break;
+			}
+			flags->off = off;
+			flags->flags = rz_list_new ();
+			added[nadded++] = flags;
+		}
+		for (; i < n && v[i].item->offset == off; i++) {
+			rz_list_append (flags->flags, v[i].item);
+		}
+	}
+	bool ok = i == n && rz_skiplist_insert_sorted (f->by_off, added, nadded);
+	free (added);
+	rz_vector_clear (fresh);
+	return ok;
+}
+
+/* set all the flags of the batch, with the same result as calling
+ * rz_flag_set() (and rz_flag_item_set_realname()) for each of them in order,
+ * and empty the batch. Returns the number of flags that were set. */
+RZ_API size_t rz_flag_batch_commit(RzFlagBatch *b) {
+	rz_return_val_if_fail (b, 0);
+	RzFlag *f = b->f;
+	RzVector fresh;
+	rz_vector_init (&fresh, sizeof (BatchFresh), NULL, NULL);
+	rz_vector_reserve (&fresh, rz_vector_len (&b->items));
+	size_t seq = 0, count = 0;
+	BatchItem *it;
+	rz_vector_foreach (&b->items, it) {
+		const char *name = rz_strpool_get (b->names, it->name);
+		RzFlagItem *item = rz_flag_get (f, name);
+		if (!item) {
+			item = RZ_NEW0 (RzFlagItem);
+			if (!item) {
+				continue;
+			}
+			item->name = strdup (name);
+			item->realname = item->name;
+			item->space = it->space;
+			item->size = it->size;
+			item->offset = it->off + f->base;
+			if (!item->name || !ht_pp_insert (f->ht_name, item->name, item)) {
+				rz_flag_item_free (item);
+				continue;
+			}
+			BatchFresh *nf = rz_vector_push (&fresh, NULL);
+			if (nf) {
+				nf->item = item;
+				nf->seq = seq++;
+			}
+		} else if (item->offset == it->off) {
+			item->size = it->size;
+		} else {
+			// moving a flag: index the new ones first to keep the list order
+			batch_index (f, &fresh);
+			item->space = it->space;
+			item->size = it->size;
+			update_flag_item_offset (f, item, it->off + f->base, false, true);
+			update_flag_item_name (f, item, name, true);
+		}
+		if (it->realname >= 0) {
+			rz_flag_item_set_realname (item, rz_strpool_get (b->names, it->realname));
+			item->demangled = it->demangled;
+		}
+		count++;
+	}
+	batch_index (f, &fresh);
+	rz_vector_fini (&fresh);
+	rz_vector_clear (&b->items);
+	rz_strpool_empty (b->names);
+	return count;
+}
+
 /* add/replace/remove the alias of a flag item */
 RZ_API void rz_flag_item_set_alias(RzFlagItem *item, const char *alias) {
 	rz_return_if_fail (item);
@@ -3,6 +3,7 @@
 //some definitions and test cases borrowed from http://www.nightmare.com/~ryb/code/CrcMoose.py (Ray Burr)
 
 #include <rz_hash.h>
+#include "crca.h"
 
 void crc_init (RZ_CRC_CTX *ctx, utcrc crc, ut32 size, int reflect, utcrc poly, utcrc xout) {
 	ctx->crc = crc;
@@ -12,7 +13,43 @@ void crc_init (RZ_CRC_CTX *ctx, utcrc crc, ut32 size, int reflect, utcrc poly, u
 	ctx->xout = xout;
 }
 
-void crc_update (RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz) {
+/* below this size building a lookup table costs more than it saves */
+#define CRC_TABLE_MIN 256
+
+static utcrc crc_reflect(utcrc v, ut32 size) {
+	utcrc r = 0;
+	ut32 i;
+	for (i = 0; i < size; i++) {
+		r = (r << 1) | (v & 1);
+		v >>= 1;
+	}
+	return r;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32C_HW 1
+#define CRC32C_POLY 0x1EDC6F41
+
+/* SSE4.2 computes CRC-32C in the reflected domain, without the xors */
+__attribute__((target ("sse4.2")))
+static ut32 crc32c_hw(ut32 crc, const ut8 *data, ut32 sz) {
+#if defined(__x86_64__)
+	ut64 c = crc;
+	for (; sz >= 8; sz -= 8, data += 8) {
+		ut64 v;
+		memcpy (&v, data, sizeof (v));
+		c = __builtin_ia32_crc32di (c, v);
+	}
+	crc = (ut32)c;
+#endif
+	for (; sz > 0; sz--) {
+		crc = __builtin_ia32_crc32qi (crc, *data++);
+	}
+	return crc;
+}
+#endif
+
+static void crc_update_bitwise(RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz) {
 	utcrc crc, d;
 	int i, j;
 
@@ -34,7 +71,59 @@ void crc_update (RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz) {
 	ctx->crc = crc;
 }
 
-static void crc_final (RZ_CRC_CTX *ctx, utcrc *r) {
+/* Byte at a time with a table. Reflected CRCs run in the reflected domain,
+ * so the input bytes need no reversal and only the state is flipped. */
+static void crc_update_table(RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz) {
+	utcrc table[256];
+	utcrc mask = (((UTCRC_C(1) << (ctx->size - 1)) - 1) << 1) | 1;
+	utcrc crc = ctx->crc & mask;
+	ut32 i, j;
+
+	if (ctx->reflect) {
+		crc = crc_reflect (crc, ctx->size);
+#if CRC32C_HW
+		if (ctx->size == 32 && (ctx->poly & mask) == CRC32C_POLY && __builtin_cpu_supports ("sse4.2")) {
+			ctx->crc = crc_reflect (crc32c_hw ((ut32)crc, data, sz), 32);
+			return;
+		}
+#endif
+		utcrc rpoly = crc_reflect (ctx->poly, ctx->size);
+		for (i = 0; i < 256; i++) {
+			utcrc t = i;
+			for (j = 0; j < 8; j++) {
+				t = (t & 1)? (t >> 1) ^ rpoly: t >> 1;
+			}
+			table[i] = t;
+		}
+		for (i = 0; i < sz; i++) {
+			crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		}
+		ctx->crc = crc_reflect (crc, ctx->size);
+		return;
+	}
+	ut32 shift = ctx->size - 8;
+	for (i = 0; i < 256; i++) {
+		utcrc t = (utcrc)i << shift;
+		for (j = 0; j < 8; j++) {
+			t = ((t >> (ctx->size - 1)) & 1? ctx->poly: 0) ^ (t << 1);
+		}
+		table[i] = t & mask;
+	}
+	for (i = 0; i < sz; i++) {
+		crc = (table[((crc >> shift) ^ data[i]) & 0xff] ^ (crc << 8)) & mask;
+	}
+	ctx->crc = crc;
+}
+
+void crc_update (RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz) {
+	if (ctx->size >= 8 && sz >= CRC_TABLE_MIN) {
+		crc_update_table (ctx, data, sz);
+	} else {
+		crc_update_bitwise (ctx, data, sz);
+	}
+}
+
+void crc_final (RZ_CRC_CTX *ctx, utcrc *r) {
 	utcrc crc;
 	int i;
 
@@ -0,0 +1,10 @@
+#ifndef RZ_CRCA_H
+#define RZ_CRCA_H
+
+#include <rz_hash.h>
+
+void crc_init_preset(RZ_CRC_CTX *ctx, enum CRC_PRESETS preset);
+void crc_update(RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz);
+void crc_final(RZ_CRC_CTX *ctx, utcrc *r);
+
+#endif
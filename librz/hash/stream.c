@@ -0,0 +1,409 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <math.h>
+#include <rz_hash.h>
+#include <rz_th.h>
+#include <rz_util.h>
+#include "crca.h"
+
+/* An RzHashStream feeds every block it is given to all the requested
+ * algorithms at once. Each algorithm owns its RzHash, since the do_*
+ * functions all write to ctx->digest, and with more than one thread each
+ * one runs as a separate job, while the caller goes on reading the next
+ * block. */
+
+#define STREAM_DIGESTS (RZ_HASH_MD5 | RZ_HASH_SHA1 | RZ_HASH_SHA256 | RZ_HASH_SHA384 | RZ_HASH_SHA512)
+
+/* blocks computed per call of the rz_hash_calculate_blocks() callbacks */
+#define BLOCKS_BATCH 256
+
+static const struct {
+	ut64 bit;
+	enum CRC_PRESETS preset;
+} crc_algos[] = {
+	{ RZ_HASH_CRC8_SMBUS, CRC_PRESET_8_SMBUS },
+#if RZ_HAVE_CRC8_EXTRA
+	{ RZ_HASH_CRC8_CDMA2000, CRC_PRESET_CRC8_CDMA2000 },
+	{ RZ_HASH_CRC8_DARC, CRC_PRESET_CRC8_DARC },
+	{ RZ_HASH_CRC8_DVB_S2, CRC_PRESET_CRC8_DVB_S2 },
+	{ RZ_HASH_CRC8_EBU, CRC_PRESET_CRC8_EBU },
+	{ RZ_HASH_CRC8_ICODE, CRC_PRESET_CRC8_ICODE },
+	{ RZ_HASH_CRC8_ITU, CRC_PRESET_CRC8_ITU },
+	{ RZ_HASH_CRC8_MAXIM, CRC_PRESET_CRC8_MAXIM },
+	{ RZ_HASH_CRC8_ROHC, CRC_PRESET_CRC8_ROHC },
+	{ RZ_HASH_CRC8_WCDMA, CRC_PRESET_CRC8_WCDMA },
+#endif /* #if RZ_HAVE_CRC8_EXTRA */
+#if RZ_HAVE_CRC15_EXTRA
+	{ RZ_HASH_CRC15_CAN, CRC_PRESET_15_CAN },
+#endif /* #if RZ_HAVE_CRC15_EXTRA */
+	{ RZ_HASH_CRC16, CRC_PRESET_16 },
+	{ RZ_HASH_CRC16_HDLC, CRC_PRESET_16_HDLC },
+	{ RZ_HASH_CRC16_USB, CRC_PRESET_16_USB },
+	{ RZ_HASH_CRC16_CITT, CRC_PRESET_16_CITT },
+#if RZ_HAVE_CRC16_EXTRA
+	{ RZ_HASH_CRC16_AUG_CCITT, CRC_PRESET_CRC16_AUG_CCITT },
+	{ RZ_HASH_CRC16_BUYPASS, CRC_PRESET_CRC16_BUYPASS },
+	{ RZ_HASH_CRC16_CDMA2000, CRC_PRESET_CRC16_CDMA2000 },
+	{ RZ_HASH_CRC16_DDS110, CRC_PRESET_CRC16_DDS110 },
+	{ RZ_HASH_CRC16_DECT_R, CRC_PRESET_CRC16_DECT_R },
+	{ RZ_HASH_CRC16_DECT_X, CRC_PRESET_CRC16_DECT_X },
+	{ RZ_HASH_CRC16_DNP, CRC_PRESET_CRC16_DNP },
+	{ RZ_HASH_CRC16_EN13757, CRC_PRESET_CRC16_EN13757 },
+	{ RZ_HASH_CRC16_GENIBUS, CRC_PRESET_CRC16_GENIBUS },
+	{ RZ_HASH_CRC16_MAXIM, CRC_PRESET_CRC16_MAXIM },
+	{ RZ_HASH_CRC16_MCRF4XX, CRC_PRESET_CRC16_MCRF4XX },
+	{ RZ_HASH_CRC16_RIELLO, CRC_PRESET_CRC16_RIELLO },
+	{ RZ_HASH_CRC16_T10_DIF, CRC_PRESET_CRC16_T10_DIF },
+	{ RZ_HASH_CRC16_TELEDISK, CRC_PRESET_CRC16_TELEDISK },
+	{ RZ_HASH_CRC16_TMS37157, CRC_PRESET_CRC16_TMS37157 },
+	{ RZ_HASH_CRCA, CRC_PRESET_CRCA },
+	{ RZ_HASH_CRC16_KERMIT, CRC_PRESET_CRC16_KERMIT },
+	{ RZ_HASH_CRC16_MODBUS, CRC_PRESET_CRC16_MODBUS },
+	{ RZ_HASH_CRC16_X25, CRC_PRESET_CRC16_X25 },
+	{ RZ_HASH_CRC16_XMODEM, CRC_PRESET_CRC16_XMODEM },
+#endif /* #if RZ_HAVE_CRC16_EXTRA */
+#if RZ_HAVE_CRC24
+	{ RZ_HASH_CRC24, CRC_PRESET_24 },
+#endif /* #if RZ_HAVE_CRC24 */
+	{ RZ_HASH_CRC32, CRC_PRESET_32 },
+	{ RZ_HASH_CRC32C, CRC_PRESET_32C },
+	{ RZ_HASH_CRC32_ECMA_267, CRC_PRESET_32_ECMA_267 },
+#if RZ_HAVE_CRC32_EXTRA
+	{ RZ_HASH_CRC32_BZIP2, CRC_PRESET_CRC32_BZIP2 },
+	{ RZ_HASH_CRC32D, CRC_PRESET_CRC32D },
+	{ RZ_HASH_CRC32_MPEG2, CRC_PRESET_CRC32_MPEG2 },
+	{ RZ_HASH_CRC32_POSIX, CRC_PRESET_CRC32_POSIX },
+	{ RZ_HASH_CRC32Q, CRC_PRESET_CRC32Q },
+	{ RZ_HASH_CRC32_JAMCRC, CRC_PRESET_CRC32_JAMCRC },
+	{ RZ_HASH_CRC32_XFER, CRC_PRESET_CRC32_XFER },
+#endif /* #if RZ_HAVE_CRC32_EXTRA */
+#if RZ_HAVE_CRC64
+	{ RZ_HASH_CRC64, CRC_PRESET_CRC64 },
+#endif /* #if RZ_HAVE_CRC64 */
+#if RZ_HAVE_CRC64_EXTRA
+	{ RZ_HASH_CRC64_ECMA182, CRC_PRESET_CRC64_ECMA182 },
+	{ RZ_HASH_CRC64_WE, CRC_PRESET_CRC64_WE },
+	{ RZ_HASH_CRC64_XZ, CRC_PRESET_CRC64_XZ },
+	{ RZ_HASH_CRC64_ISO, CRC_PRESET_CRC64_ISO },
+#endif /* #if RZ_HAVE_CRC64_EXTRA */
+};
+
+typedef enum {
+	STREAM_DIGEST,
+	STREAM_CRC,
+	STREAM_ENTROPY
+} StreamKind;
+
+typedef struct {
+	ut64 bit;
+	StreamKind kind;
+	RzHash *ctx;
+	RZ_CRC_CTX crc;
+	ut64 count[256];
+	// pending block
+	const ut8 *buf;
+	ut64 len;
+} StreamAlgo;
+
+struct rz_hash_stream_t {
+	StreamAlgo *algos;
+	size_t n;
+	RzThreadPool *pool;
+	ut64 size;
+	bool done;
+};
+
+static int crc_preset_of(ut64 bit) {
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE (crc_algos); i++) {
+		if (crc_algos[i].bit == bit) {
+			return crc_algos[i].preset;
+		}
+	}
+	return -1;
+}
+
+static int threads_for(int threads, size_t jobs) {
+	if (threads <= 0) {
+		threads = rz_th_ncores ();
+	}
+	return RZ_MAX (1, RZ_MIN (threads, (int)RZ_MIN (jobs, INT_MAX)));
+}
+
+/**
+ * \brief Tell whether \p algobit can be computed incrementally by RzHashStream
+ */
+RZ_API bool rz_hash_stream_supported(ut64 algobit) {
+	if (!algobit || (algobit & (algobit - 1))) {
+		return false;
+	}
+	return (algobit & STREAM_DIGESTS) || algobit == RZ_HASH_ENTROPY || crc_preset_of (algobit) >= 0;
+}
+
+/**
+ * \brief Create a stream computing all the algorithms in \p algobits
+ *
+ * Algorithms that rz_hash_stream_supported() rejects are ignored.
+ * \param threads number of threads to hash with, 0 means one per core
+ */
+RZ_API RzHashStream *rz_hash_stream_new(ut64 algobits, int threads) {
+	RzHashStream *s = RZ_NEW0 (RzHashStream);
+	if (!s) {
+		return NULL;
+	}
+	s->algos = RZ_NEWS0 (StreamAlgo, RZ_HASH_NBITS);
+	if (!s->algos) {
+		free (s);
+		return NULL;
+	}
+	ut64 bit;
+	for (bit = 1; bit && bit <= algobits; bit <<= 1) {
+		if (!(algobits & bit) || !rz_hash_stream_supported (bit)) {
+			continue;
+		}
+		StreamAlgo *a = &s->algos[s->n++];
+		a->bit = bit;
+		a->ctx = rz_hash_new (false, bit);
+		if (!a->ctx) {
+			rz_hash_stream_free (s);
+			return NULL;
+		}
+		if (bit & STREAM_DIGESTS) {
+			a->kind = STREAM_DIGEST;
+		} else if (bit == RZ_HASH_ENTROPY) {
+			a->kind = STREAM_ENTROPY;
+		} else {
+			a->kind = STREAM_CRC;
+			crc_init_preset (&a->crc, crc_preset_of (bit));
+		}
+	}
+	threads = threads_for (threads, s->n);
+	if (threads > 1) {
+		// without a pool the blocks are simply hashed by the caller
+		s->pool = rz_th_pool_new (threads);
+	}
+	return s;
+}
+
+RZ_API void rz_hash_stream_free(RzHashStream *s) {
+	if (!s) {
+		return;
+	}
+	rz_th_pool_free (s->pool);
+	size_t i;
+	for (i = 0; i < s->n; i++) {
+		rz_hash_free (s->algos[i].ctx);
+	}
+	free (s->algos);
+	free (s);
+}
+
+static void algo_update(void *user) {
+	StreamAlgo *a = user;
+	const ut8 *buf = a->buf;
+	ut64 len = a->len;
+	ut64 i;
+	switch (a->kind) {
+	case STREAM_DIGEST:
+		while (len > 0) {
+			// a zero length update finalizes the sha contexts
+			int n = (int)RZ_MIN (len, INT_MAX);
+			rz_hash_calculate (a->ctx, a->bit, buf, n);
+			buf += n;
+			len -= n;
+		}
+		break;
+	case STREAM_CRC:
+		while (len > 0) {
+			ut32 n = (ut32)RZ_MIN (len, UT32_MAX);
+			crc_update (&a->crc, buf, n);
+			buf += n;
+			len -= n;
+		}
+		break;
+	case STREAM_ENTROPY:
+		for (i = 0; i < len; i++) {
+			a->count[buf[i]]++;
+		}
+		break;
+	}
+}
+
+/**
+ * \brief Hash the next \p len bytes of the stream
+ *
+ * When the stream runs on several threads this returns before the block
+ * is hashed, so that the caller can fetch the next one meanwhile: \p buf
+ * must stay untouched until the next rz_hash_stream_update() or
+ * rz_hash_stream_final() call. Alternating two buffers is enough.
+ */
+RZ_API bool rz_hash_stream_update(RzHashStream *s, const ut8 *buf, ut64 len) {
+	rz_return_val_if_fail (s && (buf || !len) && !s->done, false);
+	if (s->pool) {
+		rz_th_pool_wait (s->pool);
+	}
+	if (!len) {
+		return true;
+	}
+	s->size += len;
+	size_t i;
+	for (i = 0; i < s->n; i++) {
+		StreamAlgo *a = &s->algos[i];
+		a->buf = buf;
+		a->len = len;
+		if (!s->pool || !rz_th_pool_add_job (s->pool, algo_update, a)) {
+			algo_update (a);
+		}
+	}
+	return true;
+}
+
+static void algo_final(StreamAlgo *a, ut64 size) {
+	RzHash *ctx = a->ctx;
+	int i, dlen;
+	switch (a->kind) {
+	case STREAM_DIGEST:
+		rz_hash_do_end (ctx, a->bit);
+		break;
+	case STREAM_CRC: {
+		utcrc r;
+		crc_final (&a->crc, &r);
+		// big endian, as rz_hash_calculate() does
+		dlen = rz_hash_size (a->bit);
+		for (i = 0; i < dlen; i++) {
+			ctx->digest[i] = (ut8)(r >> (8 * (dlen - 1 - i)));
+		}
+		break;
+	}
+	case STREAM_ENTROPY:
+		rz_mem_memzero (ctx->digest, sizeof (ctx->entropy));
+		ctx->entropy = 0;
+		for (i = 0; i < 256; i++) {
+			if (a->count[i]) {
+				double p = (double)a->count[i] / size;
+				ctx->entropy -= p * log2 (p);
+			}
+		}
+		break;
+	}
+}
+
+/**
+ * \brief Wait for the pending blocks and compute the final digests
+ */
+RZ_API void rz_hash_stream_final(RzHashStream *s) {
+	rz_return_if_fail (s);
+	if (s->done) {
+		return;
+	}
+	if (s->pool) {
+		rz_th_pool_wait (s->pool);
+	}
+	size_t i;
+	for (i = 0; i < s->n; i++) {
+		algo_final (&s->algos[i], s->size);
+	}
+	s->done = true;
+}
+
+/**
+ * \brief Get the context holding the result of \p algobit
+ *
+ * Its digest (or entropy) is only meaningful after rz_hash_stream_final().
+ * \return NULL if the stream does not compute \p algobit
+ */
+RZ_API RzHash *rz_hash_stream_ctx(RzHashStream *s, ut64 algobit) {
+	rz_return_val_if_fail (s, NULL);
+	size_t i;
+	for (i = 0; i < s->n; i++) {
+		if (s->algos[i].bit == algobit) {
+			return s->algos[i].ctx;
+		}
+	}
+	return NULL;
+}
+
+typedef struct {
+	ut64 algobit;
+	const ut8 *buf;
+	ut64 len;
+	ut64 bsize;
+	RzHash **ctxs;
+	int *dlens;
+	ut64 first; // index of the first block of the batch
+	ut64 from; // blocks [from, to) of the batch
+	ut64 to;
+} BlocksJob;
+
+static void blocks_job(void *user) {
+	BlocksJob *job = user;
+	ut64 i;
+	for (i = job->from; i < job->to; i++) {
+		ut64 off = (job->first + i) * job->bsize;
+		ut64 n = RZ_MIN (job->bsize, job->len - off);
+		job->dlens[i] = rz_hash_calculate (job->ctxs[i], job->algobit, job->buf + off, (int)n);
+	}
+}
+
+/**
+ * \brief Compute \p algobit over every \p bsize bytes block of \p buf
+ *
+ * The last block may be shorter. The blocks are hashed in batches spread
+ * over \p threads threads (0 means one per core), then \p cb is called for
+ * each of them in order, from the calling thread, with the context holding
+ * its digest or entropy. Returning false from \p cb stops the iteration.
+ */
+RZ_API bool rz_hash_calculate_blocks(ut64 algobit, const ut8 *buf, ut64 len, ut64 bsize, int threads, RzHashBlockCb cb, void *user) {
+	rz_return_val_if_fail (buf && bsize > 0 && bsize <= INT_MAX && cb, false);
+	ut64 nblocks = len / bsize + (len % bsize? 1: 0);
+	int nthreads = threads_for (threads, RZ_MIN (nblocks, BLOCKS_BATCH));
+	RzHash *ctxs[BLOCKS_BATCH] = { 0 };
+	int dlens[BLOCKS_BATCH];
+	RzThreadPool *pool = nthreads > 1? rz_th_pool_new (nthreads): NULL;
+	if (!pool) {
+		nthreads = 1;
+	}
+	BlocksJob *jobs = RZ_NEWS0 (BlocksJob, nthreads);
+	bool ret = jobs;
+	ut64 first, i;
+	int t;
+	for (i = 0; ret && i < RZ_MIN (nblocks, BLOCKS_BATCH); i++) {
+		ctxs[i] = rz_hash_new (true, algobit);
+		ret = ctxs[i];
+	}
+	for (first = 0; ret && first < nblocks; first += BLOCKS_BATCH) {
+		ut64 n = RZ_MIN (BLOCKS_BATCH, nblocks - first);
+		for (t = 0; t < nthreads; t++) {
+			BlocksJob *job = &jobs[t];
+			job->algobit = algobit;
+			job->buf = buf;
+			job->len = len;
+			job->bsize = bsize;
+			job->ctxs = ctxs;
+			job->dlens = dlens;
+			job->first = first;
+			job->from = n * t / nthreads;
+			job->to = n * (t + 1) / nthreads;
+			if (!pool || !rz_th_pool_add_job (pool, blocks_job, job)) {
+				blocks_job (job);
+			}
+		}
+		if (pool) {
+			rz_th_pool_wait (pool);
+		}
+		for (i = 0; i < n; i++) {
+			if (!cb (user, first + i, ctxs[i], dlens[i])) {
+				break;
+			}
+		}
+		if (i < n) {
+			break;
+		}
+	}
+	rz_th_pool_free (pool);
+	for (i = 0; i < BLOCKS_BATCH; i++) {
+		rz_hash_free (ctxs[i]);
+	}
+	free (jobs);
+	return ret;
+}
@@ -86,7 +86,8 @@ typedef struct rz_ascii_graph_t {
 	RzList *long_edges;
 	struct layer_t *layers;
 	int n_layers;
-	RzList *dists; /* RzList<struct dist_t> */
+	int *dists; /* distance to the next node in the layer, by node index */
+	struct layout_cache_t *layout_cache;
 	RzList *edges; /* RzList<AEdge> */
 	RzAGraphHits ghits;
 } RzAGraph;
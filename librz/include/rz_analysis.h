@@ -29,7 +29,7 @@ RZ_LIB_VERSION_HEADER(rz_analysis);
 
 /* dwarf processing context */
 typedef struct rz_analysis_dwarf_context {
-	const RzBinDwarfDebugInfo *info;
+	RzBinDwarfDebugInfo *info;
 	HtUP/*<offset, RzBinDwarfLocList*>*/  *loc;
 	// const RzBinDwarfCfa *cfa; TODO
 } RzAnalysisDwarfContext;
@@ -571,6 +571,7 @@ typedef struct rz_analysis_callbacks_t {
 } RzAnalysisCallbacks;
 
 #define RZ_ANALYSIS_ESIL_GOTO_LIMIT 4096
+#define RZ_ANALYSIS_ESIL_COMPILED_MAX 0x10000
 
 typedef struct rz_analysis_options_t {
 	int depth;
@@ -610,11 +611,48 @@ typedef enum {
 	RZ_ANALYSIS_CPP_ABI_MSVC
 } RzAnalysisCPPABI;
 
+#define RZ_ANALYSIS_OP_CACHE_BYTES 32
+
+typedef struct rz_analysis_op_cache_t {
+	HtUP *ht; // addr => RzAnalysisOpCacheItem
+	struct rz_analysis_op_cache_item_t *head; // most recently used
+	struct rz_analysis_op_cache_item_t *tail;
+	ut32 count;
+	ut32 capacity; // analysis.opcache, 0 disables the cache
+	ut64 hits;
+	ut64 misses;
+	RzReg *reg; // register profile the cached operand values point into
+	ut32 profile_gen;
+	ut32 hints_gen; // analysis hints the cached instructions were decoded with
+	char *cpu; // cpu the cached instructions were decoded for
+	bool big_endian;
+} RzAnalysisOpCache;
+
+// filled by rz_analysis_diff_fcn(), times are in microseconds
+typedef struct rz_analysis_diff_stats_t {
+	ut32 fcns;
+	ut32 fcns2;
+	ut32 by_name;
+	ut32 by_hash; // identical fingerprints
+	ut32 by_callgraph; // callees of matched functions
+	ut32 by_similarity;
+	ut32 distances; // fingerprint distances computed
+	double similarity; // mean over the matched functions
+	ut64 fingerprint_time; // set by rz_core_gdiff()
+	ut64 index_time;
+	ut64 match_time;
+} RzAnalysisDiffStats;
+
 typedef struct rz_analysis_hint_cb_t {
 	//add more cbs as needed
 	void (*on_bits) (struct rz_analysis_t *a, ut64 addr, int bits, bool set);
 } RHintCb;
 
+// sorted set of references, see xrefs.c
+typedef struct rz_analysis_xref_set_t RzAnalysisXrefSet;
+// compiled zignatures, see sign.c
+typedef struct rz_sign_index_t RzSignIndex;
+
 typedef struct rz_analysis_t {
 	char *cpu;      // analysis.cpu
 	char *os;       // asm.os
@@ -635,6 +673,8 @@ typedef struct rz_analysis_t {
 	int diff_ops;
 	double diff_thbb;
 	double diff_thfcn;
+	int diff_threads; // diff.threads, 0 = one per core
+	RzAnalysisDiffStats diff_stats;
 	RzIOBind iob;
 	RzFlagBind flb;
 	RzFlagSet flg_class_set;
@@ -652,8 +692,9 @@ typedef struct rz_analysis_t {
 	Sdb *sdb_types;
 	Sdb *sdb_fmts;
 	Sdb *sdb_zigns;
-	HtUP *dict_refs;
-	HtUP *dict_xrefs;
+	RzSignIndex *zign_index; // compiled sdb_zigns, see rz_sign_index_get()
+	RzAnalysisXrefSet *ref_set; // (from, to) -> type
+	RzAnalysisXrefSet *xref_set; // (to, from) -> type
 	bool recursive_noreturn; // analysis.rnr
 	RzSpaces zign_spaces;
 	char *zign_path; // dir.zigns
@@ -664,6 +705,7 @@ typedef struct rz_analysis_t {
 	HtUP/*<RzVector<RzAnalysisAddrHintRecord>>*/ *addr_hints; // all hints that correspond to a single address
 	RBTree/*<RzAnalysisArchHintRecord>*/ arch_hints;
 	RBTree/*<RzAnalysisArchBitsRecord>*/ bits_hints;
+	ut32 hints_gen; // bumped every time a hint is set or removed
 	RHintCb hint_cbs;
 	RzIntervalTree meta;
 	RzSpaces meta_spaces;
@@ -686,6 +728,7 @@ typedef struct rz_analysis_t {
 	SetU *visited;
 	RzStrConstPool constpool;
 	RzList *leaddrs;
+	RzAnalysisOpCache opcache;
 } RzAnalysis;
 
 typedef enum rz_analysis_addr_hint_type_t {
@@ -1120,16 +1163,11 @@ typedef struct rz_analysis_esil_change_reg_t {
 	ut64 data;
 } RzAnalysisEsilRegChange;
 
-typedef struct rz_analysis_esil_change_mem_t {
-	int idx;
-	ut8 data;
-} RzAnalysisEsilMemChange;
-
 typedef struct rz_analysis_esil_trace_t {
 	int idx;
 	int end_idx;
 	HtUP *registers;
-	HtUP *memory;
+	RzMemJournal *memory; // writes tagged with the idx they lead to
 	RzRegArena *arena[RZ_REG_TYPE_LAST];
 	ut64 stack_addr;
 	ut64 stack_size;
@@ -1158,6 +1196,7 @@ typedef struct rz_analysis_esil_callbacks_t {
 typedef struct rz_analysis_esil_t {
 	RzAnalysis *analysis;
 	char **stack;
+	struct rz_analysis_esil_value_t *values; // typed entries of the stack, see esil.c
 	ut64 addrmask;
 	int stacksize;
 	int stackptr;
@@ -1185,6 +1224,8 @@ typedef struct rz_analysis_esil_t {
 	ut8 lastsz;	//in bits //used for signature-flag
 	/* native ops and custom ops */
 	HtPP *ops;
+	HtUP *compiled; // address -> compiled expression
+	struct rz_analysis_esil_program_t *program; // compiled expression being run
 	char *current_opstr;
 	RzIDStorage *sources;
 	SdbMini *interrupts;
@@ -1569,6 +1610,13 @@ RZ_API int rz_analysis_op_reg_delta(RzAnalysis *analysis, ut64 addr, const char
 RZ_API bool rz_analysis_op_is_eob(RzAnalysisOp *op);
 RZ_API RzList *rz_analysis_op_list_new(void);
 RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+RZ_API void rz_analysis_op_cache_init(RzAnalysisOpCache *cache);
+RZ_API void rz_analysis_op_cache_fini(RzAnalysisOpCache *cache);
+RZ_API void rz_analysis_op_cache_flush(RzAnalysisOpCache *cache);
+RZ_API void rz_analysis_op_cache_set_capacity(RzAnalysisOpCache *cache, ut32 capacity);
+RZ_API void rz_analysis_op_cache_invalidate(RzAnalysisOpCache *cache, ut64 addr, ut64 len);
+RZ_API bool rz_analysis_op_cache_get(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask, int *ret);
+RZ_API void rz_analysis_op_cache_put(RzAnalysis *analysis, const RzAnalysisOp *op, const ut8 *data, int len, RzAnalysisOpMask mask, int ret);
 RZ_API RzAnalysisOp *rz_analysis_op_hexstr(RzAnalysis *analysis, ut64 addr, const char *hexstr);
 RZ_API char *rz_analysis_op_to_string(RzAnalysis *analysis, RzAnalysisOp *op);
 
@@ -1578,6 +1626,7 @@ RZ_API bool rz_analysis_esil_setup(RzAnalysisEsil *esil, RzAnalysis *analysis, i
 RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil);
 RZ_API bool rz_analysis_esil_runword(RzAnalysisEsil *esil, const char *word);
 RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str);
+RZ_API void rz_analysis_esil_compiled_flush(RzAnalysisEsil *esil);
 RZ_API bool rz_analysis_esil_dumpstack(RzAnalysisEsil *esil);
 RZ_API int rz_analysis_esil_mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int len);
 RZ_API int rz_analysis_esil_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf, int len);
@@ -1638,7 +1687,7 @@ RZ_API bool rz_analysis_fcn_add_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn
 		ut64 addr, ut64 size,
 		ut64 jump, ut64 fail, RZ_BORROW RzAnalysisDiff *diff);
 RZ_API bool rz_analysis_check_fcn(RzAnalysis *analysis, ut8 *buf, ut16 bufsz, ut64 addr, ut64 low, ut64 high);
-RZ_API void rz_analysis_fcn_invalidate_read_ahead_cache(void);
+RZ_API RZ_DEPRECATE void rz_analysis_fcn_invalidate_read_ahead_cache(RzAnalysis *analysis);
 
 RZ_API void rz_analysis_function_check_bp_use(RzAnalysisFunction *fcn);
 RZ_API void rz_analysis_update_analysis_range(RzAnalysis *analysis, ut64 addr, int size);
@@ -1670,6 +1719,7 @@ RZ_API int rz_analysis_function_resize(RzAnalysisFunction *fcn, int newsize);
 RZ_API bool rz_analysis_function_purity(RzAnalysisFunction *fcn);
 
 typedef bool (* RzAnalysisRefCmp)(RzAnalysisRef *ref, void *data);
+typedef bool (* RzAnalysisRefForeachCb)(void *user, const RzAnalysisRef *ref);
 RZ_API RzList *rz_analysis_ref_list_new(void);
 RZ_API ut64 rz_analysis_xrefs_count(RzAnalysis *analysis);
 RZ_API const char *rz_analysis_xrefs_type_tostring(RzAnalysisRefType type);
@@ -1684,6 +1734,11 @@ RZ_API int rz_analysis_xrefs_from(RzAnalysis *analysis, RzList *list, const char
 RZ_API int rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, const RzAnalysisRefType type);
 RZ_API int rz_analysis_xrefs_deln(RzAnalysis *analysis, ut64 from, ut64 to, const RzAnalysisRefType type);
 RZ_API int rz_analysis_xref_del(RzAnalysis *analysis, ut64 at, ut64 addr);
+RZ_API bool rz_analysis_refs_foreach(RzAnalysis *analysis, ut64 from, RzAnalysisRefForeachCb cb, void *user);
+RZ_API bool rz_analysis_xrefs_foreach(RzAnalysis *analysis, ut64 to, RzAnalysisRefForeachCb cb, void *user);
+RZ_API bool rz_analysis_refs_foreach_in(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisRefForeachCb cb, void *user);
+RZ_API bool rz_analysis_xrefs_foreach_in(RzAnalysis *analysis, ut64 from, ut64 to, RzAnalysisRefForeachCb cb, void *user);
+RZ_API void rz_analysis_xrefs_rebase(RzAnalysis *analysis, ut64 diff);
 
 RZ_API RzList *rz_analysis_get_fcns(RzAnalysis *analysis);
 
@@ -1745,6 +1800,7 @@ RZ_API char *rz_analysis_fcn_format_sig(RZ_NONNULL RzAnalysis *analysis, RZ_NONN
 
 /* project */
 RZ_API bool rz_analysis_xrefs_init (RzAnalysis *analysis);
+RZ_API void rz_analysis_xrefs_fini(RzAnalysis *analysis);
 
 #define RZ_ANALYSIS_THRESHOLDFCN 0.7F
 #define RZ_ANALYSIS_THRESHOLDBB 0.7F
@@ -2001,6 +2057,7 @@ RZ_API bool rz_analysis_noreturn_at_addr(RzAnalysis *analysis, ut64 addr);
 RZ_API int rz_sign_space_count_for(RzAnalysis *a, const RzSpace *space);
 RZ_API void rz_sign_space_unset_for(RzAnalysis *a, const RzSpace *space);
 RZ_API void rz_sign_space_rename_for(RzAnalysis *a, const RzSpace *space, const char *oname, const char *nname);
+RZ_API void rz_sign_index_invalidate(RzAnalysis *a);
 
 /* vtables */
 typedef struct {
@@ -2153,6 +2210,8 @@ RZ_API void rz_serialize_analysis_blocks_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzA
  * All loaded blocks will have a ref of 1 after this function and should be unrefd once after loading functions.
  */
 RZ_API bool rz_serialize_analysis_blocks_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res);
+RZ_API bool rz_serialize_analysis_blocks_save_records(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzSerializeRecordCb cb, void *user);
+RZ_API bool rz_serialize_analysis_blocks_load_records(RZ_NONNULL RzSerializeNsSource *src, RZ_NONNULL const char *path, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 
 typedef void *RzSerializeAnalVarParser;
 RZ_API RzSerializeAnalVarParser rz_serialize_analysis_var_parser_new(void);
@@ -2161,6 +2220,8 @@ RZ_API RZ_NULLABLE RzAnalysisVar *rz_serialize_analysis_var_load(RZ_NONNULL RzAn
 
 RZ_API void rz_serialize_analysis_functions_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
 RZ_API bool rz_serialize_analysis_functions_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RzSerializeAnalDiffParser diff_parser, RZ_NULLABLE RzSerializeResultInfo *res);
+RZ_API bool rz_serialize_analysis_functions_save_records(RZ_NONNULL RzAnalysis *analysis, RZ_NONNULL RzSerializeRecordCb cb, void *user);
+RZ_API bool rz_serialize_analysis_functions_load_records(RZ_NONNULL RzSerializeNsSource *src, RZ_NONNULL const char *path, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 RZ_API void rz_serialize_analysis_xrefs_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
 RZ_API bool rz_serialize_analysis_xrefs_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 RZ_API void rz_serialize_analysis_meta_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
@@ -2182,6 +2243,7 @@ RZ_API bool rz_serialize_analysis_cc_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnaly
 
 RZ_API void rz_serialize_analysis_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis);
 RZ_API bool rz_serialize_analysis_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
+RZ_API bool rz_serialize_analysis_load_from(RZ_NONNULL RzSerializeNsSource *src, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res);
 
 /* plugin pointers */
 extern RzAnalysisPlugin rz_analysis_plugin_null;
@@ -266,6 +266,7 @@ typedef struct rz_bin_object_t {
 	RzBinAddr *binsym[RZ_BIN_SYM_LAST];
 	struct rz_bin_plugin_t *plugin;
 	int lang;
+	ut64 lazy_items; // RZ_BIN_REQ_* items not loaded yet (bin.lazy)
 	Sdb *kv;
 	Sdb *addrzklassmethod;
 	void *bin_obj; // internal pointer used by formats
@@ -295,6 +296,7 @@ typedef struct rz_bin_file_t {
 	Sdb *sdb;
 	Sdb *sdb_info;
 	Sdb *sdb_addrinfo;
+	RzBinDwarfLineTable *dwarf_lines; ///< line info of the DWARF sections, NULL until loaded
 	struct rz_bin_t *rbin;
 } RzBinFile;
 
@@ -317,6 +319,8 @@ struct rz_bin_t {
 	int minstrlen;
 	int maxstrlen;
 	ut64 maxstrbuf;
+	int str_threads; // threads scanning the data sections for strings, 0 = one per core
+	int dwarf_threads; // threads decoding the .debug_line units, 0 = one per core
 	int rawstr;
 	Sdb *sdb;
 	RzIDStorage *ids;
@@ -344,6 +348,9 @@ struct rz_bin_t {
 	bool use_ldr; // use loader plugins when loading a file?
 	RzStrConstPool constpool;
 	bool is_reloc_patched; // used to indicate whether relocations were patched or not
+	bool lazy; // load symbols, imports, relocs, strings and classes on first use
+	HtPP *demangled; // "lang:mangled" -> demangled name, NULL if it did not demangle
+	RzThreadLock *demangled_lock;
 };
 
 typedef struct rz_bin_xtr_metadata_t {
@@ -730,6 +737,7 @@ RZ_API ut64 rz_bin_a2b(RzBin *bin, ut64 addr);
 RZ_API int rz_bin_load_languages(RzBinFile *binfile);
 RZ_API RzBinFile *rz_bin_cur(RzBin *bin);
 RZ_API RzBinObject *rz_bin_cur_object(RzBin *bin);
+RZ_API RzBinObject *rz_bin_cur_object_items(RzBin *bin, ut64 req);
 
 // select/list binfiles functions
 RZ_API bool rz_bin_select(RzBin *bin, const char *arch, int bits, const char *name);
@@ -780,11 +788,13 @@ RZ_API void rz_bin_file_hash_free(RzBinFileHash *fhash);
 
 // binobject functions
 RZ_API int rz_bin_object_set_items(RzBinFile *binfile, RzBinObject *o);
+RZ_API void rz_bin_object_load_items(RzBinFile *bf, ut64 req);
 RZ_API bool rz_bin_object_delete(RzBin *bin, ut32 binfile_id);
 RZ_API void rz_bin_mem_free(void *data);
 
 // demangle functions
 RZ_API char *rz_bin_demangle(RzBinFile *binfile, const char *lang, const char *str, ut64 vaddr, bool libs);
+RZ_API void rz_bin_demangle_all(RzBinFile *bf, const char *lang, int threads);
 RZ_API char *rz_bin_demangle_java(const char *str);
 RZ_API char *rz_bin_demangle_cxx(RzBinFile *binfile, const char *str, ut64 vaddr);
 RZ_API char *rz_bin_demangle_msvc(const char *str);
@@ -1,6 +1,8 @@
 #ifndef RZ_BIN_DWARF_H
 #define RZ_BIN_DWARF_H
 
+#include <ht_pu.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -318,6 +320,13 @@ extern "C" {
 #define DW_FORM_addrx3                  0x2b
 #define DW_FORM_addrx4                  0x2c
 
+/* .debug_names index attributes, DWARF5 */
+#define DW_IDX_compile_unit             0x01
+#define DW_IDX_type_unit                0x02
+#define DW_IDX_die_offset               0x03
+#define DW_IDX_parent                   0x04
+#define DW_IDX_type_hash                0x05
+
 #define DW_OP_addr                      0x03
 #define DW_OP_deref                     0x06
 #define DW_OP_const1u                   0x08
@@ -655,6 +664,32 @@ typedef struct {
 	unsigned int column;
 } RzBinDwarfRow;
 
+/**
+ * \brief One row of the line number program
+ */
+typedef struct {
+	ut64 address;
+	ut32 file; ///< index in RzBinDwarfLineTable.files
+	ut32 line;
+	ut32 column;
+} RzBinDwarfLineEntry;
+
+/**
+ * \brief Line number information of a binary, sorted by address
+ *
+ * File names are stored once and referenced by index, so that looking up
+ * an address or a file:line pair is a binary search without any string
+ * formatting.
+ */
+typedef struct rz_bin_dwarf_line_table_t {
+	RzVector /*<RzBinDwarfLineEntry>*/ entries;
+	RzPVector /*<char *>*/ files;
+	HtPU *file_ids; ///< file name -> index in files + 1
+	ut32 *by_line; ///< entries ordered by file, line and address, built on demand
+	bool sorted;
+	bool finished;
+} RzBinDwarfLineTable;
+
 #define DWARF_INIT_LEN_64	0xffffffff
 typedef union {
 	ut32 offset32;
@@ -764,13 +799,6 @@ typedef struct {
 
 #define COMP_UNIT_CAPACITY	8
 #define DEBUG_INFO_CAPACITY	8
-typedef struct {
-	size_t count;
-	size_t capacity;
-	RzBinDwarfCompUnit *comp_units;
-	HtUP/*<ut64 offset, DwarfDie *die>*/ *lookup_table;
-} RzBinDwarfDebugInfo;
-
 #define	ABBREV_DECL_CAP		8
 
 typedef struct {
@@ -791,6 +819,28 @@ typedef struct {
 	RzBinDwarfAbbrevDecl *decls;
 } RzBinDwarfDebugAbbrev;
 
+typedef struct rz_bin_dwarf_info_accel_t RzBinDwarfInfoAccel;
+
+/**
+ * \brief Compilation units of .debug_info
+ *
+ * Units are indexed from their headers and their DIEs are decoded on demand,
+ * a unit whose `dies` is NULL has not been decoded yet. Strings and blocks of
+ * the DIEs point into the copies of the sections kept here.
+ */
+typedef struct {
+	size_t count;
+	size_t capacity;
+	RzBinDwarfCompUnit *comp_units;
+	ut8 *debug_info;
+	size_t debug_info_len;
+	ut8 *debug_str;
+	size_t debug_str_len;
+	const RzBinDwarfDebugAbbrev *abbrevs; ///< borrowed, must outlive the info to decode units on demand
+	bool big_endian;
+	RzBinDwarfInfoAccel *accel; ///< name and address tables, built on first use
+} RzBinDwarfDebugInfo;
+
 #define		DWARF_FALSE	0
 #define		DWARF_TRUE	1
 
@@ -849,14 +899,33 @@ typedef struct rz_bin_dwarf_loc_list_t {
 
 RZ_API RzList *rz_bin_dwarf_parse_aranges(RzBin *a, int mode);
 RZ_API RzList *rz_bin_dwarf_parse_line(RzBin *a, int mode);
+RZ_API RzBinDwarfLineTable *rz_bin_dwarf_load_lines(RzBin *bin, int mode);
 RZ_API RzBinDwarfDebugAbbrev *rz_bin_dwarf_parse_abbrev(RzBin *a, int mode);
 RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info(RzBinDwarfDebugAbbrev *da, RzBin *a, int mode);
+RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_index_info(RzBinDwarfDebugAbbrev *da, RzBin *bin);
+RZ_API bool rz_bin_dwarf_info_decode_all(RzBinDwarfDebugInfo *info, int threads);
+RZ_API RzBinDwarfCompUnit *rz_bin_dwarf_info_unit(RzBinDwarfDebugInfo *info, size_t idx);
+RZ_API const RzBinDwarfDie *rz_bin_dwarf_info_find_die(const RzBinDwarfDebugInfo *info, ut64 offset);
+RZ_API const RzBinDwarfDie *rz_bin_dwarf_info_die(RzBinDwarfDebugInfo *info, ut64 offset);
+RZ_API RzBinDwarfCompUnit *rz_bin_dwarf_info_unit_at(RzBinDwarfDebugInfo *info, ut64 addr);
+RZ_API const RzBinDwarfDie *rz_bin_dwarf_info_find_name(RzBinDwarfDebugInfo *info, const char *name);
 RZ_API HtUP/*<offset, RzBinDwarfLocList*>*/  *rz_bin_dwarf_parse_loc(RzBin *bin, int addr_size);
 RZ_API void rz_bin_dwarf_print_loc(HtUP /*<offset, RzBinDwarfLocList*>*/  *loc_table, int addr_size, PrintfCallback print);
 RZ_API void rz_bin_dwarf_free_loc(HtUP /*<offset, RzBinDwarfLocList*>*/  *loc_table);
 RZ_API void rz_bin_dwarf_free_debug_info(RzBinDwarfDebugInfo *inf);
 RZ_API void rz_bin_dwarf_free_debug_abbrev(RzBinDwarfDebugAbbrev *da);
 
+RZ_API RzBinDwarfLineTable *rz_bin_dwarf_line_table_new(void);
+RZ_API void rz_bin_dwarf_line_table_free(RzBinDwarfLineTable *t);
+RZ_API ut32 rz_bin_dwarf_line_table_file_id(RzBinDwarfLineTable *t, const char *name);
+RZ_API const char *rz_bin_dwarf_line_table_file(RzBinDwarfLineTable *t, ut32 file);
+RZ_API bool rz_bin_dwarf_line_table_add(RzBinDwarfLineTable *t, ut64 addr, ut32 file, ut32 line, ut32 column);
+RZ_API bool rz_bin_dwarf_line_table_merge(RzBinDwarfLineTable *t, RzBinDwarfLineTable *other);
+RZ_API bool rz_bin_dwarf_line_table_finish(RzBinDwarfLineTable *t);
+RZ_API const RzBinDwarfLineEntry *rz_bin_dwarf_line_table_get(RzBinDwarfLineTable *t, ut64 addr);
+RZ_API const RzBinDwarfLineEntry *rz_bin_dwarf_line_table_find(RzBinDwarfLineTable *t, const char *file, ut32 line);
+RZ_API bool rz_bin_dwarf_line_table_del(RzBinDwarfLineTable *t, ut64 addr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -313,6 +313,11 @@ typedef struct rz_cmd_desc_t {
 	int n_children;
 	RzPVector children;
 	const RzCmdDescHelp *help;
+	/**
+	 * The handler only reads state that can be shared between threads, so
+	 * it may run in a read-only task, in parallel with other readers.
+	 */
+	bool read_only;
 
 	union {
 		struct {
@@ -391,6 +396,7 @@ RZ_API int rz_cmd_add(RzCmd *cmd, const char *command, RzCmdCb callback);
 RZ_API int rz_core_del(RzCmd *cmd, const char *command);
 RZ_API int rz_cmd_call(RzCmd *cmd, const char *command);
 RZ_API RzCmdStatus rz_cmd_call_parsed_args(RzCmd *cmd, RzCmdParsedArgs *args);
+RZ_API RzCmdStatus rz_cmd_call_read_only(RzCmd *cmd, RzCmdParsedArgs *args);
 RZ_API RzCmdDesc *rz_cmd_get_root(RzCmd *cmd);
 RZ_API RzCmdDesc *rz_cmd_get_desc(RzCmd *cmd, const char *cmd_identifier);
 RZ_API char *rz_cmd_get_help(RzCmd *cmd, RzCmdParsedArgs *args, bool use_color);
@@ -430,6 +436,7 @@ RZ_API RzCmdDesc *rz_cmd_desc_fake_new(RzCmd *cmd, RzCmdDesc *parent, const char
 RZ_API RzCmdDesc *rz_cmd_desc_parent(RzCmdDesc *cd);
 RZ_API RzCmdDesc *rz_cmd_desc_get_exec(RzCmdDesc *cd);
 RZ_API bool rz_cmd_desc_has_handler(RzCmdDesc *cd);
+RZ_API bool rz_cmd_desc_is_read_only(RzCmdDesc *cd);
 RZ_API bool rz_cmd_desc_remove(RzCmd *cmd, RzCmdDesc *cd);
 RZ_API void rz_cmd_foreach_cmdname(RzCmd *cmd, RzCmdForeachNameCb cb, void *user);
 
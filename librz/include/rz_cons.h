@@ -859,7 +859,9 @@ RZ_API void rz_cons_push(void);
 RZ_API void rz_cons_pop(void);
 RZ_API RzConsContext *rz_cons_context_new(RZ_NULLABLE RzConsContext *parent);
 RZ_API void rz_cons_context_free(RzConsContext *context);
+RZ_API RzConsContext *rz_cons_context(void);
 RZ_API void rz_cons_context_load(RzConsContext *context);
+RZ_API void rz_cons_context_load_thread(RzConsContext *context);
 RZ_API void rz_cons_context_reset(void);
 RZ_API bool rz_cons_context_is_main(void);
 RZ_API void rz_cons_context_break(RzConsContext *context);
@@ -72,7 +72,7 @@ RZ_LIB_VERSION_HEADER(rz_core);
 #define RZ_GRAPH_FORMAT_CMD          5
 
 ///
-#define RZ_CONS_COLOR_DEF(x, def) ((core->cons && core->cons->context->pal.x)? core->cons->context->pal.x: def)
+#define RZ_CONS_COLOR_DEF(x, def) ((core->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x: def)
 #define RZ_CONS_COLOR(x) RZ_CONS_COLOR_DEF (x, "")
 
 /* rtr */
@@ -221,6 +221,9 @@ typedef struct rz_core_tasks_t {
 	RzThreadLock *lock;
 	int tasks_running;
 	bool oneshot_running;
+	int readers_running; // read-only tasks running, in parallel with each other
+	int writers_waiting; // tasks waiting for them to finish
+	RzThreadCond *readers_cond;
 } RzCoreTaskScheduler;
 
 struct rz_core_t {
@@ -658,6 +661,7 @@ RZ_API int rz_core_pseudo_code (RzCore *core, const char *input);
 RZ_API int rz_core_zdiff(RzCore *c, RzCore *c2);
 RZ_API int rz_core_gdiff(RzCore *core1, RzCore *core2);
 RZ_API int rz_core_gdiff_fcn(RzCore *c, ut64 addr, ut64 addr2);
+RZ_API void rz_core_gdiff_report(RzCore *c);
 
 RZ_API char *rz_core_sysenv_begin(RzCore *core, const char *cmd);
 RZ_API void rz_core_sysenv_end(RzCore *core, const char *cmd);
@@ -825,6 +829,7 @@ typedef struct rz_core_task_t {
 	int id;
 	RTaskState state;
 	bool transient; // delete when finished
+	bool read_only; // runs a command flagged read-only, in parallel with other read-only tasks
 	int refcount;
 	RzThreadSemaphore *running_sem;
 	void *user;
@@ -931,6 +936,8 @@ RZ_API void rz_serialize_core_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core,
  */
 RZ_API bool rz_serialize_core_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core, bool load_bin_io,
 		RZ_NULLABLE const char *prj_file, RZ_NULLABLE RzSerializeResultInfo *res);
+RZ_API bool rz_serialize_core_load_from(RZ_NONNULL RzSerializeNsSource *src, RZ_NONNULL RzCore *core, bool load_bin_io,
+		RZ_NULLABLE const char *prj_file, RZ_NULLABLE RzSerializeResultInfo *res);
 
 #endif
 
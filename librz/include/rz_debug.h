@@ -161,27 +161,36 @@ typedef struct rz_debug_desc_t {
 	ut64 off;
 } RzDebugDesc;
 
+#define RZ_DEBUG_SNAP_PAGE_SIZE 0x1000
+
+/* Snapshot contents, shared by the snapshots in which it did not change */
+typedef struct rz_debug_snap_page_t {
+	ut32 refs;
+	ut8 data[RZ_DEBUG_SNAP_PAGE_SIZE];
+} RzDebugSnapPage;
+
 typedef struct rz_debug_snap_t {
 	char *name;
 	ut64 addr;
 	ut64 addr_end;
 	ut32 size;
-	ut8 *data;
+	RzDebugSnapPage **pages; // one per RZ_DEBUG_SNAP_PAGE_SIZE bytes of size
 	int perm;
 	int user;
 	bool shared;
 } RzDebugSnap;
 
+typedef struct rz_debug_mem_range_t {
+	ut64 addr;
+	ut8 *buf;
+	ut64 size;
+} RzDebugMemRange;
+
 typedef struct {
 	int cnum;
 	ut64 data;
 } RzDebugChangeReg;
 
-typedef struct {
-	int cnum;
-	ut8 data;
-} RzDebugChangeMem;
-
 typedef struct rz_debug_checkpoint_t {
 	int cnum;
 	RzRegArena *arena[RZ_REG_TYPE_LAST];
@@ -193,10 +202,11 @@ typedef struct rz_debug_session_t {
 	ut32 maxcnum;
 	RzDebugCheckpoint *cur_chkpt;
 	RzVector *checkpoints; /* RzVector<RzDebugCheckpoint> */
-	HtUP *memory; /* RzVector<RzDebugChangeMem> */
+	RzMemJournal *memory; // writes tagged with their cnum
 	HtUP *registers; /* RzVector<RzDebugChangeReg> */
 	int reasontype /*RzDebugReasonType*/;
 	RzBreakpointItem *bp;
+	bool soft_dirty; // soft-dirty bits cleared since the last checkpoint
 } RzDebugSession;
 
 /* Session file format */
@@ -579,7 +589,7 @@ RZ_API void rz_debug_esil_prestep (RzDebug *d, int p);
 // RZ_API ut8 rz_debug_get_byte(RzDebug *dbg, ut32 cnum, ut64 addr);
 RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg);
 RZ_API bool rz_debug_session_add_reg_change(RzDebugSession *session, int arena, ut64 offset, ut64 data);
-RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, ut8 data);
+RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, const ut8 *buf, ut32 len);
 RZ_API void rz_debug_session_restore_reg_mem(RzDebug *dbg, ut32 cnum);
 RZ_API void rz_debug_session_list_memory(RzDebug *dbg);
 RZ_API void rz_debug_session_serialize(RzDebugSession *session, Sdb *db);
@@ -593,6 +603,13 @@ RZ_API RzDebugSession *rz_debug_session_new(void);
 RZ_API void rz_debug_session_free(RzDebugSession *session);
 
 RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map);
+RZ_API RzList *rz_debug_snap_maps(RzDebug *dbg, int perm, RZ_NULLABLE RzList *prev, bool prev_soft_dirty);
+RZ_API bool rz_debug_snap_clear_soft_dirty(RzDebug *dbg);
+RZ_API void rz_debug_snap_restore(RzDebug *dbg, RzList *snaps);
+RZ_API RZ_OWN ut8 *rz_debug_snap_get_data(RzDebugSnap *snap);
+RZ_API bool rz_debug_snap_set_data(RzDebugSnap *snap, const ut8 *data, RZ_NULLABLE RzDebugSnap *prev);
+RZ_API void rz_debug_mem_readv(RzDebug *dbg, RzDebugMemRange *ranges, size_t count);
+RZ_API void rz_debug_mem_writev(RzDebug *dbg, const RzDebugMemRange *ranges, size_t count);
 RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr);
 RZ_API ut8 *rz_debug_snap_get_hash(RzDebugSnap *snap);
 RZ_API bool rz_debug_snap_is_equal(RzDebugSnap *a, RzDebugSnap *b);
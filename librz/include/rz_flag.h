@@ -82,6 +82,8 @@ typedef bool (*RzFlagPushSpace)(RzFlag *f, const char *name);
 
 typedef bool (*RzFlagItemCb)(RzFlagItem *fi, void *user);
 
+typedef struct rz_flag_batch_t RzFlagBatch;
+
 typedef struct rz_flag_bind_t {
 	int init;
 	RzFlag *f;
@@ -119,6 +121,10 @@ RZ_API bool rz_flag_unset_off(RzFlag *f, ut64 addr);
 RZ_API void rz_flag_unset_all (RzFlag *f);
 RZ_API RzFlagItem *rz_flag_set(RzFlag *fo, const char *name, ut64 addr, ut32 size);
 RZ_API RzFlagItem *rz_flag_set_next(RzFlag *fo, const char *name, ut64 addr, ut32 size);
+RZ_API RzFlagBatch *rz_flag_batch_new(RzFlag *f);
+RZ_API void rz_flag_batch_free(RzFlagBatch *b);
+RZ_API bool rz_flag_batch_add(RzFlagBatch *b, const char *name, const char *realname, ut64 addr, ut32 size, bool demangled);
+RZ_API size_t rz_flag_batch_commit(RzFlagBatch *b);
 RZ_API void rz_flag_item_set_alias(RzFlagItem *item, const char *alias);
 RZ_API void rz_flag_item_free (RzFlagItem *item);
 RZ_API void rz_flag_item_set_comment(RzFlagItem *item, const char *comment);
@@ -183,6 +183,10 @@ struct rz_hash_t {
 	ut8 RZ_ALIGNED(8) digest[128];
 };
 
+typedef struct rz_hash_stream_t RzHashStream;
+
+typedef bool (*RzHashBlockCb)(void *user, ut64 idx, RzHash *ctx, int dlen);
+
 typedef struct rz_hash_seed_t {
 	int prefix;
 	ut8 *buf;
@@ -503,6 +507,15 @@ RZ_API ut64 rz_hash_name_to_bits(const char *name);
 RZ_API int rz_hash_size(ut64 bit);
 RZ_API int rz_hash_calculate(RzHash *ctx, ut64 algobit, const ut8 *input, int len);
 
+/* streaming */
+RZ_API bool rz_hash_stream_supported(ut64 algobit);
+RZ_API RzHashStream *rz_hash_stream_new(ut64 algobits, int threads);
+RZ_API void rz_hash_stream_free(RzHashStream *s);
+RZ_API bool rz_hash_stream_update(RzHashStream *s, const ut8 *buf, ut64 len);
+RZ_API void rz_hash_stream_final(RzHashStream *s);
+RZ_API RzHash *rz_hash_stream_ctx(RzHashStream *s, ut64 algobit);
+RZ_API bool rz_hash_calculate_blocks(ut64 algobit, const ut8 *buf, ut64 len, ut64 bsize, int threads, RzHashBlockCb cb, void *user);
+
 /* checksums */
 /* XXX : crc16 should use 0 as arg0 by default */
 /* static methods */
@@ -78,6 +78,27 @@ typedef struct rz_io_undo_w_t {
 	int len;  /* length */
 } RzIOUndoWrite;
 
+#define RZ_IO_PAGE_CACHE_PAGES 256
+#define RZ_IO_PAGE_CACHE_PAGESIZE 0x1000
+
+typedef struct rz_io_page_cache_t {
+	HtUP/*<ut64, RzIOPage *>*/ *pages;
+	struct rz_io_page_t *head; // most recently used
+	struct rz_io_page_t *tail;
+	ut32 count;
+	ut32 capacity; // in pages, 0 disables the cache
+	ut32 page_size; // power of two
+	/* state the cached pages were read with */
+	struct rz_io_desc_t *desc;
+	int va;
+	int p_cache;
+	int volatile_descs; // open descs that cannot be cached, -1 if not counted yet
+	bool dbg_flush; // a debugger flushes the cache whenever its target stops, isdbg descs can be cached
+	RzThreadLock *lock;
+	ut64 hits;
+	ut64 misses;
+} RzIOPageCache;
+
 typedef struct rz_io_t {
 	struct rz_io_desc_t *desc; // XXX deprecate... we should use only the fd integer, not hold a weak pointer
 	ut64 off;
@@ -90,6 +111,7 @@ typedef struct rz_io_t {
 	int autofd;
 	int cached;
 	bool cachemode; // write in cache all the read operations (EXPERIMENTAL)
+	bool gzip_index; // save the checkpoint index of gzip:// files next to them
 	int p_cache;
 	RzIDPool *map_ids;
 	RzPVector maps; //from tail backwards maps with higher priority are found
@@ -98,6 +120,7 @@ typedef struct rz_io_t {
 	RzCache *buffer;
 	RzPVector cache;
 	RzSkyline cache_skyline;
+	RzIOPageCache page_cache;
 	ut8 *write_mask;
 	int write_mask_len;
 	RzIOUndo undo;
@@ -154,6 +177,7 @@ typedef struct rz_io_plugin_t {
 	int (*init)(void);
 	RzIOUndo undo;
 	bool isdbg;
+	bool isvolatile; // memory can change without going through rz_io, never cache it
 	// int (*is_file_opened)(RzIO *io, RzIODesc *fd, const char *);
 	char *(*system)(RzIO *io, RzIODesc *fd, const char *);
 	RzIODesc* (*open)(RzIO *io, const char *, int perm, int mode);
@@ -226,6 +250,7 @@ typedef bool (*RzIOIsValidOff) (RzIO *io, ut64 addr, int hasperm);
 typedef RzIOMap *(*RzIOMapGet) (RzIO *io, ut64 addr);
 typedef RzIOMap *(*RzIOMapGetPaddr) (RzIO *io, ut64 paddr);
 typedef bool (*RzIOAddrIsMapped) (RzIO *io, ut64 addr);
+typedef void (*RzIOPageCacheFlush) (RzIO *io);
 typedef RzIOMap *(*RzIOMapAdd) (RzIO *io, int fd, int flags, ut64 delta, ut64 addr, ut64 size);
 #if HAVE_PTRACE
 typedef long (*RzIOPtraceFn) (RzIO *io, rz_ptrace_request_t request, pid_t pid, void *addr, rz_ptrace_data_t data);
@@ -262,6 +287,7 @@ typedef struct rz_io_bind_t {
 	RzIOMapGet map_get;
 	RzIOMapGetPaddr map_get_paddr;
 	RzIOMapAdd map_add;
+	RzIOPageCacheFlush page_cache_flush;
 	RzIOV2P v2p;
 	RzIOP2V p2v;
 #if HAVE_PTRACE
@@ -420,6 +446,15 @@ RZ_API void rz_io_cache_reset(RzIO *io, int set);
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len);
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len);
 
+/* io/page_cache.c */
+RZ_API void rz_io_page_cache_init(RzIO *io);
+RZ_API void rz_io_page_cache_fini(RzIO *io);
+RZ_API void rz_io_page_cache_flush(RzIO *io);
+RZ_API bool rz_io_page_cache_resize(RzIO *io, ut32 capacity, ut32 page_size);
+RZ_API bool rz_io_page_cache_enabled(RzIO *io);
+RZ_API ut32 rz_io_page_cache_get(RzIO *io, ut64 page, ut32 off, ut8 *buf, ut32 len);
+RZ_API bool rz_io_page_cache_put(RzIO *io, ut64 page, const ut8 *data, ut32 size);
+
 /* io/p_cache.c */
 RZ_API bool rz_io_desc_cache_init(RzIODesc *desc);
 RZ_API int rz_io_desc_cache_write(RzIODesc *desc, ut64 paddr, const ut8 *buf, int len);
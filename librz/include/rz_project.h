@@ -12,6 +12,20 @@ extern "C" {
 
 typedef Sdb RzProject;
 
+/**
+ * A mapped binary project container, see project_bin.c
+ */
+typedef struct rz_project_bin_t RzProjectBin;
+
+/**
+ * A namespace that a binary project container stores as binary records
+ */
+typedef struct rz_project_bin_records_t {
+	const char *path; ///< e.g. "core/analysis/functions"
+	bool (*save)(void *user, RZ_NONNULL RzSerializeRecordCb cb, void *cb_user); ///< pass all records of the namespace to cb
+	void *user;
+} RzProjectBinRecords;
+
 typedef enum rz_project_err {
 	RZ_PROJECT_ERR_SUCCESS,
 	RZ_PROJECT_ERR_FILE,
@@ -25,6 +39,7 @@ typedef enum rz_project_err {
 RZ_API RZ_NONNULL const char *rz_project_err_message(RzProjectErr err);
 RZ_API RzProjectErr rz_project_save(RzCore *core, RzProject *prj, const char *file);
 RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file);
+RZ_API RzProjectErr rz_project_export_file(RzCore *core, const char *file);
 
 /**
  * @param load_bin_io whether to also load the underlying RIO and RBin state from the project. If false, the current state will be kept and the project loaded on top.
@@ -38,6 +53,15 @@ RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_
  */
 RZ_API RzProjectErr rz_project_load_file(RzCore *core, const char *file, bool load_bin_io, RzSerializeResultInfo *res);
 
+RZ_API RZ_OWN RzProjectBin *rz_project_bin_open(RZ_NONNULL const char *file);
+RZ_API void rz_project_bin_close(RzProjectBin *pb);
+RZ_API RZ_BORROW const char *rz_project_bin_get(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL const char *path, RZ_NONNULL const char *key);
+RZ_API bool rz_project_bin_load_ns(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL const char *path, RZ_NONNULL Sdb *db, bool recursive);
+RZ_API bool rz_project_bin_has_records(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL const char *path);
+RZ_API bool rz_project_bin_records(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL const char *path, RZ_NONNULL RzSerializeRecordCb cb, void *user);
+RZ_API bool rz_project_bin_save(RZ_NONNULL RzProject *prj, RZ_NULLABLE const RzProjectBinRecords *records, size_t records_count,
+		RZ_NONNULL const char *file, RZ_NULLABLE ut64 *written);
+
 #ifdef __cplusplus
 }
 #endif
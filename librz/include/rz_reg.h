@@ -109,6 +109,7 @@ typedef struct rz_reg_set_t {
 	RzList *pool;      /* RzRegArena */
 	RzList *regs;      /* RzRegItem */
 	HtPP *ht_regs;    /* name:RzRegItem */
+	RzRegArena *synced; /* contents last transferred from or to the target, see rz_reg_dirty_types() */
 	RzListIter *cur;
 	int maskregstype; /* which type of regs have this reg set (logic mask with RzRegisterType  RZ_REG_TYPE_XXX) */
 } RzRegSet;
@@ -120,6 +121,9 @@ typedef struct rz_reg_t {
 	char *name[RZ_REG_NAME_LAST]; // aliases
 	RzRegSet regset[RZ_REG_TYPE_LAST];
 	RzList *allregs;
+	RzRegItem **items; /* by RzRegItem.index, see rz_reg_index_get() */
+	int items_count;
+	HtPP *ht_all; /* name:RzRegItem of all the types, see rz_reg_get() */
 	RzList *roregs;
 	int iters;
 	int arch;
@@ -127,6 +131,7 @@ typedef struct rz_reg_t {
 	int size;
 	bool is_thumb;
 	bool big_endian;
+	ut32 profile_gen; // bumped every time the register items are freed
 } RzReg;
 
 typedef struct rz_reg_flags_t {
@@ -165,6 +170,9 @@ RZ_API RzRegItem *rz_reg_next_diff(RzReg *reg, int type, const ut8 *buf, int buf
 
 RZ_API void rz_reg_reindex(RzReg *reg);
 RZ_API RzRegItem *rz_reg_index_get(RzReg *reg, int idx);
+RZ_API int rz_reg_index_of(RzReg *reg, const char *name);
+RZ_API ut64 rz_reg_index_get_value(RzReg *reg, int idx);
+RZ_API bool rz_reg_index_set_value(RzReg *reg, int idx, ut64 value);
 
 /* Item */
 RZ_API void rz_reg_item_free(RzRegItem *item);
@@ -229,6 +237,11 @@ RZ_API const char *rz_reg_cond_to_string(int n);
 RZ_API int rz_reg_cond_from_string(const char *str);
 RZ_API void rz_reg_arena_shrink(RzReg *reg);
 
+/* dirty set */
+RZ_API int rz_reg_dirty_types(RzReg *reg);
+RZ_API void rz_reg_dirty_clear(RzReg *reg, int type);
+RZ_API void rz_reg_dirty_set(RzReg *reg, int type);
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,6 +50,9 @@ typedef struct rz_search_hit_t {
 } RzSearchHit;
 
 typedef int (*RzSearchCallback)(RzSearchKeyword *kw, void *user, ut64 where);
+typedef bool (*RzSearchReadCallback)(void *user, ut64 addr, ut8 *buf, int len);
+
+typedef struct rz_search_matcher_t RzSearchMatcher;
 
 typedef struct rz_search_t {
 	int n_kws; // hit${n_kws}_${count}
@@ -70,6 +73,7 @@ typedef struct rz_search_t {
 	int align;
 	int (*update)(struct rz_search_t *s, ut64 from, const ut8 *buf, int len);
 	RzList *kws; // TODO: Use rz_search_kw_new ()
+	RzSearchMatcher *matcher; // kws compiled for RZ_SEARCH_KEYWORD, built on the first update
 	RzIOBind iob;
 	char bckwrds;
 } RzSearch;
@@ -86,6 +90,7 @@ RZ_API RzSearch *rz_search_free(RzSearch *s);
 RZ_API RzList *rz_search_find(RzSearch *s, ut64 addr, const ut8 *buf, int len);
 RZ_API int rz_search_update(RzSearch *s, ut64 from, const ut8 *buf, long len);
 RZ_API int rz_search_update_i(RzSearch *s, ut64 from, const ut8 *buf, long len);
+RZ_API int rz_search_update_range(RzSearch *s, ut64 from, ut64 to, int bsize, int threads, RzSearchReadCallback read, void *user);
 
 RZ_API void rz_search_keyword_free (RzSearchKeyword *kw);
 RZ_API RzSearchKeyword* rz_search_keyword_new(const ut8 *kw, int kwlen, const ut8 *bm, int bmlen, const char *data);
@@ -87,6 +87,7 @@ typedef struct rz_sign_search_met {
 typedef struct rz_sign_search_t {
 	RzSearch *search;
 	RzList *items;
+	RzSignIndex *index; // keeps the items alive
 	RzSignSearchCallback cb;
 	void *user;
 } RzSignSearch;
@@ -126,6 +127,8 @@ RZ_API RzSignItem *rz_sign_get_item(RzAnalysis *a, const char *name);
 RZ_API bool rz_sign_add_item(RzAnalysis *a, RzSignItem *it);
 
 RZ_API bool rz_sign_foreach(RzAnalysis *a, RzSignForeachCallback cb, void *user);
+RZ_API RzSignIndex *rz_sign_index_get(RzAnalysis *a);
+RZ_API void rz_sign_index_unref(RzSignIndex *idx);
 
 RZ_API RzSignSearch *rz_sign_search_new(void);
 RZ_API void rz_sign_search_free(RzSignSearch *ss);
@@ -137,6 +140,7 @@ RZ_API bool rz_sign_load(RzAnalysis *a, const char *file);
 RZ_API bool rz_sign_load_gz(RzAnalysis *a, const char *filename);
 RZ_API char *rz_sign_path(RzAnalysis *a, const char *file);
 RZ_API bool rz_sign_save(RzAnalysis *a, const char *file);
+RZ_API bool rz_sign_save_compiled(RzAnalysis *a, const char *file);
 
 RZ_API RzSignItem *rz_sign_item_new(void);
 RZ_API void rz_sign_item_free(RzSignItem *item);
@@ -29,6 +29,7 @@ RZ_API RzSkipList* rz_skiplist_new(RzListFree freefn, RzListComparator comparefn
 RZ_API void rz_skiplist_free(RzSkipList *list);
 RZ_API void rz_skiplist_purge(RzSkipList *list);
 RZ_API RzSkipListNode* rz_skiplist_insert(RzSkipList* list, void* data);
+RZ_API bool rz_skiplist_insert_sorted(RzSkipList *list, void **data, size_t n);
 RZ_API bool rz_skiplist_delete(RzSkipList* list, void* data);
 RZ_API bool rz_skiplist_delete_node(RzSkipList *list, RzSkipListNode *node);
 RZ_API RzSkipListNode* rz_skiplist_find(RzSkipList* list, void* data);
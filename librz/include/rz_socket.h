@@ -53,6 +53,11 @@ typedef struct {
 #else
 	int input[2];
 	int output[2];
+	bool framed; // length prefixed messages instead of NUL terminated replies
+	ut8 *rbuf; // replies read ahead
+	size_t rbuf_off, rbuf_len, rbuf_size;
+	ut8 *wbuf; // commands queued by rzpipe_queue()
+	size_t wbuf_len, wbuf_size;
 #endif
 	RzCoreBind coreb;
 } RzPipe;
@@ -272,7 +277,12 @@ RZ_API int rap_write(RzPipe *rap, const char *str);
 RZ_API char *rap_read(RzPipe *rap);
 
 RZ_API int rzpipe_write(RzPipe *rzpipe, const char *str);
+RZ_API bool rzpipe_queue(RzPipe *rzpipe, const char *str);
 RZ_API char *rzpipe_read(RzPipe *rzpipe);
+RZ_API bool rzpipe_write_frame(int fd, const ut8 *buf, ut32 len);
+RZ_API ut8 *rzpipe_read_frame(int fd, ut32 *len);
+RZ_API RZ_OWN char *rzpipe_framed_token(int fd);
+RZ_API bool rzpipe_framed_requested(int fd);
 RZ_API int rzpipe_close(RzPipe *rzpipe);
 RZ_API RzPipe *rzpipe_open_corebind(RzCoreBind *coreb);
 RZ_API RzPipe *rzpipe_open(const char *cmd);
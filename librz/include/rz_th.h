@@ -78,9 +78,18 @@ typedef struct rz_th_t {
 	int ready;     // thread is properly setup
 } RzThread;
 
+typedef void (*RzThreadPoolJob)(void *user);
+
 typedef struct rz_th_pool_t {
 	int size;
 	RzThread **threads;
+	RzThreadLock *lock;
+	RzThreadCond *has_job; // signaled when a job is queued or on quit
+	RzThreadCond *idle;    // signaled when the queue drains
+	struct rz_th_pool_job_t *head;
+	struct rz_th_pool_job_t *tail;
+	int busy;              // number of jobs currently running
+	bool quit;
 } RzThreadPool;
 
 #ifdef RZ_API
@@ -115,6 +124,12 @@ RZ_API void rz_th_cond_signal_all(RzThreadCond *cond);
 RZ_API void rz_th_cond_wait(RzThreadCond *cond, RzThreadLock *lock);
 RZ_API void rz_th_cond_free(RzThreadCond *cond);
 
+RZ_API int rz_th_ncores(void);
+RZ_API RzThreadPool *rz_th_pool_new(int size);
+RZ_API bool rz_th_pool_add_job(RzThreadPool *pool, RzThreadPoolJob fn, void *user);
+RZ_API void rz_th_pool_wait(RzThreadPool *pool);
+RZ_API void rz_th_pool_free(RzThreadPool *pool);
+
 #endif
 
 #ifdef __cplusplus
@@ -311,6 +311,12 @@ typedef int (*PrintfCallback)(const char *str, ...) RZ_PRINTF_CHECK(1, 2);
   #endif
 #endif
 
+#if defined(_MSC_VER)
+  #define RZ_TLS __declspec(thread)
+#else
+  #define RZ_TLS __thread
+#endif
+
 #define RZ_LIB_VERSION_HEADER(x) \
 RZ_API const char *x##_version(void)
 #define RZ_LIB_VERSION(x) \
@@ -44,8 +44,10 @@ int gettimeofday (struct timeval* p, void* tz);
 #include "rz_util/rz_ctypes.h"
 #include "rz_util/rz_file.h"
 #include "rz_util/rz_hex.h"
+#include "rz_util/rz_inflate_index.h"
 #include "rz_util/rz_log.h"
 #include "rz_util/rz_mem.h"
+#include "rz_util/rz_mem_journal.h"
 #include "rz_util/rz_name.h"
 #include "rz_util/rz_num.h"
 #include "rz_util/rz_table.h"
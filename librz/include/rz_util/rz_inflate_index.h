@@ -0,0 +1,35 @@
+#ifndef RZ_INFLATE_INDEX_H
+#define RZ_INFLATE_INDEX_H
+
+#include "../rz_types.h"
+#include "rz_buf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* distance between two checkpoints of the decompressed data */
+#define RZ_INFLATE_INDEX_SPAN 0x100000
+
+/**
+ * \brief Random access index over a deflate, zlib or gzip stream
+ *
+ * It stores the state of the decompressor every few MB of output, so that a
+ * read anywhere in the decompressed data only has to resume from the closest
+ * checkpoint instead of inflating the whole stream.
+ */
+typedef struct rz_inflate_index_t RzInflateIndex;
+
+RZ_API RzInflateIndex *rz_inflate_index_new(RzBuffer *src, bool raw, ut64 span);
+RZ_API RzInflateIndex *rz_inflate_index_load(RzBuffer *src, const char *file);
+RZ_API bool rz_inflate_index_save(RzInflateIndex *idx, const char *file);
+RZ_API void rz_inflate_index_free(RzInflateIndex *idx);
+RZ_API ut64 rz_inflate_index_size(RzInflateIndex *idx);
+RZ_API ut32 rz_inflate_index_count(RzInflateIndex *idx);
+RZ_API st64 rz_inflate_index_read_at(RzInflateIndex *idx, ut64 off, ut8 *buf, ut64 len);
+RZ_API RzBuffer *rz_buf_new_with_inflate_index(RzInflateIndex *idx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //  RZ_INFLATE_INDEX_H
@@ -0,0 +1,52 @@
+#ifndef RZ_MEM_JOURNAL_H
+#define RZ_MEM_JOURNAL_H
+
+#include "../rz_types.h"
+#include "../rz_vector.h"
+#include "rz_intervaltree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * RzMemJournal records the memory writes of a trace as contiguous extents
+ * tagged with the step they happened at. Contiguous writes of the same
+ * step are merged into a single extent, and steps must never decrease.
+ */
+
+typedef struct rz_mem_journal_extent_t {
+	ut64 addr;
+	ut32 step;
+	ut32 len;
+	ut64 off; // offset of the written bytes in RzMemJournal.data
+} RzMemJournalExtent;
+
+typedef struct rz_mem_journal_t {
+	RzVector /*<RzMemJournalExtent>*/ extents; // in recording order
+	ut8 *data;
+	ut64 data_len;
+	ut64 data_size;
+	RzIntervalTree index; // [addr, addr + len) => extent index + 1
+	RzIntervalNode *last; // node of the last extent
+} RzMemJournal;
+
+typedef bool (*RzMemJournalCb)(void *user, ut64 addr, const ut8 *buf, ut32 len);
+
+RZ_API RzMemJournal *rz_mem_journal_new(void);
+RZ_API void rz_mem_journal_free(RzMemJournal *j);
+RZ_API void rz_mem_journal_clear(RzMemJournal *j);
+RZ_API bool rz_mem_journal_add(RzMemJournal *j, ut32 step, ut64 addr, const ut8 *buf, ut32 len);
+RZ_API bool rz_mem_journal_read_at(RzMemJournal *j, ut32 step, ut64 addr, ut8 *buf, ut32 len);
+RZ_API bool rz_mem_journal_replay(RzMemJournal *j, ut32 from, ut32 to, RzMemJournalCb cb, void *user);
+RZ_API ut8 *rz_mem_journal_serialize(RzMemJournal *j, ut64 *size);
+RZ_API bool rz_mem_journal_deserialize(RzMemJournal *j, const ut8 *buf, ut64 size);
+
+static inline size_t rz_mem_journal_count(RzMemJournal *j) {
+	return rz_vector_len (&j->extents);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif //  RZ_MEM_JOURNAL_H
@@ -10,4 +10,35 @@ typedef RzList RzSerializeResultInfo;
 static inline RzSerializeResultInfo *rz_serialize_result_info_new(void) { return rz_list_newf (free); }
 static inline void rz_serialize_result_info_free(RzSerializeResultInfo *info) { rz_list_free (info); }
 
+/**
+ * \brief Called for every binary record of a namespace
+ */
+typedef bool (*RzSerializeRecordCb)(void *user, RZ_NONNULL const char *key, RZ_NONNULL const ut8 *data, ut64 size);
+
+/**
+ * \brief Hands out the namespaces of a db only when a loader asks for them
+ *
+ * Loaders given a source decode each namespace right before reading it and
+ * drop it again once they are done, instead of working on a db that was
+ * decoded as a whole up front. All paths are "/"-separated and relative to
+ * the root of the source, e.g. "core/analysis/blocks".
+ */
+typedef struct rz_serialize_ns_source_t {
+	/**
+	 * Decode the namespace at \p path into \p db, and all namespaces below it if \p recursive
+	 */
+	bool (*load)(void *user, RZ_NONNULL const char *path, RZ_NONNULL Sdb *db, bool recursive);
+	/**
+	 * Whether the namespace at \p path is stored as binary records instead of key/value strings,
+	 * NULL if the source never holds any
+	 */
+	bool (*has_records)(void *user, RZ_NONNULL const char *path);
+	/**
+	 * Pass all binary records of the namespace at \p path to \p cb
+	 */
+	bool (*records)(void *user, RZ_NONNULL const char *path, RZ_NONNULL RzSerializeRecordCb cb, void *cb_user);
+	void *user;
+	const char *path; ///< path of the namespace the loader is given
+} RzSerializeNsSource;
+
 #endif //RZ_SERIALIZE_H
@@ -21,6 +21,14 @@ typedef enum {
 
 typedef int (*RzStrRangeCallback) (void *, int);
 
+/* byte classes for rz_str_scan_next() and rz_str_scan_span() */
+typedef enum {
+	RZ_STR_SCAN_PRINTABLE = 1 << 0, ///< ' ' to '~'
+	RZ_STR_SCAN_TAB = 1 << 1, ///< '\t'
+	RZ_STR_SCAN_ESCAPES = 1 << 2, ///< '\a' to '\r' and '\e'
+	RZ_STR_SCAN_UTF8_LEAD = 1 << 3, ///< first byte of a multibyte UTF-8 sequence
+} RzStrScanClass;
+
 #define RZ_STR_ISEMPTY(x) (!(x) || !*(x))
 #define RZ_STR_ISNOTEMPTY(x) ((x) && *(x))
 #define RZ_STR_DUP(x) ((x) ? strdup ((x)) : NULL)
@@ -203,6 +211,9 @@ RZ_API RzList *rz_str_wrap(char *str, size_t width);
 RZ_API const char *rz_str_sep(const char *base, const char *sep);
 RZ_API const char *rz_str_rsep(const char *base, const char *p, const char *sep);
 RZ_API char *rz_str_version(const char *program);
+RZ_API size_t rz_str_scan_next(const ut8 *buf, size_t len, int classes);
+RZ_API size_t rz_str_scan_span(const ut8 *buf, size_t len, int classes);
+RZ_API size_t rz_str_scan_wide_next(const ut8 *buf, size_t len, size_t width);
 
 #ifdef __cplusplus
 }
@@ -99,6 +99,62 @@ static st64 on_map_skyline(RzIO *io, ut64 vaddr, ut8 *buf, int len, int match_fl
 	return prefix_mode ? addr - vaddr : ret;
 }
 
+// Reads spanning at most RZ_IO_PAGE_CACHE_SPAN pages go through io->page_cache.
+// Pages remember how many bytes could be read from their beginning, reads
+// that go past that fall back to the uncached path.
+#define RZ_IO_PAGE_CACHE_SPAN 16
+
+static int page_fill(RzIO *io, ut64 addr, ut8 *buf, int len) {
+	if (io->va) {
+		return on_map_skyline (io, addr, buf, len, RZ_PERM_R, fd_read_at_wrap, true);
+	}
+	return io->desc? rz_io_desc_read_at (io->desc, addr, buf, len): 0;
+}
+
+static bool page_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len) {
+	RzIOPageCache *pc = &io->page_cache;
+	if (io->cachemode || len < 1 || UT64_ADD_OVFCHK (addr, len - 1) || !rz_io_page_cache_enabled (io)) {
+		return false;
+	}
+	const ut32 page_size = pc->page_size;
+	const ut64 last = addr + len - 1;
+	const ut64 first_page = addr & ~((ut64)page_size - 1);
+	const ut64 npages = (last - first_page) / page_size + 1;
+	if (npages > RZ_IO_PAGE_CACHE_SPAN || npages > pc->capacity / 2) {
+		return false;
+	}
+	ut8 *tmp = NULL;
+	ut64 i, page = first_page;
+	for (i = 0; i < npages; i++, page += page_size) {
+		const ut64 from = RZ_MAX (addr, page);
+		const ut64 to = RZ_MIN (last, page + page_size - 1);
+		const ut32 off = from - page;
+		const ut32 n = to - from + 1;
+		ut32 size = rz_io_page_cache_get (io, page, off, buf + (from - addr), n);
+		if (!size) {
+			if (!tmp && !(tmp = malloc (page_size))) {
+				return false;
+			}
+			int r = page_fill (io, page, tmp, page_size);
+			if (r < 1) {
+				free (tmp);
+				return false;
+			}
+			size = RZ_MIN ((ut32)r, page_size);
+			(void)rz_io_page_cache_put (io, page, tmp, size);
+			if (to - page < size) {
+				memcpy (buf + (from - addr), tmp + off, n);
+			}
+		}
+		if (to - page >= size) {
+			free (tmp);
+			return false;
+		}
+	}
+	free (tmp);
+	return true;
+}
+
 RZ_API RzIO* rz_io_new(void) {
 	return rz_io_init (RZ_NEW0 (RzIO));
 }
@@ -110,6 +166,7 @@ RZ_API RzIO* rz_io_init(RzIO* io) {
 	rz_skyline_init (&io->map_skyline);
 	rz_io_map_init (io);
 	rz_io_cache_init (io);
+	rz_io_page_cache_init (io);
 	rz_io_plugin_init (io);
 	rz_io_undo_init (io);
 	io->event = rz_event_new (io);
@@ -285,9 +342,9 @@ RZ_API bool rz_io_read_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	if (len == 0) {
 		return false;
 	}
-	bool ret = (io->va)
+	bool ret = page_cache_read (io, addr, buf, len) || ((io->va)
 		? rz_io_vread_at_mapped (io, addr, buf, len)
-		: rz_io_pread_at (io, addr, buf, len) > 0;
+		: rz_io_pread_at (io, addr, buf, len) > 0);
 	if (io->cached & RZ_PERM_R) {
 		(void)rz_io_cache_read (io, addr, buf, len);
 	}
@@ -301,6 +358,10 @@ RZ_API bool rz_io_read_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 RZ_API bool rz_io_read_at_mapped(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	bool ret;
 	rz_return_val_if_fail (io && buf, false);
+	if (page_cache_read (io, addr, buf, len)) {
+		ret = true;
+		goto beach;
+	}
 	if (io->ff) {
 		memset (buf, io->Oxff, len);
 	}
@@ -309,6 +370,7 @@ RZ_API bool rz_io_read_at_mapped(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	} else {
 		ret = rz_io_pread_at (io, addr, buf, len) > 0;
 	}
+beach:
 	if (io->cached & RZ_PERM_R) {
 		(void)rz_io_cache_read(io, addr, buf, len);
 	}
@@ -324,7 +386,9 @@ RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	if (len == 0) {
 		return 0;
 	}
-	if (io->va) {
+	if (page_cache_read (io, addr, buf, len)) {
+		ret = len;
+	} else if (io->va) {
 		if (io->ff) {
 			memset (buf, io->Oxff, len);
 		}
@@ -393,6 +457,8 @@ RZ_API bool rz_io_is_listener(RzIO* io) {
 
 RZ_API char *rz_io_system(RzIO* io, const char* cmd) {
 	if (io && io->desc && io->desc->plugin && io->desc->plugin->system) {
+		// the command may change anything behind our back
+		rz_io_page_cache_flush (io);
 		return io->desc->plugin->system (io, io->desc, cmd);
 	}
 	return NULL;
@@ -533,6 +599,7 @@ RZ_API void rz_io_bind(RzIO *io, RzIOBind *bnd) {
 	bnd->map_get_paddr = rz_io_map_get_paddr;
 	bnd->addr_is_mapped = rz_io_addr_is_mapped;
 	bnd->map_add = rz_io_map_add;
+	bnd->page_cache_flush = rz_io_page_cache_flush;
 #if HAVE_PTRACE
 	bnd->ptrace = rz_io_ptrace;
 	bnd->ptrace_func = rz_io_ptrace_func;
@@ -668,6 +735,7 @@ RZ_API int rz_io_fini(RzIO* io) {
 	rz_io_map_fini (io);
 	ls_free (io->plugins);
 	rz_io_cache_fini (io);
+	rz_io_page_cache_fini (io);
 	rz_list_free (io->undo.w_list);
 	if (io->runprofile) {
 		RZ_FREE (io->runprofile);
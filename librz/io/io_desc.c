@@ -35,6 +35,9 @@ RZ_API void rz_io_desc_free(RzIODesc* desc) {
 		free (desc->referer);
 		free (desc->name);
 		rz_io_desc_cache_fini (desc);
+		if (desc->io) {
+			rz_io_page_cache_flush (desc->io);
+		}
 		if (desc->io && desc->io->files) {
 			rz_id_storage_delete (desc->io->files, desc->fd);
 		}
@@ -52,6 +55,7 @@ RZ_API bool rz_io_desc_add(RzIO* io, RzIODesc* desc) {
 		rz_sys_backtrace ();
 		return false;
 	}
+	rz_io_page_cache_flush (io);
 	return true;
 }
 
@@ -182,6 +186,9 @@ RZ_API int rz_io_desc_write(RzIODesc *desc, const ut8* buf, int len) {
 	if (len < 0) {
 		return -1;
 	}
+	if (desc->io) {
+		rz_io_page_cache_flush (desc->io);
+	}
 	//check pointers and pcache
 	if (desc->io && (desc->io->p_cache & 2)) {
 		return rz_io_desc_cache_write (desc,
@@ -232,6 +239,9 @@ RZ_API ut64 rz_io_desc_size(RzIODesc* desc) {
 RZ_API bool rz_io_desc_resize(RzIODesc *desc, ut64 newsize) {
 	if (desc && desc->plugin && desc->plugin->resize) {
 		bool ret = desc->plugin->resize (desc->io, desc, newsize);
+		if (desc->io) {
+			rz_io_page_cache_flush (desc->io);
+		}
 		if (desc->io && desc->io->p_cache) {
 			rz_io_desc_cache_cleanup (desc);
 		}
@@ -263,6 +273,7 @@ RZ_API bool rz_io_desc_exchange(RzIO* io, int fd, int fdx) {
 	descx->fd = fd;
 	rz_id_storage_set (io->files, desc,  fdx);
 	rz_id_storage_set (io->files, descx, fd);
+	rz_io_page_cache_flush (io);
 	if (io->p_cache) {
 		HtUP* cache = desc->cache;
 		desc->cache = descx->cache;
@@ -346,6 +357,9 @@ RZ_API int rz_io_desc_write_at(RzIODesc *desc, ut64 addr, const ut8 *buf, int le
 
 RZ_API int rz_io_desc_extend(RzIODesc *desc, ut64 size) {
 	if (desc && desc->plugin && desc->plugin->extend) {
+		if (desc->io) {
+			rz_io_page_cache_flush (desc->io);
+		}
 		return desc->plugin->extend (desc->io, desc, size);
 	}
 	return 0;
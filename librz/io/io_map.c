@@ -11,6 +11,7 @@
 
 // Store map parts that are not covered by others into io->map_skyline
 void io_map_calculate_skyline(RzIO *io) {
+	rz_io_page_cache_flush (io);
 	rz_skyline_clear (&io->map_skyline);
 	// Last map has highest priority (it shadows previous maps)
 	void **it;
@@ -43,6 +44,7 @@ RzIOMap* io_map_new(RzIO* io, int fd, int perm, ut64 delta, ut64 addr, ut64 size
 	// new map lives on the top, being top the list's tail
 	rz_pvector_push (&io->maps, map);
 	rz_skyline_add (&io->map_skyline, map->itv, map);
+	rz_io_page_cache_flush (io);
 	return map;
 }
 
@@ -310,6 +312,7 @@ RZ_API void rz_io_map_cleanup(RzIO* io) {
 
 RZ_API void rz_io_map_fini(RzIO* io) {
 	rz_return_if_fail (io);
+	rz_io_page_cache_flush (io);
 	rz_pvector_clear (&io->maps);
 	rz_id_pool_free (io->map_ids);
 	io->map_ids = NULL;
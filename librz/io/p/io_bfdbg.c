@@ -204,6 +204,7 @@ RzIOPlugin rz_io_plugin_bfdbg = {
 	.check = __plugin_open,
 	.lseek = __lseek,
 	.write = __write,
+	.isvolatile = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
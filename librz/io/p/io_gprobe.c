@@ -1239,6 +1239,7 @@ RzIOPlugin rz_io_plugin_gprobe = {
 	.lseek = __lseek,
 	.write = __write,
 	.system = __system,
+	.isvolatile = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
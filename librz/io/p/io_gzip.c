@@ -6,102 +6,61 @@
 #include <stdlib.h>
 #include <sys/types.h>
 
+/* the decompressed data is only served through a checkpoint index of the
+ * stream until it is modified for the first time. The index is saved next
+ * to the file only if io.gzip.index is set, and reused when found there */
+#define GZIP_INDEX_EXT ".rzidx"
+
 typedef struct {
-	ut8 *buf;
-	ut32 size;
+	RzBuffer *b;
 	ut64 offset;
 } RzIOGzip;
 
-static inline ut32 _io_malloc_sz(RzIODesc *desc) {
-	if (!desc) {
-		return 0;
-	}
-	RzIOGzip *mal = (RzIOGzip*)desc->data;
-	return mal? mal->size: 0;
-}
-
-static inline void _io_malloc_set_sz(RzIODesc *desc, ut32 sz) {
-	if (!desc) {
-		return;
-	}
-	RzIOGzip *mal = (RzIOGzip*)desc->data;
-	if (mal) {
-		mal->size = sz;
-	}
-}
-
-static inline ut8* _io_malloc_buf(RzIODesc *desc) {
-	if (!desc) {
-		return NULL;
+/* writes need the whole data in memory */
+static bool gzip_materialize(RzIOGzip *gz) {
+	if (!gz->b->readonly) {
+		return true;
 	}
-	RzIOGzip *mal = (RzIOGzip*)desc->data;
-	return mal->buf;
-}
-
-
-static inline ut8* _io_malloc_set_buf(RzIODesc *desc, ut8* buf) {
-	if (!desc) {
-		return NULL;
-	}
-	RzIOGzip *mal = (RzIOGzip*)desc->data;
-	return mal->buf = buf;
-}
-
-static inline ut64 _io_malloc_off(RzIODesc *desc) {
-	if (!desc) {
-		return 0;
-	}
-	RzIOGzip *mal = (RzIOGzip*)desc->data;
-	return mal->offset;
-}
-
-static inline void _io_malloc_set_off(RzIODesc *desc, ut64 off) {
-	if (!desc) {
-		return;
+	RzBuffer *b = rz_buf_new_with_buf (gz->b);
+	if (!b) {
+		return false;
 	}
-	RzIOGzip *mal = (RzIOGzip*)desc->data;
-	mal->offset = off;
+	rz_buf_free (gz->b);
+	gz->b = b;
+	return true;
 }
 
 static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int count) {
 	if (!fd || !buf || count < 0 || !fd->data) {
 		return -1;
 	}
-	if (_io_malloc_off (fd) > _io_malloc_sz (fd)) {
+	RzIOGzip *gz = fd->data;
+	ut64 size = rz_buf_size (gz->b);
+	if (gz->offset > size) {
 		return -1;
 	}
-	if (_io_malloc_off (fd) + count > _io_malloc_sz (fd)) {
-		count -= (_io_malloc_off (fd) + count -_io_malloc_sz (fd));
+	if (gz->offset + count > size) {
+		count = size - gz->offset;
 	}
-	if (count > 0) {
-		memcpy (_io_malloc_buf (fd) + _io_malloc_off (fd), buf, count);
-		_io_malloc_set_off (fd, _io_malloc_off (fd) + count);
-		return count;
+	if (count > 0 && gzip_materialize (gz)) {
+		st64 r = rz_buf_write_at (gz->b, gz->offset, buf, count);
+		if (r > 0) {
+			gz->offset += r;
+		}
+		return r;
 	}
 	return -1;
 }
 
 static bool __resize(RzIO *io, RzIODesc *fd, ut64 count) {
-	ut8 * new_buf = NULL;
 	if (!fd || !fd->data || count == 0) {
 		return false;
 	}
-	ut32 mallocsz = _io_malloc_sz (fd);
-	if (_io_malloc_off (fd) > mallocsz) {
+	RzIOGzip *gz = fd->data;
+	if (gz->offset > rz_buf_size (gz->b)) {
 		return false;
 	}
-	new_buf = malloc (count);
-	if (!new_buf) {
-		return false;
-	}
-	memcpy (new_buf, _io_malloc_buf (fd), RZ_MIN (count, mallocsz));
-	if (count > mallocsz) {
-		memset (new_buf + mallocsz, 0, count - mallocsz);
-	}
-	free (_io_malloc_buf (fd));
-	_io_malloc_set_buf (fd, new_buf);
-	_io_malloc_set_sz (fd, count);
-	return true;
+	return gzip_materialize (gz) && rz_buf_resize (gz->b, count);
 }
 
 static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
@@ -109,26 +68,29 @@ static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	if (!fd || !fd->data) {
 		return -1;
 	}
-	ut32 mallocsz = _io_malloc_sz (fd);
-	if (_io_malloc_off (fd) > mallocsz) {
+	RzIOGzip *gz = fd->data;
+	if (gz->offset > rz_buf_size (gz->b)) {
 		return -1;
 	}
-	if (_io_malloc_off (fd) + count >= mallocsz) {
-		count = mallocsz - _io_malloc_off (fd);
+	st64 r = rz_buf_read_at (gz->b, gz->offset, buf, count);
+	if (r < 0) {
+		return -1;
 	}
-	memcpy (buf, _io_malloc_buf (fd) + _io_malloc_off (fd), count);
-	return count;
+	gz->offset += r;
+	return (int)r;
 }
 
 static int __close(RzIODesc *fd) {
-	RzIOGzip *riom;
+	RzIOGzip *gz;
 	if (!fd || !fd->data) {
 		return -1;
 	}
-	riom = fd->data;
-	RZ_FREE (riom->buf);
+	gz = fd->data;
+	if (!gz->b->readonly) {
+		eprintf ("TODO: Writing changes into gzipped files is not yet supported\n");
+	}
+	rz_buf_free (gz->b);
 	RZ_FREE (fd->data);
-	eprintf ("TODO: Writing changes into gzipped files is not yet supported\n");
 	return 0;
 }
 
@@ -137,19 +99,20 @@ static ut64 __lseek(RzIO* io, RzIODesc *fd, ut64 offset, int whence) {
 	if (!fd || !fd->data) {
 		return offset;
 	}
-	ut32 mallocsz = _io_malloc_sz (fd);
+	RzIOGzip *gz = fd->data;
+	ut64 size = rz_buf_size (gz->b);
 	switch (whence) {
 	case SEEK_SET:
-		rz_offset = (offset <= mallocsz) ? offset : mallocsz;
+		rz_offset = (offset <= size) ? offset : size;
 		break;
 	case SEEK_CUR:
-		rz_offset = (_io_malloc_off (fd) + offset <= mallocsz ) ? _io_malloc_off (fd) + offset : mallocsz;
+		rz_offset = (gz->offset + offset <= size) ? gz->offset + offset : size;
 		break;
 	case SEEK_END:
-		rz_offset = _io_malloc_sz (fd);
+		rz_offset = size;
 		break;
 	}
-	_io_malloc_set_off (fd, rz_offset);
+	gz->offset = rz_offset;
 	return rz_offset;
 }
 
@@ -157,24 +120,50 @@ static bool __plugin_open(RzIO *io, const char *pathname, bool many) {
 	return (!strncmp (pathname, "gzip://", 7));
 }
 
-static RzIODesc *__open(RzIO *io, const char *pathname, int rw, int mode) {
-	if (__plugin_open (io, pathname, 0)) {
-		RzIOGzip *mal = RZ_NEW0 (RzIOGzip);
-		if (!mal) {
-			return NULL;
-		}
-		size_t len;
-		ut8 *data = (ut8 *)rz_file_slurp (pathname+7, &len);	//memleak here?
-		int *size = (int*)&mal->size;
-		mal->buf = rz_inflate (data, (int)len, NULL, size);
-		if (mal->buf) {
-			return rz_io_desc_new (io, &rz_io_plugin_gzip, pathname, rw, mode, mal);
+static RzInflateIndex *gzip_index(RzBuffer *src, const char *file, bool save) {
+	char *index_file = rz_str_newf ("%s" GZIP_INDEX_EXT, file);
+	if (!index_file) {
+		return NULL;
+	}
+	RzInflateIndex *idx = rz_inflate_index_load (src, index_file);
+	if (!idx) {
+		idx = rz_inflate_index_new (src, false, RZ_INFLATE_INDEX_SPAN);
+		// small files are indexed faster than the index is written
+		if (save && idx && rz_inflate_index_count (idx) > 1) {
+			rz_inflate_index_save (idx, index_file);
 		}
-		free (data);
-		eprintf ("Cannot allocate (%s) %d byte(s)\n", pathname+9, mal->size);
-		free (mal);
 	}
-	return NULL;
+	free (index_file);
+	return idx;
+}
+
+static RzIODesc *__open(RzIO *io, const char *pathname, int rw, int mode) {
+	if (!__plugin_open (io, pathname, 0)) {
+		return NULL;
+	}
+	const char *file = pathname + 7;
+	RzBuffer *src = rz_buf_new_file (file, O_RDONLY, 0);
+	if (!src) {
+		eprintf ("Cannot open %s\n", file);
+		return NULL;
+	}
+	RzInflateIndex *idx = gzip_index (src, file, io->gzip_index);
+	rz_buf_free (src);
+	if (!idx) {
+		eprintf ("Cannot inflate %s\n", file);
+		return NULL;
+	}
+	RzIOGzip *gz = RZ_NEW0 (RzIOGzip);
+	if (!gz) {
+		rz_inflate_index_free (idx);
+		return NULL;
+	}
+	gz->b = rz_buf_new_with_inflate_index (idx);
+	if (!gz->b) {
+		free (gz);
+		return NULL;
+	}
+	return rz_io_desc_new (io, &rz_io_plugin_gzip, pathname, rw, mode, gz);
 }
 
 RzIOPlugin rz_io_plugin_gzip = {
@@ -137,6 +137,7 @@ RzIOPlugin rz_io_plugin_procpid = {
 	.lseek = __lseek,
 	.system = __system,
 	.write = __write,
+	.isvolatile = true,
 };
 
 #else
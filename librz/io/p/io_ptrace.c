@@ -14,11 +14,19 @@
 #include <sys/wait.h>
 #include <errno.h>
 
+#if __linux__ && !__ANDROID__
+#include <sys/uio.h>
+#define USE_PROCESS_VM 1
+#else
+#define USE_PROCESS_VM 0
+#endif
+
 typedef struct {
 	int pid;
 	int tid;
 	int fd;
 	int opid;
+	bool use_vm; // process_vm_readv/writev before falling back to ptrace
 } RzIOPtrace;
 #define RzIOPTRACE_OPID(x) (((RzIOPtrace*)(x)->data)->opid)
 #define RzIOPTRACE_PID(x) (((RzIOPtrace*)(x)->data)->pid)
@@ -79,6 +87,19 @@ static int debug_os_read_at(RzIO *io, int pid, ut32 *buf, int sz, ut64 addr) {
 	return sz;
 }
 
+#if USE_PROCESS_VM
+// copies as much as possible in a single syscall, it stops at the first page
+// that is unmapped or, unlike with ptrace, not accessible with its protection
+static int process_vm_rw(int pid, ut8 *buf, int len, ut64 addr, bool write) {
+	struct iovec local = { buf, len };
+	struct iovec remote = { (void *)(size_t)addr, len };
+	ssize_t r = write
+		? process_vm_writev (pid, &local, 1, &remote, 1, 0)
+		: process_vm_readv (pid, &local, 1, &remote, 1, 0);
+	return r > 0 ? (int)r : 0;
+}
+#endif
+
 static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
 #if USE_PROC_PID_MEM
 	int ret, fd;
@@ -87,6 +108,18 @@ static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
 	if (!desc || !desc->data) {
 		return -1;
 	}
+	int done = 0;
+#if USE_PROCESS_VM
+	if (((RzIOPtrace *)desc->data)->use_vm && len > 0 && addr != UT64_MAX) {
+		done = process_vm_rw (RzIOPTRACE_PID (desc), buf, len, addr, false);
+		if (done == len) {
+			return len;
+		}
+		buf += done;
+		addr += done;
+		len -= done;
+	}
+#endif
 	memset (buf, '\xff', len); // TODO: only memset the non-readed bytes
 	/* reopen procpidmem if necessary */
 #if USE_PROC_PID_MEM
@@ -115,7 +148,7 @@ static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
 		int res = debug_os_read_at (io, RzIOPTRACE_PID (desc), (ut32*)aligned_buf, len, addr);
 		memcpy (buf, aligned_buf, len);
 		rz_free_aligned (aligned_buf);
-		return res;
+		return res < 0 ? res : done + res;
 	}
 	return -1;
 }
@@ -149,7 +182,19 @@ static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int len) {
 	if (!fd || !fd->data) {
 		return -1;
 	}
-	return ptrace_write_at (io, RzIOPTRACE_PID (fd), buf, len, io->off);
+	ut64 addr = io->off;
+	int done = 0;
+#if USE_PROCESS_VM
+	// read-only pages, e.g. code getting breakpoints, are left to ptrace
+	if (((RzIOPtrace *)fd->data)->use_vm && len > 0 && addr != UT64_MAX) {
+		done = process_vm_rw (RzIOPTRACE_PID (fd), (ut8 *)buf, len, addr, true);
+		if (done == len) {
+			return len;
+		}
+	}
+#endif
+	int res = ptrace_write_at (io, RzIOPTRACE_PID (fd), buf + done, len - done, addr + done);
+	return res < 0 ? res : done + res;
 }
 
 static void open_pidmem (RzIOPtrace *iop) {
@@ -250,6 +295,7 @@ static RzIODesc *__open(RzIO *io, const char *file, int rw, int mode) {
 	}
 
 	riop->pid = riop->tid = pid;
+	riop->use_vm = USE_PROCESS_VM;
 	open_pidmem (riop);
 	desc = rz_io_desc_new (io, &rz_io_plugin_ptrace, file, rw | RZ_PERM_X, mode, riop);
 	desc->name = rz_sys_pid_to_path (pid);
@@ -303,15 +349,20 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 		eprintf ("Usage: =!cmd args\n"
 			" =!ptrace   - use ptrace io\n"
 			" =!mem      - use /proc/pid/mem io if possible\n"
+			" =!vm       - use process_vm_readv/writev io if possible\n"
 			" =!pid      - show targeted pid\n"
 			" =!pid <#>  - select new pid\n");
 	} else
 	if (!strcmp (cmd, "ptrace")) {
 		close_pidmem (iop);
+		iop->use_vm = false;
 	} else
 	if (!strcmp (cmd, "mem")) {
 		open_pidmem (iop);
 	} else
+	if (!strcmp (cmd, "vm")) {
+		iop->use_vm = USE_PROCESS_VM;
+	} else
 	if (!strncmp (cmd, "pid", 3)) {
 		if (iop) {
 			if (cmd[3] == ' ') {
@@ -343,7 +394,7 @@ static int __getpid (RzIODesc *fd) {
 // TODO: rename ptrace to io_ptrace .. err io.ptrace ??
 RzIOPlugin rz_io_plugin_ptrace = {
 	.name = "ptrace",
-	.desc = "Ptrace and /proc/pid/mem (if available) io plugin",
+	.desc = "Ptrace, process_vm and /proc/pid/mem (if available) io plugin",
 	.license = "LGPL3",
 	.uris = "ptrace://,attach://",
 	.open = __open,
@@ -144,6 +144,7 @@ RzIOPlugin rz_io_plugin_rzk = {
 	.lseek = rzk__lseek,
 	.system = rzk__system,
 	.write = rzk__write,
+	.isvolatile = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -188,7 +188,8 @@ RzIOPlugin rz_io_plugin_rzpipe = {
 	.check = __check,
 	.lseek = __lseek,
 	.write = __write,
-	.system = __system
+	.system = __system,
+	.isvolatile = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -163,6 +163,7 @@ RzIOPlugin rz_io_plugin_rzweb = {
 	.lseek = __lseek,
 	.system = __system,
 	.write = __write,
+	.isvolatile = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
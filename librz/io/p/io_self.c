@@ -501,6 +501,7 @@ RzIOPlugin rz_io_plugin_self = {
 	.lseek = __lseek,
 	.system = __system,
 	.write = __write,
+	.isvolatile = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
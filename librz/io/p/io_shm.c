@@ -139,6 +139,7 @@ RzIOPlugin rz_io_plugin_shm = {
 	.check = shm__plugin_open,
 	.lseek = shm__lseek,
 	.write = shm__write,
+	.isvolatile = true,
 };
 
 #else
@@ -84,6 +84,7 @@ RzIOPlugin rz_io_plugin_w32 = {
 	.lseek = w32__lseek,
 	.system = w32__system,
 	.write = w32__write,
+	.isvolatile = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -118,6 +118,96 @@ struct zip *rz_io_zip_open_archive(const char *archivename, ut32 perm, int mode,
 	return NULL;
 }
 
+/* libzip does not tell where the data of an entry is, so walk the central
+ * directory to its local header. Zip64 archives are left to libzip. */
+static ut64 rz_io_zip_entry_data_offset(RzBuffer *arch, struct zip_stat *sb) {
+	ut64 size = rz_buf_size (arch);
+	// the end of central directory record is followed by a comment of up to 64K
+	ut64 tail_size = RZ_MIN (size, 0xffff + 22);
+	ut8 *tail = malloc (tail_size);
+	if (!tail || tail_size < 22 || rz_buf_read_at (arch, size - tail_size, tail, tail_size) != (st64)tail_size) {
+		free (tail);
+		return UT64_MAX;
+	}
+	const ut8 *eocd = NULL;
+	ut64 i;
+	for (i = tail_size - 22 + 1; i > 0; i--) {
+		if (!memcmp (tail + i - 1, "PK\x05\x06", 4)) {
+			eocd = tail + i - 1;
+			break;
+		}
+	}
+	ut16 entries = eocd? rz_read_le16 (eocd + 10): 0;
+	ut32 cd_size = eocd? rz_read_le32 (eocd + 12): 0;
+	ut32 cd_off = eocd? rz_read_le32 (eocd + 16): UT32_MAX;
+	free (tail);
+	if (entries == UT16_MAX || cd_off == UT32_MAX || sb->index >= entries || (ut64)cd_off + cd_size > size) {
+		return UT64_MAX;
+	}
+	ut8 *cd = malloc (cd_size);
+	if (!cd || rz_buf_read_at (arch, cd_off, cd, cd_size) != cd_size) {
+		free (cd);
+		return UT64_MAX;
+	}
+	ut64 ret = UT64_MAX, local = UT64_MAX;
+	ut32 off = 0;
+	for (i = 0; i <= sb->index; i++) {
+		if (cd_size - off < 46 || memcmp (cd + off, "PK\x01\x02", 4)) {
+			goto beach;
+		}
+		ut16 name_len = rz_read_le16 (cd + off + 28);
+		ut32 next = 46 + name_len + rz_read_le16 (cd + off + 30) + rz_read_le16 (cd + off + 32);
+		if (cd_size - off < next) {
+			goto beach;
+		}
+		if (i == sb->index && name_len == strlen (sb->name) && !memcmp (cd + off + 46, sb->name, name_len)) {
+			local = rz_read_le32 (cd + off + 42);
+		}
+		off += next;
+	}
+	ut8 lh[30];
+	if (local != UT64_MAX && rz_buf_read_at (arch, local, lh, sizeof (lh)) == sizeof (lh) && !memcmp (lh, "PK\x03\x04", 4)) {
+		ut64 data = local + sizeof (lh) + rz_read_le16 (lh + 26) + rz_read_le16 (lh + 28);
+		if (data + sb->comp_size <= size) {
+			ret = data;
+		}
+	}
+beach:
+	free (cd);
+	return ret;
+}
+
+/* stored entries are read straight from the archive, deflated ones through
+ * a checkpoint index, so that big entries are not inflated in memory */
+static RzBuffer *rz_io_zip_map_file(const char *archivename, struct zip_stat *sb) {
+	const zip_uint64_t need = ZIP_STAT_INDEX | ZIP_STAT_NAME | ZIP_STAT_SIZE | ZIP_STAT_COMP_SIZE | ZIP_STAT_COMP_METHOD | ZIP_STAT_ENCRYPTION_METHOD;
+	if ((sb->valid & need) != need || sb->encryption_method != ZIP_EM_NONE
+		|| (sb->comp_method != ZIP_CM_STORE && sb->comp_method != ZIP_CM_DEFLATE)
+		|| (sb->comp_method == ZIP_CM_STORE && sb->comp_size != sb->size)) {
+		return NULL;
+	}
+	RzBuffer *arch = rz_buf_new_file (archivename, O_RDONLY, 0);
+	if (!arch) {
+		return NULL;
+	}
+	RzBuffer *data = NULL;
+	ut64 off = rz_io_zip_entry_data_offset (arch, sb);
+	if (off != UT64_MAX) {
+		data = rz_buf_new_slice (arch, off, sb->comp_size);
+	}
+	rz_buf_free (arch);
+	if (!data || sb->comp_method == ZIP_CM_STORE) {
+		return data;
+	}
+	RzInflateIndex *idx = rz_inflate_index_new (data, true, RZ_INFLATE_INDEX_SPAN);
+	rz_buf_free (data);
+	if (!idx || rz_inflate_index_size (idx) != sb->size) {
+		rz_inflate_index_free (idx);
+		return NULL;
+	}
+	return rz_buf_new_with_inflate_index (idx);
+}
+
 static int rz_io_zip_slurp_file(RzIOZipFileObj *zfo) {
 	struct zip_file *zFile = NULL;
 	struct zip *zipArch;
@@ -131,6 +221,17 @@ static int rz_io_zip_slurp_file(RzIOZipFileObj *zfo) {
 		zfo->mode, zfo->rw);
 
 	if (zipArch && zfo && zfo->entry != -1) {
+		zip_stat_init (&sb);
+		if (!zip_stat_index (zipArch, zfo->entry, 0, &sb)) {
+			RzBuffer *b = rz_io_zip_map_file (zfo->archivename, &sb);
+			if (b) {
+				rz_buf_free (zfo->b);
+				zfo->b = b;
+				zfo->opened = true;
+				zip_close (zipArch);
+				return true;
+			}
+		}
 		zFile = zip_fopen_index (zipArch, zfo->entry, 0);
 		if (!zfo->b) {
 			zfo->b = rz_buf_new ();
@@ -559,6 +660,22 @@ static int rz_io_zip_read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	return r;
 }
 
+/* entries mapped from the archive are copied to memory on the first change */
+static bool rz_io_zip_own_buf(RzIOZipFileObj *zfo) {
+	if (!zfo->b->readonly) {
+		return true;
+	}
+	ut64 cur = rz_buf_tell (zfo->b);
+	RzBuffer *b = rz_buf_new_with_buf (zfo->b);
+	if (!b) {
+		return false;
+	}
+	rz_buf_free (zfo->b);
+	zfo->b = b;
+	rz_buf_seek (zfo->b, cur, RZ_BUF_SET);
+	return true;
+}
+
 static int rz_io_zip_realloc_buf(RzIOZipFileObj *zfo, int count) {
 	return rz_buf_resize (zfo->b, rz_buf_tell (zfo->b) + count);
 }
@@ -573,7 +690,7 @@ static bool rz_io_zip_resize(RzIO *io, RzIODesc *fd, ut64 size) {
 		return false;
 	}
 	zfo = fd->data;
-	if (rz_io_zip_truncate_buf (zfo, size)) {
+	if (rz_io_zip_own_buf (zfo) && rz_io_zip_truncate_buf (zfo, size)) {
 		zfo->modified = 1;
 		rz_io_zip_flush_file (zfo);
 		return true;
@@ -588,7 +705,7 @@ static int rz_io_zip_write(RzIO *io, RzIODesc *fd, const ut8 *buf, int count) {
 		return -1;
 	}
 	zfo = fd->data;
-	if (!(zfo->perm & RZ_PERM_W)) {
+	if (!(zfo->perm & RZ_PERM_W) || !rz_io_zip_own_buf (zfo)) {
 		return -1;
 	}
 	if (rz_buf_tell (zfo->b) + count >= rz_buf_size (zfo->b)) {
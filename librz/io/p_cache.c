@@ -360,5 +360,6 @@ RZ_API void rz_io_desc_cache_fini(RzIODesc *desc) {
 RZ_API void rz_io_desc_cache_fini_all(RzIO *io) {
 	if (io && io->files) {
 		rz_id_storage_foreach (io->files, __desc_fini_cb, NULL);
+		rz_io_page_cache_flush (io);
 	}
 }
@@ -0,0 +1,247 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_io.h>
+
+/* LRU of fixed size pages read from the backends.
+ *
+ * Pages hold the data before the io.cache overlay is applied, so
+ * rz_io_cache_write() never makes them stale. Anything else that changes
+ * what a read returns (backend writes, map or desc changes, io.va...)
+ * flushes the whole cache. Nothing is cached while a desc whose memory
+ * can change on its own (live processes, shared memory...) is open. The
+ * memory of debugger descs only changes while their target runs, so they
+ * are cached as long as a debugger flushes the cache when it stops.
+ *
+ * Every operation takes the cache lock, since read-only tasks read in
+ * parallel, and data is copied out under it.
+ */
+
+typedef struct rz_io_page_t {
+	ut64 addr;
+	ut32 size; // readable prefix of the page
+	struct rz_io_page_t *prev;
+	struct rz_io_page_t *next;
+	ut8 data[];
+} RzIOPage;
+
+static void page_unlink(RzIOPageCache *pc, RzIOPage *page) {
+	if (page->prev) {
+		page->prev->next = page->next;
+	} else {
+		pc->head = page->next;
+	}
+	if (page->next) {
+		page->next->prev = page->prev;
+	} else {
+		pc->tail = page->prev;
+	}
+	page->prev = page->next = NULL;
+}
+
+static void page_push_front(RzIOPageCache *pc, RzIOPage *page) {
+	page->prev = NULL;
+	page->next = pc->head;
+	if (pc->head) {
+		pc->head->prev = page;
+	} else {
+		pc->tail = page;
+	}
+	pc->head = page;
+}
+
+static void page_evict(RzIOPageCache *pc) {
+	RzIOPage *page = pc->tail;
+	page_unlink (pc, page);
+	ht_up_delete (pc->pages, page->addr);
+	pc->count--;
+	free (page);
+}
+
+static void cache_lock(RzIOPageCache *pc) {
+	if (pc->lock) {
+		rz_th_lock_enter (pc->lock);
+	}
+}
+
+static void cache_unlock(RzIOPageCache *pc) {
+	if (pc->lock) {
+		rz_th_lock_leave (pc->lock);
+	}
+}
+
+RZ_API void rz_io_page_cache_init(RzIO *io) {
+	rz_return_if_fail (io);
+	memset (&io->page_cache, 0, sizeof (io->page_cache));
+	io->page_cache.capacity = RZ_IO_PAGE_CACHE_PAGES;
+	io->page_cache.page_size = RZ_IO_PAGE_CACHE_PAGESIZE;
+	io->page_cache.volatile_descs = -1;
+	io->page_cache.lock = rz_th_lock_new (true);
+}
+
+RZ_API void rz_io_page_cache_fini(RzIO *io) {
+	rz_return_if_fail (io);
+	rz_io_page_cache_flush (io);
+	rz_th_lock_free (io->page_cache.lock);
+	io->page_cache.lock = NULL;
+}
+
+/**
+ * \brief Drop every cached page, the hit/miss counters are kept
+ */
+RZ_API void rz_io_page_cache_flush(RzIO *io) {
+	rz_return_if_fail (io);
+	RzIOPageCache *pc = &io->page_cache;
+	cache_lock (pc);
+	RzIOPage *page = pc->head;
+	while (page) {
+		RzIOPage *next = page->next;
+		free (page);
+		page = next;
+	}
+	ht_up_free (pc->pages);
+	pc->pages = NULL;
+	pc->head = pc->tail = NULL;
+	pc->count = 0;
+	// descs are opened and closed through here, count them again
+	pc->volatile_descs = -1;
+	cache_unlock (pc);
+}
+
+/**
+ * \brief Change the number of cached pages and their size
+ *
+ * \p page_size must be a power of two, a \p capacity of 0 disables the cache.
+ */
+RZ_API bool rz_io_page_cache_resize(RzIO *io, ut32 capacity, ut32 page_size) {
+	rz_return_val_if_fail (io, false);
+	RzIOPageCache *pc = &io->page_cache;
+	if (page_size < 0x10 || (page_size & (page_size - 1))) {
+		return false;
+	}
+	cache_lock (pc);
+	if (page_size != pc->page_size || !capacity) {
+		rz_io_page_cache_flush (io);
+	}
+	pc->capacity = capacity;
+	pc->page_size = page_size;
+	while (pc->count > pc->capacity) {
+		page_evict (pc);
+	}
+	cache_unlock (pc);
+	return true;
+}
+
+static bool count_volatile_cb(void *user, void *data, ut32 id) {
+	RzIOPageCache *pc = user;
+	RzIODesc *desc = data;
+	if (desc && desc->plugin && (desc->plugin->isvolatile || (desc->plugin->isdbg && !pc->dbg_flush))) {
+		pc->volatile_descs++;
+	}
+	return true;
+}
+
+/**
+ * \brief Tell whether reads can go through the page cache
+ *
+ * The cache is skipped while any open desc comes from a plugin whose
+ * memory changes without rz_io writes, e.g. a live process, or from a
+ * debugger plugin unless RzIOPageCache.dbg_flush is set.
+ */
+RZ_API bool rz_io_page_cache_enabled(RzIO *io) {
+	rz_return_val_if_fail (io, false);
+	RzIOPageCache *pc = &io->page_cache;
+	cache_lock (pc);
+	if (pc->volatile_descs < 0) {
+		pc->volatile_descs = 0;
+		if (io->files) {
+			rz_id_storage_foreach (io->files, count_volatile_cb, pc);
+		}
+	}
+	bool ret = pc->capacity && !pc->volatile_descs;
+	cache_unlock (pc);
+	return ret;
+}
+
+static void check_state(RzIO *io) {
+	RzIOPageCache *pc = &io->page_cache;
+	if (pc->va != io->va || pc->p_cache != io->p_cache || (!io->va && pc->desc != io->desc)) {
+		rz_io_page_cache_flush (io);
+		pc->va = io->va;
+		pc->p_cache = io->p_cache;
+		pc->desc = io->desc;
+	}
+}
+
+/**
+ * \brief Copy \p len bytes at offset \p off of the cached page starting at \p page
+ *
+ * \return the size of the readable prefix of the page, 0 if it is not
+ * cached. Nothing is copied if the prefix ends before \p off + \p len.
+ */
+RZ_API ut32 rz_io_page_cache_get(RzIO *io, ut64 page, ut32 off, ut8 *buf, ut32 len) {
+	rz_return_val_if_fail (io && buf, 0);
+	RzIOPageCache *pc = &io->page_cache;
+	cache_lock (pc);
+	check_state (io);
+	RzIOPage *p = pc->pages? ht_up_find (pc->pages, page, NULL): NULL;
+	if (!p) {
+		pc->misses++;
+		cache_unlock (pc);
+		return 0;
+	}
+	if (pc->head != p) {
+		page_unlink (pc, p);
+		page_push_front (pc, p);
+	}
+	pc->hits++;
+	ut32 size = p->size;
+	if (off <= size && len <= size - off) {
+		memcpy (buf, p->data + off, len);
+	}
+	cache_unlock (pc);
+	return size;
+}
+
+/**
+ * \brief Store the first \p size readable bytes of the page starting at \p page
+ */
+RZ_API bool rz_io_page_cache_put(RzIO *io, ut64 page, const ut8 *data, ut32 size) {
+	rz_return_val_if_fail (io && data, false);
+	RzIOPageCache *pc = &io->page_cache;
+	cache_lock (pc);
+	if (!pc->capacity || !size || size > pc->page_size) {
+		cache_unlock (pc);
+		return false;
+	}
+	check_state (io);
+	if (!pc->pages && !(pc->pages = ht_up_new0 ())) {
+		cache_unlock (pc);
+		return false;
+	}
+	RzIOPage *p = ht_up_find (pc->pages, page, NULL);
+	if (!p) {
+		if (pc->count >= pc->capacity) {
+			page_evict (pc);
+		}
+		p = malloc (sizeof (RzIOPage) + pc->page_size);
+		if (!p) {
+			cache_unlock (pc);
+			return false;
+		}
+		p->addr = page;
+		p->prev = p->next = NULL;
+		if (!ht_up_insert (pc->pages, page, p)) {
+			free (p);
+			cache_unlock (pc);
+			return false;
+		}
+		pc->count++;
+	} else {
+		page_unlink (pc, p);
+	}
+	memcpy (p->data, data, size);
+	p->size = size;
+	page_push_front (pc, p);
+	cache_unlock (pc);
+	return true;
+}
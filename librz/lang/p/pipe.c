@@ -164,6 +164,10 @@ static int lang_pipe_run(RzLang *lang, const char *code, int len) {
 		perror ("pipe run");
 	} else if (!child) {
 		/* children */
+		// rzpipe clients may switch to length prefixed frames over these pipes
+		char *token = rzpipe_framed_token (output[1]);
+		rz_sys_setenv ("RZ_PIPE_FRAMED", token);
+		free (token);
 		rz_sandbox_system (code, 1);
 		(void) write (input[1], "", 1);
 		close (input[0]);
@@ -180,14 +184,42 @@ static int lang_pipe_run(RzLang *lang, const char *code, int len) {
 		/* Close pipe ends not required in the parent */
 		close (output[1]);
 		close (input[0]);
+		bool first = true, framed = false;
 		rz_cons_break_push (NULL, NULL);
 		for (;;) {
 			if (rz_cons_is_breaked ()) {
 				break;
 			}
+			if (framed) {
+				void *bed = rz_cons_sleep_begin ();
+				char *cmd = (char *)rzpipe_read_frame (output[0], NULL);
+				rz_cons_sleep_end (bed);
+				if (!cmd) {
+					break;
+				}
+				res = lang->cmd_str ((RzCore*)lang->user, cmd);
+				free (cmd);
+				bool ok = rzpipe_write_frame (input[1], (const ut8 *)(res? res: ""), res? strlen (res): 0);
+				free (res);
+				if (!ok) {
+					break;
+				}
+				continue;
+			}
 			memset (buf, 0, sizeof (buf));
 			void *bed = rz_cons_sleep_begin ();
-			ret = read (output[0], buf, sizeof (buf) - 1);
+			// the first byte alone, a NUL tells that frames follow
+			ret = read (output[0], buf, first? 1: sizeof (buf) - 1);
+			if (first && ret == 1) {
+				first = false;
+				if (!buf[0]) {
+					rz_cons_sleep_end (bed);
+					framed = true;
+					continue;
+				}
+				int n = read (output[0], buf + 1, sizeof (buf) - 2);
+				ret += RZ_MAX (n, 0);
+			}
 			rz_cons_sleep_end (bed);
 			if (ret < 1) {
 				break;
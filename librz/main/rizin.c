@@ -287,6 +287,41 @@ static bool mustSaveHistory(RzConfig *c) {
 	return true;
 }
 
+// Run the commands of a framed rzpipe client until it goes away, see librz/socket/rzpipe.c
+static void rzpipe_serve(RzCore *r) {
+	// frames go to the pipe, whatever commands and the programs they
+	// spawn write to stdout goes to stderr instead of corrupting them
+	int out = dup (1);
+	if (out == -1 || dup2 (2, 1) == -1) {
+		eprintf ("Cannot redirect stdout for rzpipe\n");
+		if (out != -1) {
+			close (out);
+		}
+		return;
+	}
+#if __UNIX__
+	// nor is the pipe left open in them
+	fcntl (out, F_SETFD, FD_CLOEXEC);
+#endif
+	char *cmd;
+	while ((cmd = (char *)rzpipe_read_frame (0, NULL))) {
+		rz_cons_push ();
+		int ret = rz_core_cmd (r, cmd, 0);
+		free (cmd);
+		rz_cons_filter ();
+		const char *buf = rz_cons_get_buffer ();
+		size_t len = buf ? strlen (buf) : 0;
+		bool ok = rzpipe_write_frame (out, (const ut8 *)(buf ? buf : ""), (ut32)len);
+		rz_cons_pop ();
+		rz_cons_echo (NULL);
+		if (!ok || ret == RZ_CORE_CMD_EXIT) {
+			break;
+		}
+	}
+	dup2 (out, 1);
+	close (out);
+}
+
 // Try to set the correct scr.color for the current terminal.
 static void set_color_default(RzCore *r) {
 #ifdef __WINDOWS__
@@ -339,6 +374,7 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 	bool do_connect = false;
 	bool fullfile = false;
 	bool zerosep = false;
+	bool framed = false;
 	int help = 0;
 	enum { LOAD_BIN_ALL, LOAD_BIN_NOTHING, LOAD_BIN_STRUCTURES_ONLY } load_bin = LOAD_BIN_ALL;
 	bool run_rc = true;
@@ -1374,7 +1410,14 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 	}
 	if ((patchfile && !quiet) || !patchfile) {
 		if (zerosep) {
-			rz_cons_zero ();
+			framed = rzpipe_framed_requested (0);
+			if (framed) {
+				// not for the processes spawned from here
+				rz_sys_setenv ("RZ_PIPE_FRAMED", NULL);
+				(void)write (1, "\x01", 1);
+			} else {
+				rz_cons_zero ();
+			}
 		}
 		if (seek != UT64_MAX) {
 			rz_core_seek (r, seek, true);
@@ -1387,6 +1430,11 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 				rz_core_cmd0 (r, "aeip");
 			}
 		}
+		if (framed) {
+			rzpipe_serve (r);
+			ret = r->num->value;
+			goto beach;
+		}
 		for (;;) {
 			rz_core_prompt_loop (r);
 			ret = r->num->value;
@@ -457,7 +457,7 @@ static int show_help(int v) {
 			"  -u         unified output (---+++)\n"
 			"  -U         unified output using system 'diff'\n"
 			"  -v         show version information\n"
-			"  -V         be verbose (current only for -s)\n"
+			"  -V         be verbose (-s progress, -C timing and match report)\n"
 			"  -z         diff on extracted strings\n"
 			"  -Z         diff code comparing zignatures\n\n"
                        "Graph Output formats: (-m [mode])\n"
@@ -1153,6 +1153,9 @@ RZ_API int rz_main_rz_diff(int argc, const char **argv) {
 			} else {
 				rz_core_gdiff (c, c2);
 				rz_core_diff_show (c, c2);
+				if (verbose) {
+					rz_core_gdiff_report (c);
+				}
 			}
 		} else if (mode == MODE_DIFF_IMPORTS) {
 			int sz;
@@ -14,6 +14,7 @@ static ut64 to = 0LL;
 static bool incremental = true;
 static int iterations = 0;
 static int quiet = 0;
+static int threads = 0;
 static RzHashSeed s = {
 	0
 }, *_s = NULL;
@@ -138,10 +139,65 @@ static int do_hash_internal(RzHash *ctx, ut64 hash, const ut8 *buf, int len, int
 	return 1;
 }
 
+/* size of the reads feeding the incremental hashes */
+#define HASH_STREAM_BLOCK 0x100000
+/* upper bound of the reads split in blocks by -B */
+#define HASH_BLOCKS_CHUNK 0x1000000
+
+typedef struct {
+	ut64 algo;
+	ut64 at;
+	ut64 bsize;
+	ut64 fsize;
+	int rad;
+	int ule;
+} BlockPrint;
+
+static bool do_hash_block_print(void *user, ut64 idx, RzHash *ctx, int dlen) {
+	BlockPrint *bp = user;
+	from = bp->at + idx * bp->bsize;
+	to = RZ_MIN (from + bp->bsize, bp->fsize);
+	if (iterations > 0) {
+		rz_hash_do_spice (ctx, bp->algo, iterations, _s);
+	}
+	do_hash_print (ctx, bp->algo, dlen, bp->rad, bp->ule);
+	return true;
+}
+
+/* read [from, to) once, two buffers in turn, and feed all the algorithms */
+static RzHashStream *do_hash_stream(RzIO *io, ut64 algobit) {
+	RzHashStream *hs = rz_hash_stream_new (algobit, threads);
+	ut8 *bufs[2] = { malloc (HASH_STREAM_BLOCK), malloc (HASH_STREAM_BLOCK) };
+	if (!hs || !bufs[0] || !bufs[1]) {
+		rz_hash_stream_free (hs);
+		free (bufs[0]);
+		free (bufs[1]);
+		return NULL;
+	}
+	ut64 j;
+	int k = 0;
+	if (s.buf && s.prefix) {
+		rz_hash_stream_update (hs, s.buf, s.len);
+	}
+	for (j = from; j < to; j += HASH_STREAM_BLOCK, k ^= 1) {
+		ut64 len = RZ_MIN (HASH_STREAM_BLOCK, to - j);
+		rz_io_pread_at (io, j, bufs[k], len);
+		rz_hash_stream_update (hs, bufs[k], len);
+	}
+	if (s.buf && !s.prefix) {
+		rz_hash_stream_update (hs, s.buf, s.len);
+	}
+	rz_hash_stream_final (hs);
+	free (bufs[0]);
+	free (bufs[1]);
+	return hs;
+}
+
 static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int rad, int ule, const ut8 *compare) {
 	ut64 j, fsize, algobit = rz_hash_name_to_bits (algo);
-	RzHash *ctx;
-	ut8 *buf;
+	RzHashStream *hs = NULL;
+	RzHash *ctx, *res;
+	ut8 *buf = NULL;
 	int ret = 0;
 	ut64 i;
 	bool first = true;
@@ -171,35 +227,55 @@ static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int
 		eprintf ("rz-hash: Unknown file size\n");
 		return 1;
 	}
-	buf = calloc (1, bsize + 1);
-	if (!buf) {
-		return 1;
-	}
 	ctx = rz_hash_new (true, algobit);
+	res = ctx;
 
 	if (rad == 'j') {
 		printf ("[");
 	}
 	if (incremental) {
+		ut64 streamed = 0;
+		for (i = 1; i < RZ_HASH_ALL; i <<= 1) {
+			if ((algobit & i) && rz_hash_stream_supported (i)) {
+				streamed |= i;
+			}
+		}
+		if (streamed) {
+			hs = do_hash_stream (io, streamed);
+			if (!hs) {
+				ret = 1;
+				goto beach;
+			}
+		}
 		for (i = 1; i < RZ_HASH_ALL; i <<= 1) {
 			if (algobit & i) {
 				ut64 hashbit = i & algobit;
 				int dlen = rz_hash_size (hashbit);
-				rz_hash_do_begin (ctx, i);
-				if (s.buf && s.prefix) {
-					do_hash_internal (ctx, hashbit, s.buf, s.len, rad, 0, ule);
-				}
-				for (j = from; j < to; j += bsize) {
-					int len = ((j + bsize) > to)? (to - j): bsize;
-					rz_io_pread_at (io, j, buf, len);
-					do_hash_internal (ctx, hashbit, buf, len, rad, 0, ule);
-				}
-				if (s.buf && !s.prefix) {
-					do_hash_internal (ctx, hashbit, s.buf, s.len, rad, 0, ule);
+				RzHash *hctx = hs? rz_hash_stream_ctx (hs, i): NULL;
+				if (!hctx) {
+					// the one-shot algorithms need the whole block in memory
+					if (!buf && !(buf = calloc (1, bsize + 1))) {
+						ret = 1;
+						goto beach;
+					}
+					hctx = ctx;
+					rz_hash_do_begin (ctx, i);
+					if (s.buf && s.prefix) {
+						do_hash_internal (ctx, hashbit, s.buf, s.len, rad, 0, ule);
+					}
+					for (j = from; j < to; j += bsize) {
+						int len = ((j + bsize) > to)? (to - j): bsize;
+						rz_io_pread_at (io, j, buf, len);
+						do_hash_internal (ctx, hashbit, buf, len, rad, 0, ule);
+					}
+					if (s.buf && !s.prefix) {
+						do_hash_internal (ctx, hashbit, s.buf, s.len, rad, 0, ule);
+					}
+					rz_hash_do_end (ctx, i);
 				}
-				rz_hash_do_end (ctx, i);
+				res = hctx;
 				if (iterations > 0) {
-					rz_hash_do_spice (ctx, i, iterations, _s);
+					rz_hash_do_spice (hctx, i, iterations, _s);
 				}
 				if (!*rz_hash_name (i)) {
 					continue;
@@ -214,7 +290,7 @@ static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int
 				if (!quiet && rad != 'j') {
 					printf ("%s: ", file);
 				}
-				do_hash_print (ctx, i, dlen, quiet? 'n': rad, ule);
+				do_hash_print (hctx, i, dlen, quiet? 'n': rad, ule);
 				if (quiet == 1) {
 					printf (" %s\n", file);
 				} else {
@@ -232,23 +308,25 @@ static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int
 		if (s.buf) {
 			eprintf ("Warning: Seed ignored on per-block hashing.\n");
 		}
+		ut64 chunk = RZ_MAX (1, HASH_BLOCKS_CHUNK / bsize) * bsize;
+		buf = malloc (chunk);
+		if (!buf) {
+			ret = 1;
+			goto beach;
+		}
 		for (i = 1; i < RZ_HASH_ALL; i <<= 1) {
-			ut64 f, t, ofrom, oto;
+			ut64 ofrom, oto;
 			if (algobit & i) {
 				ut64 hashbit = i & algobit;
+				BlockPrint bp = { hashbit, 0, bsize, fsize, rad, ule };
 				ofrom = from;
 				oto = to;
-				f = from;
-				t = to;
-				for (j = f; j < t; j += bsize) {
-					int nsize = (j + bsize < fsize)? bsize: (fsize - j);
-					rz_io_pread_at (io, j, buf, bsize);
-					from = j;
-					to = j + bsize;
-					if (to > fsize) {
-						to = fsize;
-					}
-					do_hash_internal (ctx, hashbit, buf, nsize, rad, 1, ule);
+				// the blocks of a chunk are hashed in parallel and printed in order
+				for (j = ofrom; j < oto && j < fsize; j += chunk) {
+					ut64 len = RZ_MIN (RZ_MIN (chunk, fsize - j), (oto - j + bsize - 1) / bsize * bsize);
+					rz_io_pread_at (io, j, buf, len);
+					bp.at = j;
+					rz_hash_calculate_blocks (hashbit, buf, len, bsize, threads, do_hash_block_print, &bp);
 				}
 				do_hash_internal (ctx, hashbit, NULL, 0, rad, 1, ule);
 				from = ofrom;
@@ -260,7 +338,9 @@ static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int
 		printf ("]\n");
 	}
 
-	compare_hashes (ctx, compare, rz_hash_size (algobit), &ret);
+	compare_hashes (res, compare, rz_hash_size (algobit), &ret);
+beach:
+	rz_hash_stream_free (hs);
 	rz_hash_free (ctx);
 	free (buf);
 	return ret;
@@ -290,6 +370,7 @@ static int do_help(int line) {
 		" -r          output rizin commands\n"
 		" -s string   hash this string instead of files\n"
 		" -t to       stop hashing at given address\n"
+		" -T threads  number of threads to hash with (default is one per core)\n"
 		" -x hexstr   hash this hexpair string instead of files\n"
 		" -v          show version information\n");
 	return 0;
@@ -445,7 +526,7 @@ RZ_API int rz_main_rz_hash(int argc, const char **argv) {
 	RzIO *io;
 
 	RzGetopt opt;
-	rz_getopt_init (&opt, argc, argv, "p:jD:rveE:a:i:I:S:s:x:b:nBhf:t:kLqc:");
+	rz_getopt_init (&opt, argc, argv, "p:jD:rveE:a:i:I:S:s:x:b:nBhf:t:T:kLqc:");
 	while ((c = rz_getopt_next (&opt)) != -1) {
 		switch (c) {
 		case 'q': quiet++; break;
@@ -472,6 +553,7 @@ RZ_API int rz_main_rz_hash(int argc, const char **argv) {
 		case 'b': bsize = (int) rz_num_math (NULL, opt.arg); break;
 		case 'f': from = rz_num_math (NULL, opt.arg); break;
 		case 't': to = 1 + rz_num_math (NULL, opt.arg); break;
+		case 'T': threads = (int) rz_num_math (NULL, opt.arg); break;
 		case 'v': return rz_main_version_print ("rz_hash");
 		case 'h': return do_help (0);
 		case 's': setHashString (opt.arg, 0); break;
@@ -343,3 +343,69 @@ RZ_API void rz_reg_arena_shrink(RzReg *reg) {
 		}
 	}
 }
+
+static bool is_dirty(RzRegSet *rs) {
+	RzRegArena *a = rs->arena;
+	RzRegArena *s = rs->synced;
+	return a && (!s || s->size != a->size || memcmp (s->bytes, a->bytes, a->size));
+}
+
+/**
+ * \brief Get the register types whose contents changed since they were last
+ * transferred from or to the target, see rz_reg_dirty_clear()
+ *
+ * Types are compared to a copy of their arena, so changes made in any way
+ * count, including writing straight to the arena bytes.
+ *
+ * \return a mask of (1 << RzRegisterType)
+ */
+RZ_API int rz_reg_dirty_types(RzReg *reg) {
+	rz_return_val_if_fail (reg, 0);
+	int i, mask = 0;
+	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		if (is_dirty (&reg->regset[i])) {
+			mask |= 1 << i;
+		}
+	}
+	return mask;
+}
+
+/**
+ * \brief Record that the registers of \p type match the target now
+ *
+ * \param type a RzRegisterType or RZ_REG_TYPE_ALL
+ */
+RZ_API void rz_reg_dirty_clear(RzReg *reg, int type) {
+	rz_return_if_fail (reg);
+	int i = type == RZ_REG_TYPE_ALL ? 0 : type;
+	int e = type == RZ_REG_TYPE_ALL ? RZ_REG_TYPE_LAST : type + 1;
+	for (; i >= 0 && i < e; i++) {
+		RzRegSet *rs = &reg->regset[i];
+		if (!rs->arena || !rs->arena->bytes) {
+			continue;
+		}
+		if (!rs->synced || rs->synced->size != rs->arena->size) {
+			rz_reg_arena_free (rs->synced);
+			rs->synced = rz_reg_arena_new (rs->arena->size);
+			if (!rs->synced) {
+				continue;
+			}
+		}
+		memcpy (rs->synced->bytes, rs->arena->bytes, rs->arena->size);
+	}
+}
+
+/**
+ * \brief Forget what the target registers of \p type hold, e.g. because it ran
+ *
+ * \param type a RzRegisterType or RZ_REG_TYPE_ALL
+ */
+RZ_API void rz_reg_dirty_set(RzReg *reg, int type) {
+	rz_return_if_fail (reg);
+	int i = type == RZ_REG_TYPE_ALL ? 0 : type;
+	int e = type == RZ_REG_TYPE_ALL ? RZ_REG_TYPE_LAST : type + 1;
+	for (; i >= 0 && i < e; i++) {
+		rz_reg_arena_free (reg->regset[i].synced);
+		reg->regset[i].synced = NULL;
+	}
+}
@@ -164,6 +164,7 @@ RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 	rz_return_if_fail (reg);
 	ut32 i;
 
+	reg->profile_gen++;
 	rz_list_free (reg->roregs);
 	reg->roregs = NULL;
 	RZ_FREE (reg->reg_profile_str);
@@ -174,9 +175,15 @@ RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 			RZ_FREE (reg->name[i]);
 		}
 	}
+	ht_pp_free (reg->ht_all);
+	reg->ht_all = NULL;
+	RZ_FREE (reg->items);
+	reg->items_count = 0;
 	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
 		ht_pp_free (reg->regset[i].ht_regs);
 		reg->regset[i].ht_regs = NULL;
+		rz_reg_arena_free (reg->regset[i].synced);
+		reg->regset[i].synced = NULL;
 		if (!reg->regset[i].pool) {
 			continue;
 		}
@@ -213,35 +220,58 @@ RZ_API void rz_reg_reindex(RzReg *reg) {
 	RzListIter *iter;
 	RzRegItem *r;
 	RzList *all = rz_list_newf (NULL);
+	ht_pp_free (reg->ht_all);
+	reg->ht_all = ht_pp_new0 ();
 	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
 		rz_list_foreach (reg->regset[i].regs, iter, r) {
 			rz_list_append (all, r);
+			// like rz_reg_get() looking the types up in order, the first one wins
+			if (reg->ht_all) {
+				ht_pp_insert (reg->ht_all, r->name, r);
+			}
 		}
 	}
 	rz_list_sort (all, (RzListComparator)regcmp);
+	free (reg->items);
+	reg->items = RZ_NEWS (RzRegItem *, rz_list_length (all));
+	reg->items_count = 0;
 	index = 0;
 	rz_list_foreach (all, iter, r) {
+		if (reg->items) {
+			reg->items[index] = r;
+			reg->items_count++;
+		}
 		r->index = index++;
 	}
 	rz_list_free (reg->allregs);
 	reg->allregs = all;
 }
 
+/**
+ * \brief Get the register at \p idx, as in RzRegItem.index
+ *
+ * Indexes are stable until the profile changes, so they can be resolved once
+ * with rz_reg_index_of() and used instead of names in hot paths.
+ */
 RZ_API RzRegItem *rz_reg_index_get(RzReg *reg, int idx) {
-	RzRegItem *r;
-	RzListIter *iter;
 	if (idx < 0) {
 		return NULL;
 	}
 	if (!reg->allregs) {
 		rz_reg_reindex (reg);
 	}
-	rz_list_foreach (reg->allregs, iter, r) {
-		if (r->index == idx) {
-			return r;
-		}
-	}
-	return NULL;
+	return idx < reg->items_count ? reg->items[idx] : NULL;
+}
+
+/**
+ * \brief Resolve the register or role \p name to its index, see rz_reg_index_get()
+ *
+ * \return the index or -1 if there is no such register
+ */
+RZ_API int rz_reg_index_of(RzReg *reg, const char *name) {
+	rz_return_val_if_fail (reg && name, -1);
+	RzRegItem *item = rz_reg_get (reg, name, -1);
+	return item ? item->index : -1;
 }
 
 RZ_API void rz_reg_free(RzReg *reg) {
@@ -313,17 +343,20 @@ RZ_API RzRegItem *rz_reg_get(RzReg *reg, const char *name, int type) {
 	if (type == -1) {
 		i = 0;
 		e = RZ_REG_TYPE_LAST;
-		int alias = rz_reg_get_name_idx (name);
-		if (alias != -1) {
-			const char *nname = rz_reg_get_name (reg, alias);
-			if (nname) {
-				name = nname;
+		// only the two letter role names (PC, SP, A0...) can be aliases
+		if (name[0] && name[1] && !name[2]) {
+			int alias = rz_reg_get_name_idx (name);
+			if (alias != -1 && reg->name[alias]) {
+				name = reg->name[alias];
 			}
 		}
 	} else {
 		i = type;
 		e = type + 1;
 	}
+	if (type == -1 && reg->ht_all) {
+		return ht_pp_find (reg->ht_all, name, NULL);
+	}
 	for (; i < e; i++) {
 		HtPP *pp = reg->regset[i].ht_regs;
 		if (pp) {
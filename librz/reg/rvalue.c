@@ -12,6 +12,28 @@ static ut27 rz_read_me27(const ut8 *buf, int boff) {
 	return ret;
 }
 
+// byte aligned registers of 8 to 64 bits are accessed in place
+static ut8 *fast_ptr(RzReg *reg, RzRegItem *item) {
+	if (item->offset < 0 || item->offset & 7) {
+		return NULL;
+	}
+	switch (item->size) {
+	case 8:
+	case 16:
+	case 32:
+	case 64:
+		break;
+	default:
+		return NULL;
+	}
+	RzRegArena *arena = reg->regset[item->arena].arena;
+	int off = item->offset / 8;
+	if (!arena || !arena->bytes || off + item->size / 8 > arena->size) {
+		return NULL;
+	}
+	return arena->bytes + off;
+}
+
 RZ_API ut64 rz_reg_get_value_big(RzReg *reg, RzRegItem *item, utX *val) {
 	rz_return_val_if_fail (reg && item, 0);
 
@@ -72,6 +94,15 @@ RZ_API ut64 rz_reg_get_value(RzReg *reg, RzRegItem *item) {
 	if (!reg || !item || item->offset == -1) {
 		return 0LL;
 	}
+	ut8 *p = fast_ptr (reg, item);
+	if (p) {
+		switch (item->size) {
+		case 8: return *p;
+		case 16: return rz_read_ble16 (p, reg->big_endian);
+		case 32: return rz_read_ble32 (p, reg->big_endian);
+		default: return rz_read_ble64 (p, reg->big_endian);
+		}
+	}
 	int off = BITS2BYTES (item->offset);
 	RzRegSet *regset = &reg->regset[item->arena];
 	if (!regset->arena) {
@@ -135,6 +166,15 @@ RZ_API ut64 rz_reg_get_value(RzReg *reg, RzRegItem *item) {
 	return 0LL;
 }
 
+/**
+ * \brief Get the value of the register at \p idx, see rz_reg_index_of()
+ */
+RZ_API ut64 rz_reg_index_get_value(RzReg *reg, int idx) {
+	rz_return_val_if_fail (reg, 0);
+	RzRegItem *item = rz_reg_index_get (reg, idx);
+	return item ? rz_reg_get_value (reg, item) : 0;
+}
+
 RZ_API ut64 rz_reg_get_value_by_role(RzReg *reg, RzRegisterId role) {
 	// TODO use mapping from RzRegisterId to RzRegItem (via RzRegSet)
 	return rz_reg_get_value (reg, rz_reg_get (reg, rz_reg_get_name (reg, role), -1));
@@ -151,6 +191,16 @@ RZ_API bool rz_reg_set_value(RzReg *reg, RzRegItem *item, ut64 value) {
 	if (item->offset < 0) {
 		return true;
 	}
+	ut8 *p = fast_ptr (reg, item);
+	if (p) {
+		switch (item->size) {
+		case 8: *p = (ut8)value; break;
+		case 16: rz_write_ble16 (p, value, reg->big_endian); break;
+		case 32: rz_write_ble32 (p, value, reg->big_endian); break;
+		default: rz_write_ble64 (p, value, reg->big_endian); break;
+		}
+		return true;
+	}
 	RzRegArena *arena = reg->regset[item->arena].arena;
 	if (!arena) {
 		return false;
@@ -221,6 +271,15 @@ RZ_API bool rz_reg_set_value(RzReg *reg, RzRegItem *item, ut64 value) {
 	return false;
 }
 
+/**
+ * \brief Set the value of the register at \p idx, see rz_reg_index_of()
+ */
+RZ_API bool rz_reg_index_set_value(RzReg *reg, int idx, ut64 value) {
+	rz_return_val_if_fail (reg, false);
+	RzRegItem *item = rz_reg_index_get (reg, idx);
+	return item && rz_reg_set_value (reg, item, value);
+}
+
 RZ_API bool rz_reg_set_value_by_role(RzReg *reg, RzRegisterId role, ut64 val) {
 	// TODO use mapping from RzRegisterId to RzRegItem (via RzRegSet)
 	RzRegItem *r = rz_reg_get (reg, rz_reg_get_name (reg, role), -1);
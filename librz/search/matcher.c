@@ -0,0 +1,447 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <ctype.h>
+#include "search_private.h"
+
+/* Finds where the keywords of a search may start, in a single pass over
+ * the buffer whatever their number.
+ *
+ * Each keyword is reduced to an anchor: its longest run of bytes that the
+ * binmask keeps whole. Anchors are matched case-folded if any keyword
+ * ignores case, so the candidates are a superset of the real hits and the
+ * caller confirms them with the full comparison.
+ *
+ * A single anchor is searched for with a vectorized scan of its first two
+ * bytes. Otherwise anchors of 4 bytes or more are looked up by the hash of
+ * their first 4 bytes, which only costs a bit test per position and stays
+ * in cache for thousands of keywords, while the shorter ones go through an
+ * Aho-Corasick automaton, stored as a dense DFA over the classes of bytes
+ * that appear in them. */
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PAIR_X86 1
+#include <immintrin.h>
+#endif
+
+#define MAX_CELLS   (1 << 24)
+#define STATE_MATCH 0x80000000U
+#define PREFIX_LEN  4
+
+typedef struct {
+	ut32 off; // of the anchor in the keyword
+	ut32 len; // of the anchor, 0 if the keyword has none
+	ut32 kwlen;
+	ut32 prefix; // first bytes of the anchor, folded
+	st32 next; // next keyword with the same anchor, or hash
+} MatcherKeyword;
+
+typedef struct {
+	ut8 a[2]; // accepted values of the first byte
+	ut8 b[2]; // and of the second one, if len > 1
+	ut32 len;
+} MatcherPair;
+
+struct rz_search_matcher_t {
+	MatcherKeyword *kws;
+	ut32 n;
+	ut32 anchored;
+	ut32 single; // the keyword, if only one is anchored
+	MatcherPair pair;
+	bool icase; // whether any keyword is
+	ut8 fold[256];
+	// anchors of PREFIX_LEN bytes or more
+	ut32 nhashed;
+	ut32 hbits;
+	ut64 *bloom;
+	st32 *heads;
+	// shorter ones
+	ut32 nshort;
+	ut16 cls[256];
+	ut32 ncls;
+	ut32 *delta; // nstates * ncls, each entry is state * ncls | STATE_MATCH
+	st32 *out; // first keyword whose anchor ends at the state
+	ut32 *dict; // nearest suffix state with an output, 0 for none
+	ut32 nstates;
+};
+
+static ut32 anchor_of(RzSearchKeyword *kw, ut32 *off) {
+	if (!kw->binmask_length) {
+		*off = 0;
+		return kw->keyword_length;
+	}
+	ut32 j, run = 0, best = 0;
+	*off = 0;
+	for (j = 0; j < kw->keyword_length; j++) {
+		if (kw->bin_binmask[j % kw->binmask_length] != 0xff) {
+			run = 0;
+			continue;
+		}
+		if (++run > best) {
+			best = run;
+			*off = j + 1 - run;
+		}
+	}
+	return best;
+}
+
+static inline bool is_short(const MatcherKeyword *k) {
+	return k->len && k->len < PREFIX_LEN;
+}
+
+static bool build_automaton(RzSearchMatcher *m, RzList *kws) {
+	bool used[256] = { 0 };
+	ut64 total = 1;
+	ut32 i, j;
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+
+	i = 0;
+	rz_list_foreach (kws, iter, kw) {
+		MatcherKeyword *k = &m->kws[i++];
+		if (!is_short (k)) {
+			continue;
+		}
+		for (j = 0; j < k->len; j++) {
+			used[m->fold[kw->bin_keyword[k->off + j]]] = true;
+		}
+		total += k->len;
+	}
+	m->ncls = 1;
+	ut16 ids[256] = { 0 };
+	for (i = 0; i < 256; i++) {
+		if (used[i]) {
+			ids[i] = m->ncls++;
+		}
+	}
+	for (i = 0; i < 256; i++) {
+		m->cls[i] = ids[m->fold[i]];
+	}
+	if (total * m->ncls > MAX_CELLS) {
+		return false;
+	}
+	m->delta = calloc (total * m->ncls, sizeof (ut32));
+	m->out = malloc (total * sizeof (st32));
+	m->dict = calloc (total, sizeof (ut32));
+	ut32 *fail = calloc (total, sizeof (ut32));
+	ut32 *queue = malloc (total * sizeof (ut32));
+	if (!m->delta || !m->out || !m->dict || !fail || !queue) {
+		free (fail);
+		free (queue);
+		return false;
+	}
+	memset (m->out, 0xff, total * sizeof (st32));
+
+	// trie of the anchors, 0 is the root and never a child
+	m->nstates = 1;
+	i = 0;
+	rz_list_foreach (kws, iter, kw) {
+		MatcherKeyword *k = &m->kws[i];
+		if (is_short (k)) {
+			ut32 st = 0;
+			for (j = 0; j < k->len; j++) {
+				ut32 *next = &m->delta[st * m->ncls + m->cls[kw->bin_keyword[k->off + j]]];
+				if (!*next) {
+					*next = m->nstates++;
+				}
+				st = *next;
+			}
+			k->next = m->out[st];
+			m->out[st] = i;
+		}
+		i++;
+	}
+
+	// fail links in breadth first order, turning the trie into a DFA;
+	// the children of the root keep failing to it
+	ut32 head = 0, tail = 0, c;
+	for (c = 0; c < m->ncls; c++) {
+		if (m->delta[c]) {
+			queue[tail++] = m->delta[c];
+		}
+	}
+	while (head < tail) {
+		ut32 st = queue[head++];
+		ut32 *row = &m->delta[st * m->ncls];
+		const ut32 *frow = &m->delta[fail[st] * m->ncls];
+		for (c = 0; c < m->ncls; c++) {
+			if (row[c]) {
+				ut32 child = row[c];
+				fail[child] = frow[c];
+				m->dict[child] = m->out[fail[child]] >= 0 ? fail[child] : m->dict[fail[child]];
+				queue[tail++] = child;
+			} else {
+				row[c] = frow[c];
+			}
+		}
+	}
+	free (fail);
+	free (queue);
+
+	for (i = 0; i < m->nstates * m->ncls; i++) {
+		ut32 st = m->delta[i];
+		m->delta[i] = st * m->ncls | (m->out[st] >= 0 || m->dict[st] ? STATE_MATCH : 0);
+	}
+	return true;
+}
+
+static inline ut32 prefix_hash(const RzSearchMatcher *m, ut32 x) {
+	return (x * 0x9e3779b1U) >> (32 - m->hbits);
+}
+
+static inline ut32 read_prefix(const RzSearchMatcher *m, const ut8 *p) {
+	if (!m->icase) {
+		return rz_read_le32 (p);
+	}
+	return m->fold[p[0]] | (ut32)m->fold[p[1]] << 8 | (ut32)m->fold[p[2]] << 16 | (ut32)m->fold[p[3]] << 24;
+}
+
+static bool build_hash(RzSearchMatcher *m, RzList *kws) {
+	// about 64 slots per anchor keeps false positives rare
+	m->hbits = 16;
+	while (m->hbits < 20 && (1U << m->hbits) < m->nhashed * 64) {
+		m->hbits++;
+	}
+	m->bloom = calloc ((1U << m->hbits) / 64 + 1, sizeof (ut64));
+	m->heads = malloc ((1U << m->hbits) * sizeof (st32));
+	if (!m->bloom || !m->heads) {
+		return false;
+	}
+	memset (m->heads, 0xff, (1U << m->hbits) * sizeof (st32));
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	ut32 i = 0;
+	rz_list_foreach (kws, iter, kw) {
+		MatcherKeyword *k = &m->kws[i];
+		if (k->len >= PREFIX_LEN) {
+			k->prefix = read_prefix (m, kw->bin_keyword + k->off);
+			ut32 h = prefix_hash (m, k->prefix);
+			m->bloom[h / 64] |= 1ULL << (h % 64);
+			k->next = m->heads[h];
+			m->heads[h] = i;
+		}
+		i++;
+	}
+	return true;
+}
+
+static void pair_values(RzSearchKeyword *kw, ut8 b, ut8 v[2]) {
+	v[0] = v[1] = b;
+	if (kw->icase) {
+		v[0] = tolower (b);
+		v[1] = toupper (v[0]);
+	}
+}
+
+/**
+ * \brief Compile the keywords of a search, in list order
+ */
+RZ_IPI RzSearchMatcher *rz_search_matcher_new(RzList *kws) {
+	rz_return_val_if_fail (kws, NULL);
+	RzSearchMatcher *m = RZ_NEW0 (RzSearchMatcher);
+	if (!m) {
+		return NULL;
+	}
+	m->n = rz_list_length (kws);
+	m->kws = RZ_NEWS0 (MatcherKeyword, m->n + 1);
+	if (!m->kws) {
+		free (m);
+		return NULL;
+	}
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	ut32 i = 0;
+	rz_list_foreach (kws, iter, kw) {
+		MatcherKeyword *k = &m->kws[i];
+		k->len = anchor_of (kw, &k->off);
+		k->kwlen = kw->keyword_length;
+		k->next = -1;
+		if (k->len) {
+			m->anchored++;
+			m->single = i;
+			if (k->len >= PREFIX_LEN) {
+				m->nhashed++;
+			} else {
+				m->nshort++;
+			}
+		}
+		m->icase |= kw->icase;
+		i++;
+	}
+	for (i = 0; i < 256; i++) {
+		m->fold[i] = m->icase ? tolower (i) : i;
+	}
+	if (m->anchored == 1) {
+		MatcherKeyword *k = &m->kws[m->single];
+		kw = rz_list_get_n (kws, m->single);
+		m->pair.len = RZ_MIN (k->len, 2);
+		pair_values (kw, kw->bin_keyword[k->off], m->pair.a);
+		if (m->pair.len > 1) {
+			pair_values (kw, kw->bin_keyword[k->off + 1], m->pair.b);
+		}
+	} else if ((m->nhashed && !build_hash (m, kws)) || (m->nshort && !build_automaton (m, kws))) {
+		rz_search_matcher_free (m);
+		return NULL;
+	}
+	return m;
+}
+
+RZ_IPI void rz_search_matcher_free(RzSearchMatcher *m) {
+	if (!m) {
+		return;
+	}
+	free (m->kws);
+	free (m->delta);
+	free (m->out);
+	free (m->dict);
+	free (m->bloom);
+	free (m->heads);
+	free (m);
+}
+
+/**
+ * \brief Number of keywords the matcher was built from
+ */
+RZ_IPI ut32 rz_search_matcher_count(RzSearchMatcher *m) {
+	rz_return_val_if_fail (m, 0);
+	return m->n;
+}
+
+/**
+ * \brief Whether keyword \p idx is reported by rz_search_matcher_scan()
+ *
+ * Keywords without any byte kept whole by their binmask are not.
+ */
+RZ_IPI bool rz_search_matcher_anchored(RzSearchMatcher *m, ut32 idx) {
+	rz_return_val_if_fail (m && idx < m->n, false);
+	return m->kws[idx].len > 0;
+}
+
+static inline void report(RzSearchMatcher *m, ut32 idx, ut32 end, ut32 len, RzSearchMatcherCb cb, void *user) {
+	const MatcherKeyword *k = &m->kws[idx];
+	// end is one past the anchor
+	if (end < k->off + k->len) {
+		return;
+	}
+	ut32 pos = end - k->len - k->off;
+	if (k->kwlen <= len - pos) {
+		cb (user, idx, pos);
+	}
+}
+
+static inline bool pair_in(const ut8 v[2], ut8 b) {
+	return b == v[0] || b == v[1];
+}
+
+static ut32 pair_scalar(const MatcherPair *p, const ut8 *buf, ut32 len, ut32 i) {
+	for (; i + p->len <= len; i++) {
+		if (pair_in (p->a, buf[i]) && (p->len < 2 || pair_in (p->b, buf[i + 1]))) {
+			return i;
+		}
+	}
+	return len;
+}
+
+#if PAIR_X86
+static ut32 pair_sse2(const MatcherPair *p, const ut8 *buf, ut32 len, ut32 i) {
+	const __m128i a0 = _mm_set1_epi8 (p->a[0]), a1 = _mm_set1_epi8 (p->a[1]);
+	const __m128i b0 = _mm_set1_epi8 (p->b[0]), b1 = _mm_set1_epi8 (p->b[1]);
+	for (; i + 17 <= len; i += 16) {
+		__m128i x = _mm_loadu_si128 ((const __m128i *)(buf + i));
+		__m128i m = _mm_or_si128 (_mm_cmpeq_epi8 (x, a0), _mm_cmpeq_epi8 (x, a1));
+		if (p->len > 1) {
+			__m128i y = _mm_loadu_si128 ((const __m128i *)(buf + i + 1));
+			m = _mm_and_si128 (m, _mm_or_si128 (_mm_cmpeq_epi8 (y, b0), _mm_cmpeq_epi8 (y, b1)));
+		}
+		ut32 mask = (ut32)_mm_movemask_epi8 (m);
+		if (mask) {
+			return i + __builtin_ctz (mask);
+		}
+	}
+	return pair_scalar (p, buf, len, i);
+}
+
+__attribute__((target ("avx2")))
+static ut32 pair_avx2(const MatcherPair *p, const ut8 *buf, ut32 len, ut32 i) {
+	const __m256i a0 = _mm256_set1_epi8 (p->a[0]), a1 = _mm256_set1_epi8 (p->a[1]);
+	const __m256i b0 = _mm256_set1_epi8 (p->b[0]), b1 = _mm256_set1_epi8 (p->b[1]);
+	for (; i + 33 <= len; i += 32) {
+		__m256i x = _mm256_loadu_si256 ((const __m256i *)(buf + i));
+		__m256i m = _mm256_or_si256 (_mm256_cmpeq_epi8 (x, a0), _mm256_cmpeq_epi8 (x, a1));
+		if (p->len > 1) {
+			__m256i y = _mm256_loadu_si256 ((const __m256i *)(buf + i + 1));
+			m = _mm256_and_si256 (m, _mm256_or_si256 (_mm256_cmpeq_epi8 (y, b0), _mm256_cmpeq_epi8 (y, b1)));
+		}
+		ut32 mask = (ut32)_mm256_movemask_epi8 (m);
+		if (mask) {
+			return i + __builtin_ctz (mask);
+		}
+	}
+	return pair_sse2 (p, buf, len, i);
+}
+#endif
+
+static ut32 pair_next(const MatcherPair *p, const ut8 *buf, ut32 len, ut32 i) {
+#if PAIR_X86
+	static int has_avx2 = -1;
+	if (has_avx2 < 0) {
+		has_avx2 = __builtin_cpu_supports ("avx2");
+	}
+	return has_avx2 ? pair_avx2 (p, buf, len, i) : pair_sse2 (p, buf, len, i);
+#else
+	return pair_scalar (p, buf, len, i);
+#endif
+}
+
+/**
+ * \brief Call \p cb for every position of \p buf where an anchored keyword
+ * may start and fit, in no particular order
+ */
+RZ_IPI void rz_search_matcher_scan(RzSearchMatcher *m, const ut8 *buf, ut32 len, RzSearchMatcherCb cb, void *user) {
+	rz_return_if_fail (m && (buf || !len) && cb);
+	ut32 i;
+	if (!m->anchored) {
+		return;
+	}
+	if (m->anchored == 1) {
+		const MatcherKeyword *k = &m->kws[m->single];
+		for (i = pair_next (&m->pair, buf, len, 0); i < len; i = pair_next (&m->pair, buf, len, i + 1)) {
+			report (m, m->single, i + k->len, len, cb, user);
+		}
+		return;
+	}
+	if (m->nhashed && len >= PREFIX_LEN) {
+		const ut64 *bloom = m->bloom;
+		for (i = 0; i <= len - PREFIX_LEN; i++) {
+			ut32 x = read_prefix (m, buf + i);
+			ut32 h = prefix_hash (m, x);
+			if (!(bloom[h / 64] & (1ULL << (h % 64)))) {
+				continue;
+			}
+			st32 idx;
+			for (idx = m->heads[h]; idx >= 0; idx = m->kws[idx].next) {
+				if (m->kws[idx].prefix == x) {
+					report (m, idx, i + m->kws[idx].len, len, cb, user);
+				}
+			}
+		}
+	}
+	if (!m->nshort) {
+		return;
+	}
+	const ut32 *delta = m->delta;
+	const ut16 *cls = m->cls;
+	ut32 st = 0;
+	for (i = 0; i < len; i++) {
+		st = delta[(st & ~STATE_MATCH) + cls[buf[i]]];
+		if (!(st & STATE_MATCH)) {
+			continue;
+		}
+		ut32 s;
+		for (s = (st & ~STATE_MATCH) / m->ncls; s; s = m->dict[s]) {
+			st32 idx;
+			for (idx = m->out[s]; idx >= 0; idx = m->kws[idx].next) {
+				report (m, idx, i + 1, len, cb, user);
+			}
+		}
+	}
+}
@@ -3,6 +3,7 @@
 #include <rz_search.h>
 #include <rz_list.h>
 #include <ctype.h>
+#include "search_private.h"
 
 // Experimental search engine (fails, because stops at first hit of every block read
 #define USE_BMH 0
@@ -54,6 +55,7 @@ RZ_API RzSearch *rz_search_free(RzSearch *s) {
 	}
 	rz_list_free (s->hits);
 	rz_list_free (s->kws);
+	rz_search_matcher_free (s->matcher);
 	//rz_io_free(s->iob.io); this is supposed to be a weak reference
 	free (s->data);
 	free (s);
@@ -99,6 +101,9 @@ RZ_API int rz_search_begin(RzSearch *s) {
 		kw->count = 0;
 		kw->last = 0;
 	}
+	// the keywords may have been edited in place
+	rz_search_matcher_free (s->matcher);
+	s->matcher = NULL;
 	return true;
 }
 
@@ -355,12 +360,107 @@ static bool brute_force_match(RzSearch *s, RzSearchKeyword *kw, const ut8 *buf,
 	return j == kw->keyword_length;
 }
 
-// Supported search variants: backward, binmask, icase, inverse, overlap
-RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
+typedef struct {
+	ut32 kw;
+	ut32 pos;
+} SearchCandidate;
+
+static void candidate_cb(void *user, ut32 idx, ut32 pos) {
+	SearchCandidate c = { idx, pos };
+	rz_vector_push (user, &c);
+}
+
+static int candidate_cmp(const void *a, const void *b) {
+	const SearchCandidate *x = a, *y = b;
+	if (x->kw != y->kw) {
+		return x->kw < y->kw ? -1 : 1;
+	}
+	return x->pos < y->pos ? -1 : x->pos > y->pos;
+}
+
+static void find_candidates(RzSearchMatcher *m, const ut8 *buf, int len, RzVector *out) {
+	rz_search_matcher_scan (m, buf, len, candidate_cb, out);
+	if (rz_vector_len (out) > 1) {
+		// by keyword, so that hits are reported in the same order as a scan per keyword
+		qsort (out->a, rz_vector_len (out), sizeof (SearchCandidate), candidate_cmp);
+	}
+}
+
+// Skips the candidates left over by the previous keywords
+static bool has_candidates(RzVector *cands, size_t *c, ut32 idx) {
+	for (; *c < rz_vector_len (cands); (*c)++) {
+		SearchCandidate *cand = rz_vector_index_ptr (cands, *c);
+		if (cand->kw >= idx) {
+			return cand->kw == idx;
+		}
+	}
+	return false;
+}
+
+/* Reports the hits of kw starting in buf[i, end), buf holding len bytes
+ * read shift bytes before from. With candidates only their positions are
+ * tried, otherwise every one.
+ * Returns -1 on error, 2 if search.maxhits is reached and 1 otherwise. */
+static int keyword_update(RzSearch *s, RzSearchKeyword *kw, ut64 from, const ut8 *buf, int len, int i, int end, int shift, RzVector *cands, size_t *c, ut32 idx) {
+	for (;;) {
+		if (cands) {
+			SearchCandidate *cand = NULL;
+			for (; *c < rz_vector_len (cands); (*c)++) {
+				cand = rz_vector_index_ptr (cands, *c);
+				if (cand->kw > idx || (cand->kw == idx && cand->pos >= end)) {
+					return 1;
+				}
+				if (cand->kw == idx && cand->pos >= i && brute_force_match (s, kw, buf, cand->pos)) {
+					break;
+				}
+			}
+			if (*c == rz_vector_len (cands)) {
+				return 1;
+			}
+			(*c)++;
+			i = cand->pos;
+		} else {
+			for (; i + kw->keyword_length <= len && i < end; i++) {
+				if (brute_force_match (s, kw, buf, i) != s->inverse) {
+					break;
+				}
+			}
+			if (i + kw->keyword_length > len || i >= end) {
+				return 1;
+			}
+		}
+		int t = rz_search_hit_new (s, kw, s->bckwrds ? from - kw->keyword_length - i + shift : from + i - shift);
+		if (!t) {
+			return -1;
+		}
+		if (t > 1) {
+			return 2;
+		}
+		i += s->overlap ? 1 : kw->keyword_length;
+	}
+}
+
+// Inverse and distance searches need to try every position
+static RzSearchMatcher *search_matcher(RzSearch *s) {
+	if (s->inverse || s->distance) {
+		return NULL;
+	}
+	if (s->matcher && rz_search_matcher_count (s->matcher) != rz_list_length (s->kws)) {
+		rz_search_matcher_free (s->matcher);
+		s->matcher = NULL;
+	}
+	if (!s->matcher) {
+		s->matcher = rz_search_matcher_new (s->kws);
+	}
+	return s->matcher;
+}
+
+// cands, if not NULL, are those of buf as found by find_candidates()
+static int binparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len, RzVector *cands) {
 	RzSearchKeyword *kw;
 	RzListIter *iter;
 	RzSearchLeftover *left;
-	int longest = 0, i;
+	int longest = 0, i, t = 1;
 	const int old_nhits = s->nhits;
 
 	rz_list_foreach (s->kws, iter, kw) {
@@ -391,46 +491,55 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 			*j = t;
 		}
 	}
+	RzSearchMatcher *m = search_matcher (s);
 
 	ut64 len1 = left->len + RZ_MIN (longest - 1, len);
 	memcpy (left->data + left->len, buf, len1 - left->len);
+	RzVector lcands, own;
+	RzVector *bcands = cands ? cands : &own;
+	size_t lc = 0, bc = 0;
+	rz_vector_init (&lcands, sizeof (SearchCandidate), NULL, NULL);
+	rz_vector_init (&own, sizeof (SearchCandidate), NULL, NULL);
+	if (m) {
+		find_candidates (m, left->data, len1, &lcands);
+		if (!cands) {
+			find_candidates (m, buf, len, &own);
+		}
+	}
+	ut32 idx = 0;
 	rz_list_foreach (s->kws, iter, kw) {
+		bool anchored = m && rz_search_matcher_anchored (m, idx);
+		if (anchored && !has_candidates (&lcands, &lc, idx) && !has_candidates (bcands, &bc, idx)) {
+			idx++;
+			continue;
+		}
 		i = s->overlap || !kw->count ? 0 :
 				s->bckwrds
 				? kw->last - from < left->len ? from + left->len - kw->last : 0
 				: from - kw->last < left->len ? kw->last + left->len - from : 0;
-		for (; i + kw->keyword_length <= len1 && i < left->len; i++) {
-			if (brute_force_match (s, kw, left->data, i) != s->inverse) {
-				int t = rz_search_hit_new (s, kw, s->bckwrds ? from - kw->keyword_length - i + left->len : from + i - left->len);
-				if (!t) {
-					return -1;
-				}
-				if (t > 1) {
-					return s->nhits - old_nhits;
-				}
-				if (!s->overlap) {
-					i += kw->keyword_length - 1;
-				}
-			}
+		// matches that end before this block were reported by the previous update
+		i = RZ_MAX (i, left->len - (int)kw->keyword_length + 1);
+		t = keyword_update (s, kw, from, left->data, len1, i, left->len, left->len, anchored ? &lcands : NULL, &lc, idx);
+		if (t != 1) {
+			break;
 		}
 		i = s->overlap || !kw->count ? 0 :
 				s->bckwrds
 				? from > kw->last ? from - kw->last : 0
 				: from < kw->last ? kw->last - from : 0;
-		for (; i + kw->keyword_length <= len; i++) {
-			if (brute_force_match (s, kw, buf, i) != s->inverse) {
-				int t = rz_search_hit_new (s, kw, s->bckwrds ? from - kw->keyword_length - i : from + i);
-				if (!t) {
-					return -1;
-				}
-				if (t > 1) {
-					return s->nhits - old_nhits;
-				}
-				if (!s->overlap) {
-					i += kw->keyword_length - 1;
-				}
-			}
+		t = keyword_update (s, kw, from, buf, len, i, len, 0, anchored ? bcands : NULL, &bc, idx);
+		if (t != 1) {
+			break;
 		}
+		idx++;
+	}
+	rz_vector_fini (&lcands);
+	rz_vector_fini (&own);
+	if (t < 0) {
+		return -1;
+	}
+	if (t > 1) {
+		return s->nhits - old_nhits;
 	}
 	if (len < longest - 1) {
 		if (len1 < longest) {
@@ -448,6 +557,11 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 	return s->nhits - old_nhits;
 }
 
+// Supported search variants: backward, binmask, icase, inverse, overlap
+RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
+	return binparse_update (s, from, buf, len, NULL);
+}
+
 RZ_API void rz_search_set_distance(RzSearch *s, int dist) {
 	if (dist>=RZ_SEARCH_DISTANCE_MAX) {
 		eprintf ("Invalid distance\n");
@@ -486,6 +600,147 @@ RZ_API int rz_search_update_i(RzSearch *s, ut64 from, const ut8 *buf, long len)
 	return rz_search_update (s, from, buf, len);
 }
 
+#define SEARCH_JOB_BLOCKS 16
+
+typedef struct {
+	RzSearchMatcher *m;
+	ut64 from;
+	ut8 *buf;
+	ut64 len;
+	int bsize;
+	int nblocks;
+	RzVector cands[SEARCH_JOB_BLOCKS];
+} SearchJob;
+
+static void search_job(void *user) {
+	SearchJob *job = user;
+	int b;
+	for (b = 0; b < job->nblocks; b++) {
+		ut64 off = (ut64)b * job->bsize;
+		find_candidates (job->m, job->buf + off, RZ_MIN (job->bsize, job->len - off), &job->cands[b]);
+	}
+}
+
+static int update_range_serial(RzSearch *s, ut64 from, ut64 to, int bsize, RzSearchReadCallback read, void *user) {
+	ut8 *buf = malloc (bsize);
+	ut64 at;
+	int ret = 0;
+	if (!buf) {
+		return -1;
+	}
+	for (at = from; at < to; at += bsize) {
+		int len = RZ_MIN (bsize, to - at);
+		if (!read (user, at, buf, len)) {
+			break;
+		}
+		if (rz_search_update (s, at, buf, len) < 0) {
+			ret = -1;
+			break;
+		}
+		if (s->maxhits && s->nhits >= s->maxhits) {
+			break;
+		}
+	}
+	free (buf);
+	return ret;
+}
+
+/**
+ * \brief Search [from, to), read with \p read in blocks of \p bsize bytes
+ *
+ * Hits are reported on the calling thread, exactly as if rz_search_update()
+ * was called on each block in order, but with more than one thread the
+ * blocks of a forward keyword search are scanned in parallel, while \p read
+ * is always called on the calling thread, in order.
+ * Stops early if \p read returns false or search.maxhits is reached.
+ *
+ * \param threads the number of threads, 0 for one per core
+ * \return the number of hits, or -1 on error
+ */
+RZ_API int rz_search_update_range(RzSearch *s, ut64 from, ut64 to, int bsize, int threads, RzSearchReadCallback read, void *user) {
+	rz_return_val_if_fail (s && read && bsize > 0, -1);
+	const ut64 old_nhits = s->nhits;
+	int ret = 0, i, b;
+	if (threads <= 0) {
+		threads = rz_th_ncores ();
+	}
+	RzSearchMatcher *m = s->update == rz_search_mybinparse_update && !s->bckwrds ? search_matcher (s) : NULL;
+	if (threads < 2 || !m) {
+		ret = update_range_serial (s, from, to, bsize, read, user);
+		return ret < 0 ? ret : s->nhits - old_nhits;
+	}
+	const int njobs = threads * 2;
+	SearchJob *jobs = RZ_NEWS0 (SearchJob, njobs);
+	RzThreadPool *pool = rz_th_pool_new (threads);
+	if (!jobs || !pool) {
+		ret = -1;
+		goto beach;
+	}
+	for (i = 0; i < njobs; i++) {
+		jobs[i].m = m;
+		jobs[i].bsize = bsize;
+		jobs[i].buf = malloc ((size_t)bsize * SEARCH_JOB_BLOCKS);
+		if (!jobs[i].buf) {
+			ret = -1;
+			goto beach;
+		}
+		for (b = 0; b < SEARCH_JOB_BLOCKS; b++) {
+			rz_vector_init (&jobs[i].cands[b], sizeof (SearchCandidate), NULL, NULL);
+		}
+	}
+	ut64 at = from;
+	bool eof = false, stop = false;
+	while (at < to && !eof && !stop) {
+		// read here, scan on the pool
+		int n;
+		for (n = 0; n < njobs && at < to && !eof; n++) {
+			SearchJob *job = &jobs[n];
+			job->from = at;
+			job->len = 0;
+			for (job->nblocks = 0; job->nblocks < SEARCH_JOB_BLOCKS && at < to; job->nblocks++) {
+				int len = RZ_MIN (bsize, to - at);
+				if (!read (user, at, job->buf + job->len, len)) {
+					eof = true;
+					break;
+				}
+				job->len += len;
+				at += len;
+			}
+			if (job->nblocks && !rz_th_pool_add_job (pool, search_job, job)) {
+				search_job (job);
+			}
+		}
+		rz_th_pool_wait (pool);
+		// then report the hits block after block
+		for (i = 0; i < n; i++) {
+			SearchJob *job = &jobs[i];
+			for (b = 0; b < job->nblocks; b++) {
+				ut64 off = (ut64)b * bsize;
+				if (!stop && !(s->maxhits && s->nhits >= s->maxhits)) {
+					if (binparse_update (s, job->from + off, job->buf + off, RZ_MIN (bsize, job->len - off), &job->cands[b]) < 0) {
+						ret = -1;
+						stop = true;
+					}
+				}
+				rz_vector_clear (&job->cands[b]);
+			}
+		}
+		if (s->maxhits && s->nhits >= s->maxhits) {
+			stop = true;
+		}
+	}
+beach:
+	rz_th_pool_free (pool);
+	for (i = 0; jobs && i < njobs; i++) {
+		free (jobs[i].buf);
+		for (b = 0; b < SEARCH_JOB_BLOCKS; b++) {
+			rz_vector_fini (&jobs[i].cands[b]);
+		}
+	}
+	free (jobs);
+	return ret < 0 ? ret : s->nhits - old_nhits;
+}
+
 static int listcb(RzSearchKeyword *k, void *user, ut64 addr) {
 	RzSearchHit *hit = RZ_NEW0 (RzSearchHit);
 	if (!hit) {
@@ -511,6 +766,8 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw) {
 	}
 	kw->kwidx = s->n_kws++;
 	rz_list_append (s->kws, kw);
+	rz_search_matcher_free (s->matcher);
+	s->matcher = NULL;
 	return true;
 }
 
@@ -519,6 +776,8 @@ RZ_API void rz_search_string_prepare_backward(RzSearch *s) {
 	RzListIter *iter;
 	RzSearchKeyword *kw;
 	// Precondition: !kw->binmask_length || kw->keyword_length % kw->binmask_length == 0
+	rz_search_matcher_free (s->matcher);
+	s->matcher = NULL;
 	rz_list_foreach (s->kws, iter, kw) {
 		ut8 *i = kw->bin_keyword, *j = kw->bin_keyword + kw->keyword_length;
 		while (i < j) {
@@ -547,4 +806,6 @@ RZ_API void rz_search_kw_reset(RzSearch *s) {
 	rz_list_purge (s->kws);
 	rz_list_purge (s->hits);
 	RZ_FREE (s->data);
+	rz_search_matcher_free (s->matcher);
+	s->matcher = NULL;
 }
@@ -0,0 +1,18 @@
+#ifndef RZ_SEARCH_PRIVATE_H
+#define RZ_SEARCH_PRIVATE_H
+
+#include <rz_search.h>
+
+/**
+ * Called for every position \p pos of the buffer where keyword \p idx may
+ * start. Only the anchor of the keyword matched, the caller verifies the rest.
+ */
+typedef void (*RzSearchMatcherCb)(void *user, ut32 idx, ut32 pos);
+
+RZ_IPI RzSearchMatcher *rz_search_matcher_new(RzList *kws);
+RZ_IPI void rz_search_matcher_free(RzSearchMatcher *m);
+RZ_IPI ut32 rz_search_matcher_count(RzSearchMatcher *m);
+RZ_IPI bool rz_search_matcher_anchored(RzSearchMatcher *m, ut32 idx);
+RZ_IPI void rz_search_matcher_scan(RzSearchMatcher *m, const ut8 *buf, ut32 len, RzSearchMatcherCb cb, void *user);
+
+#endif
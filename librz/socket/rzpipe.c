@@ -19,6 +19,10 @@ Usage Example:
 #include <rz_util.h>
 #include <rz_lib.h>
 #include <rz_socket.h>
+#include <errno.h>
+#if !__WINDOWS__
+#include <poll.h>
+#endif
 
 #define RZP_PID(x) (((RzPipe*)(x)->data)->pid)
 #define RZP_INPUT(x) (((RzPipe*)(x)->data)->input[0])
@@ -32,12 +36,280 @@ static void env(const char *s, int f) {
 }
 #endif
 
+/*
+ * Besides NUL terminated replies, rzpipe speaks a framed protocol where every
+ * command and reply is a little endian ut32 length followed by that many
+ * bytes. It is negotiated when the pipe is opened, through RZ_PIPE_FRAMED.
+ * The variable names the pipe it was set for (see rzpipe_framed_token()), so
+ * the processes that inherit it and talk over other pipes, such as the rizin
+ * spawned by a stock rzpipe client from a script, ignore it:
+ *
+ * - rzpipe_open (cmd) sets it for the stdin of the child, rizin -0 then
+ *   sends 0x01 instead of the initial NUL byte.
+ * - rizin sets it for the scripts it runs through pipes, rzpipe_open (NULL)
+ *   then sends a single NUL byte before the first frame.
+ *
+ * Both modes read replies in big chunks, and rzpipe_queue() sends several
+ * commands before their replies are read. While commands are written, the
+ * replies that are already there are read ahead, or both sides could end up
+ * blocked on a full pipe.
+ */
+
+#define RZP_BUFSZ 0x10000
+
+static bool write_all(int fd, const ut8 *buf, size_t len) {
+	while (len > 0) {
+		ssize_t n = write (fd, buf, len);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+static bool read_all(int fd, ut8 *buf, size_t len) {
+	while (len > 0) {
+		ssize_t n = read (fd, buf, len);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+/**
+ * \brief Write \p len bytes of \p buf to \p fd as a single frame of the framed rzpipe protocol
+ */
+RZ_API bool rzpipe_write_frame(int fd, const ut8 *buf, ut32 len) {
+	rz_return_val_if_fail (buf || !len, false);
+	ut8 hdr[4];
+	rz_write_le32 (hdr, len);
+	return write_all (fd, hdr, sizeof (hdr)) && write_all (fd, buf, len);
+}
+
+/**
+ * \brief Read a frame of the framed rzpipe protocol from \p fd
+ *
+ * \return its contents, NUL terminated for convenience, or NULL at EOF
+ */
+RZ_API ut8 *rzpipe_read_frame(int fd, ut32 *len) {
+	ut8 hdr[4];
+	if (!read_all (fd, hdr, sizeof (hdr))) {
+		return NULL;
+	}
+	ut32 n = rz_read_le32 (hdr);
+	ut8 *buf = malloc ((size_t)n + 1);
+	if (!buf || !read_all (fd, buf, n)) {
+		free (buf);
+		return NULL;
+	}
+	buf[n] = 0;
+	if (len) {
+		*len = n;
+	}
+	return buf;
+}
+
+/**
+ * \brief Value of RZ_PIPE_FRAMED that asks for frames over the pipe \p fd
+ *
+ * \return the device and inode of the pipe, or NULL where this is not supported
+ */
+RZ_API RZ_OWN char *rzpipe_framed_token(int fd) {
+#if __UNIX__
+	struct stat st;
+	if (fd < 0 || fstat (fd, &st) || !S_ISFIFO (st.st_mode)) {
+		return NULL;
+	}
+	return rz_str_newf ("%" PFMT64x ":%" PFMT64x, (ut64)st.st_dev, (ut64)st.st_ino);
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * \brief Whether RZ_PIPE_FRAMED asks for frames over the pipe \p fd, and not over another one
+ */
+RZ_API bool rzpipe_framed_requested(int fd) {
+	char *env = rz_sys_getenv ("RZ_PIPE_FRAMED");
+	char *token = env ? rzpipe_framed_token (fd) : NULL;
+	bool ret = token && !strcmp (env, token);
+	free (token);
+	free (env);
+	return ret;
+}
+
+#if !__WINDOWS__
+static bool wbuf_append(RzPipe *rzp, const void *data, size_t len) {
+	if (rzp->wbuf_len + len > rzp->wbuf_size) {
+		size_t size = RZ_MAX (rzp->wbuf_size * 2, rzp->wbuf_len + len);
+		ut8 *buf = realloc (rzp->wbuf, size);
+		if (!buf) {
+			return false;
+		}
+		rzp->wbuf = buf;
+		rzp->wbuf_size = size;
+	}
+	memcpy (rzp->wbuf + rzp->wbuf_len, data, len);
+	rzp->wbuf_len += len;
+	return true;
+}
+
+static bool rbuf_fill(RzPipe *rzp);
+
+static bool wbuf_flush(RzPipe *rzp) {
+	size_t off = 0;
+	bool ret = true;
+	while (ret && off < rzp->wbuf_len) {
+		struct pollfd fds[2] = {
+			{ .fd = rzp->input[1], .events = POLLOUT },
+			{ .fd = rzp->output[0], .events = POLLIN },
+		};
+		if (poll (fds, 2, -1) < 0) {
+			ret = errno == EINTR;
+			continue;
+		}
+		if (fds[1].revents) {
+			// fails once the other side is gone
+			ret = rbuf_fill (rzp);
+			continue;
+		}
+		// up to PIPE_BUF bytes never block once the pipe is writable
+		ssize_t n = write (rzp->input[1], rzp->wbuf + off, RZ_MIN (rzp->wbuf_len - off, PIPE_BUF));
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			ret = false;
+			break;
+		}
+		off += n;
+	}
+	rzp->wbuf_len = 0;
+	return ret;
+}
+
+// read at least one more byte of replies
+static bool rbuf_fill(RzPipe *rzp) {
+	if (rzp->rbuf_off) {
+		memmove (rzp->rbuf, rzp->rbuf + rzp->rbuf_off, rzp->rbuf_len - rzp->rbuf_off);
+		rzp->rbuf_len -= rzp->rbuf_off;
+		rzp->rbuf_off = 0;
+	}
+	if (rzp->rbuf_len == rzp->rbuf_size) {
+		size_t size = RZ_MAX (rzp->rbuf_size * 2, RZP_BUFSZ);
+		ut8 *buf = realloc (rzp->rbuf, size);
+		if (!buf) {
+			return false;
+		}
+		rzp->rbuf = buf;
+		rzp->rbuf_size = size;
+	}
+	ssize_t n;
+	do {
+		n = read (rzp->output[0], rzp->rbuf + rzp->rbuf_len, rzp->rbuf_size - rzp->rbuf_len);
+	} while (n < 0 && errno == EINTR);
+	if (n <= 0) {
+		return false;
+	}
+	rzp->rbuf_len += n;
+	return true;
+}
+
+static char *read_zero(RzPipe *rzp) {
+	size_t scanned = 0;
+	for (;;) {
+		ut8 *start = rzp->rbuf + rzp->rbuf_off;
+		size_t avail = rzp->rbuf_len - rzp->rbuf_off;
+		ut8 *end = rzp->rbuf ? memchr (start + scanned, 0, avail - scanned) : NULL;
+		if (!end) {
+			scanned = avail;
+			if (rbuf_fill (rzp)) {
+				continue;
+			}
+			// the other side is gone, return what was read so far
+			end = start + avail;
+		}
+		size_t len = end - start;
+		char *ret = malloc (len + 1);
+		if (ret) {
+			if (len) {
+				memcpy (ret, start, len);
+			}
+			ret[len] = 0;
+		}
+		rzp->rbuf_off += RZ_MIN (len + 1, avail);
+		return ret;
+	}
+}
+
+static char *read_framed(RzPipe *rzp) {
+	while (rzp->rbuf_len - rzp->rbuf_off < 4) {
+		if (!rbuf_fill (rzp)) {
+			return NULL;
+		}
+	}
+	ut32 len = rz_read_le32 (rzp->rbuf + rzp->rbuf_off);
+	rzp->rbuf_off += 4;
+	char *ret = malloc ((size_t)len + 1);
+	if (!ret) {
+		return NULL;
+	}
+	// what was read ahead, then the rest of big replies straight into place
+	size_t have = RZ_MIN (len, rzp->rbuf_len - rzp->rbuf_off);
+	memcpy (ret, rzp->rbuf + rzp->rbuf_off, have);
+	rzp->rbuf_off += have;
+	if (have < len && !read_all (rzp->output[0], (ut8 *)ret + have, len - have)) {
+		free (ret);
+		return NULL;
+	}
+	ret[len] = 0;
+	return ret;
+}
+#endif
+
+/**
+ * \brief Send \p str without waiting for the reply, which is read later by rzpipe_read()
+ *
+ * Queued commands are sent together, at the latest when the next reply is read.
+ * The replies come in the order of the commands.
+ */
+RZ_API bool rzpipe_queue(RzPipe *rzpipe, const char *str) {
+	rz_return_val_if_fail (rzpipe && str, false);
+#if __WINDOWS__
+	return rzpipe_write (rzpipe, str) > 0;
+#else
+	size_t len = strlen (str);
+	if (rzpipe->framed) {
+		ut8 hdr[4];
+		rz_write_le32 (hdr, (ut32)len);
+		if (!wbuf_append (rzpipe, hdr, sizeof (hdr)) || !wbuf_append (rzpipe, str, len)) {
+			return false;
+		}
+	} else if (!wbuf_append (rzpipe, str, len) || !wbuf_append (rzpipe, "\n", 2)) { /* include \n\x00 */
+		return false;
+	}
+	return rzpipe->wbuf_len < RZP_BUFSZ || wbuf_flush (rzpipe);
+#endif
+}
+
 RZ_API int rzpipe_write(RzPipe *rzpipe, const char *str) {
-	char *cmd;
-	int ret, len;
 	if (!rzpipe || !str) {
 		return -1;
 	}
+#if __WINDOWS__
+	char *cmd;
+	int ret, len;
 	len = strlen (str) + 2; /* include \n\x00 */
 	cmd = malloc (len + 2);
 	if (!cmd) {
@@ -45,30 +317,27 @@ RZ_API int rzpipe_write(RzPipe *rzpipe, const char *str) {
 	}
 	memcpy (cmd, str, len - 1);
 	strcpy (cmd + len - 2, "\n");
-#if __WINDOWS__
 	DWORD dwWritten = -1;
 	WriteFile (rzpipe->pipe, cmd, len, &dwWritten, NULL);
 	ret = (dwWritten == len);
-#else
-	ret = (write (rzpipe->input[1], cmd, len) == len);
-#endif
 	free (cmd);
 	return ret;
+#else
+	return rzpipe_queue (rzpipe, str) && wbuf_flush (rzpipe);
+#endif
 }
 
 /* TODO: add timeout here ? */
 RZ_API char *rzpipe_read(RzPipe *rzpipe) {
-	int bufsz = 0;
-	char *buf = NULL;
 	if (!rzpipe) {
 		return NULL;
 	}
-	bufsz = 4096;
-	buf = calloc (1, bufsz);
+#if __WINDOWS__
+	int bufsz = 4096;
+	char *buf = calloc (1, bufsz);
 	if (!buf) {
 		return NULL;
 	}
-#if __WINDOWS__
 	BOOL bSuccess = FALSE;
 	DWORD dwRead = 0;
 	// TODO: handle > 4096 buffers here
@@ -80,30 +349,13 @@ RZ_API char *rzpipe_read(RzPipe *rzpipe) {
 		buf[dwRead] = 0;
 	}
 	buf[bufsz - 1] = 0;
+	return buf;
 #else
-	char *newbuf;
-	int i, rv;
-	for (i = 0; i < bufsz; i++) {
-		rv = read (rzpipe->output[0], buf + i, 1);
-		if (i + 2 >= bufsz) {
-			bufsz += 4096;
-			newbuf = realloc (buf, bufsz);
-			if (!newbuf) {
-				RZ_FREE (buf);
-				break;
-			}
-			buf = newbuf;
-		}
-		if (rv != 1 || !buf[i]) {
-			break;
-		}
-	}
-	if (buf) {
-		int zpos = (i < bufsz)? i: i - 1;
-		buf[zpos] = 0;
+	if (rzpipe->wbuf_len && !wbuf_flush (rzpipe)) {
+		return NULL;
 	}
+	return rzpipe->framed ? read_framed (rzpipe) : read_zero (rzpipe);
 #endif
-	return buf;
 }
 
 RZ_API int rzpipe_close(RzPipe *rzpipe) {
@@ -145,6 +397,8 @@ RZ_API int rzpipe_close(RzPipe *rzpipe) {
 		waitpid (rzpipe->child, NULL, 0);
 		rzpipe->child = -1;
 	}
+	free (rzpipe->rbuf);
+	free (rzpipe->wbuf);
 #endif
 	free (rzpipe);
 	return 0;
@@ -188,6 +442,10 @@ static RzPipe* rzp_open_spawn(RzPipe* rzp, const char *cmd) {
 	}
 	free (in);
 	free (out);
+	if (rzp && rzpipe_framed_requested (rzp->input[1])) {
+		// tell rizin that frames follow
+		rzp->framed = write_all (rzp->input[1], (const ut8 *)"", 1);
+	}
 	return rzp;
 #else
 	eprintf ("rzpipe_open(NULL) not supported on windows\n");
@@ -258,6 +516,10 @@ RZ_API RzPipe *rzpipe_open(const char *cmd) {
 		rzpipe_close (rzp);
 		return NULL;
 	}
+#ifdef F_SETPIPE_SZ
+	// fewer round trips for big replies, failing is fine
+	(void)fcntl (rzp->output[0], F_SETPIPE_SZ, 1 << 20);
+#endif
 #if LIBC_HAVE_FORK
 	rzp->child = fork ();
 #else
@@ -283,6 +545,7 @@ RZ_API RzPipe *rzpipe_open(const char *cmd) {
 			rzpipe_close (rzp);
 			return NULL;
 		}
+		rzp->framed = ch == 1;
 		// Close parent's end of pipes
 		close (rzp->input[0]);
 		close (rzp->output[1]);
@@ -299,6 +562,9 @@ RZ_API RzPipe *rzpipe_open(const char *cmd) {
 			close (rzp->output[0]);
 			rzp->input[1] = -1;
 			rzp->output[0] = -1;
+			char *token = rzpipe_framed_token (0);
+			rz_sys_setenv ("RZ_PIPE_FRAMED", token);
+			free (token);
 			rc = rz_sandbox_system (cmd, 1);
 			if (rc != 0) {
 				eprintf ("return code %d for %s\n", rc, cmd);
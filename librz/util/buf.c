@@ -11,6 +11,7 @@ typedef enum {
 	RZ_BUFFER_MMAP,
 	RZ_BUFFER_SPARSE,
 	RZ_BUFFER_REF,
+	RZ_BUFFER_INFLATE,
 } RzBufferType;
 
 #include "buf_file.c"
@@ -19,6 +20,7 @@ typedef enum {
 #include "buf_mmap.c"
 #include "buf_io.c"
 #include "buf_ref.c"
+#include "buf_inflate.c"
 
 static bool buf_init(RzBuffer *b, const void *user) {
 	rz_return_val_if_fail (b && b->methods, false);
@@ -102,6 +104,9 @@ static RzBuffer *new_buffer(RzBufferType type, const void *user) {
 	case RZ_BUFFER_REF:
 		b->methods = &buffer_ref_methods;
 		break;
+	case RZ_BUFFER_INFLATE:
+		b->methods = &buffer_inflate_methods;
+		break;
 	default:
 		rz_warn_if_reached ();
 		break;
@@ -166,6 +171,20 @@ RZ_API RzBuffer *rz_buf_new_slice(RzBuffer *b, ut64 offset, ut64 size) {
 	return new_buffer (RZ_BUFFER_REF, &u);
 }
 
+/**
+ * \brief Read-only buffer over the data decompressed through \p idx
+ *
+ * The buffer owns \p idx, which is freed on failure too.
+ */
+RZ_API RzBuffer *rz_buf_new_with_inflate_index(RzInflateIndex *idx) {
+	rz_return_val_if_fail (idx, NULL);
+	RzBuffer *b = new_buffer (RZ_BUFFER_INFLATE, idx);
+	if (!b) {
+		rz_inflate_index_free (idx);
+	}
+	return b;
+}
+
 RZ_API RzBuffer *rz_buf_new_with_string(const char *msg) {
 	return rz_buf_new_with_bytes ((const ut8 *)msg, (ut64)strlen (msg));
 }
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+
+struct buf_inflate_priv {
+	RzInflateIndex *idx;
+	ut64 cur;
+};
+
+static inline struct buf_inflate_priv *get_priv_inflate(RzBuffer *b) {
+	struct buf_inflate_priv *priv = (struct buf_inflate_priv *)b->priv;
+	rz_warn_if_fail (priv);
+	return priv;
+}
+
+static bool buf_inflate_init(RzBuffer *b, const void *user) {
+	struct buf_inflate_priv *priv = RZ_NEW0 (struct buf_inflate_priv);
+	if (!priv) {
+		return false;
+	}
+	// the decompressed data can only be read, callers that want to
+	// modify it copy it into a bytes buffer first
+	b->readonly = true;
+	priv->idx = (RzInflateIndex *)user;
+	b->priv = priv;
+	return true;
+}
+
+static bool buf_inflate_fini(RzBuffer *b) {
+	struct buf_inflate_priv *priv = get_priv_inflate (b);
+	rz_inflate_index_free (priv->idx);
+	RZ_FREE (b->priv);
+	return true;
+}
+
+static st64 buf_inflate_read(RzBuffer *b, ut8 *buf, ut64 len) {
+	struct buf_inflate_priv *priv = get_priv_inflate (b);
+	st64 r = rz_inflate_index_read_at (priv->idx, priv->cur, buf, len);
+	if (r > 0) {
+		priv->cur += r;
+	}
+	return r;
+}
+
+static ut64 buf_inflate_get_size(RzBuffer *b) {
+	struct buf_inflate_priv *priv = get_priv_inflate (b);
+	return rz_inflate_index_size (priv->idx);
+}
+
+static st64 buf_inflate_seek(RzBuffer *b, st64 addr, int whence) {
+	struct buf_inflate_priv *priv = get_priv_inflate (b);
+	switch (whence) {
+	case RZ_BUF_CUR:
+		priv->cur += addr;
+		break;
+	case RZ_BUF_SET:
+		priv->cur = addr;
+		break;
+	case RZ_BUF_END:
+		priv->cur = rz_inflate_index_size (priv->idx) + addr;
+		break;
+	default:
+		rz_warn_if_reached ();
+		return -1;
+	}
+	return priv->cur;
+}
+
+static const RzBufferMethods buffer_inflate_methods = {
+	.init = buf_inflate_init,
+	.fini = buf_inflate_fini,
+	.read = buf_inflate_read,
+	.get_size = buf_inflate_get_size,
+	.seek = buf_inflate_seek,
+};
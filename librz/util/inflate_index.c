@@ -0,0 +1,515 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <zlib.h>
+
+/* Seekable inflate, after zlib's examples/zran.c: a single pass over the
+ * stream records a checkpoint at a deflate block boundary every `span` bytes
+ * of output. A checkpoint is the position in the compressed stream, the bits
+ * of the last byte that still belong to the block and the 32K of output
+ * preceding it, which is all inflate needs to resume from there in raw mode.
+ * Reads are served in chunks kept in a small LRU, and the stream that filled
+ * the last chunk stays alive so that sequential reads never seek back. */
+
+#define WINSIZE    0x8000
+#define IN_SIZE    0x10000
+#define CHUNK_SIZE 0x10000
+#define CHUNKS     32
+
+#define INDEX_MAGIC   "RZIX"
+#define INDEX_VERSION 1
+#define INDEX_TAIL    16
+
+typedef enum {
+	STREAM_RAW,
+	STREAM_ZLIB,
+	STREAM_GZIP,
+} StreamKind;
+
+typedef struct {
+	ut64 in; ///< offset of the first compressed byte after the checkpoint
+	ut64 out; ///< offset in the decompressed data
+	ut8 bits; ///< bits of the byte at in - 1 that are not consumed yet
+	ut32 window_len; ///< size of the window once inflated
+	ut32 zwindow_len;
+	ut8 *zwindow; ///< preceding output, deflated to keep the index small
+} InflatePoint;
+
+typedef struct {
+	ut64 idx;
+	ut64 tick;
+	ut32 len;
+	ut8 *data;
+} InflateChunk;
+
+struct rz_inflate_index_t {
+	RzBuffer *src;
+	ut64 src_size;
+	ut64 size;
+	ut64 span;
+	StreamKind kind;
+	RzVector /*<InflatePoint>*/ points;
+
+	z_stream strm;
+	bool strm_init;
+	bool live; ///< strm is positioned at live_out
+	bool raw_now; ///< strm currently decodes raw deflate
+	ut64 live_out;
+	ut64 in_pos; ///< offset in src of the next byte to feed
+	ut8 inbuf[IN_SIZE];
+
+	InflateChunk chunks[CHUNKS];
+	ut64 tick;
+};
+
+static void point_fini(void *e, void *user) {
+	InflatePoint *p = e;
+	free (p->zwindow);
+}
+
+static StreamKind stream_kind(RzBuffer *src, bool raw) {
+	ut8 hdr[2] = { 0 };
+	if (raw || rz_buf_read_at (src, 0, hdr, sizeof (hdr)) != sizeof (hdr)) {
+		return STREAM_RAW;
+	}
+	return hdr[0] == 0x1f && hdr[1] == 0x8b? STREAM_GZIP: STREAM_ZLIB;
+}
+
+/* true if a further gzip member starts at off */
+static bool next_member(RzInflateIndex *idx, ut64 off) {
+	ut8 hdr[2] = { 0 };
+	return idx->kind == STREAM_GZIP && off < idx->src_size
+		&& rz_buf_read_at (idx->src, off, hdr, sizeof (hdr)) == sizeof (hdr)
+		&& hdr[0] == 0x1f && hdr[1] == 0x8b;
+}
+
+static bool feed(RzInflateIndex *idx) {
+	if (idx->strm.avail_in) {
+		return true;
+	}
+	st64 r = rz_buf_read_at (idx->src, idx->in_pos, idx->inbuf, IN_SIZE);
+	if (r <= 0) {
+		return false;
+	}
+	idx->in_pos += r;
+	idx->strm.next_in = idx->inbuf;
+	idx->strm.avail_in = (uInt)r;
+	return true;
+}
+
+static bool add_point(RzInflateIndex *idx, ut64 in, ut64 out, int bits, const ut8 *window, ut32 left) {
+	ut8 unrolled[WINSIZE];
+	// the window is a ring whose oldest byte is at WINSIZE - left
+	if (left) {
+		memcpy (unrolled, window + WINSIZE - left, left);
+	}
+	if (left < WINSIZE) {
+		memcpy (unrolled + left, window, WINSIZE - left);
+	}
+	InflatePoint p = { 0 };
+	p.in = in;
+	p.out = out;
+	p.bits = bits;
+	p.window_len = (ut32)RZ_MIN (out, WINSIZE);
+	if (p.window_len) {
+		uLongf zlen = compressBound (p.window_len);
+		p.zwindow = malloc (zlen);
+		if (!p.zwindow || compress2 (p.zwindow, &zlen, unrolled + WINSIZE - p.window_len, p.window_len, Z_BEST_SPEED) != Z_OK) {
+			free (p.zwindow);
+			return false;
+		}
+		p.zwindow_len = (ut32)zlen;
+	}
+	if (!rz_vector_push (&idx->points, &p)) {
+		free (p.zwindow);
+		return false;
+	}
+	return true;
+}
+
+static RzInflateIndex *index_new(RzBuffer *src, bool raw, ut64 span) {
+	RzInflateIndex *idx = RZ_NEW0 (RzInflateIndex);
+	if (!idx) {
+		return NULL;
+	}
+	idx->src = rz_buf_ref (src);
+	idx->src_size = rz_buf_size (src);
+	idx->span = span;
+	idx->kind = stream_kind (src, raw);
+	rz_vector_init (&idx->points, sizeof (InflatePoint), point_fini, NULL);
+	return idx;
+}
+
+/**
+ * \brief Index \p src in a single pass over the whole stream
+ *
+ * \param raw whether \p src is raw deflate, otherwise zlib or gzip (also
+ *            concatenated members) is detected from its header
+ * \param span distance between two checkpoints in the decompressed data
+ */
+RZ_API RzInflateIndex *rz_inflate_index_new(RzBuffer *src, bool raw, ut64 span) {
+	rz_return_val_if_fail (src && span, NULL);
+	RzInflateIndex *idx = index_new (src, raw, span);
+	if (!idx) {
+		return NULL;
+	}
+	z_stream *strm = &idx->strm;
+	if (inflateInit2 (strm, raw? -MAX_WBITS: MAX_WBITS + 32) != Z_OK) {
+		rz_inflate_index_free (idx);
+		return NULL;
+	}
+	idx->strm_init = true;
+	ut8 *window = malloc (WINSIZE);
+	if (!window) {
+		rz_inflate_index_free (idx);
+		return NULL;
+	}
+	// raw streams start right away with a block, without a header to stop after
+	if (raw && !add_point (idx, 0, 0, 0, window, WINSIZE)) {
+		goto fail;
+	}
+	ut64 totin = 0, totout = 0, last = 0;
+	int ret = Z_OK;
+	strm->avail_out = 0;
+	while (true) {
+		// raw streams report their end only on a call after the last block
+		bool eof = !feed (idx);
+		do {
+			if (!strm->avail_out) {
+				strm->avail_out = WINSIZE;
+				strm->next_out = window;
+			}
+			totin += strm->avail_in;
+			totout += strm->avail_out;
+			ret = inflate (strm, Z_BLOCK);
+			totin -= strm->avail_in;
+			totout -= strm->avail_out;
+			if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
+				goto fail;
+			}
+			if (ret == Z_STREAM_END) {
+				break;
+			}
+			// at a block boundary that is not the end of the stream
+			if ((strm->data_type & 128) && !(strm->data_type & 64) && (!totout || totout - last >= span)) {
+				if (!add_point (idx, totin, totout, strm->data_type & 7, window, strm->avail_out)) {
+					goto fail;
+				}
+				last = totout;
+			}
+			// a full window may leave decoded data behind with all input consumed
+		} while (strm->avail_in || !strm->avail_out);
+		if (ret == Z_STREAM_END) {
+			if (!next_member (idx, totin)) {
+				break;
+			}
+			inflateReset (strm);
+		} else if (eof) {
+			// truncated stream
+			goto fail;
+		}
+	}
+	free (window);
+	idx->size = totout;
+	return idx;
+fail:
+	free (window);
+	rz_inflate_index_free (idx);
+	return NULL;
+}
+
+RZ_API void rz_inflate_index_free(RzInflateIndex *idx) {
+	if (!idx) {
+		return;
+	}
+	if (idx->strm_init) {
+		inflateEnd (&idx->strm);
+	}
+	size_t i;
+	for (i = 0; i < CHUNKS; i++) {
+		free (idx->chunks[i].data);
+	}
+	rz_vector_fini (&idx->points);
+	rz_buf_free (idx->src);
+	free (idx);
+}
+
+/**
+ * \brief Size of the decompressed data
+ */
+RZ_API ut64 rz_inflate_index_size(RzInflateIndex *idx) {
+	rz_return_val_if_fail (idx, 0);
+	return idx->size;
+}
+
+/**
+ * \brief Number of checkpoints in the index
+ */
+RZ_API ut32 rz_inflate_index_count(RzInflateIndex *idx) {
+	rz_return_val_if_fail (idx, 0);
+	return (ut32)rz_vector_len (&idx->points);
+}
+
+static bool resume(RzInflateIndex *idx, InflatePoint *p) {
+	z_stream *strm = &idx->strm;
+	if (!idx->strm_init) {
+		if (inflateInit2 (strm, -MAX_WBITS) != Z_OK) {
+			return false;
+		}
+		idx->strm_init = true;
+	} else if (inflateReset2 (strm, -MAX_WBITS) != Z_OK) {
+		return false;
+	}
+	idx->live = false;
+	idx->raw_now = true;
+	strm->avail_in = 0;
+	if (p->bits) {
+		ut8 b;
+		if (rz_buf_read_at (idx->src, p->in - 1, &b, 1) != 1) {
+			return false;
+		}
+		inflatePrime (strm, p->bits, b >> (8 - p->bits));
+	}
+	if (p->window_len) {
+		ut8 window[WINSIZE];
+		uLongf wlen = WINSIZE;
+		if (uncompress (window, &wlen, p->zwindow, p->zwindow_len) != Z_OK || wlen != p->window_len) {
+			return false;
+		}
+		inflateSetDictionary (strm, window, p->window_len);
+	}
+	idx->in_pos = p->in;
+	idx->live_out = p->out;
+	idx->live = true;
+	return true;
+}
+
+/* continue the live stream into out, returns the number of bytes produced */
+static st64 advance(RzInflateIndex *idx, ut8 *out, ut64 len) {
+	z_stream *strm = &idx->strm;
+	strm->next_out = out;
+	strm->avail_out = (uInt)len;
+	while (strm->avail_out) {
+		bool eof = !feed (idx);
+		uInt avail = strm->avail_out;
+		int ret = inflate (strm, Z_NO_FLUSH);
+		if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
+			idx->live = false;
+			return -1;
+		}
+		if (ret == Z_STREAM_END) {
+			// the raw decoder leaves the gzip trailer to us
+			ut64 next = idx->in_pos - strm->avail_in + (idx->raw_now? 8: 0);
+			if (!next_member (idx, next)) {
+				break;
+			}
+			idx->in_pos = next;
+			strm->avail_in = 0;
+			inflateReset2 (strm, MAX_WBITS + 16);
+			idx->raw_now = false;
+		} else if (eof && strm->avail_out == avail) {
+			// truncated stream
+			break;
+		}
+	}
+	ut64 n = len - strm->avail_out;
+	idx->live_out += n;
+	return n;
+}
+
+#define POINT_CMP(x, e) ((x) < ((InflatePoint *)(e))->out? -1: 1)
+
+static InflateChunk *chunk_get(RzInflateIndex *idx, ut64 ci) {
+	size_t i;
+	InflateChunk *victim = &idx->chunks[0];
+	for (i = 0; i < CHUNKS; i++) {
+		InflateChunk *c = &idx->chunks[i];
+		if (c->data && c->idx == ci) {
+			c->tick = ++idx->tick;
+			return c;
+		}
+		if (!c->data || (victim->data && c->tick < victim->tick)) {
+			victim = c;
+		}
+	}
+	if (!victim->data && !(victim->data = malloc (CHUNK_SIZE))) {
+		return NULL;
+	}
+	victim->idx = UT64_MAX;
+	victim->len = 0;
+	ut64 start = ci * CHUNK_SIZE;
+	// last checkpoint at or before start
+	size_t pi;
+	rz_vector_upper_bound (&idx->points, start, pi, POINT_CMP);
+	if (!pi) {
+		return NULL;
+	}
+	InflatePoint *p = rz_vector_index_ptr (&idx->points, pi - 1);
+	if (!idx->live || idx->live_out > start || idx->live_out < p->out) {
+		if (!resume (idx, p)) {
+			return NULL;
+		}
+	}
+	while (idx->live_out < start) {
+		if (advance (idx, victim->data, RZ_MIN (CHUNK_SIZE, start - idx->live_out)) <= 0) {
+			idx->live = false;
+			return NULL;
+		}
+	}
+	st64 r = advance (idx, victim->data, RZ_MIN (CHUNK_SIZE, idx->size - start));
+	if (r <= 0) {
+		idx->live = false;
+		return NULL;
+	}
+	victim->idx = ci;
+	victim->len = (ut32)r;
+	victim->tick = ++idx->tick;
+	return victim;
+}
+
+/**
+ * \brief Read \p len bytes of the decompressed data at \p off
+ *
+ * \return the number of bytes read, less than \p len only at the end of the data
+ */
+RZ_API st64 rz_inflate_index_read_at(RzInflateIndex *idx, ut64 off, ut8 *buf, ut64 len) {
+	rz_return_val_if_fail (idx && buf, -1);
+	ut64 done = 0;
+	while (done < len && off + done < idx->size) {
+		ut64 pos = off + done;
+		InflateChunk *c = chunk_get (idx, pos / CHUNK_SIZE);
+		if (!c) {
+			return done? (st64)done: -1;
+		}
+		ut64 delta = pos % CHUNK_SIZE;
+		if (delta >= c->len) {
+			break;
+		}
+		ut64 n = RZ_MIN (len - done, c->len - delta);
+		memcpy (buf + done, c->data + delta, n);
+		done += n;
+	}
+	return (st64)done;
+}
+
+/* the file is tied to its stream by the size and the last bytes of the
+ * stream, which for zlib and gzip hold its checksum */
+static bool read_tail(RzBuffer *src, ut64 src_size, ut8 *tail) {
+	memset (tail, 0, INDEX_TAIL);
+	ut64 n = RZ_MIN (src_size, INDEX_TAIL);
+	return rz_buf_read_at (src, src_size - n, tail, n) == (st64)n;
+}
+
+/**
+ * \brief Write the checkpoints of \p idx to \p file
+ */
+RZ_API bool rz_inflate_index_save(RzInflateIndex *idx, const char *file) {
+	rz_return_val_if_fail (idx && file, false);
+	ut64 size = 4 + 4 + 8 * 3 + 4 + 4 + INDEX_TAIL;
+	InflatePoint *p;
+	rz_vector_foreach (&idx->points, p) {
+		size += 8 + 8 + 1 + 4 + 4 + p->zwindow_len;
+	}
+	if (size > ST32_MAX) {
+		return false;
+	}
+	ut8 *buf = malloc (size);
+	if (!buf) {
+		return false;
+	}
+	ut8 *b = buf;
+	memcpy (b, INDEX_MAGIC, 4);
+	rz_write_le32 (b + 4, INDEX_VERSION);
+	rz_write_le64 (b + 8, idx->src_size);
+	rz_write_le64 (b + 16, idx->size);
+	rz_write_le64 (b + 24, idx->span);
+	rz_write_le32 (b + 32, idx->kind);
+	rz_write_le32 (b + 36, (ut32)rz_vector_len (&idx->points));
+	if (!read_tail (idx->src, idx->src_size, b + 40)) {
+		free (buf);
+		return false;
+	}
+	b += 40 + INDEX_TAIL;
+	rz_vector_foreach (&idx->points, p) {
+		rz_write_le64 (b, p->in);
+		rz_write_le64 (b + 8, p->out);
+		b[16] = p->bits;
+		rz_write_le32 (b + 17, p->window_len);
+		rz_write_le32 (b + 21, p->zwindow_len);
+		if (p->zwindow_len) {
+			memcpy (b + 25, p->zwindow, p->zwindow_len);
+		}
+		b += 25 + p->zwindow_len;
+	}
+	bool ret = rz_file_dump (file, buf, (int)size, false);
+	free (buf);
+	return ret;
+}
+
+/**
+ * \brief Load an index of \p src previously written by rz_inflate_index_save()
+ *
+ * \return NULL if \p file is missing, corrupt or was made for another stream
+ */
+RZ_API RzInflateIndex *rz_inflate_index_load(RzBuffer *src, const char *file) {
+	rz_return_val_if_fail (src && file, NULL);
+	size_t size;
+	ut8 *buf = (ut8 *)rz_file_slurp (file, &size);
+	if (!buf) {
+		return NULL;
+	}
+	RzInflateIndex *idx = NULL;
+	ut8 tail[INDEX_TAIL];
+	ut64 src_size = rz_buf_size (src);
+	if (size < 40 + INDEX_TAIL || memcmp (buf, INDEX_MAGIC, 4) || rz_read_le32 (buf + 4) != INDEX_VERSION
+		|| rz_read_le64 (buf + 8) != src_size || !read_tail (src, src_size, tail)
+		|| memcmp (buf + 40, tail, INDEX_TAIL) || rz_read_le32 (buf + 32) > STREAM_GZIP) {
+		goto beach;
+	}
+	idx = index_new (src, false, rz_read_le64 (buf + 24));
+	if (!idx) {
+		goto beach;
+	}
+	idx->size = rz_read_le64 (buf + 16);
+	idx->kind = rz_read_le32 (buf + 32);
+	ut32 count = rz_read_le32 (buf + 36);
+	const ut8 *b = buf + 40 + INDEX_TAIL, *end = buf + size;
+	ut32 i;
+	for (i = 0; i < count; i++) {
+		if (end - b < 25) {
+			goto fail;
+		}
+		InflatePoint p = { 0 };
+		p.in = rz_read_le64 (b);
+		p.out = rz_read_le64 (b + 8);
+		p.bits = b[16];
+		p.window_len = rz_read_le32 (b + 17);
+		p.zwindow_len = rz_read_le32 (b + 21);
+		b += 25;
+		if (p.bits > 7 || p.in > src_size || (p.bits && !p.in) || p.window_len > WINSIZE
+			|| p.out > idx->size || p.zwindow_len > (ut64)(end - b)) {
+			goto fail;
+		}
+		if (p.zwindow_len) {
+			p.zwindow = rz_mem_dup (b, p.zwindow_len);
+			if (!p.zwindow) {
+				goto fail;
+			}
+		}
+		if (!rz_vector_push (&idx->points, &p)) {
+			free (p.zwindow);
+			goto fail;
+		}
+		b += p.zwindow_len;
+	}
+	if (!count || ((InflatePoint *)rz_vector_index_ptr (&idx->points, 0))->out) {
+		goto fail;
+	}
+	goto beach;
+fail:
+	rz_inflate_index_free (idx);
+	idx = NULL;
+beach:
+	free (buf);
+	return idx;
+}
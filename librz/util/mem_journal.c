@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+
+/* The extents live in a vector in recording order, so the writes of a
+ * range of steps are found with a binary search, while the interval tree
+ * answers which extents touched a given address. Its ends are inclusive
+ * so a write can reach the last byte of the address space.
+ *
+ * Serialized format, all numbers are uleb128 but the header:
+ *   "RZMJ" | version ut32le | count ut64le
+ *   count * (step delta | zigzag addr delta from the previous end | len | bytes)
+ */
+
+#define JOURNAL_MAGIC   "RZMJ"
+#define JOURNAL_VERSION 1
+
+#define CMP_STEP(x, y) ((st64)(x) - (st64)((RzMemJournalExtent *)(y))->step)
+
+RZ_API RzMemJournal *rz_mem_journal_new(void) {
+	RzMemJournal *j = RZ_NEW0 (RzMemJournal);
+	if (!j) {
+		return NULL;
+	}
+	rz_vector_init (&j->extents, sizeof (RzMemJournalExtent), NULL, NULL);
+	rz_interval_tree_init (&j->index, NULL);
+	return j;
+}
+
+RZ_API void rz_mem_journal_free(RzMemJournal *j) {
+	if (!j) {
+		return;
+	}
+	rz_vector_fini (&j->extents);
+	rz_interval_tree_fini (&j->index);
+	free (j->data);
+	free (j);
+}
+
+/**
+ * \brief Forget every recorded write
+ */
+RZ_API void rz_mem_journal_clear(RzMemJournal *j) {
+	rz_return_if_fail (j);
+	rz_vector_clear (&j->extents);
+	rz_interval_tree_fini (&j->index);
+	rz_interval_tree_init (&j->index, NULL);
+	RZ_FREE (j->data);
+	j->data_len = j->data_size = 0;
+	j->last = NULL;
+}
+
+static bool data_append(RzMemJournal *j, const ut8 *buf, ut32 len) {
+	if (j->data_len + len > j->data_size) {
+		ut64 size = RZ_MAX (j->data_size * 2, j->data_len + len);
+		size = RZ_MAX (size, 0x1000);
+		ut8 *data = realloc (j->data, size);
+		if (!data) {
+			return false;
+		}
+		j->data = data;
+		j->data_size = size;
+	}
+	memcpy (j->data + j->data_len, buf, len);
+	j->data_len += len;
+	return true;
+}
+
+/**
+ * \brief Record that \p len bytes of \p buf were written at \p addr during \p step
+ *
+ * \p step must not be lower than the one of the previous write.
+ */
+RZ_API bool rz_mem_journal_add(RzMemJournal *j, ut32 step, ut64 addr, const ut8 *buf, ut32 len) {
+	rz_return_val_if_fail (j && buf, false);
+	RzMemJournalExtent *last = rz_vector_empty (&j->extents) ? NULL : rz_vector_index_ptr (&j->extents, rz_vector_len (&j->extents) - 1);
+	if (last && step < last->step) {
+		return false;
+	}
+	if (addr && addr + len < addr) {
+		// keep the byte at UT64_MAX too
+		len = UT64_MAX - addr + 1;
+	}
+	if (!len) {
+		return true;
+	}
+	if (!data_append (j, buf, len)) {
+		return false;
+	}
+	if (last && last->step == step && addr && last->addr + last->len == addr && last->len + len > last->len) {
+		last->len += len;
+		// only the end changes, so the node stays where it is
+		return rz_interval_tree_resize (&j->index, j->last, last->addr, last->addr + last->len - 1);
+	}
+	RzMemJournalExtent e = { addr, step, len, j->data_len - len };
+	if (!rz_vector_push (&j->extents, &e)) {
+		j->data_len -= len;
+		return false;
+	}
+	size_t idx = rz_vector_len (&j->extents);
+	if (!rz_interval_tree_insert (&j->index, addr, addr + len - 1, (void *)idx)) {
+		rz_vector_pop (&j->extents, NULL);
+		j->data_len -= len;
+		return false;
+	}
+	j->last = rz_interval_tree_node_at_data (&j->index, addr, (void *)idx);
+	return true;
+}
+
+static bool collect_cb(RzIntervalNode *node, void *user) {
+	size_t idx = (size_t)node->data - 1;
+	rz_vector_push (user, &idx);
+	return true;
+}
+
+static int cmp_idx(const void *a, const void *b) {
+	size_t x = *(const size_t *)a, y = *(const size_t *)b;
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * \brief Fill \p buf with the bytes of [addr, addr + len) as they were after \p step
+ *
+ * Bytes never written up to \p step are left untouched.
+ * \return true if any byte was written
+ */
+RZ_API bool rz_mem_journal_read_at(RzMemJournal *j, ut32 step, ut64 addr, ut8 *buf, ut32 len) {
+	rz_return_val_if_fail (j && buf, false);
+	RzVector hits;
+	bool found = false;
+	size_t *idx;
+	if (addr && addr + len < addr) {
+		len = UT64_MAX - addr + 1;
+	}
+	if (!len) {
+		return false;
+	}
+	rz_vector_init (&hits, sizeof (size_t), NULL, NULL);
+	rz_interval_tree_all_intersect (&j->index, addr, addr + len - 1, true, collect_cb, &hits);
+	// later writes win
+	qsort (hits.a, hits.len, sizeof (size_t), cmp_idx);
+	rz_vector_foreach (&hits, idx) {
+		RzMemJournalExtent *e = rz_vector_index_ptr (&j->extents, *idx);
+		if (e->step > step) {
+			break;
+		}
+		ut64 from = RZ_MAX (addr, e->addr);
+		ut64 last = RZ_MIN (addr + len - 1, e->addr + e->len - 1);
+		memcpy (buf + (from - addr), j->data + e->off + (from - e->addr), last - from + 1);
+		found = true;
+	}
+	rz_vector_fini (&hits);
+	return found;
+}
+
+/**
+ * \brief Call \p cb for every write of the steps in [from, to], in recording order
+ *
+ * Applying them in this order leaves memory as it was after step \p to,
+ * given it was as after step \p from - 1.
+ */
+RZ_API bool rz_mem_journal_replay(RzMemJournal *j, ut32 from, ut32 to, RzMemJournalCb cb, void *user) {
+	rz_return_val_if_fail (j && cb, false);
+	size_t i;
+	rz_vector_lower_bound (&j->extents, from, i, CMP_STEP);
+	for (; i < rz_vector_len (&j->extents); i++) {
+		RzMemJournalExtent *e = rz_vector_index_ptr (&j->extents, i);
+		if (e->step > to) {
+			break;
+		}
+		if (!cb (user, e->addr, j->data + e->off, e->len)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static ut8 *write_uleb(ut8 *p, ut64 v) {
+	do {
+		ut8 b = v & 0x7f;
+		v >>= 7;
+		*p++ = v ? b | 0x80 : b;
+	} while (v);
+	return p;
+}
+
+/**
+ * \brief Encode the journal in a compact binary form, see rz_mem_journal_deserialize()
+ */
+RZ_API ut8 *rz_mem_journal_serialize(RzMemJournal *j, ut64 *size) {
+	rz_return_val_if_fail (j && size, NULL);
+	size_t n = rz_vector_len (&j->extents);
+	// 10 bytes per uleb128 at worst
+	ut8 *buf = malloc (16 + n * 30 + j->data_len);
+	if (!buf) {
+		return NULL;
+	}
+	memcpy (buf, JOURNAL_MAGIC, 4);
+	rz_write_le32 (buf + 4, JOURNAL_VERSION);
+	rz_write_le64 (buf + 8, n);
+	ut8 *p = buf + 16;
+	ut64 end = 0;
+	ut32 step = 0;
+	RzMemJournalExtent *e;
+	rz_vector_foreach (&j->extents, e) {
+		st64 delta = (st64)(e->addr - end);
+		p = write_uleb (p, e->step - step);
+		p = write_uleb (p, ((ut64)delta << 1) ^ (ut64)(delta >> 63));
+		p = write_uleb (p, e->len);
+		memcpy (p, j->data + e->off, e->len);
+		p += e->len;
+		step = e->step;
+		end = e->addr + e->len;
+	}
+	*size = p - buf;
+	return buf;
+}
+
+static bool read_uleb(const ut8 **p, const ut8 *max, ut64 *v) {
+	size_t r = read_u64_leb128 (*p, max, v);
+	*p += r;
+	return r;
+}
+
+/**
+ * \brief Append the writes encoded by rz_mem_journal_serialize() to \p j
+ */
+RZ_API bool rz_mem_journal_deserialize(RzMemJournal *j, const ut8 *buf, ut64 size) {
+	rz_return_val_if_fail (j && buf, false);
+	if (size < 16 || memcmp (buf, JOURNAL_MAGIC, 4) || rz_read_le32 (buf + 4) != JOURNAL_VERSION) {
+		return false;
+	}
+	ut64 i, n = rz_read_le64 (buf + 8);
+	const ut8 *p = buf + 16, *max = buf + size;
+	ut64 end = 0;
+	ut32 step = 0;
+	for (i = 0; i < n; i++) {
+		ut64 dstep, zz, len;
+		if (!read_uleb (&p, max, &dstep) || !read_uleb (&p, max, &zz) || !read_uleb (&p, max, &len)) {
+			return false;
+		}
+		if (len > UT32_MAX || len > max - p) {
+			return false;
+		}
+		ut64 addr = end + (ut64)((st64)(zz >> 1) ^ -(st64)(zz & 1));
+		step += (ut32)dstep;
+		if (!rz_mem_journal_add (j, step, addr, p, (ut32)len)) {
+			return false;
+		}
+		p += len;
+		end = addr + len;
+	}
+	return true;
+}
@@ -3,6 +3,7 @@
 #define RZ_SERIALIZE_UTIL_H
 
 #include <rz_util/rz_str.h>
+#include <rz_util/rz_serialize.h>
 
 #define SERIALIZE_ERR(...) do { if(res) { rz_list_push (res, rz_str_newf (__VA_ARGS__)); } } while(0)
 
@@ -48,4 +49,66 @@ static inline void key_parser_add(KeyParser *parser, const char *key, int val) {
 		rip \
 	} \
 
+
+// path of the namespace ns below the one handed out by src
+static inline char *serialize_src_path(RzSerializeNsSource *src, const char *ns) {
+	return *src->path ? rz_str_newf ("%s/%s", src->path, ns) : strdup (ns);
+}
+
+// src narrowed down to the namespace ns, sub->path must be freed
+static inline bool serialize_src_sub(RzSerializeNsSource *src, const char *ns, RzSerializeNsSource *sub) {
+	*sub = *src;
+	sub->path = serialize_src_path (src, ns);
+	return sub->path != NULL;
+}
+
+// the namespace ns of db, or if src is given, a new db it was decoded into
+static inline Sdb *serialize_sub_get(Sdb *db, RzSerializeNsSource *src, const char *ns) {
+	if (!src) {
+		return sdb_ns (db, ns, false);
+	}
+	char *path = serialize_src_path (src, ns);
+	Sdb *sub = path ? sdb_new0 () : NULL;
+	if (sub && !src->load (src->user, path, sub, true)) {
+		sdb_free (sub);
+		sub = NULL;
+	}
+	free (path);
+	return sub;
+}
+
+static inline void serialize_sub_put(RzSerializeNsSource *src, Sdb *subdb) {
+	if (src) {
+		sdb_free (subdb);
+	}
+}
+
+// the path of the namespace ns if src stores it as binary records, NULL otherwise
+static inline char *serialize_src_records(RzSerializeNsSource *src, const char *ns) {
+	if (!src || !src->has_records) {
+		return NULL;
+	}
+	char *path = serialize_src_path (src, ns);
+	if (path && !src->has_records (src->user, path)) {
+		RZ_FREE (path);
+	}
+	return path;
+}
+
+/*
+ * Like SUB_DO, but with an RzSerializeNsSource *src in scope, the namespace
+ * is decoded from src only for the duration of call.
+ */
+#define SUB_SRC_DO(ns, call, rip) \
+	subdb = serialize_sub_get (db, src, ns); \
+	if (!subdb) { \
+		SERIALIZE_ERR ("missing " ns " namespace"); \
+		rip \
+	} \
+	if (!(call)) { \
+		serialize_sub_put (src, subdb); \
+		rip \
+	} \
+	serialize_sub_put (src, subdb);
+
 #endif //RZ_SERIALIZE_UTIL_H
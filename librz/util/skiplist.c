@@ -152,20 +152,11 @@ RZ_API void rz_skiplist_free(RzSkipList *list) {
 	free (list);
 }
 
-// Inserts an element to the skiplist, and returns a pointer to the element's
-// node.
-RZ_API RzSkipListNode* rz_skiplist_insert(RzSkipList* list, void* data) {
-	RzSkipListNode *update[SKIPLIST_MAX_DEPTH + 1];
+// Link `data` after the `update` points found for it and return its node.
+static RzSkipListNode *insert_at(RzSkipList *list, void *data, RzSkipListNode **update) {
 	RzSkipListNode *x;
 	int i, x_level, new_level;
 
-	// locate insertion points in the lists of all levels
-	x = find_insertpoint (list, data, update, true);
-	// check whether the element is already in the list
-	if (x != list->head && !list->compare(x->data, data)) {
-		return x;
-	}
-
 	// randomly choose the number of levels the new node will be put in
 	for (x_level = 0; rand () < RAND_MAX / 2 && x_level < SKIPLIST_MAX_DEPTH; x_level++) {
 		;
@@ -198,6 +189,59 @@ RZ_API RzSkipListNode* rz_skiplist_insert(RzSkipList* list, void* data) {
 	return x;
 }
 
+// Inserts an element to the skiplist, and returns a pointer to the element's
+// node.
+RZ_API RzSkipListNode* rz_skiplist_insert(RzSkipList* list, void* data) {
+	RzSkipListNode *update[SKIPLIST_MAX_DEPTH + 1];
+	RzSkipListNode *x;
+
+	// locate insertion points in the lists of all levels
+	x = find_insertpoint (list, data, update, true);
+	// check whether the element is already in the list
+	if (x != list->head && !list->compare(x->data, data)) {
+		return x;
+	}
+	return insert_at (list, data, update);
+}
+
+// Inserts the `n` elements of `data`, which must be sorted in ascending
+// order. Every search resumes from the insertion points of the previous
+// element instead of the head, so filling a list in order is linear.
+// Elements already in the list are skipped.
+// Returns false if a node could not be allocated.
+RZ_API bool rz_skiplist_insert_sorted(RzSkipList *list, void **data, size_t n) {
+	RzSkipListNode *update[SKIPLIST_MAX_DEPTH + 1];
+	size_t j;
+	int i;
+
+	for (i = 0; i <= SKIPLIST_MAX_DEPTH; i++) {
+		update[i] = list->head;
+	}
+	for (j = 0; j < n; j++) {
+		RzSkipListNode *x = list->head;
+		for (i = list->list_level; i >= 0; i--) {
+			// start from whichever of the two is further in the list
+			RzSkipListNode *u = update[i];
+			if (u != list->head && (x == list->head || list->compare (u->data, x->data) > 0)) {
+				x = u;
+			}
+			while (x->forward[i] != list->head
+				&& list->compare (x->forward[i]->data, data[j]) < 0) {
+				x = x->forward[i];
+			}
+			update[i] = x;
+		}
+		x = x->forward[0];
+		if (x != list->head && !list->compare (x->data, data[j])) {
+			continue;
+		}
+		if (!insert_at (list, data[j], update)) {
+			return false;
+		}
+	}
+	return true;
+}
+
 // Delete node with data as it's payload.
 RZ_API bool rz_skiplist_delete(RzSkipList* list, void* data) {
 	return delete_element (list, data, true);
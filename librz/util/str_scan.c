@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+
+/* Byte classification for the string scanners: find where the next
+ * candidate string may start, or where the current run ends, a vector
+ * at a time. SSE2 is always there on x86_64, AVX2 is picked at runtime. */
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+static bool in_class(ut8 b, int classes) {
+	return ((classes & RZ_STR_SCAN_PRINTABLE) && b >= 0x20 && b <= 0x7e)
+		|| ((classes & RZ_STR_SCAN_TAB) && b == '\t')
+		|| ((classes & RZ_STR_SCAN_ESCAPES) && ((b >= 0x07 && b <= 0x0d) || b == 0x1b))
+		|| ((classes & RZ_STR_SCAN_UTF8_LEAD) && b >= 0xc0 && b <= 0xf7);
+}
+
+static size_t scan_scalar(const ut8 *buf, size_t len, int classes, bool in) {
+	size_t i;
+	for (i = 0; i < len; i++) {
+		if (in_class (buf[i], classes) == in) {
+			break;
+		}
+	}
+	return i;
+}
+
+#if SCAN_X86
+/* bytes are biased by 0x80 so that the signed compares order them as unsigned */
+#define B(x) ((char)((x) ^ 0x80))
+
+static inline __m128i range_sse2(__m128i v, ut8 lo, ut8 hi) {
+	return _mm_and_si128 (_mm_cmpgt_epi8 (v, _mm_set1_epi8 (B (lo - 1))), _mm_cmplt_epi8 (v, _mm_set1_epi8 (B (hi + 1))));
+}
+
+static size_t scan_sse2(const ut8 *buf, size_t len, int classes, bool in) {
+	const __m128i bias = _mm_set1_epi8 ((char)0x80);
+	size_t i;
+	for (i = 0; i + 16 <= len; i += 16) {
+		__m128i v = _mm_xor_si128 (_mm_loadu_si128 ((const __m128i *)(buf + i)), bias);
+		__m128i m = _mm_setzero_si128 ();
+		if (classes & RZ_STR_SCAN_PRINTABLE) {
+			m = _mm_or_si128 (m, range_sse2 (v, 0x20, 0x7e));
+		}
+		if (classes & RZ_STR_SCAN_TAB) {
+			m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 (B ('\t'))));
+		}
+		if (classes & RZ_STR_SCAN_ESCAPES) {
+			m = _mm_or_si128 (m, range_sse2 (v, 0x07, 0x0d));
+			m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 (B (0x1b))));
+		}
+		if (classes & RZ_STR_SCAN_UTF8_LEAD) {
+			m = _mm_or_si128 (m, range_sse2 (v, 0xc0, 0xf7));
+		}
+		ut32 mask = (ut32)_mm_movemask_epi8 (m);
+		if (!in) {
+			mask = ~mask & 0xffff;
+		}
+		if (mask) {
+			return i + __builtin_ctz (mask);
+		}
+	}
+	return i + scan_scalar (buf + i, len - i, classes, in);
+}
+
+__attribute__((target ("avx2")))
+static inline __m256i range_avx2(__m256i v, ut8 lo, ut8 hi) {
+	return _mm256_and_si256 (_mm256_cmpgt_epi8 (v, _mm256_set1_epi8 (B (lo - 1))), _mm256_cmpgt_epi8 (_mm256_set1_epi8 (B (hi + 1)), v));
+}
+
+__attribute__((target ("avx2")))
+static size_t scan_avx2(const ut8 *buf, size_t len, int classes, bool in) {
+	const __m256i bias = _mm256_set1_epi8 ((char)0x80);
+	size_t i;
+	for (i = 0; i + 32 <= len; i += 32) {
+		__m256i v = _mm256_xor_si256 (_mm256_loadu_si256 ((const __m256i *)(buf + i)), bias);
+		__m256i m = _mm256_setzero_si256 ();
+		if (classes & RZ_STR_SCAN_PRINTABLE) {
+			m = _mm256_or_si256 (m, range_avx2 (v, 0x20, 0x7e));
+		}
+		if (classes & RZ_STR_SCAN_TAB) {
+			m = _mm256_or_si256 (m, _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (B ('\t'))));
+		}
+		if (classes & RZ_STR_SCAN_ESCAPES) {
+			m = _mm256_or_si256 (m, range_avx2 (v, 0x07, 0x0d));
+			m = _mm256_or_si256 (m, _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (B (0x1b))));
+		}
+		if (classes & RZ_STR_SCAN_UTF8_LEAD) {
+			m = _mm256_or_si256 (m, range_avx2 (v, 0xc0, 0xf7));
+		}
+		ut32 mask = (ut32)_mm256_movemask_epi8 (m);
+		if (!in) {
+			mask = ~mask;
+		}
+		if (mask) {
+			return i + __builtin_ctz (mask);
+		}
+	}
+	return i + scan_sse2 (buf + i, len - i, classes, in);
+}
+#endif
+
+static size_t scan(const ut8 *buf, size_t len, int classes, bool in) {
+	rz_return_val_if_fail (buf || !len, 0);
+#if SCAN_X86
+	static int has_avx2 = -1;
+	if (has_avx2 < 0) {
+		has_avx2 = __builtin_cpu_supports ("avx2");
+	}
+	return has_avx2? scan_avx2 (buf, len, classes, in): scan_sse2 (buf, len, classes, in);
+#else
+	return scan_scalar (buf, len, classes, in);
+#endif
+}
+
+/* Forced UTF-16LE/UTF-32LE scans step over a byte that cannot start a UTF-8
+ * sequence, and over a whole unit holding a control that is neither \0 nor
+ * an escape. The walk depends on where it starts, so the bytes are classified
+ * a block at a time into masks and the steps are taken on their bits. */
+typedef struct {
+	ut64 bad; ///< 0x80 to 0xbf and 0xf8 to 0xff
+	ut64 ctl; ///< 0x00 to 0x06, 0x0e to 0x1a, 0x1c to 0x1f and 0x7f
+	ut64 zero;
+} WideMasks;
+
+static inline bool wide_bad(ut8 b) {
+	return (b >= 0x80 && b <= 0xbf) || b >= 0xf8;
+}
+
+static inline bool wide_ctl(ut8 b) {
+	return b <= 0x06 || (b >= 0x0e && b <= 0x1a) || (b >= 0x1c && b <= 0x1f) || b == 0x7f;
+}
+
+static void wide_masks_scalar(const ut8 *buf, WideMasks *m) {
+	int i;
+	memset (m, 0, sizeof (*m));
+	for (i = 0; i < 64; i++) {
+		m->bad |= (ut64)wide_bad (buf[i]) << i;
+		m->ctl |= (ut64)wide_ctl (buf[i]) << i;
+		m->zero |= (ut64)!buf[i] << i;
+	}
+}
+
+#if SCAN_X86
+static void wide_masks_sse2(const ut8 *buf, WideMasks *m) {
+	const __m128i bias = _mm_set1_epi8 ((char)0x80);
+	int i;
+	memset (m, 0, sizeof (*m));
+	for (i = 0; i < 64; i += 16) {
+		__m128i v = _mm_xor_si128 (_mm_loadu_si128 ((const __m128i *)(buf + i)), bias);
+		__m128i bad = _mm_or_si128 (range_sse2 (v, 0x80, 0xbf), _mm_cmpgt_epi8 (v, _mm_set1_epi8 (B (0xf7))));
+		__m128i ctl = _mm_or_si128 (_mm_cmplt_epi8 (v, _mm_set1_epi8 (B (0x07))), range_sse2 (v, 0x0e, 0x1a));
+		ctl = _mm_or_si128 (ctl, range_sse2 (v, 0x1c, 0x1f));
+		ctl = _mm_or_si128 (ctl, _mm_cmpeq_epi8 (v, _mm_set1_epi8 (B (0x7f))));
+		__m128i zero = _mm_cmpeq_epi8 (v, bias);
+		m->bad |= (ut64)(ut32)_mm_movemask_epi8 (bad) << i;
+		m->ctl |= (ut64)(ut32)_mm_movemask_epi8 (ctl) << i;
+		m->zero |= (ut64)(ut32)_mm_movemask_epi8 (zero) << i;
+	}
+}
+
+__attribute__((target ("avx2")))
+static void wide_masks_avx2(const ut8 *buf, WideMasks *m) {
+	const __m256i bias = _mm256_set1_epi8 ((char)0x80);
+	int i;
+	memset (m, 0, sizeof (*m));
+	for (i = 0; i < 64; i += 32) {
+		__m256i v = _mm256_xor_si256 (_mm256_loadu_si256 ((const __m256i *)(buf + i)), bias);
+		__m256i bad = _mm256_or_si256 (range_avx2 (v, 0x80, 0xbf), _mm256_cmpgt_epi8 (v, _mm256_set1_epi8 (B (0xf7))));
+		__m256i ctl = _mm256_or_si256 (_mm256_cmpgt_epi8 (_mm256_set1_epi8 (B (0x07)), v), range_avx2 (v, 0x0e, 0x1a));
+		ctl = _mm256_or_si256 (ctl, range_avx2 (v, 0x1c, 0x1f));
+		ctl = _mm256_or_si256 (ctl, _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (B (0x7f))));
+		__m256i zero = _mm256_cmpeq_epi8 (v, bias);
+		m->bad |= (ut64)(ut32)_mm256_movemask_epi8 (bad) << i;
+		m->ctl |= (ut64)(ut32)_mm256_movemask_epi8 (ctl) << i;
+		m->zero |= (ut64)(ut32)_mm256_movemask_epi8 (zero) << i;
+	}
+}
+#endif
+
+/**
+ * \brief Skip what a forced UTF-16LE or UTF-32LE string scan steps over
+ *
+ * From the start of \p buf, steps one byte over the bytes that cannot start
+ * a UTF-8 sequence and \p width bytes over the units that hold a control
+ * other than \0 and the escapes, zero-extended, until neither applies.
+ *
+ * \param width 2 for UTF-16LE, 4 for UTF-32LE
+ * \return the offset where the walk stops, a unit that may start a string
+ */
+RZ_API size_t rz_str_scan_wide_next(const ut8 *buf, size_t len, size_t width) {
+	rz_return_val_if_fail ((buf || !len) && (width == 2 || width == 4), 0);
+	void (*masks)(const ut8 *, WideMasks *) = wide_masks_scalar;
+#if SCAN_X86
+	static int has_avx2 = -1;
+	if (has_avx2 < 0) {
+		has_avx2 = __builtin_cpu_supports ("avx2");
+	}
+	masks = has_avx2? wide_masks_avx2: wide_masks_sse2;
+#endif
+	size_t i = 0;
+	// a walk over the first 32 bytes of a block may end up to 3 past them
+	while (i + 64 <= len) {
+		WideMasks m;
+		masks (buf + i, &m);
+		ut64 unit = m.ctl & m.zero >> 1;
+		if (width == 4) {
+			unit &= m.zero >> 2 & m.zero >> 3;
+		}
+		size_t p = 0;
+		while (p < 32) {
+			if (m.bad >> p & 1) {
+				p++;
+			} else if (unit >> p & 1) {
+				p += width;
+			} else {
+				return i + p;
+			}
+		}
+		i += p;
+	}
+	while (i < len) {
+		if (wide_bad (buf[i])) {
+			i++;
+		} else if (i + width <= len && wide_ctl (buf[i]) && !buf[i + 1]
+			&& (width == 2 || (!buf[i + 2] && !buf[i + 3]))) {
+			i += width;
+		} else {
+			break;
+		}
+	}
+	return i;
+}
+
+/**
+ * \brief Find the first byte of \p buf that belongs to one of \p classes
+ *
+ * \param classes a mask of RzStrScanClass
+ * \return its offset, or \p len if there is none
+ */
+RZ_API size_t rz_str_scan_next(const ut8 *buf, size_t len, int classes) {
+	return scan (buf, len, classes, true);
+}
+
+/**
+ * \brief Count the bytes at the start of \p buf that belong to one of \p classes
+ */
+RZ_API size_t rz_str_scan_span(const ut8 *buf, size_t len, int classes) {
+	return scan (buf, len, classes, false);
+}
@@ -39,6 +39,10 @@ RZ_API char *rz_strpool_alloc (RzStrpool *p, int l) {
 		} else {
 			p->size += RZ_STRPOOL_INC;
 		}
+		// grow geometrically, pools with many strings would realloc all the time
+		if (osize + osize / 2 < ST32_MAX) {
+			p->size = RZ_MAX (p->size, (int)(osize + osize / 2));
+		}
 		if (p->size < osize) {
 			eprintf ("Underflow!\n");
 			p->size = osize;
@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_th.h>
+#include <rz_util.h>
+
+/* fixed size pool of workers consuming jobs from a shared fifo */
+
+typedef struct rz_th_pool_job_t {
+	RzThreadPoolJob fn;
+	void *user;
+	struct rz_th_pool_job_t *next;
+} RzThreadPoolJobItem;
+
+static RzThreadFunctionRet pool_worker(RzThread *th) {
+	RzThreadPool *pool = th->user;
+	rz_th_lock_enter (pool->lock);
+	while (!pool->head && !pool->quit) {
+		rz_th_cond_wait (pool->has_job, pool->lock);
+	}
+	RzThreadPoolJobItem *job = pool->head;
+	if (!job) {
+		rz_th_lock_leave (pool->lock);
+		return RZ_TH_STOP;
+	}
+	pool->head = job->next;
+	if (!pool->head) {
+		pool->tail = NULL;
+	}
+	pool->busy++;
+	rz_th_lock_leave (pool->lock);
+
+	job->fn (job->user);
+	free (job);
+
+	rz_th_lock_enter (pool->lock);
+	pool->busy--;
+	if (!pool->busy && !pool->head) {
+		rz_th_cond_signal_all (pool->idle);
+	}
+	rz_th_lock_leave (pool->lock);
+	return RZ_TH_REPEAT;
+}
+
+RZ_API int rz_th_ncores(void) {
+#if __WINDOWS__
+	SYSTEM_INFO si;
+	GetSystemInfo (&si);
+	return RZ_MAX ((int)si.dwNumberOfProcessors, 1);
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long n = sysconf (_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#else
+	return 1;
+#endif
+}
+
+/**
+ * \brief Create a pool of \p size worker threads, a size <= 0 uses one thread per core
+ */
+RZ_API RzThreadPool *rz_th_pool_new(int size) {
+	RzThreadPool *pool = RZ_NEW0 (RzThreadPool);
+	if (!pool) {
+		return NULL;
+	}
+	if (size <= 0) {
+		size = rz_th_ncores ();
+	}
+	pool->lock = rz_th_lock_new (false);
+	pool->has_job = rz_th_cond_new ();
+	pool->idle = rz_th_cond_new ();
+	pool->threads = RZ_NEWS0 (RzThread *, size);
+	if (!pool->lock || !pool->has_job || !pool->idle || !pool->threads) {
+		rz_th_pool_free (pool);
+		return NULL;
+	}
+	for (pool->size = 0; pool->size < size; pool->size++) {
+		RzThread *th = rz_th_new (pool_worker, pool, 0);
+		if (!th) {
+			break;
+		}
+		pool->threads[pool->size] = th;
+	}
+	if (!pool->size) {
+		rz_th_pool_free (pool);
+		return NULL;
+	}
+	return pool;
+}
+
+/**
+ * \brief Queue \p fn to be called with \p user by the first idle worker
+ */
+RZ_API bool rz_th_pool_add_job(RzThreadPool *pool, RzThreadPoolJob fn, void *user) {
+	rz_return_val_if_fail (pool && fn, false);
+	RzThreadPoolJobItem *job = RZ_NEW0 (RzThreadPoolJobItem);
+	if (!job) {
+		return false;
+	}
+	job->fn = fn;
+	job->user = user;
+	rz_th_lock_enter (pool->lock);
+	if (pool->tail) {
+		pool->tail->next = job;
+	} else {
+		pool->head = job;
+	}
+	pool->tail = job;
+	rz_th_cond_signal (pool->has_job);
+	rz_th_lock_leave (pool->lock);
+	return true;
+}
+
+/**
+ * \brief Block until the job queue is empty and every worker is idle
+ */
+RZ_API void rz_th_pool_wait(RzThreadPool *pool) {
+	rz_return_if_fail (pool);
+	rz_th_lock_enter (pool->lock);
+	while (pool->head || pool->busy) {
+		rz_th_cond_wait (pool->idle, pool->lock);
+	}
+	rz_th_lock_leave (pool->lock);
+}
+
+/**
+ * \brief Stop the workers once the pending jobs have been run and free the pool
+ */
+RZ_API void rz_th_pool_free(RzThreadPool *pool) {
+	if (!pool) {
+		return;
+	}
+	if (pool->lock) {
+		if (pool->size) {
+			rz_th_pool_wait (pool);
+		}
+		rz_th_lock_enter (pool->lock);
+		pool->quit = true;
+		if (pool->has_job) {
+			rz_th_cond_signal_all (pool->has_job);
+		}
+		rz_th_lock_leave (pool->lock);
+	}
+	int i;
+	for (i = 0; i < pool->size; i++) {
+		rz_th_wait (pool->threads[i]);
+		rz_th_free (pool->threads[i]);
+	}
+	while (pool->head) {
+		RzThreadPoolJobItem *next = pool->head->next;
+		free (pool->head);
+		pool->head = next;
+	}
+	free (pool->threads);
+	rz_th_cond_free (pool->has_job);
+	rz_th_cond_free (pool->idle);
+	rz_th_lock_free (pool->lock);
+	free (pool);
+}
@@ -54,6 +54,9 @@ void sprint_mem(char *out, const ut8 *buf, size_t len) {
 
 #define mu_ignore do { printf(TYELLOW "IGN\n" TRESET); return MU_PASSED; } while(0)
 
+// benchmarks are skipped unless RZ_TEST_BENCH is set in the environment
+#define mu_bench do { if (!getenv ("RZ_TEST_BENCH")) { mu_ignore; } } while(0)
+
 #define mu_end do { \
 		printf(TGREEN "OK\n" TRESET); \
 		return MU_PASSED; \
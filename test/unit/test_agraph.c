@@ -99,8 +99,130 @@ bool test_graph_to_agraph() {
 	mu_end;
 }
 
+#define LARGE_CFG_BLOCKS 2000
+
+/* a function with many blocks: mostly fallthroughs and short jumps, some
+ * loops, long jumps and switch tables */
+static void add_large_cfg(RzAGraph *g, int blocks) {
+	RzANode **nodes = RZ_NEWS (RzANode *, blocks);
+	ut32 x = 0x1337;
+	int i, k;
+
+	for (i = 0; i < blocks; i++) {
+		char *title = rz_str_newf ("0x%x", 0x1000 + i * 0x10);
+		nodes[i] = rz_agraph_add_node (g, title, i % 3? "mov eax, ebx\n": "mov eax, ebx\nadd eax, 1\ncmp eax, 3\n");
+		free (title);
+	}
+	for (i = 0; i < blocks - 1; i++) {
+		x = x * 1103515245 + 12345;
+		ut32 r = (x >> 8) % 100;
+		if (r < 70) {
+			rz_agraph_add_edge (g, nodes[i], nodes[i + 1]);
+		}
+		x = x * 1103515245 + 12345;
+		if (r >= 40 && r < 85) {
+			int span = 1 + (x >> 8) % (r < 75? 8: 60);
+			int to = r < 80? i + span: i - span;
+			if (to >= 0 && to < blocks) {
+				rz_agraph_add_edge (g, nodes[i], nodes[to]);
+			}
+		} else if (r >= 85 && r < 88) {
+			for (k = 0; k < 2 + (int)(x >> 8) % 10; k++) {
+				int to = i + 1 + (k * 7 + (x >> 12)) % 30;
+				if (to < blocks) {
+					rz_agraph_add_edge (g, nodes[i], nodes[to]);
+				}
+			}
+		}
+	}
+	free (nodes);
+}
+
+static void get_positions(Sdb *db, int *pos_x, int *pos_y) {
+	// the whole graph may be shifted, so take them relative to the entry
+	int x0 = (int)sdb_num_get (db, "agraph.nodes.0x1000.x", NULL);
+	int y0 = (int)sdb_num_get (db, "agraph.nodes.0x1000.y", NULL);
+	int i;
+	for (i = 0; i < LARGE_CFG_BLOCKS; i++) {
+		pos_x[i] = (int)sdb_num_get (db, sdb_fmt ("agraph.nodes.0x%x.x", 0x1000 + i * 0x10), NULL) - x0;
+		pos_y[i] = (int)sdb_num_get (db, sdb_fmt ("agraph.nodes.0x%x.y", 0x1000 + i * 0x10), NULL) - y0;
+	}
+}
+
+bool test_agraph_layout_large(void) {
+	rz_cons_new ();
+	RzAGraph *g = rz_agraph_new (rz_cons_canvas_new (1, 1));
+	mu_assert_notnull (g, "graph");
+	add_large_cfg (g, LARGE_CFG_BLOCKS);
+
+	int *x0 = RZ_NEWS0 (int, LARGE_CFG_BLOCKS), *y0 = RZ_NEWS0 (int, LARGE_CFG_BLOCKS);
+	int *x1 = RZ_NEWS0 (int, LARGE_CFG_BLOCKS), *y1 = RZ_NEWS0 (int, LARGE_CFG_BLOCKS);
+	Sdb *db = rz_agraph_get_sdb (g);
+	mu_assert_notnull (db, "layout");
+	mu_assert_true (sdb_exists (db, "agraph.nodes.0x1000.x"), "entry placed");
+	mu_assert_true (sdb_exists (db, sdb_fmt ("agraph.nodes.0x%x.y", 0x1000 + (LARGE_CFG_BLOCKS - 1) * 0x10)), "last block placed");
+	get_positions (db, x0, y0);
+	int i;
+	for (i = 1; i < LARGE_CFG_BLOCKS; i++) {
+		mu_assert_true (y0[i] >= 0, "entry on top");
+	}
+
+	// each layout starts from the coordinates of the previous one, let them settle
+	rz_agraph_get_sdb (g);
+	get_positions (rz_agraph_get_sdb (g), x0, y0);
+
+	// a taller body only pushes down the layers below it
+	RzANode *n = rz_agraph_get_node (g, "0x1640");
+	mu_assert_notnull (n, "node");
+	free (n->body);
+	n->body = strdup ("mov eax, ebx\nmov eax, ebx\nmov eax, ebx\nmov eax, ebx\nmov eax, ebx\nmov eax, ebx\n");
+	get_positions (rz_agraph_get_sdb (g), x1, y1);
+	mu_assert_memeq ((ut8 *)x1, (ut8 *)x0, LARGE_CFG_BLOCKS * sizeof (int), "x kept");
+	int moved = 0;
+	for (i = 0; i < LARGE_CFG_BLOCKS; i++) {
+		mu_assert_true (y1[i] >= y0[i], "nodes only move down");
+		if (y0[i] <= y0[100]) {
+			mu_assert_eq (y1[i], y0[i], "layers above kept");
+		}
+		moved += y1[i] != y0[i];
+	}
+	mu_assert_true (moved > 0, "layers below moved");
+
+	free (x0);
+	free (y0);
+	free (x1);
+	free (y1);
+	rz_agraph_free (g);
+	rz_cons_free ();
+	mu_end;
+}
+
+bool test_agraph_layout_bench(void) {
+	mu_bench;
+	const int sizes[] = { 500, 2000, 5000 };
+	size_t i;
+	rz_cons_new ();
+	for (i = 0; i < RZ_ARRAY_SIZE (sizes); i++) {
+		RzAGraph *g = rz_agraph_new (rz_cons_canvas_new (1, 1));
+		mu_assert_notnull (g, "graph");
+		add_large_cfg (g, sizes[i]);
+		ut64 t0 = rz_time_now_mono ();
+		rz_agraph_get_sdb (g);
+		ut64 t1 = rz_time_now_mono ();
+		// same layered graph, the order of the previous layout is reused
+		rz_agraph_get_sdb (g);
+		ut64 t2 = rz_time_now_mono ();
+		printf ("%d blocks: layout %.3fs, relayout %.3fs\n", sizes[i], (t1 - t0) / 1e6, (t2 - t1) / 1e6);
+		rz_agraph_free (g);
+	}
+	rz_cons_free ();
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test (test_graph_to_agraph);
+	mu_run_test (test_agraph_layout_large);
+	mu_run_test (test_agraph_layout_bench);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,232 @@
+#include <rz_analysis.h>
+#include <rz_diff.h>
+#include "minunit.h"
+
+static ut32 seed;
+
+static ut8 *random_bytes(ut32 size) {
+	ut8 *buf = malloc (size);
+	ut32 i;
+	for (i = 0; buf && i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+	return buf;
+}
+
+static ut8 *mutated(const ut8 *src, ut32 size, ut32 changes) {
+	ut8 *buf = rz_mem_dup (src, size);
+	ut32 i;
+	for (i = 0; buf && i < changes; i++) {
+		buf[(i * 7 + 3) % size] ^= 0x5a;
+	}
+	return buf;
+}
+
+/* one block covering the whole function, fingerprinted with buf */
+static RzAnalysisFunction *add_fcn(RzAnalysis *analysis, const char *name, ut64 addr, const ut8 *buf, ut32 size) {
+	RzAnalysisFunction *fcn = rz_analysis_create_function (analysis, name, addr, RZ_ANALYSIS_FCN_TYPE_FCN, NULL);
+	RzAnalysisBlock *bb = rz_analysis_create_block (analysis, addr, size);
+	if (!fcn || !bb) {
+		return NULL;
+	}
+	rz_analysis_function_add_block (fcn, bb);
+	bb->fingerprint = rz_mem_dup (buf, size);
+	rz_analysis_block_unref (bb);
+	fcn->fingerprint = rz_mem_dup (buf, size);
+	fcn->fingerprint_size = size;
+	return fcn;
+}
+
+bool test_analysis_diff_fcn_rounds(void) {
+	RzAnalysis *a = rz_analysis_new ();
+	RzAnalysis *b = rz_analysis_new ();
+	seed = 1;
+	ut8 *main_buf = random_bytes (64);
+	ut8 *foo_buf = random_bytes (64);
+	ut8 *bar_buf = random_bytes (64);
+	ut8 *lonely_buf = random_bytes (64);
+	ut8 *other_buf = random_bytes (64);
+	ut8 *main2_buf = mutated (main_buf, 64, 2);
+	ut8 *bar2_buf = mutated (bar_buf, 64, 4);
+
+	RzAnalysisFunction *main_a = add_fcn (a, "main", 0x1000, main_buf, 64);
+	RzAnalysisFunction *foo = add_fcn (a, "foo", 0x2000, foo_buf, 64);
+	RzAnalysisFunction *bar = add_fcn (a, "bar", 0x3000, bar_buf, 64);
+	RzAnalysisFunction *lonely = add_fcn (a, "lonely", 0x4000, lonely_buf, 64);
+	RzAnalysisFunction *main_b = add_fcn (b, "main", 0x1100, main2_buf, 64);
+	RzAnalysisFunction *foo2 = add_fcn (b, "foo_renamed", 0x2100, foo_buf, 64);
+	RzAnalysisFunction *bar2 = add_fcn (b, "bar_v2", 0x3100, bar2_buf, 64);
+	RzAnalysisFunction *other = add_fcn (b, "other", 0x5000, other_buf, 64);
+
+	mu_assert_true (rz_analysis_diff_fcn (a, a->fcns, b->fcns), "diff");
+	RzAnalysisDiffStats *st = &a->diff_stats;
+	mu_assert_eq (st->by_name, 1, "matched by name");
+	mu_assert_eq (st->by_hash, 1, "matched by fingerprint hash");
+	mu_assert_eq (st->by_callgraph, 0, "matched by callgraph");
+	mu_assert_eq (st->by_similarity, 1, "matched by similarity");
+
+	mu_assert_eq (main_a->diff->addr, main_b->addr, "same name");
+	mu_assert_true (main_a->diff->dist < 1.0, "same name, changed body");
+	mu_assert_eq (foo->diff->addr, foo2->addr, "renamed, same body");
+	mu_assert_eq (foo->diff->type, RZ_ANALYSIS_DIFF_TYPE_MATCH, "renamed, same body");
+	mu_assert_streq (foo->diff->name, "foo_renamed", "renamed, same body");
+	mu_assert_eq (foo2->diff->addr, foo->addr, "match is symmetric");
+	mu_assert_eq (bar->diff->addr, bar2->addr, "renamed, changed body");
+	mu_assert_true (bar->diff->dist > a->diff_thfcn && bar->diff->dist < 1.0, "renamed, changed body");
+	mu_assert_eq (lonely->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, "no counterpart");
+	mu_assert_eq (other->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, "no counterpart");
+
+	free (main_buf);
+	free (foo_buf);
+	free (bar_buf);
+	free (lonely_buf);
+	free (other_buf);
+	free (main2_buf);
+	free (bar2_buf);
+	rz_analysis_free (a);
+	rz_analysis_free (b);
+	mu_end;
+}
+
+bool test_analysis_diff_fcn_callgraph(void) {
+	RzAnalysis *a = rz_analysis_new ();
+	RzAnalysis *b = rz_analysis_new ();
+	seed = 2;
+	ut8 *main_buf = random_bytes (32);
+	ut8 *callee_buf = random_bytes (64);
+	ut8 *callee2_buf = mutated (callee_buf, 64, 8);
+	ut8 *decoy_buf = mutated (callee_buf, 64, 2);
+
+	add_fcn (a, "main", 0x1000, main_buf, 32);
+	RzAnalysisFunction *callee = add_fcn (a, "callee", 0x2000, callee_buf, 64);
+	rz_analysis_xrefs_set (a, 0x1010, 0x2000, RZ_ANALYSIS_REF_TYPE_CALL);
+	add_fcn (b, "main", 0x1000, main_buf, 32);
+	RzAnalysisFunction *callee2 = add_fcn (b, "callee_v2", 0x2000, callee2_buf, 64);
+	RzAnalysisFunction *decoy = add_fcn (b, "decoy", 0x3000, decoy_buf, 64);
+	rz_analysis_xrefs_set (b, 0x1010, 0x2000, RZ_ANALYSIS_REF_TYPE_CALL);
+
+	mu_assert_true (rz_analysis_diff_fcn (a, a->fcns, b->fcns), "diff");
+	RzAnalysisDiffStats *st = &a->diff_stats;
+	mu_assert_eq (st->by_name, 1, "matched by name");
+	mu_assert_eq (st->by_callgraph, 1, "matched by callgraph");
+	mu_assert_eq (st->by_similarity, 0, "matched by similarity");
+	// the decoy is closer, only the call from main points to the real one
+	mu_assert_eq (callee->diff->addr, callee2->addr, "callee of a matched pair");
+	mu_assert_eq (decoy->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, "decoy left unmatched");
+
+	free (main_buf);
+	free (callee_buf);
+	free (callee2_buf);
+	free (decoy_buf);
+	rz_analysis_free (a);
+	rz_analysis_free (b);
+	mu_end;
+}
+
+#define LSH_FCNS 40
+
+typedef struct {
+	ut8 *buf;
+	ut32 size;
+} Fingerprint;
+
+static bool size_ok(RzAnalysis *analysis, ut32 s1, ut32 s2) {
+	return !(RZ_MAX (s1, s2) * analysis->diff_thfcn > RZ_MIN (s1, s2));
+}
+
+bool test_analysis_diff_fcn_lsh_vs_quadratic(void) {
+	RzAnalysis *a = rz_analysis_new ();
+	RzAnalysis *b = rz_analysis_new ();
+	Fingerprint fa[LSH_FCNS], fb[LSH_FCNS];
+	ut64 expect[LSH_FCNS];
+	bool taken[LSH_FCNS] = { 0 };
+	char name[32];
+	ut32 i, j;
+	seed = 3;
+	for (i = 0; i < LSH_FCNS; i++) {
+		fa[i].size = 48 + (i * 13) % 48;
+		fa[i].buf = random_bytes (fa[i].size);
+	}
+	// b holds a changed copy of most functions of a, in another order, and a few unrelated ones
+	for (i = 0; i < LSH_FCNS; i++) {
+		ut32 k = (i * 17 + 5) % LSH_FCNS;
+		if (k % 5 == 4) {
+			fb[i].size = 48 + (i * 7) % 48;
+			fb[i].buf = random_bytes (fb[i].size);
+		} else {
+			fb[i].size = fa[k].size;
+			fb[i].buf = mutated (fa[k].buf, fa[k].size, 1 + i % 6);
+		}
+	}
+	for (i = 0; i < LSH_FCNS; i++) {
+		snprintf (name, sizeof (name), "a_%u", i);
+		add_fcn (a, name, 0x1000 + i * 0x100, fa[i].buf, fa[i].size);
+		snprintf (name, sizeof (name), "b_%u", i);
+		add_fcn (b, name, 0x1000 + i * 0x100, fb[i].buf, fb[i].size);
+	}
+
+	// compare every pair, in the order the similarity round tries them
+	for (i = 0; i < LSH_FCNS; i++) {
+		double best_t = 0.0;
+		st64 best = -1;
+		ut32 best_delta = UT32_MAX;
+		expect[i] = UT64_MAX;
+		for (j = 0; j < LSH_FCNS; j++) {
+			ut32 delta = fa[i].size > fb[j].size ? fa[i].size - fb[j].size : fb[j].size - fa[i].size;
+			double t = 0.0;
+			if (taken[j] || !size_ok (a, fa[i].size, fb[j].size)) {
+				continue;
+			}
+			rz_diff_buffers_distance (NULL, fa[i].buf, fa[i].size, fb[j].buf, fb[j].size, NULL, &t);
+			if (t > a->diff_thfcn && (t > best_t || (t == best_t && delta < best_delta))) {
+				best_t = t;
+				best = j;
+				best_delta = delta;
+			}
+		}
+		if (best >= 0) {
+			taken[best] = true;
+			expect[i] = 0x1000 + best * 0x100;
+		}
+	}
+
+	a->diff_threads = 4;
+	mu_assert_true (rz_analysis_diff_fcn (a, a->fcns, b->fcns), "diff");
+	mu_assert_eq (a->diff_stats.by_name + a->diff_stats.by_hash + a->diff_stats.by_callgraph, 0, "only the similarity round matches");
+	RzAnalysisFunction *fcn;
+	RzListIter *iter;
+	i = 0;
+	rz_list_foreach (a->fcns, iter, fcn) {
+		ut32 k = (fcn->addr - 0x1000) / 0x100;
+		snprintf (name, sizeof (name), "match of a_%u", k);
+		if (expect[k] == UT64_MAX) {
+			mu_assert_eq (fcn->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, name);
+		} else {
+			mu_assert_neq (fcn->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, name);
+			mu_assert_eq (fcn->diff->addr, expect[k], name);
+			i++;
+		}
+	}
+	mu_assert_eq (a->diff_stats.by_similarity, i, "pairs");
+	mu_assert_true (a->diff_stats.distances < LSH_FCNS * LSH_FCNS / 4, "distances computed");
+
+	for (i = 0; i < LSH_FCNS; i++) {
+		free (fa[i].buf);
+		free (fb[i].buf);
+	}
+	rz_analysis_free (a);
+	rz_analysis_free (b);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_analysis_diff_fcn_rounds);
+	mu_run_test (test_analysis_diff_fcn_callgraph);
+	mu_run_test (test_analysis_diff_fcn_lsh_vs_quadratic);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
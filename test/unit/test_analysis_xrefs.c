@@ -18,8 +18,91 @@ bool test_r_analysis_xrefs_count() {
 	mu_end;
 }
 
+typedef struct {
+	ut64 at[16];
+	ut64 addr[16];
+	int n;
+} CollectedRefs;
+
+static bool collect_cb(void *user, const RzAnalysisRef *ref) {
+	CollectedRefs *c = user;
+	c->at[c->n] = ref->at;
+	c->addr[c->n] = ref->addr;
+	c->n++;
+	return c->n < 16;
+}
+
+bool test_r_analysis_xrefs_update_del() {
+	RzAnalysis *analysis = rz_analysis_new ();
+
+	rz_analysis_xrefs_set (analysis, 0x100, 0x200, RZ_ANALYSIS_REF_TYPE_CODE);
+	rz_analysis_xrefs_set (analysis, 0x100, 0x200, RZ_ANALYSIS_REF_TYPE_CALL);
+	mu_assert_eq (rz_analysis_xrefs_count (analysis), 1, "same pair is stored once");
+	RzList *refs = rz_analysis_refs_get (analysis, 0x100);
+	mu_assert_eq (rz_list_length (refs), 1, "refs count");
+	mu_assert_eq (((RzAnalysisRef *)rz_list_first (refs))->type, RZ_ANALYSIS_REF_TYPE_CALL, "type is updated");
+	rz_list_free (refs);
+
+	rz_analysis_xrefs_set (analysis, 0x100, 0x300, RZ_ANALYSIS_REF_TYPE_CODE);
+	rz_analysis_xref_del (analysis, 0x100, 0x200);
+	mu_assert_eq (rz_analysis_xrefs_count (analysis), 1, "xrefs count after delete");
+	mu_assert_null (rz_analysis_xrefs_get (analysis, 0x200), "no xrefs left to 0x200");
+	refs = rz_analysis_refs_get (analysis, 0x100);
+	mu_assert_eq (rz_list_length (refs), 1, "other refs from the same address are kept");
+	mu_assert_eq (((RzAnalysisRef *)rz_list_first (refs))->addr, 0x300, "remaining ref");
+	rz_list_free (refs);
+
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
+bool test_r_analysis_xrefs_many() {
+	RzAnalysis *analysis = rz_analysis_new ();
+	ut64 i;
+
+	// enough pairs to go through several merges
+	for (i = 0; i < 5000; i++) {
+		rz_analysis_xrefs_set (analysis, 0x1000 + (i * 7919) % 5000, 0x100000 + i % 3, RZ_ANALYSIS_REF_TYPE_DATA);
+	}
+	mu_assert_eq (rz_analysis_xrefs_count (analysis), 5000, "xrefs count");
+	for (i = 0; i < 5000; i += 2) {
+		rz_analysis_xref_del (analysis, 0x1000 + (i * 7919) % 5000, 0x100000 + i % 3);
+	}
+	mu_assert_eq (rz_analysis_xrefs_count (analysis), 2500, "xrefs count after delete");
+	RzList *xrefs = rz_analysis_xrefs_get (analysis, 0x100001);
+	ut64 n = rz_list_length (xrefs);
+	RzAnalysisRef *prev = NULL, *ref;
+	RzListIter *iter;
+	rz_list_foreach (xrefs, iter, ref) {
+		mu_assert_eq (ref->at, 0x100001, "xref target");
+		mu_assert ("xrefs are sorted by source", !prev || prev->addr < ref->addr);
+		prev = ref;
+	}
+	rz_list_free (xrefs);
+	mu_assert_eq (n, 834, "xrefs to 0x100001");
+
+	CollectedRefs c = { 0 };
+	mu_assert_false (rz_analysis_refs_foreach_in (analysis, 0x1000, 0x2000, collect_cb, &c), "iteration stopped by the callback");
+	mu_assert_eq (c.n, 16, "collected refs");
+	for (i = 1; i < c.n; i++) {
+		mu_assert ("refs are sorted by source", c.at[i - 1] < c.at[i]);
+	}
+	c.n = 0;
+	mu_assert_true (rz_analysis_refs_foreach_in (analysis, 0x1001, 0x1002, collect_cb, &c), "range iteration");
+	mu_assert_eq (c.n, 1, "one ref from 0x1001");
+	mu_assert_eq (c.at[0], 0x1001, "ref source");
+	c.n = 0;
+	mu_assert_true (rz_analysis_xrefs_foreach (analysis, 0x100003, collect_cb, &c), "xrefs iteration");
+	mu_assert_eq (c.n, 0, "no xrefs to 0x100003");
+
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test (test_r_analysis_xrefs_count);
+	mu_run_test (test_r_analysis_xrefs_update_del);
+	mu_run_test (test_r_analysis_xrefs_many);
 	return tests_passed != tests_run;
 }
 
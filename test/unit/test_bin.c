@@ -23,8 +23,146 @@ bool test_r_bin(void) {
 }
 
 
+static RzBin *open_bin(const char *file, bool lazy) {
+	RzBin *bin = rz_bin_new ();
+	RzIO *io = rz_io_new ();
+	rz_io_bind (io, &bin->iob);
+	bin->lazy = lazy;
+	RzBinOptions opt = {0};
+	if (!rz_bin_open (bin, file, &opt)) {
+		rz_bin_free (bin);
+		rz_io_free (io);
+		return NULL;
+	}
+	return bin;
+}
+
+static void close_bin(RzBin *bin) {
+	RzIO *io = bin->iob.io;
+	rz_bin_free (bin);
+	rz_io_free (io);
+}
+
+static bool check_demangle_all(const char *file, const char *lang) {
+	RzBin *bin = open_bin (file, false);
+	mu_assert_notnull (bin, "binary could not be opened");
+
+	// the names demangled one by one, without the cache
+	RzList *symbols = rz_list_newf (free);
+	RzListIter *iter;
+	RzBinSymbol *sym;
+	RzBinImport *imp;
+	rz_list_foreach (rz_bin_get_symbols (bin), iter, sym) {
+		rz_list_append (symbols, strdup (sym->name));
+	}
+	rz_list_foreach (rz_bin_get_imports (bin), iter, imp) {
+		rz_list_append (symbols, strdup (imp->name));
+	}
+	RzList *expect = rz_list_newf (free);
+	HtPP *cache = bin->demangled;
+	bin->demangled = NULL;
+	char *name;
+	rz_list_foreach (symbols, iter, name) {
+		rz_list_append (expect, rz_bin_demangle (bin->cur, lang, name, 0, false));
+	}
+	bin->demangled = cache;
+
+	rz_bin_demangle_all (bin->cur, lang, 4);
+	int demangled = 0;
+	RzListIter *it = rz_list_iterator (expect);
+	rz_list_foreach (symbols, iter, name) {
+		const char *e = rz_list_iter_get (it);
+		char *d = rz_bin_demangle (bin->cur, lang, name, 0, false);
+		mu_assert_true (e? d && !strcmp (e, d): !d, name);
+		demangled += e != NULL;
+		free (d);
+	}
+	mu_assert_true (demangled > 0, "some symbols demangled");
+	mu_assert_true (bin->demangled->count > 0, "cached");
+	rz_bin_file_delete_all (bin);
+	mu_assert_eq (bin->demangled->count, 0, "cache cleared with the last file");
+
+	rz_list_free (expect);
+	rz_list_free (symbols);
+	close_bin (bin);
+	return true;
+}
+
+bool test_rz_bin_demangle_all(void) {
+	mu_assert_true (check_demangle_all ("bins/elf/demangle-test-cpp", "c++"), "c++");
+	// the msvc demangler is not reentrant
+	mu_assert_true (check_demangle_all ("bins/pe/cpp-msvc-x86.exe", "msvc"), "msvc");
+
+	RzBin *bin = open_bin ("bins/elf/demangle-test-cpp", false);
+	mu_assert_notnull (bin, "demangle-test-cpp binary could not be opened");
+	char *d = rz_bin_demangle (bin->cur, "c++", "_ZN3foo3barEv", 0, false);
+	mu_assert_streq (d, "foo::bar()", "not prefetched");
+	free (d);
+	d = rz_bin_demangle (bin->cur, "c++", "_ZN3foo3barEv", 0, false);
+	mu_assert_streq (d, "foo::bar()", "cached");
+	free (d);
+	close_bin (bin);
+	mu_end;
+}
+
+bool test_rz_bin_lazy(void) {
+	RzBin *eager = open_bin ("bins/elf/ioli/crackme0x00", false);
+	RzBin *lazy = open_bin ("bins/elf/ioli/crackme0x00", true);
+	mu_assert ("crackme0x00 binary could not be opened", eager && lazy);
+	mu_assert_eq (rz_bin_cur_object (eager)->lazy_items, 0, "eager open loads everything");
+	mu_assert_neq (rz_bin_cur_object (lazy)->lazy_items, 0, "lazy open defers items");
+
+	RzList *syms = rz_bin_get_symbols (eager);
+	RzList *lazy_syms = rz_bin_get_symbols (lazy);
+	mu_assert_eq (rz_list_length (lazy_syms), rz_list_length (syms), "symbols count");
+	RzListIter *iter, *it = rz_list_iterator (lazy_syms);
+	RzBinSymbol *sym;
+	rz_list_foreach (syms, iter, sym) {
+		RzBinSymbol *s = rz_list_iter_get (it);
+		mu_assert_streq (s->name, sym->name, "symbol name");
+		mu_assert_eq (s->vaddr, sym->vaddr, "symbol vaddr");
+	}
+
+	RzList *imps = rz_bin_get_imports (eager);
+	RzList *lazy_imps = rz_bin_get_imports (lazy);
+	mu_assert_eq (rz_list_length (lazy_imps), rz_list_length (imps), "imports count");
+	it = rz_list_iterator (lazy_imps);
+	RzBinImport *imp;
+	rz_list_foreach (imps, iter, imp) {
+		RzBinImport *i = rz_list_iter_get (it);
+		mu_assert_streq (i->name, imp->name, "import name");
+	}
+
+	RBNode *relocs = rz_bin_get_relocs (eager);
+	RBNode *lazy_relocs = rz_bin_get_relocs (lazy);
+	RzList *vaddrs = rz_list_newf (free);
+	RBIter rit;
+	RzBinReloc *reloc;
+	rz_rbtree_foreach (relocs, rit, reloc, RzBinReloc, vrb) {
+		ut64 *v = RZ_NEW (ut64);
+		*v = reloc->vaddr;
+		rz_list_append (vaddrs, v);
+	}
+	mu_assert_true (rz_list_length (vaddrs) > 0, "some relocs");
+	it = rz_list_iterator (vaddrs);
+	rz_rbtree_foreach (lazy_relocs, rit, reloc, RzBinReloc, vrb) {
+		mu_assert_notnull (it, "relocs count");
+		ut64 *v = rz_list_iter_get (it);
+		mu_assert_eq (reloc->vaddr, *v, "reloc vaddr");
+	}
+	mu_assert_null (it, "relocs count");
+	mu_assert_eq (rz_bin_cur_object (lazy)->lazy_items & (RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_IMPORTS | RZ_BIN_REQ_RELOCS), 0, "loaded on use");
+
+	rz_list_free (vaddrs);
+	close_bin (eager);
+	close_bin (lazy);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_r_bin);
+	mu_run_test(test_rz_bin_lazy);
+	mu_run_test(test_rz_bin_demangle_all);
 	return tests_passed != tests_run;
 }
 
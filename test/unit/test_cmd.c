@@ -311,6 +311,48 @@ bool test_cmd_call_desc(void) {
 	mu_end;
 }
 
+bool test_cmd_call_read_only(void) {
+	RzCmdDescArg pd_help_args[] = {
+		{ .name = "n1", .type = RZ_CMD_ARG_TYPE_NUM },
+		{ 0 },
+	};
+	RzCmdDescHelp pd_help = {
+		.args = pd_help_args,
+	};
+
+	RzCmd *cmd = rz_cmd_new (false);
+	RzCmdDesc *root = rz_cmd_get_root (cmd);
+	RzCmdDesc *p_cd = rz_cmd_desc_group_new (cmd, root, "p", NULL, NULL, &fake_help);
+	RzCmdDesc *pd_cd = rz_cmd_desc_argv_new (cmd, p_cd, "pd", pd_handler, &pd_help);
+	RzCmdDesc *wv_cd = rz_cmd_desc_oldinput_new (cmd, root, "wv", wv_handler, NULL);
+	RzCmdDesc *a_cd = rz_cmd_desc_group_new (cmd, root, "a", NULL, NULL, &fake_help);
+	a_cd->read_only = true;
+	mu_assert_false (rz_cmd_desc_is_read_only (pd_cd), "not flagged");
+	mu_assert_false (rz_cmd_desc_is_read_only (a_cd), "flagged, but nothing to call");
+	pd_cd->read_only = true;
+	mu_assert_true (rz_cmd_desc_is_read_only (pd_cd), "flagged");
+	mu_assert_false (rz_cmd_desc_is_read_only (p_cd), "the group is not");
+
+	char *pd_args[] = {"10"};
+	char *wv8_args[] = {"0xdeadbeef"};
+
+	RzCmdParsedArgs *a = rz_cmd_parsed_args_new ("pd", 1, pd_args);
+	mu_assert_eq (rz_cmd_call_read_only (cmd, a), RZ_CMD_STATUS_OK, "pd was called");
+	rz_cmd_parsed_args_free (a);
+
+	a = rz_cmd_parsed_args_new ("wv8", 1, wv8_args);
+	mu_assert_eq (rz_cmd_call_read_only (cmd, a), RZ_CMD_STATUS_INVALID, "wv is not read-only");
+	rz_cmd_parsed_args_free (a);
+
+	wv_cd->read_only = true;
+	a = rz_cmd_parsed_args_new ("wv8", 1, wv8_args);
+	mu_assert_eq (rz_cmd_call_read_only (cmd, a), RZ_CMD_STATUS_OK, "wv was called");
+	rz_cmd_parsed_args_free (a);
+
+	rz_cmd_free (cmd);
+	mu_end;
+}
+
 bool test_cmd_help(void) {
 	const RzCmdDescHelp p_group_help = {
 		.summary = "p summary",
@@ -710,6 +752,7 @@ int all_tests() {
 	mu_run_test (test_cmd_descriptor_group);
 	mu_run_test (test_cmd_get_desc);
 	mu_run_test (test_cmd_call_desc);
+	mu_run_test (test_cmd_call_read_only);
 	mu_run_test (test_cmd_help);
 	mu_run_test (test_cmd_group_help);
 	mu_run_test (test_cmd_oldinput_help);
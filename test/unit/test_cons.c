@@ -1,4 +1,5 @@
 #include <rz_cons.h>
+#include <rz_th.h>
 #include "minunit.h"
 
 bool test_r_cons() {
@@ -279,12 +280,66 @@ bool test_line_multicompletion(void) {
 	mu_end;
 }
 
+typedef struct {
+	RzConsContext *ctx;
+	int n;
+	bool own;
+} ThreadPrint;
+
+static RzThreadFunctionRet thread_print(RzThread *th) {
+	ThreadPrint *tp = th->user;
+	rz_cons_context_load_thread (tp->ctx);
+	int i;
+	for (i = 0; i < 1000; i++) {
+		rz_cons_printf ("%d\n", tp->n);
+	}
+	tp->own = rz_cons_context () == tp->ctx;
+	rz_cons_context_load_thread (NULL);
+	return RZ_TH_STOP;
+}
+
+bool test_cons_context_thread(void) {
+	rz_cons_new ();
+	rz_cons_reset ();
+	ThreadPrint tp[4] = { 0 };
+	RzThread *th[4];
+	int i;
+	for (i = 0; i < 4; i++) {
+		tp[i].ctx = rz_cons_context_new (rz_cons_context ());
+		tp[i].n = 10 + i;
+		th[i] = rz_th_new (thread_print, &tp[i], 0);
+		mu_assert_notnull (th[i], "rz_th_new");
+	}
+	rz_cons_printf ("main\n");
+	for (i = 0; i < 4; i++) {
+		rz_th_wait (th[i]);
+		rz_th_free (th[i]);
+	}
+	mu_assert_true (rz_cons_context_is_main (), "main thread keeps the shared context");
+	mu_assert_eq (rz_cons_context ()->buffer_len, 5, "main output");
+	for (i = 0; i < 4; i++) {
+		char line[4];
+		snprintf (line, sizeof (line), "%d\n", tp[i].n);
+		mu_assert_true (tp[i].own, "thread sees its own context");
+		mu_assert_eq (tp[i].ctx->buffer_len, 3000, "thread output");
+		size_t j;
+		for (j = 0; j < 3000; j += 3) {
+			mu_assert_memeq ((ut8 *)tp[i].ctx->buffer + j, (ut8 *)line, 3, "thread output not mixed");
+		}
+		rz_cons_context_free (tp[i].ctx);
+	}
+	rz_cons_reset ();
+	rz_cons_free ();
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test (test_r_cons);
 	mu_run_test (test_cons_to_html);
 	mu_run_test (test_line_nocompletion);
 	mu_run_test (test_line_onecompletion);
 	mu_run_test (test_line_multicompletion);
+	mu_run_test (test_cons_context_thread);
 	return tests_passed != tests_run;
 }
 
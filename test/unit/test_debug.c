@@ -1,7 +1,9 @@
 #include <rz_debug.h>
 #include "minunit.h"
 #if __linux__
+#include <signal.h>
 #include <sys/user.h>
+#include <sys/wait.h>
 
 #ifndef offsetof
 #define offsetof(type, field) ((size_t) &((type *)0)->field)
@@ -52,9 +54,205 @@ bool test_r_debug_reg_offset(void) {
 	mu_end;
 }
 
+#if __linux__
+#define MEM_SIZE   0x10000
+#define MEM_RANGES 16
+
+// runs while the child is alive, the caller kills it whatever the result
+static bool check_mem_ranges(RzIO *io, RzIODesc *desc, int pid, ut64 addr, const ut8 *mem, ut8 *buf, ut8 *check) {
+	const char *backends[] = { "ptrace", "vm" };
+	size_t i;
+	for (i = 0; i < 2; i++) {
+		free (rz_io_system (io, backends[i]));
+		memset (buf, 0, MEM_SIZE);
+		rz_io_fd_read_at (io, desc->fd, addr, buf, MEM_SIZE);
+		mu_assert_memeq (buf, mem, MEM_SIZE, backends[i]);
+	}
+
+	RzDebug *dbg = rz_debug_new (true);
+	mu_assert_notnull (dbg, "rz_debug_new () failed");
+	rz_debug_use (dbg, "native");
+	rz_io_bind (io, &dbg->iob);
+	dbg->pid = dbg->tid = pid;
+	RzDebugMemRange ranges[MEM_RANGES];
+	for (i = 0; i < MEM_RANGES; i++) {
+		ut64 off = i * (MEM_SIZE / MEM_RANGES);
+		ranges[i] = (RzDebugMemRange){ addr + off, buf + off, MEM_SIZE / MEM_RANGES };
+	}
+	memset (buf, 0, MEM_SIZE);
+	rz_debug_mem_readv (dbg, ranges, MEM_RANGES);
+	bool ok = !memcmp (buf, mem, MEM_SIZE);
+
+	for (i = 0; i < MEM_SIZE; i++) {
+		buf[i] ^= 0xff;
+	}
+	rz_debug_mem_writev (dbg, ranges, MEM_RANGES);
+	rz_io_fd_read_at (io, desc->fd, addr, check, MEM_SIZE);
+	ok = ok && !memcmp (check, buf, MEM_SIZE);
+
+	// an unmapped range in the middle does not stop the others
+	RzDebugMemRange holes[3] = {
+		{ addr, check, 16 },
+		{ 0, check + 16, 16 },
+		{ addr + 16, check + 32, 16 }
+	};
+	memset (check, 0, 48);
+	rz_debug_mem_readv (dbg, holes, 3);
+	rz_debug_free (dbg);
+	mu_assert_true (ok, "readv and writev");
+	mu_assert_memeq (check, buf, 16, "range before the hole");
+	mu_assert_memeq (check + 32, buf + 16, 16, "range after the hole");
+	return true;
+}
+#endif
+
+bool test_r_debug_mem_ranges(void) {
+#if __linux__
+	ut8 *mem = malloc (MEM_SIZE);
+	ut8 *buf = malloc (MEM_SIZE);
+	ut8 *check = malloc (MEM_SIZE);
+	RzIO *io = rz_io_new ();
+	bool ok = false, ignore = false;
+	pid_t pid = -1;
+	if (!mem || !buf || !check || !io) {
+		goto beach;
+	}
+	size_t i;
+	for (i = 0; i < MEM_SIZE; i++) {
+		mem[i] = i * 7 + (i >> 12);
+	}
+	// the child has the same memory at the same addresses
+	pid = fork ();
+	if (!pid) {
+		for (;;) {
+			pause ();
+		}
+	}
+	if (pid < 0) {
+		goto beach;
+	}
+	io->va = false;
+	char uri[32];
+	snprintf (uri, sizeof (uri), "attach://%d", pid);
+	RzIODesc *desc = rz_io_open_nomap (io, uri, RZ_PERM_RW, 0);
+	if (!desc) {
+		// ptrace is not permitted here
+		ignore = true;
+		goto beach;
+	}
+	rz_io_use_fd (io, desc->fd);
+	ok = check_mem_ranges (io, desc, pid, (ut64)(size_t)mem, mem, buf, check);
+	rz_io_desc_close (desc);
+beach:
+	if (pid > 0) {
+		kill (pid, SIGKILL);
+		waitpid (pid, NULL, 0);
+	}
+	rz_io_free (io);
+	free (mem);
+	free (buf);
+	free (check);
+	if (ignore) {
+		mu_ignore;
+	}
+	mu_assert_true (ok, "memory ranges of the child");
+#endif //__linux__
+	mu_end;
+}
+
+#if __linux__
+#define BENCH_SIZE   (1024 * 1024)
+#define BENCH_RANGES 64
+
+static double mbps(ut64 len, ut64 t0) {
+	ut64 dt = RZ_MAX (rz_time_now_mono () - t0, 1);
+	return (double)len / dt; // bytes per µs is MB/s
+}
+
+static void bench_mem(RzIO *io, RzIODesc *desc, int pid, ut64 addr, ut8 *buf) {
+	const char *backends[] = { "ptrace", "vm" };
+	double speed[3];
+	size_t i;
+	for (i = 0; i < 2; i++) {
+		free (rz_io_system (io, backends[i]));
+		ut64 t0 = rz_time_now_mono ();
+		rz_io_fd_read_at (io, desc->fd, addr, buf, BENCH_SIZE);
+		speed[i] = mbps (BENCH_SIZE, t0);
+	}
+	RzDebug *dbg = rz_debug_new (true);
+	if (!dbg) {
+		return;
+	}
+	rz_debug_use (dbg, "native");
+	rz_io_bind (io, &dbg->iob);
+	dbg->pid = dbg->tid = pid;
+	RzDebugMemRange ranges[BENCH_RANGES];
+	for (i = 0; i < BENCH_RANGES; i++) {
+		ut64 off = i * (BENCH_SIZE / BENCH_RANGES);
+		ranges[i] = (RzDebugMemRange){ addr + off, buf + off, BENCH_SIZE / BENCH_RANGES };
+	}
+	ut64 t0 = rz_time_now_mono ();
+	rz_debug_mem_readv (dbg, ranges, BENCH_RANGES);
+	speed[2] = mbps (BENCH_SIZE, t0);
+	rz_debug_free (dbg);
+	printf ("ptrace: %.1f MB/s, process_vm: %.1f MB/s, process_vm in %d ranges: %.1f MB/s\n",
+		speed[0], speed[1], BENCH_RANGES, speed[2]);
+}
+#endif
+
+bool test_r_debug_mem_bench(void) {
+	mu_bench;
+#if __linux__
+	ut8 *mem = calloc (1, BENCH_SIZE);
+	ut8 *buf = malloc (BENCH_SIZE);
+	RzIO *io = rz_io_new ();
+	bool ok = false, ignore = false;
+	pid_t pid = -1;
+	if (!mem || !buf || !io) {
+		goto beach;
+	}
+	pid = fork ();
+	if (!pid) {
+		for (;;) {
+			pause ();
+		}
+	}
+	if (pid < 0) {
+		goto beach;
+	}
+	io->va = false;
+	char uri[32];
+	snprintf (uri, sizeof (uri), "attach://%d", pid);
+	RzIODesc *desc = rz_io_open_nomap (io, uri, RZ_PERM_RW, 0);
+	if (!desc) {
+		ignore = true;
+		goto beach;
+	}
+	rz_io_use_fd (io, desc->fd);
+	bench_mem (io, desc, pid, (ut64)(size_t)mem, buf);
+	rz_io_desc_close (desc);
+	ok = true;
+beach:
+	if (pid > 0) {
+		kill (pid, SIGKILL);
+		waitpid (pid, NULL, 0);
+	}
+	rz_io_free (io);
+	free (mem);
+	free (buf);
+	if (ignore) {
+		mu_ignore;
+	}
+	mu_assert_true (ok, "benchmark setup");
+#endif //__linux__
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test (test_r_debug_use);
 	mu_run_test (test_r_debug_reg_offset);
+	mu_run_test (test_r_debug_mem_ranges);
+	mu_run_test (test_r_debug_mem_bench);
 	return tests_passed != tests_run;
 }
 
@@ -12,8 +12,7 @@ Sdb *ref_db() {
 	sdb_set (registers_db, "0x100", "[{\"cnum\":0,\"data\":1094861636},{\"cnum\":1,\"data\":3735928559}]", 0);
 
 	Sdb *memory_sdb = sdb_ns (db, "memory", true);
-	sdb_set (memory_sdb, "0x7ffffffff000", "[{\"cnum\":0,\"data\":170},{\"cnum\":1,\"data\":187}]", 0);
-	sdb_set (memory_sdb, "0x7ffffffff001", "[{\"cnum\":0,\"data\":0},{\"cnum\":1,\"data\":1}]", 0);
+	sdb_set (memory_sdb, "journal", "UlpNSgEAAAACAAAAAAAAAACAwP////8/AqoAAQMCuwE=", 0);
 
 	Sdb *checkpoints_sdb = sdb_ns (db, "checkpoints", true);
 	sdb_set (checkpoints_sdb, "0x0", "{"
@@ -41,14 +40,13 @@ RzDebugSession *ref_session() {
 
 	// Registers & Memory
 	rz_debug_session_add_reg_change (s, 0, 0x100, 0x41424344);
-	rz_debug_session_add_mem_change (s, 0x7ffffffff000, 0xaa);
-	rz_debug_session_add_mem_change (s, 0x7ffffffff001, 0x00);
+	rz_debug_session_add_mem_change (s, 0x7ffffffff000, (const ut8 *)"\xaa", 1);
+	rz_debug_session_add_mem_change (s, 0x7ffffffff001, (const ut8 *)"\x00", 1);
 	s->maxcnum++;
 	s->cnum++;
 
 	rz_debug_session_add_reg_change (s, 0, 0x100, 0xdeadbeef);
-	rz_debug_session_add_mem_change (s, 0x7ffffffff000, 0xbb);
-	rz_debug_session_add_mem_change (s, 0x7ffffffff001, 0x01);
+	rz_debug_session_add_mem_change (s, 0x7ffffffff000, (const ut8 *)"\xbb\x01", 2);
 
 	// Checkpoints
 	RzDebugCheckpoint checkpoint = { 0 };
@@ -66,8 +64,9 @@ RzDebugSession *ref_session() {
 	snap->perm = 7;
 	snap->user = 0;
 	snap->shared = true;
-	snap->data = malloc (snap->size);
-	memset (snap->data, 0xf0, snap->size);
+	ut8 data[0x100];
+	memset (data, 0xf0, sizeof (data));
+	rz_debug_snap_set_data (snap, data, NULL);
 	rz_list_append (checkpoint.snaps, snap);
 	rz_vector_push (s->checkpoints, &checkpoint);
 
@@ -114,20 +113,16 @@ static bool compare_registers_cb(void *user, const ut64 key, const void *value)
 	return true;
 }
 
-static bool compare_memory_cb(void *user, const ut64 key, const void *value) {
-	RzDebugChangeMem *actual_mem, *expected_mem;
-	HtUP *ref = user;
-	RzVector *actual_vmem = (RzVector *)value;
-
-	RzVector *expected_vmem = ht_up_find (ref, key, NULL);
-	mu_assert ("vmem not found", expected_vmem);
-	mu_assert_eq (actual_vmem->len, expected_vmem->len, "vmem length");
-
+static bool memory_eq(RzMemJournal *actual, RzMemJournal *expected) {
+	RzMemJournalExtent *actual_ext, *expected_ext;
+	mu_assert_eq (rz_mem_journal_count (actual), rz_mem_journal_count (expected), "extents count");
 	size_t i;
-	rz_vector_enumerate (actual_vmem, actual_mem, i) {
-		expected_mem = rz_vector_index_ptr (expected_vmem, i);
-		mu_assert_eq (actual_mem->cnum, expected_mem->cnum, "cnum");
-		mu_assert_eq (actual_mem->data, expected_mem->data, "data");
+	rz_vector_enumerate (&actual->extents, actual_ext, i) {
+		expected_ext = rz_vector_index_ptr (&expected->extents, i);
+		mu_assert_eq (actual_ext->step, expected_ext->step, "cnum");
+		mu_assert_eq (actual_ext->addr, expected_ext->addr, "addr");
+		mu_assert_eq (actual_ext->len, expected_ext->len, "len");
+		mu_assert_memeq (actual->data + actual_ext->off, expected->data + expected_ext->off, expected_ext->len, "data");
 	}
 	return true;
 }
@@ -148,7 +143,7 @@ static bool snap_eq(RzDebugSnap *actual, RzDebugSnap *expected) {
 	mu_assert_eq (actual->perm, expected->perm, "snap perm");
 	mu_assert_eq (actual->user, expected->user, "snap user");
 	mu_assert_eq (actual->shared, expected->shared, "snap shared");
-	mu_assert_memeq (actual->data, expected->data, expected->size, "snap data");
+	mu_assert_true (rz_debug_snap_is_equal (actual, expected), "snap data");
 	return true;
 }
 
@@ -162,7 +157,7 @@ static bool test_session_load(void) {
 	// Registers
 	ht_up_foreach (s->registers, compare_registers_cb, ref->registers);
 	// Memory
-	ht_up_foreach (s->memory, compare_memory_cb, ref->memory);
+	memory_eq (s->memory, ref->memory);
 	// Checkpoints
 	size_t i, chkpt_idx;
 	RzDebugCheckpoint *chkpt, *ref_chkpt;
@@ -190,9 +185,75 @@ static bool test_session_load(void) {
 	mu_end;
 }
 
+static bool test_session_load_legacy_memory(void) {
+	RzDebugSession *ref = ref_session ();
+	RzDebugSession *s = rz_debug_session_new ();
+	Sdb *db = ref_db ();
+	Sdb *memory_sdb = sdb_ns (db, "memory", false);
+	sdb_unset (memory_sdb, "journal", 0);
+	sdb_set (memory_sdb, "0x7ffffffff000", "[{\"cnum\":0,\"data\":170},{\"cnum\":1,\"data\":187}]", 0);
+	sdb_set (memory_sdb, "0x7ffffffff001", "[{\"cnum\":0,\"data\":0},{\"cnum\":1,\"data\":1}]", 0);
+	rz_debug_session_deserialize (s, db);
+
+	mu_assert ("legacy memory", memory_eq (s->memory, ref->memory));
+
+	sdb_free (db);
+	rz_debug_session_free (s);
+	rz_debug_session_free (ref);
+	mu_end;
+}
+
+static RzDebugSnap *snap_of(ut32 size, const ut8 *data, RzDebugSnap *prev) {
+	RzDebugSnap *snap = RZ_NEW0 (RzDebugSnap);
+	snap->name = strdup ("[heap]");
+	snap->addr = 0x10000;
+	snap->size = size;
+	snap->addr_end = snap->addr + size;
+	rz_debug_snap_set_data (snap, data, prev);
+	return snap;
+}
+
+static bool test_snap_shared_pages(void) {
+	const ut32 size = 3 * RZ_DEBUG_SNAP_PAGE_SIZE + 0x10;
+	ut8 *data = malloc (size);
+	memset (data, 0x42, size);
+	RzDebugSnap *a = snap_of (size, data, NULL);
+	mu_assert_notnull (a, "snap");
+	mu_assert_notnull (a->pages, "pages");
+
+	data[RZ_DEBUG_SNAP_PAGE_SIZE + 1] = 0x43;
+	data[size - 1] = 0x44;
+	RzDebugSnap *b = snap_of (size, data, a);
+	mu_assert_ptreq (b->pages[0], a->pages[0], "unchanged page shared");
+	mu_assert_ptrneq (b->pages[1], a->pages[1], "changed page copied");
+	mu_assert_ptreq (b->pages[2], a->pages[2], "unchanged page shared");
+	mu_assert_ptrneq (b->pages[3], a->pages[3], "changed partial page copied");
+	mu_assert_eq (a->pages[0]->refs, 2, "shared page refs");
+	mu_assert_eq (b->pages[1]->refs, 1, "copied page refs");
+	mu_assert_false (rz_debug_snap_is_equal (a, b), "snaps differ");
+
+	ut8 *copy = rz_debug_snap_get_data (b);
+	mu_assert_memeq (copy, data, size, "contiguous data");
+	free (copy);
+
+	RzDebugSnap *c = snap_of (size, data, b);
+	mu_assert_true (rz_debug_snap_is_equal (b, c), "snaps equal");
+	mu_assert_ptreq (c->pages[1], b->pages[1], "page shared again");
+	// pages outlive the snapshot they were created by
+	rz_debug_snap_free (a);
+	mu_assert_eq (c->pages[0]->refs, 2, "refs after free");
+	mu_assert_eq (c->pages[0]->data[0], 0x42, "page alive after free");
+	rz_debug_snap_free (c);
+	rz_debug_snap_free (b);
+	free (data);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test (test_session_save);
 	mu_run_test (test_session_load);
+	mu_run_test (test_session_load_legacy_memory);
+	mu_run_test (test_snap_shared_pages);
 	return tests_passed != tests_run;
 }
 
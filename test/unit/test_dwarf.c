@@ -153,6 +153,13 @@ bool test_dwarf3_c_basic(void) { // this should work for dwarf2 aswell
 		mu_assert_eq (row->address, test_addresses[i++], "Line number statement address doesn't match");
 	}
 
+	RzBinDwarfLineTable *lines = bin->cur->dwarf_lines;
+	mu_assert_notnull (lines, "line table");
+	mu_assert_eq (rz_vector_len (&lines->entries), 8, "line table rows");
+	const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (lines, 0x1132);
+	mu_assert_notnull (e, "line table lookup");
+	mu_assert_eq (e->address, 0x1131, "line table lookup address");
+
 	rz_list_free (line_list);
 	rz_bin_dwarf_free_debug_abbrev (da);
 	rz_bin_free (bin);
@@ -1279,6 +1286,64 @@ bool test_big_endian_dwarf2(void) {
 	mu_end;
 }
 
+bool test_dwarf_line_table(void) {
+	RzBinDwarfLineTable *t = rz_bin_dwarf_line_table_new ();
+	mu_assert_notnull (t, "line table");
+	ut32 main_c = rz_bin_dwarf_line_table_file_id (t, "/src/main.c");
+	ut32 util_h = rz_bin_dwarf_line_table_file_id (t, "/src/util.h");
+	mu_assert_eq (main_c, 0, "first file");
+	mu_assert_eq (util_h, 1, "second file");
+	mu_assert_eq (rz_bin_dwarf_line_table_file_id (t, "/src/main.c"), main_c, "interned file");
+
+	// two sequences, out of order, the second one repeats an address
+	rz_bin_dwarf_line_table_add (t, 0x2000, util_h, 3, 1);
+	rz_bin_dwarf_line_table_add (t, 0x2008, util_h, 4, 1);
+	rz_bin_dwarf_line_table_add (t, 0x1000, main_c, 10, 0);
+	rz_bin_dwarf_line_table_add (t, 0x1004, main_c, 11, 0);
+	rz_bin_dwarf_line_table_add (t, 0x1004, main_c, 12, 0);
+	rz_bin_dwarf_line_table_add (t, 0x1010, main_c, 11, 0);
+	mu_assert_true (rz_bin_dwarf_line_table_finish (t), "finish");
+	mu_assert_eq (rz_vector_len (&t->entries), 5, "one row per address");
+
+	const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (t, 0x1004);
+	mu_assert_notnull (e, "exact lookup");
+	mu_assert_eq (e->address, 0x1004, "exact address");
+	mu_assert_eq (e->line, 11, "first row of the address is kept");
+	e = rz_bin_dwarf_line_table_get (t, 0x200f);
+	mu_assert_notnull (e, "covering lookup");
+	mu_assert_eq (e->address, 0x2008, "covering address");
+	mu_assert_streq (rz_bin_dwarf_line_table_file (t, e->file), "/src/util.h", "covering file");
+	mu_assert_null (rz_bin_dwarf_line_table_get (t, 0xfff), "below the first row");
+
+	e = rz_bin_dwarf_line_table_find (t, "/src/main.c", 11);
+	mu_assert_notnull (e, "reverse lookup");
+	mu_assert_eq (e->address, 0x1004, "lowest address of the line");
+	mu_assert_null (rz_bin_dwarf_line_table_find (t, "/src/main.c", 12), "dropped row");
+	mu_assert_null (rz_bin_dwarf_line_table_find (t, "/src/other.c", 1), "unknown file");
+
+	RzBinDwarfLineTable *u = rz_bin_dwarf_line_table_new ();
+	ut32 other_c = rz_bin_dwarf_line_table_file_id (u, "/src/other.c");
+	rz_bin_dwarf_line_table_file_id (u, "/src/util.h");
+	rz_bin_dwarf_line_table_add (u, 0x1800, other_c, 7, 2);
+	rz_bin_dwarf_line_table_add (u, 0x2000, other_c, 8, 2);
+	mu_assert_true (rz_bin_dwarf_line_table_merge (t, u), "merge");
+	rz_bin_dwarf_line_table_free (u);
+	mu_assert_true (rz_bin_dwarf_line_table_finish (t), "finish merged");
+	mu_assert_eq (rz_vector_len (&t->entries), 6, "merged rows");
+	mu_assert_eq (rz_pvector_len (&t->files), 3, "merged files");
+	e = rz_bin_dwarf_line_table_find (t, "/src/other.c", 7);
+	mu_assert_notnull (e, "merged row");
+	mu_assert_eq (e->address, 0x1800, "merged address");
+	mu_assert_eq (e->column, 2, "merged column");
+	e = rz_bin_dwarf_line_table_get (t, 0x2000);
+	mu_assert_streq (rz_bin_dwarf_line_table_file (t, e->file), "/src/util.h", "earlier table wins");
+
+	mu_assert_true (rz_bin_dwarf_line_table_del (t, 0x1800), "del");
+	mu_assert_false (rz_bin_dwarf_line_table_del (t, 0x1801), "del missing");
+	mu_assert_null (rz_bin_dwarf_line_table_find (t, "/src/other.c", 7), "deleted row");
+	rz_bin_dwarf_line_table_free (t);
+	mu_end;
+}
 
 bool all_tests() {
 	mu_run_test (test_dwarf_cpp_empty_line_info);
@@ -1288,6 +1353,7 @@ bool all_tests() {
 	mu_run_test (test_dwarf3_cpp_many_comp_units);
 	mu_run_test (test_dwarf4_cpp_many_comp_units);
 	mu_run_test (test_big_endian_dwarf2);
+	mu_run_test (test_dwarf_line_table);
 	return tests_passed != tests_run;
 }
 
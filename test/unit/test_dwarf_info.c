@@ -417,10 +417,75 @@ bool test_dwarf2_big_endian(void) {
 	mu_end;
 }
 
+bool test_dwarf_info_lazy(void) {
+	RzBin *bin = rz_bin_new ();
+	RzIO *io = rz_io_new ();
+	rz_io_bind (io, &bin->iob);
+
+	RzBinOptions opt = { 0 };
+	bool res = rz_bin_open (bin, "bins/elf/dwarf4_many_comp_units.elf", &opt);
+	mu_assert ("dwarf4_many_comp_units.elf binary could not be opened", res);
+
+	RzBinDwarfDebugAbbrev *da = rz_bin_dwarf_parse_abbrev (bin, MODE);
+	RzBinDwarfDebugInfo *full = rz_bin_dwarf_parse_info (da, bin, MODE);
+	mu_assert_notnull (full, "Failed parsing of debug_info");
+	RzBinDwarfDebugInfo *info = rz_bin_dwarf_index_info (da, bin);
+	mu_assert_notnull (info, "Failed indexing of debug_info");
+	mu_assert_eq (info->count, 2, "Incorrect number of info compilation units");
+	mu_assert_eq (info->comp_units[1].offset, full->comp_units[1].offset, "Wrong unit offset");
+	mu_assert_null (info->comp_units[0].dies, "Unit decoded while indexing");
+	mu_assert_null (info->comp_units[1].dies, "Unit decoded while indexing");
+
+	// subprogram of the first unit, see test_dwarf4_cpp_multiple_modules
+	ut64 offset = full->comp_units[0].dies[36].offset;
+	mu_assert_null (rz_bin_dwarf_info_find_die (info, offset), "DIE of an undecoded unit");
+	const RzBinDwarfDie *die = rz_bin_dwarf_info_die (info, offset);
+	mu_assert_notnull (die, "DIE not found");
+	mu_assert_eq (die->offset, offset, "Wrong DIE offset");
+	mu_assert_eq (die->tag, DW_TAG_subprogram, "Wrong DIE tag");
+	mu_assert_eq (die->abbrev_code, 19, "Wrong abbrev code");
+	mu_assert_eq (info->comp_units[0].count, 73, "Wrong number of DIEs");
+	mu_assert_null (info->comp_units[1].dies, "Unrelated unit decoded");
+	mu_assert_ptreq (rz_bin_dwarf_info_find_die (full, offset), &full->comp_units[0].dies[36], "Wrong DIE");
+
+	die = rz_bin_dwarf_info_find_name (info, "Bird");
+	mu_assert_notnull (die, "Name not found");
+	mu_assert_eq (die->offset, full->comp_units[0].dies[6].offset, "Wrong DIE for name");
+	mu_assert_null (rz_bin_dwarf_info_find_name (info, "Penguin_"), "Unknown name");
+
+	// the code of a function of the second unit belongs to it
+	ut64 low_pc = UT64_MAX;
+	size_t i, j;
+	for (i = 0; i < full->comp_units[1].count && low_pc == UT64_MAX; i++) {
+		const RzBinDwarfDie *d = &full->comp_units[1].dies[i];
+		for (j = 0; j < d->count && d->tag == DW_TAG_subprogram; j++) {
+			if (d->attr_values[j].attr_name == DW_AT_low_pc) {
+				low_pc = d->attr_values[j].address;
+			}
+		}
+	}
+	mu_assert_neq (low_pc, UT64_MAX, "No function in the second unit");
+	mu_assert_ptreq (rz_bin_dwarf_info_unit_at (info, low_pc), &info->comp_units[1], "Wrong unit for address");
+	mu_assert_null (rz_bin_dwarf_info_unit_at (info, 0x10), "Address out of the units");
+
+	mu_assert_true (rz_bin_dwarf_info_decode_all (info, 2), "Failed decoding of the units");
+	for (i = 0; i < info->count; i++) {
+		mu_assert_eq (info->comp_units[i].count, full->comp_units[i].count, "Wrong number of DIEs");
+	}
+
+	rz_bin_dwarf_free_debug_info (info);
+	rz_bin_dwarf_free_debug_info (full);
+	rz_bin_dwarf_free_debug_abbrev (da);
+	rz_bin_free (bin);
+	rz_io_free (io);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test (test_dwarf3_c);
 	mu_run_test (test_dwarf4_cpp_multiple_modules);
 	mu_run_test (test_dwarf2_big_endian);
+	mu_run_test (test_dwarf_info_lazy);
 	return tests_passed != tests_run;
 }
 
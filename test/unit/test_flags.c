@@ -128,10 +128,72 @@ bool test_r_flag_get_at() {
 	mu_end;
 }
 
+static bool dump_flag(RzFlagItem *fi, void *user) {
+	rz_strbuf_appendf (user, "%s %s 0x%"PFMT64x" %"PFMT64u" %s %d\n", fi->name, fi->realname,
+		fi->offset, fi->size, fi->space? fi->space->name: "-", fi->demangled);
+	return true;
+}
+
+static char *dump_flags(RzFlag *f) {
+	RzStrBuf *sb = rz_strbuf_new ("");
+	rz_flag_foreach (f, dump_flag, sb);
+	return rz_strbuf_drain (sb);
+}
+
+bool test_r_flag_batch(void) {
+	RzFlag *ref = rz_flag_new ();
+	RzFlag *f = rz_flag_new ();
+	rz_flag_set (ref, "old", 0x10, 1);
+	rz_flag_set (f, "old", 0x10, 1);
+	RzFlagBatch *b = rz_flag_batch_new (f);
+	mu_assert_notnull (b, "rz_flag_batch_new");
+	ut32 x = 1;
+	int i;
+	for (i = 0; i < 5000; i++) {
+		x = x * 1103515245 + 12345;
+		// few names and offsets, to repeat and move flags
+		char name[32];
+		snprintf (name, sizeof (name), (x >> 8) & 1? "sym.a b%u": "sym.f%u", (x >> 9) % 700);
+		ut64 off = 0x10 * ((x >> 20) % 300);
+		const char *realname = (x >> 4) & 1? "real name": NULL;
+		bool demangled = (x >> 5) & 1;
+		const char *space = (x >> 6) & 1? "symbols": "imports";
+		if (i == 2500) {
+			snprintf (name, sizeof (name), "old");
+		}
+
+		rz_flag_space_set (ref, space);
+		RzFlagItem *fi = rz_flag_set (ref, name, off, i);
+		if (realname) {
+			rz_flag_item_set_realname (fi, realname);
+			fi->demangled = demangled;
+		}
+		rz_flag_space_set (f, space);
+		mu_assert_true (rz_flag_batch_add (b, name, realname, off, i, demangled), "rz_flag_batch_add");
+		if (i == 4000) {
+			mu_assert_eq (rz_flag_batch_commit (b), 4001, "flags set");
+		}
+	}
+	mu_assert_eq (rz_flag_batch_commit (b), 999, "flags set");
+	mu_assert_eq (rz_flag_batch_commit (b), 0, "empty batch");
+	rz_flag_batch_free (b);
+
+	char *expect = dump_flags (ref);
+	char *actual = dump_flags (f);
+	mu_assert_true (!strcmp (actual, expect), "same flags as rz_flag_set");
+	mu_assert_notnull (rz_flag_get (f, "sym.a_b1"), "filtered name");
+	free (expect);
+	free (actual);
+	rz_flag_free (ref);
+	rz_flag_free (f);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test (test_r_flag_get_set);
 	mu_run_test (test_r_flag_by_spaces);
 	mu_run_test (test_r_flag_get_at);
+	mu_run_test (test_r_flag_batch);
 	return tests_passed != tests_run;
 }
 
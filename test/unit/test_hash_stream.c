@@ -0,0 +1,208 @@
+#include <rz_hash.h>
+#include <rz_th.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+#define BENCH_SIZE (32 * 1024 * 1024)
+
+static ut8 *random_buf(ut64 len) {
+	ut8 *buf = malloc (len);
+	ut64 i;
+	ut32 x = 0x12345678;
+	for (i = 0; buf && i < len; i++) {
+		x = x * 1103515245 + 12345;
+		buf[i] = x >> 24;
+	}
+	return buf;
+}
+
+static bool expect_ctx(RzHash *ctx, ut64 algo, const ut8 *buf, ut64 len) {
+	RzHash *ref = rz_hash_new (true, algo);
+	int dlen = rz_hash_calculate (ref, algo, buf, (int)len);
+	bool ok = algo == RZ_HASH_ENTROPY
+		? ref->entropy == ctx->entropy
+		: !memcmp (ref->digest, ctx->digest, dlen);
+	rz_hash_free (ref);
+	return ok;
+}
+
+bool test_hash_stream(void) {
+	const ut64 algos[] = {
+		RZ_HASH_MD5, RZ_HASH_SHA1, RZ_HASH_SHA256, RZ_HASH_SHA384, RZ_HASH_SHA512,
+		RZ_HASH_CRC8_SMBUS, RZ_HASH_CRC15_CAN, RZ_HASH_CRC16, RZ_HASH_CRC16_CITT,
+		RZ_HASH_CRC24, RZ_HASH_CRC32, RZ_HASH_CRC32C, RZ_HASH_CRC32_BZIP2,
+		RZ_HASH_CRC64, RZ_HASH_CRC64_XZ, RZ_HASH_ENTROPY
+	};
+	const ut64 len = 100000;
+	ut8 *buf = random_buf (len);
+	ut64 bits = 0;
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE (algos); i++) {
+		mu_assert_true (rz_hash_stream_supported (algos[i]), "streamable");
+		bits |= algos[i];
+	}
+	mu_assert_false (rz_hash_stream_supported (RZ_HASH_XXHASH), "one-shot only");
+	mu_assert_false (rz_hash_stream_supported (RZ_HASH_MD5 | RZ_HASH_SHA1), "single algorithm");
+
+	int threads;
+	for (threads = 1; threads <= 4; threads += 3) {
+		RzHashStream *hs = rz_hash_stream_new (bits | RZ_HASH_XXHASH, threads);
+		mu_assert_notnull (hs, "rz_hash_stream_new");
+		// odd sizes, below and above the crc table threshold
+		ut64 off = 0, step = 7;
+		while (off < len) {
+			ut64 n = RZ_MIN (step, len - off);
+			mu_assert_true (rz_hash_stream_update (hs, buf + off, n), "update");
+			off += n;
+			step = step * 3 + 1;
+		}
+		rz_hash_stream_final (hs);
+		mu_assert_null (rz_hash_stream_ctx (hs, RZ_HASH_XXHASH), "unsupported algorithm skipped");
+		for (i = 0; i < RZ_ARRAY_SIZE (algos); i++) {
+			RzHash *ctx = rz_hash_stream_ctx (hs, algos[i]);
+			mu_assert_notnull (ctx, "stream ctx");
+			mu_assert_true (expect_ctx (ctx, algos[i], buf, len), rz_hash_name (algos[i]));
+		}
+		rz_hash_stream_free (hs);
+	}
+	free (buf);
+	mu_end;
+}
+
+bool test_hash_crc_check(void) {
+	ut8 buf[4096];
+	ut64 i;
+	for (i = 0; i < sizeof (buf); i += 9) {
+		memcpy (buf + i, "123456789", RZ_MIN (9, sizeof (buf) - i));
+	}
+	mu_assert_eq (rz_hash_crc_preset (buf, 9, CRC_PRESET_32), 0xcbf43926, "crc32 check");
+	mu_assert_eq (rz_hash_crc_preset (buf, 9, CRC_PRESET_32C), 0xe3069283, "crc32c check");
+	mu_assert_eq (rz_hash_crc_preset (buf, 9, CRC_PRESET_CRC64_XZ), 0x995dc9bbdf1939faULL, "crc64xz check");
+
+	// slices below the table threshold against the table (or SSE4.2) path
+	const ut64 algos[] = { RZ_HASH_CRC8_SMBUS, RZ_HASH_CRC15_CAN, RZ_HASH_CRC16, RZ_HASH_CRC16_CITT, RZ_HASH_CRC24,
+		RZ_HASH_CRC32, RZ_HASH_CRC32C, RZ_HASH_CRC32_ECMA_267, RZ_HASH_CRC32Q, RZ_HASH_CRC64, RZ_HASH_CRC64_ISO };
+	size_t a;
+	for (a = 0; a < RZ_ARRAY_SIZE (algos); a++) {
+		RzHashStream *hs = rz_hash_stream_new (algos[a], 1);
+		for (i = 0; i < sizeof (buf); i += 64) {
+			rz_hash_stream_update (hs, buf + i, 64);
+		}
+		rz_hash_stream_final (hs);
+		mu_assert_true (expect_ctx (rz_hash_stream_ctx (hs, algos[a]), algos[a], buf, sizeof (buf)), rz_hash_name (algos[a]));
+		rz_hash_stream_free (hs);
+	}
+	mu_end;
+}
+
+static bool count_blocks(void *user, ut64 idx, RzHash *ctx, int dlen) {
+	RzVector *v = user;
+	ut64 *slot = rz_vector_push (v, NULL);
+	*slot = idx;
+	return true;
+}
+
+typedef struct {
+	const ut8 *buf;
+	ut64 len;
+	ut64 bsize;
+	ut64 algo;
+	ut64 next;
+	bool ok;
+} BlocksCheck;
+
+static bool check_block(void *user, ut64 idx, RzHash *ctx, int dlen) {
+	BlocksCheck *bc = user;
+	ut64 off = idx * bc->bsize;
+	if (idx != bc->next++ || off >= bc->len) {
+		bc->ok = false;
+		return false;
+	}
+	bc->ok &= expect_ctx (ctx, bc->algo, bc->buf + off, RZ_MIN (bc->bsize, bc->len - off));
+	return true;
+}
+
+bool test_hash_calculate_blocks(void) {
+	const ut64 len = 100003, bsize = 100;
+	ut8 *buf = random_buf (len);
+	const ut64 algos[] = { RZ_HASH_SHA256, RZ_HASH_ENTROPY, RZ_HASH_XXHASH, RZ_HASH_CRC32 };
+	size_t i;
+	int threads;
+	for (threads = 1; threads <= 4; threads += 3) {
+		for (i = 0; i < RZ_ARRAY_SIZE (algos); i++) {
+			BlocksCheck bc = { buf, len, bsize, algos[i], 0, true };
+			mu_assert_true (rz_hash_calculate_blocks (algos[i], buf, len, bsize, threads, check_block, &bc), "blocks");
+			mu_assert_true (bc.ok, "block digests");
+			mu_assert_eq (bc.next, len / bsize + 1, "block count");
+		}
+	}
+	RzVector idx;
+	rz_vector_init (&idx, sizeof (ut64), NULL, NULL);
+	mu_assert_true (rz_hash_calculate_blocks (RZ_HASH_ENTROPY, buf, 1000, 1000, 2, count_blocks, &idx), "single block");
+	mu_assert_eq (rz_vector_len (&idx), 1, "single block count");
+	rz_vector_fini (&idx);
+	free (buf);
+	mu_end;
+}
+
+static double mbps(ut64 len, ut64 t0) {
+	ut64 dt = RZ_MAX (rz_time_now_mono () - t0, 1);
+	return (double)len / dt; // bytes per µs is MB/s
+}
+
+bool test_hash_stream_bench(void) {
+	mu_bench;
+	const ut64 bits = RZ_HASH_MD5 | RZ_HASH_SHA1 | RZ_HASH_SHA256 | RZ_HASH_CRC32 | RZ_HASH_ENTROPY;
+	ut8 *buf = random_buf (BENCH_SIZE);
+	mu_assert_notnull (buf, "bench buffer");
+	const ut64 block = 0x100000;
+	ut64 i, off, t0 = rz_time_now_mono ();
+	// the old way: one pass over the data per algorithm
+	for (i = 1; i <= bits; i <<= 1) {
+		if (!(bits & i)) {
+			continue;
+		}
+		RzHash *ctx = rz_hash_new (false, i);
+		if (i & RZ_HASH_CRC32 || i & RZ_HASH_ENTROPY) {
+			rz_hash_calculate (ctx, i, buf, BENCH_SIZE);
+		} else {
+			for (off = 0; off < BENCH_SIZE; off += block) {
+				rz_hash_calculate (ctx, i, buf + off, block);
+			}
+			rz_hash_do_end (ctx, i);
+		}
+		rz_hash_free (ctx);
+	}
+	double seq = mbps (BENCH_SIZE, t0);
+
+	t0 = rz_time_now_mono ();
+	RzHashStream *hs = rz_hash_stream_new (bits, 0);
+	for (off = 0; off < BENCH_SIZE; off += block) {
+		rz_hash_stream_update (hs, buf + off, block);
+	}
+	rz_hash_stream_final (hs);
+	double stream = mbps (BENCH_SIZE, t0);
+	mu_assert_true (expect_ctx (rz_hash_stream_ctx (hs, RZ_HASH_SHA256), RZ_HASH_SHA256, buf, BENCH_SIZE), "bench digest");
+	rz_hash_stream_free (hs);
+
+	t0 = rz_time_now_mono ();
+	rz_hash_crc_preset (buf, BENCH_SIZE, CRC_PRESET_32C);
+	double crc32c = mbps (BENCH_SIZE, t0);
+
+	printf ("md5+sha1+sha256+crc32+entropy: %.1f MB/s per algorithm, %.1f MB/s streamed on %d cores; crc32c: %.1f MB/s\n",
+		seq, stream, rz_th_ncores (), crc32c);
+	free (buf);
+	mu_end;
+}
+
+bool all_tests() {
+	mu_run_test (test_hash_stream);
+	mu_run_test (test_hash_crc_check);
+	mu_run_test (test_hash_calculate_blocks);
+	mu_run_test (test_hash_stream_bench);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -0,0 +1,182 @@
+#include <rz_util.h>
+#include <zlib.h>
+#include "minunit.h"
+
+#define DATA_SIZE 0x300000
+#define SPAN      0x40000
+
+static ut8 *ref_data(void) {
+	ut8 *data = malloc (DATA_SIZE);
+	if (!data) {
+		return NULL;
+	}
+	// compressible, but with enough noise to get many deflate blocks
+	ut32 x = 0x1337;
+	size_t i;
+	for (i = 0; i < DATA_SIZE; i++) {
+		x = x * 1103515245 + 12345;
+		data[i] = (x >> 16) % 8? "rizin"[i % 5]: x >> 24;
+	}
+	return data;
+}
+
+static RzBuffer *compress_buf(const ut8 *data, size_t len, int wbits, int members) {
+	RzBuffer *b = rz_buf_new ();
+	ut8 *out = malloc (0x10000);
+	size_t part = len / members, off = 0;
+	int m;
+	for (m = 0; m < members; m++) {
+		z_stream strm = { 0 };
+		deflateInit2 (&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, wbits, 8, Z_DEFAULT_STRATEGY);
+		size_t n = m == members - 1? len - off: part;
+		strm.next_in = (Bytef *)data + off;
+		strm.avail_in = (uInt)n;
+		int ret;
+		do {
+			strm.next_out = out;
+			strm.avail_out = 0x10000;
+			ret = deflate (&strm, Z_FINISH);
+			rz_buf_append_bytes (b, out, 0x10000 - strm.avail_out);
+		} while (ret != Z_STREAM_END);
+		deflateEnd (&strm);
+		off += n;
+	}
+	free (out);
+	return b;
+}
+
+static bool check_reads(RzInflateIndex *idx, const ut8 *data) {
+	ut8 buf[0x3000];
+	ut32 x = 0xcafe;
+	int i;
+	// random reads, including some crossing chunks and past the end
+	for (i = 0; i < 200; i++) {
+		x = x * 1103515245 + 12345;
+		ut64 off = (x >> 8) % (DATA_SIZE + 0x100);
+		st64 r = rz_inflate_index_read_at (idx, off, buf, sizeof (buf));
+		st64 expected = off >= DATA_SIZE? 0: RZ_MIN (sizeof (buf), DATA_SIZE - off);
+		if (r != expected || memcmp (buf, data + off, r)) {
+			return false;
+		}
+	}
+	// sequential reads
+	ut64 off;
+	for (off = DATA_SIZE / 3; off < DATA_SIZE; off += sizeof (buf)) {
+		st64 r = rz_inflate_index_read_at (idx, off, buf, sizeof (buf));
+		if (r <= 0 || memcmp (buf, data + off, r)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_inflate_index_gzip(void) {
+	ut8 *data = ref_data ();
+	mu_assert_notnull (data, "data");
+	RzBuffer *src = compress_buf (data, DATA_SIZE, MAX_WBITS + 16, 1);
+	RzInflateIndex *idx = rz_inflate_index_new (src, false, SPAN);
+	mu_assert_notnull (idx, "index");
+	mu_assert_eq (rz_inflate_index_size (idx), DATA_SIZE, "size");
+	mu_assert_true (rz_inflate_index_count (idx) >= DATA_SIZE / SPAN / 2, "checkpoints");
+	mu_assert_true (check_reads (idx, data), "reads");
+	rz_inflate_index_free (idx);
+
+	// concatenated members and zlib streams
+	rz_buf_free (src);
+	src = compress_buf (data, DATA_SIZE, MAX_WBITS + 16, 3);
+	idx = rz_inflate_index_new (src, false, SPAN);
+	mu_assert_notnull (idx, "index members");
+	mu_assert_eq (rz_inflate_index_size (idx), DATA_SIZE, "size members");
+	mu_assert_true (check_reads (idx, data), "reads members");
+	rz_inflate_index_free (idx);
+	rz_buf_free (src);
+	src = compress_buf (data, DATA_SIZE, MAX_WBITS, 1);
+	idx = rz_inflate_index_new (src, false, SPAN);
+	mu_assert_notnull (idx, "index zlib");
+	mu_assert_true (check_reads (idx, data), "reads zlib");
+	rz_inflate_index_free (idx);
+
+	rz_buf_free (src);
+	free (data);
+	mu_end;
+}
+
+bool test_inflate_index_raw(void) {
+	ut8 *data = ref_data ();
+	mu_assert_notnull (data, "data");
+	RzBuffer *src = compress_buf (data, DATA_SIZE, -MAX_WBITS, 1);
+	RzInflateIndex *idx = rz_inflate_index_new (src, true, SPAN);
+	mu_assert_notnull (idx, "index");
+	mu_assert_eq (rz_inflate_index_size (idx), DATA_SIZE, "size");
+	mu_assert_true (check_reads (idx, data), "reads");
+
+	RzBuffer *b = rz_buf_new_with_inflate_index (idx);
+	mu_assert_notnull (b, "buffer");
+	mu_assert_eq (rz_buf_size (b), DATA_SIZE, "buffer size");
+	ut8 tmp[0x100];
+	rz_buf_seek (b, 0x12345, RZ_BUF_SET);
+	mu_assert_eq (rz_buf_read (b, tmp, sizeof (tmp)), sizeof (tmp), "buffer read");
+	mu_assert_memeq (tmp, data + 0x12345, sizeof (tmp), "buffer data");
+	mu_assert_eq (rz_buf_tell (b), 0x12345 + sizeof (tmp), "buffer tell");
+	rz_buf_free (b);
+
+	// a truncated stream cannot be indexed
+	RzBuffer *cut = rz_buf_new_slice (src, 0, rz_buf_size (src) / 2);
+	mu_assert_null (rz_inflate_index_new (cut, true, SPAN), "truncated");
+	rz_buf_free (cut);
+
+	rz_buf_free (src);
+	free (data);
+	mu_end;
+}
+
+bool test_inflate_index_save(void) {
+	ut8 *data = ref_data ();
+	mu_assert_notnull (data, "data");
+	RzBuffer *src = compress_buf (data, DATA_SIZE, MAX_WBITS + 16, 2);
+	RzInflateIndex *idx = rz_inflate_index_new (src, false, SPAN);
+	mu_assert_notnull (idx, "index");
+	char *file = NULL;
+	int fd = rz_file_mkstemp ("rzidx", &file);
+	mu_assert_neq (fd, -1, "tmp file");
+	close (fd);
+	mu_assert_true (rz_inflate_index_save (idx, file), "save");
+	ut32 count = rz_inflate_index_count (idx);
+	rz_inflate_index_free (idx);
+
+	idx = rz_inflate_index_load (src, file);
+	mu_assert_notnull (idx, "load");
+	mu_assert_eq (rz_inflate_index_count (idx), count, "loaded checkpoints");
+	mu_assert_eq (rz_inflate_index_size (idx), DATA_SIZE, "loaded size");
+	mu_assert_true (check_reads (idx, data), "loaded reads");
+	rz_inflate_index_free (idx);
+
+	// the index does not apply to another stream
+	RzBuffer *other = compress_buf (data, DATA_SIZE, MAX_WBITS + 16, 1);
+	mu_assert_null (rz_inflate_index_load (other, file), "other stream");
+	rz_buf_free (other);
+	// nor when it is corrupt
+	size_t size;
+	ut8 *buf = (ut8 *)rz_file_slurp (file, &size);
+	mu_assert_notnull (buf, "slurp");
+	mu_assert_true (rz_file_dump (file, buf, (int)size - 10, false), "dump");
+	mu_assert_null (rz_inflate_index_load (src, file), "truncated index");
+	free (buf);
+
+	rz_file_rm (file);
+	free (file);
+	rz_buf_free (src);
+	free (data);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_inflate_index_gzip);
+	mu_run_test (test_inflate_index_raw);
+	mu_run_test (test_inflate_index_save);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -261,6 +261,81 @@ bool test_rz_io_priority2(void) {
 	mu_end;
 }
 
+bool test_rz_io_page_cache(void) {
+	RzIO *io = rz_io_new ();
+	ut8 buf[4];
+	io->va = true;
+	mu_assert_notnull (rz_io_open_at (io, "malloc://0x1800", RZ_PERM_RW, 0644, 0x1000), "malloc should be opened");
+	mu_assert_true (rz_io_write_at (io, 0x1ffe, (const ut8 *)"\x01\x02\x03\x04", 4), "write across pages");
+	mu_assert_true (rz_io_read_at (io, 0x1ffe, buf, 4), "read across pages");
+	mu_assert_memeq (buf, (ut8 *)"\x01\x02\x03\x04", 4, "read back the written bytes");
+	ut64 hits = io->page_cache.hits;
+	mu_assert_true (rz_io_read_at (io, 0x1fff, buf, 2), "read from cached pages");
+	mu_assert_memeq (buf, (ut8 *)"\x02\x03", 2, "cached bytes");
+	mu_assert_eq (io->page_cache.hits, hits + 2, "both pages should be hits");
+
+	// writes must not return stale data
+	rz_io_write_at (io, 0x1fff, (const ut8 *)"\x90", 1);
+	rz_io_read_at (io, 0x1ffe, buf, 4);
+	mu_assert_memeq (buf, (ut8 *)"\x01\x90\x03\x04", 4, "written byte after a backend write");
+	io->cached = RZ_PERM_RW;
+	rz_io_write_at (io, 0x2000, (const ut8 *)"\xcc", 1);
+	rz_io_read_at (io, 0x1ffe, buf, 4);
+	mu_assert_memeq (buf, (ut8 *)"\x01\x90\xcc\x04", 4, "io.cache is applied on top of the pages");
+	io->cached = 0;
+
+	// the last page is only partially readable
+	mu_assert_true (rz_io_read_at (io, 0x27fc, buf, 4), "read the end of the map");
+	mu_assert_eq (rz_io_nread_at (io, 0x27fe, buf, 4), 2, "readable prefix past the end of the map");
+
+	// maps changes are seen
+	rz_io_map_remap (io, rz_io_map_get (io, 0x1000)->id, 0x2000);
+	rz_io_read_at (io, 0x2ffe, buf, 4);
+	mu_assert_memeq (buf, (ut8 *)"\x01\x90\x03\x04", 4, "read after remap");
+
+	mu_assert_true (rz_io_page_cache_resize (io, 0, RZ_IO_PAGE_CACHE_PAGESIZE), "disable the cache");
+	mu_assert_eq (io->page_cache.count, 0, "no pages once disabled");
+	rz_io_read_at (io, 0x2ffe, buf, 4);
+	mu_assert_eq (io->page_cache.count, 0, "disabled cache is not filled");
+	mu_assert_false (rz_io_page_cache_resize (io, 16, 1000), "page size must be a power of two");
+	rz_io_free (io);
+	mu_end;
+}
+
+bool test_rz_io_page_cache_volatile(void) {
+	RzIOPlugin plugin;
+	RzIO *io = rz_io_new ();
+	ut8 buf[4];
+	io->va = true;
+	RzIODesc *desc = rz_io_open_at (io, "malloc://0x1000", RZ_PERM_RW, 0644, 0);
+	mu_assert_notnull (desc, "malloc should be opened");
+	mu_assert_true (rz_io_page_cache_enabled (io), "static memory is cached");
+	// pretend the memory belongs to a live process
+	plugin = *desc->plugin;
+	plugin.isvolatile = true;
+	desc->plugin = &plugin;
+	rz_io_page_cache_flush (io);
+	mu_assert_false (rz_io_page_cache_enabled (io), "volatile memory is not cached");
+	rz_io_read_at (io, 0x10, buf, 4);
+	mu_assert_eq (io->page_cache.count, 0, "no page read from volatile memory");
+	rz_io_write_at (io, 0x10, (const ut8 *)"\x01\x02\x03\x04", 4);
+	rz_io_read_at (io, 0x10, buf, 4);
+	mu_assert_memeq (buf, (ut8 *)"\x01\x02\x03\x04", 4, "read volatile memory directly");
+
+	// debugger memory is only cached when a debugger flushes it on stop
+	plugin.isvolatile = false;
+	plugin.isdbg = true;
+	rz_io_page_cache_flush (io);
+	mu_assert_false (rz_io_page_cache_enabled (io), "debugger memory without flush on stop");
+	io->page_cache.dbg_flush = true;
+	rz_io_page_cache_flush (io);
+	mu_assert_true (rz_io_page_cache_enabled (io), "debugger memory flushed on stop");
+	rz_io_read_at (io, 0x10, buf, 4);
+	mu_assert_eq (io->page_cache.count, 1, "page read from debugger memory");
+	rz_io_free (io);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_io_cache);
 	mu_run_test(test_rz_io_mapsplit);
@@ -271,6 +346,8 @@ int all_tests() {
 	mu_run_test(test_rz_io_priority);
 	mu_run_test(test_rz_io_priority2);
 	mu_run_test(test_va_malloc_zero);
+	mu_run_test(test_rz_io_page_cache);
+	mu_run_test(test_rz_io_page_cache_volatile);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,140 @@
+#include <rz_util.h>
+#include "minunit.h"
+
+static bool test_mem_journal_merge(void) {
+	RzMemJournal *j = rz_mem_journal_new ();
+	rz_mem_journal_add (j, 0, 0x1000, (const ut8 *)"\x01\x02", 2);
+	rz_mem_journal_add (j, 0, 0x1002, (const ut8 *)"\x03\x04", 2);
+	mu_assert_eq (rz_mem_journal_count (j), 1, "contiguous writes of a step merged");
+	rz_mem_journal_add (j, 1, 0x1004, (const ut8 *)"\x05", 1);
+	rz_mem_journal_add (j, 1, 0x2000, (const ut8 *)"\x06", 1);
+	mu_assert_eq (rz_mem_journal_count (j), 3, "other steps and gaps not merged");
+	mu_assert_false (rz_mem_journal_add (j, 0, 0x3000, (const ut8 *)"\x07", 1), "step going back");
+	rz_mem_journal_free (j);
+	mu_end;
+}
+
+static bool test_mem_journal_read_at(void) {
+	RzMemJournal *j = rz_mem_journal_new ();
+	rz_mem_journal_add (j, 1, 0x1000, (const ut8 *)"AAAAAAAA", 8);
+	rz_mem_journal_add (j, 3, 0x1002, (const ut8 *)"BB", 2);
+	rz_mem_journal_add (j, 5, 0x1006, (const ut8 *)"CCCC", 4);
+	ut8 buf[12];
+
+	memset (buf, '.', sizeof (buf));
+	mu_assert_false (rz_mem_journal_read_at (j, 0, 0xffe, buf, sizeof (buf)), "nothing before step 1");
+	mu_assert_memeq (buf, (const ut8 *)"............", sizeof (buf), "untouched");
+
+	memset (buf, '.', sizeof (buf));
+	mu_assert_true (rz_mem_journal_read_at (j, 4, 0xffe, buf, sizeof (buf)), "step 4");
+	mu_assert_memeq (buf, (const ut8 *)"..AABBAAAA..", sizeof (buf), "step 4");
+
+	memset (buf, '.', sizeof (buf));
+	rz_mem_journal_read_at (j, 5, 0xffe, buf, sizeof (buf));
+	mu_assert_memeq (buf, (const ut8 *)"..AABBAACCCC", sizeof (buf), "step 5");
+
+	memset (buf, '.', sizeof (buf));
+	rz_mem_journal_read_at (j, 5, 0x1003, buf, 2);
+	mu_assert_memeq (buf, (const ut8 *)"BA", 2, "partial overlap");
+	rz_mem_journal_free (j);
+	mu_end;
+}
+
+typedef struct {
+	ut8 mem[0x10];
+	int calls;
+} Replay;
+
+static bool replay_cb(void *user, ut64 addr, const ut8 *buf, ut32 len) {
+	Replay *r = user;
+	memcpy (r->mem + addr, buf, len);
+	r->calls++;
+	return true;
+}
+
+static bool test_mem_journal_replay(void) {
+	RzMemJournal *j = rz_mem_journal_new ();
+	rz_mem_journal_add (j, 0, 0, (const ut8 *)"aaaa", 4);
+	rz_mem_journal_add (j, 2, 2, (const ut8 *)"bb", 2);
+	rz_mem_journal_add (j, 2, 8, (const ut8 *)"cc", 2);
+	rz_mem_journal_add (j, 4, 3, (const ut8 *)"d", 1);
+	Replay r = { { 0 } };
+
+	memset (r.mem, '.', sizeof (r.mem));
+	rz_mem_journal_replay (j, 0, 2, replay_cb, &r);
+	mu_assert_memeq (r.mem, (const ut8 *)"aabb....cc......", sizeof (r.mem), "steps 0-2");
+	mu_assert_eq (r.calls, 3, "calls");
+
+	rz_mem_journal_replay (j, 3, 10, replay_cb, &r);
+	mu_assert_memeq (r.mem, (const ut8 *)"aabd....cc......", sizeof (r.mem), "steps 3-10");
+	mu_assert_eq (r.calls, 4, "calls");
+	rz_mem_journal_free (j);
+	mu_end;
+}
+
+static bool test_mem_journal_serialize(void) {
+	RzMemJournal *j = rz_mem_journal_new ();
+	ut32 step;
+	ut8 buf[4];
+	for (step = 0; step < 1000; step++) {
+		rz_write_le32 (buf, step);
+		rz_mem_journal_add (j, step, 0x7fff0000 - (step % 16) * 4, buf, sizeof (buf));
+		rz_mem_journal_add (j, step, 0x400000 + step, buf, 1);
+	}
+	ut64 size;
+	ut8 *data = rz_mem_journal_serialize (j, &size);
+	mu_assert_notnull (data, "serialize");
+	mu_assert ("compact", size < 2000 * 12);
+
+	RzMemJournal *j2 = rz_mem_journal_new ();
+	mu_assert_true (rz_mem_journal_deserialize (j2, data, size), "deserialize");
+	mu_assert_eq (rz_mem_journal_count (j2), rz_mem_journal_count (j), "count");
+	RzMemJournalExtent *e, *e2;
+	size_t i;
+	rz_vector_enumerate (&j->extents, e, i) {
+		e2 = rz_vector_index_ptr (&j2->extents, i);
+		mu_assert_eq (e2->step, e->step, "step");
+		mu_assert_eq (e2->addr, e->addr, "addr");
+		mu_assert_eq (e2->len, e->len, "len");
+		mu_assert_memeq (j2->data + e2->off, j->data + e->off, e->len, "data");
+	}
+	rz_mem_journal_clear (j2);
+	mu_assert_false (rz_mem_journal_deserialize (j2, data, size - 1), "truncated");
+	rz_mem_journal_free (j2);
+	free (data);
+	rz_mem_journal_free (j);
+	mu_end;
+}
+
+static bool test_mem_journal_end_of_space(void) {
+	RzMemJournal *j = rz_mem_journal_new ();
+	ut8 buf[4];
+	rz_mem_journal_add (j, 0, UT64_MAX - 1, (const ut8 *)"xyzw", 4);
+	mu_assert_eq (rz_mem_journal_count (j), 1, "recorded");
+	RzMemJournalExtent *e = rz_vector_index_ptr (&j->extents, 0);
+	mu_assert_eq (e->len, 2, "clamped to the last byte");
+	rz_mem_journal_add (j, 0, 0, (const ut8 *)"a", 1);
+	mu_assert_eq (rz_mem_journal_count (j), 2, "not merged across the wrap");
+
+	memset (buf, '.', sizeof (buf));
+	mu_assert_true (rz_mem_journal_read_at (j, 0, UT64_MAX - 2, buf, sizeof (buf)), "read at the end");
+	mu_assert_memeq (buf, (const ut8 *)".xy.", sizeof (buf), "last byte kept");
+	memset (buf, '.', sizeof (buf));
+	mu_assert_true (rz_mem_journal_read_at (j, 0, UT64_MAX, buf, 1), "read the last byte");
+	mu_assert_memeq (buf, (const ut8 *)"y", 1, "last byte");
+	rz_mem_journal_free (j);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_mem_journal_merge);
+	mu_run_test (test_mem_journal_read_at);
+	mu_run_test (test_mem_journal_replay);
+	mu_run_test (test_mem_journal_serialize);
+	mu_run_test (test_mem_journal_end_of_space);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -0,0 +1,226 @@
+#include <rz_project.h>
+#include "minunit.h"
+#include "test_sdb.h"
+
+static Sdb *ref_db(void) {
+	Sdb *db = sdb_new0 ();
+	sdb_set (db, "type", "rizin rz-db project", 0);
+	sdb_set (db, "version", "1", 0);
+	Sdb *core = sdb_ns (db, "core", true);
+	sdb_set (core, "offset", "0x1337", 0);
+	sdb_set (core, "blocksize", "0x100", 0);
+	sdb_ns (core, "file", true);
+	Sdb *functions = sdb_ns_path (db, "core/analysis/functions", true);
+	int i;
+	for (i = 0; i < 1000; i++) {
+		char key[32];
+		snprintf (key, sizeof (key), "0x%x", 0x1000 + i * 0x10);
+		sdb_set (functions, key, "{\"name\":\"fcn\",\"bits\":32,\"type\":\"fcn\"}", 0);
+	}
+	sdb_set (sdb_ns_path (db, "core/flags", true), "base", "0", 0);
+	sdb_set (sdb_ns_path (db, "core/analysis/meta", true), "0x1000", PERTURBATOR, 0);
+	sdb_set (sdb_ns_path (db, "core/analysis-x", true), "empty", "", 0);
+	return db;
+}
+
+static char *tmp_file(void) {
+	char *file = NULL;
+	int fd = rz_file_mkstemp ("rzprj", &file);
+	if (fd != -1) {
+		close (fd);
+	}
+	return file;
+}
+
+static bool load_equals(const char *file, Sdb *expected) {
+	RzProjectBin *pb = rz_project_bin_open (file);
+	if (!pb) {
+		return false;
+	}
+	Sdb *db = sdb_new0 ();
+	bool ret = rz_project_bin_load_ns (pb, "", db, true) && sdb_diff (expected, db, diff_cb, NULL);
+	sdb_free (db);
+	rz_project_bin_close (pb);
+	return ret;
+}
+
+bool test_project_bin_roundtrip(void) {
+	char *file = tmp_file ();
+	mu_assert_notnull (file, "tmp file");
+	mu_assert_null (rz_project_bin_open (file), "empty file is no container");
+
+	Sdb *db = ref_db ();
+	mu_assert_true (rz_project_bin_save (db, NULL, 0, file, NULL), "save");
+	mu_assert_true (load_equals (file, db), "roundtrip");
+
+	RzProjectBin *pb = rz_project_bin_open (file);
+	mu_assert_notnull (pb, "open");
+	mu_assert_streq (rz_project_bin_get (pb, "", "type"), "rizin rz-db project", "root key");
+	mu_assert_streq (rz_project_bin_get (pb, "core/analysis/functions", "0x1ff0"), "{\"name\":\"fcn\",\"bits\":32,\"type\":\"fcn\"}", "key");
+	mu_assert_streq (rz_project_bin_get (pb, "core/analysis/meta", "0x1000"), PERTURBATOR, "perturbed key");
+	mu_assert_streq (rz_project_bin_get (pb, "core/analysis-x", "empty"), "", "empty value");
+	mu_assert_null (rz_project_bin_get (pb, "core/analysis/functions", "0x1ff8"), "missing key");
+	mu_assert_null (rz_project_bin_get (pb, "core/types", "x"), "missing namespace");
+
+	Sdb *analysis = sdb_new0 ();
+	mu_assert_true (rz_project_bin_load_ns (pb, "core/analysis", analysis, true), "load subtree");
+	assert_sdb_eq (analysis, sdb_ns_path (db, "core/analysis", false), "subtree");
+	sdb_free (analysis);
+	Sdb *core = sdb_new0 ();
+	mu_assert_true (rz_project_bin_load_ns (pb, "core", core, false), "load single namespace");
+	mu_assert_eq (sdb_count (core), 2, "single namespace keys");
+	mu_assert_null (sdb_ns (core, "analysis", false), "single namespace only");
+	sdb_free (core);
+	rz_project_bin_close (pb);
+
+	sdb_free (db);
+	rz_file_rm (file);
+	free (file);
+	mu_end;
+}
+
+bool test_project_bin_incremental(void) {
+	char *file = tmp_file ();
+	mu_assert_notnull (file, "tmp file");
+	Sdb *db = ref_db ();
+	ut64 full = 0, written = 0;
+	mu_assert_true (rz_project_bin_save (db, NULL, 0, file, &full), "save");
+	mu_assert_eq (rz_file_size (file), full, "full save");
+
+	mu_assert_true (rz_project_bin_save (db, NULL, 0, file, &written), "save unchanged");
+	mu_assert_true (written < 512, "only the table and header are written");
+	mu_assert_true (load_equals (file, db), "unchanged");
+
+	sdb_set (sdb_ns_path (db, "core/analysis/meta", false), "0x1010", "a new comment", 0);
+	mu_assert_true (rz_project_bin_save (db, NULL, 0, file, &written), "save one change");
+	mu_assert_true (written < 1024, "only the changed namespace is written");
+	mu_assert_true (load_equals (file, db), "one change");
+
+	sdb_ns_path (db, "core/analysis/types", true);
+	sdb_unset (sdb_ns (db, "core", false), "offset", 0);
+	mu_assert_true (rz_project_bin_save (db, NULL, 0, file, &written), "save new namespace");
+	mu_assert_true (load_equals (file, db), "new namespace");
+
+	// rewriting the biggest namespace again and again eventually compacts the file
+	Sdb *functions = sdb_ns_path (db, "core/analysis/functions", false);
+	int i;
+	for (i = 0; i < 4; i++) {
+		sdb_set (functions, "0x1000", i & 1 ? "{}" : "{\"name\":\"main\"}", 0);
+		mu_assert_true (rz_project_bin_save (db, NULL, 0, file, &written), "save big change");
+		mu_assert_true (load_equals (file, db), "big change");
+	}
+	mu_assert_true (rz_file_size (file) < 2 * full, "compacted");
+
+	sdb_free (db);
+	rz_file_rm (file);
+	free (file);
+	mu_end;
+}
+
+// records in descending key order, with 0 bytes inside and some empty ones
+static bool records_save(void *user, RzSerializeRecordCb cb, void *cb_user) {
+	int *count = user;
+	int i;
+	for (i = *count - 1; i >= 0; i--) {
+		char key[32];
+		ut8 data[8];
+		snprintf (key, sizeof (key), "0x%x", 0x1000 + i * 0x10);
+		rz_write_le64 (data, (ut64)i);
+		if (!cb (cb_user, key, data, i % 3 ? sizeof (data) : 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool records_check_cb(void *user, const char *key, const ut8 *data, ut64 size) {
+	int *i = user;
+	char expected[32];
+	snprintf (expected, sizeof (expected), "0x%x", 0x1000 + *i * 0x10);
+	bool ok = !strcmp (key, expected) && size == (*i % 3 ? 8 : 0) && (!size || rz_read_le64 (data) == (ut64)*i);
+	(*i)++;
+	return ok;
+}
+
+bool test_project_bin_records(void) {
+	char *file = tmp_file ();
+	mu_assert_notnull (file, "tmp file");
+	Sdb *db = ref_db ();
+	int count = 100;
+	RzProjectBinRecords records[] = {
+		{ "core/analysis/functions", records_save, &count },
+		{ "core/analysis/blocks", records_save, &count }
+	};
+	ut64 written = 0;
+	mu_assert_true (rz_project_bin_save (db, records, RZ_ARRAY_SIZE (records), file, NULL), "save");
+
+	RzProjectBin *pb = rz_project_bin_open (file);
+	mu_assert_notnull (pb, "open");
+	mu_assert_true (rz_project_bin_has_records (pb, "core/analysis/functions"), "replaced namespace");
+	mu_assert_true (rz_project_bin_has_records (pb, "core/analysis/blocks"), "new namespace");
+	mu_assert_false (rz_project_bin_has_records (pb, "core/analysis/meta"), "string namespace");
+	mu_assert_null (rz_project_bin_get (pb, "core/analysis/functions", "0x1000"), "records are no strings");
+	int i = 0;
+	mu_assert_true (rz_project_bin_records (pb, "core/analysis/functions", records_check_cb, &i), "records");
+	mu_assert_eq (i, count, "records count");
+	mu_assert_false (rz_project_bin_records (pb, "core/analysis/meta", records_check_cb, &i), "string namespace records");
+	Sdb *analysis = sdb_new0 ();
+	mu_assert_false (rz_project_bin_load_ns (pb, "core/analysis/blocks", analysis, false), "records have no sdb form");
+	mu_assert_true (rz_project_bin_load_ns (pb, "core/analysis", analysis, true), "load subtree");
+	mu_assert_null (sdb_ns (analysis, "functions", false), "records are skipped");
+	mu_assert_notnull (sdb_ns (analysis, "meta", false), "strings are decoded");
+	sdb_free (analysis);
+	rz_project_bin_close (pb);
+
+	mu_assert_true (rz_project_bin_save (db, records, RZ_ARRAY_SIZE (records), file, &written), "save unchanged");
+	mu_assert_true (written < 512, "records are reused");
+	count = 50;
+	mu_assert_true (rz_project_bin_save (db, records, RZ_ARRAY_SIZE (records), file, &written), "save fewer records");
+	pb = rz_project_bin_open (file);
+	mu_assert_notnull (pb, "open");
+	i = 0;
+	mu_assert_true (rz_project_bin_records (pb, "core/analysis/blocks", records_check_cb, &i), "records");
+	mu_assert_eq (i, count, "fewer records");
+	rz_project_bin_close (pb);
+
+	sdb_free (db);
+	rz_file_rm (file);
+	free (file);
+	mu_end;
+}
+
+bool test_project_bin_corrupt(void) {
+	char *file = tmp_file ();
+	mu_assert_notnull (file, "tmp file");
+	Sdb *db = ref_db ();
+	mu_assert_true (rz_project_bin_save (db, NULL, 0, file, NULL), "save");
+	size_t size;
+	ut8 *buf = (ut8 *)rz_file_slurp (file, &size);
+	mu_assert_notnull (buf, "slurp");
+
+	// table pointing past the end
+	rz_write_le64 (buf + 16, size);
+	mu_assert_true (rz_file_dump (file, buf, (int)size, false), "dump");
+	mu_assert_null (rz_project_bin_open (file), "bad table");
+	// truncated
+	mu_assert_true (rz_file_dump (file, buf, (int)size / 2, false), "dump");
+	mu_assert_null (rz_project_bin_open (file), "truncated");
+	free (buf);
+
+	sdb_free (db);
+	rz_file_rm (file);
+	free (file);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_project_bin_roundtrip);
+	mu_run_test (test_project_bin_incremental);
+	mu_run_test (test_project_bin_records);
+	mu_run_test (test_project_bin_corrupt);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
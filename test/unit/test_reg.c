@@ -234,6 +234,73 @@ bool test_r_reg_get_pack(void) {
 	mu_end;
 }
 
+bool test_r_reg_index(void) {
+	RzReg *reg = rz_reg_new ();
+	mu_assert_notnull (reg, "rz_reg_new () failed");
+	rz_reg_set_profile_string (reg,
+		"=PC	eip\n\
+		gpr	eax	.32	0	0\n\
+		gpr	ax	.16	0	0\n\
+		gpr	al	.8	0	0\n\
+		gpr	eip	.32	8	0\n\
+		xmm	xmm0	.64	0	0\n\
+		gpr	zf	.1	.96	0");
+
+	int eax = rz_reg_index_of (reg, "eax");
+	int pc = rz_reg_index_of (reg, "PC");
+	mu_assert_neq (eax, -1, "eax index");
+	mu_assert_eq (pc, rz_reg_index_of (reg, "eip"), "role resolved to its register");
+	mu_assert_eq (rz_reg_index_of (reg, "ebx"), -1, "no such register");
+	mu_assert_ptreq (rz_reg_index_get (reg, eax), rz_reg_get (reg, "eax", -1), "index to item");
+	mu_assert_null (rz_reg_index_get (reg, 100), "index out of range");
+
+	mu_assert_true (rz_reg_index_set_value (reg, eax, 0x11223344), "set eax");
+	mu_assert_eq (rz_reg_index_get_value (reg, eax), 0x11223344, "get eax");
+	mu_assert_eq (rz_reg_getv (reg, "ax"), 0x3344, "ax");
+	mu_assert_eq (rz_reg_getv (reg, "al"), 0x44, "al");
+	mu_assert_true (rz_reg_index_set_value (reg, pc, 0x8048000), "set pc");
+	mu_assert_eq (rz_reg_getv (reg, "eip"), 0x8048000, "get eip");
+	rz_reg_setv (reg, "zf", 1);
+	mu_assert_eq (rz_reg_getv (reg, "zf"), 1, "unaligned flag");
+
+	reg->big_endian = true;
+	rz_reg_setv (reg, "eax", 0x11223344);
+	mu_assert_eq (rz_reg_getv (reg, "ax"), 0x1122, "big endian ax");
+	mu_assert_eq (rz_reg_index_get_value (reg, eax), 0x11223344, "big endian eax");
+
+	rz_reg_free (reg);
+	mu_end;
+}
+
+bool test_r_reg_dirty(void) {
+	RzReg *reg = rz_reg_new ();
+	mu_assert_notnull (reg, "rz_reg_new () failed");
+	rz_reg_set_profile_string (reg,
+		"gpr	eax	.32	0	0\n\
+		xmm	xmm0	.64	0	0");
+	const int all = (1 << RZ_REG_TYPE_LAST) - 1;
+	mu_assert_eq (rz_reg_dirty_types (reg), all, "never synced");
+	rz_reg_dirty_clear (reg, RZ_REG_TYPE_ALL);
+	mu_assert_eq (rz_reg_dirty_types (reg), 0, "synced");
+
+	rz_reg_setv (reg, "xmm0", 42);
+	mu_assert_eq (rz_reg_dirty_types (reg), 1 << RZ_REG_TYPE_XMM, "xmm changed");
+	rz_reg_setv (reg, "xmm0", 0);
+	mu_assert_eq (rz_reg_dirty_types (reg), 0, "changed back");
+
+	// writes straight to the arena count too
+	reg->regset[RZ_REG_TYPE_GPR].arena->bytes[0] = 1;
+	mu_assert_eq (rz_reg_dirty_types (reg), 1 << RZ_REG_TYPE_GPR, "gpr changed");
+	rz_reg_dirty_clear (reg, RZ_REG_TYPE_GPR);
+	mu_assert_eq (rz_reg_dirty_types (reg), 0, "gpr synced");
+
+	rz_reg_dirty_set (reg, RZ_REG_TYPE_XMM);
+	mu_assert_eq (rz_reg_dirty_types (reg), 1 << RZ_REG_TYPE_XMM, "xmm forgotten");
+
+	rz_reg_free (reg);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test (test_r_reg_set_name);
 	mu_run_test (test_r_reg_set_profile_string);
@@ -242,6 +309,8 @@ int all_tests() {
 	mu_run_test (test_r_reg_get);
 	mu_run_test (test_r_reg_get_list);
 	mu_run_test (test_r_reg_get_pack);
+	mu_run_test (test_r_reg_index);
+	mu_run_test (test_r_reg_dirty);
 	return tests_passed != tests_run;
 }
 
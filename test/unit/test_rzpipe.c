@@ -12,6 +12,173 @@ static bool test_rzpipe(void) {
 	mu_end;
 }
 
+static bool test_rzpipe_framed(void) {
+	RzPipe *r = rzpipe_open ("rizin -q0 malloc://0x100000");
+	mu_assert ("rzpipe can spawn", r);
+	mu_assert_true (r->framed, "framed protocol negotiated");
+	char *hello = rzpipe_cmd (r, "?e hello world");
+	mu_assert_streq (hello, "hello world\n", "framed hello world");
+	free (hello);
+	char *empty = rzpipe_cmd (r, "?e");
+	mu_assert_streq (empty, "\n", "empty line");
+	free (empty);
+
+	// replies of queued commands come in order
+	int i;
+	for (i = 0; i < 100; i++) {
+		char cmd[32];
+		snprintf (cmd, sizeof (cmd), "?e %d", i);
+		mu_assert_true (rzpipe_queue (r, cmd), "queue");
+	}
+	for (i = 0; i < 100; i++) {
+		char *out = rzpipe_read (r);
+		char exp[32];
+		snprintf (exp, sizeof (exp), "%d\n", i);
+		mu_assert_streq (out, exp, "queued reply");
+		free (out);
+	}
+
+	// bigger than the pipe and the read ahead buffer
+	char *big = rzpipe_cmd (r, "p8 0x100000");
+	mu_assert_eq (strlen (big), 2 * 0x100000 + 1, "big reply");
+	free (big);
+
+	// what goes to stdout outside of the cons buffer stays out of the frames
+	char *shell = rzpipe_cmd (r, "!echo stray");
+	mu_assert_notnull (shell, "shell command reply");
+	free (shell);
+	char *ok = rzpipe_cmd (r, "?e ok");
+	mu_assert_streq (ok, "ok\n", "frames after a shell command");
+	free (ok);
+	rzpipe_close (r);
+	mu_end;
+}
+
+static bool queue_big_replies(RzPipe *r) {
+	// more commands than the pipe to rizin holds, with more replies than
+	// the pipe back holds
+	int i;
+	for (i = 0; i < 20000; i++) {
+		mu_assert_true (rzpipe_queue (r, "p8 0x200"), "queue");
+	}
+	for (i = 0; i < 20000; i++) {
+		char *out = rzpipe_read (r);
+		mu_assert_eq (out ? strlen (out) : 0, 2 * 0x200 + 1, "queued reply");
+		free (out);
+	}
+	return MU_PASSED;
+}
+
+static bool test_rzpipe_queue_big(void) {
+	RzPipe *r = rzpipe_open ("rizin -q0 malloc://0x100000");
+	mu_assert ("rzpipe can spawn", r);
+	bool ret = queue_big_replies (r);
+	rzpipe_close (r);
+	mu_assert_true (ret == MU_PASSED, "framed");
+	r = rzpipe_open ("env RZ_PIPE_FRAMED=0 rizin -q0 malloc://0x100000");
+	mu_assert ("rzpipe can spawn", r);
+	ret = queue_big_replies (r);
+	rzpipe_close (r);
+	mu_assert_true (ret == MU_PASSED, "NUL terminated");
+	mu_end;
+}
+
+static bool test_rzpipe_zero(void) {
+	// rizin that does not know about frames
+	RzPipe *r = rzpipe_open ("env RZ_PIPE_FRAMED=0 rizin -q0 malloc://0x100000");
+	mu_assert ("rzpipe can spawn", r);
+	mu_assert_false (r->framed, "NUL terminated protocol");
+	int i;
+	for (i = 0; i < 10; i++) {
+		char cmd[32];
+		snprintf (cmd, sizeof (cmd), "?e %d", i);
+		mu_assert_true (rzpipe_queue (r, cmd), "queue");
+	}
+	for (i = 0; i < 10; i++) {
+		char *out = rzpipe_read (r);
+		char exp[32];
+		snprintf (exp, sizeof (exp), "%d\n", i);
+		mu_assert_streq (out, exp, "queued reply");
+		free (out);
+	}
+	char *big = rzpipe_cmd (r, "p8 0x100000");
+	mu_assert_eq (strlen (big), 2 * 0x100000 + 1, "big reply");
+	free (big);
+	rzpipe_close (r);
+	mu_end;
+}
+
+static bool test_rzpipe_inherited(void) {
+	// RZ_PIPE_FRAMED left by a framed parent, for another pipe
+	RzPipe *r = rzpipe_open ("env RZ_PIPE_FRAMED=1 rizin -q0 -");
+	mu_assert ("rzpipe can spawn", r);
+	mu_assert_false (r->framed, "NUL terminated protocol");
+	char *hello = rzpipe_cmd (r, "?e hello world");
+	mu_assert_streq (hello, "hello world\n", "rzpipe hello world");
+	free (hello);
+	rzpipe_close (r);
+	mu_end;
+}
+
+static bool test_rzpipe_framed_token(void) {
+#if __UNIX__
+	int fds[2];
+	mu_assert_eq (pipe (fds), 0, "pipe");
+	char *a = rzpipe_framed_token (fds[0]);
+	char *b = rzpipe_framed_token (fds[1]);
+	mu_assert_notnull (a, "token of a pipe");
+	mu_assert_streq (a, b, "both ends of a pipe");
+	rz_sys_setenv ("RZ_PIPE_FRAMED", a);
+	mu_assert_true (rzpipe_framed_requested (fds[1]), "requested for this pipe");
+	mu_assert_false (rzpipe_framed_requested (-1), "not for another fd");
+	rz_sys_setenv ("RZ_PIPE_FRAMED", "1");
+	mu_assert_false (rzpipe_framed_requested (fds[1]), "not for any pipe");
+	rz_sys_setenv ("RZ_PIPE_FRAMED", NULL);
+	free (a);
+	free (b);
+	close (fds[0]);
+	close (fds[1]);
+#endif
+	mu_end;
+}
+
+static void bench(const char *name, const char *cmd) {
+	RzPipe *r = rzpipe_open (cmd);
+	if (!r) {
+		return;
+	}
+	const int n = 2000;
+	int i;
+	ut64 t = rz_time_now_mono ();
+	for (i = 0; i < n; i++) {
+		free (rzpipe_cmd (r, "?e x"));
+	}
+	ut64 sync = rz_time_now_mono () - t;
+	t = rz_time_now_mono ();
+	for (i = 0; i < n; i++) {
+		rzpipe_queue (r, "?e x");
+	}
+	for (i = 0; i < n; i++) {
+		free (rzpipe_read (r));
+	}
+	ut64 queued = rz_time_now_mono () - t;
+	t = rz_time_now_mono ();
+	char *big = rzpipe_cmd (r, "p8 0x1000000");
+	ut64 bigt = rz_time_now_mono () - t;
+	size_t len = big ? strlen (big) : 0;
+	free (big);
+	printf ("%s: %.0f cmds/s, %.0f queued cmds/s, %.1f MB/s\n", name,
+		n * 1e6 / RZ_MAX (sync, 1), n * 1e6 / RZ_MAX (queued, 1), len / (double)RZ_MAX (bigt, 1));
+	rzpipe_close (r);
+}
+
+static bool test_rzpipe_bench(void) {
+	mu_bench;
+	bench ("framed", "rizin -q0 malloc://0x1000000");
+	bench ("zero", "env RZ_PIPE_FRAMED=0 rizin -q0 malloc://0x1000000");
+	mu_end;
+}
+
 static bool test_rzpipe_404(void) {
 	RzPipe *r = rzpipe_open ("ricin -q0 -");
 	mu_assert ("rzpipe can spawn", !r);
@@ -20,6 +187,12 @@ static bool test_rzpipe_404(void) {
 
 static int all_tests() {
 	mu_run_test (test_rzpipe);
+	mu_run_test (test_rzpipe_framed);
+	mu_run_test (test_rzpipe_zero);
+	mu_run_test (test_rzpipe_queue_big);
+	mu_run_test (test_rzpipe_inherited);
+	mu_run_test (test_rzpipe_framed_token);
+	mu_run_test (test_rzpipe_bench);
 	mu_run_test (test_rzpipe_404);
 	return tests_passed != tests_run;
 }
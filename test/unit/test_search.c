@@ -0,0 +1,248 @@
+#include <rz_search.h>
+#include "minunit.h"
+
+#define BENCH_SIZE (16 * 1024 * 1024)
+
+static ut8 *random_buf(ut64 len, ut32 seed) {
+	ut8 *buf = malloc (len);
+	ut64 i;
+	for (i = 0; buf && i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 24;
+	}
+	return buf;
+}
+
+static RzList *search_chunked(RzSearch *s, const ut8 *buf, int len, int chunk) {
+	RzList *hits = rz_list_newf (free);
+	int at;
+	rz_search_set_callback (s, NULL, NULL);
+	rz_list_purge (s->hits);
+	rz_search_begin (s);
+	for (at = 0; at < len; at += chunk) {
+		rz_search_update (s, at, buf + at, RZ_MIN (chunk, len - at));
+	}
+	RzListIter *it;
+	RzSearchHit *h;
+	rz_list_foreach (s->hits, it, h) {
+		RzSearchHit *c = RZ_NEW (RzSearchHit);
+		*c = *h;
+		rz_list_append (hits, c);
+	}
+	return hits;
+}
+
+static bool naive_match(RzSearchKeyword *kw, const ut8 *buf) {
+	ut32 j;
+	for (j = 0; j < kw->keyword_length; j++) {
+		ut8 a = buf[j], b = kw->bin_keyword[j];
+		ut8 m = kw->binmask_length ? kw->bin_binmask[j % kw->binmask_length] : 0xff;
+		if (kw->icase) {
+			a = tolower (a);
+			b = tolower (b);
+		}
+		if ((a & m) != (b & m)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_search_multi(void) {
+	const int len = 50000;
+	ut8 *buf = random_buf (len, 42);
+	RzSearch *s = rz_search_new (RZ_SEARCH_KEYWORD);
+	s->overlap = true;
+	s->contiguous = true;
+	int i;
+	// keywords taken from the data, so that they all hit
+	for (i = 0; i < 64; i++) {
+		int off = (i * 7919) % (len - 16), kwlen = 1 + i % 12;
+		if (i % 8 == 1) {
+			rz_search_kw_add (s, rz_search_keyword_new_hexmask ("41..43", NULL));
+		} else if (i % 8 == 2) {
+			ut8 mask[] = { 0xff, 0x00, 0xff, 0xff };
+			rz_search_kw_add (s, rz_search_keyword_new (buf + off, 4, mask, 4, NULL));
+		} else if (i % 8 == 3) {
+			rz_search_kw_add (s, rz_search_keyword_new_str ("HeLLo", NULL, NULL, true));
+		} else {
+			rz_search_kw_add (s, rz_search_keyword_new (buf + off, kwlen, NULL, 0, NULL));
+		}
+	}
+	memcpy (buf + 1000, "hello", 5);
+	memcpy (buf + 4095, "HELLO", 5); // across the chunk boundary
+	memcpy (buf + 2000, "A\xff" "C", 3);
+
+	RzList *hits = search_chunked (s, buf, len, 4096);
+	RzListIter *it;
+	RzSearchHit *h;
+	int expected = 0;
+	RzSearchKeyword *kw;
+	rz_list_foreach (s->kws, it, kw) {
+		for (i = 0; i + kw->keyword_length <= len; i++) {
+			expected += naive_match (kw, buf + i);
+		}
+	}
+	mu_assert_eq (rz_list_length (hits), expected, "every match is reported");
+	rz_list_foreach (hits, it, h) {
+		mu_assert_true (naive_match (h->kw, buf + h->addr), "hit matches");
+	}
+	// the block size must not change the result
+	RzList *whole = search_chunked (s, buf, len, len);
+	RzList *small = search_chunked (s, buf, len, 100);
+	mu_assert_eq (rz_list_length (whole), expected, "single block");
+	mu_assert_eq (rz_list_length (small), expected, "small blocks");
+	rz_list_free (whole);
+	rz_list_free (small);
+	rz_list_free (hits);
+	rz_search_free (s);
+	free (buf);
+	mu_end;
+}
+
+bool test_search_order(void) {
+	const ut8 buf[] = "abcabcab";
+	RzSearch *s = rz_search_new (RZ_SEARCH_KEYWORD);
+	rz_search_kw_add (s, rz_search_keyword_new ((const ut8 *)"bc", 2, NULL, 0, NULL));
+	rz_search_kw_add (s, rz_search_keyword_new ((const ut8 *)"ab", 2, NULL, 0, NULL));
+	RzList *hits = search_chunked (s, buf, sizeof (buf) - 1, 3);
+	// the hits of a block are grouped by keyword
+	const ut64 addrs[] = { 1, 0, 4, 3, 6 };
+	const int kws[] = { 0, 1, 0, 1, 1 };
+	mu_assert_eq (rz_list_length (hits), RZ_ARRAY_SIZE (addrs), "hits");
+	RzListIter *it;
+	RzSearchHit *h;
+	int i = 0;
+	rz_list_foreach (hits, it, h) {
+		mu_assert_eq (h->addr, addrs[i], "hit address");
+		mu_assert_eq (h->kw->kwidx, kws[i], "hit keyword");
+		i++;
+	}
+	rz_list_free (hits);
+	rz_search_free (s);
+	mu_end;
+}
+
+typedef struct {
+	const ut8 *buf;
+	ut64 eof;
+} ReadCtx;
+
+static bool read_cb(void *user, ut64 addr, ut8 *buf, int len) {
+	ReadCtx *ctx = user;
+	if (addr >= ctx->eof) {
+		return false;
+	}
+	memcpy (buf, ctx->buf + addr, len);
+	return true;
+}
+
+static RzList *search_range(RzSearch *s, const ut8 *buf, ut64 len, ut64 eof, int threads) {
+	ReadCtx ctx = { buf, eof };
+	rz_search_set_callback (s, NULL, NULL);
+	rz_list_purge (s->hits);
+	s->nhits = 0;
+	rz_search_begin (s);
+	rz_search_update_range (s, 0, len, 1000, threads, read_cb, &ctx);
+	RzList *hits = s->hits;
+	s->hits = rz_list_newf (free);
+	return hits;
+}
+
+static bool same_hits(RzList *a, RzList *b) {
+	RzListIter *x, *y;
+	if (rz_list_length (a) != rz_list_length (b)) {
+		return false;
+	}
+	for (x = a->head, y = b->head; x; x = x->n, y = y->n) {
+		RzSearchHit *h = x->data, *k = y->data;
+		if (h->addr != k->addr || h->kw != k->kw) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_search_update_range(void) {
+	const ut64 len = 300000;
+	ut8 *buf = random_buf (len, 7);
+	ut64 i;
+	for (i = 0; i < len; i++) {
+		buf[i] &= 3; // lots of overlapping hits
+	}
+	RzSearch *s = rz_search_new (RZ_SEARCH_KEYWORD);
+	rz_search_kw_add (s, rz_search_keyword_new ((const ut8 *)"\x01\x01\x01", 3, NULL, 0, NULL));
+	rz_search_kw_add (s, rz_search_keyword_new ((const ut8 *)"\x02\x03\x02\x03\x02", 5, NULL, 0, NULL));
+	rz_search_kw_add (s, rz_search_keyword_new_hexmask ("00..00", NULL));
+	int o;
+	for (o = 0; o < 2; o++) {
+		s->overlap = o;
+		RzList *serial = search_range (s, buf, len, len, 1);
+		RzList *parallel = search_range (s, buf, len, len, 4);
+		mu_assert_true (rz_list_length (serial) > 1000, "hits");
+		mu_assert_true (same_hits (serial, parallel), "same hits as the serial search");
+		rz_list_free (serial);
+		rz_list_free (parallel);
+
+		serial = search_range (s, buf, len, 123456, 1);
+		parallel = search_range (s, buf, len, 123456, 3);
+		mu_assert_true (same_hits (serial, parallel), "same hits up to a failed read");
+		rz_list_free (serial);
+		rz_list_free (parallel);
+
+		s->maxhits = 777;
+		serial = search_range (s, buf, len, len, 1);
+		parallel = search_range (s, buf, len, len, 2);
+		mu_assert_eq (rz_list_length (parallel), 777, "search.maxhits");
+		mu_assert_true (same_hits (serial, parallel), "same first hits");
+		rz_list_free (serial);
+		rz_list_free (parallel);
+		s->maxhits = 0;
+	}
+	rz_search_free (s);
+	free (buf);
+	mu_end;
+}
+
+static double gbps(ut64 len, ut64 t0) {
+	ut64 dt = RZ_MAX (rz_time_now_mono () - t0, 1);
+	return (double)len / dt / 1000;
+}
+
+bool test_search_bench(void) {
+	mu_bench;
+	ut8 *buf = random_buf (BENCH_SIZE, 1);
+	ut8 *kwbuf = random_buf (5000 * 8, 2);
+	mu_assert_true (buf && kwbuf, "bench buffers");
+	const int counts[] = { 1, 10, 100, 1000, 5000 };
+	size_t c;
+	for (c = 0; c < RZ_ARRAY_SIZE (counts); c++) {
+		RzSearch *s = rz_search_new (RZ_SEARCH_KEYWORD);
+		int i;
+		for (i = 0; i < counts[c]; i++) {
+			rz_search_kw_add (s, rz_search_keyword_new (kwbuf + i * 8, 8, NULL, 0, NULL));
+		}
+		rz_search_begin (s);
+		ut64 t0 = rz_time_now_mono (), at;
+		for (at = 0; at < BENCH_SIZE; at += 0x10000) {
+			rz_search_update (s, at, buf + at, 0x10000);
+		}
+		printf ("%d keywords: %.2f GB/s\n", counts[c], gbps (BENCH_SIZE, t0));
+		rz_search_free (s);
+	}
+	free (kwbuf);
+	free (buf);
+	mu_end;
+}
+
+bool all_tests() {
+	mu_run_test (test_search_multi);
+	mu_run_test (test_search_order);
+	mu_run_test (test_search_update_range);
+	mu_run_test (test_search_bench);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
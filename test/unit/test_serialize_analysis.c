@@ -624,6 +624,95 @@ bool test_analysis_var_load() {
 	mu_end;
 }
 
+// records are kept as hex strings, standing in for a project container
+static bool records_put_cb(void *user, const char *key, const ut8 *data, ut64 size) {
+	char *hex = rz_hex_bin2strdup (data, (int)size);
+	bool ret = hex && sdb_set (user, key, hex, 0);
+	free (hex);
+	return ret;
+}
+
+typedef struct {
+	RzSerializeRecordCb cb;
+	void *user;
+	bool ok;
+} RecordsForeachCtx;
+
+static bool records_foreach_cb(void *user, const char *k, const char *v) {
+	RecordsForeachCtx *ctx = user;
+	int len = strlen (v) / 2;
+	ut8 *data = malloc (len + 1);
+	ctx->ok = data && rz_hex_str2bin (v, data) == len && ctx->cb (ctx->user, k, data, len);
+	free (data);
+	return ctx->ok;
+}
+
+static bool records_src_records(void *user, const char *path, RzSerializeRecordCb cb, void *cb_user) {
+	RecordsForeachCtx ctx = { cb, cb_user, true };
+	sdb_foreach (user, records_foreach_cb, &ctx);
+	return ctx.ok;
+}
+
+// saves blocks and functions as records, loads them into a fresh analysis and compares the json of both
+static bool records_roundtrip(RzAnalysis *analysis, const char *arch, int bits) {
+	Sdb *blocks = sdb_new0 ();
+	Sdb *functions = sdb_new0 ();
+	mu_assert_true (rz_serialize_analysis_blocks_save_records (analysis, records_put_cb, blocks), "blocks records save");
+	mu_assert_true (rz_serialize_analysis_functions_save_records (analysis, records_put_cb, functions), "functions records save");
+
+	RzAnalysis *loaded = rz_analysis_new ();
+	if (arch) {
+		rz_analysis_use (loaded, arch);
+		rz_analysis_set_bits (loaded, bits);
+	}
+	RzSerializeNsSource src = { NULL, NULL, records_src_records, blocks, "" };
+	mu_assert_true (rz_serialize_analysis_blocks_load_records (&src, "blocks", loaded, NULL), "blocks records load");
+	src.user = functions;
+	mu_assert_true (rz_serialize_analysis_functions_load_records (&src, "functions", loaded, NULL), "functions records load");
+
+	Sdb *expected = sdb_new0 ();
+	Sdb *actual = sdb_new0 ();
+	rz_serialize_analysis_blocks_save (expected, analysis);
+	rz_serialize_analysis_blocks_save (actual, loaded);
+	assert_sdb_eq (actual, expected, "blocks records roundtrip");
+	sdb_reset (expected);
+	sdb_reset (actual);
+	rz_serialize_analysis_functions_save (expected, analysis);
+	rz_serialize_analysis_functions_save (actual, loaded);
+	assert_sdb_eq (actual, expected, "functions records roundtrip");
+
+	sdb_free (expected);
+	sdb_free (actual);
+	sdb_free (blocks);
+	sdb_free (functions);
+	rz_analysis_free (loaded);
+	return true;
+}
+
+bool test_analysis_records() {
+	RzAnalysis *analysis = rz_analysis_new ();
+	RzSerializeAnalDiffParser diff_parser = rz_serialize_analysis_diff_parser_new ();
+	Sdb *db = blocks_ref_db ();
+	mu_assert_true (rz_serialize_analysis_blocks_load (db, analysis, diff_parser, NULL), "blocks load");
+	sdb_free (db);
+	db = functions_ref_db ();
+	mu_assert_true (rz_serialize_analysis_functions_load (db, analysis, diff_parser, NULL), "functions load");
+	sdb_free (db);
+	mu_assert_true (records_roundtrip (analysis, NULL, 0), "blocks and functions");
+	rz_analysis_free (analysis);
+
+	analysis = rz_analysis_new ();
+	rz_analysis_use (analysis, "x86");
+	rz_analysis_set_bits (analysis, 64);
+	db = vars_ref_db ();
+	mu_assert_true (rz_serialize_analysis_functions_load (db, analysis, diff_parser, NULL), "vars load");
+	sdb_free (db);
+	mu_assert_true (records_roundtrip (analysis, "x86", 64), "vars");
+	rz_analysis_free (analysis);
+	rz_serialize_analysis_diff_parser_free (diff_parser);
+	mu_end;
+}
+
 Sdb *xrefs_ref_db() {
 	Sdb *db = sdb_new0 ();
 	sdb_set (db, "0x29a", "[{\"to\":333,\"type\":\"s\"}]", 0);
@@ -1823,6 +1912,7 @@ int all_tests() {
 	mu_run_test (test_analysis_function_load);
 	mu_run_test (test_analysis_var_save);
 	mu_run_test (test_analysis_var_load);
+	mu_run_test (test_analysis_records);
 	mu_run_test (test_analysis_xrefs_save);
 	mu_run_test (test_analysis_xrefs_load);
 	mu_run_test (test_analysis_meta_save);
@@ -106,8 +106,65 @@ static bool test_analysis_sign_get_set(void) {
 	mu_end;
 }
 
+static int count_cb(RzSignItem *it, void *user) {
+	(*(int *)user)++;
+	return 1;
+}
+
+static bool test_analysis_sign_compiled(void) {
+	RzAnalysis *analysis = rz_analysis_new ();
+	int count = 0;
+
+	rz_sign_add_comment (analysis, "sym.link", "hero of time");
+	rz_sign_add_addr (analysis, "sym.link", 0x1337);
+	rz_sign_foreach (analysis, count_cb, &count);
+	mu_assert_eq (count, 1, "zignatures count");
+
+	rz_sign_add_bytes (analysis, "sym.zelda", 4, (const ut8 *)"\xde\xad\xbe\xef", (const ut8 *)"\xff\xff\x00\xff");
+	rz_spaces_set (&analysis->zign_spaces, "koridai");
+	rz_sign_add_comment (analysis, "sym.boring", "gee it sure is boring around here");
+	rz_spaces_set (&analysis->zign_spaces, NULL);
+	count = 0;
+	rz_sign_foreach (analysis, count_cb, &count);
+	mu_assert_eq (count, 2, "zignatures count after adding");
+
+	char *file = rz_file_temp ("zigns");
+	mu_assert_true (rz_sign_save_compiled (analysis, file), "save compiled");
+	rz_analysis_free (analysis);
+
+	analysis = rz_analysis_new ();
+	mu_assert_true (rz_sign_load (analysis, file), "load compiled");
+	rz_file_rm (file);
+	free (file);
+	count = 0;
+	rz_sign_foreach (analysis, count_cb, &count);
+	mu_assert_eq (count, 2, "loaded zignatures count");
+
+	RzSignItem *item = rz_sign_get_item (analysis, "sym.link");
+	mu_assert_notnull (item, "get item");
+	mu_assert_streq (item->comment, "hero of time", "comment");
+	mu_assert_eq (item->addr, 0x1337, "addr");
+	rz_sign_item_free (item);
+	item = rz_sign_get_item (analysis, "sym.zelda");
+	mu_assert_notnull (item, "get item");
+	mu_assert_notnull (item->bytes, "bytes");
+	mu_assert_eq (item->bytes->size, 4, "bytes size");
+	mu_assert_memeq (item->bytes->bytes, (const ut8 *)"\xde\xad\xbe\xef", 4, "bytes bytes");
+	mu_assert_memeq (item->bytes->mask, (const ut8 *)"\xff\xff\x00\xff", 4, "bytes mask");
+	rz_sign_item_free (item);
+	rz_spaces_set (&analysis->zign_spaces, "koridai");
+	item = rz_sign_get_item (analysis, "sym.boring");
+	mu_assert_notnull (item, "get item in space");
+	mu_assert_streq (item->comment, "gee it sure is boring around here", "item in space comment");
+	rz_sign_item_free (item);
+
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
 int all_tests(void) {
 	mu_run_test (test_analysis_sign_get_set);
+	mu_run_test (test_analysis_sign_compiled);
 	return tests_passed != tests_run;
 }
 
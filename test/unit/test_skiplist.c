@@ -160,6 +160,35 @@ bool test_join(void) {
 	mu_end;
 }
 
+bool test_insert_sorted(void) {
+	RzSkipList *list = rz_skiplist_new (NULL, (RzListComparator)cmp_int);
+	void *data[1000];
+	int i;
+	// odd elements one by one, then all of them in a batch
+	for (i = 1; i < 1000; i += 2) {
+		rz_skiplist_insert (list, (void *)(intptr_t)i);
+	}
+	for (i = 0; i < 1000; i++) {
+		data[i] = (void *)(intptr_t)i;
+	}
+	mu_assert ("insert sorted", rz_skiplist_insert_sorted (list, data, 1000));
+	mu_assert_eq (rz_skiplist_length (list), 1000, "existing elements are skipped");
+
+	RzSkipListNode *it;
+	void *d;
+	i = 0;
+	rz_skiplist_foreach (list, it, d) {
+		mu_assert_eq ((int)(intptr_t)d, i, "elements in order");
+		i++;
+	}
+	for (i = 0; i < 1000; i += 7) {
+		mu_assert ("element can be found", rz_skiplist_find (list, (void *)(intptr_t)i));
+	}
+	mu_assert ("nothing to insert", rz_skiplist_insert_sorted (list, data, 0));
+	rz_skiplist_free (list);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_empty);
 	mu_run_test(test_oneelement);
@@ -168,6 +197,7 @@ int all_tests() {
 	mu_run_test(test_purge);
 	mu_run_test(test_delete);
 	mu_run_test(test_join);
+	mu_run_test(test_insert_sorted);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,123 @@
+#include <rz_util.h>
+#include "minunit.h"
+
+static bool ref_in(ut8 b, int classes) {
+	return ((classes & RZ_STR_SCAN_PRINTABLE) && IS_PRINTABLE (b))
+		|| ((classes & RZ_STR_SCAN_TAB) && b == '\t')
+		|| ((classes & RZ_STR_SCAN_ESCAPES) && ((b >= 0x07 && b <= 0x0d) || b == 0x1b))
+		|| ((classes & RZ_STR_SCAN_UTF8_LEAD) && b >= 0xc0 && b <= 0xf7);
+}
+
+bool test_str_scan_basic(void) {
+	const ut8 buf[] = "\x00\x01\xff\x80hello\tworld\x00";
+	const size_t len = sizeof (buf) - 1;
+	mu_assert_eq (rz_str_scan_next (buf, len, RZ_STR_SCAN_PRINTABLE), 4, "first printable");
+	mu_assert_eq (rz_str_scan_next (buf, len, RZ_STR_SCAN_UTF8_LEAD), len, "no utf8 lead");
+	mu_assert_eq (rz_str_scan_next (buf, len, RZ_STR_SCAN_ESCAPES), 9, "tab is an escape");
+	mu_assert_eq (rz_str_scan_span (buf + 4, len - 4, RZ_STR_SCAN_PRINTABLE), 5, "span stops at the tab");
+	mu_assert_eq (rz_str_scan_span (buf + 4, len - 4, RZ_STR_SCAN_PRINTABLE | RZ_STR_SCAN_TAB), 11, "span with tab");
+	mu_assert_eq (rz_str_scan_next (buf, 0, RZ_STR_SCAN_PRINTABLE), 0, "empty");
+	mu_assert_eq (rz_str_scan_span (buf + 4, 3, RZ_STR_SCAN_PRINTABLE), 3, "span to the end");
+	mu_end;
+}
+
+bool test_str_scan_random(void) {
+	const int classes[] = {
+		RZ_STR_SCAN_PRINTABLE,
+		RZ_STR_SCAN_PRINTABLE | RZ_STR_SCAN_TAB,
+		RZ_STR_SCAN_PRINTABLE | RZ_STR_SCAN_ESCAPES | RZ_STR_SCAN_UTF8_LEAD,
+		RZ_STR_SCAN_UTF8_LEAD
+	};
+	ut8 buf[300];
+	ut32 x = 0x1337;
+	int iter;
+	size_t c, off, i;
+	for (iter = 0; iter < 200; iter++) {
+		// mostly out of class bytes, so matches land in every lane
+		for (i = 0; i < sizeof (buf); i++) {
+			x = x * 1103515245 + 12345;
+			buf[i] = (x >> 16) % 16 ? (x >> 24) % 7 : x >> 24;
+		}
+		for (c = 0; c < RZ_ARRAY_SIZE (classes); c++) {
+			for (off = 0; off < 40; off += 13) {
+				size_t len = sizeof (buf) - off, next = 0, span = 0;
+				while (next < len && !ref_in (buf[off + next], classes[c])) {
+					next++;
+				}
+				while (span < len && ref_in (buf[off + span], classes[c])) {
+					span++;
+				}
+				mu_assert_eq (rz_str_scan_next (buf + off, len, classes[c]), next, "next");
+				mu_assert_eq (rz_str_scan_span (buf + off, len, classes[c]), span, "span");
+			}
+		}
+	}
+	mu_end;
+}
+
+static size_t ref_wide_next(const ut8 *buf, size_t len, size_t width) {
+	size_t i = 0;
+	while (i < len) {
+		RzRune r = 0;
+		if ((buf[i] >= 0x80 && buf[i] < 0xc0) || buf[i] >= 0xf8) {
+			i++;
+			continue;
+		}
+		if (i + width > len) {
+			break;
+		}
+		if (width == 2) {
+			rz_utf16le_decode (buf + i, len - i, &r);
+		} else {
+			rz_utf32le_decode (buf + i, len - i, &r);
+		}
+		if ((r >= 0x20 && r != 0x7f) || (r && strchr ("\b\v\f\n\r\t\a\033\\", (char)r))) {
+			break;
+		}
+		i += width;
+	}
+	return i;
+}
+
+bool test_str_scan_wide(void) {
+	const ut8 buf[] = "\x01\x00\xff\x02\x00\x00\x00" "A\x00";
+	mu_assert_eq (rz_str_scan_wide_next (buf, sizeof (buf) - 1, 2), 7, "utf16 stops on A");
+	mu_assert_eq (rz_str_scan_wide_next (buf + 3, sizeof (buf) - 4, 4), 4, "utf32 stops on A");
+	mu_assert_eq (rz_str_scan_wide_next (buf, 1, 2), 0, "partial unit");
+	mu_assert_eq (rz_str_scan_wide_next (buf, 0, 4), 0, "empty");
+	mu_end;
+}
+
+bool test_str_scan_wide_random(void) {
+	ut8 buf[300];
+	ut32 x = 0x1337;
+	int iter;
+	size_t width, off, i;
+	for (iter = 0; iter < 500; iter++) {
+		// mostly skipped units, so the walk ends anywhere in the blocks
+		for (i = 0; i < sizeof (buf); i++) {
+			x = x * 1103515245 + 12345;
+			ut8 r = x >> 24;
+			buf[i] = (x >> 16) % 64 == 0 ? r : (x >> 16) % 3 ? 0 : (r & 1 ? 0x80 | (r & 0x3f) : r & 0x1f);
+		}
+		for (width = 2; width <= 4; width += 2) {
+			for (off = 0; off < 40; off += 13) {
+				size_t len = sizeof (buf) - off;
+				mu_assert_eq (rz_str_scan_wide_next (buf + off, len, width), ref_wide_next (buf + off, len, width), "wide next");
+			}
+		}
+	}
+	mu_end;
+}
+
+bool all_tests() {
+	mu_run_test (test_str_scan_basic);
+	mu_run_test (test_str_scan_random);
+	mu_run_test (test_str_scan_wide);
+	mu_run_test (test_str_scan_wide_random);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
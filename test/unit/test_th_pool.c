@@ -0,0 +1,86 @@
+#include <rz_th.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+typedef struct {
+	RzThreadLock *lock;
+	int sum;
+	int calls;
+} PoolTestAcc;
+
+typedef struct {
+	PoolTestAcc *acc;
+	int value;
+	int out;
+} PoolTestJob;
+
+static void job_square(void *user) {
+	PoolTestJob *job = user;
+	job->out = job->value * job->value;
+	rz_th_lock_enter (job->acc->lock);
+	job->acc->sum += job->out;
+	job->acc->calls++;
+	rz_th_lock_leave (job->acc->lock);
+}
+
+bool test_th_pool(void) {
+	PoolTestAcc acc = { 0 };
+	acc.lock = rz_th_lock_new (false);
+	PoolTestJob jobs[100];
+	RzThreadPool *pool = rz_th_pool_new (4);
+	mu_assert_notnull (pool, "rz_th_pool_new ()");
+	mu_assert_eq (pool->size, 4, "pool size");
+	int i, expect = 0;
+	for (i = 0; i < 100; i++) {
+		jobs[i].acc = &acc;
+		jobs[i].value = i;
+		jobs[i].out = -1;
+		expect += i * i;
+		mu_assert_true (rz_th_pool_add_job (pool, job_square, &jobs[i]), "add job");
+	}
+	rz_th_pool_wait (pool);
+	mu_assert_eq (acc.calls, 100, "every job ran once");
+	mu_assert_eq (acc.sum, expect, "sum of squares");
+	for (i = 0; i < 100; i++) {
+		mu_assert_eq (jobs[i].out, i * i, "job result");
+	}
+
+	// the pool can be reused after waiting
+	jobs[0].value = 7;
+	rz_th_pool_add_job (pool, job_square, &jobs[0]);
+	rz_th_pool_wait (pool);
+	mu_assert_eq (jobs[0].out, 49, "job result after reuse");
+	mu_assert_eq (acc.calls, 101, "calls after reuse");
+	rz_th_pool_free (pool);
+	rz_th_lock_free (acc.lock);
+	mu_end;
+}
+
+bool test_th_pool_free_pending(void) {
+	PoolTestAcc acc = { 0 };
+	acc.lock = rz_th_lock_new (false);
+	PoolTestJob jobs[32];
+	RzThreadPool *pool = rz_th_pool_new (2);
+	mu_assert_notnull (pool, "rz_th_pool_new ()");
+	int i;
+	for (i = 0; i < 32; i++) {
+		jobs[i].acc = &acc;
+		jobs[i].value = 1;
+		rz_th_pool_add_job (pool, job_square, &jobs[i]);
+	}
+	// free drains the queue before joining the workers
+	rz_th_pool_free (pool);
+	mu_assert_eq (acc.calls, 32, "pending jobs ran before free");
+	rz_th_lock_free (acc.lock);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_th_pool);
+	mu_run_test (test_th_pool_free_pending);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}